@@ -8,6 +8,11 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+// Per-stage heap accounting (Native_Toolkit/firmware/alloc_track.c, needs CONFIG_HEAP_USE_HOOKS)
+#include "alloc_track.h"
+
+// Heap use per stage, printed after every send
+#define ALLOC_TRACK_ENABLED 0
 
 // Container data structure (matches actual sensor readings exactly)
 typedef struct {
@@ -103,8 +108,8 @@ size_t cbor_compress_container_data(const container_data_t *data, uint8_t *buffe
     cbor_map_add(root, cbor_pair(cbor_build_string("nsat"), cbor_build_string(data->nsat)));
     cbor_map_add(root, cbor_pair(cbor_build_string("hdop"), cbor_build_string(data->hdop)));
     
-    // Encode to buffer
-    size_t encoded_size = cbor_serialize_alloc(root, &buffer, &buffer_size);
+    // Encode into the caller's buffer (cbor_serialize_alloc would return a new heap block)
+    size_t encoded_size = cbor_serialize(root, buffer, buffer_size);
     
     // Clean up
     cbor_decref(&root);
@@ -149,6 +154,28 @@ bool send_container_data_via_udp(const uint8_t *cbor_data, size_t data_size) {
     }
 }
 
+#if ALLOC_TRACK_ENABLED
+static int stage_encode = -1, stage_http = -1, stage_udp = -1;
+
+static void alloc_track_print() {
+    alloc_track_stage_t stages[ALLOC_TRACK_MAX_STAGES];
+    size_t n = alloc_track_snapshot(stages, ALLOC_TRACK_MAX_STAGES);
+    Serial.printf("Heap per stage (free %u, min free %u):\n", ESP.getFreeHeap(), ESP.getMinFreeHeap());
+    for (size_t i = 0; i < n && i < ALLOC_TRACK_MAX_STAGES; i++) {
+        const alloc_track_stage_t *s = &stages[i];
+        uint64_t calls = s->calls ? s->calls : 1;
+        Serial.printf("  %-12s allocs/msg %.1f bytes/msg %.0f peak %llu retained %lld\n", s->name,
+                      (double)s->allocs / calls, (double)s->bytes / calls,
+                      (unsigned long long)s->peak, (long long)s->retained);
+    }
+}
+#define STAGE_ENTER(id) alloc_track_enter(id)
+#define STAGE_LEAVE() alloc_track_leave()
+#else
+#define STAGE_ENTER(id) ((void)0)
+#define STAGE_LEAVE() ((void)0)
+#endif
+
 // Main function to demonstrate the complete flow
 void send_container_data() {
     container_data_t container_data;
@@ -164,8 +191,12 @@ void send_container_data() {
     Serial.printf("Temperature: %.2f°C\n", container_data.temperature);
     Serial.printf("Battery: %d%%\n", container_data.bat_soc);
     
-    // Step 2: Compress with CBOR
+    // Step 2: Compress with CBOR (libcbor items are heap blocks)
+    STAGE_ENTER(stage_encode);
+    uint32_t encode_start = ESP.getCycleCount();
     size_t cbor_size = cbor_compress_container_data(&container_data, cbor_buffer, buffer_size);
+    uint32_t encode_cycles = ESP.getCycleCount() - encode_start;
+    STAGE_LEAVE();
     
     if (cbor_size == 0) {
         Serial.println("CBOR compression failed!");
@@ -173,6 +204,8 @@ void send_container_data() {
     }
     
     Serial.printf("CBOR compressed size: %d bytes\n", cbor_size);
+    // Encode cost for Native_Toolkit/tools/energy_report --cycles
+    Serial.printf("CBOR encode: %u cycles\n", encode_cycles);
     Serial.printf("CBOR data (hex): ");
     for (size_t i = 0; i < cbor_size && i < 32; i++) {
         Serial.printf("%02x", cbor_buffer[i]);
@@ -181,13 +214,20 @@ void send_container_data() {
     Serial.println();
     
     // Step 3: Send via HTTP (for testing)
+    STAGE_ENTER(stage_http);
     bool http_success = send_container_data_via_http(cbor_buffer, cbor_size);
+    STAGE_LEAVE();
     
     // Step 4: Send via UDP (for production/Astrocast)
+    STAGE_ENTER(stage_udp);
     bool udp_success = send_container_data_via_udp(cbor_buffer, cbor_size);
+    STAGE_LEAVE();
     
     Serial.printf("HTTP send: %s\n", http_success ? "SUCCESS" : "FAILED");
     Serial.printf("UDP send: %s\n", udp_success ? "SUCCESS" : "FAILED");
+#if ALLOC_TRACK_ENABLED
+    alloc_track_print();
+#endif
 }
 
 // Arduino setup function
@@ -203,6 +243,14 @@ void setup() {
     }
     Serial.println("\nWiFi connected");
     
+#if ALLOC_TRACK_ENABLED
+    // Arduino String, HTTPClient and libcbor all allocate through heap_caps
+    if (!alloc_track_hooked()) Serial.println("CONFIG_HEAP_USE_HOOKS is off: heap per stage is not tracked");
+    stage_encode = alloc_track_stage("cbor-encode");
+    stage_http = alloc_track_stage("http-send");
+    stage_udp = alloc_track_stage("udp-send");
+#endif
+    
     // Test CBOR compression
     send_container_data();
 }
@@ -237,7 +285,7 @@ void loop() {
  *     cbor_item_t *root = cbor_new_definite_map(20);
  *     cbor_map_add(root, cbor_pair(cbor_build_string("msisdn"), cbor_build_string(data->msisdn)));
  *     // ... add all fields
- *     return cbor_serialize_alloc(root, &buffer, &buffer_size);
+ *     return cbor_serialize(root, buffer, buffer_size);
  * }
  * 
  * All three implementations produce identical CBOR data that can be
@@ -8,6 +8,10 @@
 import time
 import random
 import json
+import zlib
+import struct
+import mmap
+import sys
 import cbor2
 from datetime import datetime, timedelta
 from locust import HttpUser, task, between, events
@@ -25,10 +29,68 @@ import os
 DEFAULT_POOL_SIZE = 10000
 DATA_POOL_SIZE = int(os.environ.get('LOCUST_DATA_POOL_SIZE', DEFAULT_POOL_SIZE))
 
+# Pre-encoded corpus shared by all workers (Native_Toolkit/tools/corpus_build,
+# layout in Native_Toolkit/common/payload_corpus.h). Every worker maps the
+# same file read-only, so startup is instant and every run sends the same bytes.
+CORPUS_PATH = os.environ.get('LOCUST_CORPUS')
+
+# Native codecs (Native_Toolkit/python/native_codecs.c): the C encoders of the
+# host tools, byte for byte, at native speed. Used when the extension is built;
+# NATIVE_CODECS=0 keeps the Python encoders.
+NATIVE_CODECS_DIR = os.environ.get('NATIVE_CODECS_DIR', os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', 'Native_Toolkit', 'python'))
+native_codecs = None
+if os.environ.get('NATIVE_CODECS', '1') != '0':
+    sys.path.insert(0, NATIVE_CODECS_DIR)
+    try:
+        import native_codecs
+    except ImportError:
+        pass
+
+class PayloadCorpus:
+    """Read-only mmap of a corpus file, indexed like the generated data pool"""
+    HEADER = struct.Struct('<8sII16sQqIIQ')
+    ENTRY = struct.Struct('<II')
+
+    def __init__(self, path, codec):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, count, name, self.seed, self.time_base,
+         crc, _, payload_bytes) = self.HEADER.unpack_from(self._map, 0)
+        name = name.rstrip(b'\0').decode()
+        if magic != b'IPCORP1\0' or version != 1:
+            raise ValueError(f"{path}: not a payload corpus")
+        if name != codec:
+            raise ValueError(f"{path}: corpus holds {name} payloads, this sender sends {codec}")
+        self._data = self.HEADER.size + self.ENTRY.size * count
+        if count == 0 or len(self._map) != self._data + payload_bytes:
+            raise ValueError(f"{path}: truncated corpus")
+        with memoryview(self._map) as view, view[self.HEADER.size:] as body:
+            if zlib.crc32(body) != crc:
+                raise ValueError(f"{path}: corpus CRC mismatch")
+        self.count = count
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, i):
+        offset, length = self.ENTRY.unpack_from(self._map, self.HEADER.size + self.ENTRY.size * i)
+        start = self._data + offset
+        return {'compressed': self._map[start:start + length], 'size': length}
+
 def cbor_compress(data: dict) -> bytes:
     """Pure CBOR compression: directly encode JSON data with CBOR"""
+    if native_codecs:
+        return native_codecs.encode('cbor', data)
     return cbor2.dumps(data)
 
+def cbor_compress_batch(records: list) -> list:
+    """Encode a list of records, in one native call when available"""
+    if native_codecs:
+        payloads, offsets = native_codecs.encode_batch('cbor', records)
+        return [payloads[offsets[i]:offsets[i + 1]] for i in range(len(records))]
+    return [cbor_compress(data) for data in records]
+
 class ContainerDataSender(HttpUser):
     wait_time = between(1, 3)  # Wait 1-3 seconds between requests
     
@@ -49,6 +111,13 @@ class ContainerDataSender(HttpUser):
         is_master = "--master" in sys.argv
         worker_label = "WORKER" if is_worker else "MASTER" if is_master else "SINGLE"
         
+        if CORPUS_PATH:
+            cls._data_pool = PayloadCorpus(CORPUS_PATH, 'cbor')
+            cls._pool_initialized = True
+            logger.info(f"[{worker_label}] Mapped corpus {CORPUS_PATH}: {len(cls._data_pool):,} payloads "
+                        f"(seed {cls._data_pool.seed})")
+            return
+        
         logger.info(f"[{worker_label}] Pre-generating {cls._data_pool_size:,} container data records...")
         
         cls._data_pool = []
@@ -63,18 +132,18 @@ class ContainerDataSender(HttpUser):
             batch_generated = 0
             
             while batch_generated < batch_target:
-                data = generate_test_container_data()
-                compressed = cbor_compress(data)
-                size = len(compressed)
+                records = [generate_test_container_data() for _ in range(batch_target - batch_generated)]
+                for data, compressed in zip(records, cbor_compress_batch(records)):
+                    size = len(compressed)
                 
-                cls._data_pool.append({
-                    'original': data,
-                    'compressed': compressed,
-                    'size': size
-                })
+                    cls._data_pool.append({
+                        'original': data,
+                        'compressed': compressed,
+                        'size': size
+                    })
                 
-                batch_generated += 1
-                generated_count += 1
+                    batch_generated += 1
+                    generated_count += 1
             
             progress = (generated_count / cls._data_pool_size) * 100
             elapsed = time.time() - start_time
@@ -220,6 +289,9 @@ def test_compression():
     print(f"   CBOR ratio vs JSON: {len(json_bytes) / len(cbor_data):.2f}x")
     print(f"   Size reduction: {len(json_bytes) - len(cbor_data)} bytes ({((len(json_bytes) - len(cbor_data)) / len(json_bytes) * 100):.1f}%)")
     
+    if native_codecs:
+        print(f"   Native encoder matches cbor2: {'YES' if cbor_data == cbor2.dumps(sample_data) else 'NO'}")
+    
     # Test decompression
     try:
         decompressed = cbor2.loads(cbor_data)
@@ -307,3 +379,5 @@ if __name__ == "__main__":
         print("Environment Variables:")
         print(f"  LOCUST_DATA_POOL_SIZE={DATA_POOL_SIZE:,} (default: {DEFAULT_POOL_SIZE:,})")
         print("    Controls pre-generated data pool size per worker") 
+        print("  LOCUST_CORPUS=<file> (default: unset)")
+        print("    Send payloads from a corpus_build file instead of generating them")
@@ -6,6 +6,9 @@
 
 const express = require('express');
 const cbor = require('cbor');
+const { AdmissionController } = require('./admission');
+const { EventLog } = require('./event_log');
+const { BatchIngest, FORMATS, STATUS } = require('./batch_frame');
 const app = express();
 
 // Configuration
@@ -15,6 +18,18 @@ const OUTBOUND_URL = process.env.OUTBOUND_URL || null; // Outbound URL
 const OUTBOUND_RETRY_INTERVAL = 5000; // Outbound retry interval
 const MAX_RETRY_ATTEMPTS = 100; // Maximum number of retry attempts
 
+// Hot-path messages go to the binary event log (render with `npm run logs`)
+const events = new EventLog();
+const EVENTS = {
+    batchStart: events.define('info', 'Processing {} messages from queue...'),
+    messageError: events.define('error', 'Error processing message: {}'),
+    batchDone: events.define('info', 'Batch processed: {} messages'),
+    totals: events.define('info', 'Total: {} processed, {} errors, Rate: {} msg/sec'),
+    outboundGiveUp: events.define('warn', 'Giving up on item {} after {} attempts'),
+    receiveError: events.define('error', 'Error receiving container data: {}'),
+    unhandled: events.define('error', 'Unhandled error: {}')
+};
+
 // CBOR decompression
 function cborDecompress(compressedData) {
     try {
@@ -55,7 +70,7 @@ class MessageQueue {
     processQueue() {
         if (this.queue.length === 0) return;
         
-        console.log(`Processing ${this.queue.length} messages from queue...`);
+        events.emit(EVENTS.batchStart, this.queue.length);
         const batch = this.queue.splice(0);
         
         batch.forEach(message => {
@@ -63,21 +78,23 @@ class MessageQueue {
                 this.processMessage(message);
                 this.processed++;
             } catch (error) {
-                console.error('Error processing message:', error.message);
+                events.emit(EVENTS.messageError, error.message);
                 this.errors++;
             }
         });
         
         if (batch.length > 0) {
-            console.log(`Batch processed: ${batch.length} messages`);
-            console.log(`Total: ${this.processed} processed, ${this.errors} errors, Rate: ${(this.processed / ((Date.now() - this.startTime) / 1000)).toFixed(1)} msg/sec`);
+            events.emit(EVENTS.batchDone, batch.length);
+            const rate = this.processed / ((Date.now() - this.startTime) / 1000);
+            events.emit(EVENTS.totals, this.processed, this.errors, Math.round(rate * 10) / 10);
         }
     }
     
     processMessage(message) {
         const { compressedData, receivedAt, queuedAt } = message;
         
-        const containerData = cborDecompress(compressedData);
+        // Batch items arrive decoded
+        const containerData = message.containerData || cborDecompress(compressedData);
         
         if (!containerData || typeof containerData !== 'object') {
             throw new Error('Invalid decompressed data structure');
@@ -195,7 +212,7 @@ class OutboundQueue {
         } catch (error) {
             if (item.attempts >= MAX_RETRY_ATTEMPTS) {
                 this.totalErrors++;
-                console.log(`Giving up on item ${item.id} after ${MAX_RETRY_ATTEMPTS} attempts`);
+                events.emit(EVENTS.outboundGiveUp, item.id, MAX_RETRY_ATTEMPTS);
                 item.attempts = 0;
             } else {
                 const delay = Math.min(OUTBOUND_RETRY_INTERVAL * Math.pow(2, item.attempts - 1), 60000);
@@ -221,6 +238,14 @@ class OutboundQueue {
 // Initialize queues
 const messageQueue = new MessageQueue();
 const outboundQueue = new OutboundQueue();
+const admission = new AdmissionController(() => ({
+    depth: messageQueue.queue.length,
+    oldestQueuedAt: messageQueue.queue.length ? messageQueue.queue[0].queuedAt : null,
+    outboundDepth: outboundQueue.queue.length,
+    processed: messageQueue.processed,
+    sent: outboundQueue.totalSent
+}), { drainIntervalMs: QUEUE_PROCESS_INTERVAL });
+const batches = new BatchIngest();
 
 // Middleware
 app.use(express.raw({ type: 'application/octet-stream', limit: '1mb' }));
@@ -230,7 +255,7 @@ app.use(express.json());
 app.use((req, res, next) => {
     res.header('Access-Control-Allow-Origin', '*');
     res.header('Access-Control-Allow-Methods', 'GET, POST, PUT, DELETE, OPTIONS');
-    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization');
+    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization, X-Priority');
     
     if (req.method === 'OPTIONS') {
         res.sendStatus(200);
@@ -243,12 +268,15 @@ app.use((req, res, next) => {
 app.get('/health', (req, res) => {
     const inboundStats = messageQueue.getStats();
     const outboundStats = outboundQueue.getStats();
+    const admissionStats = admission.getStats();
     
+    // Still 200 while shedding: the replica is up and admitting alarms
     res.json({
-        status: 'healthy',
+        status: admissionStats.level === 'normal' ? 'healthy' : 'degraded',
         timestamp: new Date().toISOString(),
         inbound: inboundStats,
-        outbound: outboundStats
+        outbound: outboundStats,
+        admission: admissionStats
     });
 });
 
@@ -260,7 +288,10 @@ app.get('/stats', (req, res) => {
     res.json({
         timestamp: new Date().toISOString(),
         inbound: inboundStats,
-        outbound: outboundStats
+        outbound: outboundStats,
+        admission: admission.getStats(),
+        batch: batches.getStats(),
+        eventLog: events.getStats()
     });
 });
 
@@ -283,6 +314,12 @@ app.post('/container-data', (req, res) => {
             });
         }
         
+        // Under load routine telemetry is shed; alarms are still admitted
+        const decision = admission.admit(req, () => cborDecompress(compressedData));
+        if (!decision.admitted) {
+            return admission.reject(res, decision);
+        }
+        
         messageQueue.add({
             compressedData: compressedData,
             receivedAt: Date.now(),
@@ -297,7 +334,47 @@ app.post('/container-data', (req, res) => {
         });
         
     } catch (error) {
-        console.error('Error receiving container data:', error.message);
+        events.emit(EVENTS.receiveError, error.message);
+        res.status(500).json({
+            error: 'Processing error',
+            message: error.message
+        });
+    }
+});
+
+// Batch endpoint: many payloads per request (batch_frame.js), one status each
+app.post('/container-data/batch', (req, res) => {
+    try {
+        let items;
+        try {
+            items = batches.parse(req.body);
+        } catch (error) {
+            return res.status(400).json({
+                error: 'Invalid batch',
+                message: error.message
+            });
+        }
+        
+        const receivedAt = Date.now();
+        const status = batches.ingest(items, item => {
+            if (item.format !== FORMATS.default && item.format !== FORMATS.cbor) return STATUS.REJECTED;
+            const containerData = cborDecompress(item.payload);
+            if (!admission.admit(req, () => containerData).admitted) return STATUS.RETRY;
+            messageQueue.add({
+                compressedData: item.payload,
+                containerData: containerData,
+                receivedAt: receivedAt,
+                size: item.payload.length
+            });
+            return STATUS.ACCEPTED;
+        });
+        
+        batches.reply(req, res, status, () => admission.retryAfter(), {
+            queueSize: messageQueue.queue.length
+        });
+        
+    } catch (error) {
+        events.emit(EVENTS.receiveError, error.message);
         res.status(500).json({
             error: 'Processing error',
             message: error.message
@@ -307,7 +384,7 @@ app.post('/container-data', (req, res) => {
 
 // Error handling middleware
 app.use((error, req, res, next) => {
-    console.error('Unhandled error:', error);
+    events.emit(EVENTS.unhandled, error.stack || error.message);
     res.status(500).json({
         error: 'Internal server error',
         message: error.message
@@ -342,10 +419,13 @@ app.listen(PORT, () => {
     console.log('='.repeat(60));
     console.log(`Listening on port ${PORT}`);
     console.log(`Main endpoint: POST /container-data`);
+    console.log(`Batch endpoint: POST /container-data/batch (up to ${batches.maxItems} items)`);
     console.log(`Health check: GET /health`);
     console.log(`Statistics: GET /stats`);
     console.log(`Queue processing: every ${QUEUE_PROCESS_INTERVAL}ms`);
     console.log(`Compression method: CBOR`);
+    console.log(`Admission control: ${admission.enabled ? 'on' : 'off'}`);
+    console.log(`Event log: ${events.mode}`);
     console.log(`Content-Type: application/octet-stream`);
     console.log('='.repeat(60));
 });
@@ -0,0 +1,192 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Batch ingest for POST /container-data/batch (mirrors Native_Toolkit/firmware/batch_frame.c).
+//
+// Request body:
+//   [0xB1][flags u8][count u16 BE] then count items of
+//   [format u8, if flags & 1][id length u8 + device id, if flags & 2]
+//   [payload length, LEB128 varint of at most 3 bytes][payload]
+// Format tags: 0 = the endpoint's codec, 1 cbor, 2 msgpack, 3 protobuf,
+// 4 struct-zlib, 5 struct-rans, 6 deflate session frame.
+//
+// The whole frame is parsed before anything is queued, so a malformed
+// batch is answered 400 and can be resent as is. Every item is then
+// decoded once, here, and gets a 2-bit status, four per byte, item i in
+// byte i >> 2 at bit 2 * (i & 3): 0 accepted, 1 rejected (do not resend),
+// 2 retry (shed under load), 3 resync (session frame while the device
+// waits for a keyframe). The reply is JSON with the status bytes in
+// base64, or [count u16 BE][status bytes] for Accept: application/octet-stream.
+
+const MAGIC = 0xB1;
+const HEADER_SIZE = 4;
+const FLAG_FORMAT = 0x01;
+const FLAG_DEVICE = 0x02;
+const MAX_ITEMS = 65535;
+
+const FORMATS = {
+    default: 0,
+    cbor: 1,
+    msgpack: 2,
+    protobuf: 3,
+    'struct-zlib': 4,
+    'struct-rans': 5,
+    session: 6
+};
+const STATUS = { ACCEPTED: 0, REJECTED: 1, RETRY: 2, RESYNC: 3 };
+const STATUS_NAMES = ['accepted', 'rejected', 'retry', 'resync'];
+
+const envNumber = (name, def) => {
+    const value = parseInt(process.env[name], 10);
+    return Number.isFinite(value) && value > 0 ? value : def;
+};
+
+// Returns [{ format, deviceId, payload }]; payloads are views into body.
+// Throws on any framing error.
+function parseBatch(body, maxItems = MAX_ITEMS) {
+    if (!Buffer.isBuffer(body) || body.length < HEADER_SIZE) throw new Error('Truncated batch header');
+    if (body[0] !== MAGIC) throw new Error(`Not a batch frame (first byte 0x${body[0].toString(16)})`);
+    const flags = body[1];
+    if (flags & ~(FLAG_FORMAT | FLAG_DEVICE)) throw new Error(`Unknown batch flags 0x${flags.toString(16)}`);
+    const count = body.readUInt16BE(2);
+    if (count > maxItems) throw new Error(`Batch of ${count} items exceeds the limit of ${maxItems}`);
+
+    const items = new Array(count);
+    let pos = HEADER_SIZE;
+    for (let i = 0; i < count; i++) {
+        let format = FORMATS.default;
+        let deviceId = null;
+        if (flags & FLAG_FORMAT) {
+            if (pos >= body.length) throw new Error(`Item ${i}: truncated format tag`);
+            format = body[pos++];
+        }
+        if (flags & FLAG_DEVICE) {
+            if (pos >= body.length || pos + 1 + body[pos] > body.length) throw new Error(`Item ${i}: truncated device id`);
+            const idLength = body[pos++];
+            deviceId = idLength ? body.toString('utf8', pos, pos + idLength) : null;
+            pos += idLength;
+        }
+        let length = 0;
+        for (let shift = 0; ; shift += 7) {
+            if (pos >= body.length || shift === 21) throw new Error(`Item ${i}: bad length`);
+            const byte = body[pos++];
+            length |= (byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        if (pos + length > body.length) throw new Error(`Item ${i}: payload truncated`);
+        items[i] = { format, deviceId, payload: body.subarray(pos, pos + length) };
+        pos += length;
+    }
+    if (pos !== body.length) throw new Error(`${body.length - pos} bytes after the last item`);
+    return items;
+}
+
+// Sender side, for tests and gateways written in Node
+function buildBatch(items) {
+    const flags = (items.some(item => item.format) ? FLAG_FORMAT : 0) |
+        (items.some(item => item.deviceId) ? FLAG_DEVICE : 0);
+    const parts = [Buffer.from([MAGIC, flags, items.length >> 8, items.length & 0xFF])];
+    for (const { format = 0, deviceId = null, payload } of items) {
+        const head = [];
+        if (flags & FLAG_FORMAT) head.push(format);
+        const id = deviceId ? Buffer.from(String(deviceId), 'utf8') : Buffer.alloc(0);
+        if (flags & FLAG_DEVICE) head.push(id.length);
+        parts.push(Buffer.from(head));
+        if (flags & FLAG_DEVICE) parts.push(id);
+        const varint = [];
+        let v = payload.length;
+        while (v >= 0x80) {
+            varint.push((v & 0x7F) | 0x80);
+            v >>>= 7;
+        }
+        varint.push(v);
+        parts.push(Buffer.from(varint), payload);
+    }
+    return Buffer.concat(parts);
+}
+
+class BatchStatus {
+    constructor(count) {
+        this.count = count;
+        this.buffer = Buffer.alloc(2 + ((count + 3) >> 2));
+        this.buffer.writeUInt16BE(count, 0);
+        this.totals = [count, 0, 0, 0];
+    }
+
+    set(i, status) {
+        const shift = (i & 3) * 2;
+        const at = 2 + (i >> 2);
+        this.totals[(this.buffer[at] >> shift) & 3]--;
+        this.buffer[at] = (this.buffer[at] & ~(3 << shift)) | (status << shift);
+        this.totals[status]++;
+    }
+
+    get(i) {
+        return (this.buffer[2 + (i >> 2)] >> ((i & 3) * 2)) & 3;
+    }
+}
+
+class BatchIngest {
+    constructor({ maxItems = envNumber('BATCH_MAX_ITEMS', 1024) } = {}) {
+        this.maxItems = Math.min(maxItems, MAX_ITEMS);
+        this.stats = { requests: 0, malformed: 0, items: 0, accepted: 0, rejected: 0, retry: 0, resync: 0 };
+    }
+
+    parse(body) {
+        try {
+            return parseBatch(body, this.maxItems);
+        } catch (err) {
+            this.stats.malformed++;
+            throw err;
+        }
+    }
+
+    // handle(item, i) returns a STATUS; a throw counts as rejected
+    ingest(items, handle) {
+        const status = new BatchStatus(items.length);
+        items.forEach((item, i) => {
+            let result;
+            try {
+                result = handle(item, i);
+            } catch (err) {
+                result = STATUS.REJECTED;
+            }
+            if (result !== STATUS.ACCEPTED) status.set(i, result);
+        });
+        this.stats.requests++;
+        this.stats.items += items.length;
+        STATUS_NAMES.forEach((name, s) => { this.stats[name] += status.totals[s]; });
+        return status;
+    }
+
+    // 200 unless every item was shed (503); Retry-After whenever one was.
+    // retryAfter() is only called then.
+    reply(req, res, status, retryAfter, extra = {}) {
+        const shed = status.totals[STATUS.RETRY];
+        const overloaded = shed > 0 && shed === status.count;
+        if (shed) res.set('Retry-After', String(retryAfter()));
+        res.status(overloaded ? 503 : 200);
+        if ((req.get('Accept') || '').includes('application/octet-stream')) {
+            return res.type('application/octet-stream').send(status.buffer);
+        }
+        const counts = {};
+        STATUS_NAMES.forEach((name, s) => { counts[name] = status.totals[s]; });
+        return res.json({
+            status: overloaded ? 'overloaded' : 'received',
+            timestamp: new Date().toISOString(),
+            count: status.count,
+            ...counts,
+            statusMap: status.buffer.subarray(2).toString('base64'),
+            ...extra
+        });
+    }
+
+    getStats() {
+        return { ...this.stats, maxItems: this.maxItems };
+    }
+}
+
+module.exports = { BatchIngest, BatchStatus, parseBatch, buildBatch, FORMATS, STATUS };
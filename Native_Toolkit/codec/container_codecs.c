@@ -0,0 +1,495 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "container_codecs.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "record_rans.h"
+
+const char *const container_record_field_names[CONTAINER_RECORD_FIELDS] = {
+    "msisdn", "iso6346", "time", "rssi", "cgi", "ble-m", "bat-soc",
+    "acc", "temperature", "humidity", "pressure", "door", "gnss",
+    "latitude", "longitude", "altitude", "speed", "heading", "nsat", "hdop"
+};
+
+static const char *const codec_names[CONTAINER_CODEC_COUNT] = {
+    "cbor", "msgpack", "protobuf", "struct-zlib", "struct-rans"
+};
+
+const char *container_codec_name(container_codec_t codec) {
+    return codec < CONTAINER_CODEC_COUNT ? codec_names[codec] : "unknown";
+}
+
+int container_codec_parse(const char *name, container_codec_t *codec) {
+    for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+        if (!strcmp(name, codec_names[c])) {
+            *codec = (container_codec_t)c;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Same decimals as generate_test_container_data() in the CBOR/MessagePack senders
+int container_record_format(const container_record_t *rec,
+                            char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX]) {
+    snprintf(values[0], CONTAINER_RECORD_VALUE_MAX, "%s", rec->msisdn);
+    snprintf(values[1], CONTAINER_RECORD_VALUE_MAX, "%s", rec->iso6346);
+    snprintf(values[2], CONTAINER_RECORD_VALUE_MAX, "%s", rec->time);
+    snprintf(values[3], CONTAINER_RECORD_VALUE_MAX, "%u", rec->rssi);
+    snprintf(values[4], CONTAINER_RECORD_VALUE_MAX, "%s", rec->cgi);
+    snprintf(values[5], CONTAINER_RECORD_VALUE_MAX, "%u", rec->ble_m);
+    snprintf(values[6], CONTAINER_RECORD_VALUE_MAX, "%u", rec->bat_soc);
+    snprintf(values[7], CONTAINER_RECORD_VALUE_MAX, "%.4f %.4f %.4f", rec->acc[0], rec->acc[1], rec->acc[2]);
+    snprintf(values[8], CONTAINER_RECORD_VALUE_MAX, "%.2f", rec->temperature);
+    snprintf(values[9], CONTAINER_RECORD_VALUE_MAX, "%.2f", rec->humidity);
+    snprintf(values[10], CONTAINER_RECORD_VALUE_MAX, "%.4f", rec->pressure);
+    snprintf(values[11], CONTAINER_RECORD_VALUE_MAX, "%s", rec->door);
+    snprintf(values[12], CONTAINER_RECORD_VALUE_MAX, "%u", rec->gnss);
+    snprintf(values[13], CONTAINER_RECORD_VALUE_MAX, "%.4f", rec->latitude);
+    snprintf(values[14], CONTAINER_RECORD_VALUE_MAX, "%.4f", rec->longitude);
+    snprintf(values[15], CONTAINER_RECORD_VALUE_MAX, "%.2f", rec->altitude);
+    snprintf(values[16], CONTAINER_RECORD_VALUE_MAX, "%.1f", rec->speed);
+    snprintf(values[17], CONTAINER_RECORD_VALUE_MAX, "%.2f", rec->heading);
+    snprintf(values[18], CONTAINER_RECORD_VALUE_MAX, "%02u", rec->nsat);
+    snprintf(values[19], CONTAINER_RECORD_VALUE_MAX, "%.1f", rec->hdop);
+    return 0;
+}
+
+// ================= PARSING =================
+static int parse_string(const char *s, char *dst, size_t cap) {
+    size_t len = strlen(s);
+    if (len >= cap) return -1;
+    memcpy(dst, s, len + 1);
+    return 0;
+}
+
+static int at_end(const char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    return *s == '\0';
+}
+
+// int() then struct 'B'
+static int parse_u8(const char *s, uint8_t *v) {
+    char *end;
+    long x = strtol(s, &end, 10);
+    if (end == s || !at_end(end) || x < 0 || x > 255) return -1;
+    *v = (uint8_t)x;
+    return 0;
+}
+
+// float() then float32: round the double, not the decimal, so ties match Python
+static int parse_f32(const char *s, float *v) {
+    char *end;
+    double x = strtod(s, &end);
+    if (end == s || !at_end(end)) return -1;
+    *v = (float)x;
+    return 0;
+}
+
+static int parse_acc(const char *s, float acc[3]) {
+    for (int i = 0; i < 3; i++) {
+        while (isspace((unsigned char)*s) || *s == ',') s++;
+        char *end;
+        double x = strtod(s, &end);
+        if (end == s) return -1;
+        acc[i] = (float)x;
+        s = end;
+    }
+    return at_end(s) ? 0 : -1;
+}
+
+int container_record_parse(const char *const values[CONTAINER_RECORD_FIELDS], container_record_t *rec) {
+    memset(rec, 0, sizeof(*rec));
+    return parse_string(values[0], rec->msisdn, sizeof(rec->msisdn)) ||
+           parse_string(values[1], rec->iso6346, sizeof(rec->iso6346)) ||
+           parse_string(values[2], rec->time, sizeof(rec->time)) ||
+           parse_u8(values[3], &rec->rssi) ||
+           parse_string(values[4], rec->cgi, sizeof(rec->cgi)) ||
+           parse_u8(values[5], &rec->ble_m) ||
+           parse_u8(values[6], &rec->bat_soc) ||
+           parse_acc(values[7], rec->acc) ||
+           parse_f32(values[8], &rec->temperature) ||
+           parse_f32(values[9], &rec->humidity) ||
+           parse_f32(values[10], &rec->pressure) ||
+           parse_string(values[11], rec->door, sizeof(rec->door)) ||
+           parse_u8(values[12], &rec->gnss) ||
+           parse_f32(values[13], &rec->latitude) ||
+           parse_f32(values[14], &rec->longitude) ||
+           parse_f32(values[15], &rec->altitude) ||
+           parse_f32(values[16], &rec->speed) ||
+           parse_f32(values[17], &rec->heading) ||
+           parse_u8(values[18], &rec->nsat) ||
+           parse_f32(values[19], &rec->hdop) ? -1 : 0;
+}
+
+// ================= CBOR / MESSAGEPACK =================
+typedef struct {
+    uint8_t *p;
+    uint8_t *end;
+} writer_t;
+
+static int put(writer_t *w, const void *data, size_t len) {
+    if ((size_t)(w->end - w->p) < len) return -1;
+    memcpy(w->p, data, len);
+    w->p += len;
+    return 0;
+}
+
+static int put_byte(writer_t *w, uint8_t b) {
+    return put(w, &b, 1);
+}
+
+// Major type 3 (text string), shortest length form like cbor2
+static int cbor_text(writer_t *w, const char *s) {
+    size_t len = strlen(s);
+    if (len < 24) {
+        if (put_byte(w, (uint8_t)(0x60 | len))) return -1;
+    } else if (len < 256) {
+        if (put_byte(w, 0x78) || put_byte(w, (uint8_t)len)) return -1;
+    } else {
+        return -1;
+    }
+    return put(w, s, len);
+}
+
+// fixstr for up to 31 bytes, str8 above (use_bin_type=True)
+static int msgpack_str(writer_t *w, const char *s) {
+    size_t len = strlen(s);
+    if (len < 32) {
+        if (put_byte(w, (uint8_t)(0xA0 | len))) return -1;
+    } else if (len < 256) {
+        if (put_byte(w, 0xD9) || put_byte(w, (uint8_t)len)) return -1;
+    } else {
+        return -1;
+    }
+    return put(w, s, len);
+}
+
+static size_t encode_map_values(const char *const values[CONTAINER_RECORD_FIELDS], uint8_t *buf, size_t cap,
+                                int msgpack) {
+    writer_t w = { buf, buf + cap };
+    // 20 entries: CBOR map with 1-byte length, MessagePack map16 (fixmap stops at 15)
+    int rc = msgpack ? put(&w, "\xDE\x00\x14", 3) : put(&w, "\xB4", 1);
+    for (int f = 0; f < CONTAINER_RECORD_FIELDS && rc == 0; f++) {
+        rc = msgpack ? msgpack_str(&w, container_record_field_names[f]) || msgpack_str(&w, values[f])
+                     : cbor_text(&w, container_record_field_names[f]) || cbor_text(&w, values[f]);
+    }
+    return rc == 0 ? (size_t)(w.p - buf) : 0;
+}
+
+static size_t encode_map(const container_record_t *rec, uint8_t *buf, size_t cap, int msgpack) {
+    char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX];
+    const char *v[CONTAINER_RECORD_FIELDS];
+    container_record_format(rec, values);
+    for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) v[f] = values[f];
+    return encode_map_values(v, buf, cap, msgpack);
+}
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} reader_t;
+
+static int get(reader_t *r, size_t len, const uint8_t **data) {
+    if ((size_t)(r->end - r->p) < len) return -1;
+    *data = r->p;
+    r->p += len;
+    return 0;
+}
+
+static int get_uint(reader_t *r, size_t bytes, size_t *v) {
+    const uint8_t *d;
+    if (get(r, bytes, &d)) return -1;
+    *v = 0;
+    for (size_t i = 0; i < bytes; i++) *v = *v << 8 | d[i];
+    return 0;
+}
+
+// CBOR: map (major 5) or text (major 3) header with an inline, 1- or 2-byte length
+static int cbor_header(reader_t *r, uint8_t major, size_t *len) {
+    const uint8_t *d;
+    if (get(r, 1, &d) || *d >> 5 != major) return -1;
+    uint8_t info = *d & 0x1F;
+    if (info < 24) *len = info;
+    else if (info == 24 || info == 25) return get_uint(r, info == 24 ? 1 : 2, len);
+    else return -1;
+    return 0;
+}
+
+// MessagePack: fixmap/map16 or fixstr/str8/str16
+static int msgpack_header(reader_t *r, int map, size_t *len) {
+    const uint8_t *d;
+    if (get(r, 1, &d)) return -1;
+    if (map) {
+        if ((*d & 0xF0) == 0x80) *len = *d & 0x0F;
+        else if (*d == 0xDE) return get_uint(r, 2, len);
+        else return -1;
+    } else {
+        if ((*d & 0xE0) == 0xA0) *len = *d & 0x1F;
+        else if (*d == 0xD9 || *d == 0xDA) return get_uint(r, *d == 0xD9 ? 1 : 2, len);
+        else return -1;
+    }
+    return 0;
+}
+
+static int map_text(reader_t *r, int msgpack, const uint8_t **s, size_t *len) {
+    int rc = msgpack ? msgpack_header(r, 0, len) : cbor_header(r, 3, len);
+    return rc || get(r, *len, s);
+}
+
+static int decode_map(const uint8_t *buf, size_t len, int msgpack,
+                      char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX]) {
+    reader_t r = { buf, buf + len };
+    size_t count;
+    if ((msgpack ? msgpack_header(&r, 1, &count) : cbor_header(&r, 5, &count)) || count != CONTAINER_RECORD_FIELDS)
+        return -1;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *key, *value;
+        size_t key_len, value_len;
+        if (map_text(&r, msgpack, &key, &key_len) || map_text(&r, msgpack, &value, &value_len)) return -1;
+        int f = 0;
+        while (f < CONTAINER_RECORD_FIELDS && (strlen(container_record_field_names[f]) != key_len ||
+                                               memcmp(container_record_field_names[f], key, key_len)))
+            f++;
+        if (f == CONTAINER_RECORD_FIELDS || (seen >> f & 1) || value_len >= CONTAINER_RECORD_VALUE_MAX) return -1;
+        seen |= 1u << f;
+        memcpy(values[f], value, value_len);
+        values[f][value_len] = '\0';
+    }
+    return r.p == r.end ? 0 : -1;
+}
+
+// ================= PROTOBUF =================
+static int pb_varint(writer_t *w, uint32_t v) {
+    while (v >= 0x80) {
+        if (put_byte(w, (uint8_t)(v | 0x80))) return -1;
+        v >>= 7;
+    }
+    return put_byte(w, (uint8_t)v);
+}
+
+// proto3 omits fields that hold the default value
+static int pb_string(writer_t *w, uint32_t field, const char *s) {
+    size_t len = strlen(s);
+    if (len == 0) return 0;
+    return pb_varint(w, field << 3 | 2) || pb_varint(w, (uint32_t)len) || put(w, s, len);
+}
+
+static int pb_uint(writer_t *w, uint32_t field, uint32_t v) {
+    if (v == 0) return 0;
+    return pb_varint(w, field << 3) || pb_varint(w, v);
+}
+
+static int pb_float(writer_t *w, uint32_t field, float v) {
+    if (v == 0.0f) return 0;
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint8_t le[4] = { (uint8_t)bits, (uint8_t)(bits >> 8), (uint8_t)(bits >> 16), (uint8_t)(bits >> 24) };
+    return pb_varint(w, field << 3 | 5) || put(w, le, sizeof(le));
+}
+
+// Field numbers of container_data.proto, serialized in field order like SerializeToString
+static size_t encode_protobuf(const container_record_t *rec, uint8_t *buf, size_t cap) {
+    writer_t w = { buf, buf + cap };
+    int rc = pb_string(&w, 1, rec->msisdn) || pb_string(&w, 2, rec->iso6346) || pb_string(&w, 3, rec->time) ||
+             pb_string(&w, 4, rec->cgi) || pb_string(&w, 5, rec->door) ||
+             pb_uint(&w, 6, rec->rssi) || pb_uint(&w, 7, rec->ble_m) || pb_uint(&w, 8, rec->bat_soc) ||
+             pb_uint(&w, 9, rec->gnss) || pb_uint(&w, 10, rec->nsat) ||
+             pb_float(&w, 11, rec->acc[0]) || pb_float(&w, 12, rec->acc[1]) || pb_float(&w, 13, rec->acc[2]) ||
+             pb_float(&w, 14, rec->temperature) || pb_float(&w, 15, rec->humidity) ||
+             pb_float(&w, 16, rec->pressure) || pb_float(&w, 17, rec->latitude) ||
+             pb_float(&w, 18, rec->longitude) || pb_float(&w, 19, rec->altitude) ||
+             pb_float(&w, 20, rec->speed) || pb_float(&w, 21, rec->heading) || pb_float(&w, 22, rec->hdop);
+    return rc == 0 ? (size_t)(w.p - buf) : 0;
+}
+
+static int pb_get_varint(reader_t *r, uint64_t *v) {
+    *v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const uint8_t *d;
+        if (get(r, 1, &d)) return -1;
+        *v |= (uint64_t)(*d & 0x7F) << shift;
+        if (!(*d & 0x80)) return 0;
+    }
+    return -1;
+}
+
+static int decode_protobuf(const uint8_t *buf, size_t len, container_record_t *rec) {
+    char *strings[5] = { rec->msisdn, rec->iso6346, rec->time, rec->cgi, rec->door };
+    size_t string_caps[5] = { sizeof(rec->msisdn), sizeof(rec->iso6346), sizeof(rec->time), sizeof(rec->cgi),
+                              sizeof(rec->door) };
+    uint8_t *uints[5] = { &rec->rssi, &rec->ble_m, &rec->bat_soc, &rec->gnss, &rec->nsat };
+    float *floats[12] = { &rec->acc[0], &rec->acc[1], &rec->acc[2], &rec->temperature, &rec->humidity,
+                          &rec->pressure, &rec->latitude, &rec->longitude, &rec->altitude, &rec->speed,
+                          &rec->heading, &rec->hdop };
+
+    memset(rec, 0, sizeof(*rec));
+    reader_t r = { buf, buf + len };
+    while (r.p < r.end) {
+        uint64_t tag, v;
+        const uint8_t *d;
+        if (pb_get_varint(&r, &tag)) return -1;
+        uint64_t field = tag >> 3;
+        switch (tag & 7) {
+        case 0:
+            if (pb_get_varint(&r, &v)) return -1;
+            if (field >= 6 && field <= 10) {
+                if (v > 255) return -1;
+                *uints[field - 6] = (uint8_t)v;
+            }
+            break;
+        case 2:
+            if (pb_get_varint(&r, &v) || v > (uint64_t)(r.end - r.p) || get(&r, (size_t)v, &d)) return -1;
+            if (field >= 1 && field <= 5) {
+                if (v >= string_caps[field - 1]) return -1;
+                memcpy(strings[field - 1], d, (size_t)v);
+                strings[field - 1][v] = '\0';
+            }
+            break;
+        case 5:
+            if (get(&r, 4, &d)) return -1;
+            if (field >= 11 && field <= 22) {
+                uint32_t bits = (uint32_t)d[0] | (uint32_t)d[1] << 8 | (uint32_t)d[2] << 16 | (uint32_t)d[3] << 24;
+                memcpy(floats[field - 11], &bits, sizeof(bits));
+            }
+            break;
+        case 1:
+            if (get(&r, 8, &d)) return -1;
+            break;
+        default:
+            return -1;
+        }
+        // A known field sent with another wire type
+        if ((field >= 1 && field <= 5 && (tag & 7) != 2) || (field >= 6 && field <= 10 && (tag & 7) != 0) ||
+            (field >= 11 && field <= 22 && (tag & 7) != 5))
+            return -1;
+    }
+    return 0;
+}
+
+// ================= STRUCT =================
+static size_t encode_struct(const container_record_t *rec, uint8_t *buf, size_t cap, int rans) {
+    uint8_t packed[CONTAINER_RECORD_STRUCT_MAX];
+    size_t len = container_record_pack_struct(rec, packed, sizeof(packed));
+    if (!len) return 0;
+    if (rans) return record_rans_encode(packed, len, buf, cap);
+
+    uLongf n = cap;
+    return compress2(buf, &n, packed, len, Z_BEST_COMPRESSION) == Z_OK ? (size_t)n : 0;
+}
+
+static int decode_struct(const uint8_t *buf, size_t len, int rans, container_record_t *rec) {
+    uint8_t packed[RECORD_RANS_MAX_RECORD];
+    int n;
+    if (rans) {
+        n = record_rans_decode(buf, len, packed, sizeof(packed));
+    } else {
+        uLongf out = sizeof(packed);
+        n = uncompress(packed, &out, buf, len) == Z_OK ? (int)out : -1;
+    }
+    return n < 0 ? -1 : container_record_unpack_struct(packed, (size_t)n, rec);
+}
+
+size_t container_codec_encode(container_codec_t codec, const container_record_t *rec, uint8_t *buf, size_t cap) {
+    switch (codec) {
+    case CONTAINER_CODEC_CBOR: return encode_map(rec, buf, cap, 0);
+    case CONTAINER_CODEC_MSGPACK: return encode_map(rec, buf, cap, 1);
+    case CONTAINER_CODEC_PROTOBUF: return encode_protobuf(rec, buf, cap);
+    case CONTAINER_CODEC_STRUCT_ZLIB: return encode_struct(rec, buf, cap, 0);
+    case CONTAINER_CODEC_STRUCT_RANS: return encode_struct(rec, buf, cap, 1);
+    default: return 0;
+    }
+}
+
+size_t container_codec_encode_values(container_codec_t codec, const char *const values[CONTAINER_RECORD_FIELDS],
+                                     uint8_t *buf, size_t cap) {
+    if (codec == CONTAINER_CODEC_CBOR || codec == CONTAINER_CODEC_MSGPACK)
+        return encode_map_values(values, buf, cap, codec == CONTAINER_CODEC_MSGPACK);
+    container_record_t rec;
+    return container_record_parse(values, &rec) ? 0 : container_codec_encode(codec, &rec, buf, cap);
+}
+
+int container_codec_decode(container_codec_t codec, const uint8_t *buf, size_t len,
+                           char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX]) {
+    container_record_t rec;
+    switch (codec) {
+    case CONTAINER_CODEC_CBOR: return decode_map(buf, len, 0, values);
+    case CONTAINER_CODEC_MSGPACK: return decode_map(buf, len, 1, values);
+    default: return container_codec_decode_record(codec, buf, len, &rec) ? -1 : container_record_format(&rec, values);
+    }
+}
+
+int container_codec_decode_record(container_codec_t codec, const uint8_t *buf, size_t len, container_record_t *rec) {
+    char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX];
+    const char *v[CONTAINER_RECORD_FIELDS];
+    switch (codec) {
+    case CONTAINER_CODEC_CBOR:
+    case CONTAINER_CODEC_MSGPACK:
+        if (decode_map(buf, len, codec == CONTAINER_CODEC_MSGPACK, values)) return -1;
+        for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) v[f] = values[f];
+        return container_record_parse(v, rec);
+    case CONTAINER_CODEC_PROTOBUF: return decode_protobuf(buf, len, rec);
+    case CONTAINER_CODEC_STRUCT_ZLIB: return decode_struct(buf, len, 0, rec);
+    case CONTAINER_CODEC_STRUCT_RANS: return decode_struct(buf, len, 1, rec);
+    default: return -1;
+    }
+}
+
+// Walks the map or the message until iso6346 and stops there
+int container_codec_peek_iso6346(container_codec_t codec, const uint8_t *buf, size_t len, char *out, size_t cap) {
+    reader_t r = { buf, buf + len };
+    const uint8_t *value = NULL;
+    size_t value_len = 0;
+
+    if (codec == CONTAINER_CODEC_CBOR || codec == CONTAINER_CODEC_MSGPACK) {
+        int msgpack = codec == CONTAINER_CODEC_MSGPACK;
+        size_t count;
+        if (msgpack ? msgpack_header(&r, 1, &count) : cbor_header(&r, 5, &count)) return -1;
+        for (size_t i = 0; i < count && !value; i++) {
+            const uint8_t *key, *v;
+            size_t key_len, v_len;
+            if (map_text(&r, msgpack, &key, &key_len) || map_text(&r, msgpack, &v, &v_len)) return -1;
+            if (key_len == 7 && !memcmp(key, "iso6346", 7)) {
+                value = v;
+                value_len = v_len;
+            }
+        }
+    } else if (codec == CONTAINER_CODEC_PROTOBUF) {
+        while (r.p < r.end && !value) {
+            uint64_t tag, v;
+            const uint8_t *d;
+            if (pb_get_varint(&r, &tag)) return -1;
+            switch (tag & 7) {
+            case 0: if (pb_get_varint(&r, &v)) return -1; break;
+            case 1: if (get(&r, 8, &d)) return -1; break;
+            case 5: if (get(&r, 4, &d)) return -1; break;
+            case 2:
+                if (pb_get_varint(&r, &v) || v > (uint64_t)(r.end - r.p) || get(&r, (size_t)v, &d)) return -1;
+                if (tag >> 3 == 2) {
+                    value = d;
+                    value_len = (size_t)v;
+                }
+                break;
+            default: return -1;
+            }
+        }
+        // proto3 leaves out an empty string
+        if (!value) value = buf;
+    } else {
+        return 1;
+    }
+    if (!value || value_len >= cap) return -1;
+    memcpy(out, value, value_len);
+    out[value_len] = '\0';
+    return 0;
+}
@@ -0,0 +1,94 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Host-side encoders producing the exact payloads of the four services.
+//
+//   cbor         CBOR_Service        cbor2.dumps(dict): map of 20 text fields
+//   msgpack      MessagePack_Service msgpack.packb(dict): map16 of 20 str fields
+//   protobuf     Protobuf_Service    ContainerData (container_data.proto), proto3
+//   struct-zlib  Struct_Zlib_Service struct packing + zlib level 9
+//   struct-rans  Struct_Zlib_Service struct packing + static rANS (record_rans.c)
+//
+// The text fields use the locust senders' formatting (decimals per field),
+// so a receiver decodes them to the same JSON document. Documents the
+// senders already hold as strings go through container_codec_encode_values
+// (cbor and msgpack write the strings unchanged, the others parse them like
+// the senders' int()/float()), and container_codec_decode reads any of the
+// five payloads back into a document. Link with firmware/record_rans.c and
+// -lz.
+
+#ifndef CONTAINER_CODECS_H
+#define CONTAINER_CODECS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "container_record.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTAINER_CODEC_MAX_PAYLOAD 512   // upper bound for every codec
+#define CONTAINER_RECORD_VALUE_MAX 64     // formatted field value, NUL included
+
+typedef enum {
+    CONTAINER_CODEC_CBOR,
+    CONTAINER_CODEC_MSGPACK,
+    CONTAINER_CODEC_PROTOBUF,
+    CONTAINER_CODEC_STRUCT_ZLIB,
+    CONTAINER_CODEC_STRUCT_RANS,
+    CONTAINER_CODEC_COUNT
+} container_codec_t;
+
+// Field names in document order (the senders' dict insertion order)
+extern const char *const container_record_field_names[CONTAINER_RECORD_FIELDS];
+
+// Sender-formatted string values, in document order. Returns 0.
+int container_record_format(const container_record_t *rec,
+                            char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX]);
+
+// Inverse of container_record_format: integers, floats parsed as a double
+// and rounded to float32 (Python float() then struct 'f' / protobuf float),
+// acc as three numbers separated by spaces or commas. Returns 0, or -1 on a
+// malformed value or a string too long for its field.
+int container_record_parse(const char *const values[CONTAINER_RECORD_FIELDS], container_record_t *rec);
+
+const char *container_codec_name(container_codec_t codec);
+
+// Returns 0 and sets *codec, or -1 for an unknown name
+int container_codec_parse(const char *name, container_codec_t *codec);
+
+// Encode one record. Returns the payload size, 0 if it does not fit in cap.
+size_t container_codec_encode(container_codec_t codec, const container_record_t *rec, uint8_t *buf, size_t cap);
+
+// Encode a document given as strings in document order. Returns the payload
+// size, 0 if it does not fit in cap or a value does not parse.
+size_t container_codec_encode_values(container_codec_t codec, const char *const values[CONTAINER_RECORD_FIELDS],
+                                     uint8_t *buf, size_t cap);
+
+// Decode a payload into a document. cbor and msgpack return their strings
+// as sent (keys in any order, all 20 required); protobuf and the struct
+// codecs decode the record and format it with container_record_format.
+// Returns 0, or -1 on a malformed payload.
+int container_codec_decode(container_codec_t codec, const uint8_t *buf, size_t len,
+                           char values[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX]);
+
+// Decode a payload into a record (cbor and msgpack values are parsed with
+// container_record_parse). Returns 0, or -1 on a malformed payload.
+int container_codec_decode_record(container_codec_t codec, const uint8_t *buf, size_t len, container_record_t *rec);
+
+// Device key without a full decode: the iso6346 string of a cbor, msgpack or
+// protobuf payload (NUL-terminated, cap bytes). Returns 0, -1 on a
+// malformed payload or a key that does not fit, 1 for the struct codecs
+// (their strings sit behind the compression; decode them instead).
+int container_codec_peek_iso6346(container_codec_t codec, const uint8_t *buf, size_t len, char *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTAINER_CODECS_H
@@ -0,0 +1,240 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "container_record.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static uint64_t gen_next(container_record_gen_t *g) {
+    // xorshift64*
+    g->rng ^= g->rng >> 12;
+    g->rng ^= g->rng << 25;
+    g->rng ^= g->rng >> 27;
+    return g->rng * 0x2545F4914F6CDD1Dull;
+}
+
+static double gen_uniform(container_record_gen_t *g) {
+    return (double)(gen_next(g) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Inclusive, like random.randint
+static int gen_int(container_record_gen_t *g, int lo, int hi) {
+    return lo + (int)(gen_next(g) % (uint64_t)(hi - lo + 1));
+}
+
+// The senders format with a fixed number of decimals before packing
+static float quantize(double value, int decimals) {
+    double scale = pow(10.0, decimals);
+    return (float)(round(value * scale) / scale);
+}
+
+// DDMMYY hhmmss.s
+static void format_time(container_record_t *rec, time_t stamp, int tenths) {
+    struct tm tm;
+    gmtime_r(&stamp, &tm);
+    snprintf(rec->time, sizeof(rec->time), "%02d%02d%02d %02d%02d%02d.%d",
+             tm.tm_mday, tm.tm_mon + 1, tm.tm_year % 100, tm.tm_hour, tm.tm_min, tm.tm_sec, tenths);
+}
+
+static double clamp(double value, double lo, double hi) {
+    return value < lo ? lo : value > hi ? hi : value;
+}
+
+void container_record_gen_init(container_record_gen_t *g, uint64_t seed, time_t time_base,
+                               uint32_t time_spread_s) {
+    g->rng = seed * 0x9E3779B97F4A7C15ull + 0xD1B54A32D192ED03ull;
+    if (g->rng == 0) g->rng = 1;
+    g->time_base = time_base;
+    g->time_spread_s = time_spread_s;
+}
+
+void container_record_generate(container_record_gen_t *g, container_record_t *rec) {
+    memset(rec, 0, sizeof(*rec));
+
+    snprintf(rec->msisdn, sizeof(rec->msisdn), "39360050%d", gen_int(g, 4800, 4999));
+    snprintf(rec->iso6346, sizeof(rec->iso6346), "LMCU%07d", gen_int(g, 1, 999999));
+
+    time_t stamp = g->time_base - (time_t)(gen_uniform(g) * g->time_spread_s);
+    format_time(rec, stamp, gen_int(g, 0, 9));
+
+    rec->rssi = (uint8_t)gen_int(g, 15, 35);
+    strcpy(rec->cgi, "999-01-1-31D41");
+    rec->ble_m = (uint8_t)gen_int(g, 0, 1);
+    double battery = 96.0 - gen_uniform(g) * 20.0;
+    rec->bat_soc = (uint8_t)(battery < 10.0 ? 10.0 : battery);
+
+    rec->acc[0] = quantize(-993.9 + gen_uniform(g) * 20.0, 4);
+    rec->acc[1] = quantize(-27.1 + gen_uniform(g) * 10.0, 4);
+    rec->acc[2] = quantize(-52.0 + gen_uniform(g) * 10.0, 4);
+    rec->temperature = quantize(17.0 + gen_uniform(g) * 10.0, 2);
+    rec->humidity = quantize(71.0 + gen_uniform(g) * 20.0 - 10.0, 2);
+    rec->pressure = quantize(1012.4 + gen_uniform(g) * 20.0 - 10.0, 4);
+
+    static const char doors[] = "DOCT";
+    rec->door[0] = doors[gen_int(g, 0, 3)];
+
+    rec->gnss = (uint8_t)gen_int(g, 0, 1);
+    rec->latitude = quantize(31.86 + (gen_uniform(g) - 0.5) * 0.5, 2);
+    rec->longitude = quantize(28.74 + (gen_uniform(g) - 0.5) * 0.5, 2);
+    rec->altitude = quantize(49.5 + gen_uniform(g) * 20.0 - 10.0, 2);
+    rec->speed = quantize(gen_uniform(g) * 40.0, 1);
+    rec->heading = quantize(gen_uniform(g) * 360.0, 2);
+    rec->nsat = (uint8_t)gen_int(g, 4, 12);
+    rec->hdop = quantize(0.5 + gen_uniform(g) * 5.0, 1);
+}
+
+void container_trace_init(container_trace_t *t, uint64_t seed, time_t start, uint32_t interval_s) {
+    container_record_gen_init(&t->gen, seed, start, 0);
+    container_record_generate(&t->gen, &t->rec);
+    t->rec.gnss = 1;
+    t->now = start;
+    t->interval_s = interval_s;
+}
+
+// Random walk around the previous sample, within the generator's ranges
+void container_trace_next(container_trace_t *t, container_record_t *rec) {
+    container_record_gen_t *g = &t->gen;
+    container_record_t *r = &t->rec;
+    double step = gen_uniform(g) - 0.5;
+
+    t->now += t->interval_s;
+    format_time(r, t->now, gen_int(g, 0, 9));
+
+    r->rssi = (uint8_t)clamp(r->rssi + gen_int(g, -1, 1), 15, 35);
+    if (gen_uniform(g) < 0.01) r->ble_m ^= 1;
+    if (r->bat_soc > 10 && gen_uniform(g) < 0.02) r->bat_soc--;
+
+    r->acc[0] = quantize(clamp(r->acc[0] + (gen_uniform(g) - 0.5) * 0.4, -993.9, -973.9), 4);
+    r->acc[1] = quantize(clamp(r->acc[1] + (gen_uniform(g) - 0.5) * 0.2, -27.1, -17.1), 4);
+    r->acc[2] = quantize(clamp(r->acc[2] + (gen_uniform(g) - 0.5) * 0.2, -52.0, -42.0), 4);
+    r->temperature = quantize(clamp(r->temperature + step * 0.1, 17.0, 27.0), 2);
+    r->humidity = quantize(clamp(r->humidity + (gen_uniform(g) - 0.5) * 0.4, 61.0, 81.0), 2);
+    r->pressure = quantize(clamp(r->pressure + (gen_uniform(g) - 0.5) * 0.1, 1002.4, 1022.4), 4);
+
+    static const char doors[] = "DOCT";
+    if (gen_uniform(g) < 0.02) r->door[0] = doors[gen_int(g, 0, 3)];
+
+    // Move along the heading at the current speed (1 degree ~ 111 km)
+    double dist_deg = r->speed * t->interval_s / 111000.0;
+    double heading_rad = r->heading * 3.14159265358979 / 180.0;
+    r->latitude = quantize(clamp(r->latitude + dist_deg * cos(heading_rad), 31.61, 32.11), 2);
+    r->longitude = quantize(clamp(r->longitude + dist_deg * sin(heading_rad), 28.49, 28.99), 2);
+    r->altitude = quantize(clamp(r->altitude + (gen_uniform(g) - 0.5) * 0.5, 39.5, 59.5), 2);
+    r->speed = quantize(clamp(r->speed + (gen_uniform(g) - 0.5) * 2.0, 0.0, 40.0), 1);
+    r->heading = quantize(fmod(r->heading + (gen_uniform(g) - 0.5) * 10.0 + 360.0, 360.0), 2);
+    r->nsat = (uint8_t)clamp(r->nsat + (gen_uniform(g) < 0.1 ? gen_int(g, -1, 1) : 0), 4, 12);
+    r->hdop = quantize(clamp(r->hdop + (gen_uniform(g) < 0.2 ? (gen_uniform(g) - 0.5) * 0.4 : 0.0), 0.5, 5.5), 1);
+
+    *rec = *r;
+}
+
+static uint8_t *put_str_len(uint8_t *p, const char *s) {
+    size_t len = strlen(s);
+    *p++ = (uint8_t)(len >> 8);
+    *p++ = (uint8_t)len;
+    return p;
+}
+
+static uint8_t *put_f32(uint8_t *p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    *p++ = (uint8_t)(bits >> 24);
+    *p++ = (uint8_t)(bits >> 16);
+    *p++ = (uint8_t)(bits >> 8);
+    *p++ = (uint8_t)bits;
+    return p;
+}
+
+size_t container_record_pack_struct(const container_record_t *rec, uint8_t *buf, size_t cap) {
+    const char *strings[] = { rec->msisdn, rec->iso6346, rec->time, rec->cgi, rec->door };
+    size_t total = 5 * 2 + 5 + 12 * 4;
+    for (size_t i = 0; i < 5; i++) total += strlen(strings[i]);
+    if (total > cap) return 0;
+
+    uint8_t *p = buf;
+    p = put_str_len(p, rec->msisdn);
+    p = put_str_len(p, rec->iso6346);
+    p = put_str_len(p, rec->time);
+    *p++ = rec->rssi;
+    p = put_str_len(p, rec->cgi);
+    *p++ = rec->ble_m;
+    *p++ = rec->bat_soc;
+    for (int i = 0; i < 3; i++) p = put_f32(p, rec->acc[i]);
+    p = put_f32(p, rec->temperature);
+    p = put_f32(p, rec->humidity);
+    p = put_f32(p, rec->pressure);
+    p = put_str_len(p, rec->door);
+    *p++ = rec->gnss;
+    p = put_f32(p, rec->latitude);
+    p = put_f32(p, rec->longitude);
+    p = put_f32(p, rec->altitude);
+    p = put_f32(p, rec->speed);
+    p = put_f32(p, rec->heading);
+    *p++ = rec->nsat;
+    p = put_f32(p, rec->hdop);
+
+    for (size_t i = 0; i < 5; i++) {
+        size_t len = strlen(strings[i]);
+        memcpy(p, strings[i], len);
+        p += len;
+    }
+    return (size_t)(p - buf);
+}
+
+static const uint8_t *get_str_len(const uint8_t *p, size_t *len) {
+    *len = (size_t)p[0] << 8 | p[1];
+    return p + 2;
+}
+
+static float get_f32(const uint8_t *p) {
+    uint32_t bits = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int container_record_unpack_struct(const uint8_t *buf, size_t len, container_record_t *rec) {
+    static const size_t fixed = 5 * 2 + 5 + 12 * 4;
+    if (len < fixed) return -1;
+    memset(rec, 0, sizeof(*rec));
+    char *strings[] = { rec->msisdn, rec->iso6346, rec->time, rec->cgi, rec->door };
+    size_t caps[] = { sizeof(rec->msisdn), sizeof(rec->iso6346), sizeof(rec->time), sizeof(rec->cgi),
+                      sizeof(rec->door) };
+    size_t lens[5];
+
+    const uint8_t *p = buf;
+    p = get_str_len(p, &lens[0]);
+    p = get_str_len(p, &lens[1]);
+    p = get_str_len(p, &lens[2]);
+    rec->rssi = *p++;
+    p = get_str_len(p, &lens[3]);
+    rec->ble_m = *p++;
+    rec->bat_soc = *p++;
+    for (int i = 0; i < 3; i++, p += 4) rec->acc[i] = get_f32(p);
+    rec->temperature = get_f32(p), p += 4;
+    rec->humidity = get_f32(p), p += 4;
+    rec->pressure = get_f32(p), p += 4;
+    p = get_str_len(p, &lens[4]);
+    rec->gnss = *p++;
+    rec->latitude = get_f32(p), p += 4;
+    rec->longitude = get_f32(p), p += 4;
+    rec->altitude = get_f32(p), p += 4;
+    rec->speed = get_f32(p), p += 4;
+    rec->heading = get_f32(p), p += 4;
+    rec->nsat = *p++;
+    rec->hdop = get_f32(p), p += 4;
+
+    size_t rest = len - fixed;
+    for (int i = 0; i < 5; i++) {
+        if (lens[i] > rest || lens[i] >= caps[i]) return -1;
+        memcpy(strings[i], p, lens[i]);
+        p += lens[i];
+        rest -= lens[i];
+    }
+    return rest == 0 ? 0 : -1;
+}
@@ -0,0 +1,91 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Typed container record shared by the host-side codec tools.
+//
+// container_record_generate() reproduces the value distributions of
+// generate_test_container_data() in the locust senders (same ranges, same
+// decimal rounding before the float32 conversion), so host benchmarks and
+// model training see the payloads the services are load-tested with.
+// container_trace_next() instead follows one device over time
+// (fixed identity, slowly drifting sensors, one uplink per interval), which
+// is what a real container sends.
+// container_record_pack_struct() is the Struct+zlib packing stage without
+// the zlib step (Struct_Zlib_Service/locust_sender.py, struct_zlib_compress);
+// container_record_unpack_struct() reads it back (archived corpora).
+
+#ifndef CONTAINER_RECORD_H
+#define CONTAINER_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTAINER_RECORD_FIELDS 20        // keys in the JSON document ("acc" is one)
+#define CONTAINER_RECORD_STRUCT_MAX 160   // packed size upper bound
+
+typedef struct {
+    char msisdn[16];                      // SIM ID
+    char iso6346[16];                     // Container ID
+    char time[64];                        // UTC time DDMMYY hhmmss.s
+    uint8_t rssi;
+    char cgi[20];                         // Cell ID
+    uint8_t ble_m;
+    uint8_t bat_soc;
+    float acc[3];
+    float temperature;
+    float humidity;
+    float pressure;
+    char door[2];
+    uint8_t gnss;
+    float latitude;
+    float longitude;
+    float altitude;
+    float speed;
+    float heading;
+    uint8_t nsat;
+    float hdop;
+} container_record_t;
+
+typedef struct {
+    uint64_t rng;
+    time_t time_base;                     // records are stamped within [base - spread, base]
+    uint32_t time_spread_s;
+} container_record_gen_t;
+
+typedef struct {
+    container_record_gen_t gen;
+    container_record_t rec;               // last sample
+    time_t now;
+    uint32_t interval_s;
+} container_trace_t;
+
+// time_spread_s = 3600 matches the senders (up to 60 minutes in the past)
+void container_record_gen_init(container_record_gen_t *g, uint64_t seed, time_t time_base,
+                               uint32_t time_spread_s);
+void container_record_generate(container_record_gen_t *g, container_record_t *rec);
+
+// Per-device trace: the first sample comes from the generator, later ones drift from it
+void container_trace_init(container_trace_t *t, uint64_t seed, time_t start, uint32_t interval_s);
+void container_trace_next(container_trace_t *t, container_record_t *rec);
+
+// Struct layout: fixed part (string lengths u16 BE in place, u8, float32 BE)
+// followed by the string bytes. Returns the packed size, 0 if cap is too small.
+size_t container_record_pack_struct(const container_record_t *rec, uint8_t *buf, size_t cap);
+
+// Inverse of container_record_pack_struct. Returns 0, or -1 if buf does not
+// follow the layout or a string does not fit its field.
+int container_record_unpack_struct(const uint8_t *buf, size_t len, container_record_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTAINER_RECORD_H
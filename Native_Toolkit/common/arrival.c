@@ -0,0 +1,323 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "arrival.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const model_names[ARRIVAL_MODEL_COUNT] = {
+    "uniform", "poisson", "onoff", "fleet-tick", "satellite", "diurnal", "trace"
+};
+
+// ================= RANDOM =================
+static uint64_t rng_seed(uint64_t seed) {
+    uint64_t s = seed * 0x9E3779B97F4A7C15ull + 0xD1B54A32D192ED03ull;
+    return s ? s : 1;
+}
+
+static uint64_t rng_next(uint64_t *s) {
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1Dull;
+}
+
+// Uniform in (0, 1]
+static double rng_uniform(uint64_t *s) {
+    return (double)((rng_next(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double rng_exp(uint64_t *s, double mean) {
+    return -log(rng_uniform(s)) * mean;
+}
+
+// ================= SPEC =================
+void arrival_spec_defaults(arrival_spec_t *spec) {
+    memset(spec, 0, sizeof(*spec));
+    spec->model = ARRIVAL_UNIFORM;
+    spec->fleet = 1000.0;
+    spec->period_s = 300.0;
+    spec->on_s = 10.0;
+    spec->off_s = 50.0;
+    spec->phase_spread_s = 0.0;
+    spec->jitter_s = 1.0;
+    spec->pass_interval_s = 3600.0;
+    spec->pass_jitter_s = 300.0;
+    spec->dump_s = 60.0;
+    spec->day_s = 86400.0;
+    spec->amplitude = 0.5;
+    spec->peak_at_s = 43200.0;
+    spec->trace_fleet = 1.0;
+    spec->speedup = 1.0;
+    spec->seed = 1;
+}
+
+const char *arrival_model_name(arrival_model_t model) {
+    return model < ARRIVAL_MODEL_COUNT ? model_names[model] : "unknown";
+}
+
+int arrival_model_parse(const char *name, arrival_model_t *model) {
+    for (int m = 0; m < ARRIVAL_MODEL_COUNT; m++) {
+        if (!strcmp(name, model_names[m])) {
+            *model = (arrival_model_t)m;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static double trace_loop_length(const arrival_spec_t *spec) {
+    // Span plus one mean gap, so the wrap-around gap looks like the others
+    double span = spec->trace[spec->trace_len - 1];
+    return spec->trace_len > 1 && span > 0.0 ? span + span / (double)(spec->trace_len - 1) : 1.0;
+}
+
+double arrival_mean_rate(const arrival_spec_t *spec) {
+    if (spec->model == ARRIVAL_TRACE) {
+        if (!spec->trace || spec->trace_len == 0) return 0.0;
+        return (double)spec->trace_len / trace_loop_length(spec) * spec->speedup * spec->fleet / spec->trace_fleet;
+    }
+    if (spec->model == ARRIVAL_FLEET_TICK) return spec->fleet / (spec->period_s + spec->jitter_s / 2.0);
+    return spec->fleet / spec->period_s;
+}
+
+// ================= FLEET TICK HEAP =================
+static void heap_sift_down(double *h, size_t n, size_t i) {
+    double v = h[i];
+    while (1) {
+        size_t c = 2 * i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && h[c + 1] < h[c]) c++;
+        if (h[c] >= v) break;
+        h[i] = h[c];
+        i = c;
+    }
+    h[i] = v;
+}
+
+// ================= INIT =================
+int arrival_init(arrival_t *a, const arrival_spec_t *spec, unsigned shard, unsigned shards) {
+    memset(a, 0, sizeof(*a));
+    if (shards == 0 || shard >= shards || spec->model >= ARRIVAL_MODEL_COUNT || !(spec->fleet > 0.0)) return -1;
+    if (spec->model == ARRIVAL_TRACE) {
+        if (!spec->trace || spec->trace_len == 0 || !(spec->trace_fleet > 0.0) || !(spec->speedup > 0.0)) return -1;
+    } else if (!(spec->period_s > 0.0)) {
+        return -1;
+    }
+
+    a->spec = *spec;
+    a->shard = shard;
+    a->shards = shards;
+    a->rng = rng_seed(spec->seed ^ ((uint64_t)(shard + 1) * 0xBF58476D1CE4E5B9ull));
+    a->shared_rng = rng_seed(spec->seed);
+    a->rate = arrival_mean_rate(spec) / shards;
+
+    arrival_spec_t *s = &a->spec;
+    switch (s->model) {
+        case ARRIVAL_ONOFF:
+            if (s->on_s <= 0.0) return -1;
+            if (s->off_s < 0.0) s->off_s = 0.0;
+            a->window_start = 0.0;
+            a->window_end = rng_exp(&a->shared_rng, s->on_s);
+            break;
+        case ARRIVAL_FLEET_TICK: {
+            // Whole devices, spread over the shards
+            uint64_t fleet = (uint64_t)llround(s->fleet);
+            a->heap_len = fleet / shards + (shard < fleet % shards);
+            if (a->heap_len == 0) break;
+            a->heap = malloc(a->heap_len * sizeof(double));
+            if (!a->heap) return -1;
+            for (size_t i = 0; i < a->heap_len; i++) {
+                a->heap[i] = s->phase_spread_s > 0.0 ? (1.0 - rng_uniform(&a->rng)) * s->phase_spread_s : 0.0;
+            }
+            for (size_t i = a->heap_len / 2; i-- > 0;) heap_sift_down(a->heap, a->heap_len, i);
+            break;
+        }
+        case ARRIVAL_SATELLITE: {
+            if (s->pass_interval_s <= 0.0) return -1;
+            // Passes must not overlap: keep the jitter and the dump inside one interval
+            if (s->pass_jitter_s > s->pass_interval_s * 0.25) s->pass_jitter_s = s->pass_interval_s * 0.25;
+            if (s->dump_s > s->pass_interval_s * 0.5) s->dump_s = s->pass_interval_s * 0.5;
+            if (s->dump_s < 0.0) s->dump_s = 0.0;
+            // The first pass is at 0 and carries one interval of queued uplinks
+            double expected = a->rate * s->pass_interval_s;
+            a->remaining = (uint64_t)expected + (rng_uniform(&a->rng) <= expected - floor(expected) ? 1 : 0);
+            break;
+        }
+        case ARRIVAL_DIURNAL:
+            if (s->day_s <= 0.0) return -1;
+            if (s->amplitude < 0.0) s->amplitude = 0.0;
+            if (s->amplitude > 1.0) s->amplitude = 1.0;
+            break;
+        case ARRIVAL_TRACE:
+            a->trace_loop_s = trace_loop_length(s);
+            a->trace_pos = s->trace_len;  // first call wraps to position 0 of loop 0
+            a->trace_base = -a->trace_loop_s;
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+void arrival_free(arrival_t *a) {
+    free(a->heap);
+    a->heap = NULL;
+}
+
+// ================= MODELS =================
+static double next_onoff(arrival_t *a) {
+    const arrival_spec_t *s = &a->spec;
+    double peak = a->rate * (s->on_s + s->off_s) / s->on_s;
+    double t = (a->t > a->window_start ? a->t : a->window_start) + rng_exp(&a->rng, 1.0 / peak);
+    // Memoryless: a gap that runs past the ON period restarts in the next one
+    while (t >= a->window_end) {
+        a->window_start = a->window_end + (s->off_s > 0.0 ? rng_exp(&a->shared_rng, s->off_s) : 0.0);
+        a->window_end = a->window_start + rng_exp(&a->shared_rng, s->on_s);
+        t = a->window_start + rng_exp(&a->rng, 1.0 / peak);
+    }
+    return t;
+}
+
+static double next_fleet_tick(arrival_t *a) {
+    if (a->heap_len == 0) return INFINITY;
+    const arrival_spec_t *s = &a->spec;
+    double t = a->heap[0];
+    // loop() waits period_s, then checks again only after delay(1000)
+    a->heap[0] = t + s->period_s + (s->jitter_s > 0.0 ? (1.0 - rng_uniform(&a->rng)) * s->jitter_s : 0.0);
+    heap_sift_down(a->heap, a->heap_len, 0);
+    return t;
+}
+
+static double next_satellite(arrival_t *a) {
+    const arrival_spec_t *s = &a->spec;
+    while (a->remaining == 0) {
+        a->pass_index++;
+        double nominal = (double)a->pass_index * s->pass_interval_s;
+        double at = nominal + (s->pass_jitter_s > 0.0 ? (2.0 * rng_uniform(&a->shared_rng) - 1.0) * s->pass_jitter_s : 0.0);
+        double expected = a->rate * (at - a->pass_at);
+        a->pass_at = at;
+        a->dump_pos = 0.0;
+        a->remaining = expected > 0.0
+                           ? (uint64_t)expected + (rng_uniform(&a->rng) <= expected - floor(expected) ? 1 : 0)
+                           : 0;
+    }
+    // Sorted uniform positions without storing them: the next of r order
+    // statistics on [pos, 1) is pos + (1 - pos) * (1 - U^(1/r))
+    a->dump_pos += (1.0 - a->dump_pos) * (1.0 - pow(rng_uniform(&a->rng), 1.0 / (double)a->remaining));
+    a->remaining--;
+    return a->pass_at + a->dump_pos * s->dump_s;
+}
+
+static double next_diurnal(arrival_t *a) {
+    const arrival_spec_t *s = &a->spec;
+    double peak = a->rate * (1.0 + s->amplitude);
+    double t = a->t;
+    // Thinning: candidates at the peak rate, kept with probability rate(t) / peak
+    while (1) {
+        t += rng_exp(&a->rng, 1.0 / peak);
+        double rate = a->rate * (1.0 + s->amplitude * cos(2.0 * M_PI * (t - s->peak_at_s) / s->day_s));
+        if (rng_uniform(&a->rng) * peak <= rate) return t;
+    }
+}
+
+static double next_trace(arrival_t *a) {
+    const arrival_spec_t *s = &a->spec;
+    double copies = s->fleet / s->trace_fleet;
+    while (1) {
+        while (a->trace_copies_left == 0) {
+            if (++a->trace_pos >= s->trace_len) {
+                a->trace_pos = 0;
+                a->trace_base += a->trace_loop_s;
+            }
+            // Drawn from the shared stream so every shard numbers the copies alike
+            a->trace_copies_left = (unsigned)copies + (rng_uniform(&a->shared_rng) <= copies - floor(copies) ? 1 : 0);
+        }
+        a->trace_copies_left--;
+        uint64_t g = a->trace_global++;
+        if (g % a->shards == a->shard) return (a->trace_base + s->trace[a->trace_pos]) / s->speedup;
+    }
+}
+
+double arrival_next(arrival_t *a) {
+    double t;
+    switch (a->spec.model) {
+        case ARRIVAL_POISSON:
+            t = a->t + rng_exp(&a->rng, 1.0 / a->rate);
+            break;
+        case ARRIVAL_ONOFF:
+            t = next_onoff(a);
+            break;
+        case ARRIVAL_FLEET_TICK:
+            t = next_fleet_tick(a);
+            break;
+        case ARRIVAL_SATELLITE:
+            t = next_satellite(a);
+            break;
+        case ARRIVAL_DIURNAL:
+            t = next_diurnal(a);
+            break;
+        case ARRIVAL_TRACE:
+            t = next_trace(a);
+            break;
+        default:
+            // Shards interleave evenly
+            t = ((double)a->count * a->shards + a->shard) / (a->rate * a->shards);
+            break;
+    }
+    a->count++;
+    if (t < a->t) t = a->t;
+    a->t = t;
+    return t;
+}
+
+// ================= TRACE FILES =================
+static int cmp_double(const void *x, const void *y) {
+    double a = *(const double *)x, b = *(const double *)y;
+    return (a > b) - (a < b);
+}
+
+long arrival_load_trace(const char *path, double **out) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    size_t n = 0, cap = 1024;
+    double *v = malloc(cap * sizeof(double));
+    char line[512];
+    while (v && fgets(line, sizeof(line), f)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *p = line, *end;
+        while (*p == ' ' || *p == '\t') p++;
+        double t = strtod(p, &end);
+        if (end == p || !isfinite(t)) continue;
+        if (n == cap) {
+            double *grown = realloc(v, cap * 2 * sizeof(double));
+            if (!grown) {
+                free(v);
+                v = NULL;
+                break;
+            }
+            v = grown;
+            cap *= 2;
+        }
+        v[n++] = t;
+    }
+    fclose(f);
+    if (!v) return -1;
+    if (n == 0) {
+        free(v);
+        return -1;
+    }
+    qsort(v, n, sizeof(double), cmp_double);
+    double first = v[0];
+    for (size_t i = 0; i < n; i++) v[i] -= first;
+    *out = v;
+    return (long)n;
+}
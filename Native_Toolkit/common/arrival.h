@@ -0,0 +1,129 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Arrival-process models for the load tools.
+//
+// Every model is parameterized by fleet size and the per-device uplink
+// period, so the long-run rate is fleet / period_s requests per second
+// (fleet-tick: fleet / (period_s + jitter_s / 2); trace replay: the trace
+// rate scaled by fleet / trace_fleet). What
+// differs is how the arrivals cluster:
+//   uniform      fixed spacing, the old loadgen schedule
+//   poisson      independent devices, exponential gaps
+//   onoff        fleet-wide ON/OFF periods (exponential lengths); all
+//                traffic falls into ON periods at a proportionally higher rate
+//   fleet-tick   per-device loop() timers: device i sends at its phase, then
+//                every period_s plus a uniform lag of up to jitter_s (the
+//                delay(1000) granularity), so a fleet powered up together
+//                starts in lock-step and drifts apart
+//   satellite    Astrocast store-and-forward: uplinks queue on board and
+//                arrive as callbacks spread over dump_s after each pass
+//   diurnal      Poisson with a cosine day cycle (thinning)
+//   trace        replay of recorded timestamps, looped, each arrival
+//                repeated fleet / trace_fleet times (bursts scale with the fleet)
+//
+// A schedule is split into shards (one per load thread). Fleet-wide events
+// (ON periods, passes, the day cycle) come from the shared seed, so every
+// shard sees them at the same time; what happens inside them is drawn per
+// shard. The shards together reproduce the whole fleet. Host only.
+
+#ifndef ARRIVAL_H
+#define ARRIVAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    ARRIVAL_UNIFORM = 0,
+    ARRIVAL_POISSON,
+    ARRIVAL_ONOFF,
+    ARRIVAL_FLEET_TICK,
+    ARRIVAL_SATELLITE,
+    ARRIVAL_DIURNAL,
+    ARRIVAL_TRACE,
+    ARRIVAL_MODEL_COUNT
+} arrival_model_t;
+
+typedef struct {
+    arrival_model_t model;
+    double fleet;                         // devices
+    double period_s;                      // per-device uplink period (300 s in the examples)
+
+    double on_s;                          // onoff: mean ON length
+    double off_s;                         // onoff: mean OFF length
+
+    double phase_spread_s;                // fleet-tick: initial phases uniform in [0, spread)
+    double jitter_s;                      // fleet-tick: extra lag per uplink, uniform in [0, jitter)
+
+    double pass_interval_s;               // satellite: mean time between passes
+    double pass_jitter_s;                 // satellite: pass time +- this
+    double dump_s;                        // satellite: callbacks of one pass spread over this
+
+    double day_s;                         // diurnal: cycle length (shorten to compress a day)
+    double amplitude;                     // diurnal: peak rate = mean * (1 + amplitude)
+    double peak_at_s;                     // diurnal: peak offset within the cycle
+
+    const double *trace;                  // trace: sorted offsets (s) from the first arrival
+    size_t trace_len;
+    double trace_fleet;                   // trace: devices the trace was recorded from
+    double speedup;                       // trace: replay speed factor
+
+    uint64_t seed;
+} arrival_spec_t;
+
+typedef struct {
+    arrival_spec_t spec;
+    unsigned shard;
+    unsigned shards;
+    uint64_t rng;                         // per shard
+    uint64_t shared_rng;                  // fleet-wide events, same sequence in every shard
+    double rate;                          // this shard's mean rate
+    double t;                             // last arrival
+    uint64_t count;
+
+    double *heap;                         // fleet-tick: next send time per device (min-heap)
+    size_t heap_len;
+
+    double window_start;                  // onoff: current ON period
+    double window_end;
+    uint64_t pass_index;                  // satellite
+    double pass_at;
+    double dump_pos;                      // satellite: position in [0, 1) within the dump
+    uint64_t remaining;                   // satellite: callbacks left in this dump
+
+    size_t trace_pos;                     // trace
+    double trace_loop_s;
+    double trace_base;
+    uint64_t trace_global;                // arrival number across shards
+    unsigned trace_copies_left;
+} arrival_t;
+
+// Defaults for every field (uniform, 1000 devices, 300 s period); the
+// caller overrides what it needs.
+void arrival_spec_defaults(arrival_spec_t *spec);
+
+const char *arrival_model_name(arrival_model_t model);
+
+// Returns 0, or -1 for an unknown name
+int arrival_model_parse(const char *name, arrival_model_t *model);
+
+// Long-run arrivals per second of the whole fleet
+double arrival_mean_rate(const arrival_spec_t *spec);
+
+// Shard shard of shards. Returns 0, or -1 on bad parameters or allocation
+// failure. spec->trace must outlive the schedule.
+int arrival_init(arrival_t *a, const arrival_spec_t *spec, unsigned shard, unsigned shards);
+void arrival_free(arrival_t *a);
+
+// Next arrival in seconds from the schedule start (non-decreasing)
+double arrival_next(arrival_t *a);
+
+// Reads one timestamp per line (first number on the line, seconds, any
+// epoch; '#' starts a comment), sorts them and rebases them to start at 0.
+// Returns the count and a malloc'd array in *out, or -1 on error.
+long arrival_load_trace(const char *path, double **out);
+
+#endif // ARRIVAL_H
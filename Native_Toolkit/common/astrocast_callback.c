@@ -0,0 +1,299 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "astrocast_callback.h"
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BASE64_KERNEL "avx2"
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define BASE64_KERNEL "ssse3"
+#else
+#define BASE64_KERNEL "scalar"
+#endif
+
+#define ESCAPED_DATA_MAX 4096             // base64 text with escapes, unescaped on the stack
+
+// ================= BASE64 =================
+
+static const uint8_t b64_value[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63,
+     52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+    255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+     15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255,
+    255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+     41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+const char *base64_kernel(void) {
+    return BASE64_KERNEL;
+}
+
+// Strips the padding; the unpadded length, or -1
+static long unpadded_length(const char *in, size_t len) {
+    size_t n = len;
+    while (n > 0 && len - n < 2 && in[n - 1] == '=') n--;
+    if (n % 4 == 1 || (n != len && len % 4 != 0)) return -1;
+    return (long)n;
+}
+
+// Whole characters only (no padding); n % 4 != 1
+static long decode_tail(const unsigned char *in, size_t n, uint8_t *out) {
+    size_t o = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t a = b64_value[in[i]], b = b64_value[in[i + 1]], c = b64_value[in[i + 2]], d = b64_value[in[i + 3]];
+        if ((a | b | c | d) & 0xC0) return -1;
+        uint32_t v = a << 18 | b << 12 | c << 6 | d;
+        out[o++] = (uint8_t)(v >> 16);
+        out[o++] = (uint8_t)(v >> 8);
+        out[o++] = (uint8_t)v;
+    }
+    if (n - i >= 2) {
+        uint32_t a = b64_value[in[i]], b = b64_value[in[i + 1]], c = n - i == 3 ? b64_value[in[i + 2]] : 0;
+        if ((a | b | c) & 0xC0) return -1;
+        uint32_t v = a << 18 | b << 12 | c << 6;
+        out[o++] = (uint8_t)(v >> 16);
+        if (n - i == 3) out[o++] = (uint8_t)(v >> 8);
+    }
+    return (long)o;
+}
+
+static size_t decoded_length(size_t n) {
+    return n / 4 * 3 + (n % 4 ? n % 4 - 1 : 0);
+}
+
+long base64_decode_scalar(const char *in, size_t len, uint8_t *out, size_t cap) {
+    long n = unpadded_length(in, len);
+    if (n < 0 || decoded_length((size_t)n) > cap) return -1;
+    return decode_tail((const unsigned char *)in, (size_t)n, out);
+}
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+// Nibble tables (W. Mula): a character is valid when the low-nibble and
+// high-nibble classes share no bit; the roll added to it comes from its
+// high nibble, '/' (0x2F) being the one character that needs its own.
+#define LUT_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define LUT_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+#define LUT_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+#define PACK_ORDER 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+#endif
+
+long base64_decode(const char *in, size_t len, uint8_t *out, size_t cap) {
+    long n = unpadded_length(in, len);
+    if (n < 0 || decoded_length((size_t)n) > cap) return -1;
+    size_t i = 0, o = 0;
+
+#if defined(__AVX2__)
+    const __m256i lut_lo = _mm256_setr_epi8(LUT_LO, LUT_LO), lut_hi = _mm256_setr_epi8(LUT_HI, LUT_HI);
+    const __m256i lut_roll = _mm256_setr_epi8(LUT_ROLL, LUT_ROLL), nibble = _mm256_set1_epi8(0x0F);
+    const __m256i order = _mm256_setr_epi8(PACK_ORDER, PACK_ORDER);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    for (; i + 32 <= (size_t)n; i += 32, o += 24) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi32(s, 4), nibble);
+        __m256i cls = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, _mm256_and_si256(s, nibble)),
+                                       _mm256_shuffle_epi8(lut_hi, hi));
+        if (!_mm256_testz_si256(cls, cls)) return -1;
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(s, _mm256_set1_epi8(0x2F)), hi));
+        __m256i v = _mm256_maddubs_epi16(_mm256_add_epi8(s, roll), _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, order), lanes);
+        if (o + 32 <= cap) {
+            _mm256_storeu_si256((__m256i *)(out + o), v);
+        } else {
+            uint8_t tmp[32];
+            _mm256_storeu_si256((__m256i *)tmp, v);
+            memcpy(out + o, tmp, 24);
+        }
+    }
+#elif defined(__SSSE3__)
+    const __m128i lut_lo = _mm_setr_epi8(LUT_LO), lut_hi = _mm_setr_epi8(LUT_HI);
+    const __m128i lut_roll = _mm_setr_epi8(LUT_ROLL), nibble = _mm_set1_epi8(0x0F);
+    const __m128i order = _mm_setr_epi8(PACK_ORDER);
+    for (; i + 16 <= (size_t)n; i += 16, o += 12) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi32(s, 4), nibble);
+        __m128i cls = _mm_and_si128(_mm_shuffle_epi8(lut_lo, _mm_and_si128(s, nibble)), _mm_shuffle_epi8(lut_hi, hi));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(cls, _mm_setzero_si128()))) return -1;
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(s, _mm_set1_epi8(0x2F)), hi));
+        __m128i v = _mm_maddubs_epi16(_mm_add_epi8(s, roll), _mm_set1_epi32(0x01400140));
+        v = _mm_shuffle_epi8(_mm_madd_epi16(v, _mm_set1_epi32(0x00011000)), order);
+        if (o + 16 <= cap) {
+            _mm_storeu_si128((__m128i *)(out + o), v);
+        } else {
+            uint8_t tmp[16];
+            _mm_storeu_si128((__m128i *)tmp, v);
+            memcpy(out + o, tmp, 12);
+        }
+    }
+#endif
+
+    long tail = decode_tail((const unsigned char *)in + i, (size_t)n - i, out + o);
+    return tail < 0 ? -1 : (long)o + tail;
+}
+
+// ================= CALLBACK JSON =================
+
+static const char *skip_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+    return p;
+}
+
+// p just after the opening quote; the closing quote, or NULL
+static const char *string_end(const char *p, const char *end, bool *escaped) {
+    const char *q = memchr(p, '"', (size_t)(end - p));
+    if (!q) return NULL;
+    if (!memchr(p, '\\', (size_t)(q - p))) return q;
+    *escaped = true;
+    while (p < end) {
+        if (*p == '\\') p += 2;
+        else if (*p == '"') return p;
+        else p++;
+    }
+    return NULL;
+}
+
+// Any value; the first byte after it, or NULL
+static const char *skip_value(const char *p, const char *end) {
+    bool escaped = false;
+    if (p == end) return NULL;
+    if (*p == '"') {
+        const char *q = string_end(p + 1, end, &escaped);
+        return q ? q + 1 : NULL;
+    }
+    if (*p == '{' || *p == '[') {
+        unsigned depth = 0;
+        while (p < end) {
+            char ch = *p++;
+            if (ch == '"') {
+                const char *q = string_end(p, end, &escaped);
+                if (!q) return NULL;
+                p = q + 1;
+            } else if (ch == '{' || ch == '[') {
+                depth++;
+            } else if ((ch == '}' || ch == ']') && --depth == 0) {
+                return p;
+            }
+        }
+        return NULL;
+    }
+    const char *start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+        p++;
+    return p > start ? p : NULL;
+}
+
+static bool key_is(const char *key, size_t len, const char *name) {
+    return len == strlen(name) && !memcmp(key, name, len);
+}
+
+int astrocast_reader_init(astrocast_reader_t *r, const char *body, size_t len) {
+    r->p = skip_ws(body, body + len);
+    r->end = body + len;
+    r->done = false;
+    r->array = r->p < r->end && *r->p == '[';
+    if (r->array) {
+        r->p = skip_ws(r->p + 1, r->end);
+        if (r->p < r->end && *r->p == ']') {
+            r->done = true;
+            return skip_ws(r->p + 1, r->end) == r->end ? 0 : -1;
+        }
+    }
+    return r->p < r->end && *r->p == '{' ? 0 : -1;
+}
+
+int astrocast_reader_next(astrocast_reader_t *r, astrocast_msg_t *msg) {
+    if (r->done) return 0;
+    memset(msg, 0, sizeof(*msg));
+    const char *p = skip_ws(r->p, r->end), *end = r->end;
+    r->done = true;                       // until the object is read in full
+    if (p == end || *p != '{') return -1;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        for (;;) {
+            bool escaped = false;
+            if (p == end || *p != '"') return -1;
+            const char *key = p + 1, *key_end = string_end(key, end, &escaped);
+            if (!key_end) return -1;
+            p = skip_ws(key_end + 1, end);
+            if (p == end || *p != ':') return -1;
+            p = skip_ws(p + 1, end);
+
+            size_t klen = (size_t)(key_end - key);
+            const char **field = NULL;
+            size_t *field_len = NULL;
+            if (key_is(key, klen, "data")) field = &msg->data, field_len = &msg->data_len;
+            else if (key_is(key, klen, "guid")) field = &msg->guid, field_len = &msg->guid_len;
+            else if (key_is(key, klen, "deviceGuid")) field = &msg->device_guid, field_len = &msg->device_guid_len;
+
+            if (field && p < end && *p == '"') {
+                escaped = false;
+                const char *v_end = string_end(p + 1, end, &escaped);
+                if (!v_end) return -1;
+                *field = p + 1;
+                *field_len = (size_t)(v_end - p - 1);
+                if (field == &msg->data) msg->data_escaped = escaped;
+                p = v_end + 1;
+            } else if (!(p = skip_value(p, end))) {
+                return -1;
+            }
+
+            p = skip_ws(p, end);
+            if (p == end) return -1;
+            if (*p == '}') {
+                p++;
+                break;
+            }
+            if (*p != ',') return -1;
+            p = skip_ws(p + 1, end);
+        }
+    }
+
+    p = skip_ws(p, end);
+    if (r->array) {
+        if (p == end) return -1;
+        if (*p == ',') r->done = false, p++;
+        else if (*p != ']' || skip_ws(p + 1, end) != end) return -1;
+    } else if (p != end) {
+        return -1;
+    }
+    r->p = p;
+    return 1;
+}
+
+long astrocast_msg_payload(const astrocast_msg_t *msg, uint8_t *out, size_t cap) {
+    if (!msg->data || !msg->data_len) return -1;
+    if (!msg->data_escaped) return base64_decode(msg->data, msg->data_len, out, cap);
+
+    // JSON encoders may write '/' as "\/"; base64 needs no other escape
+    char text[ESCAPED_DATA_MAX];
+    size_t n = 0;
+    for (size_t i = 0; i < msg->data_len; i++) {
+        char ch = msg->data[i];
+        if (ch == '\\') {
+            if (++i == msg->data_len || msg->data[i] != '/') return -1;
+            ch = '/';
+        }
+        if (n == sizeof(text)) return -1;
+        text[n++] = ch;
+    }
+    return base64_decode(text, n, out, cap);
+}
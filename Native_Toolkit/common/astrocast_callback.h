@@ -0,0 +1,77 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Astrocast callback bodies without a JSON parser.
+//
+// A callback is a JSON object with the uplink in base64 under "data",
+// the message "guid" and the "deviceGuid"; a batched callback is an array
+// of them. The reader walks the body once, keeps pointers to those three
+// strings and skips every other value (numbers, nested objects, arrays)
+// without building anything, so a satellite-pass burst costs one scan
+// per body and no allocation.
+//
+// The base64 decoder handles 16 (SSSE3) or 32 (AVX2) characters per step:
+// nibble lookups validate and translate the characters, two multiply-adds
+// pack the 6-bit groups and a shuffle drops the gaps. The kernel is chosen
+// at compile time (-mssse3, -mavx2 or -march=native), as in fec_rs.c; the
+// scalar table decoder handles the tail, padding and other targets.
+// Host only.
+
+#ifndef ASTROCAST_CALLBACK_H
+#define ASTROCAST_CALLBACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Output bytes that always suffice for len characters of base64
+#define BASE64_DECODED_MAX(len) ((size_t)(len) / 4 * 3 + 3)
+
+// Standard alphabet (RFC 4648 section 4), padded or not, no whitespace.
+// Returns the decoded length, or -1 on an invalid character, misplaced
+// padding, a dangling character or an output buffer that is too small.
+long base64_decode(const char *in, size_t len, uint8_t *out, size_t cap);
+
+// "avx2", "ssse3" or "scalar"
+const char *base64_kernel(void);
+
+// Scalar decoder only (benchmarks, cross-checks)
+long base64_decode_scalar(const char *in, size_t len, uint8_t *out, size_t cap);
+
+// One callback; the strings point into the body, unescaped bytes between
+// the quotes. NULL when the field is absent or not a string.
+typedef struct {
+    const char *data, *guid, *device_guid;
+    size_t data_len, guid_len, device_guid_len;
+    bool data_escaped;                    // data contains JSON escapes (e.g. "\/")
+} astrocast_msg_t;
+
+typedef struct {
+    const char *p, *end;
+    bool array;                           // batched form
+    bool done;
+} astrocast_reader_t;
+
+// 0 for an object or array body, -1 otherwise
+int astrocast_reader_init(astrocast_reader_t *r, const char *body, size_t len);
+
+// 1 with the next callback, 0 after the last, -1 on malformed JSON (the
+// callbacks returned before it were well formed)
+int astrocast_reader_next(astrocast_reader_t *r, astrocast_msg_t *msg);
+
+// Decodes msg->data (undoing "\/" escapes). Returns the payload length,
+// or -1 when data is missing, empty or invalid, or does not fit cap.
+long astrocast_msg_payload(const astrocast_msg_t *msg, uint8_t *out, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASTROCAST_CALLBACK_H
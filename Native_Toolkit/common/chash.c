@@ -0,0 +1,184 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "chash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint64_t chash_key(const char *id, size_t len) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)id[i];
+        h *= 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+static int point_cmp(const void *a, const void *b) {
+    const chash_point_t *x = a, *y = b;
+    if (x->point != y->point) return x->point < y->point ? -1 : 1;
+    return x->node < y->node ? -1 : x->node > y->node;
+}
+
+// Rebuilds the ring from the node list; the points of a node depend only
+// on its name, its weight and vnodes
+static int rebuild(chash_t *h) {
+    size_t len = 0;
+    for (unsigned i = 0; i < h->node_count; i++) len += (size_t)h->node[i].weight * h->vnodes;
+    chash_point_t *ring = len ? malloc(len * sizeof(*ring)) : NULL;
+    if (len && !ring) return -1;
+    size_t n = 0;
+    for (unsigned i = 0; i < h->node_count; i++) {
+        char label[CHASH_NAME_MAX + 16];
+        for (uint32_t v = 0; v < h->node[i].weight * h->vnodes; v++) {
+            int k = snprintf(label, sizeof(label), "%s#%u", h->node[i].name, v);
+            ring[n].point = chash_key(label, (size_t)k);
+            ring[n].node = i;
+            n++;
+        }
+    }
+    qsort(ring, n, sizeof(*ring), point_cmp);
+    free(h->ring);
+    h->ring = ring;
+    h->ring_len = n;
+    return 0;
+}
+
+static void count_up_weight(chash_t *h) {
+    h->up_weight = 0;
+    for (unsigned i = 0; i < h->node_count; i++)
+        if (h->node[i].up) h->up_weight += h->node[i].weight;
+}
+
+int chash_init(chash_t *h, unsigned vnodes, double epsilon) {
+    if (!h || !vnodes || epsilon <= 0.0) return -1;
+    memset(h, 0, sizeof(*h));
+    h->vnodes = vnodes;
+    h->epsilon = epsilon;
+    return 0;
+}
+
+void chash_free(chash_t *h) {
+    free(h->ring);
+    h->ring = NULL;
+    h->ring_len = 0;
+}
+
+int chash_find(const chash_t *h, const char *name) {
+    for (unsigned i = 0; i < h->node_count; i++)
+        if (!strcmp(h->node[i].name, name)) return (int)i;
+    return -1;
+}
+
+int chash_add(chash_t *h, const char *name, uint32_t weight) {
+    if (!weight || strlen(name) >= CHASH_NAME_MAX) return -1;
+    int i = chash_find(h, name);
+    if (i < 0) {
+        if (h->node_count == CHASH_MAX_NODES) return -1;
+        i = (int)h->node_count++;
+        memset(&h->node[i], 0, sizeof(h->node[i]));
+        strcpy(h->node[i].name, name);
+    }
+    uint32_t old = h->node[i].weight;
+    h->node[i].weight = weight;
+    h->node[i].up = true;
+    if (rebuild(h) != 0) {
+        h->node[i].weight = old;
+        return -1;
+    }
+    count_up_weight(h);
+    return i;
+}
+
+int chash_remove(chash_t *h, unsigned node) {
+    if (node >= h->node_count || !h->node[node].weight) return -1;
+    uint32_t old = h->node[node].weight;
+    h->node[node].weight = 0;
+    h->node[node].up = false;
+    if (rebuild(h) != 0) {
+        h->node[node].weight = old;
+        return -1;
+    }
+    count_up_weight(h);
+    return 0;
+}
+
+void chash_set_up(chash_t *h, unsigned node, bool up) {
+    if (node >= h->node_count || !h->node[node].weight) return;
+    h->node[node].up = up;
+    count_up_weight(h);
+}
+
+// First ring position at or after key
+static size_t locate(const chash_t *h, uint64_t key) {
+    size_t lo = 0, hi = h->ring_len;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (h->ring[mid].point < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo == h->ring_len ? 0 : lo;
+}
+
+int chash_home(const chash_t *h, uint64_t key) {
+    if (!h->up_weight) return -1;
+    size_t at = locate(h, key);
+    for (size_t k = 0; k < h->ring_len; k++) {
+        const chash_point_t *p = &h->ring[(at + k) % h->ring_len];
+        if (h->node[p->node].up) return (int)p->node;
+    }
+    return -1;
+}
+
+// Most requests a node may hold with one more in flight:
+// ceil((1 + epsilon) x (total + 1) x weight / up weight)
+static uint64_t bound(const chash_t *h, unsigned node) {
+    double share = (double)(h->total_load + 1) * h->node[node].weight / (double)h->up_weight;
+    uint64_t b = (uint64_t)((1.0 + h->epsilon) * share);
+    return (double)b < (1.0 + h->epsilon) * share ? b + 1 : b;
+}
+
+int chash_pick(chash_t *h, uint64_t key) {
+    if (!h->up_weight) return -1;
+    size_t at = locate(h, key);
+    uint64_t seen = 0;
+    int home = -1;
+    for (size_t k = 0; k < h->ring_len; k++) {
+        unsigned n = h->ring[(at + k) % h->ring_len].node;
+        if (!h->node[n].up || (seen >> n & 1)) continue;
+        seen |= 1ull << n;
+        if (home < 0) home = (int)n;
+        if (h->node[n].load < bound(h, n)) {
+            h->node[n].picked++;
+            if ((int)n != home) h->node[n].spilled++;
+            return (int)n;
+        }
+    }
+    // Every up node is at the bound (cannot happen with epsilon > 0), so home
+    h->node[home].picked++;
+    return home;
+}
+
+int chash_least_loaded(const chash_t *h) {
+    int best = -1;
+    double best_load = 0.0;
+    for (unsigned i = 0; i < h->node_count; i++) {
+        if (!h->node[i].up) continue;
+        double load = (double)h->node[i].load / h->node[i].weight;
+        if (best < 0 || load < best_load) {
+            best = (int)i;
+            best_load = load;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,112 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Consistent hashing with bounded loads (Mirrokni, Thorup, Zadimoghaddam).
+//
+// Every node owns vnodes x weight points on a 64-bit ring, placed by
+// hashing its name, so a node's points do not depend on the other nodes:
+// a node joining takes about 1/n of the keys, from every node, and a node
+// leaving hands only its own keys to its ring successors. Nothing else
+// moves.
+//
+// A key goes to the first node clockwise from its hash (its home) unless
+// that node already carries more than (1 + epsilon) times its share of the
+// current load (in-flight requests, counted with chash_acquire and
+// chash_release); then it goes on to the next node on the ring that is
+// under the bound. A hot device or a slow node therefore spills to a
+// stable second choice instead of piling up, and the keys return home
+// when the load drops. Down nodes are skipped without removing their
+// points, so they get their keys back when they come up. Not thread
+// safe: one ring per thread, each counting its own load. Host only.
+
+#ifndef CHASH_H
+#define CHASH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHASH_MAX_NODES 64
+#define CHASH_NAME_MAX 64
+
+typedef struct {
+    uint64_t point;
+    uint32_t node;
+} chash_point_t;
+
+typedef struct {
+    char name[CHASH_NAME_MAX];
+    uint32_t weight;                      // 0 = slot unused (removed)
+    bool up;
+    uint32_t load;                        // requests in flight
+    uint64_t picked;                      // keys routed here
+    uint64_t spilled;                     // of which another node was home
+} chash_node_t;
+
+typedef struct {
+    chash_point_t *ring;                  // sorted by point, every node with weight > 0
+    size_t ring_len;
+    unsigned vnodes;                      // points per unit of weight
+    double epsilon;                       // load bound: (1 + epsilon) x fair share
+    chash_node_t node[CHASH_MAX_NODES];
+    unsigned node_count;                  // slots used so far, removed ones included
+    uint64_t total_load;
+    uint64_t up_weight;
+} chash_t;
+
+// 64-bit key of a device id: FNV-1a with a fmix64 finish, as shard_pipeline_key
+uint64_t chash_key(const char *id, size_t len);
+
+// vnodes: 160 keeps the key share of every node within about 20 % of the
+// mean with 8 nodes; more points even it out further, at rebuild cost.
+// epsilon: 0.25 spills about 1 key in 50 under even load.
+int chash_init(chash_t *h, unsigned vnodes, double epsilon);
+void chash_free(chash_t *h);
+
+// Adds a node, or gives a removed node of that name its slot (and points)
+// back. Returns the node index, or -1 when full or out of memory.
+int chash_add(chash_t *h, const char *name, uint32_t weight);
+
+// Takes the node's points off the ring; its index stays reserved for it
+int chash_remove(chash_t *h, unsigned node);
+
+// Index of the node with that name (removed nodes included), or -1
+int chash_find(const chash_t *h, const char *name);
+
+void chash_set_up(chash_t *h, unsigned node, bool up);
+
+// First up node clockwise from key, load ignored; -1 when none is up
+int chash_home(const chash_t *h, uint64_t key);
+
+// Home node unless it is at the load bound, else the next up node on the
+// ring that is under it. Counts the pick; the caller then calls
+// chash_acquire. Returns -1 when no node is up.
+int chash_pick(chash_t *h, uint64_t key);
+
+// Up node with the least load relative to its weight (keyless requests)
+int chash_least_loaded(const chash_t *h);
+
+static inline void chash_acquire(chash_t *h, unsigned node) {
+    h->node[node].load++;
+    h->total_load++;
+}
+
+static inline void chash_release(chash_t *h, unsigned node) {
+    if (h->node[node].load) {
+        h->node[node].load--;
+        h->total_load--;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHASH_H
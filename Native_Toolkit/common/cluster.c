@@ -0,0 +1,774 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "cluster.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "chash.h"
+
+#define GOSSIP_MAGIC 0x4743544Eu           // "NTCG"
+#define TRANSFER_MAGIC 0x5843544Eu         // "NTCX"
+#define GOSSIP_MAX 65507
+#define GOSSIP_FANOUT 3
+#define TRANSFER_TIMEOUT_S 5
+#define TRANSFER_MAX (1u << 30)
+#define NO_OWNER 0xFF
+
+enum { STATE_ALIVE, STATE_LEAVING, STATE_LEFT };
+enum { ROUTE_UNAVAILABLE, ROUTE_LOCAL, ROUTE_REMOTE };
+
+typedef struct {
+    char name[CLUSTER_NAME_MAX];
+    char http[CLUSTER_ADDR_MAX];
+    char gossip[CLUSTER_ADDR_MAX];
+    struct sockaddr_storage addr;
+    socklen_t addr_len;                   // 0 until the gossip address resolves
+    uint64_t incarnation;                 // start time in ms: a restarted node supersedes its old self
+    uint64_t heartbeat;
+    uint8_t state;
+    double heard;                         // local time the heartbeat last grew, 0 = never
+    bool up;                              // heard within fail-after and not left
+    double avoid_until;                   // no transfers to it before then (the last one failed)
+} member_t;
+
+struct cluster {
+    cluster_config_t cfg;
+    char name[CLUSTER_NAME_MAX], gossip[CLUSTER_ADDR_MAX], http[CLUSTER_ADDR_MAX];
+    pthread_mutex_t lock;
+    member_t member[CLUSTER_MAX_MEMBERS]; // 0 is this node; never removed
+    unsigned members;
+    uint32_t *version;
+    int16_t *owner;                       // member index, -1 = never owned
+    uint8_t *mine;                        // the pipeline holds the partition's devices
+    uint8_t *moving;                      // being exported or sent
+    _Atomic uint32_t *route;              // ROUTE_* | owner << 8, read by the ingress threads
+    uint64_t *pkey;                       // ring key of each partition
+    uint8_t *claim, *drop, *move;         // rebalance thread scratch, one flag per partition
+    chash_t ring;                         // rebalance thread only; node i is member i
+    bool synced;                          // merged a table from another member
+    double started;
+    struct sockaddr_storage join_addr;
+    socklen_t join_len;
+    int udp, tcp;
+    uint64_t rng;
+    uint8_t *gbuf;
+    pthread_t gossip_thread, rebalance_thread, transfer_thread;
+    unsigned threads;
+    atomic_bool stop;
+    cluster_stats_t stats;
+};
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void put_le(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static uint64_t next_rand(cluster_t *c) {
+    c->rng ^= c->rng << 13;
+    c->rng ^= c->rng >> 7;
+    c->rng ^= c->rng << 17;
+    return c->rng;
+}
+
+static int resolve(const char *hostport, int socktype, struct sockaddr_storage *addr, socklen_t *len) {
+    char host[CLUSTER_ADDR_MAX];
+    const char *colon = strrchr(hostport, ':');
+    if (!colon || (size_t)(colon - hostport) >= sizeof(host)) return -1;
+    memcpy(host, hostport, (size_t)(colon - hostport));
+    host[colon - hostport] = '\0';
+    struct addrinfo hints = { .ai_socktype = socktype }, *res;
+    if (getaddrinfo(host[0] ? host : NULL, colon + 1, &hints, &res) != 0) return -1;
+    memcpy(addr, res->ai_addr, res->ai_addrlen);
+    *len = res->ai_addrlen;
+    freeaddrinfo(res);
+    return 0;
+}
+
+// Route of partition p from the table; lock held
+static void publish(cluster_t *c, unsigned p) {
+    int o = c->owner[p];
+    uint32_t r = ROUTE_UNAVAILABLE;
+    if (!c->moving[p] && o == 0 && c->mine[p]) r = ROUTE_LOCAL;
+    else if (!c->moving[p] && o > 0 && c->member[o].up) r = ROUTE_REMOTE | (uint32_t)o << 8;
+    atomic_store_explicit(&c->route[p], r, memory_order_release);
+}
+
+static int member_find(const cluster_t *c, const char *name, size_t len) {
+    for (unsigned i = 0; i < c->members; i++)
+        if (strlen(c->member[i].name) == len && !memcmp(c->member[i].name, name, len)) return (int)i;
+    return -1;
+}
+
+// ================= GOSSIP =================
+// Datagram, little endian:
+//   magic u32, members u8, partitions u16
+//   per member: name, http and gossip (length u8 + bytes each), incarnation u64, heartbeat u64, state u8
+//   per partition: version u32, owner u8 (index in this member list, 0xFF = none)
+static size_t gossip_encode(const cluster_t *c, uint8_t *out) {
+    put_le(out, GOSSIP_MAGIC, 4);
+    out[4] = (uint8_t)c->members;
+    put_le(out + 5, c->cfg.partitions, 2);
+    size_t n = 7;
+    for (unsigned i = 0; i < c->members; i++) {
+        const member_t *m = &c->member[i];
+        const char *s[3] = { m->name, m->http, m->gossip };
+        for (int k = 0; k < 3; k++) {
+            size_t l = strlen(s[k]);
+            out[n] = (uint8_t)l;
+            memcpy(out + n + 1, s[k], l);
+            n += 1 + l;
+        }
+        put_le(out + n, m->incarnation, 8);
+        put_le(out + n + 8, m->heartbeat, 8);
+        out[n + 16] = m->state;
+        n += 17;
+    }
+    for (unsigned p = 0; p < c->cfg.partitions; p++) {
+        put_le(out + n, c->version[p], 4);
+        out[n + 4] = c->owner[p] < 0 ? NO_OWNER : (uint8_t)c->owner[p];
+        n += 5;
+    }
+    return n;
+}
+
+// Lock held
+static void gossip_merge(cluster_t *c, const uint8_t *in, size_t len, double now) {
+    if (len < 7 || get_le(in, 4) != GOSSIP_MAGIC) return;
+    unsigned count = in[4], parts = (unsigned)get_le(in + 5, 2);
+    int map[256];
+    size_t n = 7;
+    for (unsigned i = 0; i < count; i++) {
+        const char *s[3];
+        size_t l[3];
+        for (int k = 0; k < 3; k++) {
+            if (n + 1 > len || n + 1 + in[n] > len) return;
+            l[k] = in[n];
+            s[k] = (const char *)in + n + 1;
+            n += 1 + l[k];
+        }
+        if (n + 17 > len) return;
+        uint64_t incarnation = get_le(in + n, 8), heartbeat = get_le(in + n + 8, 8);
+        uint8_t state = in[n + 16];
+        n += 17;
+        map[i] = -1;
+        if (!l[0] || l[0] >= CLUSTER_NAME_MAX || l[1] >= CLUSTER_ADDR_MAX || l[2] >= CLUSTER_ADDR_MAX ||
+            state > STATE_LEFT)
+            continue;
+        int m = member_find(c, s[0], l[0]);
+        if (m == 0) {
+            // This node's own view of itself always wins
+            map[i] = 0;
+            continue;
+        }
+        if (m < 0) {
+            if (c->members == CLUSTER_MAX_MEMBERS) continue;
+            m = (int)c->members++;
+            memset(&c->member[m], 0, sizeof(c->member[m]));
+            memcpy(c->member[m].name, s[0], l[0]);
+        }
+        map[i] = m;
+        member_t *mb = &c->member[m];
+        if (incarnation > mb->incarnation) {
+            memcpy(mb->http, s[1], l[1]);
+            mb->http[l[1]] = '\0';
+            memcpy(mb->gossip, s[2], l[2]);
+            mb->gossip[l[2]] = '\0';
+            if (resolve(mb->gossip, SOCK_DGRAM, &mb->addr, &mb->addr_len) != 0) mb->addr_len = 0;
+            mb->incarnation = incarnation;
+            mb->heartbeat = heartbeat;
+            mb->state = state;
+            mb->heard = state == STATE_LEFT ? 0.0 : now;
+            mb->avoid_until = 0.0;
+        } else if (incarnation == mb->incarnation) {
+            if (heartbeat > mb->heartbeat) {
+                mb->heartbeat = heartbeat;
+                if (state != STATE_LEFT) mb->heard = now;
+            }
+            if (state > mb->state) mb->state = state;
+        }
+    }
+    if (parts != c->cfg.partitions || n + 5 * (size_t)parts != len) return;
+    c->synced = true;
+    for (unsigned p = 0; p < parts; p++, n += 5) {
+        uint32_t v = (uint32_t)get_le(in + n, 4);
+        unsigned o = in[n + 4];
+        if (o == NO_OWNER || o >= count || map[o] < 0) continue;
+        int lo = map[o], cur = c->owner[p];
+        if (v > c->version[p] ||
+            (v == c->version[p] && cur >= 0 && lo != cur && strcmp(c->member[lo].name, c->member[cur].name) < 0)) {
+            c->version[p] = v;
+            c->owner[p] = (int16_t)lo;
+            publish(c, p);
+        }
+    }
+}
+
+// To GOSSIP_FANOUT random members that are up, now and then one that is
+// down (so a healed network joins up again), the join address until a
+// table arrived, and every member once this node has left
+static void gossip_send(cluster_t *c) {
+    struct sockaddr_storage to[CLUSTER_MAX_MEMBERS + 1];
+    socklen_t to_len[CLUSTER_MAX_MEMBERS + 1];
+    unsigned n = 0;
+    pthread_mutex_lock(&c->lock);
+    c->member[0].heartbeat++;
+    size_t len = gossip_encode(c, c->gbuf);
+    unsigned up[CLUSTER_MAX_MEMBERS], ups = 0, down[CLUSTER_MAX_MEMBERS], downs = 0;
+    for (unsigned i = 1; i < c->members; i++) {
+        const member_t *m = &c->member[i];
+        if (!m->addr_len || m->state == STATE_LEFT) continue;
+        if (m->up) up[ups++] = i;
+        else down[downs++] = i;
+    }
+    unsigned fanout = c->member[0].state == STATE_LEFT ? ups : GOSSIP_FANOUT;
+    for (unsigned k = 0; k < ups && n < fanout; k++) {
+        unsigned j = k + (unsigned)(next_rand(c) % (ups - k)), t = up[j];
+        up[j] = up[k];
+        up[k] = t;
+        to[n] = c->member[t].addr;
+        to_len[n++] = c->member[t].addr_len;
+    }
+    if (downs && next_rand(c) % 8 == 0) {
+        unsigned t = down[next_rand(c) % downs];
+        to[n] = c->member[t].addr;
+        to_len[n++] = c->member[t].addr_len;
+    }
+    if (!c->synced && c->join_len) {
+        to[n] = c->join_addr;
+        to_len[n++] = c->join_len;
+    }
+    pthread_mutex_unlock(&c->lock);
+    for (unsigned i = 0; i < n; i++) sendto(c->udp, c->gbuf, len, MSG_DONTWAIT, (struct sockaddr *)&to[i], to_len[i]);
+}
+
+static void *gossip_main(void *arg) {
+    cluster_t *c = arg;
+    uint8_t *buf = malloc(GOSSIP_MAX);
+    double next = 0.0;
+    while (buf && !atomic_load(&c->stop)) {
+        double now = now_s();
+        if (now >= next) {
+            gossip_send(c);
+            next = now + c->cfg.gossip_s;
+        }
+        struct pollfd pfd = { .fd = c->udp, .events = POLLIN };
+        if (poll(&pfd, 1, (int)((next - now) * 1000.0) + 1) <= 0) continue;
+        ssize_t r;
+        while ((r = recv(c->udp, buf, GOSSIP_MAX, MSG_DONTWAIT)) > 0) {
+            pthread_mutex_lock(&c->lock);
+            gossip_merge(c, buf, (size_t)r, now_s());
+            pthread_mutex_unlock(&c->lock);
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+// ================= TRANSFER =================
+// Stream: magic u32, sender name (length u8 + bytes), count u16,
+// count x (partition u16, version u32), state length u32, device state
+// (shard_pipeline_export). The target answers one byte, 'A' or 'N'.
+static int write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, void *buf, size_t len) {
+    uint8_t *p = buf;
+    while (len) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void set_timeouts(int fd) {
+    struct timeval tv = { .tv_sec = TRANSFER_TIMEOUT_S };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static int transfer_send(const cluster_t *c, const char *gossip, const uint16_t *parts, const uint32_t *versions,
+                         unsigned count, const uint8_t *state, size_t len) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    if (resolve(gossip, SOCK_STREAM, &addr, &addr_len) != 0) return -1;
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    set_timeouts(fd);
+    size_t name_len = strlen(c->name), head_len = 4 + 1 + name_len + 2 + 6 * (size_t)count + 4;
+    uint8_t *head = malloc(head_len), ack = 0;
+    int rc = -1;
+    if (head && connect(fd, (struct sockaddr *)&addr, addr_len) == 0) {
+        put_le(head, TRANSFER_MAGIC, 4);
+        head[4] = (uint8_t)name_len;
+        memcpy(head + 5, c->name, name_len);
+        size_t n = 5 + name_len;
+        put_le(head + n, count, 2);
+        n += 2;
+        for (unsigned i = 0; i < count; i++, n += 6) {
+            put_le(head + n, parts[i], 2);
+            put_le(head + n + 2, versions[i], 4);
+        }
+        put_le(head + n, len, 4);
+        if (write_all(fd, head, head_len) == 0 && write_all(fd, state, len) == 0 && read_all(fd, &ack, 1) == 0 &&
+            ack == 'A')
+            rc = 0;
+    }
+    free(head);
+    close(fd);
+    return rc;
+}
+
+// Moves the flagged partitions (all owned here, none moving) to member t
+static void transfer_out(cluster_t *c, int t, const uint8_t *flags) {
+    unsigned parts = c->cfg.partitions, count = 0;
+    uint16_t *list = malloc(parts * sizeof(*list));
+    uint32_t *versions = malloc(parts * sizeof(*versions));
+    if (!list || !versions) {
+        free(list);
+        free(versions);
+        return;
+    }
+    char gossip[CLUSTER_ADDR_MAX];
+    pthread_mutex_lock(&c->lock);
+    for (unsigned p = 0; p < parts; p++) {
+        if (!flags[p]) continue;
+        c->moving[p] = 1;
+        publish(c, p);
+        list[count] = (uint16_t)p;
+        versions[count++] = c->version[p];
+    }
+    strcpy(gossip, c->member[t].gossip);
+    pthread_mutex_unlock(&c->lock);
+
+    double t0 = now_s();
+    uint8_t *state = NULL;
+    size_t len = 0;
+    uint32_t devices = 0;
+    int rc = shard_pipeline_export(c->cfg.pipeline, c->cfg.ingress, flags, false, &state, &len, &devices);
+    bool ok = rc == 0 && transfer_send(c, gossip, list, versions, count, state, len) == 0;
+    // Not taken: the devices go back into the pipeline here
+    if (!ok) shard_pipeline_import(c->cfg.pipeline, c->cfg.ingress, flags, state, len);
+    double t1 = now_s();
+
+    pthread_mutex_lock(&c->lock);
+    for (unsigned i = 0; i < count; i++) {
+        unsigned p = list[i];
+        c->moving[p] = 0;
+        if (ok) {
+            c->mine[p] = 0;
+            if (c->version[p] <= versions[i]) {
+                c->version[p] = versions[i] + 1;
+                c->owner[p] = (int16_t)t;
+            }
+        }
+        publish(c, p);
+    }
+    if (ok) {
+        c->stats.transfers_out++;
+        c->stats.partitions_out += count;
+        c->stats.devices_out += devices;
+        c->stats.bytes_out += len;
+        c->stats.last_transfer_ms = (t1 - t0) * 1000.0;
+    } else {
+        c->stats.transfer_errors++;
+        c->member[t].avoid_until = t1 + c->cfg.fail_after_s;
+    }
+    pthread_mutex_unlock(&c->lock);
+    free(state);
+    free(list);
+    free(versions);
+}
+
+static void transfer_in(cluster_t *c, int fd) {
+    unsigned parts = c->cfg.partitions;
+    uint8_t head[5], ack = 'N';
+    char name[CLUSTER_NAME_MAX];
+    uint8_t *entries = NULL, *state = NULL, *flags = calloc(parts, 1);
+    uint8_t word[4];
+    set_timeouts(fd);
+    if (!flags || read_all(fd, head, 5) != 0 || get_le(head, 4) != TRANSFER_MAGIC || head[4] >= CLUSTER_NAME_MAX ||
+        read_all(fd, name, head[4]) != 0 || read_all(fd, word, 2) != 0)
+        goto out;
+    name[head[4]] = '\0';
+    unsigned count = (unsigned)get_le(word, 2);
+    if (!count || count > parts || !(entries = malloc(6 * (size_t)count)) || read_all(fd, entries, 6 * (size_t)count) ||
+        read_all(fd, word, 4) != 0)
+        goto out;
+    size_t len = get_le(word, 4);
+    if (len > TRANSFER_MAX || (len && !(state = malloc(len))) || read_all(fd, state, len) != 0) goto out;
+    for (unsigned i = 0; i < count; i++) {
+        unsigned p = (unsigned)get_le(entries + 6 * i, 2);
+        if (p >= parts || flags[p]) goto out;
+        flags[p] = 1;
+    }
+
+    // Refused while leaving, or for a partition this node has a newer version of
+    bool take = true;
+    pthread_mutex_lock(&c->lock);
+    if (c->member[0].state != STATE_ALIVE) take = false;
+    for (unsigned i = 0; take && i < count; i++) {
+        unsigned p = (unsigned)get_le(entries + 6 * i, 2);
+        if (get_le(entries + 6 * i + 2, 4) < c->version[p] || c->mine[p]) take = false;
+    }
+    pthread_mutex_unlock(&c->lock);
+    long devices = take ? shard_pipeline_import(c->cfg.pipeline, c->cfg.ingress + 1, flags, state, len) : -1;
+    if (devices < 0) goto out;
+
+    pthread_mutex_lock(&c->lock);
+    for (unsigned i = 0; i < count; i++) {
+        unsigned p = (unsigned)get_le(entries + 6 * i, 2);
+        uint32_t v = (uint32_t)get_le(entries + 6 * i + 2, 4) + 1;
+        if (c->version[p] < v) c->version[p] = v;
+        c->owner[p] = 0;
+        c->mine[p] = 1;
+        publish(c, p);
+    }
+    c->stats.transfers_in++;
+    c->stats.partitions_in += count;
+    c->stats.devices_in += (uint64_t)devices;
+    c->stats.bytes_in += len;
+    pthread_mutex_unlock(&c->lock);
+    ack = 'A';
+out:
+    write_all(fd, &ack, 1);
+    free(entries);
+    free(state);
+    free(flags);
+}
+
+static void *transfer_main(void *arg) {
+    cluster_t *c = arg;
+    while (!atomic_load(&c->stop)) {
+        struct pollfd pfd = { .fd = c->tcp, .events = POLLIN };
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        int fd = accept4(c->tcp, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        transfer_in(c, fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+// ================= REBALANCE =================
+// One pass: liveness, then in order drops, claims and one transfer
+static void rebalance(cluster_t *c) {
+    unsigned parts = c->cfg.partitions, ndrop = 0, nclaim = 0, nmove = 0;
+    int target = -1;
+    double now = now_s();
+    memset(c->drop, 0, parts);
+    memset(c->claim, 0, parts);
+    memset(c->move, 0, parts);
+
+    pthread_mutex_lock(&c->lock);
+    bool changed = false;
+    for (unsigned i = 0; i < c->members; i++) {
+        member_t *m = &c->member[i];
+        bool up = i == 0 || (m->state != STATE_LEFT && m->heard > 0.0 && now - m->heard < c->cfg.fail_after_s);
+        if (up != m->up) {
+            m->up = up;
+            changed = true;
+        }
+        // Ring node i is member i: both only ever grow, in the same order
+        if (i == c->ring.node_count && chash_add(&c->ring, m->name, 1) != (int)i) break;
+        bool in_ring = up && m->state == STATE_ALIVE;
+        if (c->ring.node[i].up != in_ring) chash_set_up(&c->ring, i, in_ring);
+    }
+    if (changed)
+        for (unsigned p = 0; p < parts; p++) publish(c, p);
+
+    // A joining node claims orphans only once it has had time to hear of everyone
+    bool settled = !c->join_len || (c->synced && now - c->started >= c->cfg.fail_after_s);
+    for (unsigned p = 0; p < parts; p++) {
+        int o = c->owner[p];
+        if (c->moving[p]) continue;
+        if (c->mine[p] && o != 0) {
+            c->drop[p] = 1;
+            ndrop++;
+            continue;
+        }
+        int t = chash_home(&c->ring, c->pkey[p]);
+        if (c->mine[p]) {
+            if (t > 0 && now >= c->member[t].avoid_until && (target < 0 || t == target) && nmove < c->cfg.batch) {
+                target = t;
+                c->move[p] = 1;
+                nmove++;
+            }
+            continue;
+        }
+        // Owned here by an earlier incarnation, never owned, or owner down
+        if (settled && ((o == 0) || ((o < 0 || !c->member[o].up) && t == 0))) {
+            c->claim[p] = 1;
+            nclaim++;
+        }
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    shard_pipeline_t *pl = c->cfg.pipeline;
+    if (ndrop) {
+        shard_pipeline_export(pl, c->cfg.ingress, c->drop, true, NULL, NULL, NULL);
+        pthread_mutex_lock(&c->lock);
+        for (unsigned p = 0; p < parts; p++) {
+            if (!c->drop[p]) continue;
+            c->mine[p] = 0;
+            publish(c, p);
+        }
+        c->stats.dropped += ndrop;
+        pthread_mutex_unlock(&c->lock);
+    }
+    if (nclaim) {
+        // An empty import: clears the moved flags a past export left
+        shard_pipeline_import(pl, c->cfg.ingress, c->claim, NULL, 0);
+        pthread_mutex_lock(&c->lock);
+        for (unsigned p = 0; p < parts; p++) {
+            int o = c->owner[p];
+            if (!c->claim[p] || c->mine[p] || (o > 0 && c->member[o].up)) continue;
+            c->version[p]++;
+            c->owner[p] = 0;
+            c->mine[p] = 1;
+            c->stats.claimed++;
+            publish(c, p);
+        }
+        pthread_mutex_unlock(&c->lock);
+    }
+    if (nmove) transfer_out(c, target, c->move);
+}
+
+static void *rebalance_main(void *arg) {
+    cluster_t *c = arg;
+    while (!atomic_load(&c->stop)) {
+        usleep((useconds_t)(c->cfg.gossip_s * 1e6));
+        rebalance(c);
+    }
+    return NULL;
+}
+
+// ================= API =================
+static int open_socket(const char *hostport, int type) {
+    struct sockaddr_storage addr;
+    socklen_t len;
+    if (resolve(hostport, type, &addr, &len) != 0) return -1;
+    int fd = socket(addr.ss_family, type | SOCK_CLOEXEC, 0), one = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+        bind(fd, (struct sockaddr *)&addr, len) || (type == SOCK_STREAM && listen(fd, 16))) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void cluster_free(cluster_t *c) {
+    if (c->udp >= 0) close(c->udp);
+    if (c->tcp >= 0) close(c->tcp);
+    chash_free(&c->ring);
+    pthread_mutex_destroy(&c->lock);
+    free(c->version);
+    free(c->owner);
+    free(c->mine);
+    free(c->moving);
+    free((void *)c->route);
+    free(c->pkey);
+    free(c->claim);
+    free(c->drop);
+    free(c->move);
+    free(c->gbuf);
+    free(c);
+}
+
+cluster_t *cluster_start(const cluster_config_t *cfg) {
+    if (!cfg || !cfg->name || !cfg->gossip || !cfg->http || !cfg->pipeline || !cfg->partitions ||
+        cfg->partitions > SHARD_PIPELINE_MAX_PARTITIONS || !cfg->name[0] || strlen(cfg->name) >= CLUSTER_NAME_MAX ||
+        strlen(cfg->gossip) >= CLUSTER_ADDR_MAX || strlen(cfg->http) >= CLUSTER_ADDR_MAX || strchr(cfg->name, ' '))
+        return NULL;
+    cluster_t *c = calloc(1, sizeof(*c));
+    if (!c) return NULL;
+    c->cfg = *cfg;
+    if (c->cfg.gossip_s <= 0.0) c->cfg.gossip_s = 0.2;
+    if (c->cfg.fail_after_s <= 0.0) c->cfg.fail_after_s = 3.0;
+    if (!c->cfg.batch) c->cfg.batch = 16;
+    strcpy(c->name, cfg->name);
+    strcpy(c->gossip, cfg->gossip);
+    strcpy(c->http, cfg->http);
+    c->udp = c->tcp = -1;
+    pthread_mutex_init(&c->lock, NULL);
+    unsigned parts = cfg->partitions;
+    c->version = calloc(parts, sizeof(*c->version));
+    c->owner = malloc(parts * sizeof(*c->owner));
+    c->mine = calloc(parts, 1);
+    c->moving = calloc(parts, 1);
+    c->route = calloc(parts, sizeof(*c->route));
+    c->pkey = malloc(parts * sizeof(*c->pkey));
+    c->claim = malloc(parts);
+    c->drop = malloc(parts);
+    c->move = malloc(parts);
+    c->gbuf = malloc(GOSSIP_MAX);
+    if (!c->version || !c->owner || !c->mine || !c->moving || !c->route || !c->pkey || !c->claim || !c->drop ||
+        !c->move || !c->gbuf || chash_init(&c->ring, 160, 0.25) != 0)
+        goto fail;
+    if ((cfg->join && resolve(cfg->join, SOCK_DGRAM, &c->join_addr, &c->join_len) != 0) ||
+        (c->udp = open_socket(cfg->gossip, SOCK_DGRAM)) < 0 || (c->tcp = open_socket(cfg->gossip, SOCK_STREAM)) < 0)
+        goto fail;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    member_t *self = &c->member[0];
+    strcpy(self->name, c->name);
+    strcpy(self->http, c->http);
+    strcpy(self->gossip, c->gossip);
+    self->incarnation = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+    self->up = true;
+    c->members = 1;
+    c->rng = self->incarnation | 1;
+    c->started = now_s();
+    self->heard = c->started;
+    for (unsigned p = 0; p < parts; p++) {
+        char label[32];
+        int n = snprintf(label, sizeof(label), "partition-%u", p);
+        c->pkey[p] = chash_key(label, (size_t)n);
+        c->owner[p] = cfg->join ? -1 : 0;
+        c->version[p] = cfg->join ? 0 : 1;
+        c->mine[p] = !cfg->join;
+        publish(c, p);
+    }
+
+    if (pthread_create(&c->gossip_thread, NULL, gossip_main, c) != 0) goto fail;
+    c->threads++;
+    if (pthread_create(&c->rebalance_thread, NULL, rebalance_main, c) != 0) goto stop;
+    c->threads++;
+    if (pthread_create(&c->transfer_thread, NULL, transfer_main, c) != 0) goto stop;
+    c->threads++;
+    return c;
+stop:
+    cluster_stop(c);
+    return NULL;
+fail:
+    cluster_free(c);
+    return NULL;
+}
+
+cluster_route_t cluster_route(cluster_t *c, uint64_t key, char *owner, size_t cap) {
+    uint32_t r = atomic_load_explicit(&c->route[shard_pipeline_partition(key, c->cfg.partitions)], memory_order_acquire);
+    switch (r & 0xFF) {
+    case ROUTE_LOCAL: return CLUSTER_LOCAL;
+    case ROUTE_REMOTE:
+        pthread_mutex_lock(&c->lock);
+        snprintf(owner, cap, "%s", c->member[r >> 8].http);
+        pthread_mutex_unlock(&c->lock);
+        return CLUSTER_REMOTE;
+    default: return CLUSTER_UNAVAILABLE;
+    }
+}
+
+int cluster_leave(cluster_t *c, double timeout_s) {
+    pthread_mutex_lock(&c->lock);
+    c->member[0].state = STATE_LEAVING;
+    pthread_mutex_unlock(&c->lock);
+    double end = now_s() + timeout_s;
+    int rc = -1;
+    while (now_s() < end) {
+        unsigned owned = 0, takers = 0;
+        pthread_mutex_lock(&c->lock);
+        for (unsigned p = 0; p < c->cfg.partitions; p++) owned += c->mine[p];
+        for (unsigned i = 1; i < c->members; i++) takers += c->member[i].up && c->member[i].state == STATE_ALIVE;
+        pthread_mutex_unlock(&c->lock);
+        if (!owned) {
+            rc = 0;
+            break;
+        }
+        if (!takers) break;
+        usleep(50000);
+    }
+    // A few rounds to every member, so the leave is not taken for a failure
+    pthread_mutex_lock(&c->lock);
+    c->member[0].state = STATE_LEFT;
+    pthread_mutex_unlock(&c->lock);
+    usleep((useconds_t)(3 * c->cfg.gossip_s * 1e6));
+    return rc;
+}
+
+void cluster_stop(cluster_t *c) {
+    if (!c) return;
+    atomic_store(&c->stop, true);
+    pthread_t *threads[3] = { &c->gossip_thread, &c->rebalance_thread, &c->transfer_thread };
+    for (unsigned i = 0; i < c->threads; i++) pthread_join(*threads[i], NULL);
+    cluster_free(c);
+}
+
+void cluster_stats(cluster_t *c, cluster_stats_t *out) {
+    pthread_mutex_lock(&c->lock);
+    *out = c->stats;
+    out->members = c->members;
+    out->up = 0;
+    for (unsigned i = 0; i < c->members; i++) out->up += c->member[i].up;
+    out->owned = 0;
+    for (unsigned p = 0; p < c->cfg.partitions; p++) out->owned += c->mine[p];
+    pthread_mutex_unlock(&c->lock);
+}
+
+char *cluster_map(cluster_t *c, size_t *len) {
+    static const char *state_name[] = { "up", "leaving", "left" };
+    char *text = NULL;
+    FILE *out = open_memstream(&text, len);
+    if (!out) return NULL;
+    pthread_mutex_lock(&c->lock);
+    fprintf(out, "partitions %u\n", c->cfg.partitions);
+    for (unsigned i = 0; i < c->members; i++) {
+        const member_t *m = &c->member[i];
+        unsigned owned = 0;
+        for (unsigned p = 0; p < c->cfg.partitions; p++) owned += c->owner[p] == (int)i;
+        fprintf(out, "member %u %s %s %s %s %u\n", i, m->name, m->http, m->gossip,
+                m->state == STATE_ALIVE && !m->up ? "down" : state_name[m->state], owned);
+    }
+    fputs("owners", out);
+    for (unsigned p = 0; p < c->cfg.partitions; p++) fprintf(out, " %d", c->owner[p]);
+    fputc('\n', out);
+    pthread_mutex_unlock(&c->lock);
+    if (fclose(out) != 0) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
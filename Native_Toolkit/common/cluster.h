@@ -0,0 +1,114 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Cluster membership and partition ownership for shard_receiver --cluster.
+//
+// Devices fall into a fixed number of partitions (shard_pipeline_partition
+// of the device key) and every partition has one owner node, which holds
+// the state of its devices in its shard pipeline. The partition table
+// (owner and version per partition) and the member list travel by gossip:
+// every gossip interval each node sends both, over UDP, to three random
+// members (and to its --join address until it has heard from someone).
+// A member whose heartbeat has not grown for fail-after seconds is down.
+// Tables merge partition by partition: the higher version wins, and on a
+// tie the owner with the smaller name.
+//
+// Target owners come from a consistent hash ring (common/chash.h) over the
+// members that are up, so a join or a leave moves about 1/n of the
+// partitions. Each owner moves its own partitions to their targets:
+//
+//   owner: partitions answered 503 (moving), shard_pipeline_export
+//          --> TCP to the target's gossip port: names, versions, device state
+//   target: shard_pipeline_import, owner = self, version + 1 --> ack
+//   owner: owner = target, version + 1; requests now get a 307 to it
+//
+// Without the ack the owner imports the state back and retries later. A
+// partition whose owner is down is claimed by its target with version + 1
+// and starts empty: what the owner held since is lost, as with a single
+// receiver that dies. A node that loses a partition by merge (two claims)
+// drops its copy. Leaving (cluster_leave) hands every partition to its
+// target first, then gossips the member as left. Host only.
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "shard_pipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLUSTER_MAX_MEMBERS 64
+#define CLUSTER_NAME_MAX 64
+#define CLUSTER_ADDR_MAX 128
+
+typedef struct {
+    const char *name;                     // unique per node
+    const char *gossip;                   // HOST:PORT for UDP gossip and TCP transfers (bound)
+    const char *http;                     // HOST:PORT other nodes redirect clients to
+    const char *join;                     // gossip address of a member, NULL for the first node
+    unsigned partitions;                  // same on every node; the pipeline's cfg.partitions
+    double gossip_s;                      // heartbeat interval (default 0.2)
+    double fail_after_s;                  // silence before a member is down (default 3)
+    unsigned batch;                       // partitions per transfer (default 16)
+    shard_pipeline_t *pipeline;
+    unsigned ingress;                     // uses pipeline ingress ingress and ingress + 1
+} cluster_config_t;
+
+typedef enum {
+    CLUSTER_LOCAL,                        // owned here: submit
+    CLUSTER_REMOTE,                       // owned by another node: redirect
+    CLUSTER_UNAVAILABLE,                  // moving, or owner down and not yet claimed: retry
+} cluster_route_t;
+
+typedef struct {
+    uint32_t members;                     // known, self included
+    uint32_t up;
+    uint32_t owned;
+    uint64_t transfers_out, transfers_in, transfer_errors;
+    uint64_t partitions_out, partitions_in;
+    uint64_t devices_out, devices_in;
+    uint64_t bytes_out, bytes_in;
+    uint64_t claimed;                     // partitions taken over from a down owner
+    uint64_t dropped;                     // partitions given up to a competing claim
+    double last_transfer_ms;              // export to ack, last transfer out
+} cluster_stats_t;
+
+typedef struct cluster cluster_t;
+
+// Binds the gossip address and starts the gossip, rebalance and transfer
+// threads. The first node (no join) owns every partition; a joining node
+// owns none until partitions move to it. NULL on a bad config or when the
+// address cannot be bound.
+cluster_t *cluster_start(const cluster_config_t *cfg);
+
+// Route of a device key. With CLUSTER_REMOTE the owner's HTTP address is
+// copied to owner (cap bytes). Lock free unless remote.
+cluster_route_t cluster_route(cluster_t *c, uint64_t key, char *owner, size_t cap);
+
+// Hands every owned partition to its target and gossips the node as left.
+// 0 when nothing was left behind, -1 when timeout_s ran out first.
+int cluster_leave(cluster_t *c, double timeout_s);
+
+void cluster_stop(cluster_t *c);
+
+void cluster_stats(cluster_t *c, cluster_stats_t *out);
+
+// Text map, malloc'd, for GET /cluster/map:
+//   partitions N
+//   member INDEX NAME HTTP GOSSIP up|down|leaving|left OWNED
+//   owners M0 M1 ... (member index per partition, -1 when unowned)
+char *cluster_map(cluster_t *c, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLUSTER_H
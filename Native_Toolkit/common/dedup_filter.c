@@ -0,0 +1,235 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "dedup_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOTS 4                           // fingerprints per bucket (one uint64_t)
+#define MAX_KICKS 500
+#define LOAD_LIMIT 0.92                   // cuckoo inserts start failing near 95 %
+#define CONFIRM_WAYS 4
+#define LANES 0x0001000100010001ull
+#define LANE_HIGH 0x8000800080008000ull
+
+// ================= HELPERS =================
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t dedup_hash(const void *data, size_t len) {
+    const uint8_t *p = data;
+    uint64_t h = 0xCBF29CE484222325ull ^ len;
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        h = (h ^ mix64(w)) * 0x100000001B3ull;
+    }
+    uint64_t w = 0;
+    memcpy(&w, p, len);
+    return mix64(h ^ w);
+}
+
+uint64_t dedup_key(uint64_t device, uint64_t value) {
+    return mix64(device ^ mix64(value + 0x9E3779B97F4A7C15ull));
+}
+
+static uint16_t fingerprint(uint64_t key) {
+    uint16_t fp = (uint16_t)(key >> 48);
+    return fp ? fp : 1;
+}
+
+static size_t alt_index(const dedup_filter_t *f, size_t i, uint16_t fp) {
+    return (i ^ (size_t)(fp * 0x5BD1E995u)) & f->mask;
+}
+
+// Lanes of the bucket equal to fp: a zero 16-bit lane in bucket ^ (fp x 4)
+static bool bucket_has(uint64_t bucket, uint16_t fp) {
+    uint64_t x = bucket ^ (fp * LANES);
+    return ((x - LANES) & ~x & LANE_HIGH) != 0;
+}
+
+static bool bucket_put(uint64_t *bucket, uint16_t fp) {
+    for (int s = 0; s < SLOTS; s++) {
+        if (!((*bucket >> (16 * s)) & 0xFFFF)) {
+            *bucket |= (uint64_t)fp << (16 * s);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ================= FILTER =================
+int dedup_init(dedup_filter_t *f, const dedup_config_t *cfg) {
+    memset(f, 0, sizeof(*f));
+    if (cfg->capacity == 0 || cfg->window_s <= 0.0) return -1;
+    f->cfg = *cfg;
+    size_t buckets = 1;
+    while (buckets * SLOTS * LOAD_LIMIT < cfg->capacity) buckets <<= 1;
+    f->mask = buckets - 1;
+    f->max_count = (size_t)(buckets * SLOTS * LOAD_LIMIT);
+    f->kick_rng = 0x2545F4914F6CDD1Dull;
+    for (int g = 0; g < 2; g++) {
+        f->gen[g].buckets = calloc(buckets, sizeof(uint64_t));
+        if (!f->gen[g].buckets) goto fail;
+    }
+    if (cfg->confirm_entries) {
+        size_t sets = 1;
+        while (sets * CONFIRM_WAYS < cfg->confirm_entries) sets <<= 1;
+        f->confirm_mask = sets - 1;
+        f->confirm_keys = calloc(sets * CONFIRM_WAYS, sizeof(*f->confirm_keys));
+        f->confirm_time = calloc(sets * CONFIRM_WAYS, sizeof(*f->confirm_time));
+        if (!f->confirm_keys || !f->confirm_time) goto fail;
+    }
+    f->gen[0].start = f->gen[1].start = -1.0;  // set by the first call
+    f->confirm_base = -1.0;
+    return 0;
+fail:
+    dedup_free(f);
+    return -1;
+}
+
+void dedup_free(dedup_filter_t *f) {
+    free(f->gen[0].buckets);
+    free(f->gen[1].buckets);
+    free(f->confirm_keys);
+    free(f->confirm_time);
+    memset(f, 0, sizeof(*f));
+}
+
+static void rotate(dedup_filter_t *f, double now) {
+    f->current ^= 1;
+    dedup_generation_t *g = &f->gen[f->current];
+    memset(g->buckets, 0, (f->mask + 1) * sizeof(uint64_t));
+    g->count = 0;
+    g->start = now;
+    f->epoch++;
+    f->stats.rotations++;
+}
+
+uint64_t dedup_epoch(dedup_filter_t *f, double now) {
+    dedup_generation_t *g = &f->gen[f->current];
+    if (g->start < 0.0) {
+        g->start = now;
+        f->confirm_base = now;
+    } else if (now - g->start >= f->cfg.window_s) {
+        rotate(f, now);
+    }
+    return f->epoch;
+}
+
+static bool filter_has(const dedup_filter_t *f, uint64_t key) {
+    uint16_t fp = fingerprint(key);
+    size_t i1 = (size_t)key & f->mask, i2 = alt_index(f, i1, fp);
+    for (int g = 0; g < 2; g++) {
+        const uint64_t *b = f->gen[g].buckets;
+        if (bucket_has(b[i1], fp) || bucket_has(b[i2], fp)) return true;
+    }
+    return false;
+}
+
+// ================= EXACT CACHE =================
+// Entries older than two windows are stale (the filter has forgotten them)
+static bool confirm_has(const dedup_filter_t *f, uint64_t key, double now) {
+    size_t set = (size_t)mix64(key) & f->confirm_mask;
+    float limit = (float)(now - f->confirm_base - 2.0 * f->cfg.window_s);
+    for (int w = 0; w < CONFIRM_WAYS; w++) {
+        size_t e = set * CONFIRM_WAYS + w;
+        if (f->confirm_keys[e] == key && f->confirm_time[e] >= limit) return true;
+    }
+    return false;
+}
+
+static void confirm_put(dedup_filter_t *f, uint64_t key, double now) {
+    size_t set = (size_t)mix64(key) & f->confirm_mask, oldest = set * CONFIRM_WAYS;
+    for (int w = 0; w < CONFIRM_WAYS; w++) {
+        size_t e = set * CONFIRM_WAYS + w;
+        if (f->confirm_keys[e] == key) {
+            oldest = e;
+            break;
+        }
+        // An empty way first: a key put at time 0.0 would look just as old
+        if (!f->confirm_keys[oldest]) continue;
+        if (!f->confirm_keys[e] || f->confirm_time[e] < f->confirm_time[oldest]) oldest = e;
+    }
+    f->confirm_keys[oldest] = key;
+    f->confirm_time[oldest] = (float)(now - f->confirm_base);
+}
+
+// ================= API =================
+dedup_result_t dedup_lookup(dedup_filter_t *f, uint64_t key, double now) {
+    dedup_epoch(f, now);
+    f->stats.lookups++;
+    if (!filter_has(f, key)) return DEDUP_NEW;
+    if (f->confirm_keys && confirm_has(f, key, now)) {
+        f->stats.duplicates++;
+        return DEDUP_DUPLICATE;
+    }
+    f->stats.probable++;
+    return DEDUP_PROBABLE;
+}
+
+void dedup_insert(dedup_filter_t *f, uint64_t key, double now) {
+    dedup_epoch(f, now);
+    dedup_generation_t *g = &f->gen[f->current];
+    if (g->count >= f->max_count) {
+        f->stats.early_rotations++;
+        rotate(f, now);
+        g = &f->gen[f->current];
+    }
+    f->stats.inserts++;
+    if (f->confirm_keys) confirm_put(f, key, now);
+
+    uint16_t fp = fingerprint(key);
+    size_t i = (size_t)key & f->mask;
+    if (bucket_put(&g->buckets[i], fp) || bucket_put(&g->buckets[alt_index(f, i, fp)], fp)) {
+        g->count++;
+        return;
+    }
+    // Evict a random fingerprint and move it to its other bucket
+    if (f->kick_rng & 1) i = alt_index(f, i, fp);
+    for (int k = 0; k < MAX_KICKS; k++) {
+        f->kick_rng ^= f->kick_rng << 13;
+        f->kick_rng ^= f->kick_rng >> 7;
+        f->kick_rng ^= f->kick_rng << 17;
+        int s = (int)(f->kick_rng % SLOTS);
+        uint16_t victim = (uint16_t)(g->buckets[i] >> (16 * s));
+        g->buckets[i] &= ~(0xFFFFull << (16 * s));
+        g->buckets[i] |= (uint64_t)fp << (16 * s);
+        fp = victim;
+        i = alt_index(f, i, fp);
+        if (bucket_put(&g->buckets[i], fp)) {
+            g->count++;
+            return;
+        }
+    }
+    // Table too full for this fingerprint: start a fresh generation with it
+    f->stats.early_rotations++;
+    rotate(f, now);
+    bucket_put(&f->gen[f->current].buckets[i], fp);
+    f->gen[f->current].count++;
+}
+
+bool dedup_check(dedup_filter_t *f, uint64_t key, double now) {
+    dedup_result_t r = dedup_lookup(f, key, now);
+    if (r == DEDUP_NEW) {
+        dedup_insert(f, key, now);
+        return false;
+    }
+    return r == DEDUP_DUPLICATE || f->cfg.drop_unconfirmed;
+}
+
+size_t dedup_memory(const dedup_filter_t *f) {
+    size_t m = 2 * (f->mask + 1) * sizeof(uint64_t);
+    if (f->confirm_keys) m += (f->confirm_mask + 1) * CONFIRM_WAYS * (sizeof(uint64_t) + sizeof(float));
+    return m;
+}
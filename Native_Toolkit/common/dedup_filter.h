@@ -0,0 +1,101 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Time-windowed duplicate filter for retransmitted payloads.
+//
+// Keys are 64-bit hashes of (device, payload) or (device, sequence). Two
+// cuckoo filter generations of 16-bit fingerprints, 4 per bucket, cover
+// the window: inserts go to the current one, lookups check both, and the
+// older one is cleared and reused once the current one is window_s old
+// (or full), so a key is remembered for between one and two windows in
+// 2.2 to 4.4 bytes per key (bucket counts are powers of two). A bucket holds 4 fingerprints in one 64-bit word,
+// compared at once, so a lookup is two or four cache lines.
+//
+// A fingerprint match may be a different key (about 2e-4 with both
+// generations full). An optional exact cache of recent full keys, 4-way
+// set associative, confirms it: a confirmed duplicate is certain, an
+// unconfirmed one is dropped only with drop_unconfirmed. With 2 x capacity
+// entries the cache holds every key the filter remembers (12 more bytes
+// per key); a smaller one lets the older copies through. One instance per
+// thread (no locking); host only.
+
+#ifndef DEDUP_FILTER_H
+#define DEDUP_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    DEDUP_NEW,
+    DEDUP_DUPLICATE,                      // exact cache hit
+    DEDUP_PROBABLE,                       // fingerprint hit, not in the exact cache
+} dedup_result_t;
+
+typedef struct {
+    size_t capacity;                      // keys per generation (rounded up to buckets of 4)
+    double window_s;
+    size_t confirm_entries;               // exact cache size, 0 for none
+    bool drop_unconfirmed;                // treat DEDUP_PROBABLE as a duplicate
+} dedup_config_t;
+
+typedef struct {
+    uint64_t lookups;
+    uint64_t duplicates;                  // confirmed
+    uint64_t probable;                    // unconfirmed fingerprint hits
+    uint64_t inserts;
+    uint64_t rotations;
+    uint64_t early_rotations;             // generation full before the window ended
+} dedup_stats_t;
+
+typedef struct {
+    uint64_t *buckets;                    // 4 x 16-bit fingerprints, 0 = empty
+    size_t count;
+    double start;
+} dedup_generation_t;
+
+typedef struct {
+    dedup_config_t cfg;
+    dedup_generation_t gen[2];
+    unsigned current;
+    uint64_t epoch;                       // bumped on every rotation
+    size_t mask;                          // buckets - 1
+    size_t max_count;                     // inserts before a generation counts as full
+    uint64_t *confirm_keys;
+    float *confirm_time;                  // seconds after confirm_base
+    double confirm_base;
+    size_t confirm_mask;                  // sets - 1
+    uint64_t kick_rng;
+    dedup_stats_t stats;
+} dedup_filter_t;
+
+// Returns 0, or -1 on a bad config or allocation failure.
+int dedup_init(dedup_filter_t *f, const dedup_config_t *cfg);
+void dedup_free(dedup_filter_t *f);
+
+// Looks the key up without remembering it; now is in seconds (any
+// monotonic origin, non-decreasing).
+dedup_result_t dedup_lookup(dedup_filter_t *f, uint64_t key, double now);
+
+// Remembers the key for at least one window.
+void dedup_insert(dedup_filter_t *f, uint64_t key, double now);
+
+// Lookup, then insert when new: true when the key is a duplicate (under
+// the drop_unconfirmed policy).
+bool dedup_check(dedup_filter_t *f, uint64_t key, double now);
+
+// Advances the generations to now; current generation id (for per-device
+// quotas that reset every generation)
+uint64_t dedup_epoch(dedup_filter_t *f, double now);
+
+size_t dedup_memory(const dedup_filter_t *f);
+
+// Key helpers: 64-bit hash of a payload, and of a device key with a
+// payload hash or a sequence number
+uint64_t dedup_hash(const void *data, size_t len);
+uint64_t dedup_key(uint64_t device, uint64_t value);
+
+#endif // DEDUP_FILTER_H
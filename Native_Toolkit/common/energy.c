@@ -0,0 +1,48 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "energy.h"
+
+#include <math.h>
+#include <string.h>
+
+const energy_mcu_t *energy_mcu_find(const char *name) {
+    for (size_t i = 0; i < ENERGY_MCU_COUNT; i++) {
+        if (!strcmp(ENERGY_MCUS[i].name, name)) return &ENERGY_MCUS[i];
+    }
+    return NULL;
+}
+
+double energy_cycles_from_host(const energy_mcu_t *mcu, double host_us) {
+    return host_us * mcu->host_slowdown * mcu->mhz;
+}
+
+void energy_estimate(const link_profile_t *link, const energy_mcu_t *mcu, const energy_policy_t *policy,
+                     double payload_bytes, double encode_cycles, energy_estimate_t *out) {
+    memset(out, 0, sizeof(*out));
+    double batch = policy->batch ? (double)policy->batch : 1.0;
+    double framing = batch > 1.0 ? policy->framing_bytes : 0.0;
+    out->uplink_bytes = batch * (payload_bytes + framing);
+    out->frames = link_profile_frames(link, out->uplink_bytes);
+    out->airtime_ms = link_profile_airtime_s(link, out->uplink_bytes) * 1000.0;
+
+    double p = link->frame_loss, p_fail = pow(p, policy->retries + 1.0);
+    out->sends = p < 1.0 ? (1.0 - p_fail) / (1.0 - p) : policy->retries + 1.0;
+    out->delivered = pow(1.0 - p_fail, out->frames);
+
+    // mW x s = mJ
+    double attempt_mj = (out->airtime_ms * link->tx_mw + out->frames * link->ack_window_ms * link->rx_mw) / 1000.0;
+    double radio_mj = link->wake_mj + out->sends * attempt_mj + link->tail_ms * link->rx_mw / 1000.0;
+    double cpu_mj = batch * encode_cycles / (mcu->mhz * 1e6) * mcu->active_mw;
+    double records = batch * out->delivered;
+    if (records <= 0.0) {
+        out->cpu_mj = out->radio_mj = out->mj = INFINITY;
+        return;
+    }
+    out->cpu_mj = cpu_mj / records;
+    out->radio_mj = radio_mj / records;
+    out->mj = out->cpu_mj + out->radio_mj;
+}
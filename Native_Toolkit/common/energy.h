@@ -0,0 +1,70 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Energy per delivered record: encode CPU plus radio, per codec, link
+// (common/link_profile.h), MCU power profile and batching policy.
+//
+// One uplink carries batch records (each with framing_bytes of length
+// prefix when batch > 1) in frames = ceil(bytes / mtu). Every frame is
+// acknowledged and resent up to retries times, so with frame loss p
+//   sends     = (1 - p^(retries+1)) / (1 - p)        per frame, expected
+//   delivered = (1 - p^(retries+1))^frames           per uplink
+//   radio     = wake + sends * (airtime * tx + frames * ack_window * rx)
+//               + tail * rx                          per uplink
+//   cpu       = batch * cycles / f_cpu * P_cpu
+//   E/record  = (radio + cpu) / (batch * delivered)
+// Encode cycles are measured on the MCU, or derived from a host timing
+// through the profile's slowdown factor. Sleep current between uplinks
+// is the same for every codec and is left out. Host only.
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stddef.h>
+
+#include "link_profile.h"
+
+typedef struct {
+    const char *name;
+    double mhz;                           // CPU clock while encoding
+    double active_mw;                     // CPU power while encoding
+    double host_slowdown;                 // MCU time / host time for the same encode
+} energy_mcu_t;
+
+static const energy_mcu_t ENERGY_MCUS[] = {
+    { "esp32", 240.0, 150.0, 25.0 },
+    { "esp32-80mhz", 80.0, 75.0, 75.0 },
+    { "esp32-s3", 240.0, 130.0, 20.0 },
+    { "esp32-c3", 160.0, 80.0, 35.0 },
+};
+
+#define ENERGY_MCU_COUNT (sizeof(ENERGY_MCUS) / sizeof(ENERGY_MCUS[0]))
+
+typedef struct {
+    size_t batch;                         // records per uplink
+    double framing_bytes;                 // per record when batch > 1
+    unsigned retries;                     // resends of a lost frame
+} energy_policy_t;
+
+typedef struct {
+    double uplink_bytes, frames;
+    double airtime_ms;                    // one transmission of the uplink
+    double sends;                         // expected transmissions per frame
+    double delivered;                     // probability that the whole uplink arrives
+    double cpu_mj, radio_mj;              // per delivered record
+    double mj;                            // total per delivered record
+} energy_estimate_t;
+
+// NULL if the name is unknown
+const energy_mcu_t *energy_mcu_find(const char *name);
+
+// MCU cycles for an encode timed at host_us on the host
+double energy_cycles_from_host(const energy_mcu_t *mcu, double host_us);
+
+void energy_estimate(const link_profile_t *link, const energy_mcu_t *mcu, const energy_policy_t *policy,
+                     double payload_bytes, double encode_cycles, energy_estimate_t *out);
+
+#endif // ENERGY_H
@@ -0,0 +1,205 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "field_stats.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLOAT32_REL_ERROR 1.2e-7              // two ulps of a float32 mantissa
+
+// ================= HELPERS =================
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Bits for values 0..span
+static unsigned width(uint64_t span) {
+    unsigned bits = 0;
+    while (bits < 64 && (span >> bits)) bits++;
+    return bits;
+}
+
+// Order-0 entropy of v[0..n), sorted in place
+static double entropy_i64(int64_t *v, size_t n, size_t *distinct) {
+    qsort(v, n, sizeof(*v), cmp_i64);
+    double h = 0.0;
+    size_t d = 0;
+    for (size_t i = 0, j; i < n; i = j) {
+        for (j = i + 1; j < n && v[j] == v[i]; j++) {
+        }
+        double p = (double)(j - i) / n;
+        h -= p * log2(p);
+        d++;
+    }
+    if (distinct) *distinct = d;
+    return h;
+}
+
+static double entropy_u64(uint64_t *v, size_t n, size_t *distinct) {
+    qsort(v, n, sizeof(*v), cmp_u64);
+    double h = 0.0;
+    size_t d = 0;
+    for (size_t i = 0, j; i < n; i = j) {
+        for (j = i + 1; j < n && v[j] == v[i]; j++) {
+        }
+        double p = (double)(j - i) / n;
+        h -= p * log2(p);
+        d++;
+    }
+    if (distinct) *distinct = d;
+    return h;
+}
+
+static double binary_entropy(double p) {
+    return p <= 0.0 || p >= 1.0 ? 0.0 : -p * log2(p) - (1.0 - p) * log2(1.0 - p);
+}
+
+// Fewest decimals at which every value is a whole number of units, up to
+// float32 rounding for float32 values. Values too large for the test at
+// that scale are skipped.
+static int detect_decimals(const double *x, size_t n, bool float32, bool *limited) {
+    double rel = float32 ? FLOAT32_REL_ERROR : 1e-15;
+    for (int k = 0; k <= FIELD_STATS_MAX_DECIMALS; k++) {
+        double scale = pow(10.0, k);
+        bool ok = true, lim = false;
+        for (size_t i = 0; i < n && ok; i++) {
+            double v = x[i] * scale, tol = fabs(v) * rel + 1e-6;
+            if (tol >= 0.5) lim = true;
+            else ok = fabs(v - round(v)) <= tol;
+        }
+        if (ok) {
+            *limited = lim;
+            return k;
+        }
+    }
+    *limited = true;
+    return FIELD_STATS_MAX_DECIMALS;
+}
+
+// ================= COLUMNS =================
+void field_stats_numeric(const double *x, size_t n, const int64_t *prev, bool float32, field_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->n = n;
+    if (n == 0) return;
+
+    double sum = 0.0;
+    out->min = out->max = x[0];
+    for (size_t i = 0; i < n; i++) {
+        sum += x[i];
+        if (x[i] < out->min) out->min = x[i];
+        if (x[i] > out->max) out->max = x[i];
+    }
+    out->mean = sum / n;
+    double ss = 0.0;
+    for (size_t i = 0; i < n; i++) ss += (x[i] - out->mean) * (x[i] - out->mean);
+    out->stddev = n > 1 ? sqrt(ss / (n - 1)) : 0.0;
+
+    out->decimals = detect_decimals(x, n, float32, &out->float_limited);
+    out->scale = pow(10.0, out->decimals);
+    int64_t *q = malloc(n * sizeof(*q));
+    int64_t *d = malloc(n * sizeof(*d));
+    double *abs_d = malloc(n * sizeof(*abs_d));
+    if (!q || !d || !abs_d) {
+        free(q);
+        free(d);
+        free(abs_d);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) q[i] = llround(x[i] * out->scale);
+
+    int64_t dmin = 0, dmax = 0;
+    size_t m = 0, changed = 0;
+    for (size_t i = 0; prev && i < n; i++) {
+        if (prev[i] < 0) continue;
+        int64_t delta = q[i] - q[prev[i]];
+        if (m == 0 || delta < dmin) dmin = delta;
+        if (m == 0 || delta > dmax) dmax = delta;
+        changed += delta != 0;
+        abs_d[m] = fabs((double)delta) / out->scale;
+        d[m++] = delta;
+    }
+    out->deltas = m;
+    if (m) {
+        out->changed = (double)changed / m;
+        out->delta_bits = width((uint64_t)(dmax - dmin));
+        out->delta_entropy_bits = entropy_i64(d, m, NULL);
+        qsort(abs_d, m, sizeof(*abs_d), cmp_double);
+        out->delta_p50 = abs_d[(m - 1) / 2];
+        out->delta_p99 = abs_d[(size_t)((m - 1) * 0.99)];
+    }
+
+    int64_t qmin = llround(out->min * out->scale), qmax = llround(out->max * out->scale);
+    out->bits = width((uint64_t)(qmax - qmin));
+    out->entropy_bits = entropy_i64(q, n, &out->distinct);
+    free(q);
+    free(d);
+    free(abs_d);
+}
+
+void field_stats_symbols(const uint64_t *sym, size_t n, const int64_t *prev, field_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->n = n;
+    if (n == 0) return;
+    size_t m = 0, changed = 0;
+    for (size_t i = 0; prev && i < n; i++) {
+        if (prev[i] < 0) continue;
+        changed += sym[i] != sym[prev[i]];
+        m++;
+    }
+    uint64_t *s = malloc(n * sizeof(*s));
+    if (!s) return;
+    memcpy(s, sym, n * sizeof(*s));
+    out->entropy_bits = entropy_u64(s, n, &out->distinct);
+    free(s);
+    out->bits = width(out->distinct - 1);
+    out->deltas = m;
+    if (m) {
+        // A change flag, then the symbol when it changed
+        out->changed = (double)changed / m;
+        out->delta_bits = out->bits + 1;
+        out->delta_entropy_bits = binary_entropy(out->changed) + out->changed * out->entropy_bits;
+    }
+}
+
+double field_stats_correlation(const double *x, const double *y, size_t n) {
+    if (n < 2) return 0.0;
+    double mx = 0.0, my = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxy = 0.0, sxx = 0.0, syy = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+        syy += (y[i] - my) * (y[i] - my);
+    }
+    return sxx > 0.0 && syy > 0.0 ? sxy / sqrt(sxx * syy) : 0.0;
+}
+
+uint64_t field_stats_hash(const char *s) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (; *s; s++) {
+        h ^= (uint8_t)*s;
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
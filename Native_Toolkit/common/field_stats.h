@@ -0,0 +1,63 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Column statistics for sizing a record field (tools/field_profile).
+//
+// A numeric column is quantized at the fewest decimals that represent
+// every value (float32 rounding tolerated for float fields); that gives
+// the scale, the offset (minimum) and the fixed bit width of the range. Entropy is the
+// order-0 entropy of the quantized values, i.e. what a static per-field
+// entropy coder could reach.
+//
+// Deltas: prev[i] is the index of the previous value of the same series
+// (the same device), or -1. Deltas are taken between quantized values,
+// so their bit width and entropy are what a per-device delta coder would
+// spend after a keyframe. Symbol columns (strings, hashed by the caller)
+// get entropy, distinct count, dictionary index width and how often the
+// value changes within a series; their delta cost is a change flag plus
+// the symbol when it changed. Host only.
+
+#ifndef FIELD_STATS_H
+#define FIELD_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FIELD_STATS_MAX_DECIMALS 6
+
+typedef struct {
+    size_t n;
+    double min, max, mean, stddev;
+    int decimals;                         // of the quantization
+    bool float_limited;                   // finer decimals are below float32 resolution
+    double scale;                         // 10^decimals
+    unsigned bits;                        // fixed width of (value - min) * scale
+    double entropy_bits;                  // per value, order 0
+    size_t distinct;
+
+    size_t deltas;                        // values with a predecessor
+    double changed;                       // fraction of deltas that are not 0
+    unsigned delta_bits;                  // fixed width of the delta range
+    double delta_entropy_bits;
+    double delta_p50, delta_p99;          // |delta| in value units
+} field_stats_t;
+
+// x[0..n); prev may be NULL (no series). float32: the values went through
+// a float32, so decimals are matched within its rounding.
+void field_stats_numeric(const double *x, size_t n, const int64_t *prev, bool float32, field_stats_t *out);
+
+// Hashed symbols; bits is the dictionary index width. Value figures
+// (min, max, decimals...) stay 0.
+void field_stats_symbols(const uint64_t *sym, size_t n, const int64_t *prev, field_stats_t *out);
+
+// Pearson correlation, 0 when either column is constant
+double field_stats_correlation(const double *x, const double *y, size_t n);
+
+// 64-bit FNV-1a, for symbol columns
+uint64_t field_stats_hash(const char *s);
+
+#endif // FIELD_STATS_H
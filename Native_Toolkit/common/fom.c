@@ -0,0 +1,122 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "fom.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Two-sided 95 % Student-t quantiles for 1..30 degrees of freedom
+static const double T95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+static double t95(unsigned df) {
+    // Beyond the table 1.96 + 2.5 / df is within 0.002 of the exact value
+    return df <= 30 ? T95[df - 1] : 1.96 + 2.5 / df;
+}
+
+void fom_stat(const double *x, unsigned n, fom_stat_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->n = n;
+    if (n == 0) return;
+    double sum = 0.0;
+    for (unsigned i = 0; i < n; i++) sum += x[i];
+    out->mean = sum / n;
+    out->ci_lo = out->ci_hi = out->mean;
+    if (n < 2) return;
+    double ss = 0.0;
+    for (unsigned i = 0; i < n; i++) ss += (x[i] - out->mean) * (x[i] - out->mean);
+    out->stddev = sqrt(ss / (n - 1));
+    double half = t95(n - 1) * out->stddev / sqrt((double)n);
+    out->ci_lo = out->mean - half;
+    out->ci_hi = out->mean + half;
+}
+
+double fom_success(const link_profile_t *link, const fom_run_t *run) {
+    if (run->total == 0) return 0.0;
+    double accepted = (double)run->ok / (double)run->total;
+    return accepted * pow(1.0 - link->frame_loss, link_profile_frames(link, run->payload_bytes));
+}
+
+double fom_time_ms(const link_profile_t *link, const fom_run_t *run) {
+    return link_profile_airtime_s(link, run->payload_bytes) * 1000.0 + run->latency_ms;
+}
+
+static double term(double ref, double value, double weight) {
+    if (weight == 0.0) return 1.0;
+    return value > 0.0 ? pow(ref / value, weight) : 0.0;
+}
+
+int fom_compute(const fom_run_t *runs, size_t n, const link_profile_t *link, const char *baseline,
+                const fom_weights_t *w, fom_result_t *out, size_t cap) {
+    // Baseline means on this link
+    double ref_bytes = 0.0, ref_time = 0.0, ref_cpu = 0.0;
+    unsigned ref_n = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (w->cpu != 0.0 && runs[i].cpu_us <= 0.0) return -1;
+        if (strcmp(runs[i].codec, baseline)) continue;
+        ref_bytes += runs[i].payload_bytes;
+        ref_time += fom_time_ms(link, &runs[i]);
+        ref_cpu += runs[i].cpu_us;
+        ref_n++;
+    }
+    if (ref_n == 0) return -1;
+    ref_bytes /= ref_n;
+    ref_time /= ref_n;
+    ref_cpu /= ref_n;
+
+    double *x[6];
+    for (int k = 0; k < 6; k++) {
+        x[k] = malloc(n * sizeof(double));
+        if (!x[k]) {
+            while (k--) free(x[k]);
+            return -1;
+        }
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < n && count < cap; i++) {
+        int seen = 0;
+        for (size_t r = 0; r < count; r++) seen |= !strcmp(out[r].codec, runs[i].codec);
+        if (seen) continue;
+
+        unsigned m = 0;
+        for (size_t j = i; j < n; j++) {
+            const fom_run_t *run = &runs[j];
+            if (strcmp(run->codec, runs[i].codec)) continue;
+            double success = fom_success(link, run), time_ms = fom_time_ms(link, run);
+            x[0][m] = run->payload_bytes;
+            x[1][m] = link_profile_frames(link, run->payload_bytes);
+            x[2][m] = time_ms;
+            x[3][m] = success;
+            x[4][m] = run->cpu_us;
+            x[5][m] = (w->success == 0.0 ? 1.0 : pow(success, w->success)) *
+                      term(ref_bytes, run->payload_bytes, w->size) * term(ref_time, time_ms, w->time) *
+                      term(ref_cpu, run->cpu_us, w->cpu);
+            m++;
+        }
+        fom_result_t *res = &out[count++];
+        memset(res, 0, sizeof(*res));
+        memcpy(res->codec, runs[i].codec, FOM_CODEC_MAX);
+        res->link = link;
+        fom_stat(x[0], m, &res->bytes);
+        fom_stat(x[1], m, &res->frames);
+        fom_stat(x[2], m, &res->time_ms);
+        fom_stat(x[3], m, &res->success);
+        fom_stat(x[4], m, &res->cpu_us);
+        fom_stat(x[5], m, &res->fom);
+    }
+    for (int k = 0; k < 6; k++) free(x[k]);
+
+    for (size_t r = 0; r < count; r++) {
+        out[r].rank = 1;
+        for (size_t o = 0; o < count; o++) out[r].rank += out[o].fom.mean > out[r].fom.mean;
+    }
+    return (int)count;
+}
@@ -0,0 +1,76 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Figure of Merit: payload size, transmission time and success rate (and
+// optionally encode CPU cost) in one number per codec and link.
+//
+// For one run of a codec over a link (common/link_profile.h):
+//   frames    = ceil(bytes / mtu)
+//   success   = ok / total * (1 - frame_loss)^frames
+//   time      = airtime(bytes) + latency_ms
+//   FoM       = success^ws * (B0 / bytes)^wb * (T0 / time)^wt * (C0 / cpu)^wc
+// where B0, T0 and C0 are the baseline codec's means on the same link, so
+// the baseline scores about 1 and a codec at 1.2 is 20 % better by the
+// weighted measure. latency_ms is the receiver's measured latency
+// (loadgen); a fixed path delay is left out, because it is the same for
+// every codec and only compresses the time ratio.
+//
+// Repeated runs give a mean and a 95 % Student-t interval for each term
+// and for the FoM. The interval covers run-to-run spread; the baseline
+// means are taken as exact. Host only.
+
+#ifndef FOM_H
+#define FOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "link_profile.h"
+
+#define FOM_CODEC_MAX 24
+
+typedef struct {
+    char codec[FOM_CODEC_MAX];
+    double payload_bytes;                 // mean encoded size
+    double latency_ms;                    // mean receiver latency, 0 if not measured
+    uint64_t ok, total;                   // accepted / sent
+    double cpu_us;                        // encode cost per message, < 0 if not measured
+} fom_run_t;
+
+typedef struct {
+    double success, size, time, cpu;      // exponents, 0 drops a term
+} fom_weights_t;
+
+typedef struct {
+    unsigned n;
+    double mean, stddev;
+    double ci_lo, ci_hi;                  // 95 %, equal to the mean when n = 1
+} fom_stat_t;
+
+typedef struct {
+    char codec[FOM_CODEC_MAX];
+    const link_profile_t *link;
+    fom_stat_t bytes, frames, time_ms, success, cpu_us, fom;
+    int rank;                             // 1 = highest mean FoM on this link
+} fom_result_t;
+
+static const fom_weights_t FOM_DEFAULT_WEIGHTS = { 1.0, 1.0, 1.0, 0.0 };
+
+// Mean, sample standard deviation and 95 % interval of x[0..n)
+void fom_stat(const double *x, unsigned n, fom_stat_t *out);
+
+// Per-message terms of one run on a link
+double fom_success(const link_profile_t *link, const fom_run_t *run);
+double fom_time_ms(const link_profile_t *link, const fom_run_t *run);
+
+// Groups runs by codec (first-seen order) and scores them on one link
+// against the baseline codec's means. Fills up to cap results and returns
+// their count; -1 if the baseline has no runs, or the CPU term is weighted
+// and a run has no cpu_us.
+int fom_compute(const fom_run_t *runs, size_t n, const link_profile_t *link, const char *baseline,
+                const fom_weights_t *w, fom_result_t *out, size_t cap);
+
+#endif // FOM_H
@@ -0,0 +1,192 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "hdr_histogram.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int floor_log2(int64_t v) {
+    return 63 - __builtin_clzll((unsigned long long)v);
+}
+
+int hdr_init(hdr_histogram_t *h, int64_t lowest, int64_t highest, int significant_digits) {
+    memset(h, 0, sizeof(*h));
+    if (lowest < 1 || highest < 2 * lowest || significant_digits < 1 || significant_digits > 5) return -1;
+
+    int64_t largest_single_unit = 2;
+    for (int i = 0; i < significant_digits; i++) largest_single_unit *= 10;
+    int sub_bucket_count_magnitude = (int)ceil(log2((double)largest_single_unit));
+
+    h->lowest = lowest;
+    h->highest = highest;
+    h->significant_digits = significant_digits;
+    h->unit_magnitude = floor_log2(lowest);
+    h->sub_bucket_half_count_magnitude = (sub_bucket_count_magnitude > 1 ? sub_bucket_count_magnitude : 1) - 1;
+    h->sub_bucket_count = 1 << (h->sub_bucket_half_count_magnitude + 1);
+    h->sub_bucket_half_count = h->sub_bucket_count / 2;
+    h->sub_bucket_mask = ((int64_t)h->sub_bucket_count - 1) << h->unit_magnitude;
+
+    // Buckets needed to cover highest: each one doubles the range
+    int64_t smallest_untrackable = (int64_t)h->sub_bucket_count << h->unit_magnitude;
+    int32_t buckets = 1;
+    while (smallest_untrackable <= highest) {
+        if (smallest_untrackable > INT64_MAX / 2) {
+            buckets++;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        buckets++;
+    }
+    h->bucket_count = buckets;
+    h->counts_len = (buckets + 1) * h->sub_bucket_half_count;
+    h->counts = calloc((size_t)h->counts_len, sizeof(int64_t));
+    if (!h->counts) return -1;
+    h->min = INT64_MAX;
+    return 0;
+}
+
+void hdr_free(hdr_histogram_t *h) {
+    free(h->counts);
+    h->counts = NULL;
+}
+
+void hdr_reset(hdr_histogram_t *h) {
+    memset(h->counts, 0, (size_t)h->counts_len * sizeof(int64_t));
+    h->total_count = 0;
+    h->min = INT64_MAX;
+    h->max = 0;
+    h->saturated = 0;
+}
+
+static int32_t counts_index(const hdr_histogram_t *h, int64_t value) {
+    int pow2ceiling = 64 - __builtin_clzll((unsigned long long)(value | h->sub_bucket_mask));
+    int32_t bucket = pow2ceiling - h->unit_magnitude - (h->sub_bucket_half_count_magnitude + 1);
+    int32_t sub_bucket = (int32_t)(value >> (bucket + h->unit_magnitude));
+    return ((bucket + 1) << h->sub_bucket_half_count_magnitude) + (sub_bucket - h->sub_bucket_half_count);
+}
+
+// Lowest value of the range counted at index, and the range width
+static int64_t value_at_index(const hdr_histogram_t *h, int32_t index, int64_t *range) {
+    int32_t bucket = (index >> h->sub_bucket_half_count_magnitude) - 1;
+    int32_t sub_bucket = (index & (h->sub_bucket_half_count - 1)) + h->sub_bucket_half_count;
+    if (bucket < 0) {
+        sub_bucket -= h->sub_bucket_half_count;
+        bucket = 0;
+    }
+    if (range) *range = (int64_t)1 << (h->unit_magnitude + bucket);
+    return (int64_t)sub_bucket << (bucket + h->unit_magnitude);
+}
+
+void hdr_record_n(hdr_histogram_t *h, int64_t value, int64_t count) {
+    if (value < 0) value = 0;
+    if (value > h->highest) {
+        value = h->highest;
+        h->saturated += count;
+    }
+    h->counts[counts_index(h, value)] += count;
+    h->total_count += count;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+void hdr_record(hdr_histogram_t *h, int64_t value) {
+    hdr_record_n(h, value, 1);
+}
+
+int hdr_add(hdr_histogram_t *dst, const hdr_histogram_t *src) {
+    if (dst->counts_len != src->counts_len || dst->unit_magnitude != src->unit_magnitude) return -1;
+    for (int32_t i = 0; i < src->counts_len; i++) dst->counts[i] += src->counts[i];
+    dst->total_count += src->total_count;
+    dst->saturated += src->saturated;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    return 0;
+}
+
+// Highest value that falls into the same count as value
+static int64_t highest_equivalent(const hdr_histogram_t *h, int32_t index) {
+    int64_t range;
+    int64_t lowest = value_at_index(h, index, &range);
+    return lowest + range - 1;
+}
+
+int64_t hdr_value_at_percentile(const hdr_histogram_t *h, double percentile) {
+    if (h->total_count == 0) return 0;
+    if (percentile > 100.0) percentile = 100.0;
+    int64_t target = (int64_t)(percentile / 100.0 * (double)h->total_count + 0.5);
+    if (target < 1) target = 1;
+
+    int64_t seen = 0;
+    for (int32_t i = 0; i < h->counts_len; i++) {
+        seen += h->counts[i];
+        if (seen >= target) {
+            int64_t v = highest_equivalent(h, i);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+double hdr_mean(const hdr_histogram_t *h) {
+    if (h->total_count == 0) return 0.0;
+    double sum = 0.0;
+    for (int32_t i = 0; i < h->counts_len; i++) {
+        if (!h->counts[i]) continue;
+        int64_t range;
+        int64_t lowest = value_at_index(h, i, &range);
+        sum += (double)h->counts[i] * ((double)lowest + (double)(range - 1) / 2.0);
+    }
+    return sum / (double)h->total_count;
+}
+
+double hdr_stddev(const hdr_histogram_t *h) {
+    if (h->total_count == 0) return 0.0;
+    double mean = hdr_mean(h), sum = 0.0;
+    for (int32_t i = 0; i < h->counts_len; i++) {
+        if (!h->counts[i]) continue;
+        int64_t range;
+        double mid = (double)value_at_index(h, i, &range) + (double)(range - 1) / 2.0;
+        sum += (double)h->counts[i] * (mid - mean) * (mid - mean);
+    }
+    return sqrt(sum / (double)h->total_count);
+}
+
+void hdr_write_percentiles(const hdr_histogram_t *h, FILE *out, int ticks_per_half_distance, double value_scale) {
+    fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+    if (h->total_count > 0) {
+        // Percentile steps halve the remaining distance to 100 every ticks_per_half_distance lines
+        double percentile = 0.0;
+        int64_t last_count = -1;
+        while (1) {
+            int64_t target = (int64_t)(percentile / 100.0 * (double)h->total_count + 0.5);
+            int64_t value = hdr_value_at_percentile(h, percentile);
+            int64_t count = 0;
+            for (int32_t i = 0; i < h->counts_len; i++) {
+                if (value_at_index(h, i, NULL) > value) break;
+                count += h->counts[i];
+            }
+            if (count != last_count || target >= h->total_count) {
+                double frac = percentile / 100.0;
+                if (frac < 1.0) {
+                    fprintf(out, "%12.3f %2.12f %10lld %14.2f\n", (double)value / value_scale, frac,
+                            (long long)count, 1.0 / (1.0 - frac));
+                }
+                last_count = count;
+            }
+            if (count >= h->total_count) break;
+            double half_distance = pow(2.0, floor(log2(100.0 / (100.0 - percentile))) + 1.0);
+            percentile += 100.0 / (half_distance * ticks_per_half_distance);
+        }
+        fprintf(out, "%12.3f %2.12f %10lld\n", (double)h->max / value_scale, 1.0, (long long)h->total_count);
+    }
+    fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", hdr_mean(h) / value_scale,
+            hdr_stddev(h) / value_scale);
+    fprintf(out, "#[Max     = %12.3f, Total count    = %12lld]\n", (double)h->max / value_scale,
+            (long long)h->total_count);
+    fprintf(out, "#[Buckets = %12d, SubBuckets     = %12d]\n", h->bucket_count, h->sub_bucket_count);
+}
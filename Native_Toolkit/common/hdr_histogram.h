@@ -0,0 +1,62 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// High dynamic range histogram (HdrHistogram layout) for latency recording.
+//
+// Values are integers (microseconds in the load tools) tracked from lowest
+// to highest with a fixed number of significant decimal digits: buckets
+// double in range, each split into 2 * 10^digits linear sub-buckets, so a
+// recorded value is off by at most 1 part in 10^digits. Recording is one
+// clz and one increment; histograms of the same shape merge by addition.
+// Host only.
+
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    int64_t lowest;
+    int64_t highest;
+    int significant_digits;
+    int unit_magnitude;
+    int sub_bucket_half_count_magnitude;
+    int32_t sub_bucket_count;
+    int32_t sub_bucket_half_count;
+    int64_t sub_bucket_mask;
+    int32_t bucket_count;
+    int32_t counts_len;
+    int64_t total_count;
+    int64_t min;
+    int64_t max;
+    int64_t saturated;                    // values above highest, recorded as highest
+    int64_t *counts;
+} hdr_histogram_t;
+
+// lowest >= 1, highest >= 2 * lowest, digits 1..5. Returns 0, or -1 on
+// bad arguments or allocation failure.
+int hdr_init(hdr_histogram_t *h, int64_t lowest, int64_t highest, int significant_digits);
+void hdr_free(hdr_histogram_t *h);
+void hdr_reset(hdr_histogram_t *h);
+
+void hdr_record(hdr_histogram_t *h, int64_t value);
+void hdr_record_n(hdr_histogram_t *h, int64_t value, int64_t count);
+
+// Adds src into dst; both must have been created with the same arguments.
+// Returns 0, or -1 on a shape mismatch.
+int hdr_add(hdr_histogram_t *dst, const hdr_histogram_t *src);
+
+// percentile in [0, 100]; 0 for an empty histogram
+int64_t hdr_value_at_percentile(const hdr_histogram_t *h, double percentile);
+double hdr_mean(const hdr_histogram_t *h);
+double hdr_stddev(const hdr_histogram_t *h);
+
+// Percentile distribution in the HdrHistogram .hgrm text format (readable
+// by the HdrHistogram plotter), values divided by value_scale.
+void hdr_write_percentiles(const hdr_histogram_t *h, FILE *out, int ticks_per_half_distance, double value_scale);
+
+#endif // HDR_HISTOGRAM_H
@@ -0,0 +1,613 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "http_load.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RBUF_SIZE 8192
+#define MAX_EVENTS 512
+#define TIMER_TAG UINT64_MAX
+#define RECONNECT_DELAY_NS 100000000ull   // after a failed connect
+#define TIMEOUT_SCAN_NS 10000000ull
+#define START_DELAY_NS 100000000ull       // lets every thread set up before the first arrival
+
+typedef enum { CONN_CLOSED, CONN_CONNECTING, CONN_IDLE, CONN_BUSY } conn_state_t;
+
+typedef struct {
+    int fd;
+    conn_state_t state;
+    int on_idle_stack;
+    const http_load_request_t *req;
+    size_t written;
+    uint64_t intended_ns;
+    uint64_t sent_ns;
+    uint64_t retry_at_ns;
+    size_t rlen;
+    char rbuf[RBUF_SIZE];
+} conn_t;
+
+typedef struct {
+    const http_load_config_t *cfg;
+    unsigned index;
+    pthread_t thread;
+    int epfd;
+    int tfd;
+    const struct sockaddr *addr;
+    socklen_t addrlen;
+
+    conn_t *conns;
+    unsigned conn_count;
+    unsigned *idle;                       // stack of idle connection indices, each at most once
+    unsigned idle_count;
+
+    uint64_t *backlog;                    // intended send times, FIFO ring
+    size_t backlog_head;
+    size_t backlog_count;
+
+    uint64_t start_ns;
+    uint64_t measure_ns;                  // end of warm-up
+    uint64_t end_ns;                      // no arrivals at or after this
+    arrival_t arrivals;                   // this thread's shard of the schedule
+    uint64_t next_arrival_ns;
+    size_t next_request;
+
+    http_load_result_t res;
+    int failed;
+} worker_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ================= REQUESTS =================
+int http_load_render_post(http_load_request_t *req, const char *host, const char *path,
+                          const char *content_type, const char *extra_headers, const uint8_t *body, size_t len) {
+    char head[1024];
+    int n = snprintf(head, sizeof(head),
+                     "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n",
+                     path, host, content_type, len, extra_headers ? extra_headers : "");
+    if (n < 0 || (size_t)n >= sizeof(head)) return -1;
+
+    req->data = malloc((size_t)n + len);
+    if (!req->data) return -1;
+    memcpy(req->data, head, (size_t)n);
+    memcpy(req->data + n, body, len);
+    req->len = (size_t)n + len;
+    return 0;
+}
+
+void http_load_free_request(http_load_request_t *req) {
+    free(req->data);
+    req->data = NULL;
+    req->len = 0;
+}
+
+int http_load_parse_url(const char *url, char *host, size_t host_cap, uint16_t *port, char *path, size_t path_cap) {
+    if (strncmp(url, "http://", 7) != 0) return -1;
+    const char *h = url + 7;
+    const char *slash = strchr(h, '/');
+    const char *colon = strchr(h, ':');
+    if (colon && slash && colon > slash) colon = NULL;
+    const char *host_end = colon ? colon : slash ? slash : h + strlen(h);
+    size_t host_len = (size_t)(host_end - h);
+    if (host_len == 0 || host_len >= host_cap) return -1;
+    memcpy(host, h, host_len);
+    host[host_len] = '\0';
+    long p = colon ? strtol(colon + 1, NULL, 10) : 80;
+    if (p <= 0 || p > 65535) return -1;
+    *port = (uint16_t)p;
+    if ((size_t)snprintf(path, path_cap, "%s", slash ? slash : "/") >= path_cap) return -1;
+    return 0;
+}
+
+int http_load_get(const char *host, uint16_t port, const char *path, double timeout_s, char *body, size_t cap) {
+    char port_s[8];
+    snprintf(port_s, sizeof(port_s), "%u", port);
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *ai;
+    if (getaddrinfo(host, port_s, &hints, &ai) != 0) return -1;
+    int fd = socket(ai->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct timeval tv = { (time_t)timeout_s, (suseconds_t)((timeout_s - (time_t)timeout_s) * 1e6) };
+    if (fd >= 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+    if (fd < 0 || connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+        if (fd >= 0) close(fd);
+        freeaddrinfo(ai);
+        return -1;
+    }
+    freeaddrinfo(ai);
+
+    char buf[65536];
+    int n = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: %s:%u\r\nConnection: close\r\n\r\n", path, host, port);
+    if (send(fd, buf, (size_t)n, MSG_NOSIGNAL) != n) {
+        close(fd);
+        return -1;
+    }
+    // Connection: close, so the response ends at EOF
+    size_t len = 0;
+    ssize_t r;
+    while (len < sizeof(buf) - 1 && (r = recv(fd, buf + len, sizeof(buf) - 1 - len, 0)) > 0) len += (size_t)r;
+    close(fd);
+    buf[len] = '\0';
+
+    int status;
+    if (sscanf(buf, "HTTP/1.%*d %d", &status) != 1) return -1;
+    const char *start = strstr(buf, "\r\n\r\n");
+    start = start ? start + 4 : buf + len;
+    if (body && cap) snprintf(body, cap, "%s", start);
+    return status;
+}
+
+long http_load_raise_fd_limit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return -1;
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+    getrlimit(RLIMIT_NOFILE, &rl);
+    return (long)rl.rlim_cur;
+}
+
+// ================= CONNECTIONS =================
+static int set_interest(worker_t *w, unsigned i, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.u64 = i };
+    return epoll_ctl(w->epfd, EPOLL_CTL_MOD, w->conns[i].fd, &ev);
+}
+
+static void conn_close(worker_t *w, unsigned i, uint64_t retry_at) {
+    conn_t *c = &w->conns[i];
+    if (c->fd >= 0) close(c->fd);    // also removes it from the epoll set
+    c->fd = -1;
+    c->state = CONN_CLOSED;
+    c->retry_at_ns = retry_at;
+    c->rlen = 0;
+}
+
+static void conn_open(worker_t *w, unsigned i, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    int fd = socket(w->addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        c->retry_at_ns = now + RECONNECT_DELAY_NS;
+        return;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    c->fd = fd;
+    c->state = CONN_CONNECTING;
+    c->rlen = 0;
+    struct epoll_event ev = { .events = EPOLLOUT | EPOLLIN, .data.u64 = i };
+    if ((connect(fd, w->addr, w->addrlen) != 0 && errno != EINPROGRESS) ||
+        epoll_ctl(w->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        if (now >= w->measure_ns) w->res.errors++;
+        conn_close(w, i, now + RECONNECT_DELAY_NS);
+        return;
+    }
+    w->res.connects++;
+}
+
+static void push_idle(worker_t *w, unsigned i) {
+    w->conns[i].state = CONN_IDLE;
+    if (!w->conns[i].on_idle_stack) {
+        w->conns[i].on_idle_stack = 1;
+        w->idle[w->idle_count++] = i;
+    }
+}
+
+// Idle stack entries may be stale (closed while idle): skip them
+static int pop_idle(worker_t *w, unsigned *i) {
+    while (w->idle_count > 0) {
+        unsigned c = w->idle[--w->idle_count];
+        w->conns[c].on_idle_stack = 0;
+        if (w->conns[c].state == CONN_IDLE) {
+            *i = c;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static uint64_t next_arrival(worker_t *w) {
+    double t = arrival_next(&w->arrivals) * 1e9;
+    return t < (double)(w->end_ns - w->start_ns) ? w->start_ns + (uint64_t)t : w->end_ns;
+}
+
+// ================= REQUEST LIFECYCLE =================
+static int measured(const worker_t *w, uint64_t intended) {
+    return intended >= w->measure_ns;
+}
+
+static void request_failed(worker_t *w, unsigned i, int timeout, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    if (measured(w, c->intended_ns)) {
+        if (timeout) w->res.timeouts++;
+        else w->res.errors++;
+    }
+    conn_close(w, i, now);
+}
+
+static void write_request(worker_t *w, unsigned i, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    while (c->written < c->req->len) {
+        ssize_t n = send(c->fd, c->req->data + c->written, c->req->len - c->written, MSG_NOSIGNAL);
+        if (n > 0) {
+            c->written += (size_t)n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            set_interest(w, i, EPOLLIN | EPOLLOUT);
+            return;
+        } else {
+            request_failed(w, i, 0, now);
+            return;
+        }
+    }
+    if (measured(w, c->intended_ns)) w->res.bytes_sent += c->req->len;
+    set_interest(w, i, EPOLLIN);
+}
+
+static void start_request(worker_t *w, unsigned i, uint64_t intended, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    c->state = CONN_BUSY;
+    c->req = &w->cfg->requests[w->next_request++ % w->cfg->request_count];
+    c->written = 0;
+    c->intended_ns = intended;
+    c->sent_ns = now;
+    c->rlen = 0;
+    if (measured(w, intended)) w->res.sent++;
+    write_request(w, i, now);
+}
+
+// 1 = complete response, 0 = need more bytes, -1 = malformed.
+// *close_after is set when the server will close the connection.
+static int parse_response(const conn_t *c, int eof, int *status, int *close_after) {
+    const char *end = memmem(c->rbuf, c->rlen, "\r\n\r\n", 4);
+    if (!end) return c->rlen == RBUF_SIZE || eof ? -1 : 0;
+    size_t header_len = (size_t)(end - c->rbuf) + 4;
+
+    if (c->rlen < 12 || strncmp(c->rbuf, "HTTP/1.", 7) != 0) return -1;
+    *status = atoi(c->rbuf + 9);
+    *close_after = c->rbuf[7] == '0';    // HTTP/1.0 closes unless told otherwise
+
+    long content_length = -1;
+    int chunked = 0;
+    const char *line = memchr(c->rbuf, '\n', header_len) + 1;
+    while (line < end) {
+        const char *eol = memchr(line, '\n', (size_t)(end + 2 - line));
+        if (!eol) break;
+        if (!strncasecmp(line, "content-length:", 15)) {
+            content_length = strtol(line + 15, NULL, 10);
+        } else if (!strncasecmp(line, "transfer-encoding:", 18)) {
+            chunked = memmem(line, (size_t)(eol - line), "chunked", 7) != NULL;
+        } else if (!strncasecmp(line, "connection:", 11)) {
+            if (memmem(line, (size_t)(eol - line), "close", 5)) *close_after = 1;
+            if (memmem(line, (size_t)(eol - line), "keep-alive", 10)) *close_after = 0;
+        }
+        line = eol + 1;
+    }
+
+    if (*status == 204 || *status == 304) return 1;
+    if (content_length >= 0) {
+        if (header_len + (size_t)content_length > RBUF_SIZE) return -1;
+        return c->rlen >= header_len + (size_t)content_length;
+    }
+    if (chunked) {
+        // Small bodies only: the last chunk marker ends the response
+        return memmem(c->rbuf + header_len - 2, c->rlen - header_len + 2, "\r\n0\r\n\r\n", 7) != NULL ? 1
+               : c->rlen == RBUF_SIZE ? -1 : 0;
+    }
+    *close_after = 1;
+    return eof ? 1 : 0;
+}
+
+static void finish_request(worker_t *w, unsigned i, int status, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    if (measured(w, c->intended_ns)) {
+        http_load_result_t *r = &w->res;
+        r->completed++;
+        r->bytes_received += c->rlen;
+        if (status >= 200 && status < 300) r->status_2xx++;
+        else if (status >= 300 && status < 400) r->status_3xx++;
+        else if (status >= 400 && status < 500) r->status_4xx++;
+        else r->status_5xx++;
+        if (status == 429) r->status_429++;
+        hdr_record(&r->corrected, (int64_t)((now - c->intended_ns) / 1000));
+        hdr_record(&r->service, (int64_t)((now - c->sent_ns) / 1000));
+    }
+}
+
+static void on_readable(worker_t *w, unsigned i, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    int eof = 0;
+    while (c->rlen < RBUF_SIZE) {
+        ssize_t n = recv(c->fd, c->rbuf + c->rlen, RBUF_SIZE - c->rlen, 0);
+        if (n > 0) {
+            c->rlen += (size_t)n;
+        } else if (n == 0) {
+            eof = 1;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            eof = 1;
+            break;
+        }
+    }
+
+    if (c->state != CONN_BUSY) {
+        // Server closed an idle keep-alive connection: reopen at once
+        if (eof) conn_close(w, i, now);
+        else c->rlen = 0;
+        return;
+    }
+
+    int status = 0, close_after = 0;
+    int rc = parse_response(c, eof, &status, &close_after);
+    if (rc == 0 && !eof) return;
+    if (rc <= 0) {
+        request_failed(w, i, 0, now);
+        return;
+    }
+    finish_request(w, i, status, now);
+    if (close_after || eof) {
+        conn_close(w, i, now);
+    } else {
+        c->rlen = 0;
+        push_idle(w, i);
+    }
+}
+
+static void on_event(worker_t *w, unsigned i, uint32_t events, uint64_t now) {
+    conn_t *c = &w->conns[i];
+    if (c->state == CONN_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0 || (events & (EPOLLERR | EPOLLHUP))) {
+            if (now >= w->measure_ns) w->res.errors++;
+            conn_close(w, i, now + RECONNECT_DELAY_NS);
+            return;
+        }
+        set_interest(w, i, EPOLLIN);
+        push_idle(w, i);
+        return;
+    }
+    if (c->state == CONN_BUSY && (events & EPOLLOUT) && c->written < c->req->len) {
+        write_request(w, i, now);
+        if (c->state != CONN_BUSY) return;
+    }
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) on_readable(w, i, now);
+}
+
+// ================= WORKER LOOP =================
+static void arm_timer(worker_t *w, uint64_t at_ns) {
+    struct itimerspec its = { { 0, 0 }, { (time_t)(at_ns / 1000000000ull), (long)(at_ns % 1000000000ull) } };
+    timerfd_settime(w->tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    const http_load_config_t *cfg = w->cfg;
+    uint64_t timeout_ns = (uint64_t)(cfg->timeout_s * 1e9);
+    uint64_t next_scan = 0, armed = 0;
+    struct epoll_event events[MAX_EVENTS];
+
+    for (unsigned i = 0; i < w->conn_count; i++) conn_open(w, i, now_ns());
+
+    while (1) {
+        uint64_t now = now_ns();
+
+        // Arrivals follow the schedule whatever the server does
+        while (w->next_arrival_ns <= now && w->next_arrival_ns < w->end_ns) {
+            int m = measured(w, w->next_arrival_ns);
+            if (m) w->res.scheduled++;
+            if (w->backlog_count == cfg->max_backlog) {
+                if (m) w->res.dropped++;
+            } else {
+                w->backlog[(w->backlog_head + w->backlog_count) % cfg->max_backlog] = w->next_arrival_ns;
+                w->backlog_count++;
+                if (w->backlog_count > w->res.max_backlog_seen) w->res.max_backlog_seen = w->backlog_count;
+            }
+            w->next_arrival_ns = next_arrival(w);
+        }
+
+        // Oldest arrival first, on any idle connection; nothing new once the
+        // drain deadline has passed
+        unsigned i;
+        while (w->backlog_count > 0 && now < w->end_ns + timeout_ns && pop_idle(w, &i) == 0) {
+            uint64_t intended = w->backlog[w->backlog_head];
+            w->backlog_head = (w->backlog_head + 1) % cfg->max_backlog;
+            w->backlog_count--;
+            start_request(w, i, intended, now);
+        }
+
+        uint64_t wake = w->next_arrival_ns < w->end_ns ? w->next_arrival_ns : now + TIMEOUT_SCAN_NS;
+        if (now >= next_scan) {
+            unsigned busy = 0;
+            for (unsigned c = 0; c < w->conn_count; c++) {
+                conn_t *conn = &w->conns[c];
+                if (conn->state == CONN_BUSY) {
+                    if (now - conn->sent_ns > timeout_ns) request_failed(w, c, 1, now);
+                    else busy++;
+                }
+                if (conn->state == CONN_CLOSED && conn->retry_at_ns <= now &&
+                    (now < w->end_ns || (w->backlog_count > 0 && now < w->end_ns + timeout_ns))) {
+                    conn_open(w, c, now);
+                }
+            }
+            next_scan = now + TIMEOUT_SCAN_NS;
+
+            // Done when the schedule is over and nothing is in flight; arrivals
+            // still queued timeout_s after the end are given up on
+            if (now >= w->end_ns && busy == 0 && (w->backlog_count == 0 || now >= w->end_ns + timeout_ns)) break;
+        }
+        if (next_scan < wake) wake = next_scan;
+        if (wake != armed) {
+            arm_timer(w, wake);
+            armed = wake;
+        }
+
+        int n = epoll_wait(w->epfd, events, MAX_EVENTS, -1);
+        now = now_ns();
+        for (int e = 0; e < n; e++) {
+            if (events[e].data.u64 == TIMER_TAG) {
+                uint64_t expirations;
+                if (read(w->tfd, &expirations, sizeof(expirations)) < 0) { /* spurious */ }
+                armed = 0;
+                continue;
+            }
+            on_event(w, (unsigned)events[e].data.u64, events[e].events, now);
+        }
+    }
+
+    // Arrivals still queued never got a connection
+    for (size_t b = 0; b < w->backlog_count; b++) {
+        if (measured(w, w->backlog[(w->backlog_head + b) % cfg->max_backlog])) w->res.timeouts++;
+    }
+    for (unsigned c = 0; c < w->conn_count; c++) {
+        if (w->conns[c].fd >= 0) close(w->conns[c].fd);
+    }
+    return NULL;
+}
+
+// ================= RUN =================
+static int result_init(http_load_result_t *r) {
+    memset(r, 0, sizeof(*r));
+    if (hdr_init(&r->corrected, 1, HTTP_LOAD_HIGHEST_US, HTTP_LOAD_DIGITS) != 0) return -1;
+    if (hdr_init(&r->service, 1, HTTP_LOAD_HIGHEST_US, HTTP_LOAD_DIGITS) != 0) {
+        hdr_free(&r->corrected);
+        return -1;
+    }
+    return 0;
+}
+
+void http_load_result_free(http_load_result_t *res) {
+    hdr_free(&res->corrected);
+    hdr_free(&res->service);
+}
+
+static void result_add(http_load_result_t *dst, const http_load_result_t *src) {
+    hdr_add(&dst->corrected, &src->corrected);
+    hdr_add(&dst->service, &src->service);
+    dst->scheduled += src->scheduled;
+    dst->sent += src->sent;
+    dst->completed += src->completed;
+    dst->status_2xx += src->status_2xx;
+    dst->status_3xx += src->status_3xx;
+    dst->status_4xx += src->status_4xx;
+    dst->status_5xx += src->status_5xx;
+    dst->status_429 += src->status_429;
+    dst->errors += src->errors;
+    dst->timeouts += src->timeouts;
+    dst->dropped += src->dropped;
+    dst->connects += src->connects;
+    dst->bytes_sent += src->bytes_sent;
+    dst->bytes_received += src->bytes_received;
+    if (src->max_backlog_seen > dst->max_backlog_seen) dst->max_backlog_seen = src->max_backlog_seen;
+}
+
+static void worker_free(worker_t *w) {
+    if (w->epfd >= 0) close(w->epfd);
+    if (w->tfd >= 0) close(w->tfd);
+    free(w->conns);
+    free(w->idle);
+    free(w->backlog);
+    arrival_free(&w->arrivals);
+    http_load_result_free(&w->res);
+}
+
+int http_load_run(const http_load_config_t *cfg, http_load_result_t *res) {
+    if (cfg->threads == 0 || cfg->threads > HTTP_LOAD_MAX_THREADS || cfg->connections < cfg->threads ||
+        (!cfg->arrivals && cfg->rate <= 0.0) || cfg->request_count == 0 || cfg->max_backlog == 0) {
+        return -1;
+    }
+
+    char port[8];
+    snprintf(port, sizeof(port), "%u", cfg->port);
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *ai;
+    if (getaddrinfo(cfg->host, port, &hints, &ai) != 0) return -1;
+
+    if (result_init(res) != 0) {
+        freeaddrinfo(ai);
+        return -1;
+    }
+
+    worker_t *workers = calloc(cfg->threads, sizeof(worker_t));
+    if (!workers) {
+        freeaddrinfo(ai);
+        return -1;
+    }
+
+    // Threads share one schedule start, each runs one shard of it
+    arrival_spec_t uniform;
+    const arrival_spec_t *spec = cfg->arrivals;
+    if (!spec) {
+        arrival_spec_defaults(&uniform);
+        uniform.fleet = cfg->rate * uniform.period_s;
+        spec = &uniform;
+    }
+    uint64_t start = now_ns() + START_DELAY_NS;
+    int rc = 0;
+    unsigned started = 0;
+    for (unsigned t = 0; t < cfg->threads; t++) {
+        worker_t *w = &workers[t];
+        w->cfg = cfg;
+        w->index = t;
+        w->addr = ai->ai_addr;
+        w->addrlen = ai->ai_addrlen;
+        w->conn_count = cfg->connections / cfg->threads + (t < cfg->connections % cfg->threads);
+        w->conns = calloc(w->conn_count, sizeof(conn_t));
+        w->idle = calloc(w->conn_count, sizeof(unsigned));
+        w->backlog = calloc(cfg->max_backlog, sizeof(uint64_t));
+        w->epfd = epoll_create1(EPOLL_CLOEXEC);
+        w->tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        w->start_ns = start;
+        w->measure_ns = start + (uint64_t)(cfg->warmup_s * 1e9);
+        w->end_ns = w->measure_ns + (uint64_t)(cfg->duration_s * 1e9);
+        int arrivals_ok = arrival_init(&w->arrivals, spec, t, cfg->threads) == 0;
+        if (arrivals_ok) w->next_arrival_ns = next_arrival(w);
+        w->next_request = cfg->request_count * t / cfg->threads;
+        for (unsigned c = 0; c < w->conn_count && w->conns; c++) w->conns[c].fd = -1;
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = TIMER_TAG };
+        if (!arrivals_ok || result_init(&w->res) != 0 || !w->conns || !w->idle || !w->backlog || w->epfd < 0 ||
+            w->tfd < 0 || epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->tfd, &ev) != 0 ||
+            pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            w->failed = 1;
+            rc = -1;
+            break;
+        }
+        started++;
+    }
+
+    for (unsigned t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+        result_add(res, &workers[t].res);
+    }
+    for (unsigned t = 0; t < cfg->threads; t++) {
+        if (t < started || workers[t].failed) worker_free(&workers[t]);
+    }
+    res->elapsed_s = cfg->duration_s;
+    free(workers);
+    freeaddrinfo(ai);
+    return rc;
+}
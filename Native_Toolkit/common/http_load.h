@@ -0,0 +1,99 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Open-loop HTTP/1.1 load engine (Linux, epoll).
+//
+// Requests are issued on a schedule that does not depend on responses:
+// each thread owns one shard of the arrival model (common/arrival.h), an
+// epoll set with its own keep-alive connections and a timerfd that fires
+// at the next intended send time. An arrival that finds no idle connection waits in a backlog,
+// so a slow server makes requests queue instead of silently lowering the
+// rate (coordinated omission). Latency is recorded twice:
+//   corrected    response time - intended send time (what a device sees)
+//   service      response time - actual write time (closed-loop view)
+// One request per connection at a time, no pipelining. Host only.
+
+#ifndef HTTP_LOAD_H
+#define HTTP_LOAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arrival.h"
+#include "hdr_histogram.h"
+
+#define HTTP_LOAD_MAX_THREADS 256
+#define HTTP_LOAD_HIGHEST_US 3600000000LL  // histogram range: 1 us .. 1 h
+#define HTTP_LOAD_DIGITS 3
+
+// Pre-rendered request (request line, headers and body)
+typedef struct {
+    uint8_t *data;
+    size_t len;
+} http_load_request_t;
+
+typedef struct {
+    const char *host;
+    uint16_t port;
+    double rate;                          // offered requests per second, all threads
+    const arrival_spec_t *arrivals;       // arrival model; NULL for evenly spaced at rate
+    double duration_s;                    // schedule length after warm-up
+    double warmup_s;                      // sent but not recorded
+    unsigned threads;
+    unsigned connections;                 // all threads
+    double timeout_s;                     // per request, from the write
+    size_t max_backlog;                   // per thread; arrivals beyond it are dropped
+    const http_load_request_t *requests;  // cycled, each thread from its own offset
+    size_t request_count;
+} http_load_config_t;
+
+typedef struct {
+    hdr_histogram_t corrected;            // microseconds
+    hdr_histogram_t service;
+    uint64_t scheduled;                   // arrivals in the measured window
+    uint64_t sent;
+    uint64_t completed;
+    uint64_t status_2xx;
+    uint64_t status_3xx;
+    uint64_t status_4xx;
+    uint64_t status_5xx;
+    uint64_t status_429;                  // also counted in status_4xx
+    uint64_t errors;                      // connect failures, resets, bad responses
+    uint64_t timeouts;
+    uint64_t dropped;                     // backlog overflow
+    uint64_t connects;
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    size_t max_backlog_seen;
+    double elapsed_s;                     // measured window
+} http_load_result_t;
+
+// Build "POST path HTTP/1.1" with the given body. extra_headers (may be
+// NULL) is inserted verbatim and must end with \r\n. Returns 0, -1 on
+// allocation failure.
+int http_load_render_post(http_load_request_t *req, const char *host, const char *path,
+                          const char *content_type, const char *extra_headers, const uint8_t *body, size_t len);
+void http_load_free_request(http_load_request_t *req);
+
+// Splits http://host[:port][/path] (port 80 and path / by default).
+// Returns 0, or -1 on a malformed URL or a component that does not fit.
+int http_load_parse_url(const char *url, char *host, size_t host_cap, uint16_t *port, char *path, size_t path_cap);
+
+// Blocking GET with Connection: close, for health and stats endpoints
+// between runs. Copies the body (chunked encoding not undone) into body.
+// Returns the HTTP status, or -1 on a connection error or timeout.
+int http_load_get(const char *host, uint16_t port, const char *path, double timeout_s, char *body, size_t cap);
+
+// Raise RLIMIT_NOFILE to the hard limit. Returns the new soft limit.
+long http_load_raise_fd_limit(void);
+
+// Runs the whole schedule and fills res (histograms initialized here,
+// release with http_load_result_free). Returns 0, or -1 on setup failure
+// (address resolution, threads, histograms).
+int http_load_run(const http_load_config_t *cfg, http_load_result_t *res);
+void http_load_result_free(http_load_result_t *res);
+
+#endif // HTTP_LOAD_H
@@ -0,0 +1,83 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Packet loss models for the host-side link emulators.
+//
+// Gilbert-Elliott two-state chain: frames are lost with loss_good in the
+// good state and loss_bad in the bad state. With mean_burst = 1 the model
+// degenerates to independent (Bernoulli) loss. Header-only, host only.
+
+#ifndef LINK_LOSS_H
+#define LINK_LOSS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    double p_good_to_bad;
+    double p_bad_to_good;
+    double loss_good;
+    double loss_bad;
+    bool bad;
+    uint64_t rng;
+} link_loss_t;
+
+static inline uint64_t link_loss_next(link_loss_t *l) {
+    // xorshift64*
+    l->rng ^= l->rng >> 12;
+    l->rng ^= l->rng << 25;
+    l->rng ^= l->rng >> 27;
+    return l->rng * 0x2545F4914F6CDD1Dull;
+}
+
+static inline double link_loss_uniform(link_loss_t *l) {
+    return (double)(link_loss_next(l) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline void link_loss_seed(link_loss_t *l, uint64_t seed) {
+    l->rng = seed * 0x9E3779B97F4A7C15ull + 0xD1B54A32D192ED03ull;
+    if (l->rng == 0) l->rng = 1;
+}
+
+// Independent loss with probability p
+static inline void link_loss_init_bernoulli(link_loss_t *l, double p, uint64_t seed) {
+    l->p_good_to_bad = 0.0;
+    l->p_bad_to_good = 1.0;
+    l->loss_good = p;
+    l->loss_bad = 1.0;
+    l->bad = false;
+    link_loss_seed(l, seed);
+}
+
+// Bursty loss with long-run rate mean_loss and average burst length
+// mean_burst frames (every frame in the bad state is lost)
+static inline void link_loss_init_gilbert(link_loss_t *l, double mean_loss, double mean_burst,
+                                          uint64_t seed) {
+    if (mean_burst <= 1.0 || mean_loss <= 0.0 || mean_loss >= 1.0) {
+        link_loss_init_bernoulli(l, mean_loss, seed);
+        return;
+    }
+    l->p_bad_to_good = 1.0 / mean_burst;
+    l->p_good_to_bad = l->p_bad_to_good * mean_loss / (1.0 - mean_loss);
+    if (l->p_good_to_bad > 1.0) l->p_good_to_bad = 1.0;
+    l->loss_good = 0.0;
+    l->loss_bad = 1.0;
+    l->bad = false;
+    link_loss_seed(l, seed);
+}
+
+// Advance the chain by one frame; true if the frame is dropped
+static inline bool link_loss_drop(link_loss_t *l) {
+    double u = link_loss_uniform(l);
+    if (l->bad) {
+        if (u < l->p_bad_to_good) l->bad = false;
+    } else if (u < l->p_good_to_bad) {
+        l->bad = true;
+    }
+    return link_loss_uniform(l) < (l->bad ? l->loss_bad : l->loss_good);
+}
+
+#endif // LINK_LOSS_H
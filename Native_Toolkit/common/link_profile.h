@@ -0,0 +1,77 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Nominal uplink profiles shared by the host tools (fec_bench, fom_report,
+// link_emu, energy_report).
+//
+// Figures are for comparison between codecs and strategies, not datasheet
+// values; the tools override them on the command line. The Astrocast
+// contact schedule is compressed (a 2-minute pass every 10 minutes) so a
+// lab run sees several passes. LoRa rates are the EU868 125 kHz data rates
+// (SF7-SF12) with their payload limits. wake_mj and tail_ms are the fixed
+// radio costs of one uplink: modem wake-up and attach/RRC set-up or Wi-Fi
+// wake, and the time the radio keeps listening after the last frame
+// (NB-IoT inactivity timer with release assistance). Header-only, host
+// only.
+
+#ifndef LINK_PROFILE_H
+#define LINK_PROFILE_H
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    double bitrate_bps;                   // uplink PHY rate
+    double tx_mw;                         // radio power while transmitting
+    double rx_mw;                         // radio power while listening for ACK/NACK
+    double frame_overhead_bytes;          // preamble, sync, MAC/IP headers
+    double ack_window_ms;                 // listen time per ACK/NACK
+    double cpu_nj_per_byte;               // parity mul-add cost on the MCU (scalar)
+    double mtu_bytes;                     // largest payload in one frame
+    double frame_loss;                    // independent per-frame loss
+    double latency_ms;                    // one-way delay after the frame is on air
+    double jitter_ms;                     // spread of that delay
+    double contact_period_s;              // transmit windows every period, 0 = always
+    double contact_window_s;              // length of each window
+    double wake_mj;                       // fixed energy to bring the link up per uplink
+    double tail_ms;                       // listening at rx_mw after the last frame
+} link_profile_t;
+
+static const link_profile_t LINK_PROFILES[] = {
+    { "astrocast", 1200.0, 800.0, 60.0, 20.0, 5000.0, 4.2, 160.0, 0.05, 60.0, 20.0, 600.0, 120.0, 20.0, 0.0 },
+    { "lora-sf7", 5470.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 222.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "lora-sf8", 3125.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 222.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "lora-sf9", 1760.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 115.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "lora-sf10", 980.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 51.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "lora-sf11", 440.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 51.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "lora-sf12", 250.0, 420.0, 40.0, 13.0, 2000.0, 4.2, 51.0, 0.10, 30.0, 10.0, 0.0, 0.0, 2.0, 0.0 },
+    { "nbiot", 25000.0, 700.0, 150.0, 40.0, 1500.0, 4.2, 1358.0, 0.01, 300.0, 150.0, 0.0, 0.0, 250.0, 2000.0 },
+    { "wifi-udp", 6000000.0, 600.0, 350.0, 60.0, 20.0, 4.2, 1472.0, 0.001, 2.0, 1.0, 0.0, 0.0, 120.0, 100.0 },
+};
+
+#define LINK_PROFILE_COUNT (sizeof(LINK_PROFILES) / sizeof(LINK_PROFILES[0]))
+
+// NULL if the name is unknown
+static inline const link_profile_t *link_profile_find(const char *name) {
+    for (size_t i = 0; i < LINK_PROFILE_COUNT; i++) {
+        if (!strcmp(LINK_PROFILES[i].name, name)) return &LINK_PROFILES[i];
+    }
+    return NULL;
+}
+
+// Frames needed for a payload; a payload is split at the MTU
+static inline double link_profile_frames(const link_profile_t *l, double payload_bytes) {
+    return payload_bytes <= l->mtu_bytes ? 1.0 : ceil(payload_bytes / l->mtu_bytes);
+}
+
+// Time on air for a payload, every frame carrying the overhead
+static inline double link_profile_airtime_s(const link_profile_t *l, double payload_bytes) {
+    return (payload_bytes + link_profile_frames(l, payload_bytes) * l->frame_overhead_bytes) * 8.0 / l->bitrate_bps;
+}
+
+#endif // LINK_PROFILE_H
@@ -0,0 +1,164 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "link_shaper.h"
+
+#include <math.h>
+#include <string.h>
+
+#define PARETO_SHAPE 2.5
+#define MAX_RETRANSMITS 16
+
+static const char *DELAY_NAMES[] = { "const", "uniform", "normal", "pareto" };
+
+void link_shaper_config_defaults(link_shaper_config_t *cfg, const link_profile_t *profile) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->profile = *profile;
+    cfg->delay = LINK_DELAY_NORMAL;
+    cfg->mean_burst = 1.0;
+    cfg->queue_bytes = 256 * 1024;
+}
+
+int link_shaper_delay_parse(const char *name, link_delay_dist_t *out) {
+    for (int d = 0; d < (int)(sizeof(DELAY_NAMES) / sizeof(DELAY_NAMES[0])); d++) {
+        if (!strcmp(name, DELAY_NAMES[d])) {
+            *out = (link_delay_dist_t)d;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *link_shaper_delay_name(link_delay_dist_t d) {
+    return DELAY_NAMES[d];
+}
+
+void link_shaper_init(link_shaper_t *s, const link_shaper_config_t *cfg, uint64_t seed) {
+    memset(s, 0, sizeof(*s));
+    s->cfg = *cfg;
+    link_loss_init_gilbert(&s->loss, cfg->profile.frame_loss, cfg->mean_burst, seed);
+    s->rng = seed * 0xD6E8FEB86659FD93ull + 1;
+}
+
+// ================= SAMPLING =================
+static double uniform01(link_shaper_t *s) {
+    s->rng ^= s->rng >> 12;
+    s->rng ^= s->rng << 25;
+    s->rng ^= s->rng >> 27;
+    return ((s->rng * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double sample_delay_s(link_shaper_t *s) {
+    const link_profile_t *p = &s->cfg.profile;
+    double ms = p->latency_ms;
+    switch (s->cfg.delay) {
+    case LINK_DELAY_CONST:
+        break;
+    case LINK_DELAY_UNIFORM:
+        ms += (2.0 * uniform01(s) - 1.0) * p->jitter_ms;
+        break;
+    case LINK_DELAY_NORMAL: {
+        double u1 = uniform01(s), u2 = uniform01(s);
+        ms += p->jitter_ms * sqrt(-2.0 * log(u1 > 0.0 ? u1 : 1e-300)) * cos(2.0 * M_PI * u2);
+        break;
+    }
+    case LINK_DELAY_PARETO: {
+        // Scale chosen so the tail adds jitter_ms on average
+        double xm = p->jitter_ms * (PARETO_SHAPE - 1.0) / PARETO_SHAPE;
+        ms += xm / pow(1.0 - uniform01(s), 1.0 / PARETO_SHAPE);
+        break;
+    }
+    }
+    return ms > 0.0 ? ms / 1000.0 : 0.0;
+}
+
+// ================= SERIALIZER =================
+bool link_shaper_contact(const link_shaper_t *s, double now, double *next_change) {
+    const link_profile_t *p = &s->cfg.profile;
+    if (p->contact_period_s <= 0.0 || p->contact_window_s >= p->contact_period_s) {
+        if (next_change) *next_change = INFINITY;
+        return true;
+    }
+    double pos = fmod(now - s->cfg.contact_offset_s, p->contact_period_s);
+    if (pos < 0.0) pos += p->contact_period_s;
+    bool open = pos < p->contact_window_s;
+    if (next_change) *next_change = now - pos + (open ? p->contact_window_s : p->contact_period_s);
+    return open;
+}
+
+// Earliest start at or after t at which airtime fits in a window. A frame
+// longer than a whole window starts at a window opening.
+static double contact_start(const link_shaper_t *s, double t, double airtime) {
+    const link_profile_t *p = &s->cfg.profile;
+    if (p->contact_period_s <= 0.0 || p->contact_window_s >= p->contact_period_s) return t;
+    double pos = fmod(t - s->cfg.contact_offset_s, p->contact_period_s);
+    if (pos < 0.0) pos += p->contact_period_s;
+    if (pos + airtime <= p->contact_window_s || pos == 0.0) return t;
+    return t - pos + p->contact_period_s;
+}
+
+// Puts one frame on air; returns the time its last bit leaves
+static double transmit(link_shaper_t *s, double now, double payload_bytes) {
+    const link_profile_t *p = &s->cfg.profile;
+    double airtime = (payload_bytes + p->frame_overhead_bytes) * 8.0 / p->bitrate_bps;
+    double start = contact_start(s, now > s->free_at ? now : s->free_at, airtime);
+    s->free_at = start + airtime;
+    s->stats.frames++;
+    return s->free_at;
+}
+
+double link_shaper_backlog(const link_shaper_t *s, double now) {
+    return s->free_at > now ? (s->free_at - now) * s->cfg.profile.bitrate_bps / 8.0 : 0.0;
+}
+
+double link_shaper_datagram(link_shaper_t *s, double now, size_t len) {
+    const link_profile_t *p = &s->cfg.profile;
+    s->stats.packets++;
+    s->stats.bytes += len;
+    if (s->cfg.drop_oversize && len > p->mtu_bytes) {
+        s->stats.oversize_drops++;
+        return -1.0;
+    }
+    if (link_shaper_backlog(s, now) + len > s->cfg.queue_bytes) {
+        s->stats.queue_drops++;
+        return -1.0;
+    }
+    double frames = link_profile_frames(p, (double)len), remaining = (double)len, end = now;
+    bool lost = false;
+    for (double f = 0; f < frames; f++) {
+        double part = remaining < p->mtu_bytes ? remaining : p->mtu_bytes;
+        end = transmit(s, now, part);
+        remaining -= part;
+        lost |= link_loss_drop(&s->loss);
+    }
+    if (lost) {
+        s->stats.lost++;
+        return -1.0;
+    }
+    s->stats.delivered++;
+    return end + sample_delay_s(s);
+}
+
+double link_shaper_segment(link_shaper_t *s, double now, size_t len, double *stream_last) {
+    const link_profile_t *p = &s->cfg.profile;
+    double rto = s->cfg.rto_ms > 0.0 ? s->cfg.rto_ms / 1000.0 : fmax(0.2, 3.0 * (p->latency_ms + p->jitter_ms) / 1000.0);
+    s->stats.packets++;
+    s->stats.bytes += len;
+    // The copy is charged to the link right away, so a retransmission does
+    // not hold up other streams for the RTO; the segment itself is late by
+    // one RTO per loss
+    double end = transmit(s, now, (double)len), penalty = 0.0;
+    for (int tries = 0; tries < MAX_RETRANSMITS && link_loss_drop(&s->loss); tries++) {
+        s->stats.retransmits++;
+        end = transmit(s, end, (double)len);
+        penalty += rto;
+    }
+    s->stats.delivered++;
+    double due = end + penalty + sample_delay_s(s);
+    if (due < *stream_last) due = *stream_last;
+    *stream_last = due;
+    return due;
+}
@@ -0,0 +1,82 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Timing model of one direction of an emulated link (tools/link_emu).
+//
+// Packets are serialized one after another at the profile's bit rate,
+// each frame carrying the profile's overhead, and only inside the contact
+// windows. They then take a sampled one-way delay. Frames are lost by a
+// Gilbert-Elliott chain (common/link_loss.h).
+//   datagrams  are split at the MTU (or dropped when larger, drop_oversize);
+//              one lost frame loses the datagram; jitter may reorder them
+//   segments   are never lost: a lost frame is sent again after the RTO,
+//              and delivery waits for earlier segments of the same stream,
+//              as TCP would
+// The shaper only computes times; the caller holds the bytes. Times are
+// seconds on any monotonic clock. Host only.
+
+#ifndef LINK_SHAPER_H
+#define LINK_SHAPER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "link_loss.h"
+#include "link_profile.h"
+
+typedef enum {
+    LINK_DELAY_CONST = 0,
+    LINK_DELAY_UNIFORM,                   // latency +- jitter
+    LINK_DELAY_NORMAL,                    // sd = jitter, clamped at 0
+    LINK_DELAY_PARETO,                    // latency + Pareto tail with mean jitter
+} link_delay_dist_t;
+
+typedef struct {
+    link_profile_t profile;
+    link_delay_dist_t delay;
+    double mean_burst;                    // loss burst length, 1 = independent
+    double queue_bytes;                   // waiting to be serialized before tail drop
+    double rto_ms;                        // segment retransmission timeout, 0 = auto
+    double contact_offset_s;              // first window opens at this time
+    bool drop_oversize;                   // datagrams above the MTU are dropped
+} link_shaper_config_t;
+
+typedef struct {
+    uint64_t packets, bytes;              // offered
+    uint64_t delivered, lost, queue_drops, oversize_drops;
+    uint64_t frames, retransmits;
+} link_shaper_stats_t;
+
+typedef struct {
+    link_shaper_config_t cfg;
+    link_loss_t loss;
+    uint64_t rng;
+    double free_at;                       // serializer busy until
+    link_shaper_stats_t stats;
+} link_shaper_t;
+
+void link_shaper_config_defaults(link_shaper_config_t *cfg, const link_profile_t *profile);
+int link_shaper_delay_parse(const char *name, link_delay_dist_t *out);
+const char *link_shaper_delay_name(link_delay_dist_t d);
+
+void link_shaper_init(link_shaper_t *s, const link_shaper_config_t *cfg, uint64_t seed);
+
+// Delivery time of a datagram of len bytes offered at now, or -1 if it is
+// lost or dropped
+double link_shaper_datagram(link_shaper_t *s, double now, size_t len);
+
+// Delivery time of a stream segment (len <= MTU) offered at now; stream_last
+// holds the stream's previous delivery time (0 for a new stream)
+double link_shaper_segment(link_shaper_t *s, double now, size_t len, double *stream_last);
+
+// Bytes waiting to be serialized at now
+double link_shaper_backlog(const link_shaper_t *s, double now);
+
+// Whether a contact window is open at now, and when the state next changes
+bool link_shaper_contact(const link_shaper_t *s, double now, double *next_change);
+
+#endif // LINK_SHAPER_H
@@ -0,0 +1,204 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "metrics.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE 64
+#define EXPORT_MIN_POW 10                 // first le: 2^10 ns
+#define EXPORT_MAX_POW 36                 // last le: 1.5 x 2^36 ns
+
+typedef struct {
+    metrics_type_t type;
+    char *name, *labels, *help;
+} series_t;
+
+struct metrics_registry {
+    series_t series[METRICS_MAX_SERIES];
+    size_t offset[METRICS_MAX_SERIES];
+    int count;
+    size_t cells;
+    metrics_block_t *blocks[METRICS_MAX_BLOCKS];
+    int block_count;
+    uint64_t scratch[METRICS_BUCKETS];    // summed histogram, under the lock
+    pthread_mutex_t lock;                 // series and block lists, not the cells
+};
+
+// ================= REGISTRY =================
+metrics_registry_t *metrics_create(void) {
+    metrics_registry_t *r = calloc(1, sizeof(*r));
+    if (r) pthread_mutex_init(&r->lock, NULL);
+    return r;
+}
+
+void metrics_destroy(metrics_registry_t *r) {
+    if (!r) return;
+    for (int i = 0; i < r->count; i++) {
+        free(r->series[i].name);
+        free(r->series[i].labels);
+        free(r->series[i].help);
+    }
+    for (int i = 0; i < r->block_count; i++) {
+        free(r->blocks[i]->cells);
+        free(r->blocks[i]);
+    }
+    pthread_mutex_destroy(&r->lock);
+    free(r);
+}
+
+static size_t series_cells(metrics_type_t type) {
+    return type == METRICS_HISTOGRAM ? METRICS_BUCKETS + 1 : 1;
+}
+
+int metrics_series(metrics_registry_t *r, metrics_type_t type, const char *name, const char *labels,
+                   const char *help) {
+    pthread_mutex_lock(&r->lock);
+    int id = -1;
+    if (r->count < METRICS_MAX_SERIES && r->block_count == 0) {
+        series_t *s = &r->series[r->count];
+        s->type = type;
+        s->name = strdup(name);
+        s->labels = strdup(labels ? labels : "");
+        s->help = strdup(help ? help : "");
+        if (s->name && s->labels && s->help) {
+            r->offset[r->count] = r->cells;
+            r->cells += series_cells(type);
+            id = r->count++;
+        } else {
+            free(s->name);
+            free(s->labels);
+            free(s->help);
+        }
+    }
+    pthread_mutex_unlock(&r->lock);
+    return id;
+}
+
+metrics_block_t *metrics_block(metrics_registry_t *r) {
+    pthread_mutex_lock(&r->lock);
+    metrics_block_t *b = NULL;
+    if (r->block_count < METRICS_MAX_BLOCKS && (b = malloc(sizeof(*b)))) {
+        // Whole cache lines, so no two writers share one
+        size_t bytes = (r->cells * sizeof(uint64_t) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+        b->cells = aligned_alloc(CACHE_LINE, bytes ? bytes : CACHE_LINE);
+        b->offset = r->offset;
+        if (b->cells) {
+            memset(b->cells, 0, bytes);
+            r->blocks[r->block_count++] = b;
+        } else {
+            free(b);
+            b = NULL;
+        }
+    }
+    pthread_mutex_unlock(&r->lock);
+    return b;
+}
+
+// ================= READERS =================
+// Caller holds the lock
+static uint64_t sum_cell(const metrics_registry_t *r, size_t cell) {
+    uint64_t v = 0;
+    for (int i = 0; i < r->block_count; i++)
+        v += atomic_load_explicit(&r->blocks[i]->cells[cell], memory_order_relaxed);
+    return v;
+}
+
+static uint64_t sum_histogram(metrics_registry_t *r, int id) {
+    uint64_t *counts = r->scratch, total = 0;
+    for (unsigned k = 0; k < METRICS_BUCKETS; k++) {
+        counts[k] = sum_cell(r, r->offset[id] + k);
+        total += counts[k];
+    }
+    return total;
+}
+
+// Exclusive upper edge of bucket i, in ns
+static uint64_t bucket_upper(unsigned i) {
+    if (i < (1u << METRICS_SUB_BITS)) return i + 1;
+    unsigned p = (i >> METRICS_SUB_BITS) + METRICS_SUB_BITS - 1, sub = i & ((1u << METRICS_SUB_BITS) - 1);
+    return (uint64_t)((1u << METRICS_SUB_BITS) + sub + 1) << (p - METRICS_SUB_BITS);
+}
+
+uint64_t metrics_percentile(metrics_registry_t *r, int id, double percentile) {
+    uint64_t result = 0;
+    pthread_mutex_lock(&r->lock);
+    uint64_t total = id >= 0 && id < r->count ? sum_histogram(r, id) : 0;
+    if (total) {
+        uint64_t target = (uint64_t)(percentile / 100.0 * (double)total + 0.5), seen = 0;
+        if (target < 1) target = 1;
+        if (target > total) target = total;
+        for (unsigned k = 0; k < METRICS_BUCKETS; k++) {
+            seen += r->scratch[k];
+            if (seen >= target) {
+                result = bucket_upper(k);
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&r->lock);
+    return result;
+}
+
+static void write_labels(FILE *out, const char *labels, const char *extra) {
+    if (!labels[0] && !extra) return;
+    fprintf(out, "{%s%s%s}", labels, labels[0] && extra ? "," : "", extra ? extra : "");
+}
+
+static void write_histogram(metrics_registry_t *r, int id, FILE *out) {
+    const series_t *s = &r->series[id];
+    uint64_t total = sum_histogram(r, id);
+    if (!total) return;
+    uint64_t below = 0;
+    unsigned k = 0;
+    char le[48];
+    // Edges 2^p and 1.5 x 2^p: the first and the middle bucket of each power
+    for (unsigned p = EXPORT_MIN_POW; p <= EXPORT_MAX_POW; p++) {
+        for (unsigned half = 0; half < 2; half++) {
+            unsigned edge = ((p - METRICS_SUB_BITS + 1) << METRICS_SUB_BITS) | (half << (METRICS_SUB_BITS - 1));
+            while (k < edge) below += r->scratch[k++];
+            uint64_t ns = (uint64_t)((1u << METRICS_SUB_BITS) | (half << (METRICS_SUB_BITS - 1)))
+                          << (p - METRICS_SUB_BITS);
+            snprintf(le, sizeof(le), "le=\"%.9g\"", (double)ns * 1e-9);
+            fprintf(out, "%s_bucket", s->name);
+            write_labels(out, s->labels, le);
+            fprintf(out, " %llu\n", (unsigned long long)below);
+        }
+    }
+    fprintf(out, "%s_bucket", s->name);
+    write_labels(out, s->labels, "le=\"+Inf\"");
+    fprintf(out, " %llu\n%s_sum", (unsigned long long)total, s->name);
+    write_labels(out, s->labels, NULL);
+    fprintf(out, " %.9g\n%s_count", (double)sum_cell(r, r->offset[id] + METRICS_BUCKETS) * 1e-9, s->name);
+    write_labels(out, s->labels, NULL);
+    fprintf(out, " %llu\n", (unsigned long long)total);
+}
+
+void metrics_write_prometheus(metrics_registry_t *r, FILE *out) {
+    static const char *type_name[] = { "counter", "gauge", "histogram" };
+    bool done[METRICS_MAX_SERIES] = { false };
+    pthread_mutex_lock(&r->lock);
+    for (int i = 0; i < r->count; i++) {
+        if (done[i]) continue;
+        const series_t *s = &r->series[i];
+        fprintf(out, "# HELP %s %s\n# TYPE %s %s\n", s->name, s->help, s->name, type_name[s->type]);
+        for (int j = i; j < r->count; j++) {
+            if (done[j] || strcmp(r->series[j].name, s->name)) continue;
+            done[j] = true;
+            if (r->series[j].type == METRICS_HISTOGRAM) {
+                write_histogram(r, j, out);
+                continue;
+            }
+            fputs(s->name, out);
+            write_labels(out, r->series[j].labels, NULL);
+            fprintf(out, " %llu\n", (unsigned long long)sum_cell(r, r->offset[j]));
+        }
+    }
+    pthread_mutex_unlock(&r->lock);
+}
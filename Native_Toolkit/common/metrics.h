@@ -0,0 +1,108 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Per-thread counters and latency histograms, exported in the Prometheus
+// text format.
+//
+// The series (name, labels, help) are declared in a registry first; every
+// writer thread then takes its own block of cells. A thread only updates
+// its own block, with a relaxed load and store (no locked instruction, no
+// cache line shared with another writer), and the exporter sums the
+// blocks with relaxed loads, so a scrape never stalls a writer and a
+// writer never waits for anything.
+//
+// Histograms are log-linear over nanoseconds: every power of two is split
+// into 8 linear buckets, so a bucket is at most 12.5 % wide, from 1 ns to
+// 2^40 ns (18 minutes; longer values land in the last bucket). Recording
+// is a clz, a shift and two adds. The export keeps two buckets per power
+// of two, le in seconds from 2^10 ns (1 us) to 2^36 ns (69 s), all of them
+// exact bucket edges. Host only.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define METRICS_SUB_BITS 3                // 8 buckets per power of two
+#define METRICS_MAX_POW 39                // last full power of two
+#define METRICS_BUCKETS ((METRICS_MAX_POW - METRICS_SUB_BITS + 2) << METRICS_SUB_BITS)
+#define METRICS_MAX_SERIES 256
+#define METRICS_MAX_BLOCKS 256
+
+typedef enum {
+    METRICS_COUNTER,
+    METRICS_GAUGE,                        // last value set; summed over blocks
+    METRICS_HISTOGRAM,                    // METRICS_BUCKETS cells, then the sum in ns
+} metrics_type_t;
+
+typedef struct metrics_registry metrics_registry_t;
+
+// One writer thread's cells; offset maps a series id to its first cell
+typedef struct {
+    _Atomic uint64_t *cells;
+    const size_t *offset;
+} metrics_block_t;
+
+metrics_registry_t *metrics_create(void);
+void metrics_destroy(metrics_registry_t *r);
+
+// Declares a series and returns its id, or -1 when the registry is full or
+// already has blocks. labels is the inside of the braces (`stage="decode"`)
+// or NULL; series of one name must share type and help.
+int metrics_series(metrics_registry_t *r, metrics_type_t type, const char *name, const char *labels,
+                   const char *help);
+
+// A zeroed block for one writer thread; no series can be added afterwards.
+// Thread safe; NULL when out of memory or blocks.
+metrics_block_t *metrics_block(metrics_registry_t *r);
+
+// Every series with at least one sample (counters and gauges always),
+// grouped by name with one HELP and TYPE line each. Safe while writers run.
+void metrics_write_prometheus(metrics_registry_t *r, FILE *out);
+
+// Percentile in [0, 100] of a histogram over all blocks, in ns (upper edge
+// of the bucket); 0 when empty
+uint64_t metrics_percentile(metrics_registry_t *r, int id, double percentile);
+
+// ================= WRITERS =================
+static inline uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline unsigned metrics_bucket(uint64_t v) {
+    if (v < (1u << METRICS_SUB_BITS)) return (unsigned)v;
+    int p = 63 - __builtin_clzll(v);
+    if (p > METRICS_MAX_POW) return METRICS_BUCKETS - 1;
+    return (unsigned)((p - METRICS_SUB_BITS + 1) << METRICS_SUB_BITS) |
+           (unsigned)((v >> (p - METRICS_SUB_BITS)) & ((1u << METRICS_SUB_BITS) - 1));
+}
+
+// Single writer per cell: a plain add, published with a relaxed store
+static inline void metrics_cell_add(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline void metrics_add(metrics_block_t *b, int id, uint64_t n) {
+    metrics_cell_add(&b->cells[b->offset[id]], n);
+}
+
+static inline void metrics_set(metrics_block_t *b, int id, uint64_t v) {
+    atomic_store_explicit(&b->cells[b->offset[id]], v, memory_order_relaxed);
+}
+
+static inline void metrics_observe(metrics_block_t *b, int id, uint64_t ns) {
+    _Atomic uint64_t *h = &b->cells[b->offset[id]];
+    metrics_cell_add(&h[metrics_bucket(ns)], 1);
+    metrics_cell_add(&h[METRICS_BUCKETS], ns);
+}
+
+#endif // METRICS_H
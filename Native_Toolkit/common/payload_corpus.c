@@ -0,0 +1,148 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "payload_corpus.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static uint32_t get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+    return (uint64_t)get_u32(p) | (uint64_t)get_u32(p + 4) << 32;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+// ================= READER =================
+static int corpus_invalid(payload_corpus_t *c) {
+    payload_corpus_close(c);
+    errno = EINVAL;
+    return -1;
+}
+
+int payload_corpus_open(payload_corpus_t *c, const char *path) {
+    memset(c, 0, sizeof(*c));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < PAYLOAD_CORPUS_HEADER_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    c->map = map;
+    c->map_len = (size_t)st.st_size;
+
+    const uint8_t *h = c->map;
+    if (memcmp(h, PAYLOAD_CORPUS_MAGIC, 8) != 0 || get_u32(h + 8) != PAYLOAD_CORPUS_VERSION) {
+        return corpus_invalid(c);
+    }
+    c->count = get_u32(h + 12);
+    memcpy(c->codec, h + 16, PAYLOAD_CORPUS_CODEC_MAX);
+    c->codec[PAYLOAD_CORPUS_CODEC_MAX] = '\0';
+    c->seed = get_u64(h + 32);
+    c->time_base = (int64_t)get_u64(h + 40);
+    c->max_payload = get_u32(h + 52);
+    c->payload_bytes = get_u64(h + 56);
+
+    uint64_t index_len = (uint64_t)c->count * 8;
+    if (c->count == 0 || PAYLOAD_CORPUS_HEADER_SIZE + index_len + c->payload_bytes != c->map_len) {
+        return corpus_invalid(c);
+    }
+    c->index = h + PAYLOAD_CORPUS_HEADER_SIZE;
+    c->data = c->index + index_len;
+    if ((uint32_t)crc32(0L, c->index, (uInt)(c->map_len - PAYLOAD_CORPUS_HEADER_SIZE)) != get_u32(h + 48)) {
+        return corpus_invalid(c);
+    }
+    for (uint32_t i = 0; i < c->count; i++) {
+        uint64_t off = get_u32(c->index + 8 * (size_t)i), len = get_u32(c->index + 8 * (size_t)i + 4);
+        if (off + len > c->payload_bytes || len > c->max_payload) return corpus_invalid(c);
+    }
+    return 0;
+}
+
+void payload_corpus_close(payload_corpus_t *c) {
+    if (c->map) munmap((void *)c->map, c->map_len);
+    c->map = NULL;
+}
+
+const uint8_t *payload_corpus_get(const payload_corpus_t *c, uint32_t i, uint32_t *len) {
+    const uint8_t *e = c->index + 8 * (size_t)i;
+    *len = get_u32(e + 4);
+    return c->data + get_u32(e);
+}
+
+// ================= WRITER =================
+int payload_corpus_write(const char *path, const char *codec, uint64_t seed, int64_t time_base,
+                         const uint8_t *data, const uint32_t *lens, uint32_t count) {
+    uint8_t header[PAYLOAD_CORPUS_HEADER_SIZE] = { 0 };
+    uint8_t *index = malloc((size_t)count * 8);
+    if (!index) return -1;
+    uint64_t total = 0;
+    uint32_t max_len = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        put_u32(index + 8 * (size_t)i, (uint32_t)total);
+        put_u32(index + 8 * (size_t)i + 4, lens[i]);
+        total += lens[i];
+        if (lens[i] > max_len) max_len = lens[i];
+    }
+    if (total > UINT32_MAX) {
+        free(index);
+        return -1;
+    }
+
+    uLong crc = crc32(0L, index, (uInt)count * 8);
+    crc = crc32(crc, data, (uInt)total);
+    memcpy(header, PAYLOAD_CORPUS_MAGIC, 8);
+    put_u32(header + 8, PAYLOAD_CORPUS_VERSION);
+    put_u32(header + 12, count);
+    strncpy((char *)header + 16, codec, PAYLOAD_CORPUS_CODEC_MAX);
+    put_u64(header + 32, seed);
+    put_u64(header + 40, (uint64_t)time_base);
+    put_u32(header + 48, (uint32_t)crc);
+    put_u32(header + 52, max_len);
+    put_u64(header + 56, total);
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    int ok = f && fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+             fwrite(index, 1, (size_t)count * 8, f) == (size_t)count * 8 && fwrite(data, 1, total, f) == total;
+    if (f && fclose(f) != 0) ok = 0;
+    free(index);
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
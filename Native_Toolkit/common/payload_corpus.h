@@ -0,0 +1,68 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Pre-encoded payload corpus: one codec's payloads in one indexed file.
+//
+// Built once by tools/corpus_build, then mapped read-only (MAP_SHARED) by
+// every load worker, so the page cache holds a single copy however many
+// processes use it and startup costs one mmap instead of re-encoding the
+// pool. The file records the generator seed and time base, so a corpus
+// rebuilt with the same arguments is byte-identical.
+//
+// Layout, little-endian:
+//   0   magic "IPCORP1\0"
+//   8   u32 version (1)
+//   12  u32 record count n
+//   16  char codec[16] (NUL padded, container_codec_name())
+//   32  u64 generator seed
+//   40  i64 generator time base (unix seconds)
+//   48  u32 CRC-32 of everything after the header
+//   52  u32 largest payload
+//   56  u64 payload bytes
+//   64  n x { u32 offset, u32 length }, offsets from the payload area
+//   64 + 8n  payloads, back to back
+// The Python reader in the locust senders (PayloadCorpus) follows this
+// layout. Host only.
+
+#ifndef PAYLOAD_CORPUS_H
+#define PAYLOAD_CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PAYLOAD_CORPUS_MAGIC "IPCORP1"
+#define PAYLOAD_CORPUS_VERSION 1
+#define PAYLOAD_CORPUS_HEADER_SIZE 64
+#define PAYLOAD_CORPUS_CODEC_MAX 16
+
+typedef struct {
+    const uint8_t *map;
+    size_t map_len;
+    uint32_t count;
+    char codec[PAYLOAD_CORPUS_CODEC_MAX + 1];
+    uint64_t seed;
+    int64_t time_base;
+    uint32_t max_payload;
+    uint64_t payload_bytes;
+    const uint8_t *index;
+    const uint8_t *data;
+} payload_corpus_t;
+
+// Maps and validates the file (header, index bounds, CRC). Returns 0, or
+// -1 with errno set by the failing call, or EINVAL for a bad file.
+int payload_corpus_open(payload_corpus_t *c, const char *path);
+void payload_corpus_close(payload_corpus_t *c);
+
+// Payload i (< count), pointing into the mapping
+const uint8_t *payload_corpus_get(const payload_corpus_t *c, uint32_t i, uint32_t *len);
+
+// Writes a corpus from count payloads stored back to back in data, with
+// lengths in lens. Writes to path.tmp and renames, so readers never map a
+// partial file. Returns 0, -1 on I/O error.
+int payload_corpus_write(const char *path, const char *codec, uint64_t seed, int64_t time_base,
+                         const uint8_t *data, const uint32_t *lens, uint32_t count);
+
+#endif // PAYLOAD_CORPUS_H
@@ -0,0 +1,918 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "shard_pipeline.h"
+
+#include <netdb.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "deflate_session.h"
+#include "spsc_ring.h"
+
+#define SHARD_BATCH 64                    // items taken from one ring before moving on
+#define SHARD_SPIN 2000                   // empty polls before sleeping
+#define SHARD_SLEEP_MS 100                // upper bound, so stop is seen without a wake-up
+#define STORE_BUFFER (64 * 1024)
+#define CODEC_LABELS (CONTAINER_CODEC_COUNT + 1)   // codecs and session
+#define DEVICE_RECENT 8                   // duplicate keys a device carries to another node
+
+enum { OP_RECORD, OP_EXPORT, OP_IMPORT };
+
+// Duplicate keys a device added last, kept in cluster mode only: the
+// filter holds fingerprints, which cannot be picked out by partition
+typedef struct {
+    uint64_t key[DEVICE_RECENT];
+    double at[DEVICE_RECENT];
+    unsigned next;
+} device_recent_t;
+
+typedef struct {
+    uint64_t key;                         // 0 = empty slot
+    uint64_t seq;
+    uint64_t messages;
+    inflate_session_t *session;           // session frames only
+    uint64_t dedup_epoch;                 // filter generation of dedup_count
+    size_t dedup_count;
+    device_recent_t *recent;              // cluster mode with a duplicate filter
+    container_record_t latest;
+} device_t;
+
+// Export or import request for one shard; the item payload holds a pointer
+// to it
+typedef struct {
+    const uint8_t *partitions;
+    bool discard;
+    uint8_t *buf;                         // export: filled by the shard; import: its devices
+    size_t len, cap;
+    uint32_t devices;
+    int error;
+} transfer_t;
+
+// Written by the owning shard only, read by anyone
+typedef struct {
+    _Atomic uint64_t v[sizeof(shard_stats_t) / sizeof(uint64_t)];
+} shard_counters_t;
+
+enum { C_ITEMS, C_RECORDS, C_BAD, C_RESYNCS, C_ORDER, C_STORED, C_FORWARDED, C_FORWARD_ERR, C_DEVICES, C_SLEEPS,
+       C_DUPLICATES, C_DEDUP_QUOTA, C_MOVED };
+
+typedef struct {
+    _Alignas(SPSC_RING_CACHE_LINE) atomic_int sleeping;
+    int wake_fd;
+    unsigned index;
+    pthread_t thread;
+    bool started;
+    struct shard_pipeline *p;
+
+    device_t *devices;
+    size_t cap, count;
+    FILE *store;
+    char *store_buf;
+    int forward_fd;
+    dedup_filter_t *dedup;
+    metrics_block_t *metrics;
+    double now;                           // per batch, for the dedup window
+    bool *signal;                         // per ingress: replies pushed this round
+    uint8_t *moved;                       // per partition: exported (cluster mode)
+
+    _Alignas(SPSC_RING_CACHE_LINE) shard_counters_t counters;
+} shard_t;
+
+struct shard_pipeline {
+    shard_pipeline_config_t cfg;
+    spsc_ring_t *in;                      // [ingress * shards + shard]
+    spsc_ring_t *out;                     // [shard * ingress + ingress]
+    int *reply_fd;                        // per ingress
+    shard_t *shard;
+    atomic_bool stop;
+    struct {
+        _Alignas(SPSC_RING_CACHE_LINE) uint64_t n;
+    } *tick;                              // per ingress, items submitted (metrics sampling)
+    uint64_t sample_mask;
+    int stage_series[SHARD_STAGE_COUNT][CODEC_LABELS];
+    int records_series[CODEC_LABELS];
+    int bytes_series[CODEC_LABELS];
+};
+
+// ================= HELPERS =================
+static void bump(shard_t *s, int c, uint64_t n) {
+    _Atomic uint64_t *v = &s->counters.v[c];
+    atomic_store_explicit(v, atomic_load_explicit(v, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static const char *codec_label(unsigned codec) {
+    return codec == SHARD_CODEC_SESSION ? "session" : container_codec_name((container_codec_t)codec);
+}
+
+uint64_t shard_pipeline_key(const char *id) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (; *id; id++) {
+        h ^= (uint8_t)*id;
+        h *= 0x100000001B3ull;
+    }
+    // fmix64 (MurmurHash3): FNV leaves the high bits poorly mixed
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+unsigned shard_pipeline_route(const shard_pipeline_t *p, uint64_t key) {
+    return (unsigned)(((key >> 32) * p->cfg.shards) >> 32);
+}
+
+static int open_forward(const char *hostport) {
+    char host[256];
+    const char *colon = strrchr(hostport, ':');
+    if (!colon || (size_t)(colon - hostport) >= sizeof(host)) return -1;
+    memcpy(host, hostport, (size_t)(colon - hostport));
+    host[colon - hostport] = '\0';
+
+    struct addrinfo hints = { .ai_socktype = SOCK_DGRAM }, *res;
+    if (getaddrinfo(host, colon + 1, &hints, &res) != 0) return -1;
+    int fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// ================= DEVICE TABLE =================
+static int table_grow(shard_t *s) {
+    size_t cap = s->cap ? s->cap * 2 : 1024;
+    device_t *d = calloc(cap, sizeof(*d));
+    if (!d) return -1;
+    for (size_t i = 0; i < s->cap; i++) {
+        if (!s->devices[i].key) continue;
+        size_t j = s->devices[i].key & (cap - 1);
+        while (d[j].key) j = (j + 1) & (cap - 1);
+        d[j] = s->devices[i];
+    }
+    free(s->devices);
+    s->devices = d;
+    s->cap = cap;
+    return 0;
+}
+
+static device_t *device_get(shard_t *s, uint64_t key) {
+    if (!key) key = 1;
+    if ((s->count + 1) * 10 > s->cap * 7 && table_grow(s)) return NULL;
+    size_t i = key & (s->cap - 1);
+    while (s->devices[i].key && s->devices[i].key != key) i = (i + 1) & (s->cap - 1);
+    if (!s->devices[i].key) {
+        s->devices[i].key = key;
+        s->count++;
+        bump(s, C_DEVICES, 1);
+    }
+    return &s->devices[i];
+}
+
+// ================= SHARD =================
+static int decode_session(device_t *d, const shard_item_t *it, container_record_t *rec) {
+    if (!d->session) {
+        d->session = malloc(sizeof(*d->session));
+        if (!d->session || inflate_session_init(d->session) != DEFLATE_SESSION_OK) {
+            free(d->session);
+            d->session = NULL;
+            return DEFLATE_SESSION_ERR_ZLIB;
+        }
+    }
+    uint8_t packed[CONTAINER_RECORD_STRUCT_MAX];
+    int n = inflate_session_decompress(d->session, it->payload, it->len, packed, sizeof(packed));
+    if (n < 0) return n;
+    return container_record_unpack_struct(packed, (size_t)n, rec) ? DEFLATE_SESSION_ERR_DATA : DEFLATE_SESSION_OK;
+}
+
+// Remembers a decoded record's key, within the device's share of the filter
+static void dedup_remember(shard_t *s, device_t *d, uint64_t key) {
+    uint64_t epoch = dedup_epoch(s->dedup, s->now);
+    if (d->dedup_epoch != epoch) {
+        d->dedup_epoch = epoch;
+        d->dedup_count = 0;
+    }
+    if (s->p->cfg.dedup_per_device && d->dedup_count >= s->p->cfg.dedup_per_device) {
+        bump(s, C_DEDUP_QUOTA, 1);
+        return;
+    }
+    dedup_insert(s->dedup, key, s->now);
+    d->dedup_count++;
+    if (s->p->cfg.partitions && (d->recent || (d->recent = calloc(1, sizeof(*d->recent))))) {
+        d->recent->key[d->recent->next] = key;
+        d->recent->at[d->recent->next] = s->now;
+        d->recent->next = (d->recent->next + 1) % DEVICE_RECENT;
+    }
+}
+
+// t0: pick-up time in ns when the item is timed, else 0
+static uint16_t process(shard_t *s, const shard_item_t *it, uint64_t t0) {
+    bump(s, C_ITEMS, 1);
+    if (s->moved && s->moved[shard_pipeline_partition(it->key, s->p->cfg.partitions)]) {
+        bump(s, C_MOVED, 1);
+        return SHARD_STATUS_MOVED;
+    }
+    device_t *d = device_get(s, it->key);
+    if (!d) {
+        bump(s, C_BAD, 1);
+        return SHARD_STATUS_BAD_PAYLOAD;
+    }
+    if (s->dedup && it->dedup) {
+        dedup_result_t r = dedup_lookup(s->dedup, it->dedup, s->now);
+        if (r == DEDUP_DUPLICATE || (r == DEDUP_PROBABLE && s->dedup->cfg.drop_unconfirmed)) {
+            bump(s, C_DUPLICATES, 1);
+            return SHARD_STATUS_DUPLICATE;
+        }
+    }
+    container_record_t rec;
+    if (it->decoded) {
+        rec = it->rec;
+    } else if (it->codec == SHARD_CODEC_SESSION) {
+        int rc = decode_session(d, it, &rec);
+        if (rc == DEFLATE_SESSION_ERR_DESYNC) {
+            bump(s, C_RESYNCS, 1);
+            return SHARD_STATUS_RESYNC;
+        }
+        if (rc != DEFLATE_SESSION_OK) {
+            bump(s, C_BAD, 1);
+            return SHARD_STATUS_BAD_PAYLOAD;
+        }
+    } else if (container_codec_decode_record((container_codec_t)it->codec, it->payload, it->len, &rec)) {
+        bump(s, C_BAD, 1);
+        return SHARD_STATUS_BAD_PAYLOAD;
+    }
+    // Only a decoded record moves the sequence: a bad or desynced frame
+    // would hide the order violation of the next good one
+    if (it->seq) {
+        if (it->seq <= d->seq) bump(s, C_ORDER, 1);
+        d->seq = it->seq;
+    }
+    d->latest = rec;
+    d->messages++;
+    bump(s, C_RECORDS, 1);
+    if (s->dedup && it->dedup) dedup_remember(s, d, it->dedup);
+
+    const shard_pipeline_t *p = s->p;
+    uint64_t t = 0;
+    if (s->metrics) {
+        metrics_add(s->metrics, p->records_series[it->codec], 1);
+        metrics_add(s->metrics, p->bytes_series[it->codec], it->len);
+    }
+    if (t0) {
+        t = metrics_now_ns();
+        metrics_observe(s->metrics, p->stage_series[SHARD_STAGE_DECODE][it->codec], t - t0);
+    }
+
+    if (s->store || s->forward_fd >= 0) {
+        uint8_t buf[2 + CONTAINER_RECORD_STRUCT_MAX];
+        size_t n = container_record_pack_struct(&rec, buf + 2, sizeof(buf) - 2);
+        buf[0] = (uint8_t)(n >> 8);
+        buf[1] = (uint8_t)n;
+        if (n && s->store) {
+            if (fwrite(buf, 1, n + 2, s->store) == n + 2) bump(s, C_STORED, n + 2);
+            if (t0) {
+                uint64_t t1 = metrics_now_ns();
+                metrics_observe(s->metrics, p->stage_series[SHARD_STAGE_STORE][it->codec], t1 - t);
+                t = t1;
+            }
+        }
+        if (n && s->forward_fd >= 0) {
+            if (send(s->forward_fd, buf + 2, n, MSG_DONTWAIT) == (ssize_t)n) bump(s, C_FORWARDED, 1);
+            else bump(s, C_FORWARD_ERR, 1);
+            if (t0) metrics_observe(s->metrics, p->stage_series[SHARD_STAGE_FORWARD][it->codec], metrics_now_ns() - t);
+        }
+    }
+    return SHARD_STATUS_OK;
+}
+
+// ================= PARTITION TRANSFER =================
+// Device state, little endian:
+//   key u64, seq u64, messages u64, flags u8
+//   flags & 1: latest record, packed length u8 + container_record_pack_struct bytes
+//   flags & 2: session, state length u16 + inflate_session_save bytes
+//   flags & 4: duplicate keys, count u8 + count x (key u64, age in ms u32)
+#define DEVICE_STATE_MAX (25 + 1 + CONTAINER_RECORD_STRUCT_MAX + 2 + INFLATE_SESSION_STATE_MAX + 1 + DEVICE_RECENT * 12)
+
+static void put_le(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static size_t device_save(shard_t *s, device_t *d, uint8_t *out) {
+    size_t n = 25;
+    put_le(out, d->key, 8);
+    put_le(out + 8, d->seq, 8);
+    put_le(out + 16, d->messages, 8);
+    uint8_t flags = 0;
+    if (d->messages) {
+        size_t len = container_record_pack_struct(&d->latest, out + n + 1, CONTAINER_RECORD_STRUCT_MAX);
+        if (len) {
+            out[n] = (uint8_t)len;
+            n += 1 + len;
+            flags |= 1;
+        }
+    }
+    if (d->session) {
+        int len = inflate_session_save(d->session, out + n + 2, INFLATE_SESSION_STATE_MAX);
+        if (len > 0) {
+            put_le(out + n, (uint64_t)len, 2);
+            n += 2 + (size_t)len;
+            flags |= 2;
+        }
+    }
+    if (d->recent && s->dedup) {
+        size_t count_at = n++;
+        uint8_t count = 0;
+        for (unsigned i = 0; i < DEVICE_RECENT; i++) {
+            double age = s->now - d->recent->at[i];
+            if (!d->recent->key[i] || age >= s->dedup->cfg.window_s) continue;
+            put_le(out + n, d->recent->key[i], 8);
+            put_le(out + n + 8, (uint64_t)(age * 1000.0), 4);
+            n += 12;
+            count++;
+        }
+        out[count_at] = count;
+        flags |= 4;
+    }
+    out[24] = flags;
+    return n;
+}
+
+// Size of the device state at data, 0 when malformed
+static size_t device_state_size(const uint8_t *data, size_t len) {
+    if (len < 25) return 0;
+    uint8_t flags = data[24];
+    size_t n = 25;
+    if (flags & 1) {
+        if (n + 1 > len) return 0;
+        n += 1 + data[n];
+    }
+    if (flags & 2) {
+        if (n + 2 > len) return 0;
+        n += 2 + get_le(data + n, 2);
+    }
+    if (flags & 4) {
+        if (n + 1 > len) return 0;
+        n += 1 + 12 * (size_t)data[n];
+    }
+    return flags & ~7 || n > len ? 0 : n;
+}
+
+static void device_release(device_t *d) {
+    if (d->session) {
+        inflate_session_end(d->session);
+        free(d->session);
+    }
+    free(d->recent);
+    memset(d, 0, sizeof(*d));
+}
+
+// Replaces the state of the device with data (checked by device_state_size)
+static void device_load(shard_t *s, const uint8_t *data) {
+    device_t *d = device_get(s, get_le(data, 8));
+    if (!d) return;
+    uint64_t key = d->key;
+    device_release(d);
+    d->key = key;
+    d->seq = get_le(data + 8, 8);
+    d->messages = get_le(data + 16, 8);
+    uint8_t flags = data[24];
+    size_t n = 25;
+    if (flags & 1) {
+        if (container_record_unpack_struct(data + n + 1, data[n], &d->latest)) memset(&d->latest, 0, sizeof(d->latest));
+        n += 1 + data[n];
+    }
+    if (flags & 2) {
+        size_t len = get_le(data + n, 2);
+        d->session = malloc(sizeof(*d->session));
+        // Without the history the stream waits for the next keyframe (409)
+        if (d->session && inflate_session_restore(d->session, data + n + 2, len) != DEFLATE_SESSION_OK &&
+            inflate_session_init(d->session) != DEFLATE_SESSION_OK) {
+            free(d->session);
+            d->session = NULL;
+        }
+        n += 2 + len;
+    }
+    if (flags & 4) {
+        unsigned count = data[n++];
+        for (unsigned i = 0; i < count; i++, n += 12) {
+            uint64_t dk = get_le(data + n, 8);
+            double at = s->now - get_le(data + n + 8, 4) / 1000.0;
+            if (!s->dedup) continue;
+            // Remembered for a window from now: a little longer than on the old node
+            dedup_insert(s->dedup, dk, s->now);
+            if (!d->recent && !(d->recent = calloc(1, sizeof(*d->recent)))) continue;
+            d->recent->key[d->recent->next] = dk;
+            d->recent->at[d->recent->next] = at;
+            d->recent->next = (d->recent->next + 1) % DEVICE_RECENT;
+        }
+    }
+}
+
+static void shard_export(shard_t *s, transfer_t *t) {
+    unsigned parts = s->p->cfg.partitions;
+    device_t *kept = calloc(s->cap, sizeof(*kept));
+    if (!kept) {
+        t->error = -1;
+        return;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < s->cap; i++) {
+        device_t *d = &s->devices[i];
+        if (!d->key) continue;
+        if (!t->partitions[shard_pipeline_partition(d->key, parts)]) {
+            size_t j = d->key & (s->cap - 1);
+            while (kept[j].key) j = (j + 1) & (s->cap - 1);
+            kept[j] = *d;
+            count++;
+            continue;
+        }
+        if (!t->discard) {
+            if (t->len + DEVICE_STATE_MAX > t->cap) {
+                size_t cap = t->cap ? 2 * t->cap : 64 * 1024;
+                uint8_t *buf = realloc(t->buf, cap);
+                if (!buf) {
+                    free(kept);
+                    t->error = -1;
+                    return;
+                }
+                t->buf = buf;
+                t->cap = cap;
+            }
+            t->len += device_save(s, d, t->buf + t->len);
+            t->devices++;
+        }
+    }
+    // Nothing fails past this point: release the exported devices
+    for (size_t i = 0; i < s->cap; i++) {
+        device_t *d = &s->devices[i];
+        if (d->key && t->partitions[shard_pipeline_partition(d->key, parts)]) device_release(d);
+    }
+    for (unsigned p = 0; p < parts; p++) {
+        if (t->partitions[p]) s->moved[p] = 1;
+    }
+    // Counters only grow; the device gauge wraps down by the exported count
+    bump(s, C_DEVICES, (uint64_t)count - s->count);
+    free(s->devices);
+    s->devices = kept;
+    s->count = count;
+}
+
+static void shard_import(shard_t *s, transfer_t *t) {
+    for (size_t off = 0; off < t->len;) {
+        size_t n = device_state_size(t->buf + off, t->len - off);
+        device_load(s, t->buf + off);
+        off += n;
+        t->devices++;
+    }
+    for (unsigned p = 0; p < s->p->cfg.partitions; p++) {
+        if (t->partitions[p]) s->moved[p] = 0;
+    }
+}
+
+static void reply(shard_t *s, unsigned ingress, uint64_t token, uint16_t status) {
+    shard_pipeline_t *p = s->p;
+    spsc_ring_t *r = &p->out[s->index * p->cfg.ingress + ingress];
+    shard_reply_t rep = { token, status };
+    // Ingress bounds its in-flight items per shard by the ring size, so this
+    // only waits if it stopped draining
+    while (!spsc_ring_push(r, &rep, sizeof(rep))) {
+        eventfd_write(p->reply_fd[ingress], 1);
+        sched_yield();
+    }
+    s->signal[ingress] = true;
+}
+
+static bool rings_empty(shard_t *s) {
+    shard_pipeline_t *p = s->p;
+    for (unsigned i = 0; i < p->cfg.ingress; i++) {
+        if (spsc_ring_size(&p->in[i * p->cfg.shards + s->index])) return false;
+    }
+    return true;
+}
+
+static void *shard_main(void *arg) {
+    shard_t *s = arg;
+    shard_pipeline_t *p = s->p;
+    if (p->cfg.pin) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(s->index % (unsigned)(cpus > 0 ? cpus : 1), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    unsigned idle = 0;
+    for (;;) {
+        size_t done = 0;
+        if (s->dedup) {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            s->now = ts.tv_sec + ts.tv_nsec * 1e-9;
+        }
+        for (unsigned i = 0; i < p->cfg.ingress; i++) {
+            spsc_ring_t *r = &p->in[i * p->cfg.shards + s->index];
+            for (int n = 0; n < SHARD_BATCH; n++) {
+                const shard_item_t *it = spsc_ring_peek(r);
+                if (!it) break;
+                if (it->op != OP_RECORD) {
+                    transfer_t *t;
+                    memcpy(&t, it->payload, sizeof(t));
+                    if (it->op == OP_EXPORT) shard_export(s, t);
+                    else shard_import(s, t);
+                    uint64_t token = it->token;
+                    spsc_ring_release(r);
+                    reply(s, i, token, SHARD_STATUS_OK);
+                    done++;
+                    continue;
+                }
+                uint64_t t0 = 0;
+                if (s->metrics && it->submitted_ns) {
+                    t0 = metrics_now_ns();
+                    metrics_observe(s->metrics, p->stage_series[SHARD_STAGE_QUEUE_WAIT][it->codec],
+                                    t0 - it->submitted_ns);
+                }
+                uint16_t status = process(s, it, t0);
+                uint64_t token = it->token;
+                spsc_ring_release(r);
+                if (p->cfg.replies) reply(s, i, token, status);
+                done++;
+            }
+        }
+        for (unsigned i = 0; p->cfg.replies && i < p->cfg.ingress; i++) {
+            if (s->signal[i]) eventfd_write(p->reply_fd[i], 1);
+            s->signal[i] = false;
+        }
+        if (done) {
+            idle = 0;
+            continue;
+        }
+        // Producers are done once stop is set; leave when the rings are drained
+        if (atomic_load(&p->stop)) {
+            if (rings_empty(s)) break;
+            continue;
+        }
+        if (++idle < SHARD_SPIN) {
+            cpu_relax();
+            continue;
+        }
+
+        // Announce the sleep, then look once more: a producer that committed
+        // before seeing the flag is caught here, one that sees it writes the eventfd
+        atomic_store(&s->sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (rings_empty(s) && !atomic_load(&p->stop)) {
+            struct pollfd pfd = { .fd = s->wake_fd, .events = POLLIN };
+            if (poll(&pfd, 1, SHARD_SLEEP_MS) > 0) {
+                eventfd_t v;
+                eventfd_read(s->wake_fd, &v);
+            }
+            bump(s, C_SLEEPS, 1);
+        }
+        atomic_store(&s->sleeping, 0);
+        idle = 0;
+    }
+    return NULL;
+}
+
+// ================= PIPELINE =================
+static int shard_open(shard_pipeline_t *p, shard_t *s, unsigned index) {
+    s->p = p;
+    s->index = index;
+    s->forward_fd = -1;
+    atomic_init(&s->sleeping, 0);
+    s->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    s->signal = calloc(p->cfg.ingress, sizeof(*s->signal));
+    if (s->wake_fd < 0 || !s->signal || table_grow(s)) return -1;
+    if (p->cfg.partitions && !(s->moved = calloc(p->cfg.partitions, 1))) return -1;
+    if (p->cfg.store_dir) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/shard-%02u.rec", p->cfg.store_dir, index);
+        s->store = fopen(path, "ab");
+        s->store_buf = malloc(STORE_BUFFER);
+        if (!s->store || !s->store_buf) {
+            fprintf(stderr, "shard %u: cannot open %s\n", index, path);
+            return -1;
+        }
+        setvbuf(s->store, s->store_buf, _IOFBF, STORE_BUFFER);
+    }
+    if (p->cfg.dedup.window_s > 0.0) {
+        s->dedup = malloc(sizeof(*s->dedup));
+        if (!s->dedup || dedup_init(s->dedup, &p->cfg.dedup)) {
+            free(s->dedup);
+            s->dedup = NULL;
+            return -1;
+        }
+    }
+    if (p->cfg.metrics && !(s->metrics = metrics_block(p->cfg.metrics))) return -1;
+    if (p->cfg.forward && (s->forward_fd = open_forward(p->cfg.forward)) < 0) {
+        fprintf(stderr, "shard %u: cannot reach %s\n", index, p->cfg.forward);
+        return -1;
+    }
+    return 0;
+}
+
+static void shard_close(shard_t *s) {
+    for (size_t i = 0; i < s->cap; i++) {
+        if (s->devices[i].key) device_release(&s->devices[i]);
+    }
+    free(s->devices);
+    free(s->moved);
+    if (s->dedup) dedup_free(s->dedup);
+    free(s->dedup);
+    if (s->store) fclose(s->store);
+    free(s->store_buf);
+    if (s->forward_fd >= 0) close(s->forward_fd);
+    if (s->wake_fd >= 0) close(s->wake_fd);
+    free(s->signal);
+}
+
+// Stage histograms and per-codec counters, before any block is taken
+static int register_metrics(shard_pipeline_t *p) {
+    static const char *stage_names[SHARD_STAGE_COUNT] = { "receive", "queue_wait", "decode",
+                                                          "store",   "forward",    "request" };
+    metrics_registry_t *r = p->cfg.metrics;
+    char labels[96];
+    for (unsigned c = 0; c < CODEC_LABELS; c++) {
+        for (int st = 0; st < SHARD_STAGE_COUNT; st++) {
+            snprintf(labels, sizeof(labels), "stage=\"%s\",codec=\"%s\"", stage_names[st], codec_label(c));
+            p->stage_series[st][c] = metrics_series(r, METRICS_HISTOGRAM, "shard_pipeline_stage_seconds", labels,
+                                                    "Time per item and pipeline stage");
+        }
+        snprintf(labels, sizeof(labels), "codec=\"%s\"", codec_label(c));
+        p->records_series[c] = metrics_series(r, METRICS_COUNTER, "shard_pipeline_records_total", labels,
+                                              "Records decoded and applied");
+        p->bytes_series[c] = metrics_series(r, METRICS_COUNTER, "shard_pipeline_payload_bytes_total", labels,
+                                            "Wire bytes of the decoded records");
+        if (p->records_series[c] < 0 || p->bytes_series[c] < 0) return -1;
+        for (int st = 0; st < SHARD_STAGE_COUNT; st++) {
+            if (p->stage_series[st][c] < 0) return -1;
+        }
+    }
+    return 0;
+}
+
+static void pipeline_free(shard_pipeline_t *p) {
+    size_t rings = (size_t)p->cfg.ingress * p->cfg.shards;
+    for (size_t i = 0; p->in && i < rings; i++) spsc_ring_free(&p->in[i]);
+    for (size_t i = 0; p->out && i < rings; i++) spsc_ring_free(&p->out[i]);
+    for (unsigned i = 0; p->reply_fd && i < p->cfg.ingress; i++) {
+        if (p->reply_fd[i] >= 0) close(p->reply_fd[i]);
+    }
+    for (unsigned i = 0; p->shard && i < p->cfg.shards; i++) shard_close(&p->shard[i]);
+    free(p->in);
+    free(p->out);
+    free(p->reply_fd);
+    free(p->shard);
+    free(p->tick);
+    free(p);
+}
+
+shard_pipeline_t *shard_pipeline_start(const shard_pipeline_config_t *cfg) {
+    if (!cfg->shards || cfg->shards > SHARD_PIPELINE_MAX_SHARDS || !cfg->ingress ||
+        cfg->ingress > SHARD_PIPELINE_MAX_INGRESS || cfg->ring_slots < 2 ||
+        cfg->partitions > SHARD_PIPELINE_MAX_PARTITIONS || (cfg->partitions && !cfg->replies))
+        return NULL;
+    shard_pipeline_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->cfg = *cfg;
+    atomic_init(&p->stop, false);
+    size_t rings = (size_t)cfg->ingress * cfg->shards;
+    p->in = calloc(rings, sizeof(*p->in));
+    p->out = calloc(rings, sizeof(*p->out));
+    p->reply_fd = malloc(cfg->ingress * sizeof(*p->reply_fd));
+    p->shard = aligned_alloc(SPSC_RING_CACHE_LINE, cfg->shards * sizeof(*p->shard));
+    if (!p->in || !p->out || !p->reply_fd || !p->shard) goto fail;
+    memset(p->shard, 0, cfg->shards * sizeof(*p->shard));
+    for (unsigned i = 0; i < cfg->ingress; i++) p->reply_fd[i] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    // A failed start closes every shard, also those never opened
+    for (unsigned s = 0; s < cfg->shards; s++) p->shard[s].wake_fd = p->shard[s].forward_fd = -1;
+    for (size_t i = 0; i < rings; i++) {
+        if (spsc_ring_init(&p->in[i], cfg->ring_slots, sizeof(shard_item_t)) ||
+            (cfg->replies && spsc_ring_init(&p->out[i], cfg->ring_slots, sizeof(shard_reply_t))))
+            goto fail;
+    }
+    for (unsigned i = 0; i < cfg->ingress; i++) {
+        if (p->reply_fd[i] < 0) goto fail;
+    }
+    if (cfg->metrics) {
+        unsigned sample = cfg->metrics_sample ? cfg->metrics_sample : 1;
+        if (sample & (sample - 1)) goto fail;
+        p->sample_mask = sample - 1;
+        p->tick = aligned_alloc(SPSC_RING_CACHE_LINE, cfg->ingress * sizeof(*p->tick));
+        if (!p->tick || register_metrics(p)) goto fail;
+        memset(p->tick, 0, cfg->ingress * sizeof(*p->tick));
+    }
+    for (unsigned s = 0; s < cfg->shards; s++) {
+        if (shard_open(p, &p->shard[s], s)) goto fail;
+    }
+    for (unsigned s = 0; s < cfg->shards; s++) {
+        if (pthread_create(&p->shard[s].thread, NULL, shard_main, &p->shard[s]) != 0) {
+            shard_pipeline_stop(p, NULL);
+            return NULL;
+        }
+        p->shard[s].started = true;
+    }
+    return p;
+fail:
+    pipeline_free(p);
+    return NULL;
+}
+
+int shard_pipeline_submit(shard_pipeline_t *p, unsigned ingress, const shard_item_t *item) {
+    unsigned s = shard_pipeline_route(p, item->key);
+    spsc_ring_t *r = &p->in[ingress * p->cfg.shards + s];
+    void *slot = spsc_ring_reserve(r);
+    if (!slot) return -1;
+    memcpy(slot, item, offsetof(shard_item_t, payload) + (item->decoded ? 0 : item->len));
+    if (p->cfg.metrics && item->op == OP_RECORD)
+        ((shard_item_t *)slot)->submitted_ns = p->tick[ingress].n++ & p->sample_mask ? 0 : metrics_now_ns();
+    spsc_ring_commit(r);
+    // Pairs with the fence in shard_main: either the shard sees the item or we see it sleeping
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&p->shard[s].sleeping, memory_order_relaxed)) eventfd_write(p->shard[s].wake_fd, 1);
+    return 0;
+}
+
+size_t shard_pipeline_replies(shard_pipeline_t *p, unsigned ingress, shard_reply_t *out, size_t max) {
+    size_t n = 0;
+    eventfd_t v;
+    eventfd_read(p->reply_fd[ingress], &v);
+    for (unsigned s = 0; p->cfg.replies && s < p->cfg.shards && n < max; s++) {
+        spsc_ring_t *r = &p->out[s * p->cfg.ingress + ingress];
+        while (n < max && spsc_ring_pop(r, &out[n], sizeof(out[n]))) n++;
+    }
+    return n;
+}
+
+// Hands every shard its transfer and waits for all the replies. it is the
+// caller's scratch item, allocated before any shard is asked
+static void transfer_run(shard_pipeline_t *p, unsigned ingress, uint8_t op, transfer_t *t, shard_item_t *it) {
+    // One reply per shard; the ring is sized for one item per slot, so a
+    // full ring only means the shard is behind
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        transfer_t *ts = &t[s];
+        memset(it, 0, offsetof(shard_item_t, payload));
+        it->op = op;
+        it->token = s;
+        // Any key of the shard: route() reads the high 32 bits
+        it->key = ((((uint64_t)s << 32) + p->cfg.shards - 1) / p->cfg.shards) << 32;
+        it->len = sizeof(ts);
+        memcpy(it->payload, &ts, sizeof(ts));
+        while (shard_pipeline_submit(p, ingress, it) != 0) sched_yield();
+    }
+    unsigned answered = 0;
+    shard_reply_t rep[SHARD_PIPELINE_MAX_SHARDS];
+    while (answered < p->cfg.shards) {
+        size_t n = shard_pipeline_replies(p, ingress, rep, SHARD_PIPELINE_MAX_SHARDS);
+        answered += (unsigned)n;
+        if (!n) {
+            struct pollfd pfd = { .fd = p->reply_fd[ingress], .events = POLLIN };
+            poll(&pfd, 1, SHARD_SLEEP_MS);
+        }
+    }
+}
+
+int shard_pipeline_export(shard_pipeline_t *p, unsigned ingress, const uint8_t *partitions, bool discard,
+                          uint8_t **out, size_t *len, uint32_t *devices) {
+    transfer_t t[SHARD_PIPELINE_MAX_SHARDS];
+    memset(t, 0, sizeof(t));
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        t[s].partitions = partitions;
+        t[s].discard = discard;
+    }
+    if (out) *out = NULL;
+    if (len) *len = 0;
+    if (devices) *devices = 0;
+    if (!p->cfg.partitions || !p->cfg.replies) return -1;
+    shard_item_t *it = calloc(1, sizeof(*it));
+    if (!it) return -1;
+    transfer_run(p, ingress, OP_EXPORT, t, it);
+
+    size_t total = 0;
+    int rc = 0;
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        total += t[s].len;
+        if (t[s].error) rc = -1;
+    }
+    uint8_t *buf = !discard && out && total ? malloc(total) : NULL;
+    bool restored = total && !discard && out && !buf;
+    if (restored) {
+        // The shards have let go of the devices: each takes its own back. A
+        // shard that failed kept them and only has its moved flags cleared.
+        for (unsigned s = 0; s < p->cfg.shards; s++) {
+            if (t[s].error) t[s].len = 0;
+            t[s].devices = 0;
+        }
+        transfer_run(p, ingress, OP_IMPORT, t, it);
+        rc = -1;
+    }
+    size_t off = 0;
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        if (buf) memcpy(buf + off, t[s].buf, t[s].len);
+        off += t[s].len;
+        if (devices && !restored) *devices += t[s].devices;
+        free(t[s].buf);
+    }
+    free(it);
+    if (out) *out = buf;
+    if (len) *len = buf ? total : 0;
+    return rc;
+}
+
+long shard_pipeline_import(shard_pipeline_t *p, unsigned ingress, const uint8_t *partitions, const uint8_t *data,
+                           size_t len) {
+    if (!p->cfg.partitions || !p->cfg.replies) return -1;
+    // Check everything and count per shard, then copy each shard's devices together
+    size_t bytes[SHARD_PIPELINE_MAX_SHARDS] = { 0 };
+    for (size_t off = 0; off < len;) {
+        size_t n = device_state_size(data + off, len - off);
+        uint64_t key = n ? get_le(data + off, 8) : 0;
+        if (!n || !partitions[shard_pipeline_partition(key, p->cfg.partitions)]) return -1;
+        bytes[shard_pipeline_route(p, key)] += n;
+        off += n;
+    }
+    transfer_t t[SHARD_PIPELINE_MAX_SHARDS];
+    memset(t, 0, sizeof(t));
+    shard_item_t *it = calloc(1, sizeof(*it));
+    long rc = it ? 0 : -1;
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        t[s].partitions = partitions;
+        if (bytes[s] && !(t[s].buf = malloc(bytes[s]))) rc = -1;
+    }
+    if (rc == 0) {
+        for (size_t off = 0; off < len;) {
+            size_t n = device_state_size(data + off, len - off);
+            transfer_t *ts = &t[shard_pipeline_route(p, get_le(data + off, 8))];
+            memcpy(ts->buf + ts->len, data + off, n);
+            ts->len += n;
+            off += n;
+        }
+        transfer_run(p, ingress, OP_IMPORT, t, it);
+        for (unsigned s = 0; s < p->cfg.shards; s++) rc += t[s].devices;
+    }
+    for (unsigned s = 0; s < p->cfg.shards; s++) free(t[s].buf);
+    free(it);
+    return rc;
+}
+
+int shard_pipeline_stage_series(const shard_pipeline_t *p, shard_stage_t stage, unsigned codec) {
+    return p->cfg.metrics && stage < SHARD_STAGE_COUNT && codec < CODEC_LABELS ? p->stage_series[stage][codec] : -1;
+}
+
+int shard_pipeline_reply_fd(const shard_pipeline_t *p, unsigned ingress) {
+    return p->reply_fd[ingress];
+}
+
+void shard_pipeline_stats(const shard_pipeline_t *p, unsigned shard, shard_stats_t *out) {
+    uint64_t *dst = (uint64_t *)out;
+    for (size_t i = 0; i < sizeof(*out) / sizeof(uint64_t); i++)
+        dst[i] = atomic_load_explicit(&p->shard[shard].counters.v[i], memory_order_relaxed);
+}
+
+void shard_pipeline_stop(shard_pipeline_t *p, shard_stats_t *totals) {
+    atomic_store(&p->stop, true);
+    for (unsigned s = 0; s < p->cfg.shards; s++) {
+        if (!p->shard[s].started) continue;
+        eventfd_write(p->shard[s].wake_fd, 1);
+        pthread_join(p->shard[s].thread, NULL);
+    }
+    if (totals) {
+        memset(totals, 0, sizeof(*totals));
+        for (unsigned s = 0; s < p->cfg.shards; s++) {
+            shard_stats_t st;
+            shard_pipeline_stats(p, s, &st);
+            uint64_t *t = (uint64_t *)totals, *v = (uint64_t *)&st;
+            for (size_t i = 0; i < sizeof(st) / sizeof(uint64_t); i++) t[i] += v[i];
+        }
+    }
+    pipeline_free(p);
+}
@@ -0,0 +1,183 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Shared-nothing receiver pipeline: one shard thread per core, each owning
+// the devices whose key hashes to it.
+//
+//   ingress 0 ──ring──► shard 0 (decode, device state, store, forward)
+//   ingress 0 ──ring──► shard 1 ...
+//   ingress 1 ──ring──► shard 0 ...
+//
+// Every (ingress, shard) pair has its own SPSC ring (common/spsc_ring.h),
+// and every (shard, ingress) pair a reply ring, so no two threads ever
+// write the same queue and nothing is locked. A device always lands on
+// the same shard, and a shard drains each ring in order, so the records of
+// a device submitted through one ingress are processed in submission
+// order. The shard is the only thread that touches a device's state:
+// duplicate filter (common/dedup_filter.h), checked before the decode,
+// latest record, sequence check, session inflate stream (deflate_session),
+// per-shard store file (u16 BE length + packed record, the --packed
+// format of field_profile) and forward socket.
+//
+// Idle shards sleep on an eventfd; producers only signal a shard that
+// announced it is going to sleep. With a metrics registry (common/metrics.h)
+// every shard counts records and bytes per codec into its own block, and
+// times the queue wait, decode, store and forward of one item in
+// metrics_sample, since timing every item costs about half a protobuf
+// decode.
+//
+// Cluster mode (cfg.partitions > 0, tools/shard_receiver --cluster): the
+// device keys fall into partitions that the nodes of a cluster own, and
+// shard_pipeline_export / shard_pipeline_import move the state of whole
+// partitions between processes (latest record, sequence, session inflate
+// history, recent duplicate keys). A shard answers SHARD_STATUS_MOVED for
+// records of a partition it has exported. Linux only, host only.
+
+#ifndef SHARD_PIPELINE_H
+#define SHARD_PIPELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "dedup_filter.h"
+#include "metrics.h"
+
+#define SHARD_PIPELINE_MAX_SHARDS 64
+#define SHARD_PIPELINE_MAX_INGRESS 64
+#define SHARD_ITEM_PAYLOAD_MAX CONTAINER_CODEC_MAX_PAYLOAD
+#define SHARD_CODEC_SESSION CONTAINER_CODEC_COUNT   // struct record in a deflate_session frame
+
+// Stages of shard_pipeline_stage_seconds; receive and request are recorded
+// by the ingress (parse to submit, parse to response)
+typedef enum {
+    SHARD_STAGE_RECEIVE,
+    SHARD_STAGE_QUEUE_WAIT,               // submit to shard pick-up
+    SHARD_STAGE_DECODE,                   // device lookup, duplicate check, decode
+    SHARD_STAGE_STORE,
+    SHARD_STAGE_FORWARD,
+    SHARD_STAGE_REQUEST,
+    SHARD_STAGE_COUNT
+} shard_stage_t;
+
+// Reply status, HTTP-like
+#define SHARD_STATUS_OK 200
+#define SHARD_STATUS_DUPLICATE 208                   // already received within the dedup window
+#define SHARD_STATUS_BAD_PAYLOAD 400
+#define SHARD_STATUS_RESYNC 409                      // session frame while waiting for a keyframe
+#define SHARD_STATUS_MOVED 421                       // partition exported (cluster mode)
+
+#define SHARD_PIPELINE_MAX_PARTITIONS 4096
+
+typedef struct {
+    uint64_t key;                         // device key (shard_pipeline_key)
+    uint64_t token;                       // returned with the reply
+    uint64_t seq;                         // per-device sequence for the order check, 0 = none
+    uint64_t dedup;                       // duplicate key (dedup_key), 0 = not checked
+    uint64_t submitted_ns;                // set by shard_pipeline_submit, 0 = not timed
+    uint8_t codec;                        // container_codec_t or SHARD_CODEC_SESSION
+    uint8_t op;                           // 0 = record; export and import are internal
+    bool decoded;                         // rec already holds the record (ingress decoded it)
+    uint16_t len;                         // payload bytes (ignored when decoded)
+    container_record_t rec;
+    uint8_t payload[SHARD_ITEM_PAYLOAD_MAX];
+} shard_item_t;
+
+typedef struct {
+    uint64_t token;
+    uint16_t status;
+} shard_reply_t;
+
+typedef struct {
+    unsigned ingress;                     // producer threads
+    unsigned shards;
+    size_t ring_slots;                    // per ring, rounded up to a power of two
+    bool replies;                         // shards answer every item
+    bool pin;                             // pin shard i to CPU i % online CPUs
+    const char *store_dir;                // shard-NN.rec per shard, NULL for none
+    const char *forward;                  // host:port, packed records over UDP, NULL for none
+    dedup_config_t dedup;                 // per shard; window_s 0 = no duplicate filter
+    size_t dedup_per_device;              // keys a device may add per generation, 0 = no limit
+    metrics_registry_t *metrics;          // series added by shard_pipeline_start, NULL for none
+    unsigned metrics_sample;              // time one item in N per ingress (power of two, 0 = 1)
+    unsigned partitions;                  // cluster partitions, 0 = not clustered
+} shard_pipeline_config_t;
+
+typedef struct {
+    uint64_t items;
+    uint64_t records;                     // decoded and applied
+    uint64_t bad;
+    uint64_t resyncs;
+    uint64_t order_violations;            // seq not above the device's last decoded one
+    uint64_t stored_bytes;
+    uint64_t forwarded;
+    uint64_t forward_errors;
+    uint64_t devices;
+    uint64_t sleeps;                      // times the shard blocked on its eventfd
+    uint64_t duplicates;                  // dropped before the decode
+    uint64_t dedup_over_quota;            // records not remembered (device over dedup_per_device)
+    uint64_t moved;                       // records of an exported partition (SHARD_STATUS_MOVED)
+} shard_stats_t;
+
+typedef struct shard_pipeline shard_pipeline_t;
+
+// Device key of an iso6346 (or any device id string): FNV-1a, mixed so the
+// high bits are uniform
+uint64_t shard_pipeline_key(const char *id);
+
+// Starts the shard threads. Returns NULL on bad config or resource failure.
+shard_pipeline_t *shard_pipeline_start(const shard_pipeline_config_t *cfg);
+
+unsigned shard_pipeline_route(const shard_pipeline_t *p, uint64_t key);
+
+// Cluster partition of a device key: the low bits, so it does not follow
+// the shard (high bits)
+static inline unsigned shard_pipeline_partition(uint64_t key, unsigned partitions) {
+    return (unsigned)((uint32_t)key % partitions);
+}
+
+// From ingress thread `ingress` only. Returns 0, or -1 if that shard's ring
+// is full (the caller retries or sheds).
+int shard_pipeline_submit(shard_pipeline_t *p, unsigned ingress, const shard_item_t *item);
+
+// Replies for ingress thread `ingress`, from any shard. Returns the count.
+size_t shard_pipeline_replies(shard_pipeline_t *p, unsigned ingress, shard_reply_t *out, size_t max);
+
+// eventfd that becomes readable when replies are waiting (for epoll)
+int shard_pipeline_reply_fd(const shard_pipeline_t *p, unsigned ingress);
+
+// Histogram series id of a stage and codec (container_codec_t or
+// SHARD_CODEC_SESSION), -1 without metrics
+int shard_pipeline_stage_series(const shard_pipeline_t *p, shard_stage_t stage, unsigned codec);
+
+// Live counters (relaxed reads); shard < cfg.shards
+void shard_pipeline_stats(const shard_pipeline_t *p, unsigned shard, shard_stats_t *out);
+
+// Cluster mode. partitions[i] != 0 selects partition i. Both run from
+// producer `ingress` (its rings and replies, so a thread of its own) and
+// wait until every shard has answered.
+//
+// Export takes the devices of the selected partitions out of every shard
+// and marks the partitions moved; *out (malloc'd, freed by the caller)
+// receives their state, *devices the count. discard drops the state
+// instead (out may be NULL). Returns 0, or -1 when memory ran out: a
+// shard that failed keeps its devices, and when *out cannot be allocated
+// every shard takes its devices back and *out is NULL.
+int shard_pipeline_export(shard_pipeline_t *p, unsigned ingress, const uint8_t *partitions, bool discard,
+                          uint8_t **out, size_t *len, uint32_t *devices);
+
+// Loads exported state (data may be empty) and opens the selected
+// partitions again. Returns the devices loaded, or -1 on malformed data or
+// a key outside the selected partitions (nothing is loaded).
+long shard_pipeline_import(shard_pipeline_t *p, unsigned ingress, const uint8_t *partitions, const uint8_t *data,
+                           size_t len);
+
+// Drains every ring, joins the shards, closes files. totals may be NULL.
+void shard_pipeline_stop(shard_pipeline_t *p, shard_stats_t *totals);
+
+#endif // SHARD_PIPELINE_H
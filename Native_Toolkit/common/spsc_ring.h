@@ -0,0 +1,115 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Lock-free single-producer / single-consumer ring of fixed-size slots.
+//
+// The producer owns tail, the consumer owns head; each publishes its index
+// with a release store and reads the other's with an acquire load, and
+// keeps a cached copy of it so the shared line is only touched when the
+// ring looks full (producer) or empty (consumer). Indices run freely and
+// are masked on access, so capacity is a power of two and all slots are
+// usable. Slots are written in place (reserve/commit) or copied
+// (push/pop). Header only so the hot path inlines; host only.
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPSC_RING_CACHE_LINE 64
+
+typedef struct {
+    // Consumer side
+    _Alignas(SPSC_RING_CACHE_LINE) atomic_size_t head;
+    size_t tail_cache;
+    // Producer side
+    _Alignas(SPSC_RING_CACHE_LINE) atomic_size_t tail;
+    size_t head_cache;
+    // Read-only after init
+    _Alignas(SPSC_RING_CACHE_LINE) size_t mask;
+    size_t slot_size;
+    uint8_t *slots;
+} spsc_ring_t;
+
+// capacity is rounded up to a power of two. Returns 0, -1 on allocation failure.
+static inline int spsc_ring_init(spsc_ring_t *r, size_t capacity, size_t slot_size) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    memset(r, 0, sizeof(*r));
+    r->slot_size = (slot_size + 7) & ~(size_t)7;
+    r->slots = aligned_alloc(SPSC_RING_CACHE_LINE,
+                             (cap * r->slot_size + SPSC_RING_CACHE_LINE - 1) & ~(size_t)(SPSC_RING_CACHE_LINE - 1));
+    if (!r->slots) return -1;
+    r->mask = cap - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    return 0;
+}
+
+static inline void spsc_ring_free(spsc_ring_t *r) {
+    free(r->slots);
+    r->slots = NULL;
+}
+
+// ================= PRODUCER =================
+// Next free slot, or NULL when full. Fill it, then spsc_ring_commit.
+static inline void *spsc_ring_reserve(spsc_ring_t *r) {
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail - r->head_cache > r->mask) {
+        r->head_cache = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (tail - r->head_cache > r->mask) return NULL;
+    }
+    return r->slots + (tail & r->mask) * r->slot_size;
+}
+
+static inline void spsc_ring_commit(spsc_ring_t *r) {
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+}
+
+static inline bool spsc_ring_push(spsc_ring_t *r, const void *item, size_t len) {
+    void *slot = spsc_ring_reserve(r);
+    if (!slot) return false;
+    memcpy(slot, item, len);
+    spsc_ring_commit(r);
+    return true;
+}
+
+// ================= CONSUMER =================
+// Oldest slot, or NULL when empty. Read it, then spsc_ring_release.
+static inline const void *spsc_ring_peek(spsc_ring_t *r) {
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (head == r->tail_cache) {
+        r->tail_cache = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (head == r->tail_cache) return NULL;
+    }
+    return r->slots + (head & r->mask) * r->slot_size;
+}
+
+static inline void spsc_ring_release(spsc_ring_t *r) {
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+}
+
+static inline bool spsc_ring_pop(spsc_ring_t *r, void *item, size_t len) {
+    const void *slot = spsc_ring_peek(r);
+    if (!slot) return false;
+    memcpy(item, slot, len);
+    spsc_ring_release(r);
+    return true;
+}
+
+// Approximate from either side
+static inline size_t spsc_ring_size(spsc_ring_t *r) {
+    return atomic_load_explicit(&r->tail, memory_order_acquire) - atomic_load_explicit(&r->head, memory_order_acquire);
+}
+
+#endif // SPSC_RING_H
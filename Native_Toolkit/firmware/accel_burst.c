@@ -0,0 +1,350 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "accel_burst.h"
+
+#include <string.h>
+
+#define RING_MASK (ACCEL_BURST_RING_SAMPLES - 1)
+#define SAMPLE_LIMIT_MG 16000             // +/-16 g full scale
+
+// Burst wire format (big-endian, same convention as the struct packing):
+//   [0]     version << 5 | log2(decimation) << 3 | quantization shift
+//   [1]     pre-trigger samples
+//   [2..3]  sample rate after decimation (Hz)
+//   [4..5]  samples per axis
+//   [6..7]  peak deviation (mg)
+//   [8..9]  trigger age (units of 100 ms, saturating)
+//   then per axis: int16 first sample, and for every block of 16 deltas a
+//   4-bit width code followed by the zigzag deltas at that width (MSB first).
+//   Width code 15 stands for 16 bits. Samples are stored as value >> shift,
+//   which drops the sensor noise floor when the budget is tight.
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t pos;                           // bytes fully written
+    uint32_t acc;
+    int bits;
+    bool overflow;
+} bit_writer_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    uint32_t acc;
+    int bits;
+    bool underflow;
+} bit_reader_t;
+
+static void bw_put(bit_writer_t *w, uint32_t value, int width) {
+    while (width > 0) {
+        int take = width > 16 ? 16 : width;
+        width -= take;
+        w->acc = (w->acc << take) | ((value >> width) & ((1u << take) - 1));
+        w->bits += take;
+        while (w->bits >= 8) {
+            w->bits -= 8;
+            if (w->pos >= w->cap) { w->overflow = true; return; }
+            w->buf[w->pos++] = (uint8_t)(w->acc >> w->bits);
+        }
+    }
+}
+
+static void bw_flush(bit_writer_t *w) {
+    if (w->bits > 0) bw_put(w, 0, 8 - w->bits);
+}
+
+static uint32_t br_get(bit_reader_t *r, int width) {
+    uint32_t value = 0;
+    while (width > 0) {
+        if (r->bits == 0) {
+            if (r->pos >= r->len) { r->underflow = true; return 0; }
+            r->acc = r->buf[r->pos++];
+            r->bits = 8;
+        }
+        int take = width < r->bits ? width : r->bits;
+        r->bits -= take;
+        width -= take;
+        value = (value << take) | ((r->acc >> r->bits) & ((1u << take) - 1));
+    }
+    return value;
+}
+
+static inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static inline int width_of(uint32_t v) {
+    int w = 0;
+    while (v) { w++; v >>= 1; }
+    return w;
+}
+
+static inline int width_code(int w) { return w >= 15 ? 15 : w; }
+static inline int code_width(int c) { return c == 15 ? 16 : c; }
+
+static uint32_t isqrt32(uint32_t v) {
+    uint32_t r = 0, bit = 1u << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else r >>= 1;
+        bit >>= 2;
+    }
+    return r;
+}
+
+static inline int16_t clamp_mg(int32_t v) {
+    if (v > SAMPLE_LIMIT_MG) return SAMPLE_LIMIT_MG;
+    if (v < -SAMPLE_LIMIT_MG) return -SAMPLE_LIMIT_MG;
+    return (int16_t)v;
+}
+
+static inline int16_t axis_of(const accel_sample_t *s, int axis) {
+    return axis == 0 ? s->x : axis == 1 ? s->y : s->z;
+}
+
+void accel_burst_default_config(accel_burst_config_t *cfg, uint16_t sample_rate_hz) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->sample_rate_hz = sample_rate_hz;
+    cfg->threshold_mg = 1500;             // 1.5 g off the gravity vector
+    cfg->sta_samples = sample_rate_hz >= 50 ? sample_rate_hz / 50 : 1;    // 20 ms
+    cfg->lta_samples = sample_rate_hz ? (uint16_t)(sample_rate_hz * 2) : 1;  // 2 s
+    cfg->sta_lta_ratio_q4 = 8 * 16;
+    cfg->min_sta_mg = 250;
+    cfg->refractory_ms = 2000;
+    cfg->baseline_shift = 9;
+}
+
+void accel_burst_init(accel_burst_t *ab, const accel_burst_config_t *cfg) {
+    memset(ab, 0, sizeof(*ab));
+    ab->cfg = *cfg;
+    if (ab->cfg.sta_samples == 0) ab->cfg.sta_samples = 1;
+    if (ab->cfg.lta_samples == 0) ab->cfg.lta_samples = 1;
+    ab->warmup = ab->cfg.lta_samples > ACCEL_BURST_PRE_TRIGGER ? ab->cfg.lta_samples
+                                                               : ACCEL_BURST_PRE_TRIGGER;
+    ab->last_trigger_at = UINT32_MAX;
+}
+
+static void freeze_burst(accel_burst_t *ab) {
+    if (ab->pending) {
+        ab->dropped++;
+        if (ab->burst_peak_mg >= ab->capture_peak_mg) return;   // keep the stronger shock
+    }
+    uint32_t start = ab->trigger_at - ACCEL_BURST_PRE_TRIGGER;
+    for (uint32_t i = 0; i < ACCEL_BURST_WINDOW; i++) {
+        ab->burst[i] = ab->ring[(start + i) & RING_MASK];
+    }
+    ab->burst_peak_mg = ab->capture_peak_mg;
+    ab->burst_trigger_at = ab->trigger_at;
+    ab->pending = true;
+}
+
+bool accel_burst_push(accel_burst_t *ab, accel_sample_t s) {
+    s.x = clamp_mg(s.x);
+    s.y = clamp_mg(s.y);
+    s.z = clamp_mg(s.z);
+
+    uint32_t index = ab->head++;
+    ab->ring[index & RING_MASK] = s;
+
+    if (index == 0) {
+        for (int axis = 0; axis < 3; axis++) ab->base_q8[axis] = (int32_t)axis_of(&s, axis) * 256;
+    }
+
+    // Squared deviation from the gravity baseline, mg^2
+    uint32_t energy = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t d = ((int32_t)axis_of(&s, axis) * 256 - ab->base_q8[axis]) / 256;
+        energy += (uint32_t)(d * d);
+    }
+    uint32_t dev_mg = isqrt32(energy);
+
+    if (ab->capturing) {
+        if (dev_mg > ab->capture_peak_mg) ab->capture_peak_mg = (uint16_t)dev_mg;
+        ab->sta_mg2 += (uint32_t)(((int64_t)energy - ab->sta_mg2) / ab->cfg.sta_samples);
+        if (index - ab->trigger_at + 1 >= ACCEL_BURST_POST_TRIGGER) {
+            ab->capturing = false;
+            ab->events++;
+            freeze_burst(ab);
+            return true;
+        }
+        return false;
+    }
+
+    // Baseline and long-term energy only track quiet periods
+    for (int axis = 0; axis < 3; axis++) {
+        ab->base_q8[axis] += ((int32_t)axis_of(&s, axis) * 256 - ab->base_q8[axis]) >> ab->cfg.baseline_shift;
+    }
+    ab->sta_mg2 += (uint32_t)(((int64_t)energy - ab->sta_mg2) / ab->cfg.sta_samples);
+
+    if (index < ab->warmup) {
+        ab->lta_mg2 += (uint32_t)(((int64_t)energy - ab->lta_mg2) / ab->cfg.lta_samples);
+        return false;
+    }
+
+    uint32_t refractory = (uint32_t)ab->cfg.refractory_ms * ab->cfg.sample_rate_hz / 1000;
+    bool armed = ab->last_trigger_at == UINT32_MAX || index - ab->last_trigger_at >= refractory;
+
+    uint32_t thr = ab->cfg.threshold_mg;
+    uint32_t min_sta = (uint32_t)ab->cfg.min_sta_mg * ab->cfg.min_sta_mg;
+    bool over_threshold = thr > 0 && energy >= thr * thr;
+    bool energy_jump = ab->sta_mg2 >= min_sta &&
+                       (uint64_t)ab->sta_mg2 * 16 >= (uint64_t)ab->lta_mg2 * ab->cfg.sta_lta_ratio_q4;
+
+    if (armed && (over_threshold || energy_jump)) {
+        ab->capturing = true;
+        ab->trigger_at = index;
+        ab->last_trigger_at = index;
+        ab->capture_peak_mg = (uint16_t)(dev_mg > UINT16_MAX ? UINT16_MAX : dev_mg);
+        return false;
+    }
+
+    ab->lta_mg2 += (uint32_t)(((int64_t)energy - ab->lta_mg2) / ab->cfg.lta_samples);
+    return false;
+}
+
+void accel_burst_latest(const accel_burst_t *ab, float *x, float *y, float *z) {
+    if (ab->head == 0) {
+        *x = *y = *z = 0.0f;
+        return;
+    }
+    const accel_sample_t *s = &ab->ring[(ab->head - 1) & RING_MASK];
+    *x = (float)s->x;
+    *y = (float)s->y;
+    *z = (float)s->z;
+}
+
+size_t accel_burst_encode(const accel_sample_t *samples, size_t n, size_t pre_trigger,
+                          uint16_t sample_rate_hz, uint16_t peak_mg, uint32_t age_ms,
+                          uint8_t decimation, uint8_t quant_shift, uint8_t *out, size_t budget) {
+    int log2_dec = decimation == 8 ? 3 : decimation == 4 ? 2 : decimation == 2 ? 1 : 0;
+    size_t d = (size_t)1 << log2_dec;
+    size_t count = n / d;
+    if (count == 0 || count > UINT16_MAX || quant_shift > ACCEL_BURST_MAX_QUANT_SHIFT ||
+        budget < ACCEL_BURST_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint32_t age_ds = age_ms / 100;
+    if (age_ds > UINT16_MAX) age_ds = UINT16_MAX;
+    size_t pre = pre_trigger / d;
+    uint16_t rate = (uint16_t)(sample_rate_hz / d);
+
+    out[0] = (uint8_t)(ACCEL_BURST_VERSION << 5 | log2_dec << 3 | quant_shift);
+    out[1] = (uint8_t)(pre > 255 ? 255 : pre);
+    out[2] = rate >> 8;   out[3] = rate & 0xFF;
+    out[4] = (uint8_t)(count >> 8); out[5] = count & 0xFF;
+    out[6] = peak_mg >> 8; out[7] = peak_mg & 0xFF;
+    out[8] = (uint8_t)(age_ds >> 8); out[9] = age_ds & 0xFF;
+
+    bit_writer_t w = { out, budget, ACCEL_BURST_HEADER_SIZE, 0, 0, false };
+
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t prev = 0;
+        uint32_t deltas[ACCEL_BURST_BLOCK];
+        size_t i = 0;
+        while (i < count) {
+            size_t block = 0;
+            int width = 0;
+            while (block < ACCEL_BURST_BLOCK && i < count) {
+                // Box-filter decimation keeps the shock energy in band
+                int32_t sum = 0;
+                for (size_t k = 0; k < d; k++) sum += axis_of(&samples[i * d + k], axis);
+                int32_t value = (sum / (int32_t)d) >> quant_shift;
+
+                if (i == 0) {
+                    bw_put(&w, (uint16_t)(int16_t)value, 16);
+                } else {
+                    deltas[block] = zigzag(value - prev);
+                    int wv = width_of(deltas[block]);
+                    if (wv > width) width = wv;
+                    block++;
+                }
+                prev = value;
+                i++;
+            }
+            if (block == 0) continue;
+            int code = width_code(width);
+            bw_put(&w, (uint32_t)code, 4);
+            for (size_t b = 0; b < block; b++) bw_put(&w, deltas[b], code_width(code));
+        }
+    }
+    bw_flush(&w);
+    return w.overflow ? 0 : w.pos;
+}
+
+size_t accel_burst_take(accel_burst_t *ab, uint8_t *out, size_t budget) {
+    if (!ab->pending) return 0;
+
+    uint32_t age_ms = (uint32_t)((uint64_t)(ab->head - ab->burst_trigger_at) * 1000 /
+                                 (ab->cfg.sample_rate_hz ? ab->cfg.sample_rate_hz : 1));
+    size_t size = 0;
+
+    // Time resolution matters more than amplitude resolution for impacts:
+    // coarsen the amplitude first, then halve the rate
+    for (uint8_t d = 1; d <= 8 && size == 0; d <<= 1) {
+        for (uint8_t q = 0; q <= ACCEL_BURST_MAX_QUANT_SHIFT && size == 0; q++) {
+            size = accel_burst_encode(ab->burst, ACCEL_BURST_WINDOW, ACCEL_BURST_PRE_TRIGGER,
+                                      ab->cfg.sample_rate_hz, ab->burst_peak_mg, age_ms, d, q,
+                                      out, budget);
+        }
+    }
+
+    // Still too large: trim the tail of the window, keep the onset
+    size_t n = ACCEL_BURST_WINDOW;
+    while (size == 0 && n > ACCEL_BURST_PRE_TRIGGER + 32) {
+        n = n * 3 / 4;
+        size = accel_burst_encode(ab->burst, n, ACCEL_BURST_PRE_TRIGGER, ab->cfg.sample_rate_hz,
+                                  ab->burst_peak_mg, age_ms, 8, ACCEL_BURST_MAX_QUANT_SHIFT,
+                                  out, budget);
+    }
+
+    ab->pending = false;
+    return size;
+}
+
+size_t accel_burst_decode(const uint8_t *in, size_t len, accel_burst_info_t *info,
+                          accel_sample_t *samples, size_t max_samples) {
+    if (len < ACCEL_BURST_HEADER_SIZE || (in[0] >> 5) != ACCEL_BURST_VERSION) return 0;
+
+    accel_burst_info_t hdr;
+    hdr.decimation = (uint8_t)(1u << ((in[0] >> 3) & 0x3));
+    hdr.quant_shift = in[0] & 0x7;
+    hdr.pre_trigger = in[1];
+    hdr.sample_rate_hz = (uint16_t)(in[2] << 8 | in[3]);
+    hdr.n_samples = (uint16_t)(in[4] << 8 | in[5]);
+    hdr.peak_mg = (uint16_t)(in[6] << 8 | in[7]);
+    hdr.age_ms = (uint32_t)(in[8] << 8 | in[9]) * 100;
+    if (info) *info = hdr;
+    if (hdr.n_samples == 0 || hdr.quant_shift > ACCEL_BURST_MAX_QUANT_SHIFT) return 0;
+    int32_t half_step = hdr.quant_shift ? 1 << (hdr.quant_shift - 1) : 0;
+    // Quantized range of an int16 sample; a value outside it only comes from a
+    // corrupt or hostile burst and would overflow the running sum
+    int32_t lo = -(32768 >> hdr.quant_shift), hi = 32767 >> hdr.quant_shift;
+
+    bit_reader_t r = { in, len, ACCEL_BURST_HEADER_SIZE, 0, 0, false };
+
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t value = (int16_t)br_get(&r, 16);
+        int width = 0;
+        for (size_t i = 0; i < hdr.n_samples; i++) {
+            if (i > 0) {
+                if ((i - 1) % ACCEL_BURST_BLOCK == 0) width = code_width((int)br_get(&r, 4));
+                value += unzigzag(br_get(&r, width));
+            }
+            if (value < lo || value > hi) return 0;
+            if (i < max_samples && samples) {
+                int16_t mg = (int16_t)(value * (1 << hdr.quant_shift) + half_step);
+                if (axis == 0) samples[i].x = mg;
+                else if (axis == 1) samples[i].y = mg;
+                else samples[i].z = mg;
+            }
+        }
+    }
+    return r.underflow ? 0 : hdr.n_samples;
+}
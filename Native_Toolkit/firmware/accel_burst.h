@@ -0,0 +1,126 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// High-rate accelerometer capture with shock-event burst encoding.
+//
+// Samples (mg, int16 per axis) are pushed at the sensor rate into a ring
+// buffer. A slow EMA tracks the gravity baseline; an event fires when the
+// deviation from it crosses a threshold or when short-term energy rises
+// above the long-term average (STA/LTA). The pre- and post-trigger window
+// is frozen into a burst that the uplink path encodes (delta + block
+// bit-packing) and attaches only while one is pending.
+//
+// Pure C, no ESP-IDF dependencies: the same file builds into the ESP32
+// firmware and into the host simulator (tools/accel_burst_sim.c).
+// The caller serializes access between the sampling and uplink tasks.
+
+#ifndef ACCEL_BURST_H
+#define ACCEL_BURST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define ACCEL_BURST_RING_SAMPLES 512      // power of two, ~1.3 s at 400 Hz
+#define ACCEL_BURST_PRE_TRIGGER 64        // samples kept before the trigger
+#define ACCEL_BURST_POST_TRIGGER 192      // samples captured after the trigger
+#define ACCEL_BURST_WINDOW (ACCEL_BURST_PRE_TRIGGER + ACCEL_BURST_POST_TRIGGER)
+#define ACCEL_BURST_MAX_BYTES 96          // default uplink budget for one burst
+#define ACCEL_BURST_BLOCK 16              // deltas sharing one bit width
+#define ACCEL_BURST_HEADER_SIZE 10
+#define ACCEL_BURST_MAX_QUANT_SHIFT 5      // coarsest amplitude step, 32 mg
+#define ACCEL_BURST_VERSION 1
+
+typedef struct {
+    int16_t x, y, z;                      // mg
+} accel_sample_t;
+
+typedef struct {
+    uint16_t sample_rate_hz;              // sensor output data rate
+    uint16_t threshold_mg;                // |a - baseline| that fires immediately
+    uint16_t sta_samples;                 // short-term energy window
+    uint16_t lta_samples;                 // long-term energy window
+    uint16_t sta_lta_ratio_q4;            // STA/LTA trigger ratio, x16
+    uint16_t min_sta_mg;                  // ignore STA/LTA below this RMS deviation
+    uint16_t refractory_ms;               // minimum spacing between events
+    uint8_t baseline_shift;               // EMA weight 1/2^shift for gravity
+} accel_burst_config_t;
+
+// Decoded burst header (receiver side / host tools)
+typedef struct {
+    uint16_t sample_rate_hz;              // after decimation
+    uint8_t decimation;                   // 1, 2, 4 or 8
+    uint8_t quant_shift;                  // amplitude step is 2^shift mg
+    uint8_t pre_trigger;                  // samples before the trigger (decimated)
+    uint16_t n_samples;                   // samples per axis (decimated)
+    uint16_t peak_mg;                     // peak deviation from baseline
+    uint32_t age_ms;                      // trigger time relative to encoding
+} accel_burst_info_t;
+
+typedef struct {
+    accel_burst_config_t cfg;
+
+    accel_sample_t ring[ACCEL_BURST_RING_SAMPLES];
+    uint32_t head;                        // total samples pushed
+
+    int32_t base_q8[3];                   // gravity baseline per axis, Q8 mg
+    uint32_t sta_mg2;                     // EMA of squared deviation, mg^2
+    uint32_t lta_mg2;
+    uint32_t warmup;                      // samples until LTA is meaningful
+
+    bool capturing;
+    uint32_t trigger_at;                  // sample index of the trigger
+    uint32_t last_trigger_at;
+    uint16_t capture_peak_mg;
+
+    bool pending;                         // burst ready for the next uplink
+    accel_sample_t burst[ACCEL_BURST_WINDOW];
+    uint16_t burst_peak_mg;
+    uint32_t burst_trigger_at;
+
+    uint32_t events;                      // statistics
+    uint32_t dropped;                     // events overwritten before uplink
+} accel_burst_t;
+
+// Fill cfg with defaults for the given sensor rate
+void accel_burst_default_config(accel_burst_config_t *cfg, uint16_t sample_rate_hz);
+
+void accel_burst_init(accel_burst_t *ab, const accel_burst_config_t *cfg);
+
+// Feed one sample; returns true when a burst has just been completed
+bool accel_burst_push(accel_burst_t *ab, accel_sample_t s);
+
+static inline bool accel_burst_pending(const accel_burst_t *ab) { return ab->pending; }
+
+// Most recent sample in mg (replaces the single-shot read_accelerometer)
+void accel_burst_latest(const accel_burst_t *ab, float *x, float *y, float *z);
+
+// Encode the pending burst into at most `budget` bytes and clear it.
+// The finest resolution that fits is used: amplitude steps of 1..32 mg at
+// full rate first, then decimation by 2, 4 and 8. Returns 0 when nothing
+// is pending or the burst cannot fit.
+size_t accel_burst_take(accel_burst_t *ab, uint8_t *out, size_t budget);
+
+// Encode an arbitrary window (used by accel_burst_take and host tools)
+size_t accel_burst_encode(const accel_sample_t *samples, size_t n, size_t pre_trigger,
+                          uint16_t sample_rate_hz, uint16_t peak_mg, uint32_t age_ms,
+                          uint8_t decimation, uint8_t quant_shift, uint8_t *out, size_t budget);
+
+// Decode a burst. Writes up to max_samples samples; returns samples per
+// axis, or 0 if the buffer is malformed.
+size_t accel_burst_decode(const uint8_t *in, size_t len, accel_burst_info_t *info,
+                          accel_sample_t *samples, size_t max_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACCEL_BURST_H
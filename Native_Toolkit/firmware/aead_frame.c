@@ -0,0 +1,510 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "aead_frame.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// A restarted receiver does not know the sender's sequence epoch; the
+// first frame of a device is tried against this many 2^16 epochs
+#define RESYNC_EPOCHS 64
+
+#define BATCH_LANES 4
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static inline void store64_le(uint8_t *p, uint64_t v) {
+    store32_le(p, (uint32_t)v);
+    store32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+// ================= CHACHA20 =================
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d)                      \
+    do {                                               \
+        a += b; d ^= a; d = ROTL32(d, 16);             \
+        c += d; b ^= c; b = ROTL32(b, 12);             \
+        a += b; d ^= a; d = ROTL32(d, 8);              \
+        c += d; b ^= c; b = ROTL32(b, 7);              \
+    } while (0)
+
+#define DOUBLE_ROUND(x)                                \
+    do {                                               \
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);        \
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);        \
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);       \
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);       \
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);       \
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);       \
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);        \
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);        \
+    } while (0)
+
+static const uint32_t SIGMA[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+
+void chacha20_block(const uint8_t key[32], uint32_t counter, const uint8_t nonce[12], uint8_t out[64]) {
+    uint32_t in[16], x[16];
+    for (int i = 0; i < 4; i++) in[i] = SIGMA[i];
+    for (int i = 0; i < 8; i++) in[4 + i] = load32_le(key + 4 * i);
+    in[12] = counter;
+    for (int i = 0; i < 3; i++) in[13 + i] = load32_le(nonce + 4 * i);
+
+    memcpy(x, in, sizeof(x));
+    for (int i = 0; i < 10; i++) DOUBLE_ROUND(x);
+    for (int i = 0; i < 16; i++) store32_le(out + 4 * i, x[i] + in[i]);
+}
+
+// Four independent blocks (own key, nonce and counter per lane)
+#if defined(__GNUC__)
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+
+static void chacha20_block_x4(const uint8_t *const keys[BATCH_LANES], const uint32_t counters[BATCH_LANES],
+                              const uint8_t *const nonces[BATCH_LANES], uint8_t out[BATCH_LANES][64]) {
+    u32x4 in[16], x[16];
+    for (int i = 0; i < 4; i++) in[i] = (u32x4){ SIGMA[i], SIGMA[i], SIGMA[i], SIGMA[i] };
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        for (int i = 0; i < 8; i++) in[4 + i][lane] = load32_le(keys[lane] + 4 * i);
+        in[12][lane] = counters[lane];
+        for (int i = 0; i < 3; i++) in[13 + i][lane] = load32_le(nonces[lane] + 4 * i);
+    }
+
+    memcpy(x, in, sizeof(x));
+    for (int i = 0; i < 10; i++) DOUBLE_ROUND(x);
+    for (int i = 0; i < 16; i++) {
+        u32x4 v = x[i] + in[i];
+        for (int lane = 0; lane < BATCH_LANES; lane++) store32_le(out[lane] + 4 * i, v[lane]);
+    }
+}
+#else
+static void chacha20_block_x4(const uint8_t *const keys[BATCH_LANES], const uint32_t counters[BATCH_LANES],
+                              const uint8_t *const nonces[BATCH_LANES], uint8_t out[BATCH_LANES][64]) {
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        chacha20_block(keys[lane], counters[lane], nonces[lane], out[lane]);
+    }
+}
+#endif
+
+// ================= POLY1305 =================
+
+// 26-bit limbs, 32x32->64 multiplies (suits the ESP32's 32-bit core)
+typedef struct {
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    uint8_t buf[16];
+    size_t left;
+} poly1305_t;
+
+static void poly1305_init(poly1305_t *st, const uint8_t key[32]) {
+    st->r[0] = load32_le(key + 0) & 0x3ffffff;
+    st->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    st->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    st->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    st->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 5; i++) st->h[i] = 0;
+    for (int i = 0; i < 4; i++) st->pad[i] = load32_le(key + 16 + 4 * i);
+    st->left = 0;
+}
+
+static void poly1305_blocks(poly1305_t *st, const uint8_t *m, size_t bytes, uint32_t hibit) {
+    const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3], r4 = st->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+
+    while (bytes >= 16) {
+        h0 += load32_le(m + 0) & 0x3ffffff;
+        h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32_le(m + 12) >> 8) | hibit;
+
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        uint32_t c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m += 16;
+        bytes -= 16;
+    }
+    st->h[0] = h0; st->h[1] = h1; st->h[2] = h2; st->h[3] = h3; st->h[4] = h4;
+}
+
+static void poly1305_update(poly1305_t *st, const uint8_t *m, size_t bytes) {
+    if (st->left) {
+        size_t want = 16 - st->left;
+        if (want > bytes) want = bytes;
+        memcpy(st->buf + st->left, m, want);
+        st->left += want;
+        m += want;
+        bytes -= want;
+        if (st->left < 16) return;
+        poly1305_blocks(st, st->buf, 16, 1u << 24);
+        st->left = 0;
+    }
+    size_t full = bytes & ~(size_t)15;
+    if (full) poly1305_blocks(st, m, full, 1u << 24);
+    if (bytes > full) {
+        memcpy(st->buf, m + full, bytes - full);
+        st->left = bytes - full;
+    }
+}
+
+static void poly1305_finish(poly1305_t *st, uint8_t tag[16]) {
+    if (st->left) {
+        st->buf[st->left] = 1;
+        memset(st->buf + st->left + 1, 0, 16 - st->left - 1);
+        poly1305_blocks(st, st->buf, 16, 0);
+    }
+
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+    uint32_t c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // h - p, selected in constant time if non-negative
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0; h1 = (h1 & mask) | g1; h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3; h4 = (h4 & mask) | g4;
+
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    uint64_t f = (uint64_t)h0 + st->pad[0];              h0 = (uint32_t)f;
+    f = (uint64_t)h1 + st->pad[1] + (f >> 32);           h1 = (uint32_t)f;
+    f = (uint64_t)h2 + st->pad[2] + (f >> 32);           h2 = (uint32_t)f;
+    f = (uint64_t)h3 + st->pad[3] + (f >> 32);           h3 = (uint32_t)f;
+    store32_le(tag + 0, h0); store32_le(tag + 4, h1);
+    store32_le(tag + 8, h2); store32_le(tag + 12, h3);
+}
+
+void poly1305_mac(const uint8_t key[32], const uint8_t *msg, size_t len, uint8_t tag[16]) {
+    poly1305_t st;
+    poly1305_init(&st, key);
+    poly1305_update(&st, msg, len);
+    poly1305_finish(&st, tag);
+}
+
+// ================= AEAD =================
+
+static const uint8_t ZERO_PAD[16];
+
+// RFC 8439 section 2.8: AAD || pad || ciphertext || pad || len(AAD) || len(ciphertext)
+static void aead_tag(const uint8_t poly_key[32], const uint8_t *aad, size_t aad_len,
+                     const uint8_t *ct, size_t ct_len, uint8_t tag[16]) {
+    poly1305_t st;
+    uint8_t lengths[16];
+    poly1305_init(&st, poly_key);
+    poly1305_update(&st, aad, aad_len);
+    poly1305_update(&st, ZERO_PAD, (16 - aad_len % 16) % 16);
+    poly1305_update(&st, ct, ct_len);
+    poly1305_update(&st, ZERO_PAD, (16 - ct_len % 16) % 16);
+    store64_le(lengths, aad_len);
+    store64_le(lengths + 8, ct_len);
+    poly1305_update(&st, lengths, sizeof(lengths));
+    poly1305_finish(&st, tag);
+}
+
+static void build_nonce(uint8_t nonce[12], uint64_t device_id, uint32_t seq) {
+    for (int i = 0; i < 8; i++) nonce[i] = (uint8_t)(device_id >> (56 - 8 * i));
+    nonce[8] = (uint8_t)(seq >> 24); nonce[9] = (uint8_t)(seq >> 16);
+    nonce[10] = (uint8_t)(seq >> 8); nonce[11] = (uint8_t)seq;
+}
+
+static bool tag_equal(const uint8_t *a, const uint8_t *b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static void xor_keystream(const uint8_t key[32], const uint8_t nonce[12], uint8_t *data, size_t len) {
+    uint8_t block[64];
+    for (uint32_t counter = 1; len > 0; counter++) {
+        chacha20_block(key, counter, nonce, block);
+        size_t n = len < 64 ? len : 64;
+        for (size_t i = 0; i < n; i++) data[i] ^= block[i];
+        data += n;
+        len -= n;
+    }
+}
+
+static inline bool valid_tag_len(uint8_t tag_len) {
+    return tag_len >= AEAD_FRAME_TAG_MIN && tag_len <= AEAD_FRAME_TAG_MAX;
+}
+
+int aead_sender_init(aead_sender_t *s, const uint8_t key[AEAD_FRAME_KEY_SIZE], uint64_t device_id,
+                     uint8_t tag_len, uint32_t first_seq) {
+    if (!valid_tag_len(tag_len)) return AEAD_ERR_PARAM;
+    memcpy(s->key, key, AEAD_FRAME_KEY_SIZE);
+    s->device_id = device_id;
+    s->tag_len = tag_len;
+    s->next_seq = first_seq;
+    return AEAD_OK;
+}
+
+int aead_peer_init(aead_peer_t *p, const uint8_t key[AEAD_FRAME_KEY_SIZE], uint64_t device_id,
+                   uint8_t tag_len) {
+    if (!valid_tag_len(tag_len)) return AEAD_ERR_PARAM;
+    memset(p, 0, sizeof(*p));
+    memcpy(p->key, key, AEAD_FRAME_KEY_SIZE);
+    p->device_id = device_id;
+    p->tag_len = tag_len;
+    return AEAD_OK;
+}
+
+int aead_frame_seal(aead_sender_t *s, uint8_t *frame, size_t payload_len, size_t cap) {
+    if (payload_len > AEAD_FRAME_MAX_PAYLOAD || cap < payload_len + AEAD_FRAME_OVERHEAD(s->tag_len)) {
+        return AEAD_ERR_PARAM;
+    }
+    // A nonce must never repeat under one key
+    if (s->next_seq == UINT32_MAX) return AEAD_ERR_SEQ_EXHAUSTED;
+    uint32_t seq = s->next_seq++;
+
+    uint8_t nonce[12], block0[64], tag[16];
+    frame[0] = (uint8_t)(seq >> 8);
+    frame[1] = (uint8_t)seq;
+    build_nonce(nonce, s->device_id, seq);
+
+    uint8_t *payload = frame + AEAD_FRAME_HEADER_SIZE;
+    xor_keystream(s->key, nonce, payload, payload_len);
+    chacha20_block(s->key, 0, nonce, block0);
+    aead_tag(block0, frame, AEAD_FRAME_HEADER_SIZE, payload, payload_len, tag);
+    memcpy(payload + payload_len, tag, s->tag_len);
+
+    return (int)(payload_len + AEAD_FRAME_OVERHEAD(s->tag_len));
+}
+
+uint32_t aead_frame_expand_seq(uint32_t reference, uint16_t seq_lo) {
+    int64_t candidate = (int64_t)((reference & 0xFFFF0000u) | seq_lo);
+    int64_t ref = reference;
+    if (candidate < ref - 0x8000 && candidate + 0x10000 <= UINT32_MAX) candidate += 0x10000;
+    else if (candidate > ref + 0x8000 && candidate >= 0x10000) candidate -= 0x10000;
+    return (uint32_t)candidate;
+}
+
+static int replay_check(const aead_peer_t *p, uint32_t seq) {
+    if (!p->seen || seq > p->highest_seq) return AEAD_OK;
+    uint32_t age = p->highest_seq - seq;
+    if (age >= AEAD_FRAME_REPLAY_WINDOW || ((p->window >> age) & 1)) return AEAD_ERR_REPLAY;
+    return AEAD_OK;
+}
+
+static void replay_accept(aead_peer_t *p, uint32_t seq) {
+    if (!p->seen) {
+        p->seen = true;
+        p->highest_seq = seq;
+        p->window = 1;
+    } else if (seq > p->highest_seq) {
+        uint32_t shift = seq - p->highest_seq;
+        p->window = shift >= AEAD_FRAME_REPLAY_WINDOW ? 1 : (p->window << shift) | 1;
+        p->highest_seq = seq;
+    } else {
+        p->window |= (uint64_t)1 << (p->highest_seq - seq);
+    }
+    p->accepted++;
+}
+
+static bool verify_seq(const aead_peer_t *p, const uint8_t *frame, size_t ct_len, uint32_t seq,
+                       uint8_t nonce[12]) {
+    uint8_t block0[64], tag[16];
+    build_nonce(nonce, p->device_id, seq);
+    chacha20_block(p->key, 0, nonce, block0);
+    aead_tag(block0, frame, AEAD_FRAME_HEADER_SIZE, frame + AEAD_FRAME_HEADER_SIZE, ct_len, tag);
+    return tag_equal(tag, frame + AEAD_FRAME_HEADER_SIZE + ct_len, p->tag_len);
+}
+
+int aead_frame_open(aead_peer_t *p, uint8_t *frame, size_t len, uint8_t **payload) {
+    if (len < AEAD_FRAME_OVERHEAD(p->tag_len) ||
+        len - AEAD_FRAME_OVERHEAD(p->tag_len) > AEAD_FRAME_MAX_PAYLOAD) {
+        return AEAD_ERR_PARAM;
+    }
+    size_t ct_len = len - AEAD_FRAME_OVERHEAD(p->tag_len);
+    uint16_t seq_lo = (uint16_t)(frame[0] << 8 | frame[1]);
+    uint32_t seq = aead_frame_expand_seq(p->seen ? p->highest_seq : 0, seq_lo);
+
+    int rc = replay_check(p, seq);
+    if (rc != AEAD_OK) { p->replays++; return rc; }
+
+    uint8_t nonce[12];
+    bool ok = verify_seq(p, frame, ct_len, seq, nonce);
+    for (uint32_t epoch = 1; !ok && !p->seen && epoch < RESYNC_EPOCHS; epoch++) {
+        seq = epoch << 16 | seq_lo;
+        ok = verify_seq(p, frame, ct_len, seq, nonce);
+    }
+    if (!ok) { p->auth_failures++; return AEAD_ERR_AUTH; }
+
+    replay_accept(p, seq);
+    *payload = frame + AEAD_FRAME_HEADER_SIZE;
+    xor_keystream(p->key, nonce, *payload, ct_len);
+    return (int)ct_len;
+}
+
+// ================= BATCH =================
+
+typedef struct {
+    aead_peer_t *peer;
+    uint32_t seq;
+    size_t index;
+} batch_entry_t;
+
+static int compare_entries(const void *a, const void *b) {
+    const batch_entry_t *x = a, *y = b;
+    if (x->peer != y->peer) return x->peer < y->peer ? -1 : 1;
+    if (x->seq != y->seq) return x->seq < y->seq ? -1 : 1;
+    return 0;
+}
+
+// Internal markers, never returned (payload lengths are >= 0, errors > -100)
+#define STATUS_PENDING -100               // verified, waiting for the replay pass
+#define STATUS_SINGLE -101                // peer not synchronized yet
+
+size_t aead_frame_open_batch(aead_peer_t *const peers[], uint8_t *const frames[],
+                             const size_t lens[], size_t n, uint8_t *payloads[], int status[]) {
+    uint32_t *seqs = malloc(n * sizeof(uint32_t));
+    batch_entry_t *accepted = malloc(n * sizeof(batch_entry_t));
+    if (n > 0 && (!seqs || !accepted)) {
+        free(seqs);
+        free(accepted);
+        for (size_t i = 0; i < n; i++) status[i] = aead_frame_open(peers[i], frames[i], lens[i], &payloads[i]);
+        size_t opened = 0;
+        for (size_t i = 0; i < n; i++) opened += status[i] >= 0;
+        return opened;
+    }
+
+    // Pass 1: header checks and sequence expansion
+    size_t lanes[BATCH_LANES];
+    size_t lane_count = 0;
+    uint8_t nonces[BATCH_LANES][12];
+    uint8_t blocks[BATCH_LANES][64];
+    size_t n_accepted = 0;
+
+    for (size_t i = 0; i <= n; i++) {
+        if (i < n) {
+            aead_peer_t *p = peers[i];
+            payloads[i] = NULL;
+            if (lens[i] < AEAD_FRAME_OVERHEAD(p->tag_len) ||
+                lens[i] - AEAD_FRAME_OVERHEAD(p->tag_len) > AEAD_FRAME_MAX_PAYLOAD) {
+                status[i] = AEAD_ERR_PARAM;
+                continue;
+            }
+            if (!p->seen) { status[i] = STATUS_SINGLE; continue; }
+            seqs[i] = aead_frame_expand_seq(p->highest_seq, (uint16_t)(frames[i][0] << 8 | frames[i][1]));
+            if (replay_check(p, seqs[i]) != AEAD_OK) {
+                p->replays++;
+                status[i] = AEAD_ERR_REPLAY;
+                continue;
+            }
+            lanes[lane_count++] = i;
+            if (lane_count < BATCH_LANES) continue;
+        }
+        if (lane_count == 0) continue;
+
+        // Pass 2: keystream for up to four frames at once, verify, decrypt
+        const uint8_t *keys[BATCH_LANES], *nonce_ptrs[BATCH_LANES];
+        uint32_t counters[BATCH_LANES];
+        size_t ct_lens[BATCH_LANES], max_blocks = 0;
+        bool verified[BATCH_LANES];
+        for (size_t l = 0; l < BATCH_LANES; l++) {
+            size_t idx = lanes[l < lane_count ? l : 0];
+            aead_peer_t *p = peers[idx];
+            build_nonce(nonces[l], p->device_id, seqs[idx]);
+            keys[l] = p->key;
+            nonce_ptrs[l] = nonces[l];
+            counters[l] = 0;
+            ct_lens[l] = lens[idx] - AEAD_FRAME_OVERHEAD(p->tag_len);
+            size_t nb = (ct_lens[l] + 63) / 64;
+            if (l < lane_count && nb > max_blocks) max_blocks = nb;
+        }
+
+        chacha20_block_x4(keys, counters, nonce_ptrs, blocks);
+        for (size_t l = 0; l < lane_count; l++) {
+            size_t idx = lanes[l];
+            uint8_t tag[16];
+            aead_tag(blocks[l], frames[idx], AEAD_FRAME_HEADER_SIZE, frames[idx] + AEAD_FRAME_HEADER_SIZE,
+                     ct_lens[l], tag);
+            verified[l] = tag_equal(tag, frames[idx] + AEAD_FRAME_HEADER_SIZE + ct_lens[l],
+                                    peers[idx]->tag_len);
+            if (!verified[l]) {
+                peers[idx]->auth_failures++;
+                status[idx] = AEAD_ERR_AUTH;
+            }
+        }
+
+        for (size_t b = 1; b <= max_blocks; b++) {
+            for (size_t l = 0; l < BATCH_LANES; l++) counters[l] = (uint32_t)b;
+            chacha20_block_x4(keys, counters, nonce_ptrs, blocks);
+            for (size_t l = 0; l < lane_count; l++) {
+                if (!verified[l] || (b - 1) * 64 >= ct_lens[l]) continue;
+                uint8_t *data = frames[lanes[l]] + AEAD_FRAME_HEADER_SIZE + (b - 1) * 64;
+                size_t len = ct_lens[l] - (b - 1) * 64;
+                if (len > 64) len = 64;
+                for (size_t k = 0; k < len; k++) data[k] ^= blocks[l][k];
+            }
+        }
+
+        for (size_t l = 0; l < lane_count; l++) {
+            if (!verified[l]) continue;
+            size_t idx = lanes[l];
+            status[idx] = STATUS_PENDING;
+            accepted[n_accepted++] = (batch_entry_t){ peers[idx], seqs[idx], idx };
+        }
+        lane_count = 0;
+    }
+
+    // Pass 3: replay window in sequence order per device (duplicates
+    // inside the batch are caught here)
+    qsort(accepted, n_accepted, sizeof(batch_entry_t), compare_entries);
+    for (size_t a = 0; a < n_accepted; a++) {
+        batch_entry_t *e = &accepted[a];
+        if (replay_check(e->peer, e->seq) != AEAD_OK) {
+            e->peer->replays++;
+            status[e->index] = AEAD_ERR_REPLAY;
+            continue;
+        }
+        replay_accept(e->peer, e->seq);
+        payloads[e->index] = frames[e->index] + AEAD_FRAME_HEADER_SIZE;
+        status[e->index] = (int)(lens[e->index] - AEAD_FRAME_OVERHEAD(e->peer->tag_len));
+    }
+
+    // Devices seen for the first time go through the resynchronizing path
+    size_t opened = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (status[i] == STATUS_SINGLE) status[i] = aead_frame_open(peers[i], frames[i], lens[i], &payloads[i]);
+        opened += status[i] >= 0;
+    }
+
+    free(seqs);
+    free(accepted);
+    return opened;
+}
@@ -0,0 +1,107 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Low-overhead authenticated encryption framing (ChaCha20-Poly1305, RFC 8439).
+//
+// Frame on the wire:
+//   [seq_lo u16 BE][ciphertext][tag, tag_len bytes]
+// The 96-bit nonce is implicit: device ID (u64 BE) || sequence (u32 BE).
+// Only the low 16 bits of the sequence are sent; the receiver rebuilds the
+// full value from the highest sequence it has accepted, and a wrong guess
+// simply fails authentication. The 2-byte header is the associated data.
+// With the default 6-byte tag the overhead is 8 bytes per frame.
+//
+// Sealing runs in place: the caller serializes the payload at
+// frame + AEAD_FRAME_HEADER_SIZE and leaves room for the tag behind it.
+// The receiver keeps a 64-frame replay window per device.
+//
+// Pure C, no ESP-IDF or mbedTLS dependency; the batch decryptor generates
+// keystream for four frames at once with GCC/Clang vector extensions.
+
+#ifndef AEAD_FRAME_H
+#define AEAD_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define AEAD_FRAME_KEY_SIZE 32
+#define AEAD_FRAME_HEADER_SIZE 2
+#define AEAD_FRAME_TAG_MIN 4
+#define AEAD_FRAME_TAG_MAX 16
+#define AEAD_FRAME_TAG_DEFAULT 6
+#define AEAD_FRAME_OVERHEAD(tag_len) ((size_t)AEAD_FRAME_HEADER_SIZE + (tag_len))
+#define AEAD_FRAME_MAX_PAYLOAD 1024
+#define AEAD_FRAME_REPLAY_WINDOW 64
+
+// Status codes
+#define AEAD_OK 0
+#define AEAD_ERR_PARAM -1                 // bad length or configuration
+#define AEAD_ERR_AUTH -2                  // tag mismatch (tampered, wrong key or wrong sequence)
+#define AEAD_ERR_REPLAY -3                // sequence already accepted or too old
+#define AEAD_ERR_SEQ_EXHAUSTED -4         // sender ran out of sequence numbers
+
+// Sender state: one per device key
+typedef struct {
+    uint8_t key[AEAD_FRAME_KEY_SIZE];
+    uint64_t device_id;
+    uint8_t tag_len;
+    uint32_t next_seq;                    // persist (with a reserve) across reboots
+} aead_sender_t;
+
+// Receiver state: one per known device
+typedef struct {
+    uint8_t key[AEAD_FRAME_KEY_SIZE];
+    uint64_t device_id;
+    uint8_t tag_len;
+    bool seen;
+    uint32_t highest_seq;
+    uint64_t window;                      // bit i set: highest_seq - i accepted
+
+    uint32_t accepted;                    // statistics
+    uint32_t auth_failures;
+    uint32_t replays;
+} aead_peer_t;
+
+// Returns AEAD_ERR_PARAM for tag lengths outside 4..16
+int aead_sender_init(aead_sender_t *s, const uint8_t key[AEAD_FRAME_KEY_SIZE], uint64_t device_id,
+                     uint8_t tag_len, uint32_t first_seq);
+int aead_peer_init(aead_peer_t *p, const uint8_t key[AEAD_FRAME_KEY_SIZE], uint64_t device_id,
+                   uint8_t tag_len);
+
+// Seal in place. frame holds payload_len bytes at frame + AEAD_FRAME_HEADER_SIZE
+// and has cap bytes in total. Returns the frame length, or a negative status.
+int aead_frame_seal(aead_sender_t *s, uint8_t *frame, size_t payload_len, size_t cap);
+
+// Open in place. On success *payload points into frame and the replay
+// window advances. Returns the payload length, or a negative status.
+int aead_frame_open(aead_peer_t *p, uint8_t *frame, size_t len, uint8_t **payload);
+
+// Open n frames in place (peers[i] may repeat). Keystream for up to four
+// frames is generated per pass; frames of a synchronized device are
+// accepted in sequence order, the first frames of a device in array order.
+// status[i] receives the payload length or a negative status, payloads[i]
+// the payload pointer. Returns the number opened.
+size_t aead_frame_open_batch(aead_peer_t *const peers[], uint8_t *const frames[],
+                             const size_t lens[], size_t n, uint8_t *payloads[], int status[]);
+
+// Full sequence from the 16 bits on the wire, closest to the reference
+uint32_t aead_frame_expand_seq(uint32_t reference, uint16_t seq_lo);
+
+// Primitives (benchmarks, cross-checks)
+void chacha20_block(const uint8_t key[32], uint32_t counter, const uint8_t nonce[12], uint8_t out[64]);
+void poly1305_mac(const uint8_t key[32], const uint8_t *msg, size_t len, uint8_t tag[16]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AEAD_FRAME_H
@@ -0,0 +1,239 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "alloc_track.h"
+
+#include <string.h>
+
+#if defined(ESP_PLATFORM) && defined(CONFIG_HEAP_USE_HOOKS)
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#define ALLOC_TRACK_IRAM IRAM_ATTR            // the heap may call the hooks with the cache off
+#else
+#define ALLOC_TRACK_IRAM
+#endif
+
+typedef struct {
+    int depth;                                // may exceed ALLOC_TRACK_MAX_DEPTH
+    uint8_t stack[ALLOC_TRACK_MAX_DEPTH];
+    int64_t base[ALLOC_TRACK_MAX_DEPTH];      // thread's live bytes at entry
+    int64_t live;                             // allocated minus freed by this thread
+} thread_state_t;
+
+static alloc_track_stage_t stages[ALLOC_TRACK_MAX_STAGES] = { { .name = "other" } };
+static int64_t live_bytes;
+static _Thread_local thread_state_t tls;
+
+// ================= HELPERS =================
+static ALLOC_TRACK_IRAM void atomic_max(uint64_t *slot, uint64_t v) {
+    uint64_t cur = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    while (v > cur && !__atomic_compare_exchange_n(slot, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static ALLOC_TRACK_IRAM int current_depth(const thread_state_t *t) {
+    return t->depth < ALLOC_TRACK_MAX_DEPTH ? t->depth : ALLOC_TRACK_MAX_DEPTH;
+}
+
+// ================= STAGES =================
+int alloc_track_stage(const char *name) {
+    for (int i = 0; i < ALLOC_TRACK_MAX_STAGES; i++) {
+        const char *cur = __atomic_load_n(&stages[i].name, __ATOMIC_ACQUIRE);
+        if (!cur) {
+            // Claim the free slot; another thread may take it first
+            if (__atomic_compare_exchange_n(&stages[i].name, &cur, name, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+                return i;
+        }
+        if (!strcmp(cur, name)) return i;
+    }
+    return -1;
+}
+
+void alloc_track_enter(int stage) {
+    thread_state_t *t = &tls;
+    if (stage <= 0 || stage >= ALLOC_TRACK_MAX_STAGES) stage = ALLOC_TRACK_OTHER;
+    if (t->depth < ALLOC_TRACK_MAX_DEPTH) {
+        t->stack[t->depth] = (uint8_t)stage;
+        t->base[t->depth] = t->live;
+    }
+    t->depth++;
+    __atomic_add_fetch(&stages[stage].calls, 1, __ATOMIC_RELAXED);
+}
+
+void alloc_track_leave(void) {
+    thread_state_t *t = &tls;
+    if (t->depth == 0) return;
+    t->depth--;
+    if (t->depth < ALLOC_TRACK_MAX_DEPTH) {
+        uint8_t stage = t->stack[t->depth];
+        if (stage != ALLOC_TRACK_OTHER)
+            __atomic_add_fetch(&stages[stage].retained, t->live - t->base[t->depth], __ATOMIC_RELAXED);
+    }
+}
+
+void alloc_track_reset(void) {
+    for (int i = 0; i < ALLOC_TRACK_MAX_STAGES; i++) {
+        alloc_track_stage_t *s = &stages[i];
+        __atomic_store_n(&s->calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->allocs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->frees, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->bytes, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->freed, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->retained, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->peak, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->largest, 0, __ATOMIC_RELAXED);
+    }
+    // Stage 0's high-water mark restarts from what is allocated now
+    int64_t live = __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&stages[0].peak, live > 0 ? (uint64_t)live : 0, __ATOMIC_RELAXED);
+}
+
+size_t alloc_track_snapshot(alloc_track_stage_t *out, size_t cap) {
+    size_t n = 0;
+    for (int i = 0; i < ALLOC_TRACK_MAX_STAGES; i++) {
+        alloc_track_stage_t *s = &stages[i];
+        const char *name = __atomic_load_n(&s->name, __ATOMIC_ACQUIRE);
+        if (!name) break;
+        if (n < cap) {
+            alloc_track_stage_t *o = &out[n];
+            o->name = name;
+            o->calls = __atomic_load_n(&s->calls, __ATOMIC_RELAXED);
+            o->allocs = __atomic_load_n(&s->allocs, __ATOMIC_RELAXED);
+            o->frees = __atomic_load_n(&s->frees, __ATOMIC_RELAXED);
+            o->bytes = __atomic_load_n(&s->bytes, __ATOMIC_RELAXED);
+            o->freed = __atomic_load_n(&s->freed, __ATOMIC_RELAXED);
+            o->retained = __atomic_load_n(&s->retained, __ATOMIC_RELAXED);
+            o->peak = __atomic_load_n(&s->peak, __ATOMIC_RELAXED);
+            o->largest = __atomic_load_n(&s->largest, __ATOMIC_RELAXED);
+        }
+        n++;
+    }
+    return n;
+}
+
+int64_t alloc_track_live(void) {
+    return __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+}
+
+// ================= ACCOUNTING =================
+ALLOC_TRACK_IRAM void alloc_track_on_alloc(size_t size) {
+    thread_state_t *t = &tls;
+    int depth = current_depth(t);
+    alloc_track_stage_t *s = &stages[depth ? t->stack[depth - 1] : ALLOC_TRACK_OTHER];
+    __atomic_add_fetch(&s->allocs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s->bytes, size, __ATOMIC_RELAXED);
+    atomic_max(&s->largest, size);
+
+    int64_t live = __atomic_add_fetch(&live_bytes, (int64_t)size, __ATOMIC_RELAXED);
+    if (live > 0) atomic_max(&stages[0].peak, (uint64_t)live);
+    t->live += (int64_t)size;
+    // Every enclosing stage sees the allocation in its own peak
+    for (int i = 0; i < depth; i++) {
+        int64_t above = t->live - t->base[i];
+        if (t->stack[i] != ALLOC_TRACK_OTHER && above > 0) atomic_max(&stages[t->stack[i]].peak, (uint64_t)above);
+    }
+}
+
+ALLOC_TRACK_IRAM void alloc_track_on_free(size_t size) {
+    thread_state_t *t = &tls;
+    int depth = current_depth(t);
+    alloc_track_stage_t *s = &stages[depth ? t->stack[depth - 1] : ALLOC_TRACK_OTHER];
+    __atomic_add_fetch(&s->frees, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s->freed, size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&live_bytes, (int64_t)size, __ATOMIC_RELAXED);
+    t->live -= (int64_t)size;
+}
+
+// ================= HOOKS =================
+#if defined(ALLOC_TRACK_MALLOC_HOOKS)
+#include <errno.h>
+#include <malloc.h>
+#include <stdlib.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t align, size_t size);
+extern void __libc_free(void *ptr);
+
+static void *tracked(void *p) {
+    if (p) alloc_track_on_alloc(malloc_usable_size(p));
+    return p;
+}
+
+void *malloc(size_t size) {
+    return tracked(__libc_malloc(size));
+}
+
+void *calloc(size_t n, size_t size) {
+    return tracked(__libc_calloc(n, size));
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (!ptr) return malloc(size);
+    if (!size) {
+        free(ptr);
+        return NULL;
+    }
+    size_t old = malloc_usable_size(ptr);
+    void *p = __libc_realloc(ptr, size);
+    if (p) {
+        alloc_track_on_free(old);
+        alloc_track_on_alloc(malloc_usable_size(p));
+    }
+    return p;
+}
+
+void free(void *ptr) {
+    if (!ptr) return;
+    alloc_track_on_free(malloc_usable_size(ptr));
+    __libc_free(ptr);
+}
+
+void *memalign(size_t align, size_t size) {
+    return tracked(__libc_memalign(align, size));
+}
+
+void *aligned_alloc(size_t align, size_t size) {
+    return tracked(__libc_memalign(align, size));
+}
+
+int posix_memalign(void **out, size_t align, size_t size) {
+    if (align < sizeof(void *) || (align & (align - 1))) return EINVAL;
+    void *p = tracked(__libc_memalign(align, size));
+    if (!p) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+bool alloc_track_hooked(void) {
+    return true;
+}
+
+#elif defined(ESP_PLATFORM) && defined(CONFIG_HEAP_USE_HOOKS)
+
+IRAM_ATTR void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps) {
+    (void)size;
+    (void)caps;
+    alloc_track_on_alloc(heap_caps_get_allocated_size(ptr));
+}
+
+// Called before the block is released
+IRAM_ATTR void esp_heap_trace_free_hook(void *ptr) {
+    if (ptr) alloc_track_on_free(heap_caps_get_allocated_size(ptr));
+}
+
+bool alloc_track_hooked(void) {
+    return true;
+}
+
+#else
+
+bool alloc_track_hooked(void) {
+    return false;
+}
+
+#endif
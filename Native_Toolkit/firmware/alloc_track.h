@@ -0,0 +1,88 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Per-stage heap accounting.
+//
+// Code marks the pipeline stage it is in with alloc_track_enter() /
+// alloc_track_leave(); stages nest, and the stack is per thread (per task
+// on ESP-IDF). The allocator hooks charge every allocation and free to the
+// innermost stage of the calling thread, or to stage 0 ("other") outside
+// any stage. Sizes are the allocator's usable sizes, so they include
+// rounding but not the allocator's own headers.
+//
+// Per stage: calls, allocations, frees, bytes allocated and freed, the
+// largest block, the peak (highest heap use above the level at entry, by
+// the calling thread) and what the stage still held when it left
+// (retained). A free is charged to the stage current when it happens, so a
+// stage that frees what it allocated nets to zero. Stage 0's peak is the
+// process-wide high-water mark of tracked bytes.
+//
+// Hooks:
+//   host     build this file with -DALLOC_TRACK_MALLOC_HOOKS (glibc): it
+//            then defines malloc, calloc, realloc, free and the aligned
+//            variants on top of __libc_*, so allocations made inside shared
+//            libraries (zlib) are counted as well
+//   ESP-IDF  enable CONFIG_HEAP_USE_HOOKS: this file then defines
+//            esp_heap_trace_alloc_hook / esp_heap_trace_free_hook for every
+//            heap_caps allocation (malloc, new, Arduino String, libcbor)
+// Without either, alloc_track_hooked() is false and only the stage calls
+// are counted. Counters are atomic; the hooks never allocate.
+
+#ifndef ALLOC_TRACK_H
+#define ALLOC_TRACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define ALLOC_TRACK_MAX_STAGES 24
+#define ALLOC_TRACK_MAX_DEPTH 8               // deeper stages are charged to the 8th
+
+#define ALLOC_TRACK_OTHER 0                   // allocations outside any stage
+
+typedef struct {
+    const char *name;
+    uint64_t calls;                           // alloc_track_enter() count
+    uint64_t allocs, frees;                   // a realloc counts as one of each
+    uint64_t bytes, freed;
+    int64_t retained;                         // still held when the stage left, summed
+    uint64_t peak;                            // bytes above the level at entry
+    uint64_t largest;                         // largest single block
+} alloc_track_stage_t;
+
+// Id of the named stage, registered on first use (the name is not
+// copied). -1 when the table is full.
+int alloc_track_stage(const char *name);
+
+void alloc_track_enter(int stage);
+void alloc_track_leave(void);
+
+// Zeroes every counter; stage names stay registered
+void alloc_track_reset(void);
+
+// Copies up to cap stages (stage 0 first); returns the number registered
+size_t alloc_track_snapshot(alloc_track_stage_t *out, size_t cap);
+
+// Tracked bytes currently allocated, all threads
+int64_t alloc_track_live(void);
+
+// Whether allocator hooks are compiled in
+bool alloc_track_hooked(void);
+
+// Called by the hooks, or by a custom allocator, with usable sizes
+void alloc_track_on_alloc(size_t size);
+void alloc_track_on_free(size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ALLOC_TRACK_H
@@ -0,0 +1,129 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "batch_frame.h"
+
+#include <string.h>
+
+#define KNOWN_FLAGS (BATCH_FLAG_FORMAT | BATCH_FLAG_DEVICE)
+
+static size_t varint_size(size_t v) {
+    return v < (1u << 7) ? 1 : v < (1u << 14) ? 2 : 3;
+}
+
+// ================= BUILDER =================
+
+size_t batch_item_size(uint8_t flags, size_t device_id_len, size_t payload_len) {
+    return ((flags & BATCH_FLAG_FORMAT) ? 1 : 0) + ((flags & BATCH_FLAG_DEVICE) ? 1 + device_id_len : 0) +
+           varint_size(payload_len) + payload_len;
+}
+
+int batch_builder_init(batch_builder_t *b, uint8_t *buf, size_t cap, uint8_t flags) {
+    if (!b || !buf || (flags & ~KNOWN_FLAGS)) return BATCH_FRAME_ERR_PARAM;
+    if (cap < BATCH_FRAME_HEADER_SIZE) return BATCH_FRAME_ERR_SPACE;
+    b->buf = buf;
+    b->cap = cap;
+    b->flags = flags;
+    b->count = 0;
+    b->len = BATCH_FRAME_HEADER_SIZE;
+    buf[0] = BATCH_FRAME_MAGIC;
+    buf[1] = flags;
+    buf[2] = buf[3] = 0;
+    return BATCH_FRAME_OK;
+}
+
+int batch_builder_add(batch_builder_t *b, uint8_t format, const uint8_t *device_id, size_t device_id_len,
+                      const uint8_t *payload, size_t payload_len) {
+    if (payload_len > BATCH_FRAME_MAX_PAYLOAD || (payload_len && !payload)) return BATCH_FRAME_ERR_PARAM;
+    if (b->flags & BATCH_FLAG_DEVICE) {
+        if (device_id_len > BATCH_FRAME_MAX_DEVICE_ID || (device_id_len && !device_id)) return BATCH_FRAME_ERR_PARAM;
+    }
+    if (b->count == BATCH_FRAME_MAX_ITEMS) return BATCH_FRAME_ERR_SPACE;
+    if (batch_item_size(b->flags, device_id_len, payload_len) > b->cap - b->len) return BATCH_FRAME_ERR_SPACE;
+
+    uint8_t *p = b->buf + b->len;
+    if (b->flags & BATCH_FLAG_FORMAT) *p++ = format;
+    if (b->flags & BATCH_FLAG_DEVICE) {
+        *p++ = (uint8_t)device_id_len;
+        if (device_id_len) memcpy(p, device_id, device_id_len);
+        p += device_id_len;
+    }
+    size_t v = payload_len;
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    if (payload_len) memcpy(p, payload, payload_len);
+    p += payload_len;
+
+    b->len = (size_t)(p - b->buf);
+    b->count++;
+    b->buf[2] = (uint8_t)(b->count >> 8);
+    b->buf[3] = (uint8_t)b->count;
+    return BATCH_FRAME_OK;
+}
+
+size_t batch_builder_finish(const batch_builder_t *b) {
+    return b->len;
+}
+
+// ================= READER =================
+
+int batch_reader_init(batch_reader_t *r, const uint8_t *frame, size_t len) {
+    if (!r || !frame) return BATCH_FRAME_ERR_PARAM;
+    if (len < BATCH_FRAME_HEADER_SIZE || frame[0] != BATCH_FRAME_MAGIC || (frame[1] & ~KNOWN_FLAGS))
+        return BATCH_FRAME_ERR_FORMAT;
+    r->frame = frame;
+    r->len = len;
+    r->pos = BATCH_FRAME_HEADER_SIZE;
+    r->flags = frame[1];
+    r->count = (uint16_t)(frame[2] << 8 | frame[3]);
+    r->index = 0;
+    return BATCH_FRAME_OK;
+}
+
+int batch_reader_next(batch_reader_t *r, batch_item_t *item) {
+    if (r->index == r->count) return r->pos == r->len ? BATCH_FRAME_ERR_END : BATCH_FRAME_ERR_FORMAT;
+    const uint8_t *p = r->frame + r->pos, *end = r->frame + r->len;
+
+    item->format = BATCH_FORMAT_DEFAULT;
+    if (r->flags & BATCH_FLAG_FORMAT) {
+        if (p == end) return BATCH_FRAME_ERR_FORMAT;
+        item->format = *p++;
+    }
+    item->device_id_len = 0;
+    item->device_id = NULL;
+    if (r->flags & BATCH_FLAG_DEVICE) {
+        if (p == end || (size_t)(end - p) < 1u + p[0]) return BATCH_FRAME_ERR_FORMAT;
+        item->device_id_len = *p++;
+        item->device_id = p;
+        p += item->device_id_len;
+    }
+    size_t length = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (p == end || shift == 21) return BATCH_FRAME_ERR_FORMAT;
+        uint8_t byte = *p++;
+        length |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if ((size_t)(end - p) < length) return BATCH_FRAME_ERR_FORMAT;
+    item->payload = p;
+    item->payload_len = length;
+
+    r->pos = (size_t)(p + length - r->frame);
+    r->index++;
+    return BATCH_FRAME_OK;
+}
+
+int batch_status_parse(const uint8_t *reply, size_t len, const uint8_t **status) {
+    if (!reply || !status) return BATCH_FRAME_ERR_PARAM;
+    if (len < 2) return BATCH_FRAME_ERR_FORMAT;
+    int count = reply[0] << 8 | reply[1];
+    if (len != 2 + BATCH_STATUS_BYTES(count)) return BATCH_FRAME_ERR_FORMAT;
+    *status = reply + 2;
+    return count;
+}
@@ -0,0 +1,143 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Many payloads in one request, for POST /container-data/batch.
+//
+// A gateway or a store-and-forward device that comes back online holds
+// hundreds of queued payloads; sent one per request, each pays for its own
+// HTTP exchange (and TLS record, proxy hop, radio wake-up). A batch frame
+// carries them all:
+//   [0xB1][flags u8][count u16 BE] then count items of
+//   [format u8]        if flags & BATCH_FLAG_FORMAT
+//   [id_len u8][id]    if flags & BATCH_FLAG_DEVICE
+//   [length, LEB128 varint of at most 3 bytes][payload]
+// Payloads are the bytes /container-data takes, unchanged. The format tag
+// overrides the endpoint's codec per item (0 keeps it); the device ID
+// replaces the X-Device-Id header per item (session frames need one).
+//
+// The receiver answers with one 2-bit status per item, four items per
+// byte, item i in byte i / 4 at bit 2 * (i % 4):
+//   [count u16 BE][status bytes]     (Accept: application/octet-stream)
+// or the same bytes in base64 in the JSON reply. An item marked retry was
+// shed by admission control and is sent again later; an item marked
+// resync is a session frame whose device waits for a keyframe.
+//
+// Builder and parser work in caller buffers, no allocation. The first byte
+// is never 0x78 (zlib), 0xA? (rANS) or 0xC? (session), so the single
+// payload endpoint can tell a batch sent to it by mistake.
+
+#ifndef BATCH_FRAME_H
+#define BATCH_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define BATCH_FRAME_MAGIC 0xB1
+#define BATCH_FRAME_HEADER_SIZE 4
+#define BATCH_FRAME_MAX_ITEMS 65535
+#define BATCH_FRAME_MAX_PAYLOAD ((1u << 21) - 1)    // 3-byte varint
+#define BATCH_FRAME_MAX_DEVICE_ID 255
+
+#define BATCH_FLAG_FORMAT 0x01
+#define BATCH_FLAG_DEVICE 0x02
+
+// Per-item format tags: container_codec_t + 1, 0 for the endpoint's codec
+#define BATCH_FORMAT_DEFAULT 0
+#define BATCH_FORMAT_CBOR 1
+#define BATCH_FORMAT_MSGPACK 2
+#define BATCH_FORMAT_PROTOBUF 3
+#define BATCH_FORMAT_STRUCT_ZLIB 4
+#define BATCH_FORMAT_STRUCT_RANS 5
+#define BATCH_FORMAT_SESSION 6                      // deflate_session frame
+
+// Item statuses in the reply
+#define BATCH_STATUS_ACCEPTED 0
+#define BATCH_STATUS_REJECTED 1                     // undecodable or unsupported format; do not resend
+#define BATCH_STATUS_RETRY 2                        // shed under load; resend later
+#define BATCH_STATUS_RESYNC 3                       // session frame while waiting for a keyframe
+#define BATCH_STATUS_BYTES(count) (((size_t)(count) + 3) / 4)
+
+// Result codes
+#define BATCH_FRAME_OK 0
+#define BATCH_FRAME_ERR_PARAM -1                    // bad argument or flags
+#define BATCH_FRAME_ERR_SPACE -2                    // output buffer too small or batch full
+#define BATCH_FRAME_ERR_FORMAT -3                   // malformed frame
+#define BATCH_FRAME_ERR_END -4                      // no more items
+
+// Builder state over a caller buffer
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    uint8_t flags;
+    uint16_t count;
+} batch_builder_t;
+
+// One parsed item; payload and device_id point into the frame
+typedef struct {
+    uint8_t format;
+    uint8_t device_id_len;
+    const uint8_t *device_id;
+    const uint8_t *payload;
+    size_t payload_len;
+} batch_item_t;
+
+// Parser state over a received frame
+typedef struct {
+    const uint8_t *frame;
+    size_t len;
+    size_t pos;
+    uint8_t flags;
+    uint16_t count;
+    uint16_t index;                       // items read so far
+} batch_reader_t;
+
+// Bytes an item adds to a frame with the given flags
+size_t batch_item_size(uint8_t flags, size_t device_id_len, size_t payload_len);
+
+int batch_builder_init(batch_builder_t *b, uint8_t *buf, size_t cap, uint8_t flags);
+
+// Append one item. format and device_id are ignored unless the matching
+// flag is set. Returns BATCH_FRAME_ERR_SPACE when it does not fit; the
+// builder is unchanged, so the caller sends the batch and starts another.
+int batch_builder_add(batch_builder_t *b, uint8_t format, const uint8_t *device_id, size_t device_id_len,
+                      const uint8_t *payload, size_t payload_len);
+
+// Length of the finished frame (the count is kept up to date in the header)
+size_t batch_builder_finish(const batch_builder_t *b);
+
+// Checks the header; the items are checked as they are read
+int batch_reader_init(batch_reader_t *r, const uint8_t *frame, size_t len);
+
+// Next item, or BATCH_FRAME_ERR_END after the last. A truncated or padded
+// frame returns BATCH_FRAME_ERR_FORMAT.
+int batch_reader_next(batch_reader_t *r, batch_item_t *item);
+
+// Status of item i from a reply's status bytes
+static inline uint8_t batch_status_get(const uint8_t *status, size_t i) {
+    return (uint8_t)((status[i >> 2] >> ((i & 3) * 2)) & 3);
+}
+
+static inline void batch_status_set(uint8_t *status, size_t i, uint8_t value) {
+    uint8_t shift = (uint8_t)((i & 3) * 2);
+    status[i >> 2] = (uint8_t)((status[i >> 2] & ~(3u << shift)) | (unsigned)(value & 3) << shift);
+}
+
+// Parses a binary reply ([count u16 BE][status bytes]). Returns the item
+// count with *status pointing into reply, or a negative result code.
+int batch_status_parse(const uint8_t *reply, size_t len, const uint8_t **status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCH_FRAME_H
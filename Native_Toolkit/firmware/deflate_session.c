@@ -0,0 +1,169 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "deflate_session.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t sync_marker[4] = { 0x00, 0x00, 0xFF, 0xFF };
+
+// ================= SENDER =================
+
+int deflate_session_init(deflate_session_t *s, int level, uint16_t keyframe_interval) {
+    memset(s, 0, sizeof(*s));
+    if (deflateInit2(&s->z, level, Z_DEFLATED, -DEFLATE_SESSION_WINDOW_BITS, DEFLATE_SESSION_MEM_LEVEL,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return DEFLATE_SESSION_ERR_ZLIB;
+    }
+    s->keyframe_interval = keyframe_interval;
+    s->key_next = true;
+    return DEFLATE_SESSION_OK;
+}
+
+void deflate_session_end(deflate_session_t *s) {
+    deflateEnd(&s->z);
+}
+
+void deflate_session_request_keyframe(deflate_session_t *s) {
+    if (!s->key_next) s->reset_next = true;
+    s->key_next = true;
+}
+
+int deflate_session_compress(deflate_session_t *s, const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    if (!in || !out || cap < DEFLATE_SESSION_HEADER_SIZE + sizeof(sync_marker)) return DEFLATE_SESSION_ERR_ARGS;
+
+    bool key = s->key_next;
+    if (s->reset_next) {
+        if (deflateReset(&s->z) != Z_OK) return DEFLATE_SESSION_ERR_ZLIB;
+        s->reset_next = false;
+    }
+    if (key) s->since_key = 0;
+
+    // The message before a scheduled keyframe ends with a full flush
+    bool full = s->keyframe_interval && s->since_key + 1u >= s->keyframe_interval;
+
+    s->z.next_in = (Bytef *)in;
+    s->z.avail_in = (uInt)len;
+    s->z.next_out = out + DEFLATE_SESSION_HEADER_SIZE;
+    s->z.avail_out = (uInt)(cap - DEFLATE_SESSION_HEADER_SIZE);
+    int rc = deflate(&s->z, full ? Z_FULL_FLUSH : Z_SYNC_FLUSH);
+
+    // A flush is complete only if it left room in the output buffer
+    size_t produced = cap - DEFLATE_SESSION_HEADER_SIZE - s->z.avail_out;
+    if (rc != Z_OK || s->z.avail_in != 0 || s->z.avail_out == 0 || produced < sizeof(sync_marker) ||
+        memcmp(out + DEFLATE_SESSION_HEADER_SIZE + produced - sizeof(sync_marker), sync_marker,
+               sizeof(sync_marker)) != 0) {
+        s->key_next = true;
+        s->reset_next = true;
+        return rc == Z_OK ? DEFLATE_SESSION_ERR_SPACE : DEFLATE_SESSION_ERR_ZLIB;
+    }
+
+    out[0] = DEFLATE_SESSION_MAGIC | (key ? DEFLATE_SESSION_FLAG_KEY : 0);
+    out[1] = s->seq++;
+    s->key_next = full;
+    s->since_key++;
+    s->messages++;
+    s->keyframes += key;
+    return (int)(DEFLATE_SESSION_HEADER_SIZE + produced - sizeof(sync_marker));
+}
+
+// ================= RECEIVER =================
+
+int inflate_session_init(inflate_session_t *s) {
+    memset(s, 0, sizeof(*s));
+    // Any window at least as large as the sender's
+    return inflateInit2(&s->z, -15) == Z_OK ? DEFLATE_SESSION_OK : DEFLATE_SESSION_ERR_ZLIB;
+}
+
+void inflate_session_end(inflate_session_t *s) {
+    inflateEnd(&s->z);
+}
+
+static int inflate_chunk(z_stream *z, const uint8_t *in, size_t len) {
+    z->next_in = (Bytef *)in;
+    z->avail_in = (uInt)len;
+    while (z->avail_in > 0) {
+        if (z->avail_out == 0) return DEFLATE_SESSION_ERR_SPACE;
+        int rc = inflate(z, Z_SYNC_FLUSH);
+        if (rc == Z_BUF_ERROR && z->avail_out == 0) return DEFLATE_SESSION_ERR_SPACE;
+        // The stream never ends (no final block), so Z_STREAM_END is corruption too
+        if (rc != Z_OK) return DEFLATE_SESSION_ERR_DATA;
+    }
+    return DEFLATE_SESSION_OK;
+}
+
+int inflate_session_decompress(inflate_session_t *s, const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    if (!in || !out || len < DEFLATE_SESSION_HEADER_SIZE || (in[0] & 0xF0) != DEFLATE_SESSION_MAGIC) {
+        return DEFLATE_SESSION_ERR_ARGS;
+    }
+
+    bool key = in[0] & DEFLATE_SESSION_FLAG_KEY;
+    uint8_t seq = in[1];
+    if (key) {
+        if (inflateReset(&s->z) != Z_OK) return DEFLATE_SESSION_ERR_ZLIB;
+        s->synced = true;
+        s->keyframes++;
+    } else if (!s->synced || seq != s->expected_seq) {
+        // A lost message leaves a hole in the history: wait for a keyframe
+        s->synced = false;
+        s->desyncs++;
+        return DEFLATE_SESSION_ERR_DESYNC;
+    }
+
+    s->z.next_out = out;
+    s->z.avail_out = (uInt)cap;
+    int rc = inflate_chunk(&s->z, in + DEFLATE_SESSION_HEADER_SIZE, len - DEFLATE_SESSION_HEADER_SIZE);
+    if (rc == DEFLATE_SESSION_OK) rc = inflate_chunk(&s->z, sync_marker, sizeof(sync_marker));
+    if (rc != DEFLATE_SESSION_OK) {
+        s->synced = false;
+        s->errors++;
+        return rc;
+    }
+
+    s->expected_seq = (uint8_t)(seq + 1);
+    s->messages++;
+    return (int)(cap - s->z.avail_out);
+}
+
+int inflate_session_save(inflate_session_t *s, uint8_t *out, size_t cap) {
+    // The receiver window is 32 KB (see inflate_session_init); heap, not stack
+    uint8_t *window = NULL;
+    uInt len = 0;
+    if (s->synced) {
+        window = malloc(32768);
+        if (!window || inflateGetDictionary(&s->z, window, &len) != Z_OK) {
+            free(window);
+            return DEFLATE_SESSION_ERR_ZLIB;
+        }
+    }
+    // Only the sender's window can be referenced
+    size_t keep = len < (1u << DEFLATE_SESSION_WINDOW_BITS) ? len : (1u << DEFLATE_SESSION_WINDOW_BITS);
+    if (cap < 4 + keep) {
+        free(window);
+        return DEFLATE_SESSION_ERR_SPACE;
+    }
+    out[0] = s->expected_seq;
+    out[1] = s->synced;
+    out[2] = (uint8_t)(keep >> 8);
+    out[3] = (uint8_t)keep;
+    if (keep) memcpy(out + 4, window + len - keep, keep);
+    free(window);
+    return (int)(4 + keep);
+}
+
+int inflate_session_restore(inflate_session_t *s, const uint8_t *in, size_t len) {
+    if (len < 4 || len != 4 + ((size_t)in[2] << 8 | in[3])) return DEFLATE_SESSION_ERR_DATA;
+    int rc = inflate_session_init(s);
+    if (rc != DEFLATE_SESSION_OK) return rc;
+    s->expected_seq = in[0];
+    s->synced = in[1] != 0;
+    if (len > 4 && inflateSetDictionary(&s->z, in + 4, (uInt)(len - 4)) != Z_OK) {
+        inflate_session_end(s);
+        return DEFLATE_SESSION_ERR_ZLIB;
+    }
+    return DEFLATE_SESSION_OK;
+}
@@ -0,0 +1,111 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Session-persistent deflate for packed records.
+//
+// compress2() starts every message from an empty window, although two
+// consecutive uplinks of the same container differ in a handful of bytes.
+// Here each device keeps one raw deflate stream open for its lifetime and
+// ends every message with Z_SYNC_FLUSH, so the next message can reference
+// the previous ones; the receiver keeps the matching inflate stream.
+// The 00 00 FF FF marker that every sync flush ends with is not sent; the
+// receiver appends it back.
+//
+// Resynchronization: every keyframe_interval messages the sender ends a
+// message with Z_FULL_FLUSH instead, so the next message (the keyframe)
+// references nothing before it. A receiver that missed a message (sequence
+// gap) drops everything up to the next keyframe, or asks for one early
+// (deflate_session_request_keyframe, e.g. on HTTP 409).
+//
+// Wire format: [0xC0 | flags][seq u8][raw deflate bytes]
+// flags bit 0 = keyframe. The low nibble of the first byte is never 8, so
+// the receiver tells it apart from zlib (CMF 0x?8) and static rANS (0xA?).
+
+#ifndef DEFLATE_SESSION_H
+#define DEFLATE_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define DEFLATE_SESSION_MAGIC 0xC0              // high nibble of the first byte
+#define DEFLATE_SESSION_FLAG_KEY 0x01
+#define DEFLATE_SESSION_HEADER_SIZE 2
+#define DEFLATE_SESSION_WINDOW_BITS 11          // 2 KB history, about 17 records
+#define DEFLATE_SESSION_MEM_LEVEL 4             // deflate state about 12 KB
+#define DEFLATE_SESSION_KEYFRAME_INTERVAL 32
+
+// Result codes
+#define DEFLATE_SESSION_OK 0
+#define DEFLATE_SESSION_ERR_ARGS -1
+#define DEFLATE_SESSION_ERR_SPACE -2            // output buffer too small
+#define DEFLATE_SESSION_ERR_ZLIB -3
+#define DEFLATE_SESSION_ERR_DESYNC -4           // waiting for a keyframe
+#define DEFLATE_SESSION_ERR_DATA -5             // corrupt deflate data
+
+typedef struct {
+    z_stream z;
+    uint8_t seq;                          // sequence number of the next message
+    uint16_t keyframe_interval;
+    uint16_t since_key;                   // messages sent since the last keyframe
+    bool key_next;                        // next message starts from a flushed window
+    bool reset_next;                      // ...and the stream must be reset first
+    uint32_t messages;
+    uint32_t keyframes;
+} deflate_session_t;
+
+typedef struct {
+    z_stream z;
+    uint8_t expected_seq;
+    bool synced;
+    uint32_t messages;
+    uint32_t keyframes;
+    uint32_t desyncs;                     // messages dropped waiting for a keyframe
+    uint32_t errors;
+} inflate_session_t;
+
+// Sender. keyframe_interval 0 means only on demand. Returns DEFLATE_SESSION_OK
+// or DEFLATE_SESSION_ERR_ZLIB.
+int deflate_session_init(deflate_session_t *s, int level, uint16_t keyframe_interval);
+void deflate_session_end(deflate_session_t *s);
+
+// Compress one message into a frame. Returns the frame size or a negative
+// DEFLATE_SESSION_ERR_* code; after an error the next frame is a keyframe.
+int deflate_session_compress(deflate_session_t *s, const uint8_t *in, size_t len, uint8_t *out, size_t cap);
+
+// Make the next frame a keyframe (receiver reported a desync)
+void deflate_session_request_keyframe(deflate_session_t *s);
+
+// Receiver. One per device.
+int inflate_session_init(inflate_session_t *s);
+void inflate_session_end(inflate_session_t *s);
+
+// Decompress one frame. Returns the message size or a negative
+// DEFLATE_SESSION_ERR_* code (ERR_DESYNC until the next keyframe arrives).
+int inflate_session_decompress(inflate_session_t *s, const uint8_t *in, size_t len, uint8_t *out, size_t cap);
+
+// Receiver state between two frames, to carry a device's stream over to
+// another process: [expected seq][synced][history length u16 BE][history],
+// the history being the last sender window of output. Every frame ends on
+// a sync flush, so a stream restored from it decodes the next frame as the
+// original would. Save returns the size written or DEFLATE_SESSION_ERR_SPACE
+// / ERR_ZLIB; restore initializes s (DEFLATE_SESSION_OK, ERR_DATA or
+// ERR_ZLIB).
+#define INFLATE_SESSION_STATE_MAX (4 + (1u << DEFLATE_SESSION_WINDOW_BITS))
+int inflate_session_save(inflate_session_t *s, uint8_t *out, size_t cap);
+int inflate_session_restore(inflate_session_t *s, const uint8_t *in, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEFLATE_SESSION_H
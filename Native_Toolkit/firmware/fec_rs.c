@@ -0,0 +1,383 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "fec_rs.h"
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GF256_KERNEL "avx2"
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define GF256_KERNEL "ssse3"
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GF256_KERNEL "neon"
+#else
+#define GF256_KERNEL "scalar"
+#endif
+
+#define GF256_POLY 0x11D
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static bool gf_ready;
+
+void fec_rs_init(void) {
+    if (gf_ready) return;
+    unsigned x = 1;
+    for (int i = 0; i < 255; i++) {
+        gf_exp[i] = (uint8_t)x;
+        gf_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= GF256_POLY;
+    }
+    // Doubled table avoids the modulo in gf256_mul
+    for (int i = 255; i < 512; i++) gf_exp[i] = gf_exp[i - 255];
+    gf_log[0] = 0;
+    gf_ready = true;
+}
+
+uint8_t gf256_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+uint8_t gf256_inv(uint8_t a) {
+    return a ? gf_exp[255 - gf_log[a]] : 0;
+}
+
+const char *gf256_kernel_name(void) { return GF256_KERNEL; }
+
+// ================= GF(256) KERNELS =================
+
+// c * x split into the products of the low and high nibble of x
+static void nibble_tables(uint8_t c, uint8_t lo[16], uint8_t hi[16]) {
+    for (int x = 0; x < 16; x++) {
+        lo[x] = gf256_mul(c, (uint8_t)x);
+        hi[x] = gf256_mul(c, (uint8_t)(x << 4));
+    }
+}
+
+static void xor_region(uint8_t *dst, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i < len; i++) dst[i] ^= src[i];
+}
+
+static void mul_add_tail(uint8_t *dst, const uint8_t *src, const uint8_t lo[16],
+                         const uint8_t hi[16], size_t len) {
+    for (size_t i = 0; i < len; i++) dst[i] ^= lo[src[i] & 0x0F] ^ hi[src[i] >> 4];
+}
+
+void gf256_mul_add_region_scalar(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    fec_rs_init();
+    if (c == 0) return;
+    if (c == 1) { xor_region(dst, src, len); return; }
+    uint8_t lo[16], hi[16];
+    nibble_tables(c, lo, hi);
+    mul_add_tail(dst, src, lo, hi, len);
+}
+
+void gf256_mul_add_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    fec_rs_init();
+    if (c == 0) return;
+    uint8_t lo[16], hi[16];
+    nibble_tables(c, lo, hi);
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)lo));
+    const __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)hi));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    for (; i + 32 <= len; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i p = _mm256_xor_si256(
+            _mm256_shuffle_epi8(tlo, _mm256_and_si256(s, mask)),
+            _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask)));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(d, p));
+    }
+#elif defined(__SSSE3__)
+    const __m128i tlo = _mm_loadu_si128((const __m128i *)lo);
+    const __m128i thi = _mm_loadu_si128((const __m128i *)hi);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(tlo, _mm_and_si128(s, mask)),
+                                  _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(s, 4), mask)));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(d, p));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t tlo = vld1q_u8(lo);
+    const uint8x16_t thi = vld1q_u8(hi);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t p = veorq_u8(vqtbl1q_u8(tlo, vandq_u8(s, mask)), vqtbl1q_u8(thi, vshrq_n_u8(s, 4)));
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), p));
+    }
+#endif
+
+    if (c == 1) xor_region(dst + i, src + i, len - i);
+    else mul_add_tail(dst + i, src + i, lo, hi, len - i);
+}
+
+// ================= BLOCK CODE =================
+
+// Cauchy element for parity row i, data column j: 1 / (x_i + y_j) with
+// x_i = k + i and y_j = j, all distinct while k + m <= 256
+static inline uint8_t cauchy(size_t k, size_t i, size_t j) {
+    return gf256_inv((uint8_t)((k + i) ^ j));
+}
+
+int fec_rs_encode(const uint8_t *const data[], size_t k, uint8_t *const parity[], size_t m,
+                  size_t shard_len) {
+    if (k == 0 || k > FEC_RS_MAX_K || m > FEC_RS_MAX_M || shard_len == 0) return -1;
+    fec_rs_init();
+
+    for (size_t i = 0; i < m; i++) {
+        memset(parity[i], 0, shard_len);
+        for (size_t j = 0; j < k; j++) {
+            gf256_mul_add_region(parity[i], data[j], cauchy(k, i, j), shard_len);
+        }
+    }
+    return 0;
+}
+
+// Gauss-Jordan inversion of a k x k matrix in place; false if singular
+static bool invert_matrix(uint8_t a[FEC_RS_MAX_K][FEC_RS_MAX_K], size_t k,
+                          uint8_t inv[FEC_RS_MAX_K][FEC_RS_MAX_K]) {
+    for (size_t r = 0; r < k; r++) {
+        for (size_t c = 0; c < k; c++) inv[r][c] = (r == c);
+    }
+    for (size_t col = 0; col < k; col++) {
+        size_t pivot = col;
+        while (pivot < k && a[pivot][col] == 0) pivot++;
+        if (pivot == k) return false;
+        if (pivot != col) {
+            for (size_t c = 0; c < k; c++) {
+                uint8_t t = a[col][c]; a[col][c] = a[pivot][c]; a[pivot][c] = t;
+                t = inv[col][c]; inv[col][c] = inv[pivot][c]; inv[pivot][c] = t;
+            }
+        }
+        uint8_t scale = gf256_inv(a[col][col]);
+        for (size_t c = 0; c < k; c++) {
+            a[col][c] = gf256_mul(a[col][c], scale);
+            inv[col][c] = gf256_mul(inv[col][c], scale);
+        }
+        for (size_t r = 0; r < k; r++) {
+            uint8_t f = a[r][col];
+            if (r == col || f == 0) continue;
+            for (size_t c = 0; c < k; c++) {
+                a[r][c] ^= gf256_mul(f, a[col][c]);
+                inv[r][c] ^= gf256_mul(f, inv[col][c]);
+            }
+        }
+    }
+    return true;
+}
+
+int fec_rs_reconstruct(uint8_t *const shards[], const bool present[], size_t k, size_t m,
+                       size_t shard_len) {
+    if (k == 0 || k > FEC_RS_MAX_K || m > FEC_RS_MAX_M) return -1;
+    fec_rs_init();
+
+    // First k present shards; data shards come first, so the decode
+    // matrix is mostly identity rows
+    size_t rows[FEC_RS_MAX_K];
+    size_t n = 0;
+    for (size_t i = 0; i < k + m && n < k; i++) {
+        if (present[i]) rows[n++] = i;
+    }
+    if (n < k) return -1;
+
+    size_t missing = 0;
+    for (size_t j = 0; j < k; j++) missing += !present[j];
+    if (missing == 0) return 0;
+
+    uint8_t a[FEC_RS_MAX_K][FEC_RS_MAX_K];
+    uint8_t inv[FEC_RS_MAX_K][FEC_RS_MAX_K];
+    for (size_t r = 0; r < k; r++) {
+        for (size_t c = 0; c < k; c++) {
+            a[r][c] = rows[r] < k ? (uint8_t)(rows[r] == c) : cauchy(k, rows[r] - k, c);
+        }
+    }
+    if (!invert_matrix(a, k, inv)) return -1;
+
+    for (size_t j = 0; j < k; j++) {
+        if (present[j]) continue;
+        memset(shards[j], 0, shard_len);
+        for (size_t r = 0; r < k; r++) {
+            gf256_mul_add_region(shards[j], shards[rows[r]], inv[j][r], shard_len);
+        }
+    }
+    return (int)missing;
+}
+
+// ================= FRAMING =================
+
+int fec_sender_init(fec_sender_t *s, uint8_t k, uint8_t m) {
+    if (k == 0 || k > FEC_RS_MAX_K || m > FEC_RS_MAX_M) return -1;
+    memset(s, 0, sizeof(*s));
+    s->k = k;
+    s->m = m;
+    return 0;
+}
+
+size_t fec_sender_add(fec_sender_t *s, const uint8_t *frame, size_t len, uint8_t *out, size_t cap) {
+    if (s->count >= s->k || len > FEC_RS_MAX_FRAME || cap < len + FEC_RS_HEADER_SIZE) return 0;
+
+    uint8_t *shard = s->shards[s->count];
+    shard[0] = (uint8_t)len;
+    memcpy(shard + 1, frame, len);
+    memset(shard + 1 + len, 0, FEC_RS_MAX_SHARD - 1 - len);
+    if (len + 1 > s->shard_len) s->shard_len = len + 1;
+
+    out[0] = s->group;
+    out[1] = s->count;
+    out[2] = (uint8_t)(s->k << 4 | s->m);
+    memcpy(out + FEC_RS_HEADER_SIZE, frame, len);
+    s->count++;
+    return len + FEC_RS_HEADER_SIZE;
+}
+
+size_t fec_sender_finish_group(fec_sender_t *s, uint8_t *const out[], size_t cap, size_t *frame_len) {
+    size_t written = 0;
+    uint8_t k = s->count;
+
+    if (k > 0 && s->m > 0 && cap >= s->shard_len + FEC_RS_HEADER_SIZE) {
+        const uint8_t *data[FEC_RS_MAX_K];
+        uint8_t *parity[FEC_RS_MAX_M];
+        for (size_t j = 0; j < k; j++) data[j] = s->shards[j];
+        for (size_t i = 0; i < s->m; i++) parity[i] = s->shards[FEC_RS_MAX_K + i];
+
+        fec_rs_encode(data, k, parity, s->m, s->shard_len);
+        for (size_t i = 0; i < s->m; i++) {
+            out[i][0] = s->group;
+            out[i][1] = (uint8_t)(k + i);
+            out[i][2] = (uint8_t)(k << 4 | s->m);
+            memcpy(out[i] + FEC_RS_HEADER_SIZE, parity[i], s->shard_len);
+        }
+        written = s->m;
+        if (frame_len) *frame_len = s->shard_len + FEC_RS_HEADER_SIZE;
+    }
+
+    s->group++;
+    s->count = 0;
+    s->shard_len = 0;
+    return written;
+}
+
+void fec_receiver_init(fec_receiver_t *r) {
+    memset(r, 0, sizeof(*r));
+}
+
+static inline uint32_t data_mask(uint8_t k) { return (1u << k) - 1; }
+
+static void close_group(fec_receiver_t *r) {
+    // Without a parity frame the group size is unknown (the sender may
+    // have flushed early); only holes below the highest data index count
+    uint32_t expected = data_mask(r->k);
+    if (!r->k_known) {
+        uint32_t seen = r->delivered & data_mask(FEC_RS_MAX_K);
+        expected = 0;
+        while (seen) { expected = (expected << 1) | 1; seen >>= 1; }
+    }
+    if (r->active && (r->delivered & expected) != expected) r->groups_incomplete++;
+    r->active = false;
+}
+
+int fec_receiver_push(fec_receiver_t *r, const uint8_t *frame, size_t len, fec_deliver_fn cb,
+                      void *ctx) {
+    if (len < FEC_RS_HEADER_SIZE) { r->malformed++; return -1; }
+    uint8_t group = frame[0], index = frame[1];
+    uint8_t k = frame[2] >> 4, m = frame[2] & 0x0F;
+    const uint8_t *payload = frame + FEC_RS_HEADER_SIZE;
+    size_t payload_len = len - FEC_RS_HEADER_SIZE;
+    bool is_parity = index >= k;
+
+    if (k == 0 || k > FEC_RS_MAX_K || m > FEC_RS_MAX_M || index >= k + m ||
+        (is_parity ? payload_len == 0 || payload_len > FEC_RS_MAX_SHARD : payload_len > FEC_RS_MAX_FRAME)) {
+        r->malformed++;
+        return -1;
+    }
+    r->frames_in++;
+
+    if (!r->active || group != r->group) {
+        // Group ids wrap; anything in the half behind the current one is late
+        if (r->active && (uint8_t)(group - r->group) >= 128) { r->stale++; return 0; }
+        close_group(r);
+        r->active = true;
+        r->group = group;
+        r->k = k;
+        r->m = m;
+        r->k_known = false;
+        r->present = 0;
+        r->delivered = 0;
+        r->shard_len = 0;
+    }
+
+    int delivered = 0;
+    if (!is_parity) {
+        uint32_t bit = 1u << index;
+        if (r->present & bit) return 0;
+        uint8_t *shard = r->shards[index];
+        shard[0] = (uint8_t)payload_len;
+        memcpy(shard + 1, payload, payload_len);
+        memset(shard + 1 + payload_len, 0, FEC_RS_MAX_SHARD - 1 - payload_len);
+        r->data_len[index] = (uint8_t)payload_len;
+        r->present |= bit;
+        if (!(r->delivered & bit)) {
+            r->delivered |= bit;
+            if (cb) cb(ctx, payload, payload_len, false);
+            delivered++;
+        }
+    } else {
+        size_t p = index - k;
+        uint32_t bit = 1u << (FEC_RS_MAX_K + p);
+        if (r->present & bit) return 0;
+        if (r->k_known && (k != r->k || payload_len != r->shard_len)) { r->malformed++; return -1; }
+        memcpy(r->shards[FEC_RS_MAX_K + p], payload, payload_len);
+        r->present |= bit;
+        r->k = k;
+        r->m = m;
+        r->k_known = true;
+        r->shard_len = payload_len;
+    }
+
+    if (!r->k_known || (r->delivered & data_mask(r->k)) == data_mask(r->k)) return delivered;
+
+    uint8_t *shards[FEC_RS_MAX_K + FEC_RS_MAX_M];
+    bool present[FEC_RS_MAX_K + FEC_RS_MAX_M];
+    size_t have = 0;
+    for (size_t j = 0; j < r->k; j++) {
+        shards[j] = r->shards[j];
+        present[j] = (r->present >> j) & 1;
+        // A data frame longer than the parity shards cannot be part of this group
+        if (present[j] && r->data_len[j] + 1u > r->shard_len) { r->malformed++; return -1; }
+        have += present[j];
+    }
+    for (size_t i = 0; i < r->m; i++) {
+        shards[r->k + i] = r->shards[FEC_RS_MAX_K + i];
+        present[r->k + i] = (r->present >> (FEC_RS_MAX_K + i)) & 1;
+        have += present[r->k + i];
+    }
+    if (have < r->k) return delivered;
+
+    if (fec_rs_reconstruct(shards, present, r->k, r->m, r->shard_len) < 0) return delivered;
+    for (size_t j = 0; j < r->k; j++) {
+        uint32_t bit = 1u << j;
+        if (r->delivered & bit) continue;
+        size_t frame_len = shards[j][0];
+        r->delivered |= bit;
+        if (frame_len + 1 > r->shard_len) { r->malformed++; continue; }
+        r->recovered++;
+        if (cb) cb(ctx, shards[j] + 1, frame_len, true);
+        delivered++;
+    }
+    return delivered;
+}
@@ -0,0 +1,135 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Cross-frame forward error correction (systematic Reed-Solomon erasure code).
+//
+// Frames are grouped K at a time; M parity frames are added per group and
+// the receiver rebuilds the group from any K of the K+M frames. The code
+// uses a Cauchy matrix over GF(2^8) (polynomial 0x11D), so every K x K
+// submatrix of [I; C] is invertible.
+//
+// Wire format of every FEC frame (3-byte header):
+//   byte 0   group id (wraps at 256)
+//   byte 1   index: 0..K-1 data, K..K+M-1 parity
+//   byte 2   K << 4 | M
+// Data frames carry the original frame unpadded after the header. Parity
+// frames carry shard_len bytes, where each data shard is logically
+// [len u8][frame][zero padding] and shard_len = longest frame + 1.
+// Data frames are delivered as soon as they arrive; the parity header's K
+// is authoritative, which lets the sender flush a partial group.
+//
+// The GF(256) multiply-accumulate kernel uses SSSE3/AVX2 (pshufb) or NEON
+// (tbl) nibble lookups when the compiler targets them, scalar otherwise.
+
+#ifndef FEC_RS_H
+#define FEC_RS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#ifndef FEC_RS_MAX_K
+#define FEC_RS_MAX_K 8                    // data frames per group (wire limit 15)
+#endif
+#ifndef FEC_RS_MAX_M
+#define FEC_RS_MAX_M 4                    // parity frames per group (wire limit 15)
+#endif
+#define FEC_RS_HEADER_SIZE 3
+#define FEC_RS_MAX_FRAME 255              // length prefix is one byte
+#define FEC_RS_MAX_SHARD (FEC_RS_MAX_FRAME + 1)
+
+// ================= GF(256) KERNELS =================
+
+// Build the log/exp tables (idempotent, called by every entry point)
+void fec_rs_init(void);
+
+uint8_t gf256_mul(uint8_t a, uint8_t b);
+uint8_t gf256_inv(uint8_t a);
+
+// dst[i] ^= c * src[i], best kernel for the target
+void gf256_mul_add_region(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+// Portable reference kernel (benchmarks, cross-checks)
+void gf256_mul_add_region_scalar(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len);
+
+// "avx2", "ssse3", "neon" or "scalar"
+const char *gf256_kernel_name(void);
+
+// ================= BLOCK CODE =================
+
+// Compute m parity shards from k data shards, all shard_len bytes.
+// Returns 0 on success, -1 on invalid parameters.
+int fec_rs_encode(const uint8_t *const data[], size_t k, uint8_t *const parity[], size_t m,
+                  size_t shard_len);
+
+// shards[0..k+m-1]; present[i] marks the received ones. Missing data
+// shards (index < k) are rebuilt in place. Returns the number of shards
+// rebuilt, or -1 if fewer than k shards are present.
+int fec_rs_reconstruct(uint8_t *const shards[], const bool present[], size_t k, size_t m,
+                       size_t shard_len);
+
+// ================= FRAMING =================
+
+typedef struct {
+    uint8_t k, m;
+    uint8_t group;
+    uint8_t count;                        // data frames in the current group
+    size_t shard_len;
+    uint8_t shards[FEC_RS_MAX_K + FEC_RS_MAX_M][FEC_RS_MAX_SHARD];
+} fec_sender_t;
+
+// Returns -1 if k or m exceed the compiled limits
+int fec_sender_init(fec_sender_t *s, uint8_t k, uint8_t m);
+
+// Wrap one frame into out (len + FEC_RS_HEADER_SIZE bytes). Returns the
+// FEC frame size, 0 if the frame is too long or the group is already full.
+size_t fec_sender_add(fec_sender_t *s, const uint8_t *frame, size_t len, uint8_t *out, size_t cap);
+
+static inline bool fec_sender_group_full(const fec_sender_t *s) { return s->count == s->k; }
+
+// Emit every parity frame of the current group (full or partial) into
+// out[i], each cap bytes, and start the next group. Returns the number of
+// parity frames written; *frame_len receives their common size.
+size_t fec_sender_finish_group(fec_sender_t *s, uint8_t *const out[], size_t cap, size_t *frame_len);
+
+typedef void (*fec_deliver_fn)(void *ctx, const uint8_t *frame, size_t len, bool recovered);
+
+typedef struct {
+    bool active;
+    uint8_t group;
+    uint8_t k, m;                         // k from the parity header once seen
+    bool k_known;
+    uint32_t present;                     // bitmap over k+m shard indices
+    uint32_t delivered;                   // data shards already handed out
+    size_t shard_len;
+    uint8_t data_len[FEC_RS_MAX_K];
+    uint8_t shards[FEC_RS_MAX_K + FEC_RS_MAX_M][FEC_RS_MAX_SHARD];
+
+    uint32_t frames_in;                   // statistics
+    uint32_t recovered;
+    uint32_t groups_incomplete;           // groups closed with data still missing
+    uint32_t malformed;
+    uint32_t stale;
+} fec_receiver_t;
+
+void fec_receiver_init(fec_receiver_t *r);
+
+// Feed one FEC frame. Data frames are delivered immediately; missing ones
+// are delivered (recovered = true) as soon as K shards of the group are
+// in. Returns the number of frames delivered, -1 on a malformed frame.
+int fec_receiver_push(fec_receiver_t *r, const uint8_t *frame, size_t len, fec_deliver_fn cb,
+                      void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FEC_RS_H
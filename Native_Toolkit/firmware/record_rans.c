@@ -0,0 +1,192 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+#include "record_rans.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Trained model: record_rans_model[], record_rans_model_symbols[],
+// record_rans_model_freqs[] (generated by tools/record_rans_train.c)
+#include "record_rans_tables.h"
+
+#define RANS_L (1u << 23)                 // lower bound of the normalized state
+
+// Offsets of the u16 BE string lengths in the fixed part, in string order
+static const uint8_t str_len_offset[RECORD_RANS_STR_FIELDS] = { 0, 2, 4, 7, 35 };
+
+uint8_t record_rans_model_version(void) {
+    return RECORD_RANS_MODEL_VERSION;
+}
+
+static size_t str_len_at(const uint8_t *packed, int field) {
+    const uint8_t *p = packed + str_len_offset[field];
+    return ((size_t)p[0] << 8) | p[1];
+}
+
+static uint16_t str_context(int field, size_t pos) {
+    size_t clipped = pos < RECORD_RANS_STR_POSITIONS ? pos : RECORD_RANS_STR_POSITIONS - 1;
+    return (uint16_t)(RECORD_RANS_FIXED_BYTES + field * RECORD_RANS_STR_POSITIONS + clipped);
+}
+
+int record_rans_contexts(const uint8_t *packed, size_t len, uint16_t *ctx) {
+    if (len < RECORD_RANS_FIXED_BYTES) return -1;
+
+    size_t total = RECORD_RANS_FIXED_BYTES;
+    for (int f = 0; f < RECORD_RANS_STR_FIELDS; f++) total += str_len_at(packed, f);
+    if (total != len) return -1;
+
+    size_t i = 0;
+    for (; i < RECORD_RANS_FIXED_BYTES; i++) ctx[i] = (uint16_t)i;
+    for (int f = 0; f < RECORD_RANS_STR_FIELDS; f++) {
+        size_t n = str_len_at(packed, f);
+        for (size_t pos = 0; pos < n; pos++) ctx[i++] = str_context(f, pos);
+    }
+    return 0;
+}
+
+// ================= ENCODER =================
+
+// Start and frequency of a symbol, summed from the sparse model
+static void symbol_range(const record_rans_context_t *c, uint8_t sym, uint32_t *start, uint32_t *freq) {
+    const uint8_t *symbols = &record_rans_model_symbols[c->first_pair];
+    const uint16_t *freqs = &record_rans_model_freqs[c->first_pair];
+    uint32_t cum = sym;
+    *freq = 1;
+    for (uint16_t i = 0; i < c->pair_count && symbols[i] <= sym; i++) {
+        if (symbols[i] == sym) {
+            *freq = freqs[i];
+            break;
+        }
+        cum += freqs[i] - 1u;
+    }
+    *start = cum;
+}
+
+size_t record_rans_encode(const uint8_t *packed, size_t len, uint8_t *out, size_t cap) {
+    uint16_t ctx[RECORD_RANS_MAX_RECORD];
+    if (len > RECORD_RANS_MAX_RECORD || cap < RECORD_RANS_HEADER_SIZE) return 0;
+    if (record_rans_contexts(packed, len, ctx) != 0) return 0;
+
+    // rANS is last-in first-out: encode backwards, writing from the end of out
+    uint32_t x = RANS_L;
+    uint8_t *ptr = out + cap;
+    for (size_t i = len; i-- > 0;) {
+        const record_rans_context_t *c = &record_rans_model[ctx[i]];
+        uint32_t start, freq;
+        symbol_range(c, packed[i], &start, &freq);
+
+        uint32_t x_max = ((RANS_L >> c->scale_bits) << 8) * freq;
+        while (x >= x_max) {
+            if (ptr == out) return 0;
+            *--ptr = (uint8_t)x;
+            x >>= 8;
+        }
+        x = ((x / freq) << c->scale_bits) + (x % freq) + start;
+    }
+
+    if (ptr - out < RECORD_RANS_HEADER_SIZE) return 0;
+    ptr -= 4;
+    ptr[0] = (uint8_t)(x >> 24);
+    ptr[1] = (uint8_t)(x >> 16);
+    ptr[2] = (uint8_t)(x >> 8);
+    ptr[3] = (uint8_t)x;
+
+    size_t n = (size_t)(out + cap - ptr);
+    memmove(out + 1, ptr, n);
+    out[0] = RECORD_RANS_MAGIC | RECORD_RANS_MODEL_VERSION;
+    return n + 1;
+}
+
+// ================= DECODER =================
+
+static uint16_t (*cum_tables)[257];
+
+int record_rans_decoder_init(void) {
+    if (cum_tables) return 0;
+    uint16_t (*tables)[257] = malloc(sizeof(uint16_t[257]) * RECORD_RANS_CONTEXTS);
+    if (!tables) return -1;
+
+    for (int c = 0; c < RECORD_RANS_CONTEXTS; c++) {
+        const record_rans_context_t *model = &record_rans_model[c];
+        uint32_t freq[256];
+        for (int s = 0; s < 256; s++) freq[s] = 1;
+        for (uint16_t i = 0; i < model->pair_count; i++) {
+            freq[record_rans_model_symbols[model->first_pair + i]] = record_rans_model_freqs[model->first_pair + i];
+        }
+        uint32_t cum = 0;
+        for (int s = 0; s < 256; s++) {
+            tables[c][s] = (uint16_t)cum;
+            cum += freq[s];
+        }
+        tables[c][256] = (uint16_t)cum;
+    }
+    cum_tables = tables;
+    return 0;
+}
+
+// Symbol whose cumulative range holds slot (branch-free binary search)
+static uint8_t find_symbol(const uint16_t *cum, uint32_t slot) {
+    const uint16_t *base = cum;
+    for (unsigned n = 256; n > 1; n -= n / 2) {
+        base = base[n / 2] <= slot ? base + n / 2 : base;
+    }
+    return (uint8_t)(base - cum);
+}
+
+typedef struct {
+    uint32_t x;
+    const uint8_t *p;
+    const uint8_t *end;
+} rans_reader_t;
+
+static int decode_symbol(rans_reader_t *r, uint16_t ctx, uint8_t *sym) {
+    const record_rans_context_t *c = &record_rans_model[ctx];
+    const uint16_t *cum = cum_tables[ctx];
+    uint32_t slot = r->x & ((1u << c->scale_bits) - 1);
+    uint8_t s = c->pair_count == 0 && c->scale_bits == 8 ? (uint8_t)slot : find_symbol(cum, slot);
+
+    r->x = (uint32_t)(cum[s + 1] - cum[s]) * (r->x >> c->scale_bits) + slot - cum[s];
+    while (r->x < RANS_L) {
+        if (r->p == r->end) return -1;
+        r->x = (r->x << 8) | *r->p++;
+    }
+    *sym = s;
+    return 0;
+}
+
+int record_rans_decode(const uint8_t *in, size_t len, uint8_t *packed, size_t cap) {
+    if (len < RECORD_RANS_HEADER_SIZE) return -1;
+    if (in[0] != (RECORD_RANS_MAGIC | RECORD_RANS_MODEL_VERSION)) return -1;
+    if (record_rans_decoder_init() != 0) return -1;
+    if (cap < RECORD_RANS_FIXED_BYTES) return -1;
+
+    rans_reader_t r = {
+        ((uint32_t)in[1] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 8) | in[4],
+        in + RECORD_RANS_HEADER_SIZE, in + len
+    };
+    if (r.x < RANS_L) return -1;
+
+    size_t i = 0;
+    for (; i < RECORD_RANS_FIXED_BYTES; i++) {
+        if (decode_symbol(&r, (uint16_t)i, &packed[i]) != 0) return -1;
+    }
+
+    size_t total = RECORD_RANS_FIXED_BYTES;
+    for (int f = 0; f < RECORD_RANS_STR_FIELDS; f++) total += str_len_at(packed, f);
+    if (total > cap || total > RECORD_RANS_MAX_RECORD) return -1;
+
+    for (int f = 0; f < RECORD_RANS_STR_FIELDS; f++) {
+        size_t n = str_len_at(packed, f);
+        for (size_t pos = 0; pos < n; pos++, i++) {
+            if (decode_symbol(&r, str_context(f, pos), &packed[i]) != 0) return -1;
+        }
+    }
+
+    // The encoder started from RANS_L: anything else means corruption
+    if (r.x != RANS_L || r.p != r.end) return -1;
+    return (int)total;
+}
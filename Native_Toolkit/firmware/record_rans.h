@@ -0,0 +1,75 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Static-model rANS back end for the Struct+zlib packed record.
+//
+// On 50-150 byte records deflate spends a large share of its output on the
+// zlib header, block header, Huffman table description and Adler-32.
+// This coder replaces the zlib stage with a byte-wise rANS whose
+// probability tables are trained offline (tools/record_rans_train.c) and
+// compiled into both ends. The model has one context per byte of the fixed
+// part (string lengths, u8 fields, each byte of every float32) and one per
+// leading position of every string, so the layout is learned, not sent.
+//
+// Wire format: [0xA0 | model version][rANS state u32 BE][rANS bytes]
+// A zlib stream always starts with a CMF byte whose low nibble is 8, so the
+// receiver tells the two back ends apart from the first byte.
+//
+// The encoder needs no RAM tables (cumulative frequencies are summed from
+// the sparse model in flash). The decoder builds cumulative tables on first
+// use (about 73 KB, host side).
+
+#ifndef RECORD_RANS_H
+#define RECORD_RANS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration
+#define RECORD_RANS_MAGIC 0xA0            // high nibble of the first byte
+#define RECORD_RANS_HEADER_SIZE 5         // magic + initial state
+#define RECORD_RANS_FIXED_BYTES 63        // fixed part of the packed record
+#define RECORD_RANS_STR_FIELDS 5          // msisdn, iso6346, time, cgi, door
+#define RECORD_RANS_STR_POSITIONS 16      // positions >= 15 share the last context
+#define RECORD_RANS_CONTEXTS (RECORD_RANS_FIXED_BYTES + RECORD_RANS_STR_FIELDS * RECORD_RANS_STR_POSITIONS)
+#define RECORD_RANS_SCALE_BITS 14         // trained contexts; flat contexts use 8
+#define RECORD_RANS_MAX_RECORD 256        // largest packed record accepted
+
+// One context of the trained model. Symbols not listed have frequency 1;
+// the frequencies of a context sum to 1 << scale_bits.
+typedef struct {
+    uint8_t scale_bits;
+    uint16_t first_pair;                  // index into the symbol/frequency arrays
+    uint16_t pair_count;                  // listed symbols, sorted ascending
+} record_rans_context_t;
+
+// Model version compiled into this build (low nibble of the first byte)
+uint8_t record_rans_model_version(void);
+
+// Context of every byte of a packed record. ctx receives len entries.
+// Returns 0, or -1 if the record does not follow the packed layout.
+int record_rans_contexts(const uint8_t *packed, size_t len, uint16_t *ctx);
+
+// Encode a packed record. Returns the encoded size, 0 if it does not fit in cap.
+size_t record_rans_encode(const uint8_t *packed, size_t len, uint8_t *out, size_t cap);
+
+// Decode into packed (cap bytes). Returns the packed size, or -1 on a
+// malformed, truncated or foreign-model payload.
+int record_rans_decode(const uint8_t *in, size_t len, uint8_t *packed, size_t cap);
+
+// Builds the decoder tables; called by the first decode. Call it once up
+// front when several threads decode. Returns 0, or -1 on allocation failure.
+int record_rans_decoder_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RECORD_RANS_H
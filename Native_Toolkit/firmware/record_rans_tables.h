@@ -0,0 +1,451 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Static rANS record model, generated by tools/record_rans_train.c. Do not edit.
+// Corpus: 200000 records (synthetic, seed 1, 1826-day timestamp span)
+// Included by record_rans.c only.
+
+#ifndef RECORD_RANS_TABLES_H
+#define RECORD_RANS_TABLES_H
+
+#define RECORD_RANS_MODEL_VERSION 1
+
+// { scale_bits, first_pair, pair_count }
+static const record_rans_context_t record_rans_model[RECORD_RANS_CONTEXTS] = {
+    { 14,     0,   1 }, // msisdn.len.b0    0.02 bits
+    { 14,     1,   1 }, // msisdn.len.b1    0.02 bits
+    { 14,     2,   1 }, // iso6346.len.b0   0.02 bits
+    { 14,     3,   1 }, // iso6346.len.b1   0.02 bits
+    { 14,     4,   1 }, // time.len.b0      0.02 bits
+    { 14,     5,   1 }, // time.len.b1      0.02 bits
+    { 14,     6,  21 }, // rssi             4.41 bits
+    { 14,    27,   1 }, // cgi.len.b0       0.02 bits
+    { 14,    28,   1 }, // cgi.len.b1       0.02 bits
+    { 14,    29,   2 }, // ble-m            1.02 bits
+    { 14,    31,  20 }, // bat-soc          4.34 bits
+    { 14,    51,   1 }, // acc.x.b0         0.02 bits
+    { 14,    52,   6 }, // acc.x.b1         2.54 bits
+    {  8,    58,   0 }, // acc.x.b2         8.00 bits
+    {  8,    58,   0 }, // acc.x.b3         8.00 bits
+    { 14,    58,   1 }, // acc.y.b0         0.02 bits
+    { 14,    59,  81 }, // acc.y.b1         6.35 bits
+    {  8,   140,   0 }, // acc.y.b2         8.00 bits
+    {  8,   140,   0 }, // acc.y.b3         8.00 bits
+    { 14,   140,   1 }, // acc.z.b0         0.02 bits
+    { 14,   141,  40 }, // acc.z.b1         5.34 bits
+    {  8,   181,   0 }, // acc.z.b2         8.00 bits
+    {  8,   181,   0 }, // acc.z.b3         8.00 bits
+    { 14,   181,   1 }, // temperature.b0   0.02 bits
+    { 14,   182,  81 }, // temperature.b1   6.34 bits
+    { 14,   263,  25 }, // temperature.b2   4.66 bits
+    { 14,   288,  25 }, // temperature.b3   4.66 bits
+    { 14,   313,   1 }, // humidity.b0      0.02 bits
+    { 14,   314,  47 }, // humidity.b1      5.49 bits
+    { 14,   361,  50 }, // humidity.b2      5.64 bits
+    { 14,   411,  25 }, // humidity.b3      4.66 bits
+    { 14,   436,   1 }, // pressure.b0      0.02 bits
+    { 14,   437,   6 }, // pressure.b1      2.54 bits
+    {  8,   443,   0 }, // pressure.b2      8.00 bits
+    {  8,   443,   0 }, // pressure.b3      8.00 bits
+    { 14,   443,   1 }, // door.len.b0      0.02 bits
+    { 14,   444,   1 }, // door.len.b1      0.02 bits
+    { 14,   445,   2 }, // gnss             1.02 bits
+    { 14,   447,   2 }, // latitude.b0      0.80 bits
+    { 14,   449,   5 }, // latitude.b1      2.15 bits
+    { 14,   454,  25 }, // latitude.b2      4.58 bits
+    { 14,   479,  25 }, // latitude.b3      4.58 bits
+    { 14,   504,   1 }, // longitude.b0     0.02 bits
+    { 14,   505,   5 }, // longitude.b1     2.08 bits
+    { 14,   510,  25 }, // longitude.b2     4.66 bits
+    { 14,   535,  25 }, // longitude.b3     4.66 bits
+    { 14,   560,   1 }, // altitude.b0      0.02 bits
+    { 14,   561,  81 }, // altitude.b1      6.34 bits
+    { 14,   642,  25 }, // altitude.b2      4.66 bits
+    { 14,   667,  25 }, // altitude.b3      4.66 bits
+    { 14,   692,   7 }, // speed.b0         1.60 bits
+    { 14,   699, 220 }, // speed.b1         7.56 bits
+    { 14,   919,   5 }, // speed.b2         2.34 bits
+    { 14,   924,   5 }, // speed.b3         2.34 bits
+    { 14,   929,   8 }, // heading.b0       1.34 bits
+    { 14,   937, 256 }, // heading.b1       7.83 bits
+    { 14,  1193, 200 }, // heading.b2       7.10 bits
+    { 14,  1393,  25 }, // heading.b3       4.66 bits
+    { 14,  1418,   9 }, // nsat             3.19 bits
+    { 14,  1427,   2 }, // hdop.b0          0.89 bits
+    { 14,  1429,  42 }, // hdop.b1          5.34 bits
+    { 14,  1471,   5 }, // hdop.b2          2.34 bits
+    { 14,  1476,   5 }, // hdop.b3          2.34 bits
+    { 14,  1481,   1 }, // msisdn[0]        0.02 bits
+    { 14,  1482,   1 }, // msisdn[1]        0.02 bits
+    { 14,  1483,   1 }, // msisdn[2]        0.02 bits
+    { 14,  1484,   1 }, // msisdn[3]        0.02 bits
+    { 14,  1485,   1 }, // msisdn[4]        0.02 bits
+    { 14,  1486,   1 }, // msisdn[5]        0.02 bits
+    { 14,  1487,   1 }, // msisdn[6]        0.02 bits
+    { 14,  1488,   1 }, // msisdn[7]        0.02 bits
+    { 14,  1489,   1 }, // msisdn[8]        0.02 bits
+    { 14,  1490,   2 }, // msisdn[9]        1.02 bits
+    { 14,  1492,  10 }, // msisdn[10]       3.34 bits
+    { 14,  1502,  10 }, // msisdn[11]       3.34 bits
+    {  8,  1512,   0 }, // msisdn[12]       8.00 bits
+    {  8,  1512,   0 }, // msisdn[13]       8.00 bits
+    {  8,  1512,   0 }, // msisdn[14]       8.00 bits
+    {  8,  1512,   0 }, // msisdn[15+]      8.00 bits
+    { 14,  1512,   1 }, // iso6346[0]       0.02 bits
+    { 14,  1513,   1 }, // iso6346[1]       0.02 bits
+    { 14,  1514,   1 }, // iso6346[2]       0.02 bits
+    { 14,  1515,   1 }, // iso6346[3]       0.02 bits
+    { 14,  1516,   1 }, // iso6346[4]       0.02 bits
+    { 14,  1517,  10 }, // iso6346[5]       3.34 bits
+    { 14,  1527,  10 }, // iso6346[6]       3.34 bits
+    { 14,  1537,  10 }, // iso6346[7]       3.34 bits
+    { 14,  1547,  10 }, // iso6346[8]       3.34 bits
+    { 14,  1557,  10 }, // iso6346[9]       3.34 bits
+    { 14,  1567,  10 }, // iso6346[10]      3.34 bits
+    {  8,  1577,   0 }, // iso6346[11]      8.00 bits
+    {  8,  1577,   0 }, // iso6346[12]      8.00 bits
+    {  8,  1577,   0 }, // iso6346[13]      8.00 bits
+    {  8,  1577,   0 }, // iso6346[14]      8.00 bits
+    {  8,  1577,   0 }, // iso6346[15+]     8.00 bits
+    { 14,  1577,   4 }, // time[0]          1.81 bits
+    { 14,  1581,  10 }, // time[1]          3.34 bits
+    { 14,  1591,   2 }, // time[2]          0.84 bits
+    { 14,  1593,  10 }, // time[3]          3.28 bits
+    { 14,  1603,   1 }, // time[4]          0.02 bits
+    { 14,  1604,   6 }, // time[5]          2.54 bits
+    { 14,  1610,   1 }, // time[6]          0.02 bits
+    { 14,  1611,   3 }, // time[7]          1.51 bits
+    { 14,  1614,  10 }, // time[8]          3.31 bits
+    { 14,  1624,   6 }, // time[9]          2.61 bits
+    { 14,  1630,  10 }, // time[10]         3.34 bits
+    { 14,  1640,   6 }, // time[11]         2.61 bits
+    { 14,  1646,  10 }, // time[12]         3.34 bits
+    { 14,  1656,   1 }, // time[13]         0.02 bits
+    { 14,  1657,  10 }, // time[14]         3.34 bits
+    {  8,  1667,   0 }, // time[15+]        8.00 bits
+    { 14,  1667,   1 }, // cgi[0]           0.02 bits
+    { 14,  1668,   1 }, // cgi[1]           0.02 bits
+    { 14,  1669,   1 }, // cgi[2]           0.02 bits
+    { 14,  1670,   1 }, // cgi[3]           0.02 bits
+    { 14,  1671,   1 }, // cgi[4]           0.02 bits
+    { 14,  1672,   1 }, // cgi[5]           0.02 bits
+    { 14,  1673,   1 }, // cgi[6]           0.02 bits
+    { 14,  1674,   1 }, // cgi[7]           0.02 bits
+    { 14,  1675,   1 }, // cgi[8]           0.02 bits
+    { 14,  1676,   1 }, // cgi[9]           0.02 bits
+    { 14,  1677,   1 }, // cgi[10]          0.02 bits
+    { 14,  1678,   1 }, // cgi[11]          0.02 bits
+    { 14,  1679,   1 }, // cgi[12]          0.02 bits
+    { 14,  1680,   1 }, // cgi[13]          0.02 bits
+    {  8,  1681,   0 }, // cgi[14]          8.00 bits
+    {  8,  1681,   0 }, // cgi[15+]         8.00 bits
+    { 14,  1681,   4 }, // door[0]          2.02 bits
+    {  8,  1685,   0 }, // door[1]          8.00 bits
+    {  8,  1685,   0 }, // door[2]          8.00 bits
+    {  8,  1685,   0 }, // door[3]          8.00 bits
+    {  8,  1685,   0 }, // door[4]          8.00 bits
+    {  8,  1685,   0 }, // door[5]          8.00 bits
+    {  8,  1685,   0 }, // door[6]          8.00 bits
+    {  8,  1685,   0 }, // door[7]          8.00 bits
+    {  8,  1685,   0 }, // door[8]          8.00 bits
+    {  8,  1685,   0 }, // door[9]          8.00 bits
+    {  8,  1685,   0 }, // door[10]         8.00 bits
+    {  8,  1685,   0 }, // door[11]         8.00 bits
+    {  8,  1685,   0 }, // door[12]         8.00 bits
+    {  8,  1685,   0 }, // door[13]         8.00 bits
+    {  8,  1685,   0 }, // door[14]         8.00 bits
+    {  8,  1685,   0 }, // door[15+]        8.00 bits
+};
+
+static const uint8_t record_rans_model_symbols[] = {
+    0, 12, 0, 11, 0, 15, 15, 16, 17, 18, 19, 20,
+    21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+    33, 34, 35, 0, 14, 0, 1, 76, 77, 78, 79, 80,
+    81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92,
+    93, 94, 95, 196, 115, 116, 117, 118, 119, 120, 193, 136,
+    137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148,
+    149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160,
+    161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172,
+    173, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184,
+    185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196,
+    197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208,
+    209, 210, 211, 212, 213, 214, 215, 216, 194, 40, 41, 42,
+    43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54,
+    55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66,
+    67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78,
+    79, 65, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145,
+    146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157,
+    158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169,
+    170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180, 181,
+    182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193,
+    194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205,
+    206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 0,
+    10, 20, 30, 40, 51, 61, 71, 81, 92, 102, 112, 122,
+    133, 143, 153, 163, 174, 184, 194, 204, 215, 225, 235, 245,
+    0, 10, 20, 31, 41, 51, 61, 72, 82, 92, 102, 113,
+    123, 133, 143, 154, 164, 174, 184, 195, 205, 215, 225, 236,
+    246, 66, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137,
+    138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149,
+    150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161,
+    162, 0, 5, 10, 15, 20, 25, 30, 35, 40, 46, 51,
+    56, 61, 66, 71, 76, 81, 87, 92, 97, 102, 107, 112,
+    117, 122, 128, 133, 138, 143, 148, 153, 158, 163, 168, 174,
+    179, 184, 189, 194, 199, 204, 209, 215, 220, 225, 230, 235,
+    240, 245, 250, 0, 10, 20, 31, 41, 51, 61, 72, 82,
+    92, 102, 113, 123, 133, 143, 154, 164, 174, 184, 195, 205,
+    215, 225, 236, 246, 68, 122, 123, 124, 125, 126, 127, 0,
+    1, 0, 1, 65, 66, 0, 252, 253, 254, 255, 0, 10,
+    20, 30, 40, 51, 61, 71, 81, 92, 102, 112, 122, 133,
+    143, 153, 163, 174, 184, 194, 204, 215, 225, 235, 245, 0,
+    10, 20, 31, 41, 51, 61, 72, 82, 92, 102, 113, 123,
+    133, 143, 154, 164, 174, 184, 195, 205, 215, 225, 236, 246,
+    65, 227, 228, 229, 230, 231, 0, 10, 20, 30, 40, 51,
+    61, 71, 81, 92, 102, 112, 122, 133, 143, 153, 163, 174,
+    184, 194, 204, 215, 225, 235, 245, 0, 10, 20, 31, 41,
+    51, 61, 72, 82, 92, 102, 113, 123, 133, 143, 154, 164,
+    174, 184, 195, 205, 215, 225, 236, 246, 66, 30, 31, 32,
+    33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44,
+    45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56,
+    57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68,
+    69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80,
+    81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92,
+    93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 109, 110, 0, 10, 20, 30, 40, 51,
+    61, 71, 81, 92, 102, 112, 122, 133, 143, 153, 163, 174,
+    184, 194, 204, 215, 225, 235, 245, 0, 10, 20, 31, 41,
+    51, 61, 72, 82, 92, 102, 113, 123, 133, 143, 154, 164,
+    174, 184, 195, 205, 215, 225, 236, 246, 0, 61, 62, 63,
+    64, 65, 66, 0, 1, 2, 3, 4, 5, 6, 7, 8,
+    9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+    21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+    33, 35, 36, 38, 40, 41, 43, 44, 46, 48, 49, 51,
+    52, 54, 56, 57, 59, 60, 62, 64, 65, 67, 68, 70,
+    72, 73, 75, 76, 78, 80, 81, 83, 84, 86, 88, 89,
+    91, 92, 94, 96, 97, 99, 100, 102, 104, 105, 107, 108,
+    110, 112, 113, 115, 116, 118, 120, 121, 123, 124, 126, 128,
+    129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140,
+    141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152,
+    153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164,
+    165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176,
+    177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188,
+    189, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200,
+    201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 212,
+    213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 224,
+    225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236,
+    237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248,
+    249, 250, 251, 252, 253, 254, 255, 0, 51, 102, 153, 204,
+    0, 51, 102, 154, 205, 60, 61, 62, 63, 64, 65, 66,
+    67, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+    11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+    23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+    35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58,
+    59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70,
+    71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82,
+    83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94,
+    95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106,
+    107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118,
+    119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130,
+    131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154,
+    155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166,
+    167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178,
+    179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190,
+    191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202,
+    203, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214,
+    215, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226,
+    227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238,
+    239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250,
+    251, 252, 253, 254, 255, 0, 1, 2, 3, 5, 6, 7,
+    8, 10, 11, 12, 14, 15, 16, 17, 19, 20, 21, 23,
+    24, 25, 26, 28, 29, 30, 32, 33, 34, 35, 37, 38,
+    39, 40, 42, 43, 44, 46, 47, 48, 49, 51, 52, 53,
+    55, 56, 57, 58, 60, 61, 62, 64, 65, 66, 67, 69,
+    70, 71, 72, 74, 75, 76, 78, 79, 80, 81, 83, 84,
+    85, 87, 88, 89, 90, 92, 93, 94, 96, 97, 98, 99,
+    101, 102, 103, 104, 106, 107, 108, 110, 111, 112, 113, 115,
+    116, 117, 119, 120, 121, 122, 124, 125, 126, 128, 129, 130,
+    131, 133, 134, 135, 136, 138, 139, 140, 142, 143, 144, 145,
+    147, 148, 149, 151, 152, 153, 154, 156, 157, 158, 160, 161,
+    162, 163, 165, 166, 167, 168, 170, 171, 172, 174, 175, 176,
+    177, 179, 180, 181, 183, 184, 185, 186, 188, 189, 190, 192,
+    193, 194, 195, 197, 198, 199, 200, 202, 203, 204, 206, 207,
+    208, 209, 211, 212, 213, 215, 216, 217, 218, 220, 221, 222,
+    224, 225, 226, 227, 229, 230, 231, 232, 234, 235, 236, 238,
+    239, 240, 241, 243, 244, 245, 247, 248, 249, 250, 252, 253,
+    254, 0, 10, 20, 31, 41, 51, 61, 72, 82, 92, 102,
+    113, 123, 133, 143, 154, 164, 174, 184, 195, 205, 215, 225,
+    236, 246, 4, 5, 6, 7, 8, 9, 10, 11, 12, 63,
+    64, 0, 6, 12, 19, 25, 32, 38, 44, 51, 57, 64,
+    70, 76, 83, 89, 96, 102, 108, 115, 121, 128, 131, 134,
+    137, 140, 144, 147, 150, 153, 156, 160, 163, 166, 169, 172,
+    176, 179, 192, 204, 217, 230, 243, 0, 51, 102, 153, 204,
+    0, 51, 102, 154, 205, 51, 57, 51, 54, 48, 48, 53,
+    48, 52, 56, 57, 48, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+    76, 77, 67, 85, 48, 48, 49, 50, 51, 52, 53, 54,
+    55, 56, 57, 48, 49, 50, 51, 52, 53, 54, 55, 56,
+    57, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 48,
+    49, 50, 51, 52, 53, 54, 55, 56, 57, 48, 49, 50,
+    51, 52, 53, 54, 55, 56, 57, 48, 49, 50, 51, 52,
+    53, 54, 55, 56, 57, 48, 49, 50, 51, 48, 49, 50,
+    51, 52, 53, 54, 55, 56, 57, 48, 49, 48, 49, 50,
+    51, 52, 53, 54, 55, 56, 57, 50, 51, 52, 53, 54,
+    55, 56, 32, 48, 49, 50, 48, 49, 50, 51, 52, 53,
+    54, 55, 56, 57, 48, 49, 50, 51, 52, 53, 48, 49,
+    50, 51, 52, 53, 54, 55, 56, 57, 48, 49, 50, 51,
+    52, 53, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+    46, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 57,
+    57, 57, 45, 48, 49, 45, 49, 45, 51, 49, 68, 52,
+    49, 67, 68, 79, 84,
+};
+
+static const uint16_t record_rans_model_freqs[] = {
+    16129, 16129, 16129, 16129, 16129, 16129, 776, 774, 771, 764, 771, 764,
+    769, 761, 770, 779, 755, 773, 774, 772, 767, 765, 771, 757,
+    767, 794, 755, 16129, 16129, 8079, 8051, 800, 821, 809, 798, 815,
+    799, 798, 817, 796, 836, 813, 819, 802, 806, 802, 795, 814,
+    795, 808, 805, 16129, 1698, 3235, 3224, 3227, 3223, 1527, 16129, 42,
+    206, 202, 210, 197, 201, 203, 205, 201, 210, 207, 201, 198,
+    197, 204, 198, 200, 195, 206, 199, 205, 205, 203, 199, 202,
+    203, 204, 203, 201, 207, 207, 204, 201, 198, 203, 207, 198,
+    196, 200, 207, 198, 200, 209, 200, 202, 207, 196, 197, 203,
+    198, 200, 203, 203, 205, 251, 200, 208, 197, 201, 205, 202,
+    200, 198, 206, 202, 203, 196, 200, 198, 200, 204, 211, 207,
+    201, 197, 203, 200, 198, 203, 199, 163, 16129, 409, 409, 391,
+    403, 410, 408, 400, 413, 408, 403, 393, 409, 411, 399, 408,
+    400, 399, 399, 402, 390, 402, 406, 403, 395, 390, 397, 409,
+    437, 411, 403, 407, 404, 404, 404, 403, 406, 409, 406, 406,
+    402, 16129, 208, 194, 209, 191, 213, 196, 208, 191, 215, 192,
+    214, 198, 204, 193, 208, 194, 206, 190, 212, 198, 206, 188,
+    207, 191, 216, 191, 211, 191, 211, 188, 209, 192, 209, 191,
+    215, 189, 207, 191, 262, 192, 215, 192, 212, 193, 212, 192,
+    209, 198, 206, 193, 208, 193, 212, 195, 212, 190, 212, 199,
+    208, 197, 203, 196, 203, 194, 214, 200, 215, 195, 215, 194,
+    210, 201, 209, 190, 205, 196, 211, 203, 215, 193, 8, 653,
+    635, 674, 646, 641, 645, 654, 646, 642, 643, 643, 651, 646,
+    649, 635, 639, 649, 654, 649, 630, 652, 654, 645, 639, 639,
+    653, 654, 654, 649, 643, 645, 635, 645, 649, 635, 643, 654,
+    674, 639, 630, 639, 651, 646, 646, 639, 652, 649, 646, 642,
+    641, 16129, 194, 204, 199, 191, 201, 207, 201, 202, 203, 206,
+    200, 202, 407, 409, 402, 407, 400, 401, 407, 404, 405, 398,
+    398, 408, 401, 400, 407, 388, 403, 409, 407, 397, 406, 409,
+    399, 400, 440, 398, 410, 400, 408, 407, 408, 410, 408, 400,
+    4, 378, 277, 374, 275, 371, 265, 373, 278, 378, 268, 370,
+    277, 368, 276, 377, 271, 366, 278, 365, 269, 377, 277, 367,
+    278, 369, 272, 367, 276, 379, 272, 373, 281, 379, 271, 370,
+    274, 378, 276, 406, 270, 366, 270, 374, 272, 374, 274, 371,
+    263, 377, 271, 649, 652, 637, 643, 637, 644, 650, 643, 655,
+    654, 650, 643, 642, 648, 655, 638, 630, 646, 654, 655, 637,
+    668, 639, 635, 649, 16129, 1298, 3223, 3230, 3204, 3227, 1952, 16129,
+    16129, 8069, 8061, 12419, 3711, 3711, 480, 3873, 4173, 3896, 642, 963,
+    653, 995, 639, 959, 640, 976, 636, 971, 646, 822, 321, 645,
+    324, 650, 316, 646, 328, 643, 319, 663, 477, 638, 641, 642,
+    663, 646, 645, 971, 959, 963, 477, 328, 324, 646, 640, 653,
+    638, 643, 650, 822, 976, 995, 641, 319, 316, 321, 636, 639,
+    16129, 164, 4182, 3852, 4197, 3738, 633, 643, 647, 640, 646, 656,
+    647, 651, 654, 653, 642, 642, 642, 646, 647, 646, 651, 637,
+    641, 639, 644, 647, 645, 670, 644, 633, 647, 637, 646, 653,
+    656, 643, 645, 641, 647, 642, 647, 647, 670, 639, 646, 642,
+    651, 640, 644, 644, 651, 642, 654, 646, 16129, 201, 204, 207,
+    202, 201, 194, 205, 203, 199, 205, 209, 201, 200, 201, 205,
+    199, 204, 198, 201, 201, 194, 194, 201, 203, 200, 199, 208,
+    207, 197, 202, 204, 203, 203, 202, 201, 210, 203, 202, 205,
+    201, 196, 203, 206, 206, 196, 199, 204, 194, 197, 200, 208,
+    206, 200, 198, 204, 204, 202, 206, 250, 206, 202, 197, 202,
+    205, 201, 207, 204, 206, 201, 199, 194, 201, 199, 203, 198,
+    200, 207, 208, 207, 199, 5, 639, 678, 639, 646, 642, 647,
+    653, 639, 639, 641, 646, 646, 652, 662, 638, 652, 640, 647,
+    646, 641, 643, 653, 649, 639, 636, 639, 653, 647, 662, 641,
+    647, 678, 649, 646, 638, 646, 653, 639, 639, 641, 652, 646,
+    639, 646, 636, 643, 640, 652, 639, 642, 21, 39, 121, 600,
+    2426, 9673, 3255, 378, 122, 122, 123, 163, 80, 195, 81, 164,
+    119, 120, 124, 209, 81, 157, 83, 162, 121, 122, 164, 160,
+    77, 159, 80, 165, 201, 119, 121, 166, 82, 162, 81, 105,
+    43, 41, 40, 83, 41, 42, 41, 81, 44, 43, 40, 117,
+    40, 42, 41, 82, 44, 40, 41, 83, 43, 38, 40, 80,
+    38, 41, 41, 155, 41, 38, 43, 82, 41, 40, 43, 82,
+    43, 43, 41, 83, 41, 39, 40, 118, 42, 37, 42, 85,
+    40, 40, 45, 78, 45, 38, 41, 82, 41, 42, 43, 167,
+    42, 44, 82, 79, 39, 85, 45, 76, 81, 41, 41, 160,
+    38, 39, 42, 120, 41, 39, 75, 82, 44, 83, 37, 80,
+    160, 42, 40, 123, 42, 39, 43, 120, 40, 38, 80, 83,
+    40, 122, 40, 81, 79, 45, 39, 125, 40, 42, 44, 124,
+    43, 41, 117, 85, 43, 84, 38, 80, 82, 39, 43, 118,
+    40, 41, 40, 160, 40, 41, 80, 79, 40, 81, 39, 79,
+    80, 39, 39, 234, 39, 40, 38, 117, 39, 40, 82, 75,
+    39, 81, 40, 80, 124, 42, 42, 118, 41, 40, 41, 124,
+    39, 44, 83, 86, 40, 122, 42, 81, 79, 44, 39, 125,
+    40, 41, 40, 120, 40, 43, 120, 83, 40, 87, 42, 80,
+    85, 42, 39, 123, 41, 42, 44, 3234, 3165, 3209, 3230, 3295,
+    3234, 3165, 3209, 3230, 3295, 3, 4, 16, 69, 266, 1071, 4284,
+    10423, 61, 62, 60, 59, 61, 63, 59, 60, 63, 62, 63,
+    59, 58, 61, 63, 59, 63, 55, 59, 60, 59, 57, 63,
+    58, 65, 60, 59, 57, 56, 63, 58, 64, 57, 60, 57,
+    58, 63, 61, 56, 58, 61, 61, 58, 64, 59, 60, 62,
+    57, 62, 61, 61, 58, 58, 59, 63, 57, 61, 60, 58,
+    63, 63, 62, 59, 60, 60, 61, 63, 57, 61, 60, 61,
+    59, 60, 62, 59, 59, 60, 57, 60, 61, 60, 61, 59,
+    63, 61, 61, 61, 63, 60, 64, 61, 62, 61, 61, 63,
+    57, 64, 63, 60, 63, 62, 56, 57, 65, 59, 60, 56,
+    62, 58, 62, 62, 62, 61, 62, 59, 62, 61, 67, 57,
+    62, 63, 61, 63, 62, 57, 58, 58, 58, 118, 121, 125,
+    122, 123, 119, 119, 123, 121, 116, 117, 121, 124, 114, 123,
+    119, 120, 118, 123, 260, 123, 119, 121, 114, 118, 125, 119,
+    115, 114, 120, 124, 122, 115, 114, 119, 118, 125, 118, 119,
+    117, 123, 116, 117, 125, 123, 118, 117, 113, 121, 124, 118,
+    121, 30, 34, 28, 28, 31, 32, 27, 29, 29, 29, 31,
+    28, 30, 30, 30, 31, 30, 28, 31, 32, 30, 29, 31,
+    30, 29, 28, 30, 31, 31, 30, 30, 30, 31, 29, 33,
+    30, 29, 32, 30, 31, 31, 28, 32, 29, 31, 29, 28,
+    29, 32, 31, 31, 30, 31, 31, 32, 31, 32, 27, 29,
+    31, 31, 28, 32, 30, 32, 30, 28, 31, 35, 29, 31,
+    30, 31, 33, 32, 27, 250, 25, 83, 23, 140, 24, 82,
+    27, 253, 25, 78, 25, 144, 24, 81, 25, 248, 24, 86,
+    26, 135, 22, 81, 23, 260, 24, 85, 23, 141, 26, 84,
+    24, 253, 25, 83, 25, 139, 24, 83, 25, 249, 23, 84,
+    25, 133, 23, 84, 24, 251, 22, 84, 22, 133, 22, 82,
+    22, 257, 24, 78, 23, 140, 25, 78, 24, 256, 24, 76,
+    24, 133, 25, 84, 24, 255, 23, 83, 26, 135, 23, 82,
+    21, 249, 23, 79, 23, 132, 25, 80, 24, 248, 24, 83,
+    25, 143, 22, 77, 24, 245, 25, 82, 23, 139, 23, 75,
+    25, 257, 23, 83, 22, 145, 25, 80, 24, 356, 23, 81,
+    21, 143, 23, 80, 25, 255, 23, 81, 22, 144, 24, 81,
+    24, 251, 23, 87, 25, 140, 23, 84, 25, 248, 25, 79,
+    25, 140, 23, 84, 25, 244, 25, 79, 25, 140, 24, 77,
+    23, 257, 24, 82, 25, 140, 24, 83, 24, 247, 23, 89,
+    25, 136, 22, 82, 22, 256, 25, 80, 25, 138, 26, 76,
+    23, 252, 23, 79, 24, 140, 24, 84, 23, 254, 26, 79,
+    24, 139, 25, 84, 22, 245, 23, 80, 20, 140, 24, 84,
+    25, 642, 646, 638, 651, 648, 643, 649, 643, 631, 678, 649,
+    649, 640, 647, 638, 642, 642, 655, 655, 645, 643, 643, 638,
+    649, 649, 1796, 1768, 1793, 1781, 1809, 1798, 1790, 1803, 1799, 4706,
+    11424, 485, 324, 325, 331, 630, 315, 320, 328, 648, 325, 317,
+    323, 633, 329, 319, 321, 648, 318, 317, 321, 649, 320, 321,
+    315, 675, 327, 332, 329, 639, 316, 320, 324, 638, 325, 330,
+    159, 324, 329, 333, 332, 325, 331, 3216, 3256, 3226, 3203, 3232,
+    3216, 3256, 3226, 3203, 3232, 16129, 16129, 16129, 16129, 16129, 16129, 16129,
+    16129, 16129, 8051, 8079, 1615, 1618, 1608, 1613, 1630, 1608, 1600, 1616,
+    1615, 1615, 1612, 1609, 1620, 1622, 1608, 1616, 1611, 1618, 1633, 1589,
+    16129, 16129, 16129, 16129, 16129, 1610, 1615, 1638, 1616, 1619, 1601, 1612,
+    1596, 1617, 1614, 1613, 1615, 1610, 1625, 1608, 1606, 1612, 1622, 1596,
+    1631, 1603, 1604, 1631, 1612, 1612, 1619, 1617, 1608, 1620, 1612, 1600,
+    1603, 1602, 1616, 1620, 1618, 1601, 1650, 1599, 1629, 1641, 1609, 1598,
+    1608, 1606, 1605, 1625, 1626, 1603, 1617, 1627, 1635, 1619, 1595, 1601,
+    1615, 1608, 1608, 1618, 1612, 4737, 5305, 5299, 791, 1545, 1890, 1588,
+    1613, 1595, 1581, 1608, 1589, 1577, 1552, 12042, 4088, 1382, 2693, 2630,
+    1365, 1331, 1361, 1325, 1361, 1352, 1338, 16129, 1593, 3217, 3247, 3231,
+    3235, 1611, 16129, 6724, 6721, 2686, 2030, 2012, 1988, 2020, 1350, 1364,
+    1353, 1337, 1350, 1334, 2706, 2686, 2686, 2695, 2662, 2699, 1595, 1616,
+    1620, 1605, 1611, 1622, 1633, 1617, 1604, 1615, 2696, 2678, 2686, 2672,
+    2694, 2708, 1616, 1606, 1647, 1619, 1621, 1599, 1610, 1615, 1606, 1599,
+    16129, 1631, 1620, 1596, 1610, 1612, 1612, 1642, 1608, 1602, 1605, 16129,
+    16129, 16129, 16129, 16129, 16129, 16129, 16129, 16129, 16129, 16129, 16129, 16129,
+    16129, 4031, 4047, 4016, 4038,
+};
+
+#endif // RECORD_RANS_TABLES_H
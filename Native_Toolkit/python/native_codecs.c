@@ -0,0 +1,537 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// CPython extension over codec/container_codecs: the payload bytes of the
+// firmware and the host tools, for the Python senders and scripts.
+//
+//   encode(codec, doc) -> bytes
+//   encode_batch(codec, docs) -> (payloads: bytes, offsets: array('I'))
+//   decode(codec, payload) -> dict
+//   decode_batch(codec, payloads, offsets) -> list of dict
+//   decode_columns(codec, payloads, offsets) -> dict of columns
+//   generate(n, seed=1, time_base=0, spread=3600) -> list of dict
+//
+// A document is the senders' dict: the 20 keys of container_record_field_names
+// with string values. cbor and msgpack write the strings exactly as given, in
+// document order, so the bytes equal cbor2.dumps() / msgpack.packb() of a
+// sender dict. protobuf and the struct codecs also take numbers and acc as a
+// sequence of three. Batches are a concatenated buffer plus n + 1 uint32
+// offsets; any buffer of uint32 is accepted (array('I'), numpy.uint32), and
+// the returned ones are views for numpy.frombuffer. decode_columns returns
+// numeric fields as array('B') / array('f') (acc as 3 floats per record) and
+// string fields as lists.
+//
+// Batches are converted to C strings under the GIL, then encoded or decoded
+// without it, CHUNK records at a time.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "container_codecs.h"
+#include "record_rans.h"
+
+#define CHUNK 1024                        // records converted per GIL release
+
+typedef char values_t[CONTAINER_RECORD_FIELDS][CONTAINER_RECORD_VALUE_MAX];
+
+static PyObject *array_type;              // array.array
+static PyObject *field_keys[CONTAINER_RECORD_FIELDS];   // interned key strings
+
+// ================= ARGUMENTS =================
+static int codec_arg(PyObject *obj, void *out) {
+    const char *name = PyUnicode_Check(obj) ? PyUnicode_AsUTF8(obj) : NULL;
+    if (!name) {
+        if (!PyErr_Occurred()) PyErr_SetString(PyExc_TypeError, "codec must be a str");
+        return 0;
+    }
+    if (container_codec_parse(name, out)) {
+        PyErr_Format(PyExc_ValueError, "unknown codec '%s'", name);
+        return 0;
+    }
+    return 1;
+}
+
+static int is_map_codec(container_codec_t codec) {
+    return codec == CONTAINER_CODEC_CBOR || codec == CONTAINER_CODEC_MSGPACK;
+}
+
+static int copy_utf8(PyObject *s, char *dst, const char *key) {
+    Py_ssize_t len;
+    const char *utf8 = PyUnicode_AsUTF8AndSize(s, &len);
+    if (!utf8) return -1;
+    if (len >= CONTAINER_RECORD_VALUE_MAX) {
+        PyErr_Format(PyExc_ValueError, "'%s' is longer than %d bytes", key, CONTAINER_RECORD_VALUE_MAX - 1);
+        return -1;
+    }
+    memcpy(dst, utf8, (size_t)len + 1);
+    return 0;
+}
+
+// str() of a number, or "x y z" for a sequence (acc)
+static int copy_value(PyObject *v, char *dst, const char *key) {
+    if (PyUnicode_Check(v)) return copy_utf8(v, dst, key);
+    if (PyList_Check(v) || PyTuple_Check(v)) {
+        PyObject *sep = PyUnicode_FromString(" ");
+        PyObject *parts = PySequence_List(v);
+        PyObject *joined = NULL;
+        if (sep && parts) {
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(parts); i++) {
+                PyObject *s = PyObject_Str(PyList_GET_ITEM(parts, i));
+                if (!s) goto done;
+                PyList_SetItem(parts, i, s);
+            }
+            joined = PyUnicode_Join(sep, parts);
+        }
+    done:
+        Py_XDECREF(sep);
+        Py_XDECREF(parts);
+        if (!joined) return -1;
+        int rc = copy_utf8(joined, dst, key);
+        Py_DECREF(joined);
+        return rc;
+    }
+    if (PyLong_Check(v) || PyFloat_Check(v)) {
+        PyObject *s = PyObject_Str(v);
+        if (!s) return -1;
+        int rc = copy_utf8(s, dst, key);
+        Py_DECREF(s);
+        return rc;
+    }
+    PyErr_Format(PyExc_TypeError, "'%s' must be a str or a number", key);
+    return -1;
+}
+
+static int doc_values(container_codec_t codec, PyObject *doc, values_t values) {
+    if (!PyMapping_Check(doc)) {
+        PyErr_SetString(PyExc_TypeError, "document must be a mapping");
+        return -1;
+    }
+    for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) {
+        const char *key = container_record_field_names[f];
+        PyObject *v = PyDict_Check(doc) ? Py_XNewRef(PyDict_GetItemWithError(doc, field_keys[f]))
+                                        : PyObject_GetItem(doc, field_keys[f]);
+        if (!v) {
+            if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_KeyError)) {
+                PyErr_Clear();
+                PyErr_Format(PyExc_KeyError, "document has no '%s'", key);
+            }
+            return -1;
+        }
+        // The map codecs write text; a number would change the bytes
+        int rc;
+        if (is_map_codec(codec) && !PyUnicode_Check(v)) {
+            PyErr_Format(PyExc_TypeError, "'%s' must be a str for %s", key, container_codec_name(codec));
+            rc = -1;
+        } else {
+            rc = copy_value(v, values[f], key);
+        }
+        Py_DECREF(v);
+        if (rc) return -1;
+    }
+    return 0;
+}
+
+static PyObject *values_dict(values_t values) {
+    PyObject *d = PyDict_New();
+    for (int f = 0; d && f < CONTAINER_RECORD_FIELDS; f++) {
+        PyObject *v = PyUnicode_DecodeUTF8(values[f], (Py_ssize_t)strlen(values[f]), "replace");
+        if (!v || PyDict_SetItem(d, field_keys[f], v)) {
+            Py_XDECREF(v);
+            Py_CLEAR(d);
+            break;
+        }
+        Py_DECREF(v);
+    }
+    return d;
+}
+
+static size_t encode_one(container_codec_t codec, values_t values, uint8_t *buf) {
+    const char *v[CONTAINER_RECORD_FIELDS];
+    for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) v[f] = values[f];
+    return container_codec_encode_values(codec, v, buf, CONTAINER_CODEC_MAX_PAYLOAD);
+}
+
+static PyObject *new_array(const char *typecode, const void *data, size_t bytes) {
+    PyObject *a = PyObject_CallFunction(array_type, "s", typecode);
+    if (!a || !bytes) return a;
+    PyObject *rc = PyObject_CallMethod(a, "frombytes", "y#", (const char *)data, (Py_ssize_t)bytes);
+    if (!rc) Py_CLEAR(a);
+    Py_XDECREF(rc);
+    return a;
+}
+
+// payloads + n + 1 uint32 offsets, checked against each other
+typedef struct {
+    Py_buffer payloads, offsets;
+    size_t n;
+} batch_t;
+
+static int batch_open(batch_t *b, PyObject *payloads, PyObject *offsets) {
+    memset(b, 0, sizeof(*b));
+    if (PyObject_GetBuffer(payloads, &b->payloads, PyBUF_SIMPLE)) return -1;
+    if (PyObject_GetBuffer(offsets, &b->offsets, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS)) {
+        PyBuffer_Release(&b->payloads);
+        return -1;
+    }
+    const char *fmt = b->offsets.format ? b->offsets.format : "B";
+    char last = fmt[strlen(fmt) - 1];
+    if (b->offsets.itemsize != 4 || (last != 'I' && last != 'L') || fmt[0] == '>' || fmt[0] == '!') {
+        PyErr_SetString(PyExc_TypeError, "offsets must be native uint32 (array('I'), numpy.uint32)");
+        goto fail;
+    }
+    size_t count = (size_t)(b->offsets.len / 4);
+    const uint32_t *off = b->offsets.buf;
+    if (count == 0 || off[0] != 0 || off[count - 1] != (uint64_t)b->payloads.len) {
+        PyErr_SetString(PyExc_ValueError, "offsets must run from 0 to len(payloads)");
+        goto fail;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if (off[i] < off[i - 1]) {
+            PyErr_Format(PyExc_ValueError, "offsets decrease at %zu", i);
+            goto fail;
+        }
+    }
+    b->n = count - 1;
+    return 0;
+fail:
+    PyBuffer_Release(&b->payloads);
+    PyBuffer_Release(&b->offsets);
+    return -1;
+}
+
+static void batch_close(batch_t *b) {
+    PyBuffer_Release(&b->payloads);
+    PyBuffer_Release(&b->offsets);
+}
+
+// Decode records [first, first + count) of the batch into values; returns
+// the index of the first failure, or -1
+static Py_ssize_t decode_chunk(container_codec_t codec, const batch_t *b, size_t first, size_t count,
+                               values_t *values) {
+    const uint8_t *p = b->payloads.buf;
+    const uint32_t *off = b->offsets.buf;
+    Py_ssize_t bad = -1;
+    Py_BEGIN_ALLOW_THREADS
+    for (size_t i = 0; i < count; i++) {
+        size_t r = first + i;
+        if (container_codec_decode(codec, p + off[r], off[r + 1] - off[r], values[i])) {
+            bad = (Py_ssize_t)r;
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+    return bad;
+}
+
+// ================= ENCODE =================
+static PyObject *py_encode(PyObject *self, PyObject *args) {
+    (void)self;
+    container_codec_t codec;
+    PyObject *doc;
+    if (!PyArg_ParseTuple(args, "O&O:encode", codec_arg, &codec, &doc)) return NULL;
+    values_t values;
+    uint8_t buf[CONTAINER_CODEC_MAX_PAYLOAD];
+    if (doc_values(codec, doc, values)) return NULL;
+    size_t len = encode_one(codec, values, buf);
+    if (!len) return PyErr_Format(PyExc_ValueError, "document does not encode as %s", container_codec_name(codec));
+    return PyBytes_FromStringAndSize((const char *)buf, (Py_ssize_t)len);
+}
+
+static PyObject *py_encode_batch(PyObject *self, PyObject *args) {
+    (void)self;
+    container_codec_t codec;
+    PyObject *docs;
+    if (!PyArg_ParseTuple(args, "O&O:encode_batch", codec_arg, &codec, &docs)) return NULL;
+    PyObject *seq = PySequence_Fast(docs, "docs must be a sequence of documents");
+    if (!seq) return NULL;
+    size_t n = (size_t)PySequence_Fast_GET_SIZE(seq);
+
+    values_t *values = PyMem_Malloc(CHUNK * sizeof(*values));
+    uint32_t *offsets = PyMem_Malloc((n + 1) * sizeof(*offsets));
+    size_t cap = (n ? n : 1) * 160, used = 0;        // grows past a typical struct-zlib record
+    uint8_t *out = PyMem_Malloc(cap);
+    PyObject *result = NULL;
+    if (!values || !offsets || !out) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    offsets[0] = 0;
+    for (size_t first = 0; first < n; first += CHUNK) {
+        size_t count = n - first < CHUNK ? n - first : CHUNK;
+        for (size_t i = 0; i < count; i++) {
+            if (doc_values(codec, PySequence_Fast_GET_ITEM(seq, (Py_ssize_t)(first + i)), values[i])) {
+                PyObject *type, *value, *tb;
+                PyErr_Fetch(&type, &value, &tb);
+                PyErr_Format(type, "document %zu: %S", first + i, value);
+                Py_XDECREF(type);
+                Py_XDECREF(value);
+                Py_XDECREF(tb);
+                goto done;
+            }
+        }
+        if (cap - used < count * CONTAINER_CODEC_MAX_PAYLOAD) {
+            size_t want = used + count * CONTAINER_CODEC_MAX_PAYLOAD;
+            cap = cap * 2 > want ? cap * 2 : want;
+            uint8_t *grown = PyMem_Realloc(out, cap);
+            if (!grown) {
+                PyErr_NoMemory();
+                goto done;
+            }
+            out = grown;
+        }
+        Py_ssize_t bad = -1;
+        Py_BEGIN_ALLOW_THREADS
+        for (size_t i = 0; i < count; i++) {
+            size_t len = encode_one(codec, values[i], out + used);
+            if (!len) {
+                bad = (Py_ssize_t)(first + i);
+                break;
+            }
+            used += len;
+            offsets[first + i + 1] = (uint32_t)used;
+        }
+        Py_END_ALLOW_THREADS
+        if (bad >= 0) {
+            PyErr_Format(PyExc_ValueError, "document %zd does not encode as %s", bad, container_codec_name(codec));
+            goto done;
+        }
+    }
+
+    PyObject *payloads = PyBytes_FromStringAndSize((const char *)out, (Py_ssize_t)used);
+    PyObject *off = payloads ? new_array("I", offsets, (n + 1) * sizeof(*offsets)) : NULL;
+    if (off) result = PyTuple_Pack(2, payloads, off);
+    Py_XDECREF(payloads);
+    Py_XDECREF(off);
+done:
+    PyMem_Free(values);
+    PyMem_Free(offsets);
+    PyMem_Free(out);
+    Py_DECREF(seq);
+    return result;
+}
+
+// ================= DECODE =================
+static PyObject *py_decode(PyObject *self, PyObject *args) {
+    (void)self;
+    container_codec_t codec;
+    Py_buffer payload;
+    if (!PyArg_ParseTuple(args, "O&y*:decode", codec_arg, &codec, &payload)) return NULL;
+    values_t values;
+    int rc = container_codec_decode(codec, payload.buf, (size_t)payload.len, values);
+    PyBuffer_Release(&payload);
+    if (rc) return PyErr_Format(PyExc_ValueError, "not a %s payload", container_codec_name(codec));
+    return values_dict(values);
+}
+
+static PyObject *py_decode_batch(PyObject *self, PyObject *args) {
+    (void)self;
+    container_codec_t codec;
+    PyObject *payloads, *offsets;
+    batch_t b;
+    if (!PyArg_ParseTuple(args, "O&OO:decode_batch", codec_arg, &codec, &payloads, &offsets)) return NULL;
+    if (batch_open(&b, payloads, offsets)) return NULL;
+
+    values_t *values = PyMem_Malloc(CHUNK * sizeof(*values));
+    PyObject *list = values ? PyList_New((Py_ssize_t)b.n) : PyErr_NoMemory();
+    for (size_t first = 0; list && first < b.n; first += CHUNK) {
+        size_t count = b.n - first < CHUNK ? b.n - first : CHUNK;
+        Py_ssize_t bad = decode_chunk(codec, &b, first, count, values);
+        if (bad >= 0) {
+            PyErr_Format(PyExc_ValueError, "payload %zd is not a %s payload", bad, container_codec_name(codec));
+            Py_CLEAR(list);
+            break;
+        }
+        for (size_t i = 0; i < count; i++) {
+            PyObject *d = values_dict(values[i]);
+            if (!d) {
+                Py_CLEAR(list);
+                break;
+            }
+            PyList_SET_ITEM(list, (Py_ssize_t)(first + i), d);
+        }
+    }
+    PyMem_Free(values);
+    batch_close(&b);
+    return list;
+}
+
+// Field layout of the columns: strings, uint8, float32 (acc is three)
+enum { COL_STR, COL_U8, COL_F32 };
+static const uint8_t column_kind[CONTAINER_RECORD_FIELDS] = {
+    COL_STR, COL_STR, COL_STR, COL_U8, COL_STR, COL_U8, COL_U8, COL_F32, COL_F32, COL_F32,
+    COL_F32, COL_STR, COL_U8, COL_F32, COL_F32, COL_F32, COL_F32, COL_F32, COL_U8, COL_F32
+};
+
+static void record_columns(const container_record_t *rec, size_t i, uint8_t *u8[], float *f32[]) {
+    const uint8_t u[CONTAINER_RECORD_FIELDS] = {
+        [3] = rec->rssi, [5] = rec->ble_m, [6] = rec->bat_soc, [12] = rec->gnss, [18] = rec->nsat
+    };
+    const float f[CONTAINER_RECORD_FIELDS] = {
+        [8] = rec->temperature, [9] = rec->humidity, [10] = rec->pressure, [13] = rec->latitude,
+        [14] = rec->longitude, [15] = rec->altitude, [16] = rec->speed, [17] = rec->heading, [19] = rec->hdop
+    };
+    for (int c = 0; c < CONTAINER_RECORD_FIELDS; c++) {
+        if (column_kind[c] == COL_U8) u8[c][i] = u[c];
+        else if (c == 7) memcpy(&f32[c][i * 3], rec->acc, sizeof(rec->acc));
+        else if (column_kind[c] == COL_F32) f32[c][i] = f[c];
+    }
+}
+
+static PyObject *py_decode_columns(PyObject *self, PyObject *args) {
+    (void)self;
+    container_codec_t codec;
+    PyObject *payloads, *offsets;
+    batch_t b;
+    if (!PyArg_ParseTuple(args, "O&OO:decode_columns", codec_arg, &codec, &payloads, &offsets)) return NULL;
+    if (batch_open(&b, payloads, offsets)) return NULL;
+
+    uint8_t *u8[CONTAINER_RECORD_FIELDS] = { 0 };
+    float *f32[CONTAINER_RECORD_FIELDS] = { 0 };
+    PyObject *strs[CONTAINER_RECORD_FIELDS] = { 0 };
+    PyObject *result = NULL;
+    values_t *values = PyMem_Malloc(CHUNK * sizeof(*values));
+    int ok = values != NULL;
+    for (int c = 0; ok && c < CONTAINER_RECORD_FIELDS; c++) {
+        size_t n = b.n ? b.n : 1;
+        if (column_kind[c] == COL_U8) ok = (u8[c] = PyMem_Malloc(n)) != NULL;
+        else if (column_kind[c] == COL_F32) ok = (f32[c] = PyMem_Malloc(n * (c == 7 ? 3 : 1) * sizeof(float))) != NULL;
+    }
+    if (!ok) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (int c = 0; c < CONTAINER_RECORD_FIELDS; c++) {
+        if (column_kind[c] == COL_STR && !(strs[c] = PyList_New((Py_ssize_t)b.n))) goto done;
+    }
+
+    for (size_t first = 0; first < b.n; first += CHUNK) {
+        size_t count = b.n - first < CHUNK ? b.n - first : CHUNK;
+        Py_ssize_t bad = decode_chunk(codec, &b, first, count, values);
+        for (size_t i = 0; bad < 0 && i < count; i++) {
+            const char *v[CONTAINER_RECORD_FIELDS];
+            container_record_t rec;
+            for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) v[f] = values[i][f];
+            if (container_record_parse(v, &rec)) bad = (Py_ssize_t)(first + i);
+            else record_columns(&rec, first + i, u8, f32);
+        }
+        if (bad >= 0) {
+            PyErr_Format(PyExc_ValueError, "payload %zd is not a %s payload", bad, container_codec_name(codec));
+            goto done;
+        }
+        for (size_t i = 0; i < count; i++) {
+            for (int c = 0; c < CONTAINER_RECORD_FIELDS; c++) {
+                if (column_kind[c] != COL_STR) continue;
+                PyObject *s = PyUnicode_DecodeUTF8(values[i][c], (Py_ssize_t)strlen(values[i][c]), "replace");
+                if (!s) goto done;
+                PyList_SET_ITEM(strs[c], (Py_ssize_t)(first + i), s);
+            }
+        }
+    }
+
+    result = PyDict_New();
+    for (int c = 0; result && c < CONTAINER_RECORD_FIELDS; c++) {
+        PyObject *col;
+        if (column_kind[c] == COL_STR) col = Py_NewRef(strs[c]);
+        else if (column_kind[c] == COL_U8) col = new_array("B", u8[c], b.n);
+        else col = new_array("f", f32[c], b.n * (c == 7 ? 3 : 1) * sizeof(float));
+        if (!col || PyDict_SetItemString(result, container_record_field_names[c], col)) Py_CLEAR(result);
+        Py_XDECREF(col);
+    }
+done:
+    for (int c = 0; c < CONTAINER_RECORD_FIELDS; c++) {
+        PyMem_Free(u8[c]);
+        PyMem_Free(f32[c]);
+        Py_XDECREF(strs[c]);
+    }
+    PyMem_Free(values);
+    batch_close(&b);
+    return result;
+}
+
+// ================= GENERATOR =================
+static PyObject *py_generate(PyObject *self, PyObject *args, PyObject *kwargs) {
+    (void)self;
+    static char *kwlist[] = { "n", "seed", "time_base", "spread", NULL };
+    Py_ssize_t n;
+    unsigned long long seed = 1;
+    long long time_base = 0;
+    unsigned int spread = 3600;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|KLI:generate", kwlist, &n, &seed, &time_base, &spread))
+        return NULL;
+    if (n < 0) return PyErr_Format(PyExc_ValueError, "n must be >= 0");
+
+    container_record_gen_t g;
+    container_record_gen_init(&g, seed, time_base ? (time_t)time_base : time(NULL), spread);
+    PyObject *list = PyList_New(n);
+    for (Py_ssize_t i = 0; list && i < n; i++) {
+        container_record_t rec;
+        values_t values;
+        container_record_generate(&g, &rec);
+        container_record_format(&rec, values);
+        PyObject *d = values_dict(values);
+        if (!d) Py_CLEAR(list);
+        else PyList_SET_ITEM(list, i, d);
+    }
+    return list;
+}
+
+// ================= MODULE =================
+static PyMethodDef methods[] = {
+    { "encode", py_encode, METH_VARARGS, "encode(codec, doc) -> bytes" },
+    { "encode_batch", py_encode_batch, METH_VARARGS,
+      "encode_batch(codec, docs) -> (payloads, offsets): concatenated payloads and n + 1 uint32 offsets" },
+    { "decode", py_decode, METH_VARARGS, "decode(codec, payload) -> dict" },
+    { "decode_batch", py_decode_batch, METH_VARARGS, "decode_batch(codec, payloads, offsets) -> list of dict" },
+    { "decode_columns", py_decode_columns, METH_VARARGS,
+      "decode_columns(codec, payloads, offsets) -> dict: array('B') / array('f') per numeric field, "
+      "lists for strings" },
+    { "generate", (PyCFunction)(void (*)(void))py_generate, METH_VARARGS | METH_KEYWORDS,
+      "generate(n, seed=1, time_base=0, spread=3600) -> list of dict (container_record_generate)" },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "native_codecs", "Native container payload codecs", -1, methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_native_codecs(void) {
+    // Build the rANS decoder tables now, before decodes run without the GIL
+    if (record_rans_decoder_init()) return PyErr_NoMemory();
+    for (int f = 0; f < CONTAINER_RECORD_FIELDS; f++) {
+        if (!field_keys[f] && !(field_keys[f] = PyUnicode_InternFromString(container_record_field_names[f])))
+            return NULL;
+    }
+    if (!array_type) {
+        PyObject *array = PyImport_ImportModule("array");
+        if (!array) return NULL;
+        array_type = PyObject_GetAttrString(array, "array");
+        Py_DECREF(array);
+        if (!array_type) return NULL;
+    }
+
+    PyObject *m = PyModule_Create(&module);
+    if (!m) return NULL;
+    PyObject *codecs = PyTuple_New(CONTAINER_CODEC_COUNT);
+    for (int c = 0; codecs && c < CONTAINER_CODEC_COUNT; c++) {
+        PyTuple_SET_ITEM(codecs, c, PyUnicode_FromString(container_codec_name((container_codec_t)c)));
+    }
+    PyObject *fields = PyTuple_New(CONTAINER_RECORD_FIELDS);
+    for (int f = 0; fields && f < CONTAINER_RECORD_FIELDS; f++) {
+        PyTuple_SET_ITEM(fields, f, PyUnicode_FromString(container_record_field_names[f]));
+    }
+    if (PyModule_AddObject(m, "CODECS", codecs) || PyModule_AddObject(m, "FIELDS", fields) ||
+        PyModule_AddIntConstant(m, "MAX_PAYLOAD", CONTAINER_CODEC_MAX_PAYLOAD) ||
+        PyModule_AddIntConstant(m, "RANS_MODEL_VERSION", record_rans_model_version())) {
+        Py_DECREF(m);
+        return NULL;
+    }
+    return m;
+}
@@ -0,0 +1,339 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Host simulator for the shock-event capture path (firmware/accel_burst.c).
+//
+// Generates a synthetic container accelerometer signal (gravity vector from
+// the sample records, sensor noise, road vibration, injected impacts, drops
+// and rattles), feeds it sample by sample through the firmware detector,
+// performs the uplink every --uplink-s seconds and decodes every attached
+// burst again. Exits non-zero if a burst does not round-trip or if the
+// detection recall drops below --min-recall.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../firmware/accel_burst.h"
+
+#define MAX_EVENTS 4096
+#define MATCH_WINDOW_MS 60
+
+typedef enum { EVENT_IMPACT, EVENT_DROP, EVENT_RATTLE } event_kind_t;
+
+typedef struct {
+    event_kind_t kind;
+    uint32_t start;                       // sample index
+    uint32_t length;
+    float amplitude_mg;
+    float dir[3];
+    int detected;
+} sim_event_t;
+
+typedef struct {
+    uint16_t rate;
+    double seconds;
+    double uplink_s;
+    double events_per_min;
+    size_t budget;
+    uint32_t seed;
+    double min_recall;
+    int verbose;
+    const char *csv_path;
+} sim_options_t;
+
+static uint64_t rng_state;
+
+static double rng_uniform(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (double)(rng_state >> 11) / 9007199254740992.0;
+}
+
+static double rng_gauss(void) {
+    double u1 = rng_uniform(), u2 = rng_uniform();
+    if (u1 < 1e-12) u1 = 1e-12;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void random_direction(float dir[3]) {
+    double x = rng_gauss(), y = rng_gauss(), z = rng_gauss();
+    double n = sqrt(x * x + y * y + z * z);
+    if (n < 1e-9) n = 1.0;
+    dir[0] = (float)(x / n);
+    dir[1] = (float)(y / n);
+    dir[2] = (float)(z / n);
+}
+
+static const char *kind_name(event_kind_t kind) {
+    return kind == EVENT_IMPACT ? "impact" : kind == EVENT_DROP ? "drop" : "rattle";
+}
+
+static size_t schedule_events(const sim_options_t *opt, sim_event_t *events) {
+    size_t n = 0;
+    double t = 5.0;                       // leave the detector a warm-up period
+    double mean_gap = 60.0 / (opt->events_per_min > 0 ? opt->events_per_min : 1.0);
+
+    while (n < MAX_EVENTS) {
+        t += -log(1.0 - rng_uniform()) * mean_gap + 2.5;   // keep events apart
+        if (t >= opt->seconds - 2.0) break;
+
+        sim_event_t *e = &events[n++];
+        double pick = rng_uniform();
+        e->start = (uint32_t)(t * opt->rate);
+        e->detected = 0;
+        random_direction(e->dir);
+        if (pick < 0.55) {
+            e->kind = EVENT_IMPACT;       // half-sine, 2-8 g, 4-15 ms
+            e->amplitude_mg = (float)(2000 + rng_uniform() * 6000);
+            e->length = (uint32_t)((0.004 + rng_uniform() * 0.011) * opt->rate) + 1;
+        } else if (pick < 0.8) {
+            e->kind = EVENT_DROP;         // 150-400 ms free fall, then impact
+            e->amplitude_mg = (float)(3000 + rng_uniform() * 5000);
+            e->length = (uint32_t)((0.15 + rng_uniform() * 0.25) * opt->rate);
+        } else {
+            e->kind = EVENT_RATTLE;       // 200 ms of 300-600 mg vibration
+            e->amplitude_mg = (float)(300 + rng_uniform() * 300);
+            e->length = (uint32_t)(0.2 * opt->rate);
+        }
+    }
+    return n;
+}
+
+// Deviation from gravity contributed by an event at sample i
+static void event_signal(const sim_event_t *e, uint32_t i, uint16_t rate, const float gravity[3],
+                         float out[3]) {
+    out[0] = out[1] = out[2] = 0.0f;
+    if (i < e->start) return;
+    uint32_t k = i - e->start;
+
+    switch (e->kind) {
+    case EVENT_IMPACT:
+        if (k < e->length) {
+            float a = e->amplitude_mg * (float)sin(M_PI * (k + 0.5) / e->length);
+            for (int ax = 0; ax < 3; ax++) out[ax] = a * e->dir[ax];
+        }
+        break;
+    case EVENT_DROP: {
+        uint32_t impact_len = rate / 100 + 1;
+        if (k < e->length) {
+            for (int ax = 0; ax < 3; ax++) out[ax] = -gravity[ax];     // free fall
+        } else if (k < e->length + impact_len) {
+            float a = e->amplitude_mg * (float)sin(M_PI * (k - e->length + 0.5) / impact_len);
+            for (int ax = 0; ax < 3; ax++) out[ax] = a * e->dir[ax];
+        }
+        break;
+    }
+    case EVENT_RATTLE:
+        if (k < e->length) {
+            float a = e->amplitude_mg * (float)sin(2.0 * M_PI * 35.0 * k / rate);
+            for (int ax = 0; ax < 3; ax++) out[ax] = a * e->dir[ax];
+        }
+        break;
+    }
+}
+
+// What the receiver should see for sample i after decimation and quantization
+static int16_t expected(const accel_sample_t *s, size_t i, const accel_burst_info_t *info, int axis) {
+    int32_t sum = 0;
+    for (size_t k = 0; k < info->decimation; k++) {
+        const accel_sample_t *p = &s[i * info->decimation + k];
+        sum += axis == 0 ? p->x : axis == 1 ? p->y : p->z;
+    }
+    int32_t q = (sum / (int32_t)info->decimation) >> info->quant_shift;
+    int32_t half = info->quant_shift ? 1 << (info->quant_shift - 1) : 0;
+    return (int16_t)(q * (1 << info->quant_shift) + half);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --rate HZ          accelerometer output data rate (default 400)\n"
+            "  --seconds S        simulated duration (default 600)\n"
+            "  --uplink-s S       uplink interval (default 30, as transmission_task)\n"
+            "  --events-per-min N injected events per minute (default 1.5)\n"
+            "  --budget BYTES     burst budget per uplink (default %d)\n"
+            "  --seed N           RNG seed (default 1)\n"
+            "  --min-recall R     fail below this impact/drop recall (default 0.95)\n"
+            "  --csv PATH         dump decoded bursts as CSV\n"
+            "  --verbose          print every event and uplink\n",
+            prog, ACCEL_BURST_MAX_BYTES);
+}
+
+int main(int argc, char **argv) {
+    sim_options_t opt = { 400, 600.0, 30.0, 1.5, ACCEL_BURST_MAX_BYTES, 1, 0.95, 0, NULL };
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--verbose")) { opt.verbose = 1; continue; }
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--rate")) opt.rate = (uint16_t)atoi(v);
+        else if (!strcmp(a, "--seconds")) opt.seconds = atof(v);
+        else if (!strcmp(a, "--uplink-s")) opt.uplink_s = atof(v);
+        else if (!strcmp(a, "--events-per-min")) opt.events_per_min = atof(v);
+        else if (!strcmp(a, "--budget")) opt.budget = (size_t)atoi(v);
+        else if (!strcmp(a, "--seed")) opt.seed = (uint32_t)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--min-recall")) opt.min_recall = atof(v);
+        else if (!strcmp(a, "--csv")) opt.csv_path = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.rate < 50 || opt.budget < ACCEL_BURST_HEADER_SIZE + 8) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    rng_state = 0x9E3779B97F4A7C15ull ^ opt.seed;
+    static sim_event_t events[MAX_EVENTS];
+    size_t n_events = schedule_events(&opt, events);
+
+    static accel_burst_t ab;
+    accel_burst_config_t cfg;
+    accel_burst_default_config(&cfg, opt.rate);
+    accel_burst_init(&ab, &cfg);
+
+    FILE *csv = opt.csv_path ? fopen(opt.csv_path, "w") : NULL;
+    if (csv) fprintf(csv, "uplink,index,x,y,z\n");
+
+    const float gravity[3] = { -993.9f, -27.1f, -52.0f };
+    uint32_t total = (uint32_t)(opt.seconds * opt.rate);
+    uint32_t uplink_every = (uint32_t)(opt.uplink_s * opt.rate);
+    size_t next_event = 0;
+    uint32_t false_alarms = 0, uplinks = 0, bursts_sent = 0, mismatches = 0;
+    size_t bytes_sent = 0, max_size = 0;
+    size_t decimation_hist[9] = { 0 };
+    size_t step_hist[ACCEL_BURST_MAX_QUANT_SHIFT + 1] = { 0 };
+    uint8_t payload[512];
+    accel_sample_t decoded[ACCEL_BURST_WINDOW];
+
+    for (uint32_t i = 0; i < total; i++) {
+        float a[3] = { gravity[0], gravity[1], gravity[2] };
+        double t = (double)i / opt.rate;
+
+        // Road vibration while the truck is moving (alternating 60 s segments)
+        if (((uint32_t)(t / 60.0)) % 2 == 1) {
+            a[2] += (float)(25.0 * sin(2.0 * M_PI * 12.0 * t) + 10.0 * sin(2.0 * M_PI * 3.1 * t));
+        }
+        for (int ax = 0; ax < 3; ax++) a[ax] += (float)(4.0 * rng_gauss());
+
+        while (next_event < n_events && events[next_event].start + events[next_event].length +
+                                               opt.rate < i) {
+            next_event++;
+        }
+        for (size_t e = next_event; e < n_events && events[e].start <= i; e++) {
+            float dev[3];
+            event_signal(&events[e], i, opt.rate, gravity, dev);
+            for (int ax = 0; ax < 3; ax++) a[ax] += dev[ax];
+        }
+
+        accel_sample_t s = { (int16_t)lrintf(a[0]), (int16_t)lrintf(a[1]), (int16_t)lrintf(a[2]) };
+        if (accel_burst_push(&ab, s)) {
+            uint32_t trig = ab.trigger_at;
+            int matched = 0;
+            for (size_t e = 0; e < n_events; e++) {
+                int64_t lead = (int64_t)trig - (int64_t)events[e].start;
+                int64_t window = (int64_t)MATCH_WINDOW_MS * opt.rate / 1000 + events[e].length;
+                if (lead >= -(int64_t)opt.rate / 100 && lead <= window) {
+                    events[e].detected = 1;
+                    matched = 1;
+                }
+            }
+            if (!matched) false_alarms++;
+            if (opt.verbose) {
+                printf("t=%8.3fs  event detected (peak %u mg)%s\n", (double)trig / opt.rate,
+                       ab.capture_peak_mg, matched ? "" : "  [false alarm]");
+            }
+        }
+
+        if (uplink_every && (i + 1) % uplink_every == 0) {
+            uplinks++;
+            if (!accel_burst_pending(&ab)) continue;
+
+            accel_sample_t original[ACCEL_BURST_WINDOW];
+            memcpy(original, ab.burst, sizeof(original));
+            size_t size = accel_burst_take(&ab, payload, opt.budget);
+            if (size == 0) {
+                printf("uplink %u: burst did not fit in %zu bytes\n", uplinks, opt.budget);
+                mismatches++;
+                continue;
+            }
+
+            accel_burst_info_t info;
+            size_t n = accel_burst_decode(payload, size, &info, decoded, ACCEL_BURST_WINDOW);
+            int ok = n == info.n_samples && n > 0;
+            for (size_t k = 0; ok && k < n; k++) {
+                ok = decoded[k].x == expected(original, k, &info, 0) &&
+                     decoded[k].y == expected(original, k, &info, 1) &&
+                     decoded[k].z == expected(original, k, &info, 2);
+            }
+            if (!ok) mismatches++;
+
+            bursts_sent++;
+            bytes_sent += size;
+            if (size > max_size) max_size = size;
+            decimation_hist[info.decimation]++;
+            step_hist[info.quant_shift]++;
+            if (csv) {
+                for (size_t k = 0; k < n; k++) {
+                    fprintf(csv, "%u,%zu,%d,%d,%d\n", uplinks, k, decoded[k].x, decoded[k].y,
+                            decoded[k].z);
+                }
+            }
+            if (opt.verbose) {
+                printf("uplink %u: burst %zu bytes, %zu samples/axis, 1/%u decimation, %d mg step, "
+                       "peak %u mg, age %u ms%s\n",
+                       uplinks, size, n, info.decimation, 1 << info.quant_shift, info.peak_mg,
+                       info.age_ms,
+                       ok ? "" : "  [DECODE MISMATCH]");
+            }
+        }
+    }
+    if (csv) fclose(csv);
+
+    size_t shocks = 0, shocks_hit = 0, rattles = 0, rattles_hit = 0;
+    for (size_t e = 0; e < n_events; e++) {
+        if (events[e].kind == EVENT_RATTLE) {
+            rattles++;
+            rattles_hit += events[e].detected;
+        } else {
+            shocks++;
+            shocks_hit += events[e].detected;
+            if (!events[e].detected && opt.verbose) {
+                printf("missed %s at t=%.3fs (%.0f mg)\n", kind_name(events[e].kind),
+                       (double)events[e].start / opt.rate, events[e].amplitude_mg);
+            }
+        }
+    }
+    double recall = shocks ? (double)shocks_hit / shocks : 1.0;
+
+    printf("Accelerometer burst simulation\n");
+    printf("   Signal: %.0f s at %u Hz (%u samples), seed %u\n", opt.seconds, opt.rate, total, opt.seed);
+    printf("   Injected: %zu impacts/drops, %zu rattles\n", shocks, rattles);
+    printf("   Detected: %zu/%zu impacts/drops (recall %.1f%%), %zu/%zu rattles, %u false alarms\n",
+           shocks_hit, shocks, recall * 100.0, rattles_hit, rattles, false_alarms);
+    printf("   Events: %u captured, %u overwritten before uplink\n", ab.events, ab.dropped);
+    printf("   Uplinks: %u, with burst: %u (%.1f%%)\n", uplinks, bursts_sent,
+           uplinks ? 100.0 * bursts_sent / uplinks : 0.0);
+    printf("   Burst size: avg %.1f B, max %zu B (budget %zu B, raw window %d B)\n",
+           bursts_sent ? (double)bytes_sent / bursts_sent : 0.0, max_size, opt.budget,
+           ACCEL_BURST_WINDOW * 6);
+    printf("   Decimation used: 1x=%zu 2x=%zu 4x=%zu 8x=%zu\n", decimation_hist[1],
+           decimation_hist[2], decimation_hist[4], decimation_hist[8]);
+    printf("   Amplitude step:");
+    for (int q = 0; q <= ACCEL_BURST_MAX_QUANT_SHIFT; q++) printf(" %dmg=%zu", 1 << q, step_hist[q]);
+    printf("\n");
+    printf("   Round-trip: %s\n", mismatches ? "FAIL" : "PASS");
+
+    if (mismatches) return 1;
+    if (recall < opt.min_recall) {
+        printf("Recall %.3f below --min-recall %.3f\n", recall, opt.min_recall);
+        return 1;
+    }
+    return 0;
+}
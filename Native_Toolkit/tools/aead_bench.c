@@ -0,0 +1,412 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Self-test and benchmark for the AEAD framing (firmware/aead_frame.c).
+//
+// Self-test: RFC 8439 ChaCha20 and Poly1305 vectors, round trip for every
+// tag length, single-bit tampering at every byte, replay and reordering,
+// 16-bit sequence wrap, receiver restart resynchronization and batch vs.
+// single-frame equivalence. Benchmark: seal, open and batch open
+// throughput for typical payload sizes, plus the per-frame overhead next
+// to a DTLS 1.2 record. Exits non-zero if any self-test fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../firmware/aead_frame.h"
+
+#define MAX_SIZES 16
+#define BENCH_FRAMES 256
+#define BENCH_DEVICES 4
+#define DTLS12_CCM8_OVERHEAD 29           // 13-byte record header + 8 explicit nonce + 8 tag
+
+typedef struct {
+    size_t sizes[MAX_SIZES];
+    size_t n_sizes;
+    uint8_t tag_len;
+    double seconds;
+    size_t batch;
+} bench_options_t;
+
+static int failures;
+
+#define CHECK(cond, what)                                          \
+    do {                                                           \
+        if (!(cond)) { printf("   FAIL: %s\n", what); failures++; } \
+    } while (0)
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 0x243F6A8885A308D3ull;
+
+static uint8_t rng_byte(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint8_t)(rng_state >> 24);
+}
+
+static void hex_decode(const char *hex, uint8_t *out) {
+    for (size_t i = 0; hex[2 * i]; i++) {
+        unsigned v;
+        sscanf(hex + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+}
+
+static void fill_key(uint8_t key[AEAD_FRAME_KEY_SIZE], uint8_t seed) {
+    for (int i = 0; i < AEAD_FRAME_KEY_SIZE; i++) key[i] = (uint8_t)(seed * 31 + i * 7);
+}
+
+// Seal one random payload of len bytes; returns the frame length
+static size_t seal_random(aead_sender_t *s, uint8_t *frame, uint8_t *plain, size_t len, size_t cap) {
+    for (size_t i = 0; i < len; i++) plain[i] = rng_byte();
+    memcpy(frame + AEAD_FRAME_HEADER_SIZE, plain, len);
+    int n = aead_frame_seal(s, frame, len, cap);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+// ================= SELF-TEST =================
+
+static void test_vectors(void) {
+    // RFC 8439 2.3.2
+    uint8_t key[32], nonce[12], block[64], expected[64];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)i;
+    hex_decode("000000090000004a00000000", nonce);
+    hex_decode("10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+               "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e", expected);
+    chacha20_block(key, 1, nonce, block);
+    CHECK(memcmp(block, expected, 64) == 0, "ChaCha20 block vector (RFC 8439 2.3.2)");
+
+    // RFC 8439 2.5.2
+    uint8_t poly_key[32], tag[16], expected_tag[16];
+    const char *msg = "Cryptographic Forum Research Group";
+    hex_decode("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b", poly_key);
+    hex_decode("a8061dc1305136c6c22b8baf0c0127a9", expected_tag);
+    poly1305_mac(poly_key, (const uint8_t *)msg, strlen(msg), tag);
+    CHECK(memcmp(tag, expected_tag, 16) == 0, "Poly1305 vector (RFC 8439 2.5.2)");
+}
+
+static void test_round_trip(void) {
+    uint8_t key[32], frame[512], plain[256], *payload;
+    fill_key(key, 1);
+    for (uint8_t tag_len = AEAD_FRAME_TAG_MIN; tag_len <= AEAD_FRAME_TAG_MAX; tag_len++) {
+        aead_sender_t s;
+        aead_peer_t p;
+        aead_sender_init(&s, key, 393600504805ull, tag_len, 0);
+        aead_peer_init(&p, key, 393600504805ull, tag_len);
+        for (size_t len = 0; len <= 200; len += 13) {
+            size_t n = seal_random(&s, frame, plain, len, sizeof(frame));
+            int rc = aead_frame_open(&p, frame, n, &payload);
+            if (rc != (int)len || memcmp(payload, plain, len) != 0) {
+                CHECK(0, "round trip");
+                return;
+            }
+        }
+    }
+    aead_sender_t s;
+    CHECK(aead_sender_init(&s, key, 1, 3, 0) == AEAD_ERR_PARAM, "tag length below minimum rejected");
+    aead_sender_init(&s, key, 1, 6, 0);
+    CHECK(aead_frame_seal(&s, frame, 100, 107) == AEAD_ERR_PARAM, "seal without room for the tag rejected");
+    aead_sender_init(&s, key, 1, 6, UINT32_MAX);
+    CHECK(aead_frame_seal(&s, frame, 10, sizeof(frame)) == AEAD_ERR_SEQ_EXHAUSTED, "sequence exhaustion");
+}
+
+static void test_tampering(void) {
+    uint8_t key[32], frame[256], copy[256], plain[128], *payload;
+    fill_key(key, 2);
+    aead_sender_t s;
+    aead_peer_t p;
+    aead_sender_init(&s, key, 42, AEAD_FRAME_TAG_DEFAULT, 100);
+    aead_peer_init(&p, key, 42, AEAD_FRAME_TAG_DEFAULT);
+
+    size_t n = seal_random(&s, frame, plain, 90, sizeof(frame));
+    size_t rejected = 0;
+    for (size_t byte = 0; byte < n; byte++) {
+        memcpy(copy, frame, n);
+        copy[byte] ^= (uint8_t)(1u << (byte % 8));
+        rejected += aead_frame_open(&p, copy, n, &payload) < 0;
+    }
+    CHECK(rejected == n, "single-bit tampering detected at every byte");
+
+    aead_peer_t wrong;
+    fill_key(key, 3);
+    aead_peer_init(&wrong, key, 42, AEAD_FRAME_TAG_DEFAULT);
+    memcpy(copy, frame, n);
+    CHECK(aead_frame_open(&wrong, copy, n, &payload) == AEAD_ERR_AUTH, "wrong key rejected");
+
+    fill_key(key, 2);
+    aead_peer_init(&wrong, key, 43, AEAD_FRAME_TAG_DEFAULT);
+    memcpy(copy, frame, n);
+    CHECK(aead_frame_open(&wrong, copy, n, &payload) == AEAD_ERR_AUTH, "wrong device ID rejected");
+
+    memcpy(copy, frame, n);
+    CHECK(aead_frame_open(&p, copy, n, &payload) == 90, "untampered frame accepted after failures");
+}
+
+static void test_replay_and_order(void) {
+    uint8_t key[32], frames[8][160], copy[160], plain[100], *payload;
+    size_t lens[8];
+    fill_key(key, 4);
+    aead_sender_t s;
+    aead_peer_t p;
+    aead_sender_init(&s, key, 7, AEAD_FRAME_TAG_DEFAULT, 0);
+    aead_peer_init(&p, key, 7, AEAD_FRAME_TAG_DEFAULT);
+    for (int i = 0; i < 8; i++) lens[i] = seal_random(&s, frames[i], plain, 60, sizeof(frames[i]));
+
+    const int order[8] = { 0, 2, 1, 5, 3, 4, 7, 6 };
+    int ok = 1;
+    for (int i = 0; i < 8; i++) {
+        memcpy(copy, frames[order[i]], lens[order[i]]);
+        ok &= aead_frame_open(&p, copy, lens[order[i]], &payload) == 60;
+    }
+    CHECK(ok, "reordered frames inside the window accepted");
+    memcpy(copy, frames[3], lens[3]);
+    CHECK(aead_frame_open(&p, copy, lens[3], &payload) == AEAD_ERR_REPLAY, "replayed frame rejected");
+
+    // Push the window past frame 0
+    for (int i = 0; i < AEAD_FRAME_REPLAY_WINDOW + 2; i++) {
+        size_t n = seal_random(&s, copy, plain, 20, sizeof(copy));
+        aead_frame_open(&p, copy, n, &payload);
+    }
+    memcpy(copy, frames[0], lens[0]);
+    CHECK(aead_frame_open(&p, copy, lens[0], &payload) == AEAD_ERR_REPLAY, "frame older than the window rejected");
+}
+
+static void test_sequence_wrap(void) {
+    uint8_t key[32], frame[160], plain[100], *payload;
+    fill_key(key, 5);
+    aead_sender_t s;
+    aead_peer_t p;
+    aead_sender_init(&s, key, 9, AEAD_FRAME_TAG_DEFAULT, 0xFFF0);
+    aead_peer_init(&p, key, 9, AEAD_FRAME_TAG_DEFAULT);
+    int ok = 1;
+    for (int i = 0; i < 64; i++) {
+        size_t n = seal_random(&s, frame, plain, 40, sizeof(frame));
+        ok &= aead_frame_open(&p, frame, n, &payload) == 40;
+    }
+    CHECK(ok && p.highest_seq == 0xFFF0 + 63, "16-bit sequence wrap");
+
+    // Gap of several thousand frames (device offline, frames lost)
+    s.next_seq += 20000;
+    size_t n = seal_random(&s, frame, plain, 40, sizeof(frame));
+    CHECK(aead_frame_open(&p, frame, n, &payload) == 40, "sequence gap below half an epoch");
+
+    // Receiver restart: no state, device in its sixth epoch
+    aead_peer_init(&p, key, 9, AEAD_FRAME_TAG_DEFAULT);
+    s.next_seq = 5u * 65536 + 1234;
+    n = seal_random(&s, frame, plain, 40, sizeof(frame));
+    CHECK(aead_frame_open(&p, frame, n, &payload) == 40 && p.highest_seq == 5u * 65536 + 1234,
+          "receiver restart resynchronizes the epoch");
+}
+
+static void test_batch(void) {
+    enum { N = 103 };
+    static uint8_t frames[N][300], copies[N][300], plain[N][256];
+    size_t lens[N];
+    uint8_t *frame_ptrs[N], *payloads[N];
+    aead_peer_t *peer_ptrs[N];
+    int status[N];
+    uint8_t key[32];
+
+    aead_sender_t senders[BENCH_DEVICES];
+    aead_peer_t peers[BENCH_DEVICES], singles[BENCH_DEVICES];
+    for (int d = 0; d < BENCH_DEVICES; d++) {
+        fill_key(key, (uint8_t)(10 + d));
+        aead_sender_init(&senders[d], key, 1000 + d, AEAD_FRAME_TAG_DEFAULT, 70000u * d);
+        aead_peer_init(&peers[d], key, 1000 + d, AEAD_FRAME_TAG_DEFAULT);
+        aead_peer_init(&singles[d], key, 1000 + d, AEAD_FRAME_TAG_DEFAULT);
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        int d = (int)(i % BENCH_DEVICES);
+        size_t len = 1 + (i * 37) % 250;
+        if (i == 50) {
+            memcpy(frames[i], frames[10], lens[10]);          // duplicate inside the batch
+            lens[i] = lens[10];
+            memcpy(plain[i], plain[10], 256);
+        } else {
+            lens[i] = seal_random(&senders[d], frames[i], plain[i], len, sizeof(frames[i]));
+        }
+        if (i == 77) frames[i][5] ^= 0x40;                    // tampered
+        peer_ptrs[i] = &peers[d];
+        frame_ptrs[i] = copies[i];
+        memcpy(copies[i], frames[i], lens[i]);
+    }
+
+    size_t opened = aead_frame_open_batch(peer_ptrs, frame_ptrs, lens, N, payloads, status);
+
+    int same = 1;
+    for (size_t i = 0; i < N; i++) {
+        uint8_t single_copy[300], *payload;
+        memcpy(single_copy, frames[i], lens[i]);
+        int rc = aead_frame_open(&singles[i % BENCH_DEVICES], single_copy, lens[i], &payload);
+        if (rc != status[i]) same = 0;
+        if (rc >= 0 && memcmp(payloads[i], plain[i], (size_t)rc) != 0) same = 0;
+    }
+    CHECK(same, "batch open matches single-frame open");
+    CHECK(opened == N - 2 && status[77] == AEAD_ERR_AUTH && status[50] == AEAD_ERR_REPLAY,
+          "batch rejects tampered and duplicated frames");
+}
+
+// ================= BENCHMARK =================
+
+static void bench_size(const bench_options_t *opt, size_t size) {
+    static uint8_t sealed[BENCH_FRAMES][AEAD_FRAME_MAX_PAYLOAD + 32];
+    static uint8_t work[BENCH_FRAMES][AEAD_FRAME_MAX_PAYLOAD + 32];
+    static uint8_t plain[AEAD_FRAME_MAX_PAYLOAD];
+    size_t lens[BENCH_FRAMES];
+    uint8_t *work_ptrs[BENCH_FRAMES], *payloads[BENCH_FRAMES];
+    aead_peer_t *peer_ptrs[BENCH_FRAMES];
+    int status[BENCH_FRAMES];
+    uint8_t key[32];
+
+    aead_sender_t senders[BENCH_DEVICES];
+    aead_peer_t peers[BENCH_DEVICES];
+    for (int d = 0; d < BENCH_DEVICES; d++) {
+        fill_key(key, (uint8_t)(20 + d));
+        aead_sender_init(&senders[d], key, 2000 + d, opt->tag_len, 1);
+        aead_peer_init(&peers[d], key, 2000 + d, opt->tag_len);
+    }
+
+    // Seal throughput (also produces the frames for the open runs)
+    double t0 = now_s(), elapsed;
+    size_t sealed_frames = 0;
+    do {
+        for (size_t i = 0; i < BENCH_FRAMES; i++) {
+            int d = (int)(i % BENCH_DEVICES);
+            senders[d].next_seq = 1 + (uint32_t)(i / BENCH_DEVICES);
+            memcpy(sealed[i] + AEAD_FRAME_HEADER_SIZE, plain, size);
+            lens[i] = (size_t)aead_frame_seal(&senders[d], sealed[i], size, sizeof(sealed[i]));
+        }
+        sealed_frames += BENCH_FRAMES;
+        elapsed = now_s() - t0;
+    } while (elapsed < opt->seconds);
+    double seal_rate = sealed_frames / elapsed;
+
+    // Fresh replay windows for every pass over the same frames
+    #define RESET_PEERS()                                             \
+        for (int d = 0; d < BENCH_DEVICES; d++) {                     \
+            peers[d].seen = true;                                     \
+            peers[d].highest_seq = 0;                                 \
+            peers[d].window = 1;                                      \
+        }
+
+    size_t opened = 0, failed = 0;
+    t0 = now_s();
+    do {
+        RESET_PEERS();
+        for (size_t i = 0; i < BENCH_FRAMES; i++) {
+            memcpy(work[i], sealed[i], lens[i]);
+            uint8_t *payload;
+            failed += aead_frame_open(&peers[i % BENCH_DEVICES], work[i], lens[i], &payload) != (int)size;
+        }
+        opened += BENCH_FRAMES;
+        elapsed = now_s() - t0;
+    } while (elapsed < opt->seconds);
+    double open_rate = opened / elapsed;
+
+    size_t batched = 0;
+    for (size_t i = 0; i < BENCH_FRAMES; i++) {
+        work_ptrs[i] = work[i];
+        peer_ptrs[i] = &peers[i % BENCH_DEVICES];
+    }
+    t0 = now_s();
+    do {
+        RESET_PEERS();
+        for (size_t i = 0; i < BENCH_FRAMES; i++) memcpy(work[i], sealed[i], lens[i]);
+        for (size_t start = 0; start < BENCH_FRAMES; start += opt->batch) {
+            size_t n = BENCH_FRAMES - start < opt->batch ? BENCH_FRAMES - start : opt->batch;
+            size_t ok = aead_frame_open_batch(peer_ptrs + start, work_ptrs + start, lens + start, n,
+                                              payloads + start, status + start);
+            failed += n - ok;
+        }
+        batched += BENCH_FRAMES;
+        elapsed = now_s() - t0;
+    } while (elapsed < opt->seconds);
+    double batch_rate = batched / elapsed;
+    #undef RESET_PEERS
+
+    printf("   %5zu B %12.0f %9.1f %12.0f %9.1f %12.0f %9.1f%s\n", size, seal_rate,
+           seal_rate * size / 1e6, open_rate, open_rate * size / 1e6, batch_rate,
+           batch_rate * size / 1e6, failed ? "  [OPEN FAILURES]" : "");
+    if (failed) failures++;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --sizes LIST     payload sizes in bytes (default 60,100,150,256)\n"
+            "  --tag N          tag length 4..16 (default %d)\n"
+            "  --seconds S      time per measurement (default 0.3)\n"
+            "  --batch N        frames per batch open call (default 64)\n"
+            "  --self-test      run the self-test only\n",
+            prog, AEAD_FRAME_TAG_DEFAULT);
+}
+
+int main(int argc, char **argv) {
+    bench_options_t opt = { { 60, 100, 150, 256 }, 4, AEAD_FRAME_TAG_DEFAULT, 0.3, 64 };
+    int self_test_only = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--self-test")) { self_test_only = 1; continue; }
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--sizes")) {
+            char buf[256];
+            snprintf(buf, sizeof(buf), "%s", v);
+            opt.n_sizes = 0;
+            for (char *tok = strtok(buf, ","); tok && opt.n_sizes < MAX_SIZES; tok = strtok(NULL, ",")) {
+                opt.sizes[opt.n_sizes++] = (size_t)atol(tok);
+            }
+        }
+        else if (!strcmp(a, "--tag")) opt.tag_len = (uint8_t)atoi(v);
+        else if (!strcmp(a, "--seconds")) opt.seconds = atof(v);
+        else if (!strcmp(a, "--batch")) opt.batch = (size_t)atol(v);
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.tag_len < AEAD_FRAME_TAG_MIN || opt.tag_len > AEAD_FRAME_TAG_MAX || opt.batch == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (size_t i = 0; i < opt.n_sizes; i++) {
+        if (opt.sizes[i] == 0 || opt.sizes[i] > AEAD_FRAME_MAX_PAYLOAD) { usage(argv[0]); return 2; }
+    }
+
+    printf("AEAD framing self-test\n");
+    test_vectors();
+    test_round_trip();
+    test_tampering();
+    test_replay_and_order();
+    test_sequence_wrap();
+    test_batch();
+    printf("   %s\n\n", failures ? "FAIL" : "PASS");
+    if (self_test_only || failures) return failures ? 1 : 0;
+
+    printf("Per-frame overhead (tag %u B)\n", opt.tag_len);
+    printf("   %7s %12s %12s\n", "payload", "AEAD frame", "DTLS 1.2 CCM8");
+    for (size_t i = 0; i < opt.n_sizes; i++) {
+        size_t size = opt.sizes[i];
+        size_t overhead = AEAD_FRAME_OVERHEAD(opt.tag_len);
+        printf("   %5zu B %5zu B %4.1f%% %5d B %4.1f%%\n", size, overhead, 100.0 * overhead / size,
+               DTLS12_CCM8_OVERHEAD, 100.0 * DTLS12_CCM8_OVERHEAD / size);
+    }
+
+    printf("\nThroughput (%d devices, batch %zu)\n", BENCH_DEVICES, opt.batch);
+    printf("   %7s %12s %9s %12s %9s %12s %9s\n", "payload", "seal fr/s", "MB/s", "open fr/s", "MB/s",
+           "batch fr/s", "MB/s");
+    for (size_t i = 0; i < opt.n_sizes; i++) bench_size(&opt, opt.sizes[i]);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,1386 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Device-affine HTTP router for the receiver instances (consistent hashing
+// with bounded loads, common/chash.h).
+//
+//   client --> router thread (SO_REUSEPORT listener, epoll)
+//                 | device key: X-Device-Id, else read from the body
+//                 v  chash_pick: home instance unless it is over its load bound
+//              keep-alive upstream pool per instance --> receiver instance
+//
+// nginx's least_conn sends a device's payloads to any instance, so the
+// latest record, delta and session state of a device are spread over all
+// of them. Here every request of a device goes to the same instance as
+// long as that instance is up and not overloaded. The key is read without
+// a full decode: the iso6346 of a cbor, msgpack or protobuf body, the
+// decoded iso6346 of a struct (zlib or rANS) body, the deviceGuid of an
+// Astrocast callback, the first item of a batch frame. Session frames and
+// FEC frames need X-Device-Id, as in the receivers. Requests without a key
+// (GET /health, the dashboard) go to the least loaded instance.
+//
+// An instance that refuses connections is marked down for --retry-down
+// seconds and its keys go to their ring successors; a request whose
+// upstream fails before any response byte is retried once elsewhere.
+// --backends FILE is re-read on SIGHUP: only the keys of an instance that
+// joins or leaves move. Each thread keeps its own ring and load counts.
+// GET /router/stats returns the per-instance counters as JSON.
+//
+// With --cluster HOST:PORT the instances are the members of a clustered
+// shard_receiver (tools/shard_receiver.c --cluster): the router reads
+// GET /cluster/map from a member every --map-interval seconds and sends a
+// keyed request straight to the owner of its partition, so clients do not
+// see the 307 a member answers for a partition it does not own. The ring
+// is the fallback while the map is stale; the member redirects then.
+//
+// --bench measures the ring alone: key balance, keys moved when an
+// instance joins or leaves, load spread under a skewed request stream
+// with and without the bound, and the cost of a pick.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "astrocast_callback.h"
+#include "batch_frame.h"
+#include "chash.h"
+#include "cluster.h"
+#include "container_codecs.h"
+#include "container_record.h"
+#include "deflate_session.h"
+#include "record_rans.h"
+#include "shard_pipeline.h"
+
+#define MAX_CLIENTS 4096                  // per thread
+#define MAX_UPSTREAMS 4096                // per thread
+#define POOL_MAX 64                       // idle keep-alive connections per instance and thread
+#define RBUF_INITIAL 8192
+#define REQUEST_MAX ((1u << 20) + 16384)  // 1 MB body, as the receivers, plus headers
+#define RESPONSE_MAX (16u << 20)
+#define DEVICE_ID_MAX 64
+#define TAG_LISTEN UINT64_MAX
+#define TAG_UPSTREAM (1ull << 32)
+
+typedef struct {
+    char host[256];
+    uint16_t port;
+    container_codec_t codec;
+    unsigned threads;
+    unsigned vnodes;
+    double epsilon;
+    double timeout_s;
+    double retry_down_s;
+    double stats_s;
+    const char *backends_file;
+    const char *cluster;                  // HTTP address of a cluster member, NULL = static backends
+    double map_s;
+    bool bench;
+    unsigned nodes;                       // bench
+    size_t keys;                          // bench
+    unsigned inflight;                    // bench: requests in flight
+    double hot;                           // bench: share of requests from the hot devices
+} router_opts_t;
+
+static router_opts_t opt;
+static volatile sig_atomic_t stop, reload;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void on_signal(int sig) {
+    if (sig == SIGHUP) reload = 1;
+    else stop = 1;
+}
+
+// ================= MEMBERSHIP =================
+// The instance list every thread applies to its own ring. Indexes match
+// across threads: they all apply the same lists in the same order.
+typedef struct {
+    char name[CHASH_NAME_MAX];            // host:port
+    uint32_t weight;
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+} member_t;
+
+typedef struct {
+    _Atomic uint64_t requests, keyed, spilled, retried, errors;
+    _Atomic int64_t inflight;
+    _Atomic bool down;
+} node_stats_t;
+
+static pthread_mutex_t members_lock = PTHREAD_MUTEX_INITIALIZER;
+static member_t members[CHASH_MAX_NODES];
+static unsigned member_count;
+static _Atomic uint64_t members_gen;
+static node_stats_t node_stats[CHASH_MAX_NODES];
+static char node_names[CHASH_MAX_NODES][CHASH_NAME_MAX];   // by ring index, set by thread 0
+static _Atomic unsigned node_name_count;
+static _Atomic uint64_t unkeyed, no_backend, owner_routed;
+static unsigned partitions;               // cluster map: 0 = no map
+static int16_t partition_member[SHARD_PIPELINE_MAX_PARTITIONS];   // index in members[], -1 = none
+static char map_text[65536];             // last map installed
+
+static int resolve(const char *hostport, member_t *m) {
+    const char *colon = strrchr(hostport, ':');
+    if (!colon || colon == hostport || (size_t)(colon - hostport) >= 256) return -1;
+    char host[256];
+    memcpy(host, hostport, (size_t)(colon - hostport));
+    host[colon - hostport] = '\0';
+    struct addrinfo hints = { .ai_socktype = SOCK_STREAM }, *res;
+    if (getaddrinfo(host, colon + 1, &hints, &res) != 0) return -1;
+    memcpy(&m->addr, res->ai_addr, res->ai_addrlen);
+    m->addr_len = res->ai_addrlen;
+    freeaddrinfo(res);
+    return 0;
+}
+
+// "host:port[=weight]"
+static int parse_member(const char *spec, member_t *m) {
+    char name[CHASH_NAME_MAX];
+    const char *eq = strchr(spec, '=');
+    size_t n = eq ? (size_t)(eq - spec) : strlen(spec);
+    if (!n || n >= sizeof(name)) return -1;
+    memcpy(name, spec, n);
+    name[n] = '\0';
+    memset(m, 0, sizeof(*m));
+    strcpy(m->name, name);
+    m->weight = eq ? (uint32_t)strtoul(eq + 1, NULL, 10) : 1;
+    if (!m->weight || m->weight > 16) return -1;
+    return resolve(m->name, m);
+}
+
+static int add_member(member_t *list, unsigned *count, const char *spec) {
+    if (*count == CHASH_MAX_NODES || parse_member(spec, &list[*count]) != 0) return -1;
+    (*count)++;
+    return 0;
+}
+
+// One instance per line: host:port[=weight]; # starts a comment
+static int load_backends(const char *path, member_t *list, unsigned *count) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[512];
+    int rc = 0;
+    *count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char *s = line + strspn(line, " \t\r\n");
+        s[strcspn(s, " \t\r\n")] = '\0';
+        if (*s && add_member(list, count, s) != 0) {
+            fprintf(stderr, "bad backend line: %s\n", s);
+            rc = -1;
+        }
+    }
+    fclose(f);
+    return rc;
+}
+
+static void reload_backends(void) {
+    member_t list[CHASH_MAX_NODES];
+    unsigned count;
+    if (load_backends(opt.backends_file, list, &count) != 0 || !count) {
+        fprintf(stderr, "keeping the current backends: cannot read %s\n", opt.backends_file);
+        return;
+    }
+    pthread_mutex_lock(&members_lock);
+    memcpy(members, list, sizeof(list));
+    member_count = count;
+    atomic_fetch_add(&members_gen, 1);
+    pthread_mutex_unlock(&members_lock);
+    printf("reloaded %u backends from %s\n", count, opt.backends_file);
+    fflush(stdout);
+}
+
+// GET /cluster/map from one member into text; 0 on a 200
+static int fetch_map(const char *hostport, char *text, size_t cap) {
+    member_t m;
+    if (resolve(hostport, &m) != 0) return -1;
+    int fd = socket(m.addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    struct timeval tv = { .tv_sec = 2 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    static const char req[] = "GET /cluster/map HTTP/1.0\r\n\r\n";
+    size_t len = 0;
+    int rc = -1;
+    if (connect(fd, (struct sockaddr *)&m.addr, m.addr_len) == 0 &&
+        send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL) == (ssize_t)(sizeof(req) - 1)) {
+        ssize_t n;
+        while (len < cap - 1 && (n = recv(fd, text + len, cap - 1 - len, 0)) > 0) len += (size_t)n;
+        text[len] = '\0';
+        char *body = strstr(text, "\r\n\r\n");
+        if (body && !strncmp(text, "HTTP/1.1 200", 12)) {
+            memmove(text, body + 4, strlen(body + 4) + 1);
+            rc = 0;
+        }
+    }
+    close(fd);
+    return rc;
+}
+
+// Installs a map: the members up or leaving become the instances (named by
+// their HTTP address), the owners the partition table
+static int install_map(const char *text) {
+    member_t list[CHASH_MAX_NODES];
+    int16_t index[256], owner[SHARD_PIPELINE_MAX_PARTITIONS];
+    unsigned count = 0, parts = 0;
+    bool owners = false;
+    for (int i = 0; i < 256; i++) index[i] = -1;
+    for (const char *line = text; *line;) {
+        const char *eol = strchr(line, '\n');
+        if (!eol) eol = line + strlen(line);
+        unsigned i, owned;
+        char name[CLUSTER_NAME_MAX], http[CLUSTER_ADDR_MAX], gossip[CLUSTER_ADDR_MAX], state[16];
+        _Static_assert(CLUSTER_NAME_MAX == 64 && CLUSTER_ADDR_MAX == 128, "widths of the member line below");
+        if (!strncmp(line, "partitions ", 11)) {
+            parts = (unsigned)strtoul(line + 11, NULL, 10);
+            if (!parts || parts > SHARD_PIPELINE_MAX_PARTITIONS) return -1;
+        } else if (sscanf(line, "member %u %63s %127s %127s %15s %u", &i, name, http, gossip, state, &owned) == 6 &&
+                   i < 256 && (!strcmp(state, "up") || !strcmp(state, "leaving"))) {
+            // An address too long for a ring name is left out: its devices reach it by redirect
+            if (add_member(list, &count, http) == 0) index[i] = (int16_t)(count - 1);
+            else fprintf(stderr, "cluster member %s: cannot route to %s\n", name, http);
+        } else if (!strncmp(line, "owners", 6)) {
+            const char *p = line + 6;
+            for (unsigned k = 0; k < parts; k++) {
+                char *end;
+                long o = strtol(p, &end, 10);
+                if (end == p) return -1;
+                owner[k] = o >= 0 && o < 256 ? index[o] : -1;
+                p = end;
+            }
+            owners = true;
+        }
+        line = *eol ? eol + 1 : eol;
+    }
+    if (!owners || !count) return -1;
+    pthread_mutex_lock(&members_lock);
+    memcpy(members, list, sizeof(list));
+    member_count = count;
+    partitions = parts;
+    memcpy(partition_member, owner, parts * sizeof(owner[0]));
+    atomic_fetch_add(&members_gen, 1);
+    pthread_mutex_unlock(&members_lock);
+    return 0;
+}
+
+// From --cluster, else from any member known; installs the map when it changed
+static int refresh_map(void) {
+    static char text[sizeof(map_text)];
+    char names[CHASH_MAX_NODES][CHASH_NAME_MAX];
+    unsigned count;
+    pthread_mutex_lock(&members_lock);
+    count = member_count;
+    for (unsigned i = 0; i < count; i++) strcpy(names[i], members[i].name);
+    pthread_mutex_unlock(&members_lock);
+    int rc = fetch_map(opt.cluster, text, sizeof(text));
+    for (unsigned i = 0; rc != 0 && i < count; i++) rc = fetch_map(names[i], text, sizeof(text));
+    if (rc != 0) return -1;
+    if (!strcmp(text, map_text)) return 0;
+    if (install_map(text) != 0) return -1;
+    strcpy(map_text, text);
+    printf("cluster map: %u members, %u partitions\n", member_count, partitions);
+    fflush(stdout);
+    return 0;
+}
+
+// ================= ROUTER THREAD =================
+typedef struct {
+    int fd;
+    uint32_t gen;                         // bumped on close, so a late upstream response is dropped
+    bool close_after;
+    int upstream;                         // upstream slot serving the request in flight, -1 none
+    int node;
+    uint8_t attempts;
+    uint64_t key;
+    bool keyed;
+    size_t req_len;                       // header + body of the request in flight
+    char *rbuf;
+    size_t rlen, rcap;
+    char *obuf;                           // response being written
+    size_t olen, ooff;
+} client_t;
+
+typedef struct {
+    int fd;
+    int node;
+    int client;                           // -1 while idle in the pool
+    uint32_t client_gen;
+    bool connecting;
+    bool reused;                          // served a request before (may be a stale keep-alive)
+    bool head;                            // request was HEAD: no body
+    size_t woff;
+    char *resp;
+    size_t rlen, rcap;
+    size_t head_len;                      // 0 until the header is complete
+    long long body_len;                   // -1 chunked, -2 until close
+    bool keep_alive;
+    double deadline;
+} upstream_t;
+
+typedef struct {
+    const char *method, *path;
+    size_t method_len, path_len;
+    size_t header_len, body_len;
+    char device[DEVICE_ID_MAX];
+    bool close;
+    bool chunked;
+} request_t;
+
+typedef struct {
+    unsigned index;
+    pthread_t thread;
+    int lfd, epfd;
+    chash_t ring;
+    uint64_t gen;                         // membership applied
+    unsigned partitions;
+    int16_t partition_node[SHARD_PIPELINE_MAX_PARTITIONS];   // ring index of the owner, -1 = none
+    struct sockaddr_storage addr[CHASH_MAX_NODES];
+    socklen_t addr_len[CHASH_MAX_NODES];
+    double down_until[CHASH_MAX_NODES];
+    int pool[CHASH_MAX_NODES][POOL_MAX];
+    unsigned pool_len[CHASH_MAX_NODES];
+    client_t *clients;
+    uint32_t *free_clients;
+    size_t free_client_count;
+    upstream_t *ups;
+    uint32_t *free_ups;
+    size_t free_up_count;
+} router_t;
+
+static router_t *routers;
+
+static int open_listener(void) {
+    char port[8];
+    snprintf(port, sizeof(port), "%u", opt.port);
+    struct addrinfo hints = { .ai_socktype = SOCK_STREAM, .ai_flags = AI_PASSIVE }, *res;
+    if (getaddrinfo(opt.host[0] ? opt.host : NULL, port, &hints, &res) != 0) return -1;
+    int fd = socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) || bind(fd, res->ai_addr, res->ai_addrlen) ||
+        listen(fd, 1024)) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static void upstream_close(router_t *r, upstream_t *u) {
+    epoll_ctl(r->epfd, EPOLL_CTL_DEL, u->fd, NULL);
+    close(u->fd);
+    free(u->resp);
+    u->resp = NULL;
+    u->fd = -1;
+    r->free_ups[r->free_up_count++] = (uint32_t)(u - r->ups);
+}
+
+static void pool_drop(router_t *r, int node, int slot) {
+    for (unsigned i = 0; i < r->pool_len[node]; i++) {
+        if (r->pool[node][i] == slot) {
+            r->pool[node][i] = r->pool[node][--r->pool_len[node]];
+            return;
+        }
+    }
+}
+
+// Applies a new instance list: removed instances leave the ring (their idle
+// connections are closed), new or returning ones join it
+static void apply_members(router_t *r) {
+    member_t list[CHASH_MAX_NODES];
+    unsigned count;
+    pthread_mutex_lock(&members_lock);
+    memcpy(list, members, sizeof(list));
+    count = member_count;
+    r->partitions = partitions;
+    memcpy(r->partition_node, partition_member, partitions * sizeof(partition_member[0]));
+    r->gen = atomic_load(&members_gen);
+    pthread_mutex_unlock(&members_lock);
+
+    for (unsigned n = 0; n < r->ring.node_count; n++) {
+        if (!r->ring.node[n].weight) continue;
+        bool kept = false;
+        for (unsigned i = 0; i < count && !kept; i++) kept = !strcmp(list[i].name, r->ring.node[n].name);
+        if (kept) continue;
+        chash_remove(&r->ring, n);
+        while (r->pool_len[n]) upstream_close(r, &r->ups[r->pool[n][--r->pool_len[n]]]);
+    }
+    for (unsigned i = 0; i < count; i++) {
+        int n = chash_find(&r->ring, list[i].name);
+        if (n < 0 || r->ring.node[n].weight != list[i].weight) n = chash_add(&r->ring, list[i].name, list[i].weight);
+        if (n < 0) continue;
+        r->addr[n] = list[i].addr;
+        r->addr_len[n] = list[i].addr_len;
+        if (r->index == 0) {
+            strcpy(node_names[n], list[i].name);
+            if ((unsigned)n >= atomic_load(&node_name_count)) atomic_store(&node_name_count, (unsigned)n + 1);
+        }
+    }
+    for (unsigned p = 0; p < r->partitions; p++) {
+        int m = r->partition_node[p];
+        r->partition_node[p] = (int16_t)(m >= 0 ? chash_find(&r->ring, list[m].name) : -1);
+    }
+}
+
+static void mark_down(router_t *r, int node) {
+    chash_set_up(&r->ring, (unsigned)node, false);
+    r->down_until[node] = now_s() + opt.retry_down_s;
+    atomic_store_explicit(&node_stats[node].down, true, memory_order_relaxed);
+}
+
+// Down instances get their keys back after --retry-down; the next request
+// to one is the probe
+static void revive(router_t *r, double now) {
+    for (unsigned n = 0; n < r->ring.node_count; n++) {
+        if (r->ring.node[n].weight && !r->ring.node[n].up && now >= r->down_until[n]) {
+            chash_set_up(&r->ring, n, true);
+            atomic_store_explicit(&node_stats[n].down, false, memory_order_relaxed);
+        }
+    }
+}
+
+// ================= CLIENT SIDE =================
+static void client_close(router_t *r, client_t *c) {
+    epoll_ctl(r->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->obuf);
+    c->obuf = NULL;
+    if (c->rcap > RBUF_INITIAL) {
+        free(c->rbuf);
+        c->rbuf = NULL;
+        c->rcap = 0;
+    }
+    c->fd = -1;
+    c->gen++;
+    r->free_clients[r->free_client_count++] = (uint32_t)(c - r->clients);
+}
+
+static void client_serve(router_t *r, client_t *c);
+
+// Drops the request just answered from the read buffer, then serves the next
+static void client_done(router_t *r, client_t *c) {
+    free(c->obuf);
+    c->obuf = NULL;
+    c->olen = c->ooff = 0;
+    if (c->close_after) {
+        client_close(r, c);
+        return;
+    }
+    memmove(c->rbuf, c->rbuf + c->req_len, c->rlen - c->req_len);
+    c->rlen -= c->req_len;
+    c->req_len = 0;
+    struct epoll_event e = { .events = EPOLLIN, .data.u64 = (uint64_t)(c - r->clients) };
+    epoll_ctl(r->epfd, EPOLL_CTL_MOD, c->fd, &e);
+    client_serve(r, c);
+}
+
+static void client_flush(router_t *r, client_t *c) {
+    while (c->ooff < c->olen) {
+        ssize_t n = send(c->fd, c->obuf + c->ooff, c->olen - c->ooff, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct epoll_event e = { .events = EPOLLOUT, .data.u64 = (uint64_t)(c - r->clients) };
+            epoll_ctl(r->epfd, EPOLL_CTL_MOD, c->fd, &e);
+            return;
+        }
+        if (n <= 0) {
+            client_close(r, c);
+            return;
+        }
+        c->ooff += (size_t)n;
+    }
+    client_done(r, c);
+}
+
+// Takes ownership of buf
+static void client_send(router_t *r, client_t *c, char *buf, size_t len) {
+    c->obuf = buf;
+    c->olen = len;
+    c->ooff = 0;
+    client_flush(r, c);
+}
+
+static const char *status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 411: return "Length Required";
+    case 413: return "Payload Too Large";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Internal Server Error";
+    }
+}
+
+static void respond(router_t *r, client_t *c, int status, const char *body) {
+    size_t blen = strlen(body), cap = blen + 256;
+    char *buf = malloc(cap);
+    if (!buf) {
+        client_close(r, c);
+        return;
+    }
+    int n = snprintf(buf, cap, "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n%s\r\n%s",
+                     status, status_text(status), blen, c->close_after ? "Connection: close\r\n" : "", body);
+    client_send(r, c, buf, (size_t)n);
+}
+
+// 1 with a complete request, 0 when more bytes are needed, -1 on a bad one
+// (*status set to the answer)
+static int parse_request(client_t *c, request_t *rq, int *status) {
+    *status = 400;
+    char *end = memmem(c->rbuf, c->rlen, "\r\n\r\n", 4);
+    if (!end) return c->rlen >= 16384 ? -1 : 0;
+    memset(rq, 0, sizeof(*rq));
+    rq->header_len = (size_t)(end - c->rbuf) + 4;
+    char *line = c->rbuf, *sp1 = memchr(line, ' ', (size_t)(end - line));
+    char *sp2 = sp1 ? memchr(sp1 + 1, ' ', (size_t)(end - sp1 - 1)) : NULL;
+    if (!sp2) return -1;
+    rq->method = line;
+    rq->method_len = (size_t)(sp1 - line);
+    rq->path = sp1 + 1;
+    rq->path_len = (size_t)(sp2 - sp1 - 1);
+    rq->close = !strncmp(sp2 + 1, "HTTP/1.0", 8);
+
+    for (char *h = memchr(sp2, '\n', (size_t)(end - sp2)); h && h < end; h = memchr(h, '\n', (size_t)(end - h))) {
+        h++;
+        char *eol = memchr(h, '\r', (size_t)(end + 2 - h)), *colon = memchr(h, ':', (size_t)(eol - h));
+        if (!colon) continue;
+        char *v = colon + 1;
+        while (v < eol && *v == ' ') v++;
+        size_t name_len = (size_t)(colon - h), vlen = (size_t)(eol - v);
+        if (name_len == 14 && !strncasecmp(h, "Content-Length", 14)) {
+            rq->body_len = strtoul(v, NULL, 10);
+        } else if (name_len == 17 && !strncasecmp(h, "Transfer-Encoding", 17)) {
+            rq->chunked = true;
+        } else if (name_len == 11 && !strncasecmp(h, "X-Device-Id", 11) && vlen && vlen < DEVICE_ID_MAX) {
+            memcpy(rq->device, v, vlen);
+            rq->device[vlen] = '\0';
+        } else if (name_len == 10 && !strncasecmp(h, "Connection", 10)) {
+            rq->close = vlen >= 5 && !strncasecmp(v, "close", 5);
+        }
+    }
+    if (rq->chunked) {
+        *status = 411;
+        return -1;
+    }
+    if (rq->header_len + rq->body_len > REQUEST_MAX) {
+        *status = 413;
+        return -1;
+    }
+    return c->rlen >= rq->header_len + rq->body_len ? 1 : 0;
+}
+
+static bool path_is(const request_t *rq, const char *path) {
+    return rq->path_len == strlen(path) && !memcmp(rq->path, path, rq->path_len);
+}
+
+// iso6346 of one payload of the given codec; struct payloads are decoded,
+// session frames carry no key
+static bool payload_key(container_codec_t codec, const uint8_t *body, size_t len, uint64_t *key) {
+    if (!len) return false;
+    char id[DEVICE_ID_MAX];
+    if (codec == CONTAINER_CODEC_STRUCT_ZLIB || codec == CONTAINER_CODEC_STRUCT_RANS) {
+        if ((body[0] & 0xF0) == DEFLATE_SESSION_MAGIC) return false;
+        codec = (body[0] & 0xF0) == RECORD_RANS_MAGIC ? CONTAINER_CODEC_STRUCT_RANS : CONTAINER_CODEC_STRUCT_ZLIB;
+        container_record_t rec;
+        if (container_codec_decode_record(codec, body, len, &rec) != 0) return false;
+        *key = chash_key(rec.iso6346, strlen(rec.iso6346));
+        return true;
+    }
+    if (container_codec_peek_iso6346(codec, body, len, id, sizeof(id)) != 0) return false;
+    *key = chash_key(id, strlen(id));
+    return true;
+}
+
+// Device key of a request: X-Device-Id, else read from the body by route
+static bool request_key(const request_t *rq, const uint8_t *body, uint64_t *key) {
+    if (rq->device[0]) {
+        *key = chash_key(rq->device, strlen(rq->device));
+        return true;
+    }
+    if (path_is(rq, "/container-data")) return payload_key(opt.codec, body, rq->body_len, key);
+    if (path_is(rq, "/astrocast-callback")) {
+        astrocast_reader_t ar;
+        astrocast_msg_t msg;
+        if (astrocast_reader_init(&ar, (const char *)body, rq->body_len) != 0 ||
+            astrocast_reader_next(&ar, &msg) != 1 || !msg.device_guid)
+            return false;
+        *key = chash_key(msg.device_guid, msg.device_guid_len);
+        return true;
+    }
+    if (path_is(rq, "/container-data/batch")) {
+        batch_reader_t br;
+        batch_item_t item;
+        if (batch_reader_init(&br, body, rq->body_len) != BATCH_FRAME_OK || batch_reader_next(&br, &item) != BATCH_FRAME_OK)
+            return false;
+        if (item.device_id_len) {
+            *key = chash_key((const char *)item.device_id, item.device_id_len);
+            return true;
+        }
+        container_codec_t codec = opt.codec;
+        if (item.format >= BATCH_FORMAT_CBOR && item.format <= BATCH_FORMAT_STRUCT_RANS)
+            codec = (container_codec_t)(item.format - 1);
+        return payload_key(codec, item.payload, item.payload_len, key);
+    }
+    return false;
+}
+
+static void handle_router_stats(router_t *r, client_t *c) {
+    size_t cap = 512 + (size_t)CHASH_MAX_NODES * 320, len = 0;
+    char *body = malloc(cap);
+    if (!body) {
+        respond(r, c, 503, "{\"error\":\"Out of memory\"}");
+        return;
+    }
+    len += (size_t)snprintf(body + len, cap - len,
+                            "{\"threads\":%u,\"vnodes\":%u,\"epsilon\":%.3f,\"unkeyed\":%llu,\"noBackend\":%llu,"
+                            "\"partitions\":%u,\"ownerRouted\":%llu,\"backends\":[",
+                            opt.threads, opt.vnodes, opt.epsilon,
+                            (unsigned long long)atomic_load_explicit(&unkeyed, memory_order_relaxed),
+                            (unsigned long long)atomic_load_explicit(&no_backend, memory_order_relaxed),
+                            r->partitions, (unsigned long long)atomic_load_explicit(&owner_routed, memory_order_relaxed));
+    unsigned count = atomic_load(&node_name_count);
+    for (unsigned n = 0; n < count; n++) {
+        node_stats_t *s = &node_stats[n];
+        bool member = r->ring.node[n].weight > 0;
+        len += (size_t)snprintf(body + len, cap - len,
+                                "%s{\"name\":\"%s\",\"member\":%s,\"up\":%s,\"weight\":%u,\"inflight\":%lld,"
+                                "\"requests\":%llu,\"keyed\":%llu,\"spilled\":%llu,\"retried\":%llu,\"errors\":%llu}",
+                                n ? "," : "", node_names[n], member ? "true" : "false",
+                                member && !atomic_load_explicit(&s->down, memory_order_relaxed) ? "true" : "false",
+                                r->ring.node[n].weight, (long long)atomic_load_explicit(&s->inflight, memory_order_relaxed),
+                                (unsigned long long)atomic_load_explicit(&s->requests, memory_order_relaxed),
+                                (unsigned long long)atomic_load_explicit(&s->keyed, memory_order_relaxed),
+                                (unsigned long long)atomic_load_explicit(&s->spilled, memory_order_relaxed),
+                                (unsigned long long)atomic_load_explicit(&s->retried, memory_order_relaxed),
+                                (unsigned long long)atomic_load_explicit(&s->errors, memory_order_relaxed));
+    }
+    len += (size_t)snprintf(body + len, cap - len, "]}");
+    respond(r, c, 200, body);
+    free(body);
+}
+
+// ================= UPSTREAM SIDE =================
+static void dispatch(router_t *r, client_t *c);
+
+static void upstream_arm(router_t *r, upstream_t *u, uint32_t events) {
+    struct epoll_event e = { .events = events, .data.u64 = TAG_UPSTREAM | (uint64_t)(u - r->ups) };
+    epoll_ctl(r->epfd, EPOLL_CTL_MOD, u->fd, &e);
+}
+
+// Idle connection to the instance, or a new one (connecting)
+static upstream_t *upstream_get(router_t *r, int node) {
+    while (r->pool_len[node]) {
+        upstream_t *u = &r->ups[r->pool[node][--r->pool_len[node]]];
+        if (u->fd >= 0) return u;
+    }
+    if (!r->free_up_count) return NULL;
+    int fd = socket(r->addr[node].ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return NULL;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    bool connecting = false;
+    if (connect(fd, (struct sockaddr *)&r->addr[node], r->addr_len[node]) != 0) {
+        if (errno != EINPROGRESS) {
+            close(fd);
+            return NULL;
+        }
+        connecting = true;
+    }
+    upstream_t *u = &r->ups[r->free_ups[--r->free_up_count]];
+    memset(u, 0, sizeof(*u));
+    u->fd = fd;
+    u->node = node;
+    u->client = -1;
+    u->connecting = connecting;
+    struct epoll_event e = { .events = EPOLLOUT, .data.u64 = TAG_UPSTREAM | (uint64_t)(u - r->ups) };
+    epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &e);
+    return u;
+}
+
+// Request of the client finished on this upstream (answered, failed or
+// abandoned): gives back the load and the connection
+static void upstream_release(router_t *r, upstream_t *u, bool reusable) {
+    chash_release(&r->ring, (unsigned)u->node);
+    atomic_fetch_sub_explicit(&node_stats[u->node].inflight, 1, memory_order_relaxed);
+    u->client = -1;
+    if (reusable && r->ring.node[u->node].weight && r->pool_len[u->node] < POOL_MAX) {
+        free(u->resp);
+        u->resp = NULL;
+        u->rlen = u->rcap = u->head_len = 0;
+        u->woff = 0;
+        u->reused = true;
+        r->pool[u->node][r->pool_len[u->node]++] = (int)(u - r->ups);
+        upstream_arm(r, u, EPOLLIN);                      // notices the instance closing it
+    } else {
+        upstream_close(r, u);
+    }
+}
+
+static void dispatch(router_t *r, client_t *c) {
+    // A cluster member owning the partition takes it, whatever its load
+    int node = -1;
+    if (c->keyed && r->partitions) {
+        node = r->partition_node[shard_pipeline_partition(c->key, r->partitions)];
+        if (node >= 0 && !r->ring.node[node].up) node = -1;
+        if (node >= 0) atomic_fetch_add_explicit(&owner_routed, 1, memory_order_relaxed);
+    }
+    if (node < 0) {
+        node = c->keyed ? chash_pick(&r->ring, c->key) : chash_least_loaded(&r->ring);
+        if (node >= 0 && c->keyed && node != chash_home(&r->ring, c->key))
+            atomic_fetch_add_explicit(&node_stats[node].spilled, 1, memory_order_relaxed);
+    }
+    if (node < 0) {
+        atomic_fetch_add_explicit(&no_backend, 1, memory_order_relaxed);
+        respond(r, c, 503, "{\"error\":\"No receiver instance up\"}");
+        return;
+    }
+    upstream_t *u = upstream_get(r, node);
+    if (!u) {
+        atomic_fetch_add_explicit(&node_stats[node].errors, 1, memory_order_relaxed);
+        if (r->free_up_count) mark_down(r, node);
+        if (++c->attempts < 2 && r->free_up_count) {
+            dispatch(r, c);
+            return;
+        }
+        respond(r, c, 502, "{\"error\":\"Receiver instance unreachable\"}");
+        return;
+    }
+    chash_acquire(&r->ring, (unsigned)node);
+    atomic_fetch_add_explicit(&node_stats[node].inflight, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&node_stats[node].requests, 1, memory_order_relaxed);
+    if (c->keyed) atomic_fetch_add_explicit(&node_stats[node].keyed, 1, memory_order_relaxed);
+    if (c->attempts) atomic_fetch_add_explicit(&node_stats[node].retried, 1, memory_order_relaxed);
+    c->node = node;
+    c->upstream = (int)(u - r->ups);
+    u->client = (int)(c - r->clients);
+    u->client_gen = c->gen;
+    u->head = c->rlen >= 4 && !memcmp(c->rbuf, "HEAD", 4);
+    u->woff = 0;
+    u->deadline = now_s() + opt.timeout_s;
+    upstream_arm(r, u, EPOLLOUT);
+}
+
+// Upstream failed. Retried once elsewhere when nothing came back yet and
+// the failure looks like a refused connection or a stale keep-alive one.
+static void upstream_fail(router_t *r, upstream_t *u, int status) {
+    client_t *c = u->client >= 0 ? &r->clients[u->client] : NULL;
+    if (c && (c->fd < 0 || c->gen != u->client_gen)) c = NULL;
+    bool retry = c && !u->rlen && (u->connecting || u->reused) && c->attempts < 1;
+    int node = u->node;
+    atomic_fetch_add_explicit(&node_stats[node].errors, 1, memory_order_relaxed);
+    if (u->connecting) mark_down(r, node);
+    upstream_release(r, u, false);
+    if (!c) return;
+    c->upstream = -1;
+    if (retry) {
+        c->attempts++;
+        dispatch(r, c);
+    } else {
+        respond(r, c, status, status == 504 ? "{\"error\":\"Receiver instance timed out\"}"
+                                            : "{\"error\":\"Receiver instance failed\"}");
+    }
+}
+
+// Length of a complete chunked body from start, or 0 while incomplete
+static size_t chunked_end(const char *buf, size_t len, size_t start) {
+    size_t p = start;
+    for (;;) {
+        const char *eol = memmem(buf + p, len - p, "\r\n", 2);
+        if (!eol) return 0;
+        size_t size = strtoul(buf + p, NULL, 16);
+        p = (size_t)(eol - buf) + 2;
+        if (!size) {
+            // Trailers, then an empty line
+            for (;;) {
+                const char *t = memmem(buf + p, len - p, "\r\n", 2);
+                if (!t) return 0;
+                if (t == buf + p) return p + 2;
+                p = (size_t)(t - buf) + 2;
+            }
+        }
+        if (len - p < size + 2) return 0;
+        p += size + 2;
+    }
+}
+
+static void parse_response_head(upstream_t *u) {
+    char *end = memmem(u->resp, u->rlen, "\r\n\r\n", 4);
+    if (!end) return;
+    u->head_len = (size_t)(end - u->resp) + 4;
+    u->body_len = -2;
+    u->keep_alive = u->rlen > 8 && !memcmp(u->resp, "HTTP/1.1", 8);
+    int status = u->rlen > 12 ? atoi(u->resp + 9) : 0;
+    if (u->head || status == 204 || status == 304 || (status >= 100 && status < 200)) u->body_len = 0;
+    for (char *h = memchr(u->resp, '\n', (size_t)(end - u->resp)); h && h < end;
+         h = memchr(h, '\n', (size_t)(end - h))) {
+        h++;
+        char *eol = memchr(h, '\r', (size_t)(end + 2 - h)), *colon = memchr(h, ':', (size_t)(eol - h));
+        if (!colon) continue;
+        char *v = colon + 1;
+        while (v < eol && *v == ' ') v++;
+        size_t name_len = (size_t)(colon - h), vlen = (size_t)(eol - v);
+        if (name_len == 14 && !strncasecmp(h, "Content-Length", 14) && u->body_len == -2) {
+            u->body_len = strtoll(v, NULL, 10);
+        } else if (name_len == 17 && !strncasecmp(h, "Transfer-Encoding", 17) && u->body_len == -2) {
+            u->body_len = -1;
+        } else if (name_len == 10 && !strncasecmp(h, "Connection", 10)) {
+            if (vlen >= 5 && !strncasecmp(v, "close", 5)) u->keep_alive = false;
+        }
+    }
+    if (u->body_len == -2) u->keep_alive = false;
+}
+
+// Length of the whole response once it is buffered, else 0
+static size_t response_total(upstream_t *u) {
+    if (!u->head_len) parse_response_head(u);
+    if (!u->head_len) return 0;
+    if (u->body_len >= 0 && u->rlen >= u->head_len + (size_t)u->body_len) return u->head_len + (size_t)u->body_len;
+    if (u->body_len == -1) return chunked_end(u->resp, u->rlen, u->head_len);
+    return 0;
+}
+
+// Whole response buffered: hand it to the client
+static void upstream_complete(router_t *r, upstream_t *u, size_t total) {
+    client_t *c = &r->clients[u->client];
+    bool live = c->fd >= 0 && c->gen == u->client_gen;
+    char *resp = u->resp;
+    bool reusable = u->keep_alive && total == u->rlen;
+    u->resp = NULL;
+    upstream_release(r, u, reusable);
+    if (!live) {
+        free(resp);
+        return;
+    }
+    c->upstream = -1;
+    client_send(r, c, resp, total);
+}
+
+static void upstream_write(router_t *r, upstream_t *u) {
+    if (u->client < 0) {                                    // idle in the pool
+        upstream_arm(r, u, EPOLLIN);
+        return;
+    }
+    if (u->connecting) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(u->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err) {
+            upstream_fail(r, u, 502);
+            return;
+        }
+    }
+    client_t *c = &r->clients[u->client];
+    if (c->fd < 0 || c->gen != u->client_gen) {            // client gone before the request was sent
+        upstream_release(r, u, u->woff == 0 && !u->connecting);
+        return;
+    }
+    while (u->woff < c->req_len) {
+        ssize_t n = send(u->fd, c->rbuf + u->woff, c->req_len - u->woff, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (n <= 0) {
+            upstream_fail(r, u, 502);
+            return;
+        }
+        u->woff += (size_t)n;
+        u->connecting = false;
+    }
+    u->connecting = false;
+    upstream_arm(r, u, EPOLLIN);
+}
+
+static void upstream_read(router_t *r, upstream_t *u) {
+    if (u->client < 0) {                                    // idle: the instance closed it
+        pool_drop(r, u->node, (int)(u - r->ups));
+        upstream_close(r, u);
+        return;
+    }
+    for (;;) {
+        if (u->rlen == u->rcap) {
+            size_t cap = u->rcap ? 2 * u->rcap : 4096;
+            char *buf = cap <= RESPONSE_MAX ? realloc(u->resp, cap) : NULL;
+            if (!buf) {
+                upstream_fail(r, u, 502);
+                return;
+            }
+            u->resp = buf;
+            u->rcap = cap;
+        }
+        ssize_t n = recv(u->fd, u->resp + u->rlen, u->rcap - u->rlen, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            // The response can come in with the close (Connection: close)
+            size_t total = response_total(u);
+            if (total) upstream_complete(r, u, total);
+            else if (u->head_len && u->body_len == -2) upstream_complete(r, u, u->rlen);   // body runs to the close
+            else upstream_fail(r, u, 502);
+            return;
+        }
+        u->rlen += (size_t)n;
+    }
+    size_t total = response_total(u);
+    if (total) upstream_complete(r, u, total);
+}
+
+// ================= REQUEST LOOP =================
+static void client_serve(router_t *r, client_t *c) {
+    if (c->fd < 0 || c->upstream >= 0 || c->obuf) return;
+    request_t rq;
+    int status;
+    int rc = parse_request(c, &rq, &status);
+    if (rc == 0) return;
+    if (rc < 0) {
+        c->close_after = true;
+        c->req_len = c->rlen;
+        respond(r, c, status, "{\"error\":\"Bad request\"}");
+        return;
+    }
+    c->close_after = rq.close;
+    c->req_len = rq.header_len + rq.body_len;
+    c->attempts = 0;
+    if (path_is(&rq, "/router/stats")) {
+        handle_router_stats(r, c);
+        return;
+    }
+    c->keyed = request_key(&rq, (const uint8_t *)c->rbuf + rq.header_len, &c->key);
+    if (!c->keyed) atomic_fetch_add_explicit(&unkeyed, 1, memory_order_relaxed);
+    dispatch(r, c);
+}
+
+static void client_read(router_t *r, client_t *c) {
+    for (;;) {
+        if (c->rlen == c->rcap) {
+            if (c->rcap >= REQUEST_MAX) break;
+            size_t cap = c->rcap ? 2 * c->rcap : RBUF_INITIAL;
+            char *buf = realloc(c->rbuf, cap);
+            if (!buf) {
+                client_close(r, c);
+                return;
+            }
+            c->rbuf = buf;
+            c->rcap = cap;
+        }
+        ssize_t n = recv(c->fd, c->rbuf + c->rlen, c->rcap - c->rlen, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            // The upstream may still be writing this request from rbuf: it
+            // sees the generation change and gives the connection back
+            client_close(r, c);
+            return;
+        }
+        c->rlen += (size_t)n;
+    }
+    client_serve(r, c);
+}
+
+static void accept_all(router_t *r) {
+    for (;;) {
+        int fd = accept4(r->lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (!r->free_client_count) {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        uint32_t slot = r->free_clients[--r->free_client_count];
+        client_t *c = &r->clients[slot];
+        c->fd = fd;
+        c->close_after = false;
+        c->upstream = -1;
+        c->rlen = c->req_len = 0;
+        c->olen = c->ooff = 0;
+        struct epoll_event e = { .events = EPOLLIN, .data.u64 = slot };
+        epoll_ctl(r->epfd, EPOLL_CTL_ADD, fd, &e);
+    }
+}
+
+// Upstreams past their deadline answer 504
+static void expire(router_t *r, double now) {
+    for (uint32_t i = 0; i < MAX_UPSTREAMS; i++) {
+        upstream_t *u = &r->ups[i];
+        if (u->fd >= 0 && u->client >= 0 && now > u->deadline) {
+            u->rlen = 1;                                    // no retry: the instance may have taken it
+            u->connecting = false;
+            upstream_fail(r, u, 504);
+        }
+    }
+}
+
+static void *router_main(void *arg) {
+    router_t *r = arg;
+    struct epoll_event events[256];
+    double next_tick = now_s() + 1.0;
+    while (!stop) {
+        if (atomic_load_explicit(&members_gen, memory_order_acquire) != r->gen) apply_members(r);
+        int n = epoll_wait(r->epfd, events, 256, 200);
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == TAG_LISTEN) {
+                accept_all(r);
+            } else if (tag & TAG_UPSTREAM) {
+                upstream_t *u = &r->ups[tag & 0xFFFFFFFF];
+                if (u->fd < 0) continue;
+                if (events[i].events & EPOLLOUT) upstream_write(r, u);
+                if (u->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                    if (u->connecting) upstream_fail(r, u, 502);
+                    else upstream_read(r, u);
+                }
+            } else {
+                client_t *c = &r->clients[tag];
+                if (c->fd < 0) continue;
+                if (events[i].events & EPOLLOUT) client_flush(r, c);
+                if (c->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) client_read(r, c);
+            }
+        }
+        double now = now_s();
+        if (now >= next_tick) {
+            revive(r, now);
+            expire(r, now);
+            next_tick = now + 1.0;
+        }
+    }
+    return NULL;
+}
+
+static int router_init(router_t *r, unsigned index) {
+    r->index = index;
+    r->lfd = open_listener();
+    r->epfd = epoll_create1(EPOLL_CLOEXEC);
+    r->clients = calloc(MAX_CLIENTS, sizeof(*r->clients));
+    r->free_clients = malloc(MAX_CLIENTS * sizeof(*r->free_clients));
+    r->ups = calloc(MAX_UPSTREAMS, sizeof(*r->ups));
+    r->free_ups = malloc(MAX_UPSTREAMS * sizeof(*r->free_ups));
+    if (r->lfd < 0 || r->epfd < 0 || !r->clients || !r->free_clients || !r->ups || !r->free_ups) return -1;
+    for (uint32_t i = 0; i < MAX_CLIENTS; i++) {
+        r->clients[i].fd = -1;
+        r->free_clients[i] = MAX_CLIENTS - 1 - i;
+    }
+    for (uint32_t i = 0; i < MAX_UPSTREAMS; i++) {
+        r->ups[i].fd = -1;
+        r->free_ups[i] = MAX_UPSTREAMS - 1 - i;
+    }
+    r->free_client_count = MAX_CLIENTS;
+    r->free_up_count = MAX_UPSTREAMS;
+    if (chash_init(&r->ring, opt.vnodes, opt.epsilon) != 0) return -1;
+    apply_members(r);
+    struct epoll_event l = { .events = EPOLLIN, .data.u64 = TAG_LISTEN };
+    epoll_ctl(r->epfd, EPOLL_CTL_ADD, r->lfd, &l);
+    return 0;
+}
+
+static void print_stats(double t) {
+    printf("%8.1fs", t);
+    unsigned count = atomic_load(&node_name_count);
+    for (unsigned n = 0; n < count; n++) {
+        if (!routers[0].ring.node[n].weight) continue;
+        node_stats_t *s = &node_stats[n];
+        printf("  %s %s%llu req %llu spill %lld in flight", node_names[n],
+               atomic_load_explicit(&s->down, memory_order_relaxed) ? "DOWN " : "",
+               (unsigned long long)atomic_load_explicit(&s->requests, memory_order_relaxed),
+               (unsigned long long)atomic_load_explicit(&s->spilled, memory_order_relaxed),
+               (long long)atomic_load_explicit(&s->inflight, memory_order_relaxed));
+    }
+    printf("  unkeyed %llu\n", (unsigned long long)atomic_load_explicit(&unkeyed, memory_order_relaxed));
+    fflush(stdout);
+}
+
+static int run_router(void) {
+    routers = calloc(opt.threads, sizeof(*routers));
+    if (!routers) return 1;
+    for (unsigned i = 0; i < opt.threads; i++) {
+        if (router_init(&routers[i], i) != 0) {
+            fprintf(stderr, "cannot listen on %s:%u\n", opt.host[0] ? opt.host : "*", opt.port);
+            return 1;
+        }
+    }
+    for (unsigned i = 0; i < opt.threads; i++) pthread_create(&routers[i].thread, NULL, router_main, &routers[i]);
+    printf("listening on %s:%u, codec %s, %u threads, %u backends, %u vnodes, epsilon %.2f\n",
+           opt.host[0] ? opt.host : "*", opt.port, container_codec_name(opt.codec), opt.threads, member_count,
+           opt.vnodes, opt.epsilon);
+    fflush(stdout);
+    double start = now_s(), next = start + opt.stats_s, next_map = start + opt.map_s;
+    while (!stop) {
+        usleep(100000);
+        if (reload) {
+            reload = 0;
+            if (opt.backends_file) reload_backends();
+        }
+        if (opt.cluster && now_s() >= next_map) {
+            if (refresh_map() != 0) fprintf(stderr, "cannot read the cluster map, keeping the last one\n");
+            next_map = now_s() + opt.map_s;
+        }
+        if (opt.stats_s > 0.0 && now_s() >= next) {
+            print_stats(now_s() - start);
+            next += opt.stats_s;
+        }
+    }
+    for (unsigned i = 0; i < opt.threads; i++) pthread_join(routers[i].thread, NULL);
+    print_stats(now_s() - start);
+    return 0;
+}
+
+// ================= BENCH =================
+static uint64_t splitmix(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void bench_node_name(unsigned i, char *out, size_t cap) {
+    snprintf(out, cap, "receiver-%u:3000", i);
+}
+
+static int bench_ring(chash_t *h, unsigned nodes) {
+    if (chash_init(h, opt.vnodes, opt.epsilon) != 0) return -1;
+    for (unsigned i = 0; i < nodes; i++) {
+        char name[CHASH_NAME_MAX];
+        bench_node_name(i, name, sizeof(name));
+        if (chash_add(h, name, 1) < 0) return -1;
+    }
+    return 0;
+}
+
+static uint64_t *bench_keys(void) {
+    uint64_t *keys = malloc(opt.keys * sizeof(*keys));
+    if (!keys) return NULL;
+    for (size_t i = 0; i < opt.keys; i++) {
+        char id[16];
+        int n = snprintf(id, sizeof(id), "MSCU%07zu", i);     // iso6346-like container ids
+        keys[i] = chash_key(id, (size_t)n);
+    }
+    return keys;
+}
+
+// Share of the keys whose home changed, and whether any moved between two
+// nodes that both stayed
+static double bench_moved(const uint8_t *before, const uint8_t *after, int changed, size_t *stray) {
+    size_t moved = 0;
+    *stray = 0;
+    for (size_t i = 0; i < opt.keys; i++) {
+        if (before[i] == after[i]) continue;
+        moved++;
+        if (before[i] != changed && after[i] != changed) (*stray)++;
+    }
+    return (double)moved / opt.keys;
+}
+
+// Skewed stream with a fixed number of requests in flight, oldest finishing
+// first; returns the peak load of the busiest node over the fair share
+static double bench_spread(chash_t *h, const uint64_t *keys, bool bounded, double *spill) {
+    unsigned *owner = calloc(opt.inflight, sizeof(*owner));
+    if (!owner) return 0.0;
+    for (unsigned n = 0; n < h->node_count; n++) {
+        h->node[n].load = 0;
+        h->node[n].picked = h->node[n].spilled = 0;
+    }
+    h->total_load = 0;
+    uint64_t rng = 7, requests = 20 * (uint64_t)opt.inflight + 200000, spilled = 0;
+    uint32_t peak = 0;
+    for (uint64_t i = 0; i < requests; i++) {
+        size_t slot = i % opt.inflight;
+        if (i >= opt.inflight) chash_release(h, owner[slot]);
+        uint64_t x = splitmix(&rng);
+        // opt.hot of the requests come from 16 hot devices (a gateway draining its store, a stuck retry loop)
+        size_t k = (double)(x >> 11) / 9007199254740992.0 < opt.hot ? (x & 15) : (size_t)(x % opt.keys);
+        int n = bounded ? chash_pick(h, keys[k]) : chash_home(h, keys[k]);
+        if (n != chash_home(h, keys[k])) spilled++;
+        chash_acquire(h, (unsigned)n);
+        owner[slot] = (unsigned)n;
+        if (i >= opt.inflight && h->node[n].load > peak) peak = h->node[n].load;
+    }
+    free(owner);
+    *spill = (double)spilled / requests;
+    return peak / ((double)opt.inflight / opt.nodes);
+}
+
+static int run_bench(void) {
+    if (opt.nodes < 2 || opt.nodes >= CHASH_MAX_NODES || !opt.keys || !opt.inflight) return 2;
+    uint64_t *keys = bench_keys();
+    uint8_t *base = malloc(opt.keys), *other = malloc(opt.keys);
+    chash_t h, g;
+    if (!keys || !base || !other || bench_ring(&h, opt.nodes) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    printf("%u instances, %u vnodes, epsilon %.2f, %zu keys\n\n", opt.nodes, opt.vnodes, opt.epsilon, opt.keys);
+
+    // Key balance
+    size_t count[CHASH_MAX_NODES] = { 0 };
+    double t = now_s();
+    for (size_t i = 0; i < opt.keys; i++) base[i] = (uint8_t)chash_home(&h, keys[i]);
+    double home_ns = (now_s() - t) * 1e9 / opt.keys;
+    size_t max = 0, min = SIZE_MAX;
+    for (size_t i = 0; i < opt.keys; i++) count[base[i]]++;
+    for (unsigned n = 0; n < opt.nodes; n++) {
+        if (count[n] > max) max = count[n];
+        if (count[n] < min) min = count[n];
+    }
+    double mean = (double)opt.keys / opt.nodes;
+    printf("key share      max %.3f  min %.3f of the mean\n", max / mean, min / mean);
+
+    // Join: one more instance
+    size_t stray;
+    char name[CHASH_NAME_MAX];
+    bench_node_name(opt.nodes, name, sizeof(name));
+    int added = chash_add(&h, name, 1);
+    for (size_t i = 0; i < opt.keys; i++) other[i] = (uint8_t)chash_home(&h, keys[i]);
+    double moved = bench_moved(base, other, added, &stray);
+    printf("join           %.2f %% of keys moved (ideal %.2f %%), %zu between other instances\n", 100.0 * moved,
+           100.0 / (opt.nodes + 1), stray);
+    chash_remove(&h, (unsigned)added);
+
+    // Leave: instance 0 goes
+    chash_remove(&h, 0);
+    for (size_t i = 0; i < opt.keys; i++) other[i] = (uint8_t)chash_home(&h, keys[i]);
+    moved = bench_moved(base, other, 0, &stray);
+    printf("leave          %.2f %% of keys moved (ideal %.2f %%), %zu between other instances\n", 100.0 * moved,
+           100.0 / opt.nodes, stray);
+    chash_free(&h);
+
+    // Load spread under a skewed stream
+    if (bench_ring(&g, opt.nodes) != 0) return 1;
+    double spill_home, spill_bounded;
+    double peak_home = bench_spread(&g, keys, false, &spill_home);
+    t = now_s();
+    double peak_bounded = bench_spread(&g, keys, true, &spill_bounded);
+    double pick_ns = (now_s() - t) * 1e9 / (20.0 * opt.inflight + 200000);
+    printf("peak load      %.2f x fair share home only, %.2f x with the bound (%u in flight, %.0f %% hot)\n",
+           peak_home, peak_bounded, opt.inflight, 100.0 * opt.hot);
+    printf("spilled        %.2f %% of requests away from their home\n", 100.0 * spill_bounded);
+    printf("cost           %.0f ns per home lookup, %.0f ns per bounded pick (with release)\n", home_ns, pick_ns);
+    chash_free(&g);
+    free(keys);
+    free(base);
+    free(other);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --listen [ADDR:]PORT  HTTP listen address (default 8080)\n"
+            "  --backend HOST:PORT[=W]  receiver instance, weight W (default 1); repeat per instance\n"
+            "  --backends FILE       one HOST:PORT[=W] per line, re-read on SIGHUP\n"
+            "  --codec NAME          body codec for the key: cbor, msgpack, protobuf, struct-zlib,\n"
+            "                        struct-rans (default cbor)\n"
+            "  --threads N           router threads (default 1)\n"
+            "  --vnodes N            ring points per instance and unit of weight (default 160)\n"
+            "  --epsilon E           load bound, (1 + E) x fair share (default 0.25)\n"
+            "  --timeout S           upstream response timeout (default 10)\n"
+            "  --retry-down S        seconds an unreachable instance stays down (default 5)\n"
+            "  --stats S             status line interval, 0 for none (default 5)\n"
+            "  --cluster HOST:PORT   HTTP address of a shard_receiver cluster member: the instances\n"
+            "                        and partition owners come from its GET /cluster/map\n"
+            "  --map-interval S      cluster map refresh (default 1)\n"
+            "  --bench               ring measurements instead of HTTP\n"
+            "  --nodes N             bench instances (default 8)\n"
+            "  --keys N              bench device keys (default 1000000)\n"
+            "  --inflight N          bench requests in flight (default 1024)\n"
+            "  --hot P               bench: share of requests from 16 hot devices (default 0.2)\n",
+            prog);
+}
+
+static int parse_listen(const char *v) {
+    const char *colon = strrchr(v, ':');
+    if (colon) {
+        size_t n = (size_t)(colon - v);
+        if (n >= sizeof(opt.host)) return -1;
+        memcpy(opt.host, v, n);
+        opt.host[n] = '\0';
+        v = colon + 1;
+    }
+    char *end;
+    unsigned long port = strtoul(v, &end, 10);
+    if (*end || port == 0 || port > 65535) return -1;
+    opt.port = (uint16_t)port;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    opt.port = 8080;
+    opt.codec = CONTAINER_CODEC_CBOR;
+    opt.threads = 1;
+    opt.vnodes = 160;
+    opt.epsilon = 0.25;
+    opt.timeout_s = 10.0;
+    opt.retry_down_s = 5.0;
+    opt.stats_s = 5.0;
+    opt.map_s = 1.0;
+    opt.nodes = 8;
+    opt.keys = 1000000;
+    opt.inflight = 1024;
+    opt.hot = 0.2;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (!strcmp(a, "--bench")) { opt.bench = true; continue; }
+        const char *v = i + 1 < argc ? argv[++i] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--listen")) {
+            if (parse_listen(v)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--backend")) {
+            if (add_member(members, &member_count, v)) { fprintf(stderr, "bad backend: %s\n", v); return 2; }
+        } else if (!strcmp(a, "--backends")) {
+            opt.backends_file = v;
+            if (load_backends(v, members, &member_count)) { fprintf(stderr, "cannot read %s\n", v); return 2; }
+        } else if (!strcmp(a, "--codec")) {
+            if (container_codec_parse(v, &opt.codec)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--threads")) opt.threads = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--vnodes")) opt.vnodes = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--epsilon")) opt.epsilon = atof(v);
+        else if (!strcmp(a, "--timeout")) opt.timeout_s = atof(v);
+        else if (!strcmp(a, "--retry-down")) opt.retry_down_s = atof(v);
+        else if (!strcmp(a, "--stats")) opt.stats_s = atof(v);
+        else if (!strcmp(a, "--cluster")) opt.cluster = v;
+        else if (!strcmp(a, "--map-interval")) opt.map_s = atof(v);
+        else if (!strcmp(a, "--nodes")) opt.nodes = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--keys")) opt.keys = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--inflight")) opt.inflight = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--hot")) opt.hot = atof(v);
+        else { usage(argv[0]); return 2; }
+    }
+    if (!opt.threads || !opt.vnodes || opt.epsilon <= 0.0 || opt.timeout_s <= 0.0 || opt.hot < 0.0 ||
+        opt.hot > 1.0 || (!opt.bench && !member_count && !opt.cluster) || (opt.cluster && member_count) ||
+        opt.map_s <= 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.bench) return run_bench();
+    if (record_rans_decoder_init() != 0) {
+        fprintf(stderr, "rANS model tables are inconsistent\n");
+        return 1;
+    }
+    if (opt.cluster && refresh_map() != 0) {
+        fprintf(stderr, "cannot read the cluster map from %s\n", opt.cluster);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGHUP, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    return run_router();
+}
@@ -0,0 +1,345 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Heap use per pipeline stage (firmware/alloc_track.h).
+//
+// Runs every stage of the sender and receiver pipelines on a stream of
+// generated records with the malloc hooks in place: record generation,
+// each codec's encoder, the session deflate sender, and the decoders the
+// receiver mirrors (zlib, static rANS, session inflate). Prints
+// allocations, bytes, peak and retained bytes per call for every stage.
+//
+// --json writes the figures as a baseline; --baseline compares against one
+// and exits 1 when a stage allocates more often, more bytes, or peaks or
+// retains more than the tolerance allows, so an allocation regression
+// fails the benchmark run instead of showing up on the device.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "alloc_track.h"
+#include "container_codecs.h"
+#include "container_record.h"
+#include "deflate_session.h"
+#include "record_rans.h"
+
+#define MAX_STAGES ALLOC_TRACK_MAX_STAGES
+#define STAGE_NAME_MAX 32
+#define TIME_BASE 1735689600              // fixed, so a seed gives the same records every run
+
+typedef struct {
+    size_t messages;
+    uint64_t seed;
+    const char *json_path;
+    const char *baseline_path;
+    double tolerance;                     // fraction above the baseline
+    double slack_bytes;                   // absolute allowance for byte figures
+} bench_opts_t;
+
+typedef struct {
+    char name[STAGE_NAME_MAX];
+    double calls, allocs, bytes, peak, retained;
+} baseline_row_t;
+
+typedef struct {
+    double messages, seed;
+    baseline_row_t rows[MAX_STAGES];
+    int count;
+} baseline_t;
+
+static char stage_names[MAX_STAGES][STAGE_NAME_MAX];
+
+static int stage_id(const char *fmt, const char *arg) {
+    static int used;
+    char name[STAGE_NAME_MAX];
+    snprintf(name, sizeof(name), fmt, arg);
+    for (int i = 0; i < used; i++) {
+        if (!strcmp(stage_names[i], name)) return alloc_track_stage(stage_names[i]);
+    }
+    if (used == MAX_STAGES) return -1;
+    memcpy(stage_names[used], name, sizeof(name));
+    return alloc_track_stage(stage_names[used++]);
+}
+
+// ================= PIPELINE =================
+static size_t run(const bench_opts_t *opt) {
+    int st_generate = stage_id("%s", "generate");
+    int st_encode[CONTAINER_CODEC_COUNT];
+    for (int c = 0; c < CONTAINER_CODEC_COUNT; c++)
+        st_encode[c] = stage_id("encode:%s", container_codec_name((container_codec_t)c));
+    int st_pack = stage_id("%s", "pack");
+    int st_sinit = stage_id("%s", "session:init");
+    int st_scompress = stage_id("%s", "session:compress");
+    int st_dzlib = stage_id("%s", "decode:struct-zlib");
+    int st_drans = stage_id("%s", "decode:struct-rans");
+    int st_iinit = stage_id("%s", "session:inflate-init");
+    int st_inflate = stage_id("%s", "session:inflate");
+
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt->seed, TIME_BASE, 3600);
+    deflate_session_t tx;
+    inflate_session_t rx;
+    alloc_track_enter(st_sinit);
+    int rc = deflate_session_init(&tx, Z_BEST_COMPRESSION, DEFLATE_SESSION_KEYFRAME_INTERVAL);
+    alloc_track_leave();
+    alloc_track_enter(st_iinit);
+    rc |= inflate_session_init(&rx);
+    alloc_track_leave();
+    if (rc != DEFLATE_SESSION_OK) return opt->messages;
+
+    size_t failures = 0;
+    for (size_t m = 0; m < opt->messages; m++) {
+        container_record_t rec;
+        uint8_t payload[CONTAINER_CODEC_MAX_PAYLOAD], packed[CONTAINER_RECORD_STRUCT_MAX];
+        uint8_t frame[CONTAINER_CODEC_MAX_PAYLOAD], out[RECORD_RANS_MAX_RECORD];
+
+        alloc_track_enter(st_generate);
+        container_record_generate(&gen, &rec);
+        alloc_track_leave();
+
+        for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+            alloc_track_enter(st_encode[c]);
+            size_t n = container_codec_encode((container_codec_t)c, &rec, payload, sizeof(payload));
+            alloc_track_leave();
+            if (!n) {
+                failures++;
+                continue;
+            }
+            if (c == CONTAINER_CODEC_STRUCT_ZLIB) {
+                uLongf len = sizeof(out);
+                alloc_track_enter(st_dzlib);
+                failures += uncompress(out, &len, payload, n) != Z_OK;
+                alloc_track_leave();
+            } else if (c == CONTAINER_CODEC_STRUCT_RANS) {
+                alloc_track_enter(st_drans);
+                failures += record_rans_decode(payload, n, out, sizeof(out)) < 0;
+                alloc_track_leave();
+            }
+        }
+
+        alloc_track_enter(st_pack);
+        size_t len = container_record_pack_struct(&rec, packed, sizeof(packed));
+        alloc_track_leave();
+        alloc_track_enter(st_scompress);
+        int flen = deflate_session_compress(&tx, packed, len, frame, sizeof(frame));
+        alloc_track_leave();
+        if (flen <= 0) {
+            failures++;
+            continue;
+        }
+        alloc_track_enter(st_inflate);
+        int olen = inflate_session_decompress(&rx, frame, (size_t)flen, out, sizeof(out));
+        alloc_track_leave();
+        failures += olen != (int)len || memcmp(out, packed, len);
+    }
+    deflate_session_end(&tx);
+    inflate_session_end(&rx);
+    return failures;
+}
+
+// ================= OUTPUT =================
+static double per_call(uint64_t v, uint64_t calls) {
+    return calls ? (double)v / calls : 0.0;
+}
+
+static void print_table(const alloc_track_stage_t *s, size_t n) {
+    printf("%-22s %8s %11s %11s %9s %9s %11s\n", "Stage", "Calls", "Allocs/call", "Bytes/call", "Peak",
+           "Largest", "Retained/c");
+    for (size_t i = 1; i < n; i++) {
+        printf("%-22s %8llu %11.2f %11.1f %9llu %9llu %11.1f\n", s[i].name, (unsigned long long)s[i].calls,
+               per_call(s[i].allocs, s[i].calls), per_call(s[i].bytes, s[i].calls),
+               (unsigned long long)s[i].peak, (unsigned long long)s[i].largest,
+               s[i].calls ? (double)s[i].retained / s[i].calls : 0.0);
+    }
+    printf("%-22s %8s %11llu %11llu %9llu %9llu\n", "other (total)", "-", (unsigned long long)s[0].allocs,
+           (unsigned long long)s[0].bytes, (unsigned long long)s[0].peak, (unsigned long long)s[0].largest);
+}
+
+static int write_json(const char *path, const bench_opts_t *opt, const alloc_track_stage_t *s, size_t n) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    // One stage per line; read back by load_baseline
+    fprintf(f, "{\n  \"messages\": %zu,\n  \"seed\": %llu,\n  \"stages\": [\n", opt->messages,
+            (unsigned long long)opt->seed);
+    for (size_t i = 1; i < n; i++) {
+        fprintf(f,
+                "    {\"stage\": \"%s\", \"calls\": %llu, \"allocs_per_call\": %.4f, \"bytes_per_call\": %.2f, "
+                "\"peak\": %llu, \"largest\": %llu, \"retained_per_call\": %.2f}%s\n",
+                s[i].name, (unsigned long long)s[i].calls, per_call(s[i].allocs, s[i].calls),
+                per_call(s[i].bytes, s[i].calls), (unsigned long long)s[i].peak,
+                (unsigned long long)s[i].largest, s[i].calls ? (double)s[i].retained / s[i].calls : 0.0,
+                i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f);
+}
+
+static int json_number(const char *line, const char *key, double *out) {
+    char quoted[48];
+    snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+    const char *p = strstr(line, quoted);
+    if (!p) return -1;
+    *out = strtod(p + strlen(quoted), NULL);
+    return 0;
+}
+
+// Lazy and one-time allocations make the per-call figures depend on the
+// run length, so a baseline is only compared with a run of the same size
+static int load_baseline(const char *path, baseline_t *b) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[512];
+    b->messages = b->seed = -1.0;
+    b->count = 0;
+    while (fgets(line, sizeof(line), f) && b->count < MAX_STAGES) {
+        if (b->messages < 0.0) json_number(line, "messages", &b->messages);
+        if (b->seed < 0.0) json_number(line, "seed", &b->seed);
+        const char *p = strstr(line, "\"stage\": \"");
+        if (!p) continue;
+        p += strlen("\"stage\": \"");
+        const char *end = strchr(p, '"');
+        if (!end || end - p >= STAGE_NAME_MAX) continue;
+        baseline_row_t *r = &b->rows[b->count];
+        memcpy(r->name, p, (size_t)(end - p));
+        r->name[end - p] = '\0';
+        if (json_number(line, "calls", &r->calls) || json_number(line, "allocs_per_call", &r->allocs) ||
+            json_number(line, "bytes_per_call", &r->bytes) || json_number(line, "peak", &r->peak) ||
+            json_number(line, "retained_per_call", &r->retained))
+            continue;
+        b->count++;
+    }
+    fclose(f);
+    if (b->messages < 1.0 || b->seed < 0.0 || !b->count) {
+        fprintf(stderr, "%s: not an alloc_bench --json file\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+static int exceeds(const char *stage, const char *what, double now, double base, double tol, double slack) {
+    double limit = base * (1.0 + tol) + slack;
+    if (now <= limit) return 0;
+    printf("REGRESSION %-22s %-16s %.2f (baseline %.2f, limit %.2f)\n", stage, what, now, base, limit);
+    return 1;
+}
+
+static int compare(const bench_opts_t *opt, const baseline_t *b, const alloc_track_stage_t *s, size_t n) {
+    const baseline_row_t *rows = b->rows;
+    int regressions = 0;
+    for (int r = 0; r < b->count; r++) {
+        size_t i = 1;
+        while (i < n && strcmp(s[i].name, rows[r].name)) i++;
+        if (i == n) {
+            printf("missing    %-22s not run in this build\n", rows[r].name);
+            continue;
+        }
+        double calls = (double)s[i].calls;
+        // Allocation counts get no absolute slack: one extra malloc per message is a regression
+        regressions += exceeds(s[i].name, "allocs/call", per_call(s[i].allocs, s[i].calls), rows[r].allocs,
+                               opt->tolerance, 0.0);
+        regressions += exceeds(s[i].name, "bytes/call", per_call(s[i].bytes, s[i].calls), rows[r].bytes,
+                               opt->tolerance, opt->slack_bytes);
+        regressions += exceeds(s[i].name, "peak", (double)s[i].peak, rows[r].peak, opt->tolerance,
+                               opt->slack_bytes);
+        regressions += exceeds(s[i].name, "retained/call", calls ? (double)s[i].retained / calls : 0.0,
+                               rows[r].retained, opt->tolerance, opt->slack_bytes);
+    }
+    printf("%d regression%s against %s (tolerance %.0f%%, slack %.0f B)\n", regressions,
+           regressions == 1 ? "" : "s", opt->baseline_path, 100.0 * opt->tolerance, opt->slack_bytes);
+    return regressions;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --messages N     records through every stage (default 2000)\n"
+            "  --seed N         generator seed (default 1)\n"
+            "  --json FILE      write the per-stage figures (a baseline)\n"
+            "  --baseline FILE  compare with a --json file, exit 1 on a regression\n"
+            "                   (runs with the baseline's messages and seed)\n"
+            "  --tolerance PCT  allowed growth over the baseline (default 10)\n"
+            "  --slack BYTES    absolute allowance on byte figures (default 64)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_opts_t opt = { 2000, 1, NULL, NULL, 0.10, 64.0 };
+    int sized = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--messages")) opt.messages = (size_t)atol(v), sized = 1;
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10), sized = 1;
+        else if (!strcmp(a, "--json")) opt.json_path = v;
+        else if (!strcmp(a, "--baseline")) opt.baseline_path = v;
+        else if (!strcmp(a, "--tolerance")) opt.tolerance = atof(v) / 100.0;
+        else if (!strcmp(a, "--slack")) opt.slack_bytes = atof(v);
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.messages == 0 || opt.tolerance < 0.0 || opt.slack_bytes < 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!alloc_track_hooked()) {
+        fprintf(stderr, "built without allocator hooks: add -DALLOC_TRACK_MALLOC_HOOKS\n");
+        return 2;
+    }
+    static baseline_t baseline;
+    if (opt.baseline_path) {
+        if (load_baseline(opt.baseline_path, &baseline)) return 2;
+        if (sized && ((double)opt.messages != baseline.messages || (double)opt.seed != baseline.seed)) {
+            fprintf(stderr, "%s was recorded with --messages %.0f --seed %.0f\n", opt.baseline_path,
+                    baseline.messages, baseline.seed);
+            return 2;
+        }
+        opt.messages = (size_t)baseline.messages;
+        opt.seed = (uint64_t)baseline.seed;
+    }
+
+    // The rANS decoder tables are built once per process, not per message
+    int st_init = stage_id("%s", "decode:rans-tables");
+    alloc_track_enter(st_init);
+    int rc = record_rans_decoder_init();
+    alloc_track_leave();
+    if (rc) {
+        fprintf(stderr, "rANS decoder init failed\n");
+        return 1;
+    }
+
+    printf("Allocation benchmark: %zu messages, seed %llu\n\n", opt.messages, (unsigned long long)opt.seed);
+    size_t failures = run(&opt);
+
+    alloc_track_stage_t stages[MAX_STAGES];
+    size_t n = alloc_track_snapshot(stages, MAX_STAGES);
+    if (n > MAX_STAGES) n = MAX_STAGES;
+    print_table(stages, n);
+    printf("\nPeak: heap above the level at stage entry. Retained: held when the stage left.\n");
+
+    int status = 0;
+    if (failures) {
+        fprintf(stderr, "%zu messages failed to encode or round-trip\n", failures);
+        status = 1;
+    }
+    if (opt.json_path && write_json(opt.json_path, &opt, stages, n)) status = 1;
+    if (opt.baseline_path) {
+        printf("\n");
+        int regressions = compare(&opt, &baseline, stages, n);
+        if (regressions) status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,489 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Saturation-point search for the /container-data receivers.
+//
+// For every receiver and codec, finds the highest offered rate that still
+// meets the latency SLO (corrected p99 and p99.9, common/http_load.h) and
+// the error budget. The offered rate doubles from --start until a step
+// fails, then bisects between the last pass and the first failure until
+// they are within --precision. A step also fails when the receiver's
+// /health queues grow by more than --max-queue of the step's requests: the
+// Node receivers acknowledge before processing, so a fast 200 can hide a
+// queue that never drains. Queues are drained between steps.
+// Replaces reading the IncrementalLoadTest charts by eye.
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arrival.h"
+#include "container_codecs.h"
+#include "container_record.h"
+#include "http_load.h"
+#include "payload_corpus.h"
+
+#define MAX_TARGETS 16
+#define MAX_STEPS 64
+
+typedef struct {
+    char label[768];
+    char host[256];
+    uint16_t port;
+    char path[256];
+    container_codec_t codecs[CONTAINER_CODEC_COUNT];
+    int codec_count;
+} target_t;
+
+typedef struct {
+    double rate;
+    int pass;
+    const char *reason;                   // why it failed
+    double achieved;
+    double p50_ms, p99_ms, p999_ms, max_ms;
+    double error_rate;
+    long long queue_growth;               // -1 without a health endpoint
+} step_t;
+
+typedef struct {
+    const target_t *target;
+    container_codec_t codec;
+    double payload_mean;
+    step_t steps[MAX_STEPS];
+    int step_count;
+    const step_t *best;                   // highest passing step
+    const step_t *limit;                  // lowest failing step
+    int confirmed;                        // -1 not run
+} search_t;
+
+typedef struct {
+    target_t targets[MAX_TARGETS];
+    int target_count;
+    container_codec_t codecs[CONTAINER_CODEC_COUNT];
+    int codec_count;
+    double p99_ms, p999_ms, error_budget;
+    double start, max_rate, precision;
+    int max_steps;
+    double step_s, warmup_s, cooldown_s;
+    const char *health;
+    double max_queue, drain_timeout_s;
+    arrival_model_t arrivals;
+    unsigned threads, connections;
+    double timeout_s;
+    size_t records;
+    uint64_t seed;
+    const char *corpus_dir;
+    int confirm;
+    const char *json;
+    const char *markdown;
+} search_opts_t;
+
+static int parse_codecs(const char *list, container_codec_t *out, int *count) {
+    *count = 0;
+    if (!strcmp(list, "all")) {
+        for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) out[(*count)++] = (container_codec_t)c;
+        return 0;
+    }
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (*count == CONTAINER_CODEC_COUNT || container_codec_parse(tok, &out[*count]) != 0) return -1;
+        (*count)++;
+    }
+    return *count ? 0 : -1;
+}
+
+// [LABEL=]URL[@codec,...]
+static int parse_target(const char *spec, target_t *t) {
+    char buf[768];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    char *url = buf, *eq = strchr(buf, '=');
+    if (eq && eq < strstr(buf, "://")) {
+        *eq = '\0';
+        url = eq + 1;
+        snprintf(t->label, sizeof(t->label), "%s", buf);
+    }
+    char *at = strrchr(url, '@');
+    if (at) {
+        *at = '\0';
+        if (parse_codecs(at + 1, t->codecs, &t->codec_count) != 0) return -1;
+    }
+    if (http_load_parse_url(url, t->host, sizeof(t->host), &t->port, t->path, sizeof(t->path)) != 0) return -1;
+    if (!t->label[0]) snprintf(t->label, sizeof(t->label), "%s:%u%s", t->host, t->port, t->path);
+    return 0;
+}
+
+// ================= RECEIVER QUEUES =================
+// Sum of every "queueSize" in the health JSON (inbound and outbound), -1
+// when there is no health endpoint
+static long long health_queue(const target_t *t, const char *path) {
+    if (!path) return -1;
+    char body[65536];
+    if (http_load_get(t->host, t->port, path, 2.0, body, sizeof(body)) != 200) return -1;
+    long long total = 0;
+    int found = 0;
+    for (const char *p = strstr(body, "\"queueSize\""); p; p = strstr(p + 1, "\"queueSize\"")) {
+        const char *colon = strchr(p, ':');
+        if (colon) {
+            total += strtoll(colon + 1, NULL, 10);
+            found = 1;
+        }
+    }
+    return found ? total : -1;
+}
+
+static void drain(const target_t *t, const search_opts_t *opt) {
+    for (double waited = 0.0; waited < opt->drain_timeout_s; waited += 0.5) {
+        long long q = health_queue(t, opt->health);
+        if (q <= 0) break;
+        usleep(500000);
+    }
+    if (opt->cooldown_s > 0.0) usleep((useconds_t)(opt->cooldown_s * 1e6));
+}
+
+// ================= PAYLOADS =================
+static http_load_request_t *build_requests(const target_t *t, container_codec_t codec, const search_opts_t *opt,
+                                           size_t *count, double *payload_mean) {
+    payload_corpus_t corpus = { 0 };
+    int use_corpus = 0;
+    if (opt->corpus_dir) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s.corpus", opt->corpus_dir, container_codec_name(codec));
+        use_corpus = payload_corpus_open(&corpus, path) == 0;
+        if (!use_corpus) fprintf(stderr, "%s: %s, generating payloads instead\n", path, strerror(errno));
+    }
+    size_t n = use_corpus && corpus.count < opt->records ? corpus.count : opt->records;
+    http_load_request_t *requests = calloc(n, sizeof(*requests));
+    if (!requests) return NULL;
+
+    char host_header[300];
+    snprintf(host_header, sizeof(host_header), "%s:%u", t->host, t->port);
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt->seed, time(NULL), 3600);
+    size_t total = 0;
+    for (size_t r = 0; r < n; r++) {
+        uint8_t generated[CONTAINER_CODEC_MAX_PAYLOAD];
+        const uint8_t *payload = generated;
+        size_t len;
+        if (use_corpus) {
+            uint32_t l;
+            payload = payload_corpus_get(&corpus, (uint32_t)r, &l);
+            len = l;
+        } else {
+            container_record_t rec;
+            container_record_generate(&gen, &rec);
+            len = container_codec_encode(codec, &rec, generated, sizeof(generated));
+        }
+        if (!len || http_load_render_post(&requests[r], host_header, t->path, "application/octet-stream", NULL,
+                                          payload, len) != 0) {
+            for (size_t i = 0; i < r; i++) http_load_free_request(&requests[i]);
+            free(requests);
+            payload_corpus_close(&corpus);
+            return NULL;
+        }
+        total += len;
+    }
+    payload_corpus_close(&corpus);
+    *count = n;
+    *payload_mean = (double)total / n;
+    return requests;
+}
+
+// ================= SEARCH =================
+static int run_step(const target_t *t, const search_opts_t *opt, const http_load_request_t *requests, size_t count,
+                    double rate, step_t *step) {
+    arrival_spec_t spec;
+    arrival_spec_defaults(&spec);
+    spec.model = opt->arrivals;
+    spec.fleet = rate * spec.period_s;
+    spec.seed = opt->seed;
+
+    long long q0 = health_queue(t, opt->health);
+    http_load_config_t cfg = {
+        .host = t->host, .port = t->port, .rate = rate, .arrivals = &spec, .duration_s = opt->step_s,
+        .warmup_s = opt->warmup_s, .threads = opt->threads, .connections = opt->connections,
+        .timeout_s = opt->timeout_s, .max_backlog = (size_t)(rate * (opt->step_s + opt->warmup_s)) + 1024,
+        .requests = requests, .request_count = count
+    };
+    http_load_result_t res;
+    if (http_load_run(&cfg, &res) != 0) return -1;
+    long long q1 = q0 >= 0 ? health_queue(t, opt->health) : -1;
+
+    memset(step, 0, sizeof(*step));
+    step->rate = rate;
+    step->achieved = res.status_2xx / res.elapsed_s;
+    step->p50_ms = hdr_value_at_percentile(&res.corrected, 50.0) / 1000.0;
+    step->p99_ms = hdr_value_at_percentile(&res.corrected, 99.0) / 1000.0;
+    step->p999_ms = hdr_value_at_percentile(&res.corrected, 99.9) / 1000.0;
+    step->max_ms = res.corrected.max / 1000.0;
+    step->error_rate = res.scheduled ? (double)(res.scheduled - res.status_2xx) / res.scheduled : 1.0;
+    step->queue_growth = q0 >= 0 && q1 >= 0 ? q1 - q0 : -1;
+    http_load_result_free(&res);
+
+    // Unanswered and failed requests do not reach the histogram, so the
+    // error budget is checked first
+    step->pass = 1;
+    if (step->error_rate > opt->error_budget) step->reason = "errors";
+    else if (step->p99_ms > opt->p99_ms) step->reason = "p99";
+    else if (step->p999_ms > opt->p999_ms) step->reason = "p99.9";
+    else if (step->queue_growth > opt->max_queue * rate * (opt->step_s + opt->warmup_s)) step->reason = "queue";
+    if (step->reason) step->pass = 0;
+    return 0;
+}
+
+static void print_step(int n, const step_t *s) {
+    printf("  step %2d %10.0f req/s  p50 %8.2f  p99 %8.2f  p99.9 %8.2f ms  err %6.3f%%  queue %7lld  %s%s%s\n", n,
+           s->rate, s->p50_ms, s->p99_ms, s->p999_ms, 100.0 * s->error_rate, s->queue_growth,
+           s->pass ? "PASS" : "FAIL", s->pass ? "" : " ", s->pass ? "" : s->reason);
+    fflush(stdout);
+}
+
+static int search(search_t *sr, const search_opts_t *opt) {
+    size_t count;
+    http_load_request_t *requests = build_requests(sr->target, sr->codec, opt, &count, &sr->payload_mean);
+    if (!requests) return -1;
+    printf("\n%s, %s (%.1f bytes mean)\n", sr->target->label, container_codec_name(sr->codec), sr->payload_mean);
+
+    double lo = 0.0, hi = 0.0, rate = opt->start;
+    int rc = 0;
+    sr->confirmed = -1;
+    while (sr->step_count < opt->max_steps) {
+        step_t *s = &sr->steps[sr->step_count];
+        if (run_step(sr->target, opt, requests, count, rate, s) != 0) {
+            rc = -1;
+            break;
+        }
+        print_step(++sr->step_count, s);
+        drain(sr->target, opt);
+        if (s->pass) {
+            lo = rate;
+            sr->best = s;
+        } else {
+            hi = rate;
+            sr->limit = s;
+        }
+
+        // Ramp until the first failure, then bisect (halve while nothing passed)
+        if (hi == 0.0) {
+            if (rate >= opt->max_rate) break;
+            rate = fmin(rate * 2.0, opt->max_rate);
+        } else if (lo == 0.0) {
+            if (hi < 2.0) break;
+            rate = hi / 2.0;
+        } else if (hi - lo > opt->precision * lo) {
+            rate = (lo + hi) / 2.0;
+        } else {
+            break;
+        }
+    }
+
+    // Repeat the capacity step once; receivers are noisy near saturation
+    if (rc == 0 && opt->confirm && sr->best && sr->step_count < MAX_STEPS) {
+        step_t *s = &sr->steps[sr->step_count];
+        if (run_step(sr->target, opt, requests, count, sr->best->rate, s) == 0) {
+            printf("  confirm");
+            print_step(++sr->step_count, s);
+            drain(sr->target, opt);
+            sr->confirmed = s->pass;
+        }
+    }
+    for (size_t r = 0; r < count; r++) http_load_free_request(&requests[r]);
+    free(requests);
+    return rc;
+}
+
+// ================= REPORT =================
+static void report(FILE *f, const search_t *results, int n, const search_opts_t *opt, int markdown) {
+    const char *fmt_head = markdown ? "| %s | %s | %s | %s | %s | %s | %s | %s |\n" : "%-34s %-12s %10s %9s %9s %8s %-10s %s\n";
+    const char *fmt_row = markdown ? "| %s | %s | %s | %s | %s | %s | %s | %d |\n" : "%-34s %-12s %10s %9s %9s %8s %-10s %d\n";
+    fprintf(f, "%sCapacity report: p99 <= %.1f ms, p99.9 <= %.1f ms, errors <= %.2f %%, %s arrivals, %.0f s steps\n\n",
+            markdown ? "## " : "\n", opt->p99_ms, opt->p999_ms, 100.0 * opt->error_budget,
+            arrival_model_name(opt->arrivals), opt->step_s);
+    fprintf(f, fmt_head, "Target", "Codec", "req/s", "p99 ms", "p99.9 ms", "Errors", "Limit", "Steps");
+    if (markdown) fprintf(f, "|---|---|---|---|---|---|---|---|\n");
+    for (int i = 0; i < n; i++) {
+        const search_t *r = &results[i];
+        char cap[32] = "–", p99[16] = "–", p999[16] = "–", err[16] = "–", limit[48];
+        if (r->best) {
+            snprintf(cap, sizeof(cap), "%.0f%s", r->best->rate, r->confirmed == 0 ? "?" : "");
+            snprintf(p99, sizeof(p99), "%.2f", r->best->p99_ms);
+            snprintf(p999, sizeof(p999), "%.2f", r->best->p999_ms);
+            snprintf(err, sizeof(err), "%.3f%%", 100.0 * r->best->error_rate);
+        }
+        if (r->limit) snprintf(limit, sizeof(limit), "%s@%.0f", r->limit->reason, r->limit->rate);
+        else snprintf(limit, sizeof(limit), "%s", r->best ? "max-rate" : "–");
+        fprintf(f, fmt_row, r->target->label, container_codec_name(r->codec), cap, p99, p999, err, limit,
+                r->step_count);
+    }
+    if (!markdown) fprintf(f, "\n'?' = the confirmation run at that rate failed\n");
+}
+
+static int write_json(const char *path, const search_t *results, int n, const search_opts_t *opt) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"slo\": { \"p99_ms\": %.3f, \"p999_ms\": %.3f, \"error_budget\": %.6f, \"max_queue\": %.4f },\n",
+            opt->p99_ms, opt->p999_ms, opt->error_budget, opt->max_queue);
+    fprintf(f, "  \"arrivals\": \"%s\",\n  \"step_s\": %.1f,\n  \"results\": [\n", arrival_model_name(opt->arrivals),
+            opt->step_s);
+    for (int i = 0; i < n; i++) {
+        const search_t *r = &results[i];
+        fprintf(f, "    { \"target\": \"%s\", \"url\": \"http://%s:%u%s\", \"codec\": \"%s\", \"payload_mean_bytes\": %.2f,\n",
+                r->target->label, r->target->host, r->target->port, r->target->path, container_codec_name(r->codec),
+                r->payload_mean);
+        fprintf(f, "      \"capacity_rps\": %.1f, \"confirmed\": %s, \"limit\": %s%s%s, \"limit_rps\": %.1f,\n",
+                r->best ? r->best->rate : 0.0, r->confirmed < 0 ? "null" : r->confirmed ? "true" : "false",
+                r->limit ? "\"" : "", r->limit ? r->limit->reason : "null", r->limit ? "\"" : "",
+                r->limit ? r->limit->rate : 0.0);
+        fprintf(f, "      \"steps\": [\n");
+        for (int s = 0; s < r->step_count; s++) {
+            const step_t *st = &r->steps[s];
+            fprintf(f, "        { \"offered_rps\": %.1f, \"achieved_rps\": %.1f, \"p50_ms\": %.3f, \"p99_ms\": %.3f, "
+                       "\"p999_ms\": %.3f, \"max_ms\": %.3f, \"error_rate\": %.6f, \"queue_growth\": %lld, "
+                       "\"pass\": %s%s%s%s }%s\n",
+                    st->rate, st->achieved, st->p50_ms, st->p99_ms, st->p999_ms, st->max_ms, st->error_rate,
+                    st->queue_growth, st->pass ? "true" : "false", st->pass ? "" : ", \"reason\": \"",
+                    st->pass ? "" : st->reason, st->pass ? "" : "\"", s + 1 < r->step_count ? "," : "");
+        }
+        fprintf(f, "      ] }%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s --target [LABEL=]URL[@codec,...] [--target ...] [options]\n"
+            "  --codec LIST        codecs for targets without @ (default struct-zlib; 'all')\n"
+            "  --p99 MS            corrected p99 target (default 50)\n"
+            "  --p999 MS           corrected p99.9 target (default 200)\n"
+            "  --error-budget F    allowed fraction of non-2xx, failed or dropped requests (default 0.001)\n"
+            "  --max-queue F       allowed /health queue growth, fraction of the step's requests (default 0.01)\n"
+            "  --health PATH       health endpoint with queueSize fields (default /health, 'none' to skip)\n"
+            "  --start R           first offered rate (default 200)\n"
+            "  --max-rate R        stop ramping here (default 1000000)\n"
+            "  --precision F       stop when the bracket is within F of the capacity (default 0.05)\n"
+            "  --max-steps N       per target and codec (default 16)\n"
+            "  --step-duration S   measured seconds per step (default 20)\n"
+            "  --warmup S          unrecorded seconds per step (default 5)\n"
+            "  --cooldown S        pause after the queues drained (default 5)\n"
+            "  --drain-timeout S   longest wait for the queues (default 60)\n"
+            "  --arrivals MODEL    uniform, poisson, onoff, diurnal (default poisson)\n"
+            "  --threads N         load threads (default: online CPUs)\n"
+            "  --connections N     keep-alive connections (default 2000)\n"
+            "  --timeout S         per-request timeout (default 5)\n"
+            "  --records N         distinct payloads (default 10000)\n"
+            "  --seed N            generator and arrival seed (default 1)\n"
+            "  --corpus-dir DIR    use DIR/<codec>.corpus from corpus_build\n"
+            "  --no-confirm        skip the repeat run at the capacity\n"
+            "  --json FILE         full report with every step\n"
+            "  --markdown FILE     summary table\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    static search_opts_t opt = { .p99_ms = 50.0, .p999_ms = 200.0, .error_budget = 0.001, .start = 200.0,
+                                 .max_rate = 1e6, .precision = 0.05, .max_steps = 16, .step_s = 20.0,
+                                 .warmup_s = 5.0, .cooldown_s = 5.0, .health = "/health", .max_queue = 0.01,
+                                 .drain_timeout_s = 60.0, .arrivals = ARRIVAL_POISSON, .connections = 2000,
+                                 .timeout_s = 5.0, .records = 10000, .seed = 1, .confirm = 1 };
+    opt.threads = cpus > 0 ? (unsigned)cpus : 1;
+    opt.codecs[0] = CONTAINER_CODEC_STRUCT_ZLIB;
+    opt.codec_count = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (!strcmp(a, "--no-confirm")) { opt.confirm = 0; continue; }
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--target")) {
+            if (opt.target_count == MAX_TARGETS || parse_target(v, &opt.targets[opt.target_count]) != 0) {
+                fprintf(stderr, "bad target: %s\n", v);
+                return 2;
+            }
+            opt.target_count++;
+        } else if (!strcmp(a, "--codec")) {
+            if (parse_codecs(v, opt.codecs, &opt.codec_count) != 0) { fprintf(stderr, "bad codec list: %s\n", v); return 2; }
+        } else if (!strcmp(a, "--arrivals")) {
+            if (arrival_model_parse(v, &opt.arrivals) != 0 || opt.arrivals == ARRIVAL_TRACE) {
+                fprintf(stderr, "unsupported arrival model: %s\n", v);
+                return 2;
+            }
+        }
+        else if (!strcmp(a, "--p99")) opt.p99_ms = atof(v);
+        else if (!strcmp(a, "--p999")) opt.p999_ms = atof(v);
+        else if (!strcmp(a, "--error-budget")) opt.error_budget = atof(v);
+        else if (!strcmp(a, "--max-queue")) opt.max_queue = atof(v);
+        else if (!strcmp(a, "--health")) opt.health = strcmp(v, "none") ? v : NULL;
+        else if (!strcmp(a, "--start")) opt.start = atof(v);
+        else if (!strcmp(a, "--max-rate")) opt.max_rate = atof(v);
+        else if (!strcmp(a, "--precision")) opt.precision = atof(v);
+        else if (!strcmp(a, "--max-steps")) opt.max_steps = atoi(v);
+        else if (!strcmp(a, "--step-duration")) opt.step_s = atof(v);
+        else if (!strcmp(a, "--warmup")) opt.warmup_s = atof(v);
+        else if (!strcmp(a, "--cooldown")) opt.cooldown_s = atof(v);
+        else if (!strcmp(a, "--drain-timeout")) opt.drain_timeout_s = atof(v);
+        else if (!strcmp(a, "--threads")) opt.threads = (unsigned)atoi(v);
+        else if (!strcmp(a, "--connections")) opt.connections = (unsigned)atoi(v);
+        else if (!strcmp(a, "--timeout")) opt.timeout_s = atof(v);
+        else if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--corpus-dir")) opt.corpus_dir = v;
+        else if (!strcmp(a, "--json")) opt.json = v;
+        else if (!strcmp(a, "--markdown")) opt.markdown = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.target_count == 0 || opt.start <= 0.0 || opt.step_s <= 0.0 || opt.precision <= 0.0 ||
+        opt.records == 0 || opt.threads == 0 || opt.max_steps < 1 || opt.max_steps >= MAX_STEPS) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.connections < opt.threads) opt.connections = opt.threads;
+    http_load_raise_fd_limit();
+
+    static search_t results[MAX_TARGETS * CONTAINER_CODEC_COUNT];
+    int n = 0, rc = 0;
+    for (int t = 0; t < opt.target_count; t++) {
+        target_t *target = &opt.targets[t];
+        if (target->codec_count == 0) {
+            memcpy(target->codecs, opt.codecs, sizeof(opt.codecs));
+            target->codec_count = opt.codec_count;
+        }
+        for (int c = 0; c < target->codec_count; c++) {
+            search_t *sr = &results[n++];
+            sr->target = target;
+            sr->codec = target->codecs[c];
+            if (search(sr, &opt) != 0) {
+                fprintf(stderr, "%s: load run failed (address or setup)\n", target->label);
+                rc = 1;
+            }
+        }
+    }
+
+    report(stdout, results, n, &opt, 0);
+    if (opt.json && write_json(opt.json, results, n, &opt) != 0) rc = 1;
+    if (opt.markdown) {
+        FILE *f = fopen(opt.markdown, "w");
+        if (!f) {
+            perror(opt.markdown);
+            rc = 1;
+        } else {
+            report(f, results, n, &opt, 1);
+            fclose(f);
+        }
+    }
+    return rc;
+}
@@ -0,0 +1,182 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Builds pre-encoded payload corpora (common/payload_corpus.h) for the
+// load tools.
+//
+// Records come from container_record_generate() with a fixed seed and
+// time base, so the same arguments always produce the same bytes, and
+// every codec's corpus encodes the same record sequence (unless --max-size
+// rejects some of them, as the senders do for the 158-byte limit).
+// loadgen --corpus and the locust senders (LOCUST_CORPUS) map the result.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "payload_corpus.h"
+
+#define DEFAULT_TIME_BASE 1735689600  // 2025-01-01 00:00:00 UTC
+
+typedef struct {
+    size_t records;
+    uint64_t seed;
+    int64_t time_base;
+    size_t max_size;
+    const char *out;
+} build_opts_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int build(container_codec_t codec, const build_opts_t *opt, const char *path) {
+    double t0 = now_s();
+    size_t cap = opt->records * 128 + CONTAINER_CODEC_MAX_PAYLOAD;
+    uint8_t *data = malloc(cap);
+    uint32_t *lens = malloc(opt->records * sizeof(uint32_t));
+    if (!data || !lens) {
+        free(data);
+        free(lens);
+        return -1;
+    }
+
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt->seed, (time_t)opt->time_base, 3600);
+    size_t count = 0, rejected = 0, total = 0, min_len = SIZE_MAX, max_len = 0;
+    while (count < opt->records) {
+        container_record_t rec;
+        container_record_generate(&gen, &rec);
+        if (total + CONTAINER_CODEC_MAX_PAYLOAD > cap) {
+            uint8_t *grown = realloc(data, cap * 2);
+            if (!grown) break;
+            data = grown;
+            cap *= 2;
+        }
+        size_t n = container_codec_encode(codec, &rec, data + total, CONTAINER_CODEC_MAX_PAYLOAD);
+        if (n == 0) {
+            free(data);
+            free(lens);
+            return -1;
+        }
+        // Same rule as the senders: reject size >= limit
+        if (opt->max_size && n >= opt->max_size) {
+            if (++rejected > opt->records * 100) break;
+            continue;
+        }
+        lens[count++] = (uint32_t)n;
+        total += n;
+        if (n < min_len) min_len = n;
+        if (n > max_len) max_len = n;
+    }
+
+    int rc = count == opt->records ? payload_corpus_write(path, container_codec_name(codec), opt->seed,
+                                                          opt->time_base, data, lens, (uint32_t)count)
+                                   : -1;
+    if (rc == 0) {
+        struct stat st;
+        stat(path, &st);
+        printf("%-12s %8zu %8zu %8.1f %6zu %6zu %10lld %8.2f  %s\n", container_codec_name(codec), count, rejected,
+               (double)total / count, min_len, max_len, (long long)st.st_size, now_s() - t0, path);
+    } else if (count < opt->records) {
+        fprintf(stderr, "%s: too few records under --max-size %zu\n", container_codec_name(codec), opt->max_size);
+    } else {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    }
+    free(data);
+    free(lens);
+    return rc;
+}
+
+static int info(const char *path) {
+    payload_corpus_t c;
+    if (payload_corpus_open(&c, path) != 0) {
+        fprintf(stderr, "%s: %s\n", path, errno == EINVAL ? "not a valid corpus (header, bounds or CRC)" : strerror(errno));
+        return 1;
+    }
+    time_t tb = (time_t)c.time_base;
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", gmtime(&tb));
+    printf("Corpus:     %s\n", path);
+    printf("Codec:      %s\n", c.codec);
+    printf("Records:    %u\n", c.count);
+    printf("Payloads:   %llu bytes, mean %.1f, max %u\n", (unsigned long long)c.payload_bytes,
+           (double)c.payload_bytes / c.count, c.max_payload);
+    printf("Generator:  seed %llu, time base %s UTC\n", (unsigned long long)c.seed, when);
+    printf("File:       %zu bytes, CRC OK\n", c.map_len);
+    payload_corpus_close(&c);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s --codec NAME|all [options]\n"
+            "       %s --info FILE\n"
+            "  --codec NAME        cbor, msgpack, protobuf, struct-zlib, struct-rans, or all\n"
+            "  --records N         payloads (default 10000)\n"
+            "  --seed N            generator seed (default 1)\n"
+            "  --time-base T       generator time base, unix seconds (default 2025-01-01)\n"
+            "  --max-size N        reject payloads of N bytes or more (default: no limit)\n"
+            "  --out PATH          output file (default <codec>.corpus); a directory with --codec all\n",
+            prog, prog);
+}
+
+int main(int argc, char **argv) {
+    build_opts_t opt = { .records = 10000, .seed = 1, .time_base = DEFAULT_TIME_BASE };
+    const char *codec_name = NULL;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--info")) return info(v);
+        else if (!strcmp(a, "--codec")) codec_name = v;
+        else if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--time-base")) opt.time_base = atoll(v);
+        else if (!strcmp(a, "--max-size")) opt.max_size = (size_t)atol(v);
+        else if (!strcmp(a, "--out")) opt.out = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (!codec_name || opt.records == 0 || opt.records > UINT32_MAX / 8) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int all = !strcmp(codec_name, "all");
+    container_codec_t codec = CONTAINER_CODEC_CBOR;
+    if (!all && container_codec_parse(codec_name, &codec) != 0) {
+        fprintf(stderr, "unknown codec: %s\n", codec_name);
+        return 2;
+    }
+    if (all && opt.out && mkdir(opt.out, 0755) != 0 && errno != EEXIST) {
+        perror(opt.out);
+        return 1;
+    }
+
+    printf("%-12s %8s %8s %8s %6s %6s %10s %8s  %s\n", "Codec", "Records", "Rejected", "Mean", "Min", "Max",
+           "File", "Build s", "Path");
+    int rc = 0;
+    for (int c = all ? 0 : (int)codec; c < (all ? CONTAINER_CODEC_COUNT : (int)codec + 1); c++) {
+        char path[4096];
+        if (all || !opt.out) {
+            snprintf(path, sizeof(path), "%s%s%s.corpus", all && opt.out ? opt.out : "", all && opt.out ? "/" : "",
+                     container_codec_name((container_codec_t)c));
+        } else {
+            snprintf(path, sizeof(path), "%s", opt.out);
+        }
+        if (build((container_codec_t)c, &opt, path) != 0) rc = 1;
+    }
+    return rc;
+}
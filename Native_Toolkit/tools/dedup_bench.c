@@ -0,0 +1,284 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Duplicate filter benchmark (common/dedup_filter.h).
+//
+// 1. Lookup cost: ns per lookup of absent and present keys, and per
+//    dedup_check, with both generations full.
+// 2. Fingerprint collisions: absent keys that match a fingerprint, and
+//    how many of them the exact cache keeps from being dropped.
+// 3. Retries: every device sends a trace record each interval; a send
+//    is retried (device timeout, Astrocast callback retry, HTTP client
+//    retry) with probability --retry, possibly more than once, after an
+//    exponential delay. Payloads are encoded with --codec and keyed by
+//    (device, payload hash). The table counts duplicates caught, copies
+//    let through (older than the window or evicted) and originals dropped
+//    by mistake.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "dedup_filter.h"
+
+typedef struct {
+    size_t devices;
+    double interval_s;
+    double duration_s;
+    double retry;
+    double retry_delay_s;
+    container_codec_t codec;
+    double window_s;
+    size_t per_device;                    // filter keys per device and window
+    size_t confirm;                       // exact cache entries, 0 = two per filter key
+    int strict;
+    uint64_t seed;
+} bench_opts_t;
+
+typedef struct {
+    double t;
+    uint64_t key;
+    uint32_t msg;
+    uint8_t copy;                         // 0 = original
+} event_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s << 13;
+    *s ^= *s >> 7;
+    *s ^= *s << 17;
+    return *s;
+}
+
+static double rng_unit(uint64_t *s) {
+    return (rng_next(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int cmp_event(const void *a, const void *b) {
+    const event_t *x = a, *y = b;
+    return (x->t > y->t) - (x->t < y->t);
+}
+
+static void filter_config(const bench_opts_t *opt, dedup_config_t *cfg) {
+    cfg->capacity = opt->devices * opt->per_device;
+    cfg->window_s = opt->window_s;
+    cfg->confirm_entries = opt->confirm ? opt->confirm : 2 * cfg->capacity;
+    cfg->drop_unconfirmed = opt->strict;
+}
+
+// ================= LOOKUP COST =================
+static int run_cost(const bench_opts_t *opt) {
+    dedup_config_t cfg;
+    filter_config(opt, &cfg);
+    dedup_filter_t f;
+    if (dedup_init(&f, &cfg)) return -1;
+
+    size_t n = cfg.capacity;
+    uint64_t *keys = malloc(n * sizeof(*keys)), rng = opt->seed * 0x9E3779B97F4A7C15ull | 1;
+    if (!keys) {
+        dedup_free(&f);
+        return -1;
+    }
+    // Fill the older generation, rotate, fill the current one
+    for (size_t i = 0; i < n; i++) dedup_insert(&f, rng_next(&rng), 0.0);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = rng_next(&rng);
+        dedup_insert(&f, keys[i], opt->window_s);
+    }
+    double t = opt->window_s;
+
+    size_t rounds = n < 1000000 ? 1000000 / n + 1 : 1;
+    volatile size_t sink = 0;
+    double t0 = now_s();
+    for (size_t r = 0; r < rounds; r++)
+        for (size_t i = 0; i < n; i++) sink += dedup_lookup(&f, keys[i], t);
+    double present_ns = 1e9 * (now_s() - t0) / (rounds * n);
+
+    dedup_stats_t before = f.stats;
+    size_t absent = rounds * n;
+    t0 = now_s();
+    for (size_t i = 0; i < absent; i++) sink += dedup_lookup(&f, rng_next(&rng), t);
+    double absent_ns = 1e9 * (now_s() - t0) / absent;
+    uint64_t probable = f.stats.probable - before.probable;
+
+    dedup_filter_t g;
+    if (dedup_init(&g, &cfg)) {
+        free(keys);
+        dedup_free(&f);
+        return -1;
+    }
+    size_t checks = 4 * n;
+    t0 = now_s();
+    for (size_t i = 0; i < checks; i++) sink += dedup_check(&g, keys[i % n], opt->window_s * i / checks);
+    double check_ns = 1e9 * (now_s() - t0) / checks;
+    (void)sink;
+
+    printf("Filter: %zu keys per generation, %.0f s window, %zu B (%.2f B per key), exact cache %zu entries\n",
+           cfg.capacity, cfg.window_s, dedup_memory(&f), (double)dedup_memory(&f) / (2.0 * cfg.capacity),
+           cfg.confirm_entries);
+    printf("  lookup present %.1f ns, absent %.1f ns, check (lookup + insert) %.1f ns\n", present_ns, absent_ns,
+           check_ns);
+    printf("  fingerprint hits on absent keys: %.2e (%llu of %zu), dropped %s\n", (double)probable / absent,
+           (unsigned long long)probable, absent, opt->strict ? "all of them (--strict)" : "none (exact cache)");
+    printf("  %zu bytes per device at %zu keys per device\n\n", dedup_memory(&f) / opt->devices, opt->per_device);
+    free(keys);
+    dedup_free(&f);
+    dedup_free(&g);
+    return 0;
+}
+
+// ================= RETRIES =================
+static int run_retries(const bench_opts_t *opt) {
+    uint64_t rng = opt->seed * 0xD1342543DE82EF95ull | 1;
+    size_t per_device = (size_t)(opt->duration_s / opt->interval_s);
+    size_t cap = opt->devices * per_device * 2 + 16, count = 0;
+    event_t *ev = malloc(cap * sizeof(*ev));
+    if (!ev) return -1;
+
+    uint32_t msg = 0;
+    for (size_t d = 0; d < opt->devices; d++) {
+        container_trace_t trace;
+        container_trace_init(&trace, opt->seed + d, 1735689600, (uint32_t)opt->interval_s);
+        double phase = rng_unit(&rng) * opt->interval_s;
+        uint64_t device = dedup_hash(&d, sizeof(d));
+        for (size_t k = 0; k < per_device; k++, msg++) {
+            container_record_t rec;
+            uint8_t buf[CONTAINER_CODEC_MAX_PAYLOAD];
+            container_trace_next(&trace, &rec);
+            size_t len = container_codec_encode(opt->codec, &rec, buf, sizeof(buf));
+            if (!len) {
+                free(ev);
+                return -1;
+            }
+            uint64_t key = dedup_key(device, dedup_hash(buf, len));
+            double t = phase + k * opt->interval_s;
+            ev[count++] = (event_t){ t, key, msg, 0 };
+            for (uint8_t c = 1; c < 8 && rng_unit(&rng) < opt->retry; c++) {
+                t += -log(1.0 - rng_unit(&rng)) * opt->retry_delay_s;
+                if (count == cap) {
+                    event_t *grown = realloc(ev, 2 * cap * sizeof(*ev));
+                    if (!grown) {
+                        free(ev);
+                        return -1;
+                    }
+                    ev = grown;
+                    cap *= 2;
+                }
+                ev[count++] = (event_t){ t, key, msg, c };
+            }
+        }
+    }
+    qsort(ev, count, sizeof(*ev), cmp_event);
+
+    dedup_config_t cfg;
+    filter_config(opt, &cfg);
+    dedup_filter_t f;
+    if (dedup_init(&f, &cfg)) {
+        free(ev);
+        return -1;
+    }
+    // A copy is expected to be caught when the first delivery of its
+    // message is less than a window old
+    double *first = malloc(msg * sizeof(*first));
+    if (!first) {
+        free(ev);
+        dedup_free(&f);
+        return -1;
+    }
+    for (uint32_t m = 0; m < msg; m++) first[m] = -1.0;
+    size_t copies = 0, caught = 0, in_window = 0, missed_in_window = 0, false_drops = 0;
+    double t0 = now_s();
+    for (size_t i = 0; i < count; i++) {
+        const event_t *e = &ev[i];
+        bool dup = dedup_check(&f, e->key, e->t);
+        bool is_copy = first[e->msg] >= 0.0;
+        if (!is_copy) first[e->msg] = e->t;
+        if (!is_copy && dup) false_drops++;
+        if (!is_copy) continue;
+        copies++;
+        caught += dup;
+        if (e->t - first[e->msg] < opt->window_s) {
+            in_window++;
+            missed_in_window += !dup;
+        }
+    }
+    double dt = now_s() - t0;
+
+    printf("Retries: %zu devices, %.0f s interval, %.0f s, retry %.0f %% after %.0f s mean, %s payloads\n",
+           opt->devices, opt->interval_s, opt->duration_s, 100.0 * opt->retry, opt->retry_delay_s,
+           container_codec_name(opt->codec));
+    printf("  %zu payloads, %zu duplicates: caught %zu (%.2f %%), %zu arrived within the window, %zu of those missed\n",
+           count, copies, caught, copies ? 100.0 * caught / copies : 0.0, in_window, missed_in_window);
+    printf("  originals dropped %zu, rotations %llu (early %llu), %.1f ns per payload\n", false_drops,
+           (unsigned long long)f.stats.rotations, (unsigned long long)f.stats.early_rotations, 1e9 * dt / count);
+    free(first);
+    free(ev);
+    dedup_free(&f);
+    return false_drops && !opt->strict ? 1 : 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --devices N       devices (default 10000)\n"
+            "  --interval S      uplink period, seconds (default 60)\n"
+            "  --duration S      simulated time, seconds (default 3600)\n"
+            "  --retry P         probability that a send is retried, per attempt (default 0.05)\n"
+            "  --retry-delay S   mean retry delay, seconds (default 30)\n"
+            "  --codec NAME      payload codec (default cbor)\n"
+            "  --window S        duplicate window, seconds (default 300)\n"
+            "  --per-device N    filter keys per device and window (default 8)\n"
+            "  --confirm N       exact cache entries (default 2 x capacity, every remembered key)\n"
+            "  --strict 0|1      drop unconfirmed fingerprint hits too (default 0)\n"
+            "  --seed N          trace and retry seed (default 1)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_opts_t opt = { 10000, 60.0, 3600.0, 0.05, 30.0, CONTAINER_CODEC_CBOR, 300.0, 8, 0, 0, 1 };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--devices")) opt.devices = (size_t)atol(v);
+        else if (!strcmp(a, "--interval")) opt.interval_s = atof(v);
+        else if (!strcmp(a, "--duration")) opt.duration_s = atof(v);
+        else if (!strcmp(a, "--retry")) opt.retry = atof(v);
+        else if (!strcmp(a, "--retry-delay")) opt.retry_delay_s = atof(v);
+        else if (!strcmp(a, "--codec")) {
+            if (container_codec_parse(v, &opt.codec)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--window")) opt.window_s = atof(v);
+        else if (!strcmp(a, "--per-device")) opt.per_device = (size_t)atol(v);
+        else if (!strcmp(a, "--confirm")) opt.confirm = (size_t)atol(v);
+        else if (!strcmp(a, "--strict")) opt.strict = atoi(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.devices == 0 || opt.interval_s <= 0.0 || opt.duration_s < opt.interval_s || opt.retry < 0.0 ||
+        opt.retry >= 1.0 || opt.window_s <= 0.0 || opt.per_device == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (run_cost(&opt)) {
+        fprintf(stderr, "cannot allocate the filter\n");
+        return 1;
+    }
+    int rc = run_retries(&opt);
+    if (rc < 0) fprintf(stderr, "cannot build the retry trace\n");
+    else if (rc) fprintf(stderr, "originals were dropped without --strict\n");
+    return rc ? 1 : 0;
+}
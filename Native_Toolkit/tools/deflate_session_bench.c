@@ -0,0 +1,256 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Session-persistent deflate vs. per-message compression.
+//
+// Every simulated device sends a drifting trace (container_record_trace_*)
+// through a lossy link (common/link_loss.h). Stateless back ends (zlib-9,
+// raw deflate, static rANS) lose exactly the dropped frames. Sessions also
+// lose the frames that arrive after a gap until the next keyframe; with
+// --feedback the receiver answers a desync at once (HTTP 409 in the
+// service) and the sender resends the record as a keyframe. Every decoded
+// message is compared with the packed record.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "container_record.h"
+#include "deflate_session.h"
+#include "link_loss.h"
+#include "record_rans.h"
+
+#define FRAME_CAP 256
+
+typedef struct {
+    size_t devices;
+    size_t messages;
+    uint32_t interval_s;
+    uint64_t seed;
+    double loss;
+    double burst;
+    int feedback;
+} bench_opts_t;
+
+typedef struct {
+    size_t sent;                          // frames on air, resends included
+    size_t bytes;
+    size_t key_frames;
+    size_t key_bytes;
+    size_t delivered;                     // records decoded correctly
+    size_t desync_drops;
+    size_t failures;                      // decoded to the wrong record
+    double encode_s;
+} run_result_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// ================= STATELESS BACK ENDS =================
+static size_t zlib_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    uLongf n = cap;
+    return compress2(out, &n, in, len, Z_BEST_COMPRESSION) == Z_OK ? (size_t)n : 0;
+}
+
+static size_t raw_deflate_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK) return 0;
+    z.next_in = (Bytef *)in;
+    z.avail_in = (uInt)len;
+    z.next_out = out;
+    z.avail_out = (uInt)cap;
+    int rc = deflate(&z, Z_FINISH);
+    size_t n = z.total_out;
+    deflateEnd(&z);
+    return rc == Z_STREAM_END ? n : 0;
+}
+
+static size_t rans_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    return record_rans_encode(in, len, out, cap);
+}
+
+typedef size_t (*encode_fn)(const uint8_t *, size_t, uint8_t *, size_t);
+
+static const struct {
+    const char *name;
+    encode_fn encode;
+} stateless[] = {
+    { "zlib-9", zlib_encode },
+    { "deflate-raw", raw_deflate_encode },
+    { "rans-static", rans_encode },
+};
+#define NUM_STATELESS (sizeof(stateless) / sizeof(stateless[0]))
+
+// Keyframe intervals of the session runs (0 = on demand only)
+static const uint16_t session_intervals[] = { 4, 8, 16, 32, 64, 0 };
+#define NUM_SESSIONS (sizeof(session_intervals) / sizeof(session_intervals[0]))
+
+// ================= RUNS =================
+static void run_stateless(const bench_opts_t *opt, encode_fn encode, run_result_t *res) {
+    memset(res, 0, sizeof(*res));
+    for (size_t d = 0; d < opt->devices; d++) {
+        container_trace_t trace;
+        container_trace_init(&trace, opt->seed + d, 1735689600, opt->interval_s);
+        link_loss_t link;
+        link_loss_init_gilbert(&link, opt->loss, opt->burst, opt->seed * 1000 + d);
+
+        for (size_t m = 0; m < opt->messages; m++) {
+            container_record_t rec;
+            uint8_t packed[CONTAINER_RECORD_STRUCT_MAX], frame[FRAME_CAP];
+            container_trace_next(&trace, &rec);
+            size_t len = container_record_pack_struct(&rec, packed, sizeof(packed));
+
+            double t0 = now_s();
+            size_t n = encode(packed, len, frame, sizeof(frame));
+            res->encode_s += now_s() - t0;
+            if (!n) res->failures++;
+            res->sent++;
+            res->bytes += n;
+            res->key_frames++;
+            res->key_bytes += n;
+            if (!link_loss_drop(&link)) res->delivered++;
+        }
+    }
+}
+
+static void run_session(const bench_opts_t *opt, uint16_t keyframe_interval, int feedback, run_result_t *res) {
+    memset(res, 0, sizeof(*res));
+    for (size_t d = 0; d < opt->devices; d++) {
+        container_trace_t trace;
+        container_trace_init(&trace, opt->seed + d, 1735689600, opt->interval_s);
+        link_loss_t link;
+        link_loss_init_gilbert(&link, opt->loss, opt->burst, opt->seed * 1000 + d);
+
+        deflate_session_t tx;
+        inflate_session_t rx;
+        if (deflate_session_init(&tx, Z_BEST_COMPRESSION, keyframe_interval) != DEFLATE_SESSION_OK ||
+            inflate_session_init(&rx) != DEFLATE_SESSION_OK) {
+            res->failures++;
+            return;
+        }
+
+        for (size_t m = 0; m < opt->messages; m++) {
+            container_record_t rec;
+            uint8_t packed[CONTAINER_RECORD_STRUCT_MAX], frame[FRAME_CAP], decoded[FRAME_CAP];
+            container_trace_next(&trace, &rec);
+            size_t len = container_record_pack_struct(&rec, packed, sizeof(packed));
+
+            // At most one resend, triggered by the receiver's desync answer
+            for (int attempt = 0; attempt < 2; attempt++) {
+                double t0 = now_s();
+                int n = deflate_session_compress(&tx, packed, len, frame, sizeof(frame));
+                res->encode_s += now_s() - t0;
+                if (n < 0) {
+                    res->failures++;
+                    break;
+                }
+                res->sent++;
+                res->bytes += (size_t)n;
+                if (frame[0] & DEFLATE_SESSION_FLAG_KEY) {
+                    res->key_frames++;
+                    res->key_bytes += (size_t)n;
+                }
+                if (link_loss_drop(&link)) break;
+
+                int got = inflate_session_decompress(&rx, frame, (size_t)n, decoded, sizeof(decoded));
+                if (got == DEFLATE_SESSION_ERR_DESYNC) {
+                    res->desync_drops++;
+                    if (!feedback) break;
+                    deflate_session_request_keyframe(&tx);
+                    continue;
+                }
+                if (got != (int)len || memcmp(decoded, packed, len) != 0) {
+                    res->failures++;
+                } else {
+                    res->delivered++;
+                }
+                break;
+            }
+        }
+        deflate_session_end(&tx);
+        inflate_session_end(&rx);
+    }
+}
+
+static void print_row(const char *name, const bench_opts_t *opt, const run_result_t *res) {
+    size_t records = opt->devices * opt->messages;
+    size_t delta_frames = res->sent - res->key_frames;
+    printf("%-16s %7.1f %7.1f %7.1f %9.2f%% %8zu %9.0f\n", name, (double)res->bytes / records,
+           res->key_frames ? (double)res->key_bytes / res->key_frames : 0.0,
+           delta_frames ? (double)(res->bytes - res->key_bytes) / delta_frames : 0.0,
+           100.0 * res->delivered / records, res->desync_drops, 1e9 * res->encode_s / res->sent);
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --devices N     simulated devices (default 20)\n"
+            "  --messages N    messages per device (default 500)\n"
+            "  --interval S    uplink period, seconds (default 300)\n"
+            "  --seed N        trace and loss seed (default 1)\n"
+            "  --loss P        frame loss rate (default 0.05)\n"
+            "  --burst N       mean loss burst length, 1 = independent (default 1)\n"
+            "  --feedback 0|1  receiver answers a desync, sender resends as keyframe (default 0)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_opts_t opt = { 20, 500, 300, 1, 0.05, 1.0, 0 };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--devices")) opt.devices = (size_t)atol(v);
+        else if (!strcmp(a, "--messages")) opt.messages = (size_t)atol(v);
+        else if (!strcmp(a, "--interval")) opt.interval_s = (uint32_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--loss")) opt.loss = atof(v);
+        else if (!strcmp(a, "--burst")) opt.burst = atof(v);
+        else if (!strcmp(a, "--feedback")) opt.feedback = atoi(v);
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.devices == 0 || opt.messages == 0 || opt.loss < 0.0 || opt.loss >= 1.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    printf("Session deflate benchmark: %zu devices x %zu messages, %u s period, loss %.1f%% "
+           "(burst %.1f), feedback %s\n\n",
+           opt.devices, opt.messages, opt.interval_s, 100.0 * opt.loss, opt.burst, opt.feedback ? "on" : "off");
+    printf("%-16s %7s %7s %7s %10s %8s %9s\n", "Backend", "B/msg", "Key B", "Delta B", "Delivered",
+           "Desync", "Enc ns");
+
+    size_t failures = 0;
+    run_result_t res;
+    for (size_t b = 0; b < NUM_STATELESS; b++) {
+        run_stateless(&opt, stateless[b].encode, &res);
+        print_row(stateless[b].name, &opt, &res);
+        failures += res.failures;
+    }
+    for (size_t k = 0; k < NUM_SESSIONS; k++) {
+        char name[32];
+        if (session_intervals[k]) snprintf(name, sizeof(name), "session-key%u", session_intervals[k]);
+        else snprintf(name, sizeof(name), "session-ondemand");
+        run_session(&opt, session_intervals[k], opt.feedback, &res);
+        print_row(name, &opt, &res);
+        failures += res.failures;
+    }
+
+    printf("\nB/msg counts resends; Key B / Delta B are the mean keyframe / in-session frame sizes.\n");
+    if (failures) {
+        fprintf(stderr, "%zu frames failed to encode or decoded to the wrong record\n", failures);
+        return 1;
+    }
+    return 0;
+}
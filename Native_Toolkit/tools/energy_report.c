@@ -0,0 +1,298 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Energy per delivered record (common/energy.h) for every codec, link
+// profile and batching policy.
+//
+// Payload sizes come from encoding generated records with every codec.
+// Encode cost comes from --cycles, measured on the device (the ESP32
+// examples log cycles per encode), or else from timing the same encoders
+// on the host, scaled by the MCU profile. Each link ranks the codecs by
+// energy within a batch size, next to their rank by size, so a codec that
+// is smaller but slower to encode shows where it stops paying off.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "energy.h"
+
+#define MAX_BATCHES 8
+
+typedef struct {
+    const link_profile_t *links[LINK_PROFILE_COUNT];
+    size_t link_count;
+    energy_mcu_t mcu;
+    size_t batches[MAX_BATCHES];
+    size_t batch_count;
+    double framing_bytes;
+    unsigned retries;
+    double loss, wake_mj, tail_ms;        // < 0 keeps the profile's
+    size_t records;
+    uint64_t seed;
+    const char *csv;
+} report_opts_t;
+
+typedef struct {
+    const char *codec;
+    double bytes;                         // mean payload
+    double host_us;                       // mean host encode time
+    double cycles;                        // MCU cycles per encode
+    int measured;                         // cycles from --cycles
+} codec_cost_t;
+
+typedef struct {
+    const codec_cost_t *cost;
+    energy_estimate_t e;
+    int energy_rank, size_rank;
+} row_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Mean payload size and host encode time per codec
+static int measure(const report_opts_t *opt, codec_cost_t *costs) {
+    for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+        codec_cost_t *k = &costs[c];
+        container_record_gen_t gen;
+        container_record_gen_init(&gen, opt->seed, 1735689600, 3600);
+        size_t total = 0;
+        double encode_s = 0.0;
+        for (size_t i = 0; i < opt->records; i++) {
+            container_record_t rec;
+            uint8_t buf[CONTAINER_CODEC_MAX_PAYLOAD];
+            container_record_generate(&gen, &rec);
+            double t0 = now_s();
+            size_t n = container_codec_encode((container_codec_t)c, &rec, buf, sizeof(buf));
+            encode_s += now_s() - t0;
+            if (!n) {
+                fprintf(stderr, "%s: record %zu does not encode\n", container_codec_name((container_codec_t)c), i);
+                return -1;
+            }
+            total += n;
+        }
+        k->codec = container_codec_name((container_codec_t)c);
+        k->bytes = (double)total / opt->records;
+        k->host_us = encode_s * 1e6 / opt->records;
+        if (!k->measured) k->cycles = energy_cycles_from_host(&opt->mcu, k->host_us);
+    }
+    return 0;
+}
+
+// codec=cycles[,codec=cycles...]
+static int parse_cycles(const char *list, codec_cost_t *costs) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+        container_codec_t c;
+        if (!eq) return -1;
+        *eq = '\0';
+        if (container_codec_parse(tok, &c) != 0 || atof(eq + 1) <= 0.0) return -1;
+        costs[c].cycles = atof(eq + 1);
+        costs[c].measured = 1;
+    }
+    return 0;
+}
+
+static int parse_batches(const char *list, report_opts_t *opt) {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%s", list);
+    opt->batch_count = 0;
+    for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        long b = atol(tok);
+        if (b < 1 || opt->batch_count == MAX_BATCHES) return -1;
+        opt->batches[opt->batch_count++] = (size_t)b;
+    }
+    return opt->batch_count ? 0 : -1;
+}
+
+// ================= RANKING =================
+static void rank_rows(row_t *rows, int n) {
+    for (int i = 0; i < n; i++) {
+        rows[i].energy_rank = rows[i].size_rank = 1;
+        for (int j = 0; j < n; j++) {
+            rows[i].energy_rank += rows[j].e.mj < rows[i].e.mj;
+            rows[i].size_rank += rows[j].cost->bytes < rows[i].cost->bytes;
+        }
+    }
+    // Insertion sort by energy; n is the codec count
+    for (int i = 1; i < n; i++) {
+        row_t r = rows[i];
+        int j = i - 1;
+        while (j >= 0 && rows[j].e.mj > r.e.mj) {
+            rows[j + 1] = rows[j];
+            j--;
+        }
+        rows[j + 1] = r;
+    }
+}
+
+// ================= OUTPUT =================
+static void print_rows(const row_t *rows, int n, size_t batch) {
+    printf("  batch %zu\n", batch);
+    printf("    %-12s %9s %6s %9s %7s %9s %9s %9s %6s %6s\n", "Codec", "B/uplink", "Frames", "Air ms",
+           "Deliv%", "CPU uJ", "Radio mJ", "mJ/rec", "Energy", "Size");
+    for (int i = 0; i < n; i++) {
+        const row_t *r = &rows[i];
+        printf("    %-12s %9.1f %6.0f %9.1f %7.2f %9.2f %9.3f %9.3f %6d %6d\n", r->cost->codec, r->e.uplink_bytes,
+               r->e.frames, r->e.airtime_ms, 100.0 * r->e.delivered, 1000.0 * r->e.cpu_mj, r->e.radio_mj, r->e.mj,
+               r->energy_rank, r->size_rank);
+    }
+}
+
+static void csv_rows(FILE *f, const link_profile_t *l, const report_opts_t *opt, const row_t *rows, int n,
+                     size_t batch) {
+    for (int i = 0; i < n; i++) {
+        const row_t *r = &rows[i];
+        fprintf(f, "%s,%s,%s,%zu,%.2f,%.0f,%s,%.1f,%.0f,%.2f,%.5f,%.6f,%.6f,%.6f,%d,%d\n", l->name, opt->mcu.name,
+                r->cost->codec, batch, r->cost->bytes, r->cost->cycles, r->cost->measured ? "device" : "host",
+                r->e.uplink_bytes, r->e.frames, r->e.airtime_ms, r->e.delivered, r->e.cpu_mj, r->e.radio_mj, r->e.mj,
+                r->energy_rank, r->size_rank);
+    }
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --link LIST         astrocast, lora-sf7..12, nbiot, wifi-udp, or all (default all)\n"
+            "  --mcu NAME          esp32, esp32-80mhz, esp32-s3, esp32-c3 (default esp32)\n"
+            "  --mhz F             CPU clock override\n"
+            "  --cpu-mw P          CPU active power override\n"
+            "  --slowdown X        MCU / host encode time override\n"
+            "  --cycles LIST       codec=cycles,... measured on the device (others from host timing)\n"
+            "  --batch LIST        records per uplink (default 1,4,16)\n"
+            "  --framing B         bytes per record inside a batch (default 2)\n"
+            "  --retries N         resends of a lost frame (default 3)\n"
+            "  --loss P            frame loss override for every link\n"
+            "  --wake MJ           per-uplink wake energy override (mJ)\n"
+            "  --tail MS           per-uplink listening tail override (ms)\n"
+            "  --records N         generated records per codec (default 5000)\n"
+            "  --seed N            generator seed (default 1)\n"
+            "  --csv FILE          one row per link, codec and batch\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    report_opts_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.mcu = ENERGY_MCUS[0];
+    opt.framing_bytes = 2.0;
+    opt.retries = 3;
+    opt.loss = opt.wake_mj = opt.tail_ms = -1.0;
+    opt.records = 5000;
+    opt.seed = 1;
+    parse_batches("1,4,16", &opt);
+    const char *links = "all", *cycles = NULL;
+    double mhz = -1.0, cpu_mw = -1.0, slowdown = -1.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--link")) links = v;
+        else if (!strcmp(a, "--mcu")) {
+            const energy_mcu_t *m = energy_mcu_find(v);
+            if (!m) { fprintf(stderr, "unknown MCU profile: %s\n", v); return 2; }
+            opt.mcu = *m;
+        }
+        else if (!strcmp(a, "--mhz")) mhz = atof(v);
+        else if (!strcmp(a, "--cpu-mw")) cpu_mw = atof(v);
+        else if (!strcmp(a, "--slowdown")) slowdown = atof(v);
+        else if (!strcmp(a, "--cycles")) cycles = v;
+        else if (!strcmp(a, "--batch")) { if (parse_batches(v, &opt) != 0) { usage(argv[0]); return 2; } }
+        else if (!strcmp(a, "--framing")) opt.framing_bytes = atof(v);
+        else if (!strcmp(a, "--retries")) opt.retries = (unsigned)atoi(v);
+        else if (!strcmp(a, "--loss")) opt.loss = atof(v);
+        else if (!strcmp(a, "--wake")) opt.wake_mj = atof(v);
+        else if (!strcmp(a, "--tail")) opt.tail_ms = atof(v);
+        else if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--csv")) opt.csv = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (mhz > 0.0) opt.mcu.mhz = mhz;
+    if (cpu_mw >= 0.0) opt.mcu.active_mw = cpu_mw;
+    if (slowdown > 0.0) opt.mcu.host_slowdown = slowdown;
+    if (opt.records == 0 || opt.loss >= 1.0 || opt.framing_bytes < 0.0 || mhz == 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    codec_cost_t costs[CONTAINER_CODEC_COUNT];
+    memset(costs, 0, sizeof(costs));
+    if (cycles && parse_cycles(cycles, costs) != 0) {
+        fprintf(stderr, "bad --cycles list: %s\n", cycles);
+        return 2;
+    }
+
+    if (!strcmp(links, "all")) {
+        for (size_t l = 0; l < LINK_PROFILE_COUNT; l++) opt.links[opt.link_count++] = &LINK_PROFILES[l];
+    } else {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%s", links);
+        for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            const link_profile_t *l = link_profile_find(tok);
+            if (!l || opt.link_count == LINK_PROFILE_COUNT) {
+                fprintf(stderr, "unknown link: %s\n", tok);
+                return 2;
+            }
+            opt.links[opt.link_count++] = l;
+        }
+    }
+
+    if (measure(&opt, costs) != 0) return 1;
+
+    printf("Energy per delivered record, MCU %s (%.0f MHz, %.0f mW active), %u retries per frame\n",
+           opt.mcu.name, opt.mcu.mhz, opt.mcu.active_mw, opt.retries);
+    printf("%-12s %8s %10s %12s\n", "Codec", "Bytes", "Host us", "MCU cycles");
+    for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+        printf("%-12s %8.1f %10.3f %12.0f%s\n", costs[c].codec, costs[c].bytes, costs[c].host_us, costs[c].cycles,
+               costs[c].measured ? " (device)" : "");
+    }
+
+    FILE *csv = NULL;
+    if (opt.csv) {
+        csv = fopen(opt.csv, "w");
+        if (!csv) { perror(opt.csv); return 1; }
+        fprintf(csv, "link,mcu,codec,batch,payload_bytes,cycles,cycles_source,uplink_bytes,frames,airtime_ms,"
+                     "delivered,cpu_mj,radio_mj,mj_per_record,energy_rank,size_rank\n");
+    }
+
+    for (size_t l = 0; l < opt.link_count; l++) {
+        link_profile_t link = *opt.links[l];
+        if (opt.loss >= 0.0) link.frame_loss = opt.loss;
+        if (opt.wake_mj >= 0.0) link.wake_mj = opt.wake_mj;
+        if (opt.tail_ms >= 0.0) link.tail_ms = opt.tail_ms;
+        printf("\n%s: %.0f bps, MTU %.0f B, %.1f %% frame loss, tx %.0f / rx %.0f mW, wake %.1f mJ, tail %.0f ms\n",
+               link.name, link.bitrate_bps, link.mtu_bytes, 100.0 * link.frame_loss, link.tx_mw, link.rx_mw,
+               link.wake_mj, link.tail_ms);
+        for (size_t b = 0; b < opt.batch_count; b++) {
+            energy_policy_t policy = { opt.batches[b], opt.framing_bytes, opt.retries };
+            row_t rows[CONTAINER_CODEC_COUNT];
+            for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+                rows[c].cost = &costs[c];
+                energy_estimate(&link, &opt.mcu, &policy, costs[c].bytes, costs[c].cycles, &rows[c].e);
+            }
+            rank_rows(rows, CONTAINER_CODEC_COUNT);
+            print_rows(rows, CONTAINER_CODEC_COUNT, policy.batch);
+            if (csv) csv_rows(csv, &link, &opt, rows, CONTAINER_CODEC_COUNT, policy.batch);
+        }
+    }
+    if (csv && fclose(csv) != 0) {
+        perror(opt.csv);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,480 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Benchmark for the cross-frame FEC layer (firmware/fec_rs.c).
+//
+// 1. GF(256) kernel throughput, scalar vs. the SIMD kernel of this build.
+// 2. A loss-injecting link emulator (common/link_loss.h, Bernoulli or
+//    Gilbert-Elliott bursts) carrying real frames through four strategies:
+//      none     send once
+//      arq      per-frame ACK, retransmit up to --arq-retries times
+//      fec K:M  group of K data + M parity frames, no feedback
+//      fec+arq  FEC, then one NACK window per group; frames still missing
+//               are repaired with per-frame ARQ
+//    Every delivered frame is compared byte-for-byte with the original.
+// 3. Energy per strategy from the radio profile (TX airtime incl. per-frame
+//    overhead, RX listen windows for ACK/NACK, parity computation) and the
+//    resulting delivered payload bytes per joule.
+//
+// Exits non-zero if a frame is delivered corrupted.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../common/link_loss.h"
+#include "../common/link_profile.h"
+#include "../firmware/fec_rs.h"
+
+#define MAX_LIST 16
+#define MAX_FRAME_BYTES 250
+
+typedef link_profile_t radio_profile_t;
+
+typedef struct {
+    uint8_t k, m;
+} fec_config_t;
+
+typedef struct {
+    size_t frames;
+    size_t frame_min, frame_max;
+    double losses[MAX_LIST];
+    size_t n_losses;
+    double mean_burst;
+    fec_config_t fec[MAX_LIST];
+    size_t n_fec;
+    int arq_retries;
+    double min_delivery;
+    uint64_t seed;
+    radio_profile_t radio;
+    const char *csv_path;
+    int skip_kernels;
+} bench_options_t;
+
+typedef struct {
+    char name[24];
+    size_t offered, delivered;
+    size_t offered_bytes, delivered_bytes;
+    size_t frames_on_air, bytes_on_air;
+    size_t listens;
+    double parity_byte_ops;
+    double energy_j;
+    size_t corrupted;
+} strategy_result_t;
+
+typedef struct {
+    uint8_t data[MAX_FRAME_BYTES];
+    size_t len;
+    int delivered;
+} frame_t;
+
+static uint64_t rng_state;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ================= RADIO =================
+
+static double tx_energy(const radio_profile_t *r, size_t bytes) {
+    return (bytes + r->frame_overhead_bytes) * 8.0 / r->bitrate_bps * r->tx_mw / 1000.0;
+}
+
+static double listen_energy(const radio_profile_t *r) {
+    return r->ack_window_ms / 1000.0 * r->rx_mw / 1000.0;
+}
+
+static void finish_energy(strategy_result_t *s, const radio_profile_t *r) {
+    s->energy_j += s->listens * listen_energy(r);
+    s->energy_j += s->parity_byte_ops * r->cpu_nj_per_byte * 1e-9;
+}
+
+static void on_air(strategy_result_t *s, const radio_profile_t *r, size_t bytes) {
+    s->frames_on_air++;
+    s->bytes_on_air += bytes;
+    s->energy_j += tx_energy(r, bytes);
+}
+
+// ================= FRAMES =================
+
+static void make_frames(frame_t *frames, const bench_options_t *opt) {
+    for (size_t i = 0; i < opt->frames; i++) {
+        size_t span = opt->frame_max - opt->frame_min + 1;
+        frames[i].len = opt->frame_min + (size_t)(rng_next() % span);
+        for (size_t b = 0; b < frames[i].len; b++) frames[i].data[b] = (uint8_t)rng_next();
+        frames[i].delivered = 0;
+    }
+}
+
+static void reset_frames(frame_t *frames, size_t n) {
+    for (size_t i = 0; i < n; i++) frames[i].delivered = 0;
+}
+
+static void count_delivery(strategy_result_t *s, frame_t *f) {
+    if (f->delivered) return;
+    f->delivered = 1;
+    s->delivered++;
+    s->delivered_bytes += f->len;
+}
+
+// Per-frame stop-and-wait ARQ for one frame; the uplink carries wire_len bytes
+static void arq_send(strategy_result_t *s, const bench_options_t *opt, link_loss_t *up,
+                     link_loss_t *down, frame_t *f, size_t wire_len, int max_attempts) {
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+        on_air(s, &opt->radio, wire_len);
+        bool arrived = !link_loss_drop(up);
+        if (arrived) count_delivery(s, f);
+        s->listens++;
+        if (arrived && !link_loss_drop(down)) return;
+    }
+}
+
+// ================= STRATEGIES =================
+
+static void run_none(strategy_result_t *s, const bench_options_t *opt, frame_t *frames,
+                     link_loss_t *up) {
+    for (size_t i = 0; i < opt->frames; i++) {
+        on_air(s, &opt->radio, frames[i].len);
+        if (!link_loss_drop(up)) count_delivery(s, &frames[i]);
+    }
+}
+
+static void run_arq(strategy_result_t *s, const bench_options_t *opt, frame_t *frames,
+                    link_loss_t *up, link_loss_t *down) {
+    for (size_t i = 0; i < opt->frames; i++) {
+        arq_send(s, opt, up, down, &frames[i], frames[i].len, 1 + opt->arq_retries);
+    }
+}
+
+typedef struct {
+    frame_t *group;                       // originals of the group being received
+    size_t group_len;
+    strategy_result_t *result;
+} delivery_ctx_t;
+
+static void on_fec_frame(void *ctx, const uint8_t *frame, size_t len, bool recovered) {
+    (void)recovered;
+    delivery_ctx_t *d = ctx;
+    for (size_t i = 0; i < d->group_len; i++) {
+        frame_t *f = &d->group[i];
+        if (!f->delivered && f->len == len && memcmp(f->data, frame, len) == 0) {
+            count_delivery(d->result, f);
+            return;
+        }
+    }
+    d->result->corrupted++;
+}
+
+static void run_fec(strategy_result_t *s, const bench_options_t *opt, frame_t *frames,
+                    fec_config_t cfg, bool repair, link_loss_t *up, link_loss_t *down) {
+    static fec_sender_t sender;
+    static fec_receiver_t receiver;
+    static uint8_t parity_buf[FEC_RS_MAX_M][FEC_RS_MAX_SHARD + FEC_RS_HEADER_SIZE];
+    uint8_t *parity_out[FEC_RS_MAX_M];
+    uint8_t wire[FEC_RS_MAX_SHARD + FEC_RS_HEADER_SIZE];
+
+    for (size_t i = 0; i < FEC_RS_MAX_M; i++) parity_out[i] = parity_buf[i];
+    fec_sender_init(&sender, cfg.k, cfg.m);
+    fec_receiver_init(&receiver);
+
+    for (size_t start = 0; start < opt->frames; start += cfg.k) {
+        size_t n = opt->frames - start < cfg.k ? opt->frames - start : cfg.k;
+        delivery_ctx_t ctx = { &frames[start], n, s };
+
+        for (size_t i = 0; i < n; i++) {
+            size_t len = fec_sender_add(&sender, frames[start + i].data, frames[start + i].len,
+                                        wire, sizeof(wire));
+            on_air(s, &opt->radio, len);
+            if (!link_loss_drop(up)) fec_receiver_push(&receiver, wire, len, on_fec_frame, &ctx);
+        }
+
+        size_t shard_len = sender.shard_len;
+        size_t parity_len = 0;
+        size_t parity_frames = fec_sender_finish_group(&sender, parity_out, sizeof(parity_buf[0]),
+                                                       &parity_len);
+        s->parity_byte_ops += (double)cfg.m * n * shard_len;
+        for (size_t p = 0; p < parity_frames; p++) {
+            on_air(s, &opt->radio, parity_len);
+            if (!link_loss_drop(up)) {
+                fec_receiver_push(&receiver, parity_out[p], parity_len, on_fec_frame, &ctx);
+            }
+        }
+
+        if (!repair) continue;
+
+        // One NACK window per group; a lost NACK leaves the group as it is
+        s->listens++;
+        bool missing = false;
+        for (size_t i = 0; i < n; i++) missing |= !frames[start + i].delivered;
+        if (!missing || link_loss_drop(down)) continue;
+        for (size_t i = 0; i < n; i++) {
+            frame_t *f = &frames[start + i];
+            if (!f->delivered) {
+                arq_send(s, opt, up, down, f, f->len + FEC_RS_HEADER_SIZE, opt->arq_retries);
+            }
+        }
+    }
+}
+
+static void run_strategy(strategy_result_t *s, const bench_options_t *opt, frame_t *frames,
+                         double loss, int kind, fec_config_t cfg) {
+    memset(s, 0, sizeof(*s));
+    reset_frames(frames, opt->frames);
+    for (size_t i = 0; i < opt->frames; i++) s->offered_bytes += frames[i].len;
+    s->offered = opt->frames;
+
+    // Same loss pattern seed for every strategy at a given loss rate
+    link_loss_t up, down;
+    link_loss_init_gilbert(&up, loss, opt->mean_burst, opt->seed * 7919 + (uint64_t)(loss * 1e6));
+    link_loss_init_gilbert(&down, loss, opt->mean_burst, opt->seed * 104729 + (uint64_t)(loss * 1e6));
+
+    switch (kind) {
+    case 0:
+        snprintf(s->name, sizeof(s->name), "none");
+        run_none(s, opt, frames, &up);
+        break;
+    case 1:
+        snprintf(s->name, sizeof(s->name), "arq(%d)", opt->arq_retries);
+        run_arq(s, opt, frames, &up, &down);
+        break;
+    case 2:
+        snprintf(s->name, sizeof(s->name), "fec %u:%u", cfg.k, cfg.m);
+        run_fec(s, opt, frames, cfg, false, &up, &down);
+        break;
+    default:
+        snprintf(s->name, sizeof(s->name), "fec+arq %u:%u", cfg.k, cfg.m);
+        run_fec(s, opt, frames, cfg, true, &up, &down);
+        break;
+    }
+    finish_energy(s, &opt->radio);
+}
+
+// ================= KERNELS =================
+
+static void bench_kernels(void) {
+    enum { REGION = 64 * 1024 };
+    static uint8_t src[REGION], dst_a[REGION], dst_b[REGION];
+    for (size_t i = 0; i < REGION; i++) src[i] = (uint8_t)rng_next();
+
+    // Cross-check before timing
+    memset(dst_a, 0x5A, REGION);
+    memset(dst_b, 0x5A, REGION);
+    for (int c = 0; c < 256; c++) {
+        gf256_mul_add_region_scalar(dst_a, src, (uint8_t)c, REGION - (size_t)c);
+        gf256_mul_add_region(dst_b, src, (uint8_t)c, REGION - (size_t)c);
+    }
+    bool same = memcmp(dst_a, dst_b, REGION) == 0;
+
+    double rates[2];
+    for (int kernel = 0; kernel < 2; kernel++) {
+        size_t bytes = 0;
+        double t0 = now_s(), t;
+        do {
+            for (int rep = 0; rep < 16; rep++) {
+                uint8_t c = (uint8_t)(rep * 37 + 2);
+                if (kernel == 0) gf256_mul_add_region_scalar(dst_a, src, c, REGION);
+                else gf256_mul_add_region(dst_b, src, c, REGION);
+                bytes += REGION;
+            }
+            t = now_s() - t0;
+        } while (t < 0.25);
+        rates[kernel] = bytes / t / 1e6;
+    }
+
+    printf("GF(256) mul-add kernels\n");
+    printf("   scalar: %8.1f MB/s\n", rates[0]);
+    printf("   %-6s: %8.1f MB/s (%.1fx), cross-check %s\n\n", gf256_kernel_name(), rates[1],
+           rates[1] / rates[0], same ? "PASS" : "FAIL");
+    if (!same) exit(1);
+}
+
+// ================= CLI =================
+
+static size_t parse_losses(const char *v, double *out) {
+    size_t n = 0;
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", v);
+    for (char *tok = strtok(buf, ","); tok && n < MAX_LIST; tok = strtok(NULL, ",")) {
+        out[n++] = atof(tok);
+    }
+    return n;
+}
+
+static size_t parse_fec(const char *v, fec_config_t *out) {
+    size_t n = 0;
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", v);
+    for (char *tok = strtok(buf, ","); tok && n < MAX_LIST; tok = strtok(NULL, ",")) {
+        unsigned k = 0, m = 0;
+        if (sscanf(tok, "%u:%u", &k, &m) != 2 || k == 0 || k > FEC_RS_MAX_K || m > FEC_RS_MAX_M) {
+            fprintf(stderr, "Invalid FEC config '%s' (K 1..%d, M 0..%d)\n", tok, FEC_RS_MAX_K,
+                    FEC_RS_MAX_M);
+            exit(2);
+        }
+        out[n].k = (uint8_t)k;
+        out[n].m = (uint8_t)m;
+        n++;
+    }
+    return n;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --profile NAME       astrocast | lora-sf7..12 | nbiot | wifi-udp (default astrocast)\n"
+            "  --frames N           frames per run (default 20000)\n"
+            "  --frame-min B        shortest frame (default 70)\n"
+            "  --frame-max B        longest frame (default 110)\n"
+            "  --loss LIST          uplink/downlink loss rates (default 0,0.01,0.02,0.05,0.1,0.2,0.3)\n"
+            "  --burst N            mean loss burst length, 1 = independent (default 1)\n"
+            "  --fec LIST           K:M configurations (default 4:1,4:2,8:2,8:4)\n"
+            "  --arq-retries N      retransmissions per frame (default 3)\n"
+            "  --min-delivery R     delivery ratio a winner must reach (default 0.99)\n"
+            "  --bitrate BPS --tx-mw MW --rx-mw MW --overhead B --ack-ms MS --cpu-nj B\n"
+            "                       override the radio profile\n"
+            "  --seed N             RNG seed (default 1)\n"
+            "  --csv PATH           write one row per loss rate and strategy\n"
+            "  --no-kernels         skip the GF(256) kernel benchmark\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_options_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.frames = 20000;
+    opt.frame_min = 70;
+    opt.frame_max = 110;
+    opt.n_losses = parse_losses("0,0.01,0.02,0.05,0.1,0.2,0.3", opt.losses);
+    opt.mean_burst = 1.0;
+    opt.n_fec = parse_fec("4:1,4:2,8:2,8:4", opt.fec);
+    opt.arq_retries = 3;
+    opt.min_delivery = 0.99;
+    opt.seed = 1;
+    opt.radio = LINK_PROFILES[0];
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(a, "--no-kernels")) { opt.skip_kernels = 1; continue; }
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--profile")) {
+            const link_profile_t *p = link_profile_find(v);
+            if (!p) { usage(argv[0]); return 2; }
+            opt.radio = *p;
+        }
+        else if (!strcmp(a, "--frames")) opt.frames = (size_t)atol(v);
+        else if (!strcmp(a, "--frame-min")) opt.frame_min = (size_t)atol(v);
+        else if (!strcmp(a, "--frame-max")) opt.frame_max = (size_t)atol(v);
+        else if (!strcmp(a, "--loss")) opt.n_losses = parse_losses(v, opt.losses);
+        else if (!strcmp(a, "--burst")) opt.mean_burst = atof(v);
+        else if (!strcmp(a, "--fec")) opt.n_fec = parse_fec(v, opt.fec);
+        else if (!strcmp(a, "--arq-retries")) opt.arq_retries = atoi(v);
+        else if (!strcmp(a, "--min-delivery")) opt.min_delivery = atof(v);
+        else if (!strcmp(a, "--bitrate")) opt.radio.bitrate_bps = atof(v);
+        else if (!strcmp(a, "--tx-mw")) opt.radio.tx_mw = atof(v);
+        else if (!strcmp(a, "--rx-mw")) opt.radio.rx_mw = atof(v);
+        else if (!strcmp(a, "--overhead")) opt.radio.frame_overhead_bytes = atof(v);
+        else if (!strcmp(a, "--ack-ms")) opt.radio.ack_window_ms = atof(v);
+        else if (!strcmp(a, "--cpu-nj")) opt.radio.cpu_nj_per_byte = atof(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--csv")) opt.csv_path = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.frames == 0 || opt.frame_min == 0 || opt.frame_min > opt.frame_max ||
+        opt.frame_max > MAX_FRAME_BYTES || opt.radio.bitrate_bps <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    rng_state = 0x9E3779B97F4A7C15ull ^ opt.seed;
+    fec_rs_init();
+    if (!opt.skip_kernels) bench_kernels();
+
+    frame_t *frames = calloc(opt.frames, sizeof(frame_t));
+    if (!frames) { perror("calloc"); return 1; }
+    make_frames(frames, &opt);
+
+    FILE *csv = opt.csv_path ? fopen(opt.csv_path, "w") : NULL;
+    if (csv) {
+        fprintf(csv, "profile,loss,burst,strategy,delivery,frames_on_air,bytes_on_air,"
+                     "energy_j,mj_per_frame,bytes_per_joule\n");
+    }
+
+    printf("FEC vs. retransmission (%s: %.0f bps, TX %.0f mW, RX %.0f mW, ACK window %.0f ms)\n",
+           opt.radio.name, opt.radio.bitrate_bps, opt.radio.tx_mw, opt.radio.rx_mw,
+           opt.radio.ack_window_ms);
+    printf("   %zu frames of %zu-%zu B, mean loss burst %.1f frames\n\n", opt.frames,
+           opt.frame_min, opt.frame_max, opt.mean_burst);
+
+    size_t corrupted = 0;
+    size_t n_strategies = 2 + 2 * opt.n_fec;
+    strategy_result_t *results = calloc(n_strategies, sizeof(strategy_result_t));
+    if (!results) { perror("calloc"); return 1; }
+
+    for (size_t l = 0; l < opt.n_losses; l++) {
+        double loss = opt.losses[l];
+        run_strategy(&results[0], &opt, frames, loss, 0, opt.fec[0]);
+        run_strategy(&results[1], &opt, frames, loss, 1, opt.fec[0]);
+        for (size_t f = 0; f < opt.n_fec; f++) {
+            run_strategy(&results[2 + f], &opt, frames, loss, 2, opt.fec[f]);
+            run_strategy(&results[2 + opt.n_fec + f], &opt, frames, loss, 3, opt.fec[f]);
+        }
+
+        printf("Loss %.1f%%\n", loss * 100.0);
+        printf("   %-14s %9s %10s %12s %12s %10s\n", "strategy", "delivery", "air B/frame",
+               "mJ/frame", "bytes/J", "vs. arq");
+        size_t best = n_strategies;
+        for (size_t s = 0; s < n_strategies; s++) {
+            strategy_result_t *r = &results[s];
+            double delivery = (double)r->delivered / r->offered;
+            double bpj = r->energy_j > 0 ? r->delivered_bytes / r->energy_j : 0.0;
+            double arq_bpj = results[1].energy_j > 0 ? results[1].delivered_bytes / results[1].energy_j : 0.0;
+            corrupted += r->corrupted;
+            printf("   %-14s %8.2f%% %10.1f %12.2f %12.1f %9.2fx\n", r->name, delivery * 100.0,
+                   r->delivered ? (double)r->bytes_on_air / r->delivered : 0.0,
+                   r->delivered ? r->energy_j * 1000.0 / r->delivered : 0.0, bpj,
+                   arq_bpj > 0 ? bpj / arq_bpj : 0.0);
+            if (csv) {
+                fprintf(csv, "%s,%.4f,%.2f,%s,%.5f,%zu,%zu,%.6f,%.4f,%.2f\n", opt.radio.name, loss,
+                        opt.mean_burst, r->name, delivery, r->frames_on_air, r->bytes_on_air,
+                        r->energy_j, r->delivered ? r->energy_j * 1000.0 / r->delivered : 0.0, bpj);
+            }
+            if (delivery >= opt.min_delivery &&
+                (best == n_strategies ||
+                 bpj > results[best].delivered_bytes / results[best].energy_j)) {
+                best = s;
+            }
+        }
+        if (best < n_strategies) {
+            printf("   best at >= %.1f%% delivery: %s\n\n", opt.min_delivery * 100.0,
+                   results[best].name);
+        } else {
+            printf("   no strategy reaches %.1f%% delivery\n\n", opt.min_delivery * 100.0);
+        }
+    }
+
+    if (csv) fclose(csv);
+    free(results);
+    free(frames);
+
+    if (corrupted) {
+        printf("Corrupted deliveries: %zu  FAIL\n", corrupted);
+        return 1;
+    }
+    printf("Frame integrity: PASS\n");
+    return 0;
+}
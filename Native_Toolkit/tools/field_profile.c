@@ -0,0 +1,479 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Per-field profile of a record corpus (common/field_stats.h).
+//
+// Records come from the generator (i.i.d., like the locust senders), from
+// device traces (--trace, one drifting series per device), from a file of
+// u16 BE length-prefixed packed records (--packed, as record_rans_train
+// reads) or from a struct-zlib / struct-rans payload corpus (--corpus).
+// For every field it reports range, decimals, fixed bit width, entropy,
+// and the same for deltas within a device (keyed by msisdn); then the
+// strongest correlations between fields and the size per record of every
+// codec, measured, next to what a bit-packed or entropy-coded descriptor
+// built from the figures would reach. --descriptor writes the recommended
+// scale, offset and widths per field as JSON.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "field_stats.h"
+#include "payload_corpus.h"
+#include "record_rans.h"
+
+#define TIME_BASE 1735689600
+
+enum {
+    F_RSSI, F_BLE_M, F_BAT_SOC, F_ACC_X, F_ACC_Y, F_ACC_Z, F_TEMPERATURE, F_HUMIDITY, F_PRESSURE, F_GNSS,
+    F_LATITUDE, F_LONGITUDE, F_ALTITUDE, F_SPEED, F_HEADING, F_NSAT, F_HDOP, F_TIME, NUMERIC_FIELDS
+};
+enum { S_MSISDN, S_ISO6346, S_CGI, S_DOOR, SYMBOL_FIELDS };
+
+static const char *const numeric_names[NUMERIC_FIELDS] = {
+    "rssi", "ble-m", "bat-soc", "acc.x", "acc.y", "acc.z", "temperature", "humidity", "pressure", "gnss",
+    "latitude", "longitude", "altitude", "speed", "heading", "nsat", "hdop", "time"
+};
+static const char *const symbol_names[SYMBOL_FIELDS] = { "msisdn", "iso6346", "cgi", "door" };
+
+typedef struct {
+    size_t records;
+    uint64_t seed;
+    size_t trace_devices;                 // 0 = independent records
+    uint32_t interval_s;
+    const char *packed;
+    const char *corpus;
+    double min_corr;
+    size_t top;
+    const char *descriptor;
+} profile_opts_t;
+
+typedef struct {
+    container_record_t *v;
+    size_t n, cap;
+} record_list_t;
+
+static int push(record_list_t *l, const container_record_t *rec) {
+    if (l->n == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 4096;
+        container_record_t *v = realloc(l->v, cap * sizeof(*v));
+        if (!v) return -1;
+        l->v = v;
+        l->cap = cap;
+    }
+    l->v[l->n++] = *rec;
+    return 0;
+}
+
+// ================= SOURCES =================
+static int load_generated(record_list_t *l, const profile_opts_t *opt) {
+    if (opt->trace_devices) {
+        container_trace_t *traces = calloc(opt->trace_devices, sizeof(*traces));
+        if (!traces) return -1;
+        for (size_t d = 0; d < opt->trace_devices; d++) {
+            container_trace_init(&traces[d], opt->seed + d, TIME_BASE, opt->interval_s);
+            // The generator draws from 200 numbers; the series are keyed by msisdn
+            snprintf(traces[d].rec.msisdn, sizeof(traces[d].rec.msisdn), "3936%08u", (unsigned)(d % 100000000));
+        }
+        // Devices report in turn, as a receiver would archive them
+        for (size_t i = 0; i < opt->records; i++) {
+            container_record_t rec;
+            container_trace_next(&traces[i % opt->trace_devices], &rec);
+            if (push(l, &rec)) {
+                free(traces);
+                return -1;
+            }
+        }
+        free(traces);
+        return 0;
+    }
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt->seed, TIME_BASE, 3600);
+    for (size_t i = 0; i < opt->records; i++) {
+        container_record_t rec;
+        container_record_generate(&gen, &rec);
+        if (push(l, &rec)) return -1;
+    }
+    return 0;
+}
+
+static int load_packed(record_list_t *l, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    uint8_t hdr[2], buf[RECORD_RANS_MAX_RECORD];
+    size_t rejected = 0;
+    while (fread(hdr, 1, 2, f) == 2) {
+        size_t len = ((size_t)hdr[0] << 8) | hdr[1];
+        if (len > sizeof(buf)) {
+            fprintf(stderr, "%s: record of %zu bytes exceeds %d\n", path, len, RECORD_RANS_MAX_RECORD);
+            fclose(f);
+            return -1;
+        }
+        if (fread(buf, 1, len, f) != len) break;
+        container_record_t rec;
+        if (container_record_unpack_struct(buf, len, &rec) != 0) rejected++;
+        else if (push(l, &rec)) {
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    if (rejected) fprintf(stderr, "%s: skipped %zu records not in the packed layout\n", path, rejected);
+    return 0;
+}
+
+static int load_corpus(record_list_t *l, const char *path) {
+    payload_corpus_t c;
+    if (payload_corpus_open(&c, path) != 0) {
+        perror(path);
+        return -1;
+    }
+    int rans = !strcmp(c.codec, "struct-rans");
+    if (!rans && strcmp(c.codec, "struct-zlib")) {
+        fprintf(stderr, "%s: %s payloads do not decode to records here (struct-zlib or struct-rans only)\n", path,
+                c.codec);
+        payload_corpus_close(&c);
+        return -1;
+    }
+    size_t rejected = 0;
+    for (uint32_t i = 0; i < c.count; i++) {
+        uint32_t len;
+        const uint8_t *p = payload_corpus_get(&c, i, &len);
+        uint8_t packed[RECORD_RANS_MAX_RECORD];
+        int n;
+        if (rans) {
+            n = record_rans_decode(p, len, packed, sizeof(packed));
+        } else {
+            uLongf out = sizeof(packed);
+            n = uncompress(packed, &out, p, len) == Z_OK ? (int)out : -1;
+        }
+        container_record_t rec;
+        if (n < 0 || container_record_unpack_struct(packed, (size_t)n, &rec) != 0) rejected++;
+        else if (push(l, &rec)) {
+            payload_corpus_close(&c);
+            return -1;
+        }
+    }
+    payload_corpus_close(&c);
+    if (rejected) fprintf(stderr, "%s: skipped %zu payloads that did not decode\n", path, rejected);
+    return 0;
+}
+
+// ================= COLUMNS =================
+// DDMMYY hhmmss.s as unix seconds
+static double parse_time(const char *s) {
+    int dd, mo, yy, hh, mi, ss, tenths = 0;
+    if (sscanf(s, "%2d%2d%2d %2d%2d%2d.%1d", &dd, &mo, &yy, &hh, &mi, &ss, &tenths) < 6) return 0.0;
+    struct tm tm = { .tm_sec = ss, .tm_min = mi, .tm_hour = hh, .tm_mday = dd, .tm_mon = mo - 1,
+                     .tm_year = yy + 100 };
+    return (double)timegm(&tm) + tenths / 10.0;
+}
+
+static void numeric_values(const container_record_t *r, double *v) {
+    v[F_RSSI] = r->rssi;
+    v[F_BLE_M] = r->ble_m;
+    v[F_BAT_SOC] = r->bat_soc;
+    v[F_ACC_X] = r->acc[0];
+    v[F_ACC_Y] = r->acc[1];
+    v[F_ACC_Z] = r->acc[2];
+    v[F_TEMPERATURE] = r->temperature;
+    v[F_HUMIDITY] = r->humidity;
+    v[F_PRESSURE] = r->pressure;
+    v[F_GNSS] = r->gnss;
+    v[F_LATITUDE] = r->latitude;
+    v[F_LONGITUDE] = r->longitude;
+    v[F_ALTITUDE] = r->altitude;
+    v[F_SPEED] = r->speed;
+    v[F_HEADING] = r->heading;
+    v[F_NSAT] = r->nsat;
+    v[F_HDOP] = r->hdop;
+    v[F_TIME] = parse_time(r->time);
+}
+
+// Sent as float32, so decimals are only exact up to float32 rounding
+static bool is_float32(int f) {
+    return (f >= F_ACC_X && f <= F_PRESSURE) || (f >= F_LATITUDE && f <= F_HEADING) || f == F_HDOP;
+}
+
+static const char *symbol_value(const container_record_t *r, int s) {
+    switch (s) {
+    case S_MSISDN: return r->msisdn;
+    case S_ISO6346: return r->iso6346;
+    case S_CGI: return r->cgi;
+    default: return r->door;
+    }
+}
+
+// Index of each record's predecessor from the same msisdn, -1 for the first
+static int64_t *link_series(const uint64_t *device, size_t n, size_t *devices) {
+    size_t cap = 1;
+    while (cap < 2 * n) cap <<= 1;
+    uint64_t *keys = calloc(cap, sizeof(*keys));
+    int64_t *last = malloc(cap * sizeof(*last));
+    int64_t *prev = malloc(n * sizeof(*prev));
+    if (!keys || !last || !prev) {
+        free(keys);
+        free(last);
+        free(prev);
+        return NULL;
+    }
+    *devices = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = device[i] ? device[i] : 1;  // 0 marks an empty slot
+        size_t h = (size_t)(k * 0x9E3779B97F4A7C15ull) & (cap - 1);
+        while (keys[h] && keys[h] != k) h = (h + 1) & (cap - 1);
+        if (!keys[h]) {
+            keys[h] = k;
+            prev[i] = -1;
+            (*devices)++;
+        } else {
+            prev[i] = last[h];
+        }
+        last[h] = (int64_t)i;
+    }
+    free(keys);
+    free(last);
+    return prev;
+}
+
+// ================= OUTPUT =================
+static void print_fields(const field_stats_t *num, const field_stats_t *sym) {
+    printf("%-12s %12s %12s %4s %4s %6s %8s %6s %5s %6s %10s %10s\n", "Field", "Min", "Max", "Dec", "Bits",
+           "H", "Distinct", "dChg%", "dBits", "dH", "|d| p50", "|d| p99");
+    for (int f = 0; f < NUMERIC_FIELDS; f++) {
+        const field_stats_t *s = &num[f];
+        printf("%-12s %12.*f %12.*f %3d%s %4u %6.2f %8zu", numeric_names[f], s->decimals, s->min, s->decimals,
+               s->max, s->decimals, s->float_limited ? "*" : " ", s->bits, s->entropy_bits, s->distinct);
+        if (s->deltas) {
+            printf(" %6.1f %5u %6.2f %10.*f %10.*f\n", 100.0 * s->changed, s->delta_bits, s->delta_entropy_bits,
+                   s->decimals, s->delta_p50, s->decimals, s->delta_p99);
+        } else {
+            printf(" %6s %5s %6s %10s %10s\n", "-", "-", "-", "-", "-");
+        }
+    }
+    for (int f = 0; f < SYMBOL_FIELDS; f++) {
+        const field_stats_t *s = &sym[f];
+        printf("%-12s %12s %12s %4s %4u %6.2f %8zu", symbol_names[f], "(symbol)", "", "", s->bits, s->entropy_bits,
+               s->distinct);
+        if (s->deltas) printf(" %6.1f %5u %6.2f\n", 100.0 * s->changed, s->delta_bits, s->delta_entropy_bits);
+        else printf(" %6s %5s %6s\n", "-", "-", "-");
+    }
+    printf("* float32 cannot resolve finer decimals at this magnitude\n");
+}
+
+static void print_correlations(double **cols, size_t n, const profile_opts_t *opt) {
+    typedef struct { int a, b; double r; } pair_t;
+    pair_t pairs[NUMERIC_FIELDS * NUMERIC_FIELDS / 2];
+    size_t count = 0;
+    for (int a = 0; a < NUMERIC_FIELDS; a++) {
+        for (int b = a + 1; b < NUMERIC_FIELDS; b++) {
+            double r = field_stats_correlation(cols[a], cols[b], n);
+            if (r >= opt->min_corr || -r >= opt->min_corr) pairs[count++] = (pair_t){ a, b, r };
+        }
+    }
+    // Strongest first
+    for (size_t i = 1; i < count; i++) {
+        pair_t p = pairs[i];
+        size_t j = i;
+        while (j > 0 && (pairs[j - 1].r < 0 ? -pairs[j - 1].r : pairs[j - 1].r) < (p.r < 0 ? -p.r : p.r)) {
+            pairs[j] = pairs[j - 1];
+            j--;
+        }
+        pairs[j] = p;
+    }
+    printf("\nCorrelations |r| >= %.2f\n", opt->min_corr);
+    if (!count) printf("  none\n");
+    for (size_t i = 0; i < count && i < opt->top; i++)
+        printf("  %-12s %-12s %+.3f\n", numeric_names[pairs[i].a], numeric_names[pairs[i].b], pairs[i].r);
+}
+
+static void print_sizes(const record_list_t *l, const field_stats_t *num, const field_stats_t *sym,
+                        const double *str_len) {
+    printf("\nSize per record\n");
+    for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+        size_t total = 0, bad = 0;
+        for (size_t i = 0; i < l->n; i++) {
+            uint8_t buf[CONTAINER_CODEC_MAX_PAYLOAD];
+            size_t n = container_codec_encode((container_codec_t)c, &l->v[i], buf, sizeof(buf));
+            total += n;
+            bad += n == 0;
+        }
+        printf("  %-36s %8.1f B%s\n", container_codec_name((container_codec_t)c),
+               l->n > bad ? (double)total / (l->n - bad) : 0.0, bad ? " (some records did not fit)" : "");
+    }
+
+    double fixed = 0.0, raw_strings = 0.0, dict = 0.0, entropy = 0.0, delta_fixed = 0.0, delta_entropy = 0.0;
+    int series = 0;
+    for (int f = 0; f < NUMERIC_FIELDS; f++) {
+        fixed += num[f].bits;
+        entropy += num[f].entropy_bits;
+        if (num[f].deltas) {
+            series = 1;
+            delta_fixed += num[f].delta_bits < num[f].bits ? num[f].delta_bits : num[f].bits;
+            delta_entropy += num[f].delta_entropy_bits < num[f].entropy_bits ? num[f].delta_entropy_bits
+                                                                             : num[f].entropy_bits;
+        }
+    }
+    for (int f = 0; f < SYMBOL_FIELDS; f++) {
+        raw_strings += 8.0 * (str_len[f] + 1.0);  // length byte + text
+        dict += sym[f].bits;
+        entropy += sym[f].entropy_bits;
+        if (sym[f].deltas) {
+            double d = 1.0 + sym[f].changed * sym[f].bits;
+            delta_fixed += d < sym[f].bits ? d : sym[f].bits;
+            delta_entropy += sym[f].delta_entropy_bits < sym[f].entropy_bits ? sym[f].delta_entropy_bits
+                                                                             : sym[f].entropy_bits;
+        }
+    }
+    printf("  %-36s %8.1f B\n", "bit-packed, raw strings", (fixed + raw_strings) / 8.0);
+    printf("  %-36s %8.1f B\n", "bit-packed, string dictionaries", (fixed + dict) / 8.0);
+    printf("  %-36s %8.1f B\n", "per-field entropy bound", entropy / 8.0);
+    if (series) {
+        printf("  %-36s %8.1f B\n", "per-device delta, bit-packed", delta_fixed / 8.0);
+        printf("  %-36s %8.1f B\n", "per-device delta, entropy bound", delta_entropy / 8.0);
+    }
+    printf("Bit-packed figures quantize every field at the decimals above; dictionaries\n"
+           "and deltas assume state shared with the receiver (a keyframe per device).\n");
+}
+
+static int write_descriptor(const char *path, const char *source, size_t n, const field_stats_t *num,
+                            const field_stats_t *sym) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"source\": \"%s\",\n  \"records\": %zu,\n  \"fields\": [\n", source, n);
+    for (int i = 0; i < NUMERIC_FIELDS; i++) {
+        const field_stats_t *s = &num[i];
+        fprintf(f,
+                "    {\"name\": \"%s\", \"type\": \"numeric\", \"scale\": %.0f, \"offset\": %.*f, \"bits\": %u, "
+                "\"entropy_bits\": %.3f",
+                numeric_names[i], s->scale, s->decimals, s->min, s->bits, s->entropy_bits);
+        if (s->deltas) fprintf(f, ", \"delta_bits\": %u, \"delta_entropy_bits\": %.3f", s->delta_bits,
+                               s->delta_entropy_bits);
+        fprintf(f, "},\n");
+    }
+    for (int i = 0; i < SYMBOL_FIELDS; i++) {
+        const field_stats_t *s = &sym[i];
+        fprintf(f, "    {\"name\": \"%s\", \"type\": \"symbol\", \"distinct\": %zu, \"bits\": %u, \"entropy_bits\": %.3f",
+                symbol_names[i], s->distinct, s->bits, s->entropy_bits);
+        if (s->deltas) fprintf(f, ", \"changed\": %.4f", s->changed);
+        fprintf(f, "}%s\n", i + 1 < SYMBOL_FIELDS ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f);
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --records N       generated records (default 100000)\n"
+            "  --seed N          generator seed (default 1)\n"
+            "  --trace D         D devices sending drifting traces instead of independent records\n"
+            "  --interval S      trace uplink period, seconds (default 300)\n"
+            "  --packed FILE     u16 BE length-prefixed packed records\n"
+            "  --corpus FILE     struct-zlib or struct-rans payload corpus (corpus_build)\n"
+            "  --min-corr R      correlations to list (default 0.3)\n"
+            "  --top N           at most N correlations (default 10)\n"
+            "  --descriptor FILE recommended scale, offset and widths per field (JSON)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    profile_opts_t opt = { 100000, 1, 0, 300, NULL, NULL, 0.3, 10, NULL };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--trace")) opt.trace_devices = (size_t)atol(v);
+        else if (!strcmp(a, "--interval")) opt.interval_s = (uint32_t)atol(v);
+        else if (!strcmp(a, "--packed")) opt.packed = v;
+        else if (!strcmp(a, "--corpus")) opt.corpus = v;
+        else if (!strcmp(a, "--min-corr")) opt.min_corr = atof(v);
+        else if (!strcmp(a, "--top")) opt.top = (size_t)atol(v);
+        else if (!strcmp(a, "--descriptor")) opt.descriptor = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.records == 0 || (opt.packed && opt.corpus)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    record_list_t list = { 0 };
+    char source[256];
+    int rc;
+    if (opt.packed) {
+        rc = load_packed(&list, opt.packed);
+        snprintf(source, sizeof(source), "%s", opt.packed);
+    } else if (opt.corpus) {
+        rc = load_corpus(&list, opt.corpus);
+        snprintf(source, sizeof(source), "%s", opt.corpus);
+    } else {
+        rc = load_generated(&list, &opt);
+        if (opt.trace_devices)
+            snprintf(source, sizeof(source), "trace, %zu devices, %u s, seed %llu", opt.trace_devices,
+                     opt.interval_s, (unsigned long long)opt.seed);
+        else
+            snprintf(source, sizeof(source), "generator, seed %llu", (unsigned long long)opt.seed);
+    }
+    if (rc != 0 || list.n == 0) {
+        fprintf(stderr, "no records\n");
+        free(list.v);
+        return 1;
+    }
+
+    size_t n = list.n, devices = 0;
+    double *cols[NUMERIC_FIELDS];
+    uint64_t *syms[SYMBOL_FIELDS];
+    double str_len[SYMBOL_FIELDS] = { 0 };
+    for (int f = 0; f < NUMERIC_FIELDS; f++) cols[f] = malloc(n * sizeof(double));
+    for (int f = 0; f < SYMBOL_FIELDS; f++) syms[f] = malloc(n * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) {
+        double v[NUMERIC_FIELDS];
+        numeric_values(&list.v[i], v);
+        for (int f = 0; f < NUMERIC_FIELDS; f++) cols[f][i] = v[f];
+        for (int f = 0; f < SYMBOL_FIELDS; f++) {
+            const char *s = symbol_value(&list.v[i], f);
+            syms[f][i] = field_stats_hash(s);
+            str_len[f] += strlen(s);
+        }
+    }
+    for (int f = 0; f < SYMBOL_FIELDS; f++) str_len[f] /= n;
+    int64_t *prev = link_series(syms[S_MSISDN], n, &devices);
+
+    // A device seen once has no deltas; so does a corpus where every record is a new device
+    const int64_t *series = devices < n ? prev : NULL;
+    field_stats_t num[NUMERIC_FIELDS], sym[SYMBOL_FIELDS];
+    for (int f = 0; f < NUMERIC_FIELDS; f++) field_stats_numeric(cols[f], n, series, is_float32(f), &num[f]);
+    for (int f = 0; f < SYMBOL_FIELDS; f++) field_stats_symbols(syms[f], n, series, &sym[f]);
+
+    printf("Field profile: %zu records, %zu devices (%s)\n\n", n, devices, source);
+    print_fields(num, sym);
+    print_correlations(cols, n, &opt);
+    print_sizes(&list, num, sym, str_len);
+
+    int status = 0;
+    if (opt.descriptor && write_descriptor(opt.descriptor, source, n, num, sym) != 0) status = 1;
+
+    for (int f = 0; f < NUMERIC_FIELDS; f++) free(cols[f]);
+    for (int f = 0; f < SYMBOL_FIELDS; f++) free(syms[f]);
+    free(prev);
+    free(list.v);
+    return status;
+}
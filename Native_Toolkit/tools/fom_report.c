@@ -0,0 +1,377 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Figure-of-Merit report (common/fom.h) per codec and link profile.
+//
+// Runs come from loadgen --json summaries, from a CSV of earlier results,
+// or from --generate, which encodes fresh records with every codec (one
+// seed per run) and times the encoder. Each link scores the codecs against
+// --baseline with 95 % intervals over the runs. --csv appends, one row per
+// link and codec tagged with --label, so the file tracks the FoM across
+// codec changes.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "container_codecs.h"
+#include "container_record.h"
+#include "fom.h"
+
+#define MAX_RUNS 4096
+#define MAX_CODECS 32
+
+typedef struct {
+    const link_profile_t *links[LINK_PROFILE_COUNT];
+    size_t link_count;
+    double loss;                          // < 0 keeps the profile's
+    const char *baseline;
+    fom_weights_t weights;
+    unsigned generate;
+    size_t records;
+    uint64_t seed;
+    const char *label;
+    const char *csv;
+    const char *json;
+} report_opts_t;
+
+static fom_run_t runs[MAX_RUNS];
+static size_t run_count;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static fom_run_t *new_run(const char *codec) {
+    if (run_count == MAX_RUNS) return NULL;
+    fom_run_t *r = &runs[run_count++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->codec, sizeof(r->codec), "%s", codec);
+    r->cpu_us = -1.0;
+    return r;
+}
+
+// ================= INPUT =================
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    rewind(f);
+    char *buf = len >= 0 ? malloc((size_t)len + 1) : NULL;
+    if (buf && fread(buf, 1, (size_t)len, f) == (size_t)len) {
+        buf[len] = '\0';
+    } else {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+
+// Value of "key" after the first occurrence of "within" (NULL: anywhere).
+// Enough for loadgen's flat summary, not a general JSON parser.
+static const char *json_value(const char *doc, const char *within, const char *key) {
+    char quoted[64];
+    if (within) {
+        snprintf(quoted, sizeof(quoted), "\"%s\"", within);
+        doc = strstr(doc, quoted);
+        if (!doc) return NULL;
+        doc += strlen(quoted);
+    }
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    const char *p = strstr(doc, quoted);
+    if (!p || !(p = strchr(p + strlen(quoted), ':'))) return NULL;
+    for (p++; *p == ' ' || *p == '\t' || *p == '\n'; p++) {}
+    return p;
+}
+
+static int load_loadgen(const char *path) {
+    char *doc = read_file(path);
+    if (!doc) {
+        perror(path);
+        return -1;
+    }
+    const char *codec = json_value(doc, NULL, "codec"), *bytes = json_value(doc, NULL, "payload_mean_bytes");
+    const char *ok = json_value(doc, NULL, "status_2xx"), *total = json_value(doc, NULL, "scheduled");
+    const char *latency = json_value(doc, "latency_ms", "mean");
+    fom_run_t *r = NULL;
+    if (codec && *codec == '"' && bytes && ok && total) {
+        char name[FOM_CODEC_MAX] = "";
+        sscanf(codec + 1, "%23[^\"]", name);
+        if ((r = new_run(name)) != NULL) {
+            r->payload_bytes = strtod(bytes, NULL);
+            r->ok = strtoull(ok, NULL, 10);
+            r->total = strtoull(total, NULL, 10);
+            r->latency_ms = latency ? strtod(latency, NULL) : 0.0;
+        }
+    }
+    free(doc);
+    if (!r) fprintf(stderr, "%s: not a loadgen summary\n", path);
+    return r ? 0 : -1;
+}
+
+// Header row names the columns: codec and bytes are required; latency_ms,
+// ok, total and cpu_us are optional. Lines starting with '#' are skipped.
+static int load_csv(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    enum { C_CODEC, C_BYTES, C_LATENCY, C_OK, C_TOTAL, C_CPU, C_COUNT };
+    static const char *names[C_COUNT] = { "codec", "bytes", "latency_ms", "ok", "total", "cpu_us" };
+    int col[C_COUNT] = { -1, -1, -1, -1, -1, -1 };
+    char line[1024];
+    int header = 1, rc = 0;
+    unsigned lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!line[0] || line[0] == '#') continue;
+        char *fields[32];
+        int nf = 0;
+        for (char *save = NULL, *tok = strtok_r(line, ",", &save); tok && nf < 32; tok = strtok_r(NULL, ",", &save)) {
+            fields[nf++] = tok;
+        }
+        if (header) {
+            for (int i = 0; i < nf; i++) {
+                for (int c = 0; c < C_COUNT; c++) {
+                    if (!strcmp(fields[i], names[c]) || (c == C_BYTES && !strcmp(fields[i], "payload_bytes"))) col[c] = i;
+                }
+            }
+            if (col[C_CODEC] < 0 || col[C_BYTES] < 0) {
+                fprintf(stderr, "%s: header needs codec and bytes columns\n", path);
+                rc = -1;
+                break;
+            }
+            header = 0;
+            continue;
+        }
+        if (col[C_CODEC] >= nf || col[C_BYTES] >= nf) {
+            fprintf(stderr, "%s:%u: short row\n", path, lineno);
+            rc = -1;
+            break;
+        }
+        fom_run_t *r = new_run(fields[col[C_CODEC]]);
+        if (!r) {
+            fprintf(stderr, "%s: more than %d runs\n", path, MAX_RUNS);
+            rc = -1;
+            break;
+        }
+        r->payload_bytes = atof(fields[col[C_BYTES]]);
+        r->latency_ms = col[C_LATENCY] >= 0 && col[C_LATENCY] < nf ? atof(fields[col[C_LATENCY]]) : 0.0;
+        r->ok = col[C_OK] >= 0 && col[C_OK] < nf ? strtoull(fields[col[C_OK]], NULL, 10) : 1;
+        r->total = col[C_TOTAL] >= 0 && col[C_TOTAL] < nf ? strtoull(fields[col[C_TOTAL]], NULL, 10) : r->ok;
+        r->cpu_us = col[C_CPU] >= 0 && col[C_CPU] < nf ? atof(fields[col[C_CPU]]) : -1.0;
+    }
+    fclose(f);
+    return rc;
+}
+
+// One run per codec and seed: mean encoded size and encode time per record
+static int generate(const report_opts_t *opt) {
+    for (unsigned g = 0; g < opt->generate; g++) {
+        for (int c = 0; c < CONTAINER_CODEC_COUNT; c++) {
+            fom_run_t *r = new_run(container_codec_name((container_codec_t)c));
+            if (!r) return -1;
+            container_record_gen_t gen;
+            container_record_gen_init(&gen, opt->seed + g, 1735689600, 3600);
+            size_t total = 0, bad = 0;
+            double encode_s = 0.0;
+            for (size_t i = 0; i < opt->records; i++) {
+                container_record_t rec;
+                uint8_t buf[CONTAINER_CODEC_MAX_PAYLOAD];
+                container_record_generate(&gen, &rec);
+                double t0 = now_s();
+                size_t n = container_codec_encode((container_codec_t)c, &rec, buf, sizeof(buf));
+                encode_s += now_s() - t0;
+                total += n;
+                bad += n == 0;
+            }
+            r->payload_bytes = (double)total / opt->records;
+            r->ok = opt->records - bad;
+            r->total = opt->records;
+            r->cpu_us = encode_s * 1e6 / opt->records;
+        }
+    }
+    return 0;
+}
+
+// ================= OUTPUT =================
+static void print_link(const link_profile_t *l, const fom_result_t *res, int n, const report_opts_t *opt) {
+    printf("\n%s: %.0f bps, MTU %.0f B, %.0f B/frame overhead, %.1f %% frame loss; baseline %s\n", l->name,
+           l->bitrate_bps, l->mtu_bytes, l->frame_overhead_bytes, 100.0 * l->frame_loss, opt->baseline);
+    printf("%-12s %5s %8s %7s %10s %9s %8s %8s %19s %5s\n", "Codec", "Runs", "Bytes", "Frames", "Time ms",
+           "Success", "CPU us", "FoM", "95 % CI", "Rank");
+    for (int i = 0; i < n; i++) {
+        const fom_result_t *r = &res[i];
+        char cpu[16] = "–";
+        if (r->cpu_us.mean >= 0.0) snprintf(cpu, sizeof(cpu), "%.3f", r->cpu_us.mean);
+        printf("%-12s %5u %8.1f %7.1f %10.2f %8.2f%% %8s %8.4f  [%7.4f, %7.4f] %5d\n", r->codec, r->fom.n,
+               r->bytes.mean, r->frames.mean, r->time_ms.mean, 100.0 * r->success.mean, cpu, r->fom.mean,
+               r->fom.ci_lo, r->fom.ci_hi, r->rank);
+    }
+}
+
+static void csv_rows(FILE *f, const fom_result_t *res, int n, const report_opts_t *opt) {
+    for (int i = 0; i < n; i++) {
+        const fom_result_t *r = &res[i];
+        fprintf(f, "%s,%s,%s,%s,%u,%.3f,%.3f,%.4f,%.4f,%.6f,%.6f,%.6f,%.4f,%.6f,%.6f,%.6f,%d\n", opt->label,
+                r->link->name, opt->baseline, r->codec, r->fom.n, r->bytes.mean, r->frames.mean, r->time_ms.mean,
+                r->time_ms.ci_hi - r->time_ms.mean, r->success.mean, r->success.ci_lo, r->success.ci_hi,
+                r->cpu_us.mean, r->fom.mean, r->fom.ci_lo, r->fom.ci_hi, r->rank);
+    }
+}
+
+static void json_stat(FILE *f, const char *name, const fom_stat_t *s, const char *sep) {
+    fprintf(f, "\"%s\": { \"mean\": %.6f, \"stddev\": %.6f, \"ci95\": [%.6f, %.6f] }%s", name, s->mean, s->stddev,
+            s->ci_lo, s->ci_hi, sep);
+}
+
+static void json_link(FILE *f, const link_profile_t *l, const fom_result_t *res, int n, int last) {
+    fprintf(f, "    { \"link\": \"%s\", \"bitrate_bps\": %.1f, \"mtu_bytes\": %.0f, \"frame_overhead_bytes\": %.1f, "
+               "\"frame_loss\": %.6f,\n      \"codecs\": [\n",
+            l->name, l->bitrate_bps, l->mtu_bytes, l->frame_overhead_bytes, l->frame_loss);
+    for (int i = 0; i < n; i++) {
+        const fom_result_t *r = &res[i];
+        fprintf(f, "        { \"codec\": \"%s\", \"runs\": %u, \"rank\": %d,\n          ", r->codec, r->fom.n, r->rank);
+        json_stat(f, "bytes", &r->bytes, ", ");
+        json_stat(f, "frames", &r->frames, ",\n          ");
+        json_stat(f, "time_ms", &r->time_ms, ", ");
+        json_stat(f, "success", &r->success, ",\n          ");
+        if (r->cpu_us.mean >= 0.0) json_stat(f, "cpu_us", &r->cpu_us, ", ");
+        json_stat(f, "fom", &r->fom, "");
+        fprintf(f, " }%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "      ] }%s\n", last ? "" : ",");
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--loadgen FILE]... [--runs FILE]... [--generate N] [options]\n"
+            "  --loadgen FILE      loadgen --json summary, one run (repeatable)\n"
+            "  --runs FILE         CSV with codec,bytes[,latency_ms,ok,total,cpu_us] columns (repeatable)\n"
+            "  --generate N        N runs per codec from the record generator, one seed each\n"
+            "  --records N         records per generated run (default 10000)\n"
+            "  --seed N            first generator seed (default 1)\n"
+            "  --link LIST         astrocast, lora-sf7..12, nbiot, wifi-udp, or all (default all)\n"
+            "  --loss P            per-frame loss for every link (default: the profile's)\n"
+            "  --baseline CODEC    codec scored 1.0 (default: the first one read)\n"
+            "  --weights S,B,T,C   exponents for success, bytes, time, CPU (default 1,1,1,0)\n"
+            "  --label TEXT        tag for the CSV rows, e.g. a commit (default: UTC time)\n"
+            "  --csv FILE          append one row per link and codec\n"
+            "  --json FILE         full report\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    report_opts_t opt = { .loss = -1.0, .weights = FOM_DEFAULT_WEIGHTS, .records = 10000, .seed = 1 };
+    const char *links = "all";
+    char label[32];
+    time_t now = time(NULL);
+    strftime(label, sizeof(label), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    opt.label = label;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--loadgen")) { if (load_loadgen(v) != 0) return 1; }
+        else if (!strcmp(a, "--runs")) { if (load_csv(v) != 0) return 1; }
+        else if (!strcmp(a, "--generate")) opt.generate = (unsigned)atoi(v);
+        else if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--link")) links = v;
+        else if (!strcmp(a, "--loss")) opt.loss = atof(v);
+        else if (!strcmp(a, "--baseline")) opt.baseline = v;
+        else if (!strcmp(a, "--weights")) {
+            if (sscanf(v, "%lf,%lf,%lf,%lf", &opt.weights.success, &opt.weights.size, &opt.weights.time,
+                       &opt.weights.cpu) != 4) { usage(argv[0]); return 2; }
+        }
+        else if (!strcmp(a, "--label")) opt.label = v;
+        else if (!strcmp(a, "--csv")) opt.csv = v;
+        else if (!strcmp(a, "--json")) opt.json = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.records == 0 || opt.loss >= 1.0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.generate && generate(&opt) != 0) {
+        fprintf(stderr, "more than %d runs\n", MAX_RUNS);
+        return 1;
+    }
+    if (run_count == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!opt.baseline) opt.baseline = runs[0].codec;
+
+    if (!strcmp(links, "all")) {
+        for (size_t l = 0; l < LINK_PROFILE_COUNT; l++) opt.links[opt.link_count++] = &LINK_PROFILES[l];
+    } else {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%s", links);
+        for (char *save = NULL, *tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+            const link_profile_t *l = link_profile_find(tok);
+            if (!l || opt.link_count == LINK_PROFILE_COUNT) {
+                fprintf(stderr, "unknown link: %s\n", tok);
+                return 2;
+            }
+            opt.links[opt.link_count++] = l;
+        }
+    }
+
+    FILE *csv = NULL, *json = NULL;
+    if (opt.csv) {
+        csv = fopen(opt.csv, "a");
+        if (!csv) { perror(opt.csv); return 1; }
+        if (ftell(csv) == 0) {
+            fprintf(csv, "label,link,baseline,codec,runs,bytes,frames,time_ms,time_ci95,success,success_lo,"
+                         "success_hi,cpu_us,fom,fom_lo,fom_hi,rank\n");
+        }
+    }
+    if (opt.json) {
+        json = fopen(opt.json, "w");
+        if (!json) { perror(opt.json); if (csv) fclose(csv); return 1; }
+        fprintf(json, "{\n  \"label\": \"%s\",\n  \"baseline\": \"%s\",\n", opt.label, opt.baseline);
+        fprintf(json, "  \"weights\": { \"success\": %.3f, \"bytes\": %.3f, \"time\": %.3f, \"cpu\": %.3f },\n",
+                opt.weights.success, opt.weights.size, opt.weights.time, opt.weights.cpu);
+        fprintf(json, "  \"runs\": %zu,\n  \"links\": [\n", run_count);
+    }
+
+    printf("Figure of Merit = success^%.2g x (B0/bytes)^%.2g x (T0/time)^%.2g x (C0/cpu)^%.2g, %zu runs\n",
+           opt.weights.success, opt.weights.size, opt.weights.time, opt.weights.cpu, run_count);
+    int rc = 0;
+    for (size_t l = 0; l < opt.link_count; l++) {
+        link_profile_t link = *opt.links[l];
+        if (opt.loss >= 0.0) link.frame_loss = opt.loss;
+        static fom_result_t res[MAX_CODECS];
+        int n = fom_compute(runs, run_count, &link, opt.baseline, &opt.weights, res, MAX_CODECS);
+        if (n < 0) {
+            fprintf(stderr, "no runs for baseline %s%s\n", opt.baseline,
+                    opt.weights.cpu != 0.0 ? ", or a run without cpu_us" : "");
+            rc = 1;
+            break;
+        }
+        print_link(&link, res, n, &opt);
+        if (csv) csv_rows(csv, res, n, &opt);
+        if (json) json_link(json, &link, res, n, l + 1 == opt.link_count);
+    }
+    if (csv && fclose(csv) != 0) { fprintf(stderr, "%s: %s\n", opt.csv, strerror(errno)); rc = 1; }
+    if (json) {
+        fprintf(json, "  ]\n}\n");
+        fclose(json);
+    }
+    return rc;
+}
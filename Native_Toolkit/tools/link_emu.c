@@ -0,0 +1,710 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Userspace link emulator: a TCP and UDP proxy that puts a TN/NTN link
+// (common/link_shaper.h) between the senders and a receiver.
+//
+//   sender --> listen port --[uplink shaper]--> target
+//   sender <-- listen port <-[downlink shaper]-- target
+//
+// Each direction is one shared link: every connection and datagram
+// through the emulator competes for the same bit rate and contact
+// windows. TCP data is cut into MTU-sized segments that are delayed,
+// never lost (losses cost retransmission time, in order per connection),
+// and a sender is not read while its direction's queue is full, so
+// backpressure reaches it as it would on the real link. UDP datagrams
+// are lost, tail-dropped at a full queue, and may be reordered by jitter.
+// One epoll thread; Linux only.
+
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "link_shaper.h"
+
+#define MAX_LISTENERS 16
+#define MAX_SESSIONS 4096
+#define READ_CHUNK 65536
+#define UDP_IDLE_S 120.0
+#define TCP_SEGMENT_MAX 1460
+
+enum { UP = 0, DOWN = 1 };
+enum { TAG_LISTEN_TCP, TAG_LISTEN_UDP, TAG_TCP, TAG_UDP };
+
+typedef struct {
+    int type;
+    void *obj;
+    int side;                             // TCP: 0 client, 1 target
+} ep_tag_t;
+
+typedef struct {
+    ep_tag_t tag;
+    int fd;
+    int udp;
+    struct sockaddr_storage target;
+    socklen_t target_len;
+    char spec[128];
+} listener_t;
+
+// Direction d carries bytes read from fd[d] to fd[1 - d]
+typedef struct {
+    uint8_t *out;
+    size_t out_len, out_cap;
+    size_t in_flight;                     // scheduled, not yet due
+    double last_due;                      // in-order delivery
+    int eof_read, eof_due, shut;
+} tcp_dir_t;
+
+typedef struct tcp_conn {
+    ep_tag_t tag[2];
+    int fd[2];
+    int connecting;
+    int closed;
+    unsigned refs;                        // pending packets pointing here
+    uint32_t events[2];
+    tcp_dir_t dir[2];
+    struct tcp_conn *next_closed;
+} tcp_conn_t;
+
+typedef struct {
+    ep_tag_t tag;
+    listener_t *listener;
+    struct sockaddr_storage client;
+    socklen_t client_len;
+    int fd;                               // connected to the target
+    double last_active;
+    unsigned refs;
+    int used;
+} udp_session_t;
+
+typedef struct {
+    double due;
+    uint64_t seq;
+    int type;                             // TAG_TCP or TAG_UDP
+    int dir;
+    int eof;
+    void *owner;
+    size_t len;
+    uint8_t data[];
+} pending_t;
+
+typedef struct {
+    listener_t listeners[MAX_LISTENERS];
+    int listener_count;
+    link_shaper_config_t cfg;
+    double down_bitrate;                  // 0 = same as up
+    uint64_t seed;
+    double stats_s;
+} emu_opts_t;
+
+static int epfd;
+static link_shaper_t shapers[2];
+static pending_t **heap;
+static size_t heap_len, heap_cap;
+static uint64_t heap_seq;
+static udp_session_t sessions[MAX_SESSIONS];
+static volatile sig_atomic_t stop;
+static tcp_conn_t *closed_conns;
+static uint64_t tcp_accepted, tcp_closed_count, udp_sessions_opened;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop = 1;
+}
+
+// ================= PENDING HEAP =================
+static int before(const pending_t *a, const pending_t *b) {
+    return a->due < b->due || (a->due == b->due && a->seq < b->seq);
+}
+
+static int heap_push(pending_t *p) {
+    if (heap_len == heap_cap) {
+        size_t cap = heap_cap ? heap_cap * 2 : 1024;
+        pending_t **grown = realloc(heap, cap * sizeof(*heap));
+        if (!grown) return -1;
+        heap = grown;
+        heap_cap = cap;
+    }
+    p->seq = heap_seq++;
+    size_t i = heap_len++;
+    while (i > 0 && before(p, heap[(i - 1) / 2])) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = p;
+    return 0;
+}
+
+static pending_t *heap_pop(void) {
+    pending_t *top = heap[0], *last = heap[--heap_len];
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= heap_len) break;
+        if (c + 1 < heap_len && before(heap[c + 1], heap[c])) c++;
+        if (!before(heap[c], last)) break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    if (heap_len) heap[i] = last;
+    return top;
+}
+
+static pending_t *pending_new(int type, void *owner, int dir, const uint8_t *data, size_t len, double due) {
+    pending_t *p = malloc(sizeof(*p) + len);
+    if (!p) return NULL;
+    p->due = due;
+    p->type = type;
+    p->dir = dir;
+    p->eof = 0;
+    p->owner = owner;
+    p->len = len;
+    if (len) memcpy(p->data, data, len);
+    if (heap_push(p) != 0) {
+        free(p);
+        return NULL;
+    }
+    return p;
+}
+
+// ================= TCP =================
+static void tcp_update_events(tcp_conn_t *c, int side) {
+    if (c->closed) return;
+    tcp_dir_t *rd = &c->dir[side], *wr = &c->dir[1 - side];
+    uint32_t ev = 0;
+    if (!rd->eof_read && !(side == 1 && c->connecting) &&
+        rd->in_flight + rd->out_len < shapers[side].cfg.queue_bytes) {
+        ev |= EPOLLIN;
+    }
+    if (wr->out_len || (side == 1 && c->connecting)) ev |= EPOLLOUT;
+    if (ev != c->events[side]) {
+        struct epoll_event e = { .events = ev, .data.ptr = &c->tag[side] };
+        epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd[side], &e);
+        c->events[side] = ev;
+    }
+}
+
+// Closed connections are freed here, between epoll batches, once no
+// pending packet points at them; a later event in the same batch may
+// still name a connection that was just closed
+static void tcp_sweep(void) {
+    for (tcp_conn_t **pp = &closed_conns; *pp;) {
+        tcp_conn_t *c = *pp;
+        if (c->refs) {
+            pp = &c->next_closed;
+            continue;
+        }
+        *pp = c->next_closed;
+        for (int d = 0; d < 2; d++) free(c->dir[d].out);
+        free(c);
+    }
+}
+
+static void tcp_close(tcp_conn_t *c) {
+    if (c->closed) return;
+    for (int s = 0; s < 2; s++) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd[s], NULL);
+        close(c->fd[s]);
+    }
+    c->closed = 1;
+    c->next_closed = closed_conns;
+    closed_conns = c;
+    tcp_closed_count++;
+}
+
+// Writes direction d's buffer to fd[1 - d]; half-closes once its EOF is due
+static void tcp_flush(tcp_conn_t *c, int d) {
+    tcp_dir_t *dir = &c->dir[d];
+    if (c->closed || (d == UP && c->connecting)) return;
+    while (dir->out_len) {
+        ssize_t n = send(c->fd[1 - d], dir->out, dir->out_len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            tcp_close(c);
+            return;
+        }
+        memmove(dir->out, dir->out + n, dir->out_len - (size_t)n);
+        dir->out_len -= (size_t)n;
+    }
+    if (dir->eof_due && !dir->out_len && !dir->shut) {
+        shutdown(c->fd[1 - d], SHUT_WR);
+        dir->shut = 1;
+    }
+    if (c->dir[0].shut && c->dir[1].shut) {
+        tcp_close(c);
+        return;
+    }
+    tcp_update_events(c, 1 - d);
+    tcp_update_events(c, d);
+}
+
+static void tcp_read(tcp_conn_t *c, int side, double now) {
+    tcp_dir_t *dir = &c->dir[side];
+    link_shaper_t *sh = &shapers[side];
+    size_t segment = (size_t)sh->cfg.profile.mtu_bytes;
+    if (segment == 0 || segment > TCP_SEGMENT_MAX) segment = TCP_SEGMENT_MAX;
+    uint8_t buf[READ_CHUNK];
+    while (!c->closed && !dir->eof_read && dir->in_flight + dir->out_len < sh->cfg.queue_bytes) {
+        ssize_t n = recv(c->fd[side], buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) tcp_close(c);
+            break;
+        }
+        if (n == 0) {
+            dir->eof_read = 1;
+            pending_t *p = pending_new(TAG_TCP, c, side, NULL, 0, dir->last_due > now ? dir->last_due : now);
+            if (!p) { tcp_close(c); break; }
+            p->eof = 1;
+            c->refs++;
+            break;
+        }
+        for (size_t off = 0; off < (size_t)n; off += segment) {
+            size_t len = (size_t)n - off < segment ? (size_t)n - off : segment;
+            double due = link_shaper_segment(sh, now, len, &dir->last_due);
+            if (!pending_new(TAG_TCP, c, side, buf + off, len, due)) {
+                tcp_close(c);
+                return;
+            }
+            c->refs++;
+            dir->in_flight += len;
+        }
+    }
+    tcp_update_events(c, side);
+}
+
+static void tcp_deliver(pending_t *p) {
+    tcp_conn_t *c = p->owner;
+    c->refs--;
+    if (c->closed) return;
+    tcp_dir_t *dir = &c->dir[p->dir];
+    if (p->eof) {
+        dir->eof_due = 1;
+    } else {
+        if (dir->out_len + p->len > dir->out_cap) {
+            size_t cap = dir->out_cap ? dir->out_cap : 4096;
+            while (cap < dir->out_len + p->len) cap *= 2;
+            uint8_t *grown = realloc(dir->out, cap);
+            if (!grown) {
+                tcp_close(c);
+                return;
+            }
+            dir->out = grown;
+            dir->out_cap = cap;
+        }
+        memcpy(dir->out + dir->out_len, p->data, p->len);
+        dir->out_len += p->len;
+        dir->in_flight -= p->len;
+    }
+    tcp_flush(c, p->dir);
+}
+
+static void tcp_accept(listener_t *l) {
+    for (;;) {
+        int fd = accept4(l->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        int up = socket(l->target.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        tcp_conn_t *c = calloc(1, sizeof(*c));
+        if (up < 0 || !c) {
+            close(fd);
+            if (up >= 0) close(up);
+            free(c);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(up, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        c->fd[0] = fd;
+        c->fd[1] = up;
+        c->connecting = connect(up, (struct sockaddr *)&l->target, l->target_len) != 0;
+        if (c->connecting && errno != EINPROGRESS) {
+            close(fd);
+            close(up);
+            free(c);
+            continue;
+        }
+        for (int s = 0; s < 2; s++) {
+            c->tag[s] = (ep_tag_t){ TAG_TCP, c, s };
+            struct epoll_event e = { .events = 0, .data.ptr = &c->tag[s] };
+            epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd[s], &e);
+        }
+        tcp_accepted++;
+        tcp_update_events(c, 0);
+        tcp_update_events(c, 1);
+    }
+}
+
+static void tcp_event(tcp_conn_t *c, int side, uint32_t events, double now) {
+    if (side == 1 && c->connecting && (events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(c->fd[1], SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err) {
+            tcp_close(c);
+            return;
+        }
+        c->connecting = 0;
+        tcp_update_events(c, 0);
+    }
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) tcp_read(c, side, now);
+    if (!c->closed && (events & EPOLLOUT)) tcp_flush(c, 1 - side);
+}
+
+// ================= UDP =================
+static void udp_session_close(udp_session_t *s) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, s->fd, NULL);
+    close(s->fd);
+    s->used = 0;
+}
+
+static udp_session_t *udp_session(listener_t *l, const struct sockaddr_storage *from, socklen_t len, double now) {
+    udp_session_t *free_slot = NULL;
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        udp_session_t *s = &sessions[i];
+        if (!s->used) {
+            if (!free_slot) free_slot = s;
+            continue;
+        }
+        if (s->listener == l && s->client_len == len && !memcmp(&s->client, from, len)) return s;
+    }
+    if (!free_slot) return NULL;
+    int fd = socket(l->target.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return NULL;
+    if (connect(fd, (struct sockaddr *)&l->target, l->target_len) != 0) {
+        close(fd);
+        return NULL;
+    }
+    udp_session_t *s = free_slot;
+    memset(s, 0, sizeof(*s));
+    s->tag = (ep_tag_t){ TAG_UDP, s, 1 };
+    s->listener = l;
+    memcpy(&s->client, from, len);
+    s->client_len = len;
+    s->fd = fd;
+    s->last_active = now;
+    s->used = 1;
+    struct epoll_event e = { .events = EPOLLIN, .data.ptr = &s->tag };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &e);
+    udp_sessions_opened++;
+    return s;
+}
+
+static void udp_from_client(listener_t *l, double now) {
+    uint8_t buf[READ_CHUNK];
+    for (;;) {
+        struct sockaddr_storage from;
+        socklen_t len = sizeof(from);
+        ssize_t n = recvfrom(l->fd, buf, sizeof(buf), 0, (struct sockaddr *)&from, &len);
+        if (n < 0) return;
+        udp_session_t *s = udp_session(l, &from, len, now);
+        if (!s) continue;
+        s->last_active = now;
+        double due = link_shaper_datagram(&shapers[UP], now, (size_t)n);
+        if (due >= 0.0 && pending_new(TAG_UDP, s, UP, buf, (size_t)n, due)) s->refs++;
+    }
+}
+
+static void udp_from_target(udp_session_t *s, double now) {
+    uint8_t buf[READ_CHUNK];
+    for (;;) {
+        ssize_t n = recv(s->fd, buf, sizeof(buf), 0);
+        if (n < 0) return;
+        s->last_active = now;
+        double due = link_shaper_datagram(&shapers[DOWN], now, (size_t)n);
+        if (due >= 0.0 && pending_new(TAG_UDP, s, DOWN, buf, (size_t)n, due)) s->refs++;
+    }
+}
+
+static void udp_deliver(pending_t *p) {
+    udp_session_t *s = p->owner;
+    s->refs--;
+    if (!s->used) return;
+    if (p->dir == UP) send(s->fd, p->data, p->len, MSG_NOSIGNAL);
+    else sendto(s->listener->fd, p->data, p->len, 0, (struct sockaddr *)&s->client, s->client_len);
+}
+
+static void udp_expire(double now) {
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        udp_session_t *s = &sessions[i];
+        if (s->used && !s->refs && now - s->last_active > UDP_IDLE_S) udp_session_close(s);
+    }
+}
+
+// ================= SETUP =================
+static int resolve(const char *hostport, int passive, int udp, struct sockaddr_storage *out, socklen_t *len) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", hostport);
+    char *colon = strrchr(buf, ':');
+    const char *host = passive ? "127.0.0.1" : "localhost", *port = buf;
+    if (colon) {
+        *colon = '\0';
+        host = buf;
+        port = colon + 1;
+        if (host[0] == '[') {
+            host++;
+            buf[strlen(buf) - 1] = '\0';
+        }
+    }
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = udp ? SOCK_DGRAM : SOCK_STREAM,
+                              .ai_flags = passive ? AI_PASSIVE : 0 }, *res;
+    if (getaddrinfo(host, port, &hints, &res) != 0) return -1;
+    memcpy(out, res->ai_addr, res->ai_addrlen);
+    *len = res->ai_addrlen;
+    freeaddrinfo(res);
+    return 0;
+}
+
+// [ADDR:]PORT=HOST:PORT
+static int add_listener(emu_opts_t *opt, const char *spec, int udp) {
+    if (opt->listener_count == MAX_LISTENERS) return -1;
+    listener_t *l = &opt->listeners[opt->listener_count];
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    char *eq = strchr(buf, '=');
+    if (!eq) return -1;
+    *eq = '\0';
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    if (resolve(buf, 1, udp, &addr, &addr_len) != 0 || resolve(eq + 1, 0, udp, &l->target, &l->target_len) != 0) {
+        return -1;
+    }
+    l->fd = socket(addr.ss_family, (udp ? SOCK_DGRAM : SOCK_STREAM) | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (l->fd < 0 || setsockopt(l->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(l->fd, (struct sockaddr *)&addr, addr_len) != 0 || (!udp && listen(l->fd, 1024) != 0)) {
+        perror(spec);
+        if (l->fd >= 0) close(l->fd);
+        return -1;
+    }
+    l->udp = udp;
+    snprintf(l->spec, sizeof(l->spec), "%s %s", udp ? "udp" : "tcp", spec);
+    l->tag = (ep_tag_t){ udp ? TAG_LISTEN_UDP : TAG_LISTEN_TCP, l, 0 };
+    opt->listener_count++;
+    return 0;
+}
+
+// Shared by the command line and --profile-file; 0, or -1 if unknown
+static int apply_option(emu_opts_t *opt, const char *key, const char *v) {
+    link_shaper_config_t *c = &opt->cfg;
+    link_profile_t *p = &c->profile;
+    if (!strcmp(key, "profile")) {
+        const link_profile_t *base = link_profile_find(v);
+        if (!base) return -1;
+        *p = *base;
+    }
+    else if (!strcmp(key, "bitrate")) p->bitrate_bps = atof(v);
+    else if (!strcmp(key, "down-bitrate")) opt->down_bitrate = atof(v);
+    else if (!strcmp(key, "overhead")) p->frame_overhead_bytes = atof(v);
+    else if (!strcmp(key, "mtu")) p->mtu_bytes = atof(v);
+    else if (!strcmp(key, "loss")) p->frame_loss = atof(v);
+    else if (!strcmp(key, "burst")) c->mean_burst = atof(v);
+    else if (!strcmp(key, "latency")) p->latency_ms = atof(v);
+    else if (!strcmp(key, "jitter")) p->jitter_ms = atof(v);
+    else if (!strcmp(key, "latency-dist")) return link_shaper_delay_parse(v, &c->delay);
+    else if (!strcmp(key, "contact")) {
+        if (!strcmp(v, "0") || !strcmp(v, "off")) p->contact_period_s = p->contact_window_s = 0.0;
+        else if (sscanf(v, "%lf:%lf", &p->contact_period_s, &p->contact_window_s) != 2) return -1;
+    }
+    else if (!strcmp(key, "contact-offset")) c->contact_offset_s = atof(v);
+    else if (!strcmp(key, "queue")) c->queue_bytes = atof(v);
+    else if (!strcmp(key, "rto")) c->rto_ms = atof(v);
+    else if (!strcmp(key, "mtu-drop")) c->drop_oversize = atoi(v) != 0;
+    else if (!strcmp(key, "seed")) opt->seed = strtoull(v, NULL, 10);
+    else if (!strcmp(key, "stats")) opt->stats_s = atof(v);
+    else return -1;
+    return 0;
+}
+
+// key = value lines, '#' comments; same keys as the options
+static int load_profile_file(emu_opts_t *opt, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[256];
+    unsigned lineno = 0;
+    int rc = 0;
+    while (rc == 0 && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char key[64], value[128];
+        line[strcspn(line, "#\r\n")] = '\0';
+        if (sscanf(line, " %63[^= ] = %127s", key, value) != 2) {
+            if (strspn(line, " \t") == strlen(line)) continue;
+            rc = -1;
+        } else {
+            rc = apply_option(opt, key, value);
+        }
+        if (rc) fprintf(stderr, "%s:%u: bad line\n", path, lineno);
+    }
+    fclose(f);
+    return rc;
+}
+
+// ================= STATS =================
+static void print_stats(double t, double now) {
+    double next;
+    int open = link_shaper_contact(&shapers[UP], now, &next);
+    printf("%8.1fs", t);
+    for (int d = 0; d < 2; d++) {
+        const link_shaper_stats_t *s = &shapers[d].stats;
+        printf("  %s %8llu pkt %9.1f KB lost %5llu drop %5llu rtx %5llu queue %7.1f KB", d ? "down" : "up",
+               (unsigned long long)s->packets, s->bytes / 1024.0, (unsigned long long)s->lost,
+               (unsigned long long)(s->queue_drops + s->oversize_drops), (unsigned long long)s->retransmits,
+               link_shaper_backlog(&shapers[d], now) / 1024.0);
+    }
+    if (isfinite(next)) printf("  link %s for %.1fs", open ? "open" : "closed", next - now);
+    printf("  tcp %llu/%llu udp %llu\n", (unsigned long long)(tcp_accepted - tcp_closed_count),
+           (unsigned long long)tcp_accepted, (unsigned long long)udp_sessions_opened);
+    fflush(stdout);
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s --tcp|--udp [ADDR:]PORT=HOST:PORT [...] [options]\n"
+            "  --tcp SPEC          proxy TCP from the listen port to the target (repeatable)\n"
+            "  --udp SPEC          proxy UDP datagrams, one session per client address (repeatable)\n"
+            "  --profile NAME      astrocast, lora-sf7..12, nbiot, wifi-udp (default nbiot)\n"
+            "  --profile-file FILE key = value overrides, same keys as the options below\n"
+            "  --bitrate BPS       uplink rate\n"
+            "  --down-bitrate BPS  downlink rate (default: the uplink's)\n"
+            "  --overhead BYTES    per frame\n"
+            "  --mtu BYTES         largest frame payload\n"
+            "  --mtu-drop 1        drop datagrams above the MTU instead of fragmenting\n"
+            "  --loss P            per-frame loss\n"
+            "  --burst N           mean loss burst in frames (default 1, independent)\n"
+            "  --latency MS        one-way delay\n"
+            "  --jitter MS         spread of the delay\n"
+            "  --latency-dist D    const, uniform, normal, pareto (default normal)\n"
+            "  --contact P:W       W-second windows every P seconds, 'off' for always\n"
+            "  --contact-offset S  time of the first window (default 0, at start)\n"
+            "  --queue BYTES       per-direction queue before drops/backpressure (default 262144)\n"
+            "  --rto MS            TCP retransmission delay per lost segment (default max(200, 3x delay))\n"
+            "  --seed N            loss and delay seed (default 1)\n"
+            "  --stats S           status line interval, 0 for none (default 5)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    static emu_opts_t opt;
+    link_shaper_config_defaults(&opt.cfg, link_profile_find("nbiot"));
+    opt.seed = 1;
+    opt.stats_s = 5.0;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v || strncmp(a, "--", 2)) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--tcp") || !strcmp(a, "--udp")) {
+            if (add_listener(&opt, v, a[2] == 'u') != 0) {
+                fprintf(stderr, "bad listener: %s\n", v);
+                return 2;
+            }
+        } else if (!strcmp(a, "--profile-file")) {
+            if (load_profile_file(&opt, v) != 0) return 2;
+        } else if (apply_option(&opt, a + 2, v) != 0) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    const link_profile_t *p = &opt.cfg.profile;
+    if (opt.listener_count == 0 || p->bitrate_bps <= 0.0 || p->mtu_bytes < 1.0 || p->frame_loss < 0.0 ||
+        p->frame_loss >= 1.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    link_shaper_config_t down = opt.cfg;
+    if (opt.down_bitrate > 0.0) down.profile.bitrate_bps = opt.down_bitrate;
+    double t0 = now_s();
+    opt.cfg.contact_offset_s += t0;
+    down.contact_offset_s += t0;
+    link_shaper_init(&shapers[UP], &opt.cfg, opt.seed);
+    link_shaper_init(&shapers[DOWN], &down, opt.seed ^ 0x5DEECE66Dull);
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    for (int i = 0; i < opt.listener_count; i++) {
+        listener_t *l = &opt.listeners[i];
+        struct epoll_event e = { .events = EPOLLIN, .data.ptr = &l->tag };
+        epoll_ctl(epfd, EPOLL_CTL_ADD, l->fd, &e);
+        printf("%s\n", l->spec);
+    }
+    printf("link %s: %.0f/%.0f bps, MTU %.0f B, %.0f B overhead, loss %.2f %% (burst %.1f), delay %.0f ms %s +-%.0f",
+           p->name, p->bitrate_bps, down.profile.bitrate_bps, p->mtu_bytes, p->frame_overhead_bytes,
+           100.0 * p->frame_loss, opt.cfg.mean_burst, p->latency_ms, link_shaper_delay_name(opt.cfg.delay),
+           p->jitter_ms);
+    if (p->contact_period_s > 0.0) printf(", contact %.0f s every %.0f s", p->contact_window_s, p->contact_period_s);
+    printf("\n");
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    double next_stats = opt.stats_s > 0.0 ? t0 + opt.stats_s : INFINITY, next_expire = t0 + UDP_IDLE_S;
+    while (!stop) {
+        double now = now_s();
+        while (heap_len && heap[0]->due <= now) {
+            pending_t *pk = heap_pop();
+            if (pk->type == TAG_TCP) tcp_deliver(pk);
+            else udp_deliver(pk);
+            free(pk);
+        }
+        if (now >= next_stats) {
+            print_stats(now - t0, now);
+            next_stats += opt.stats_s;
+        }
+        if (now >= next_expire) {
+            udp_expire(now);
+            next_expire = now + UDP_IDLE_S / 4;
+        }
+
+        double wake = fmin(next_stats, next_expire);
+        if (heap_len && heap[0]->due < wake) wake = heap[0]->due;
+        int timeout_ms = (int)ceil((wake - now) * 1000.0);
+        if (timeout_ms < 0) timeout_ms = 0;
+        if (timeout_ms > 1000) timeout_ms = 1000;
+
+        struct epoll_event events[256];
+        int n = epoll_wait(epfd, events, 256, timeout_ms);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+        now = now_s();
+        for (int i = 0; i < n; i++) {
+            ep_tag_t *tag = events[i].data.ptr;
+            switch (tag->type) {
+            case TAG_LISTEN_TCP: tcp_accept(tag->obj); break;
+            case TAG_LISTEN_UDP: udp_from_client(tag->obj, now); break;
+            case TAG_UDP: udp_from_target(tag->obj, now); break;
+            case TAG_TCP: {
+                tcp_conn_t *c = tag->obj;
+                if (!c->closed) tcp_event(c, tag->side, events[i].events, now);
+                break;
+            }
+            }
+        }
+        tcp_sweep();
+    }
+    print_stats(now_s() - t0, now_s());
+    return 0;
+}
@@ -0,0 +1,475 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Open-loop load generator for the /container-data endpoints.
+//
+// Replaces the closed-loop Locust users (wait_time between 1 and 3 s,
+// one Python process per core) for capacity work: a fixed offered rate is
+// spread over epoll threads holding thousands of keep-alive connections,
+// and latency is measured from the intended send time, so queueing in the
+// receiver tier shows up in the percentiles instead of lowering the rate.
+// Payloads are generated with container_record and encoded with any of the
+// service codecs (codec/container_codecs.h) before the run starts, or taken
+// from a prebuilt corpus (tools/corpus_build, --corpus). The send
+// schedule follows one of the arrival models in common/arrival.h; --dry-run
+// prints the rate profile of a model without sending anything.
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arrival.h"
+#include "container_codecs.h"
+#include "container_record.h"
+#include "http_load.h"
+#include "payload_corpus.h"
+
+typedef struct {
+    char host[256];
+    uint16_t port;
+    char path[256];
+    container_codec_t codec;
+    const char *corpus;
+    int astrocast;
+    unsigned astrocast_batch;             // callbacks per request (JSON array when > 1)
+    double rate;
+    double fleet;
+    arrival_spec_t arrivals;
+    const char *trace;
+    int dry_run;
+    const char *rate_csv;
+    double duration_s;
+    double warmup_s;
+    unsigned threads;
+    unsigned connections;
+    double timeout_s;
+    size_t records;
+    uint64_t seed;
+    size_t backlog;
+    const char *hgrm;
+    const char *json;
+} loadgen_opts_t;
+
+static int parse_url(const char *url, loadgen_opts_t *opt) {
+    return http_load_parse_url(url, opt->host, sizeof(opt->host), &opt->port, opt->path, sizeof(opt->path));
+}
+
+// Bytes of a callback object around the base64 of a payload
+#define ASTROCAST_WRAP_MAX(len) (((len) + 2) / 3 * 4 + 96)
+
+// Astrocast callback body, as posted to /astrocast-callback
+static size_t astrocast_wrap(const uint8_t *payload, size_t len, size_t index, char *out, size_t cap) {
+    static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int n = snprintf(out, cap, "{\"guid\":\"loadgen-%zu\",\"deviceGuid\":\"loadgen-device-%zu\",\"data\":\"",
+                     index, index % 1000);
+    size_t o = (size_t)n;
+    if (n < 0 || o + (len + 2) / 3 * 4 + 3 > cap) return 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)payload[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)payload[i + 1] << 8;
+        if (i + 2 < len) v |= payload[i + 2];
+        out[o++] = b64[v >> 18];
+        out[o++] = b64[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? b64[(v >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? b64[v & 63] : '=';
+    }
+    out[o++] = '"';
+    out[o++] = '}';
+    return o;
+}
+
+// Arrivals per 100 ms over the whole schedule, no network
+static int dry_run(const loadgen_opts_t *opt) {
+    double total_s = opt->warmup_s + opt->duration_s;
+    size_t bins = (size_t)(total_s * 10.0) + 1;
+    uint64_t *fine = calloc(bins, sizeof(uint64_t));
+    if (!fine) return 1;
+    uint64_t total = 0;
+    for (unsigned t = 0; t < opt->threads; t++) {
+        arrival_t a;
+        if (arrival_init(&a, &opt->arrivals, t, opt->threads) != 0) {
+            free(fine);
+            return 1;
+        }
+        double at;
+        while ((at = arrival_next(&a)) < total_s) {
+            fine[(size_t)(at * 10.0)]++;
+            total++;
+        }
+        arrival_free(&a);
+    }
+
+    size_t seconds = (size_t)ceil(total_s);
+    uint64_t *per_s = calloc(seconds, sizeof(uint64_t));
+    uint64_t *sorted = calloc(seconds, sizeof(uint64_t));
+    if (!per_s || !sorted) return 1;
+    uint64_t peak_fine = 0;
+    for (size_t b = 0; b < bins; b++) {
+        if (b / 10 < seconds) per_s[b / 10] += fine[b];
+        if (fine[b] > peak_fine) peak_fine = fine[b];
+    }
+    memcpy(sorted, per_s, seconds * sizeof(uint64_t));
+    // Insertion sort is enough for a few hours of seconds, descending
+    for (size_t i = 1; i < seconds; i++) {
+        uint64_t v = sorted[i];
+        size_t j = i;
+        while (j > 0 && sorted[j - 1] < v) { sorted[j] = sorted[j - 1]; j--; }
+        sorted[j] = v;
+    }
+    uint64_t top = 0;
+    size_t top_n = seconds / 10 ? seconds / 10 : 1;
+    for (size_t i = 0; i < top_n; i++) top += sorted[i];
+    size_t idle = 0;
+    for (size_t i = 0; i < seconds; i++) idle += per_s[i] == 0;
+
+    double mean = arrival_mean_rate(&opt->arrivals);
+    printf("Arrival model %s: %.0f devices, mean %.1f req/s (%.1f observed over %.0f s, %llu arrivals)\n",
+           arrival_model_name(opt->arrivals.model), opt->arrivals.fleet, mean, total / total_s, total_s,
+           (unsigned long long)total);
+    printf("Peak 1 s rate      %10llu req/s (%.1fx mean)\n", (unsigned long long)sorted[0],
+           mean > 0.0 ? sorted[0] / mean : 0.0);
+    printf("p99 1 s rate       %10llu req/s\n", (unsigned long long)sorted[seconds / 100]);
+    printf("Peak 100 ms rate   %10llu req/s (%.1fx mean)\n", (unsigned long long)peak_fine * 10,
+           mean > 0.0 ? peak_fine * 10 / mean : 0.0);
+    printf("Busiest 10%% of seconds carry %.1f%% of the arrivals; %zu of %zu seconds are idle\n",
+           total ? 100.0 * top / total : 0.0, idle, seconds);
+
+    int rc = 0;
+    if (opt->rate_csv) {
+        FILE *f = fopen(opt->rate_csv, "w");
+        if (!f) {
+            perror(opt->rate_csv);
+            rc = 1;
+        } else {
+            fprintf(f, "second,arrivals\n");
+            for (size_t i = 0; i < seconds; i++) fprintf(f, "%zu,%llu\n", i, (unsigned long long)per_s[i]);
+            fclose(f);
+        }
+    }
+    free(fine);
+    free(per_s);
+    free(sorted);
+    return rc;
+}
+
+static void print_latency(const char *name, const hdr_histogram_t *h) {
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+    printf("%-10s", name);
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+        printf(" %10.3f", (double)hdr_value_at_percentile(h, percentiles[i]) / 1000.0);
+    }
+    printf(" %10.3f %10.3f\n", (double)h->max / 1000.0, hdr_mean(h) / 1000.0);
+}
+
+static int write_json(const char *path, const loadgen_opts_t *opt, const http_load_result_t *r, double payload_mean) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    const hdr_histogram_t *c = &r->corrected, *s = &r->service;
+    fprintf(f, "{\n  \"target\": \"http://%s:%u%s\",\n  \"codec\": \"%s\",\n", opt->host, opt->port, opt->path,
+            container_codec_name(opt->codec));
+    fprintf(f, "  \"arrivals\": \"%s\",\n  \"fleet\": %.0f,\n", arrival_model_name(opt->arrivals.model),
+            opt->arrivals.fleet);
+    fprintf(f, "  \"offered_rps\": %.3f,\n  \"achieved_rps\": %.3f,\n  \"duration_s\": %.3f,\n", opt->rate,
+            r->completed / r->elapsed_s, r->elapsed_s);
+    fprintf(f, "  \"threads\": %u,\n  \"connections\": %u,\n  \"payload_mean_bytes\": %.2f,\n", opt->threads,
+            opt->connections, payload_mean);
+    fprintf(f, "  \"scheduled\": %llu,\n  \"sent\": %llu,\n  \"completed\": %llu,\n",
+            (unsigned long long)r->scheduled, (unsigned long long)r->sent, (unsigned long long)r->completed);
+    fprintf(f, "  \"status_2xx\": %llu,\n  \"status_3xx\": %llu,\n  \"status_4xx\": %llu,\n  \"status_5xx\": %llu,\n"
+               "  \"status_429\": %llu,\n",
+            (unsigned long long)r->status_2xx, (unsigned long long)r->status_3xx, (unsigned long long)r->status_4xx,
+            (unsigned long long)r->status_5xx, (unsigned long long)r->status_429);
+    fprintf(f, "  \"errors\": %llu,\n  \"timeouts\": %llu,\n  \"dropped\": %llu,\n  \"connects\": %llu,\n",
+            (unsigned long long)r->errors, (unsigned long long)r->timeouts, (unsigned long long)r->dropped,
+            (unsigned long long)r->connects);
+    fprintf(f, "  \"max_backlog\": %zu,\n", r->max_backlog_seen);
+    const struct { const char *name; const hdr_histogram_t *h; } hists[] = { { "latency_ms", c }, { "service_ms", s } };
+    for (int i = 0; i < 2; i++) {
+        const hdr_histogram_t *h = hists[i].h;
+        fprintf(f, "  \"%s\": { \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"p9999\": %.3f, "
+                   "\"max\": %.3f, \"mean\": %.3f }%s\n",
+                hists[i].name, hdr_value_at_percentile(h, 50.0) / 1000.0, hdr_value_at_percentile(h, 90.0) / 1000.0,
+                hdr_value_at_percentile(h, 99.0) / 1000.0, hdr_value_at_percentile(h, 99.9) / 1000.0,
+                hdr_value_at_percentile(h, 99.99) / 1000.0, h->max / 1000.0, hdr_mean(h) / 1000.0, i ? "" : ",");
+    }
+    fprintf(f, "}\n");
+    fclose(f);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --url URL           target (default http://localhost:3000/container-data)\n"
+            "  --codec NAME        cbor, msgpack, protobuf, struct-zlib, struct-rans (default struct-zlib)\n"
+            "  --astrocast         send Astrocast callback JSON (base64 data) instead of raw payloads\n"
+            "  --astrocast-batch N callbacks per request, as a JSON array (default 1; implies --astrocast)\n"
+            "  --rate R            mean offered requests per second (default 1000)\n"
+            "  --arrivals MODEL    uniform, poisson, onoff, fleet-tick, satellite, diurnal, trace\n"
+            "  --fleet N           devices (default rate * period)\n"
+            "  --period S          per-device uplink period (default 300)\n"
+            "  --on S / --off S    onoff: mean ON / OFF length (default 10 / 50)\n"
+            "  --spread S          fleet-tick: initial phase spread (default 0, all in step)\n"
+            "  --jitter S          fleet-tick: lag per uplink, up to (default 1)\n"
+            "  --pass-interval S   satellite: time between passes (default 3600)\n"
+            "  --pass-jitter S     satellite: pass time +- (default 300)\n"
+            "  --dump S            satellite: callbacks of a pass spread over (default 60)\n"
+            "  --day S             diurnal: cycle length (default 86400)\n"
+            "  --amplitude A       diurnal: peak = mean * (1 + A) (default 0.5)\n"
+            "  --peak-at S         diurnal: peak offset in the cycle (default 43200)\n"
+            "  --trace FILE        trace: one timestamp (s) per line\n"
+            "  --trace-fleet N     trace: devices in the recording (default 1)\n"
+            "  --speedup X         trace: replay speed (default 1)\n"
+            "  --dry-run           print the arrival profile and exit\n"
+            "  --rate-csv FILE     dry run: arrivals per second\n"
+            "  --duration S        measured seconds (default 30)\n"
+            "  --warmup S          unrecorded seconds before (default 5)\n"
+            "  --threads N         epoll threads (default: online CPUs)\n"
+            "  --connections N     keep-alive connections, all threads (default 1000)\n"
+            "  --timeout S         per-request timeout (default 10)\n"
+            "  --records N         distinct pre-encoded payloads (default 10000, corpus: all)\n"
+            "  --corpus FILE       payloads from a corpus_build file instead of generating them\n"
+            "  --seed N            record generator seed (default 1)\n"
+            "  --backlog N         queued arrivals per thread before dropping (default 1000000)\n"
+            "  --hgrm FILE         corrected latency percentile distribution (ms)\n"
+            "  --json FILE         run summary\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    loadgen_opts_t opt = { .codec = CONTAINER_CODEC_STRUCT_ZLIB, .rate = 1000.0, .duration_s = 30.0, .warmup_s = 5.0,
+                           .threads = cpus > 0 ? (unsigned)cpus : 1, .connections = 1000, .timeout_s = 10.0,
+                           .records = 10000, .seed = 1, .backlog = 1000000 };
+    parse_url("http://localhost:3000/container-data", &opt);
+    arrival_spec_defaults(&opt.arrivals);
+    int records_set = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (!strcmp(a, "--astrocast")) { opt.astrocast = 1; continue; }
+        if (!strcmp(a, "--dry-run")) { opt.dry_run = 1; continue; }
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--url")) {
+            if (parse_url(v, &opt) != 0) { fprintf(stderr, "bad url: %s\n", v); return 2; }
+        } else if (!strcmp(a, "--codec")) {
+            if (container_codec_parse(v, &opt.codec) != 0) { fprintf(stderr, "unknown codec: %s\n", v); return 2; }
+        }
+        else if (!strcmp(a, "--arrivals")) {
+            if (arrival_model_parse(v, &opt.arrivals.model) != 0) { fprintf(stderr, "unknown model: %s\n", v); return 2; }
+        }
+        else if (!strcmp(a, "--astrocast-batch")) { opt.astrocast_batch = (unsigned)atoi(v); opt.astrocast = 1; }
+        else if (!strcmp(a, "--rate")) opt.rate = atof(v);
+        else if (!strcmp(a, "--fleet")) opt.fleet = atof(v);
+        else if (!strcmp(a, "--period")) opt.arrivals.period_s = atof(v);
+        else if (!strcmp(a, "--on")) opt.arrivals.on_s = atof(v);
+        else if (!strcmp(a, "--off")) opt.arrivals.off_s = atof(v);
+        else if (!strcmp(a, "--spread")) opt.arrivals.phase_spread_s = atof(v);
+        else if (!strcmp(a, "--jitter")) opt.arrivals.jitter_s = atof(v);
+        else if (!strcmp(a, "--pass-interval")) opt.arrivals.pass_interval_s = atof(v);
+        else if (!strcmp(a, "--pass-jitter")) opt.arrivals.pass_jitter_s = atof(v);
+        else if (!strcmp(a, "--dump")) opt.arrivals.dump_s = atof(v);
+        else if (!strcmp(a, "--day")) opt.arrivals.day_s = atof(v);
+        else if (!strcmp(a, "--amplitude")) opt.arrivals.amplitude = atof(v);
+        else if (!strcmp(a, "--peak-at")) opt.arrivals.peak_at_s = atof(v);
+        else if (!strcmp(a, "--trace")) opt.trace = v;
+        else if (!strcmp(a, "--trace-fleet")) opt.arrivals.trace_fleet = atof(v);
+        else if (!strcmp(a, "--speedup")) opt.arrivals.speedup = atof(v);
+        else if (!strcmp(a, "--rate-csv")) opt.rate_csv = v;
+        else if (!strcmp(a, "--duration")) opt.duration_s = atof(v);
+        else if (!strcmp(a, "--warmup")) opt.warmup_s = atof(v);
+        else if (!strcmp(a, "--threads")) opt.threads = (unsigned)atoi(v);
+        else if (!strcmp(a, "--connections")) opt.connections = (unsigned)atoi(v);
+        else if (!strcmp(a, "--timeout")) opt.timeout_s = atof(v);
+        else if (!strcmp(a, "--records")) { opt.records = (size_t)atol(v); records_set = 1; }
+        else if (!strcmp(a, "--corpus")) opt.corpus = v;
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--backlog")) opt.backlog = (size_t)atol(v);
+        else if (!strcmp(a, "--hgrm")) opt.hgrm = v;
+        else if (!strcmp(a, "--json")) opt.json = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.astrocast_batch == 0) opt.astrocast_batch = 1;
+    if (opt.rate <= 0.0 || opt.duration_s <= 0.0 || opt.records == 0 || opt.threads == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.connections < opt.threads) opt.connections = opt.threads;
+
+    // The fleet sets the rate; without --fleet the rate sets the fleet
+    double *trace = NULL;
+    opt.arrivals.seed = opt.seed;
+    if (opt.arrivals.model == ARRIVAL_TRACE) {
+        long n = opt.trace ? arrival_load_trace(opt.trace, &trace) : -1;
+        if (n <= 0) {
+            fprintf(stderr, "trace model needs a readable --trace file\n");
+            return 2;
+        }
+        opt.arrivals.trace = trace;
+        opt.arrivals.trace_len = (size_t)n;
+        opt.arrivals.fleet = opt.fleet > 0.0 ? opt.fleet : opt.arrivals.trace_fleet;
+    } else {
+        opt.arrivals.fleet = opt.fleet > 0.0 ? opt.fleet : opt.rate * opt.arrivals.period_s;
+    }
+    opt.rate = arrival_mean_rate(&opt.arrivals);
+    if (!(opt.rate > 0.0)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.dry_run) {
+        int rc = dry_run(&opt);
+        free(trace);
+        return rc;
+    }
+
+    long fd_limit = http_load_raise_fd_limit();
+    if (fd_limit > 0 && (long)opt.connections + 64 > fd_limit) {
+        fprintf(stderr, "warning: %u connections but the fd limit is %ld\n", opt.connections, fd_limit);
+    }
+
+    // Pre-encode the payload pool, or take it from the corpus
+    payload_corpus_t corpus = { 0 };
+    if (opt.corpus) {
+        if (payload_corpus_open(&corpus, opt.corpus) != 0) {
+            fprintf(stderr, "%s: %s\n", opt.corpus, errno == EINVAL ? "not a valid corpus" : strerror(errno));
+            return 1;
+        }
+        if (container_codec_parse(corpus.codec, &opt.codec) != 0) {
+            fprintf(stderr, "%s: unknown codec %s\n", opt.corpus, corpus.codec);
+            return 1;
+        }
+        if (!records_set || opt.records > corpus.count) opt.records = corpus.count;
+    }
+    http_load_request_t *requests = calloc(opt.records, sizeof(*requests));
+    uint8_t *pool = malloc(opt.records * CONTAINER_CODEC_MAX_PAYLOAD);
+    size_t *pool_len = calloc(opt.records, sizeof(*pool_len));
+    size_t body_cap = opt.astrocast_batch * ASTROCAST_WRAP_MAX(CONTAINER_CODEC_MAX_PAYLOAD) + 2;
+    char *body = malloc(body_cap);
+    if (!requests || !pool || !pool_len || !body) return 1;
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt.seed, time(NULL), 3600);
+    char host_header[300];
+    snprintf(host_header, sizeof(host_header), "%s:%u", opt.host, opt.port);
+    size_t payload_total = 0;
+    for (size_t r = 0; r < opt.records; r++) {
+        uint8_t *payload = pool + r * CONTAINER_CODEC_MAX_PAYLOAD;
+        size_t n;
+        if (opt.corpus) {
+            uint32_t len;
+            const uint8_t *stored = payload_corpus_get(&corpus, (uint32_t)r, &len);
+            n = len > CONTAINER_CODEC_MAX_PAYLOAD ? 0 : len;
+            memcpy(payload, stored, n);
+        } else {
+            container_record_t rec;
+            container_record_generate(&gen, &rec);
+            n = container_codec_encode(opt.codec, &rec, payload, CONTAINER_CODEC_MAX_PAYLOAD);
+        }
+        if (!n) {
+            fprintf(stderr, "failed to encode record %zu\n", r);
+            return 1;
+        }
+        pool_len[r] = n;
+        payload_total += n;
+    }
+    // A batched request r carries records r .. r + batch - 1, wrapping
+    for (size_t r = 0; r < opt.records; r++) {
+        const uint8_t *payload = pool + r * CONTAINER_CODEC_MAX_PAYLOAD;
+        size_t body_len = pool_len[r];
+        if (opt.astrocast && opt.astrocast_batch == 1) {
+            body_len = astrocast_wrap(payload, pool_len[r], r, body, body_cap);
+        } else if (opt.astrocast) {
+            body_len = 0;
+            body[body_len++] = '[';
+            for (unsigned k = 0; k < opt.astrocast_batch; k++) {
+                size_t j = (r + k) % opt.records;
+                size_t w = astrocast_wrap(pool + j * CONTAINER_CODEC_MAX_PAYLOAD, pool_len[j], r * opt.astrocast_batch + k,
+                                          body + body_len, body_cap - body_len - 1);
+                if (!w) {
+                    body_len = 0;
+                    break;
+                }
+                body_len += w;
+                body[body_len++] = k + 1 < opt.astrocast_batch ? ',' : ']';
+            }
+        }
+        if (!body_len || http_load_render_post(&requests[r], host_header, opt.path,
+                                               opt.astrocast ? "application/json" : "application/octet-stream",
+                                               NULL, opt.astrocast ? (const uint8_t *)body : payload,
+                                               body_len) != 0) {
+            fprintf(stderr, "failed to encode record %zu\n", r);
+            return 1;
+        }
+    }
+    free(body);
+    free(pool);
+    free(pool_len);
+    double payload_mean = (double)payload_total / opt.records;
+    payload_corpus_close(&corpus);
+
+    printf("Open-loop load: http://%s:%u%s, %s payloads (%.1f bytes mean, %zu distinct%s%s)\n", opt.host, opt.port,
+           opt.path, container_codec_name(opt.codec), payload_mean, opt.records, opt.corpus ? ", from " : "",
+           opt.corpus ? opt.corpus : "");
+    printf("Offered %.0f req/s mean (%s, %.0f devices) for %.0f s (+%.0f s warm-up), %u threads, %u connections\n\n",
+           opt.rate, arrival_model_name(opt.arrivals.model), opt.arrivals.fleet, opt.duration_s, opt.warmup_s,
+           opt.threads, opt.connections);
+    if (opt.astrocast_batch > 1) printf("%u Astrocast callbacks per request\n\n", opt.astrocast_batch);
+    fflush(stdout);
+
+    http_load_config_t cfg = {
+        .host = opt.host, .port = opt.port, .rate = opt.rate, .duration_s = opt.duration_s,
+        .arrivals = &opt.arrivals, .warmup_s = opt.warmup_s, .threads = opt.threads, .connections = opt.connections,
+        .timeout_s = opt.timeout_s, .max_backlog = opt.backlog, .requests = requests, .request_count = opt.records
+    };
+    http_load_result_t res;
+    if (http_load_run(&cfg, &res) != 0) {
+        fprintf(stderr, "load run failed (cannot resolve %s or set up threads)\n", opt.host);
+        return 1;
+    }
+
+    printf("Scheduled %llu, sent %llu, completed %llu (%.1f req/s)\n", (unsigned long long)res.scheduled,
+           (unsigned long long)res.sent, (unsigned long long)res.completed, res.completed / res.elapsed_s);
+    printf("Status 2xx %llu, 3xx %llu, 4xx %llu (429: %llu), 5xx %llu\n", (unsigned long long)res.status_2xx,
+           (unsigned long long)res.status_3xx, (unsigned long long)res.status_4xx,
+           (unsigned long long)res.status_429, (unsigned long long)res.status_5xx);
+    printf("Errors %llu, timeouts %llu, dropped %llu, connects %llu, max backlog %zu\n\n",
+           (unsigned long long)res.errors, (unsigned long long)res.timeouts, (unsigned long long)res.dropped,
+           (unsigned long long)res.connects, res.max_backlog_seen);
+    printf("%-10s %10s %10s %10s %10s %10s %10s %10s\n", "ms", "p50", "p90", "p99", "p99.9", "p99.99", "max", "mean");
+    print_latency("corrected", &res.corrected);
+    print_latency("service", &res.service);
+    if (res.corrected.saturated) {
+        printf("(%lld latencies above the histogram range)\n", (long long)res.corrected.saturated);
+    }
+
+    int rc = 0;
+    if (opt.hgrm) {
+        FILE *f = fopen(opt.hgrm, "w");
+        if (!f) {
+            perror(opt.hgrm);
+            rc = 1;
+        } else {
+            hdr_write_percentiles(&res.corrected, f, 5, 1000.0);
+            fclose(f);
+        }
+    }
+    if (opt.json && write_json(opt.json, &opt, &res, payload_mean) != 0) rc = 1;
+
+    http_load_result_free(&res);
+    for (size_t r = 0; r < opt.records; r++) http_load_free_request(&requests[r]);
+    free(requests);
+    free(trace);
+    return rc;
+}
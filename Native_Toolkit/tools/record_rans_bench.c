@@ -0,0 +1,278 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Static rANS vs. zlib on packed container records.
+//
+// Generates a held-out corpus (different seed and timestamps than the
+// training run), packs every record with the Struct+zlib layout and
+// compresses it with zlib level 9 (what the services send today), raw
+// deflate (zlib without header and Adler-32) and the trained rANS model.
+// Every payload is decoded and compared byte for byte. A corruption pass
+// flips single bits of rANS payloads: the decoder must stay in bounds, and
+// the share it cannot reject is reported (the format carries no checksum).
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "container_record.h"
+#include "record_rans.h"
+
+#define MAX_PAYLOAD_SIZE 158               // Struct_Zlib_Service limit
+
+typedef struct {
+    size_t records;
+    uint64_t seed;
+    uint32_t spread_s;
+    double seconds;
+    const char *csv;
+} bench_opts_t;
+
+typedef struct {
+    const char *name;
+    uint16_t *sizes;
+    double encode_ns;
+    double decode_ns;
+} backend_result_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int cmp_u16(const void *a, const void *b) {
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+// ================= BACK ENDS =================
+static size_t zlib_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    uLongf n = cap;
+    return compress2(out, &n, in, len, Z_BEST_COMPRESSION) == Z_OK ? (size_t)n : 0;
+}
+
+static size_t zlib_decode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    uLongf n = cap;
+    return uncompress(out, &n, in, len) == Z_OK ? (size_t)n : 0;
+}
+
+static size_t raw_deflate_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK) return 0;
+    z.next_in = (Bytef *)in;
+    z.avail_in = (uInt)len;
+    z.next_out = out;
+    z.avail_out = (uInt)cap;
+    int rc = deflate(&z, Z_FINISH);
+    size_t n = z.total_out;
+    deflateEnd(&z);
+    return rc == Z_STREAM_END ? n : 0;
+}
+
+static size_t raw_deflate_decode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, -15) != Z_OK) return 0;
+    z.next_in = (Bytef *)in;
+    z.avail_in = (uInt)len;
+    z.next_out = out;
+    z.avail_out = (uInt)cap;
+    int rc = inflate(&z, Z_FINISH);
+    size_t n = z.total_out;
+    inflateEnd(&z);
+    return rc == Z_STREAM_END ? n : 0;
+}
+
+static size_t rans_encode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    return record_rans_encode(in, len, out, cap);
+}
+
+static size_t rans_decode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    int n = record_rans_decode(in, len, out, cap);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+typedef size_t (*codec_fn)(const uint8_t *, size_t, uint8_t *, size_t);
+
+static const struct {
+    const char *name;
+    codec_fn encode;
+    codec_fn decode;
+} backends[] = {
+    { "zlib-9", zlib_encode, zlib_decode },
+    { "deflate-raw", raw_deflate_encode, raw_deflate_decode },
+    { "rans-static", rans_encode, rans_decode },
+};
+#define NUM_BACKENDS (sizeof(backends) / sizeof(backends[0]))
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --records N     held-out records (default 20000)\n"
+            "  --seed N        generator seed (default 7; training uses 1)\n"
+            "  --spread S      timestamp spread before now, seconds (default 3600)\n"
+            "  --seconds S     minimum time per speed measurement (default 0.5)\n"
+            "  --csv FILE      per-record sizes\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_opts_t opt = { 20000, 7, 3600, 0.5, NULL };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--spread")) opt.spread_s = (uint32_t)atol(v);
+        else if (!strcmp(a, "--seconds")) opt.seconds = atof(v);
+        else if (!strcmp(a, "--csv")) opt.csv = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+    if (opt.records == 0) { usage(argv[0]); return 2; }
+
+    // Held-out corpus
+    uint8_t (*packed)[CONTAINER_RECORD_STRUCT_MAX] = malloc(opt.records * sizeof(*packed));
+    uint16_t *packed_len = malloc(opt.records * sizeof(uint16_t));
+    uint8_t (*encoded)[256] = malloc(opt.records * sizeof(*encoded));
+    if (!packed || !packed_len || !encoded) return 1;
+
+    container_record_gen_t gen;
+    container_record_gen_init(&gen, opt.seed, time(NULL), opt.spread_s);
+    size_t packed_total = 0;
+    for (size_t r = 0; r < opt.records; r++) {
+        container_record_t rec;
+        container_record_generate(&gen, &rec);
+        packed_len[r] = (uint16_t)container_record_pack_struct(&rec, packed[r], sizeof(packed[r]));
+        packed_total += packed_len[r];
+    }
+    if (record_rans_decoder_init() != 0) return 1;
+
+    printf("Static rANS benchmark: %zu held-out records, %.1f bytes mean packed size, model v%u\n\n",
+           opt.records, (double)packed_total / opt.records, record_rans_model_version());
+    printf("%-12s %6s %5s %5s %5s %6s %7s %12s %12s\n", "Backend", "Mean", "p50", "p95", "Max", "Ratio",
+           ">158B", "Encode rec/s", "Decode rec/s");
+
+    backend_result_t results[NUM_BACKENDS];
+    int failures = 0;
+    for (size_t b = 0; b < NUM_BACKENDS; b++) {
+        backend_result_t *res = &results[b];
+        res->name = backends[b].name;
+        res->sizes = malloc(opt.records * sizeof(uint16_t));
+        if (!res->sizes) return 1;
+
+        // Sizes and round trip
+        size_t total = 0, oversize = 0;
+        for (size_t r = 0; r < opt.records; r++) {
+            uint8_t decoded[CONTAINER_RECORD_STRUCT_MAX];
+            size_t n = backends[b].encode(packed[r], packed_len[r], encoded[r], sizeof(encoded[r]));
+            size_t m = n ? backends[b].decode(encoded[r], n, decoded, sizeof(decoded)) : 0;
+            if (!n || m != packed_len[r] || memcmp(decoded, packed[r], m) != 0) {
+                if (failures++ < 5) fprintf(stderr, "%s: round trip failed on record %zu\n", res->name, r);
+            }
+            res->sizes[r] = (uint16_t)n;
+            total += n;
+            oversize += n > MAX_PAYLOAD_SIZE;
+        }
+
+        // Speed: repeat the corpus until the time budget is spent
+        size_t passes = 0;
+        double t0 = now_s(), elapsed;
+        do {
+            for (size_t r = 0; r < opt.records; r++) {
+                backends[b].encode(packed[r], packed_len[r], encoded[r], sizeof(encoded[r]));
+            }
+            passes++;
+            elapsed = now_s() - t0;
+        } while (elapsed < opt.seconds);
+        double encode_rate = (double)(passes * opt.records) / elapsed;
+
+        volatile size_t sink = 0;
+        passes = 0;
+        t0 = now_s();
+        do {
+            for (size_t r = 0; r < opt.records; r++) {
+                uint8_t decoded[CONTAINER_RECORD_STRUCT_MAX];
+                sink += backends[b].decode(encoded[r], res->sizes[r], decoded, sizeof(decoded));
+            }
+            passes++;
+            elapsed = now_s() - t0;
+        } while (elapsed < opt.seconds);
+        double decode_rate = (double)(passes * opt.records) / elapsed;
+        (void)sink;
+
+        uint16_t *sorted = malloc(opt.records * sizeof(uint16_t));
+        if (!sorted) return 1;
+        memcpy(sorted, res->sizes, opt.records * sizeof(uint16_t));
+        qsort(sorted, opt.records, sizeof(uint16_t), cmp_u16);
+        double mean = (double)total / opt.records;
+        printf("%-12s %6.1f %5u %5u %5u %5.2fx %7zu %12.0f %12.0f\n", res->name, mean,
+               sorted[opt.records / 2], sorted[(size_t)(opt.records * 0.95)], sorted[opt.records - 1],
+               (double)packed_total / total, oversize, encode_rate, decode_rate);
+        free(sorted);
+        res->encode_ns = 1e9 / encode_rate;
+        res->decode_ns = 1e9 / decode_rate;
+    }
+
+    // Corruption: every single-bit flip of the first records must be rejected
+    size_t flips = 0, accepted = 0;
+    for (size_t r = 0; r < opt.records && r < 200; r++) {
+        uint8_t frame[256], decoded[CONTAINER_RECORD_STRUCT_MAX];
+        size_t n = record_rans_encode(packed[r], packed_len[r], frame, sizeof(frame));
+        for (size_t bit = 0; bit < n * 8; bit++) {
+            frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            int m = record_rans_decode(frame, n, decoded, sizeof(decoded));
+            if (m >= 0 && ((size_t)m != packed_len[r] || memcmp(decoded, packed[r], (size_t)m) != 0)) accepted++;
+            frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            flips++;
+        }
+    }
+    double zlib_mean = 0.0, rans_mean = 0.0;
+    for (size_t r = 0; r < opt.records; r++) {
+        zlib_mean += results[0].sizes[r];
+        rans_mean += results[NUM_BACKENDS - 1].sizes[r];
+    }
+    zlib_mean /= opt.records;
+    rans_mean /= opt.records;
+    printf("\nrANS vs zlib-9: %.1f bytes saved per record (%.0f%%), encode %.0f ns, decode %.0f ns\n",
+           zlib_mean - rans_mean, 100.0 * (zlib_mean - rans_mean) / zlib_mean,
+           results[NUM_BACKENDS - 1].encode_ns, results[NUM_BACKENDS - 1].decode_ns);
+    printf("Corruption: %zu of %zu single-bit flips decoded to a wrong record "
+           "(no checksum: integrity comes from the transport or the AEAD layer)\n", accepted, flips);
+
+    if (opt.csv) {
+        FILE *f = fopen(opt.csv, "w");
+        if (!f) {
+            perror(opt.csv);
+            return 1;
+        }
+        fprintf(f, "record,packed");
+        for (size_t b = 0; b < NUM_BACKENDS; b++) fprintf(f, ",%s", results[b].name);
+        fprintf(f, "\n");
+        for (size_t r = 0; r < opt.records; r++) {
+            fprintf(f, "%zu,%u", r, packed_len[r]);
+            for (size_t b = 0; b < NUM_BACKENDS; b++) fprintf(f, ",%u", results[b].sizes[r]);
+            fprintf(f, "\n");
+        }
+        fclose(f);
+    }
+
+    for (size_t b = 0; b < NUM_BACKENDS; b++) free(results[b].sizes);
+    free(encoded);
+    free(packed_len);
+    free(packed);
+    if (failures) {
+        fprintf(stderr, "%d round-trip failures\n", failures);
+        return 1;
+    }
+    return 0;
+}
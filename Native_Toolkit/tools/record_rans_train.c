@@ -0,0 +1,333 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Offline trainer for the static rANS record model (firmware/record_rans.c).
+//
+// Counts byte frequencies per context over a corpus of packed records,
+// normalizes every context to 1 << RECORD_RANS_SCALE_BITS (unseen symbols
+// keep frequency 1 so any record stays encodable) and writes the model
+// twice: a C header compiled into the firmware and the host tools, and a
+// JSON file loaded by the Node receiver and the locust sender. Contexts
+// that cannot beat 8 bits per byte are stored flat.
+//
+// The corpus is either synthetic (codec/container_record.c, the locust
+// generator's distributions, timestamps spread over several years so the
+// date digits are not memorized) or a file of u16 BE length-prefixed
+// packed records.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "container_record.h"
+#include "record_rans.h"
+
+typedef struct {
+    size_t records;
+    uint64_t seed;
+    long long time_center;
+    double span_days;
+    const char *corpus;
+    const char *header_path;
+    const char *json_path;
+    double flat_bits;
+    int version;
+} train_opts_t;
+
+typedef struct {
+    uint64_t counts[RECORD_RANS_CONTEXTS][256];
+    uint64_t totals[RECORD_RANS_CONTEXTS];
+    size_t records;
+    size_t bytes;
+} corpus_stats_t;
+
+typedef struct {
+    uint8_t scale_bits;
+    uint16_t freq[256];
+    double bits;                          // cross-entropy over the corpus
+} trained_context_t;
+
+// ================= CONTEXT NAMES =================
+static const struct {
+    const char *name;
+    int size;
+} fixed_fields[] = {
+    { "msisdn.len", 2 }, { "iso6346.len", 2 }, { "time.len", 2 }, { "rssi", 1 }, { "cgi.len", 2 },
+    { "ble-m", 1 }, { "bat-soc", 1 }, { "acc.x", 4 }, { "acc.y", 4 }, { "acc.z", 4 },
+    { "temperature", 4 }, { "humidity", 4 }, { "pressure", 4 }, { "door.len", 2 }, { "gnss", 1 },
+    { "latitude", 4 }, { "longitude", 4 }, { "altitude", 4 }, { "speed", 4 }, { "heading", 4 },
+    { "nsat", 1 }, { "hdop", 4 },
+};
+static const char *string_fields[RECORD_RANS_STR_FIELDS] = { "msisdn", "iso6346", "time", "cgi", "door" };
+
+static void context_name(int ctx, char *out, size_t cap) {
+    if (ctx >= RECORD_RANS_FIXED_BYTES) {
+        int rel = ctx - RECORD_RANS_FIXED_BYTES;
+        int pos = rel % RECORD_RANS_STR_POSITIONS;
+        snprintf(out, cap, "%s[%d%s]", string_fields[rel / RECORD_RANS_STR_POSITIONS], pos,
+                 pos == RECORD_RANS_STR_POSITIONS - 1 ? "+" : "");
+        return;
+    }
+    int offset = 0;
+    for (size_t f = 0; f < sizeof(fixed_fields) / sizeof(fixed_fields[0]); f++) {
+        if (ctx < offset + fixed_fields[f].size) {
+            if (fixed_fields[f].size == 1) snprintf(out, cap, "%s", fixed_fields[f].name);
+            else snprintf(out, cap, "%s.b%d", fixed_fields[f].name, ctx - offset);
+            return;
+        }
+        offset += fixed_fields[f].size;
+    }
+    snprintf(out, cap, "ctx%d", ctx);
+}
+
+// ================= CORPUS =================
+static int count_record(corpus_stats_t *st, const uint8_t *packed, size_t len) {
+    uint16_t ctx[RECORD_RANS_MAX_RECORD];
+    if (len > RECORD_RANS_MAX_RECORD || record_rans_contexts(packed, len, ctx) != 0) return -1;
+    for (size_t i = 0; i < len; i++) {
+        st->counts[ctx[i]][packed[i]]++;
+        st->totals[ctx[i]]++;
+    }
+    st->records++;
+    st->bytes += len;
+    return 0;
+}
+
+static int load_corpus(corpus_stats_t *st, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    uint8_t hdr[2], buf[RECORD_RANS_MAX_RECORD];
+    size_t rejected = 0;
+    while (fread(hdr, 1, 2, f) == 2) {
+        size_t len = ((size_t)hdr[0] << 8) | hdr[1];
+        if (len > sizeof(buf)) {
+            fprintf(stderr, "%s: record of %zu bytes exceeds %d\n", path, len, RECORD_RANS_MAX_RECORD);
+            fclose(f);
+            return -1;
+        }
+        if (fread(buf, 1, len, f) != len) break;
+        if (count_record(st, buf, len) != 0) rejected++;
+    }
+    fclose(f);
+    if (rejected) fprintf(stderr, "%s: skipped %zu records not in the packed layout\n", path, rejected);
+    return 0;
+}
+
+static void generate_corpus(corpus_stats_t *st, const train_opts_t *opt) {
+    container_record_gen_t gen;
+    uint32_t span_s = (uint32_t)(opt->span_days * 86400.0);
+    container_record_gen_init(&gen, opt->seed, (time_t)(opt->time_center + span_s / 2), span_s);
+
+    uint8_t buf[RECORD_RANS_MAX_RECORD];
+    for (size_t n = 0; n < opt->records; n++) {
+        container_record_t rec;
+        container_record_generate(&gen, &rec);
+        size_t len = container_record_pack_struct(&rec, buf, sizeof(buf));
+        if (len) count_record(st, buf, len);
+    }
+}
+
+// ================= NORMALIZATION =================
+static void train_context(const uint64_t *counts, uint64_t total, double flat_bits, trained_context_t *out) {
+    out->scale_bits = 8;
+    out->bits = 8.0;
+    for (int s = 0; s < 256; s++) out->freq[s] = 1;
+    if (total == 0) return;
+
+    // Every symbol keeps 1, the rest of the range is shared by count
+    const uint32_t range = 1u << RECORD_RANS_SCALE_BITS;
+    uint16_t freq[256];
+    uint32_t sum = 0;
+    int top = 0;
+    for (int s = 0; s < 256; s++) {
+        freq[s] = (uint16_t)(1 + (counts[s] * (range - 256)) / total);
+        sum += freq[s];
+        if (counts[s] > counts[top]) top = s;
+    }
+    freq[top] = (uint16_t)(freq[top] + range - sum);
+
+    double bits = 0.0;
+    for (int s = 0; s < 256; s++) {
+        if (counts[s]) bits -= (double)counts[s] * log2((double)freq[s] / range);
+    }
+    bits /= (double)total;
+    if (bits >= flat_bits) return;
+
+    out->scale_bits = RECORD_RANS_SCALE_BITS;
+    out->bits = bits;
+    memcpy(out->freq, freq, sizeof(freq));
+}
+
+// ================= OUTPUT =================
+static int write_header(const char *path, int version, const trained_context_t *model,
+                        const corpus_stats_t *st, const char *source) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "// ------------------------------------------------------------\n"
+               "//  IoT Payload Optimization Framework – Master's Thesis (2025)\n"
+               "//  Copyright (c) 2025 Natesh Kumar (Natdev15)\n"
+               "//  Provided for academic and research reference only.\n"
+               "// ------------------------------------------------------------\n\n");
+    fprintf(f, "// Static rANS record model, generated by tools/record_rans_train.c. Do not edit.\n"
+               "// Corpus: %zu records (%s)\n"
+               "// Included by record_rans.c only.\n\n", st->records, source);
+    fprintf(f, "#ifndef RECORD_RANS_TABLES_H\n#define RECORD_RANS_TABLES_H\n\n");
+    fprintf(f, "#define RECORD_RANS_MODEL_VERSION %d\n\n", version);
+
+    fprintf(f, "// { scale_bits, first_pair, pair_count }\n");
+    fprintf(f, "static const record_rans_context_t record_rans_model[RECORD_RANS_CONTEXTS] = {\n");
+    size_t pairs = 0;
+    for (int c = 0; c < RECORD_RANS_CONTEXTS; c++) {
+        size_t n = 0;
+        for (int s = 0; s < 256; s++) n += model[c].freq[s] != 1;
+        char name[32];
+        context_name(c, name, sizeof(name));
+        fprintf(f, "    { %2d, %5zu, %3zu }, // %-16s %.2f bits\n", model[c].scale_bits, pairs, n, name,
+                model[c].bits);
+        pairs += n;
+    }
+    fprintf(f, "};\n\n");
+
+    const char *arrays[2] = { "static const uint8_t record_rans_model_symbols[]",
+                              "static const uint16_t record_rans_model_freqs[]" };
+    for (int a = 0; a < 2; a++) {
+        fprintf(f, "%s = {", arrays[a]);
+        size_t k = 0;
+        for (int c = 0; c < RECORD_RANS_CONTEXTS; c++) {
+            for (int s = 0; s < 256; s++) {
+                if (model[c].freq[s] == 1) continue;
+                fprintf(f, "%s%d,", k % 12 == 0 ? "\n    " : " ", a == 0 ? s : model[c].freq[s]);
+                k++;
+            }
+        }
+        if (k == 0) fprintf(f, "\n    0");
+        fprintf(f, "\n};\n\n");
+    }
+    fprintf(f, "#endif // RECORD_RANS_TABLES_H\n");
+    fclose(f);
+    return 0;
+}
+
+static int write_json(const char *path, int version, const trained_context_t *model,
+                      const corpus_stats_t *st) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    fprintf(f, "{\n  \"version\": %d,\n  \"records\": %zu,\n  \"contexts\": [\n",
+            version, st->records);
+    for (int c = 0; c < RECORD_RANS_CONTEXTS; c++) {
+        char name[32];
+        context_name(c, name, sizeof(name));
+        fprintf(f, "    { \"name\": \"%s\", \"scale\": %d, \"pairs\": [", name, model[c].scale_bits);
+        int first = 1;
+        for (int s = 0; s < 256; s++) {
+            if (model[c].freq[s] == 1) continue;
+            fprintf(f, "%s[%d, %d]", first ? "" : ", ", s, model[c].freq[s]);
+            first = 0;
+        }
+        fprintf(f, "] }%s\n", c + 1 < RECORD_RANS_CONTEXTS ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --records N        synthetic corpus size (default 200000)\n"
+            "  --seed N           generator seed (default 1)\n"
+            "  --time-center T    unix time in the middle of the timestamps (default 1767225600)\n"
+            "  --span-days D      timestamp spread (default 1826)\n"
+            "  --corpus FILE      train on u16 BE length-prefixed packed records instead\n"
+            "  --version V        model version, 1..15, sent in the first byte (default 1)\n"
+            "  --flat-bits B      store contexts at or above B bits per byte flat (default 7.9)\n"
+            "  --header PATH      C tables (default firmware/record_rans_tables.h)\n"
+            "  --json PATH        JSON model (default ../Struct_Zlib_Service/nodejs_receiver/record_rans_model.json)\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    train_opts_t opt = {
+        .records = 200000,
+        .seed = 1,
+        .time_center = 1767225600LL,
+        .span_days = 1826.0,
+        .corpus = NULL,
+        .header_path = "firmware/record_rans_tables.h",
+        .json_path = "../Struct_Zlib_Service/nodejs_receiver/record_rans_model.json",
+        .flat_bits = 7.9,
+        .version = 1,
+    };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--records")) opt.records = (size_t)atol(v);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--time-center")) opt.time_center = atoll(v);
+        else if (!strcmp(a, "--span-days")) opt.span_days = atof(v);
+        else if (!strcmp(a, "--corpus")) opt.corpus = v;
+        else if (!strcmp(a, "--version")) opt.version = atoi(v);
+        else if (!strcmp(a, "--flat-bits")) opt.flat_bits = atof(v);
+        else if (!strcmp(a, "--header")) opt.header_path = v;
+        else if (!strcmp(a, "--json")) opt.json_path = v;
+        else { usage(argv[0]); return 2; }
+        i++;
+    }
+
+    if (opt.version < 1 || opt.version > 15) { usage(argv[0]); return 2; }
+
+    corpus_stats_t *st = calloc(1, sizeof(*st));
+    trained_context_t *model = calloc(RECORD_RANS_CONTEXTS, sizeof(*model));
+    if (!st || !model) return 1;
+
+    char source[96];
+    if (opt.corpus) {
+        if (load_corpus(st, opt.corpus) != 0) return 1;
+        snprintf(source, sizeof(source), "%s", opt.corpus);
+    } else {
+        generate_corpus(st, &opt);
+        snprintf(source, sizeof(source), "synthetic, seed %llu, %.0f-day timestamp span",
+                 (unsigned long long)opt.seed, opt.span_days);
+    }
+    if (st->records == 0) {
+        fprintf(stderr, "empty corpus\n");
+        return 1;
+    }
+
+    double total_bits = 0.0;
+    int trained = 0;
+    for (int c = 0; c < RECORD_RANS_CONTEXTS; c++) {
+        train_context(st->counts[c], st->totals[c], opt.flat_bits, &model[c]);
+        total_bits += model[c].bits * (double)st->totals[c];
+        trained += model[c].scale_bits != 8;
+    }
+
+    printf("Corpus: %zu records, %.1f bytes mean packed size\n", st->records, (double)st->bytes / st->records);
+    printf("Model:  %d contexts, %d trained, %d flat\n", RECORD_RANS_CONTEXTS, trained,
+           RECORD_RANS_CONTEXTS - trained);
+    printf("Estimated coded size: %.1f bytes + %d header (in-sample)\n",
+           total_bits / 8.0 / st->records, RECORD_RANS_HEADER_SIZE);
+
+    if (write_header(opt.header_path, opt.version, model, st, source) != 0) return 1;
+    if (write_json(opt.json_path, opt.version, model, st) != 0) return 1;
+    printf("Wrote %s and %s\n", opt.header_path, opt.json_path);
+
+    free(model);
+    free(st);
+    return 0;
+}
@@ -0,0 +1,1308 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Native /container-data receiver on the shared-nothing shard pipeline
+// (common/shard_pipeline.h).
+//
+//   client --> ingress thread (SO_REUSEPORT listener, epoll)
+//                 | device key: X-Device-Id, else the payload's iso6346
+//                 v  SPSC ring
+//              shard thread owning the device (decode, state, store, forward)
+//                 |  SPSC reply ring + eventfd
+//                 v
+//   client <-- ingress thread writes the status (200, 400, 409)
+//
+// Unlike the Node receiver replicas behind nginx, every record of a
+// container is handled by one thread, so the latest value, the sequence
+// and the session inflate stream of that container stay consistent
+// however many cores are used. The cbor, msgpack and protobuf keys are
+// read without decoding; struct payloads (zlib or rANS) without an
+// X-Device-Id header are decoded by the ingress thread to find the key.
+// Session-deflate frames (0xC?) need the header, as in the Node receiver.
+// A shard with ring-slots requests of one ingress in flight gets 503 with
+// Retry-After, so the reply rings never overflow. With --dedup-window a
+// payload the device already sent within the window is answered 200
+// "duplicate" by its shard before the decode, so retries from devices,
+// Astrocast callbacks and HTTP clients are stored and forwarded once.
+// GET /metrics exports, in the Prometheus text format, the time of every
+// stage per codec (common/metrics.h histograms, one block per thread) and
+// the pipeline counters per shard.
+//
+// POST /astrocast-callback takes the callback JSON, one object or an array
+// of them (common/astrocast_callback.h). The body is scanned once for
+// data, guid and deviceGuid, the base64 is decoded with SIMD, and each
+// payload goes to its shard like a /container-data body, keyed by
+// deviceGuid. The reply, sent once every shard has answered, counts the
+// messages received, duplicate, invalid, resync and shed.
+//
+// With --cluster several receivers (processes on one host or on many)
+// share the devices (common/cluster.h): every device falls into one of
+// --partitions partitions, owned by one node, found by gossip. A request
+// for a partition owned elsewhere gets 307 to the owner (Location and
+// X-Cluster-Owner), one for a partition being moved 503 with Retry-After.
+// When a node joins or leaves, the partitions that change owner move with
+// their device state (latest record, sequence, session inflate history and
+// recent duplicate keys), so a session stream carries on across the move.
+// SIGTERM hands the node's partitions over before it exits.
+//
+// --bench replaces the network with in-process producers that pre-encode
+// device traces, and reports throughput and per-device order for each
+// shard count.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "astrocast_callback.h"
+#include "cluster.h"
+#include "container_codecs.h"
+#include "container_record.h"
+#include "dedup_filter.h"
+#include "deflate_session.h"
+#include "metrics.h"
+#include "record_rans.h"
+#include "shard_pipeline.h"
+
+#define MAX_CONNS 4096                    // per ingress thread
+#define RBUF_SIZE (8192 + SHARD_ITEM_PAYLOAD_MAX)
+#define WBUF_SIZE 4096
+#define DEVICE_ID_MAX 64
+#define MAX_SHARD_LIST 16
+#define TAG_LISTEN UINT64_MAX
+#define TAG_REPLIES (UINT64_MAX - 1)
+
+typedef struct {
+    char host[256];
+    uint16_t port;
+    container_codec_t codec;
+    bool session;                         // --bench only: session-deflate frames
+    unsigned ingress;
+    unsigned shards[MAX_SHARD_LIST];
+    unsigned shard_count;
+    size_t ring_slots;
+    bool pin;
+    const char *store_dir;
+    const char *forward;
+    double dedup_window_s;                // 0 = no duplicate filter
+    size_t dedup_capacity;                // keys per shard and generation
+    size_t dedup_per_device;
+    size_t dedup_confirm;                 // 0 = 2 x capacity
+    bool dedup_strict;
+    double stats_s;
+    bool metrics;
+    unsigned metrics_sample;              // time one request in N
+    bool bench;
+    size_t records;
+    unsigned devices;
+    uint64_t seed;
+    double duplicates;                    // bench: fraction of records sent twice
+    const char *cluster;                  // gossip address, NULL = standalone
+    const char *node_name;                // default: the gossip address
+    char advertise[CLUSTER_ADDR_MAX];     // HTTP address redirects point to
+    const char *join;
+    unsigned partitions;
+    double fail_after_s;
+} receiver_opts_t;
+
+static receiver_opts_t opt;
+static shard_pipeline_t *pipeline;
+static metrics_registry_t *registry;     // NULL with --metrics 0
+static cluster_t *cluster;               // NULL without --cluster
+static volatile sig_atomic_t stop;
+static atomic_bool ingress_stop;         // after the cluster hand-over
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop = 1;
+}
+
+static bool struct_codec(container_codec_t c) {
+    return c == CONTAINER_CODEC_STRUCT_ZLIB || c == CONTAINER_CODEC_STRUCT_RANS;
+}
+
+static void pipeline_config(shard_pipeline_config_t *cfg, unsigned shards, bool replies) {
+    memset(cfg, 0, sizeof(*cfg));
+    // Two more ingress indexes for the cluster's transfers
+    cfg->ingress = opt.ingress + (opt.cluster ? 2 : 0);
+    cfg->partitions = opt.cluster ? opt.partitions : 0;
+    cfg->shards = shards;
+    cfg->ring_slots = opt.ring_slots;
+    cfg->replies = replies;
+    cfg->pin = opt.pin;
+    cfg->store_dir = opt.store_dir;
+    cfg->forward = opt.forward;
+    cfg->dedup.window_s = opt.dedup_window_s;
+    cfg->dedup.capacity = opt.dedup_capacity;
+    cfg->dedup.confirm_entries = opt.dedup_confirm ? opt.dedup_confirm : 2 * opt.dedup_capacity;
+    cfg->dedup.drop_unconfirmed = opt.dedup_strict;
+    cfg->dedup_per_device = opt.dedup_per_device;
+    cfg->metrics = registry;
+    cfg->metrics_sample = opt.metrics_sample;
+}
+
+// ================= HTTP INGRESS =================
+// Outcomes of the messages of one callback request
+enum { TALLY_RECEIVED, TALLY_DUPLICATE, TALLY_INVALID, TALLY_RESYNC, TALLY_SHED, TALLY_MOVED, TALLY_COUNT };
+
+typedef struct {
+    int fd;
+    uint32_t gen;                         // bumped on close, so late replies are dropped
+    uint32_t pending;                     // items of the request held by shards
+    bool callback;                        // request in flight is an Astrocast callback
+    uint16_t tally[TALLY_COUNT];          // its messages by outcome
+    bool close_after;
+    uint8_t codec;                        // of the request in flight
+    uint64_t started_ns;                  // parse time of the request in flight, 0 = not timed
+    size_t rlen;
+    size_t wlen, woff;
+    char *obuf;                           // large response being sent (/metrics), else wbuf
+    char rbuf[RBUF_SIZE];
+    char wbuf[WBUF_SIZE];
+} conn_t;
+
+typedef struct {
+    const char *method, *path;
+    size_t method_len, path_len;
+    size_t header_len, body_len;
+    char device[DEVICE_ID_MAX];
+    bool close;
+} request_t;
+
+typedef struct {
+    unsigned index;
+    pthread_t thread;
+    int lfd, epfd;
+    conn_t *conns;
+    uint32_t *free_slots;
+    size_t free_count;
+    unsigned inflight[SHARD_PIPELINE_MAX_SHARDS];
+    shard_item_t item;
+    char owner[CLUSTER_ADDR_MAX];         // of the last payload routed to another node
+    metrics_block_t *metrics;
+    uint64_t ticks;                       // requests seen, for metrics sampling
+    _Atomic uint64_t requests, shed, rejected, callbacks, redirected, moving;
+} ingress_t;
+
+static ingress_t *ingress;
+
+static int open_listener(void) {
+    char port[8];
+    snprintf(port, sizeof(port), "%u", opt.port);
+    struct addrinfo hints = { .ai_socktype = SOCK_STREAM, .ai_flags = AI_PASSIVE }, *res;
+    if (getaddrinfo(opt.host[0] ? opt.host : NULL, port, &hints, &res) != 0) return -1;
+    int fd = socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) || bind(fd, res->ai_addr, res->ai_addrlen) ||
+        listen(fd, 1024)) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static void conn_close(ingress_t *in, conn_t *c) {
+    epoll_ctl(in->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    free(c->obuf);
+    c->obuf = NULL;
+    c->fd = -1;
+    c->gen++;
+    in->free_slots[in->free_count++] = (uint32_t)(c - in->conns);
+}
+
+static void conn_flush(ingress_t *in, conn_t *c) {
+    const char *buf = c->obuf ? c->obuf : c->wbuf;
+    while (c->woff < c->wlen) {
+        ssize_t n = send(c->fd, buf + c->woff, c->wlen - c->woff, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            conn_close(in, c);
+            return;
+        }
+        c->woff += (size_t)n;
+    }
+    struct epoll_event e = { .events = EPOLLIN, .data.u64 = (uint64_t)(c - in->conns) };
+    if (c->woff < c->wlen) {
+        e.events |= EPOLLOUT;
+    } else {
+        c->woff = c->wlen = 0;
+        free(c->obuf);
+        c->obuf = NULL;
+    }
+    epoll_ctl(in->epfd, EPOLL_CTL_MOD, c->fd, &e);
+    if (!c->wlen && c->close_after && !c->pending) conn_close(in, c);
+}
+
+static const char *status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 307: return "Temporary Redirect";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+    }
+}
+
+static void respond(ingress_t *in, conn_t *c, int status, const char *extra, const char *body) {
+    size_t blen = strlen(body);
+    int n = snprintf(c->wbuf + c->wlen, WBUF_SIZE - c->wlen,
+                     "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n%s%s\r\n%s", status,
+                     status_text(status), blen, extra ? extra : "", c->close_after ? "Connection: close\r\n" : "",
+                     body);
+    if (n > 0 && (size_t)n < WBUF_SIZE - c->wlen) c->wlen += (size_t)n;
+    else c->close_after = true;
+    conn_flush(in, c);
+}
+
+// Takes ownership of the heap buffer text; no other response is queued
+// until it is sent
+static void respond_large(ingress_t *in, conn_t *c, const char *content_type, char *text, size_t len) {
+    char head[256];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n",
+                     content_type, len, c->close_after ? "Connection: close\r\n" : "");
+    char *buf = malloc((size_t)n + len);
+    if (!buf) {
+        free(text);
+        c->close_after = true;
+        respond(in, c, 503, NULL, "{\"error\":\"Out of memory\"}");
+        return;
+    }
+    memcpy(buf, head, (size_t)n);
+    memcpy(buf + n, text, len);
+    free(text);
+    c->obuf = buf;
+    c->wlen = (size_t)n + len;
+    c->woff = 0;
+    conn_flush(in, c);
+}
+
+static void respond_status(ingress_t *in, conn_t *c, uint16_t status) {
+    switch (status) {
+    case SHARD_STATUS_OK: respond(in, c, 200, NULL, "{\"status\":\"received\"}"); break;
+    case SHARD_STATUS_DUPLICATE: respond(in, c, 200, NULL, "{\"status\":\"duplicate\"}"); break;
+    case SHARD_STATUS_RESYNC:
+        respond(in, c, 409, NULL, "{\"error\":\"Session desync\",\"resync\":true}");
+        break;
+    case SHARD_STATUS_MOVED:
+        respond(in, c, 503, "Retry-After: 1\r\n", "{\"error\":\"Partition moving\"}");
+        break;
+    default: respond(in, c, 400, NULL, "{\"error\":\"Invalid payload\"}"); break;
+    }
+}
+
+// 307 to the node that owns the device, same path
+static void respond_redirect(ingress_t *in, conn_t *c, const char *owner, const char *path) {
+    char extra[3 * CLUSTER_ADDR_MAX], body[CLUSTER_ADDR_MAX + 64];
+    snprintf(extra, sizeof(extra), "Location: http://%s%s\r\nX-Cluster-Owner: %s\r\n", owner, path, owner);
+    snprintf(body, sizeof(body), "{\"error\":\"Moved\",\"owner\":\"%s\"}", owner);
+    respond(in, c, 307, extra, body);
+}
+
+// 1 with a complete request, 0 when more bytes are needed, -1 on a bad one
+static int parse_request(conn_t *c, request_t *rq) {
+    char *end = memmem(c->rbuf, c->rlen, "\r\n\r\n", 4);
+    if (!end) return c->rlen == RBUF_SIZE ? -1 : 0;
+    memset(rq, 0, sizeof(*rq));
+    rq->header_len = (size_t)(end - c->rbuf) + 4;
+    char *line = c->rbuf, *sp1 = memchr(line, ' ', (size_t)(end - line));
+    char *sp2 = sp1 ? memchr(sp1 + 1, ' ', (size_t)(end - sp1 - 1)) : NULL;
+    if (!sp2) return -1;
+    rq->method = line;
+    rq->method_len = (size_t)(sp1 - line);
+    rq->path = sp1 + 1;
+    rq->path_len = (size_t)(sp2 - sp1 - 1);
+    rq->close = !strncmp(sp2 + 1, "HTTP/1.0", 8);
+
+    for (char *h = memchr(sp2, '\n', (size_t)(end - sp2)); h && h < end; h = memchr(h, '\n', (size_t)(end - h))) {
+        h++;
+        char *eol = memchr(h, '\r', (size_t)(end + 2 - h)), *colon = memchr(h, ':', (size_t)(eol - h));
+        if (!colon) continue;
+        char *v = colon + 1;
+        while (v < eol && *v == ' ') v++;
+        size_t name_len = (size_t)(colon - h), vlen = (size_t)(eol - v);
+        if (name_len == 14 && !strncasecmp(h, "Content-Length", 14)) {
+            rq->body_len = strtoul(v, NULL, 10);
+        } else if (name_len == 11 && !strncasecmp(h, "X-Device-Id", 11) && vlen && vlen < DEVICE_ID_MAX) {
+            memcpy(rq->device, v, vlen);
+            rq->device[vlen] = '\0';
+        } else if (name_len == 10 && !strncasecmp(h, "Connection", 10)) {
+            rq->close = vlen >= 5 && !strncasecmp(v, "close", 5);
+        }
+    }
+    if (rq->body_len > RBUF_SIZE - rq->header_len) return -1;
+    return c->rlen >= rq->header_len + rq->body_len ? 1 : 0;
+}
+
+static bool route_is(const request_t *rq, const char *method, const char *path) {
+    return rq->method_len == strlen(method) && !memcmp(rq->method, method, rq->method_len) &&
+           rq->path_len == strlen(path) && !memcmp(rq->path, path, rq->path_len);
+}
+
+static void handle_stats(ingress_t *in, conn_t *c) {
+    shard_stats_t t = { 0 };
+    char per_shard[WBUF_SIZE / 2];
+    size_t off = 0;
+    unsigned shards = opt.shards[0];
+    for (unsigned s = 0; s < shards; s++) {
+        shard_stats_t st;
+        shard_pipeline_stats(pipeline, s, &st);
+        uint64_t *tv = (uint64_t *)&t, *sv = (uint64_t *)&st;
+        for (size_t i = 0; i < sizeof(st) / sizeof(uint64_t); i++) tv[i] += sv[i];
+        int n = snprintf(per_shard + off, sizeof(per_shard) - off, "%s%llu", s ? "," : "",
+                         (unsigned long long)st.records);
+        if (n > 0 && (size_t)n < sizeof(per_shard) - off) off += (size_t)n;
+    }
+    per_shard[off] = '\0';
+    uint64_t requests = 0, shed = 0, rejected = 0, callbacks = 0;
+    for (unsigned i = 0; i < opt.ingress; i++) {
+        requests += atomic_load_explicit(&ingress[i].requests, memory_order_relaxed);
+        shed += atomic_load_explicit(&ingress[i].shed, memory_order_relaxed);
+        rejected += atomic_load_explicit(&ingress[i].rejected, memory_order_relaxed);
+        callbacks += atomic_load_explicit(&ingress[i].callbacks, memory_order_relaxed);
+    }
+    char cl[640] = "";
+    if (cluster) {
+        uint64_t redirected = 0, moving = 0;
+        for (unsigned i = 0; i < opt.ingress; i++) {
+            redirected += atomic_load_explicit(&ingress[i].redirected, memory_order_relaxed);
+            moving += atomic_load_explicit(&ingress[i].moving, memory_order_relaxed);
+        }
+        cluster_stats_t cs;
+        cluster_stats(cluster, &cs);
+        snprintf(cl, sizeof(cl),
+                 ",\"cluster\":{\"node\":\"%s\",\"partitions\":%u,\"owned\":%u,\"members\":%u,\"up\":%u,"
+                 "\"redirected\":%llu,\"moving\":%llu,\"moved\":%llu,\"transfers_out\":%llu,\"transfers_in\":%llu,"
+                 "\"transfer_errors\":%llu,\"partitions_out\":%llu,\"partitions_in\":%llu,\"devices_out\":%llu,"
+                 "\"devices_in\":%llu,\"bytes_out\":%llu,\"bytes_in\":%llu,\"claimed\":%llu,\"dropped\":%llu,"
+                 "\"last_transfer_ms\":%.1f}",
+                 opt.node_name, opt.partitions, cs.owned, cs.members, cs.up, (unsigned long long)redirected,
+                 (unsigned long long)moving, (unsigned long long)t.moved, (unsigned long long)cs.transfers_out,
+                 (unsigned long long)cs.transfers_in, (unsigned long long)cs.transfer_errors,
+                 (unsigned long long)cs.partitions_out, (unsigned long long)cs.partitions_in,
+                 (unsigned long long)cs.devices_out, (unsigned long long)cs.devices_in,
+                 (unsigned long long)cs.bytes_out, (unsigned long long)cs.bytes_in, (unsigned long long)cs.claimed,
+                 (unsigned long long)cs.dropped, cs.last_transfer_ms);
+    }
+    char body[WBUF_SIZE - 256];
+    snprintf(body, sizeof(body),
+             "{\"shards\":%u,\"ingress\":%u,\"requests\":%llu,\"shed\":%llu,\"rejected\":%llu,\"callbacks\":%llu,"
+             "\"records\":%llu,\"bad\":%llu,\"resyncs\":%llu,\"duplicates\":%llu,\"order_violations\":%llu,\"devices\":%llu,"
+             "\"stored_bytes\":%llu,\"forwarded\":%llu,\"forward_errors\":%llu,\"records_per_shard\":[%s]%s}",
+             shards, opt.ingress, (unsigned long long)requests, (unsigned long long)shed,
+             (unsigned long long)rejected, (unsigned long long)callbacks, (unsigned long long)t.records,
+             (unsigned long long)t.bad,
+             (unsigned long long)t.resyncs, (unsigned long long)t.duplicates, (unsigned long long)t.order_violations,
+             (unsigned long long)t.devices,
+             (unsigned long long)t.stored_bytes, (unsigned long long)t.forwarded,
+             (unsigned long long)t.forward_errors, per_shard, cl);
+    respond(in, c, 200, NULL, body);
+}
+
+static void handle_metrics(ingress_t *in, conn_t *c) {
+    static const struct {
+        const char *name, *help;
+        size_t field;
+        bool gauge;
+    } shard_series[] = {
+        { "shard_pipeline_items_total", "Items taken from the rings", offsetof(shard_stats_t, items), false },
+        { "shard_pipeline_bad_total", "Payloads that failed to decode", offsetof(shard_stats_t, bad), false },
+        { "shard_pipeline_resyncs_total", "Session frames answered 409", offsetof(shard_stats_t, resyncs), false },
+        { "shard_pipeline_order_violations_total", "Sequence numbers not above the previous one",
+          offsetof(shard_stats_t, order_violations), false },
+        { "shard_pipeline_duplicates_total", "Payloads dropped by the duplicate filter",
+          offsetof(shard_stats_t, duplicates), false },
+        { "shard_pipeline_stored_bytes_total", "Bytes appended to the store files",
+          offsetof(shard_stats_t, stored_bytes), false },
+        { "shard_pipeline_forwarded_total", "Records forwarded over UDP", offsetof(shard_stats_t, forwarded), false },
+        { "shard_pipeline_forward_errors_total", "Records the forward socket refused",
+          offsetof(shard_stats_t, forward_errors), false },
+        { "shard_pipeline_sleeps_total", "Times a shard blocked on its eventfd", offsetof(shard_stats_t, sleeps),
+          false },
+        { "shard_pipeline_moved_total", "Records of a partition moved to another node",
+          offsetof(shard_stats_t, moved), false },
+        { "shard_pipeline_devices", "Devices known to the shard", offsetof(shard_stats_t, devices), true },
+    };
+    if (!registry) {
+        respond(in, c, 404, NULL, "{\"error\":\"Metrics disabled\"}");
+        return;
+    }
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+    if (!out) {
+        respond(in, c, 503, NULL, "{\"error\":\"Out of memory\"}");
+        return;
+    }
+    metrics_write_prometheus(registry, out);
+
+    unsigned shards = opt.shards[0];
+    shard_stats_t st[SHARD_PIPELINE_MAX_SHARDS];
+    for (unsigned s = 0; s < shards; s++) shard_pipeline_stats(pipeline, s, &st[s]);
+    for (size_t i = 0; i < sizeof(shard_series) / sizeof(shard_series[0]); i++) {
+        fprintf(out, "# HELP %s %s\n# TYPE %s %s\n", shard_series[i].name, shard_series[i].help,
+                shard_series[i].name, shard_series[i].gauge ? "gauge" : "counter");
+        for (unsigned s = 0; s < shards; s++) {
+            uint64_t v;
+            memcpy(&v, (const char *)&st[s] + shard_series[i].field, sizeof(v));
+            fprintf(out, "%s{shard=\"%u\"} %llu\n", shard_series[i].name, s, (unsigned long long)v);
+        }
+    }
+    uint64_t requests = 0, shed = 0, rejected = 0, callbacks = 0;
+    for (unsigned i = 0; i < opt.ingress; i++) {
+        requests += atomic_load_explicit(&ingress[i].requests, memory_order_relaxed);
+        shed += atomic_load_explicit(&ingress[i].shed, memory_order_relaxed);
+        rejected += atomic_load_explicit(&ingress[i].rejected, memory_order_relaxed);
+        callbacks += atomic_load_explicit(&ingress[i].callbacks, memory_order_relaxed);
+    }
+    fprintf(out,
+            "# HELP shard_receiver_requests_total Payloads handed to a shard\n"
+            "# TYPE shard_receiver_requests_total counter\nshard_receiver_requests_total %llu\n"
+            "# HELP shard_receiver_shed_total Requests answered 503 (shard busy)\n"
+            "# TYPE shard_receiver_shed_total counter\nshard_receiver_shed_total %llu\n"
+            "# HELP shard_receiver_rejected_total Payloads rejected by the ingress (400, 413)\n"
+            "# TYPE shard_receiver_rejected_total counter\nshard_receiver_rejected_total %llu\n"
+            "# HELP shard_receiver_callbacks_total Astrocast callback messages read\n"
+            "# TYPE shard_receiver_callbacks_total counter\nshard_receiver_callbacks_total %llu\n",
+            (unsigned long long)requests, (unsigned long long)shed, (unsigned long long)rejected,
+            (unsigned long long)callbacks);
+    if (cluster) {
+        uint64_t redirected = 0, moving = 0;
+        for (unsigned i = 0; i < opt.ingress; i++) {
+            redirected += atomic_load_explicit(&ingress[i].redirected, memory_order_relaxed);
+            moving += atomic_load_explicit(&ingress[i].moving, memory_order_relaxed);
+        }
+        cluster_stats_t cs;
+        cluster_stats(cluster, &cs);
+        fprintf(out,
+                "# HELP cluster_redirected_total Payloads answered 307 (owned by another node)\n"
+                "# TYPE cluster_redirected_total counter\ncluster_redirected_total %llu\n"
+                "# HELP cluster_moving_total Payloads answered 503 (partition moving or owner down)\n"
+                "# TYPE cluster_moving_total counter\ncluster_moving_total %llu\n"
+                "# HELP cluster_partitions_owned Partitions whose devices this node holds\n"
+                "# TYPE cluster_partitions_owned gauge\ncluster_partitions_owned %u\n"
+                "# HELP cluster_members_up Members heard from within fail-after, this node included\n"
+                "# TYPE cluster_members_up gauge\ncluster_members_up %u\n"
+                "# HELP cluster_partitions_moved_total Partitions handed over, by direction\n"
+                "# TYPE cluster_partitions_moved_total counter\n"
+                "cluster_partitions_moved_total{direction=\"out\"} %llu\n"
+                "cluster_partitions_moved_total{direction=\"in\"} %llu\n"
+                "# HELP cluster_transfer_errors_total Transfers the target did not take\n"
+                "# TYPE cluster_transfer_errors_total counter\ncluster_transfer_errors_total %llu\n",
+                (unsigned long long)redirected, (unsigned long long)moving, cs.owned, cs.up,
+                (unsigned long long)cs.partitions_out, (unsigned long long)cs.partitions_in,
+                (unsigned long long)cs.transfer_errors);
+    }
+    if (fclose(out) != 0) {
+        free(text);
+        respond(in, c, 503, NULL, "{\"error\":\"Out of memory\"}");
+        return;
+    }
+    respond_large(in, c, "text/plain; version=0.0.4", text, len);
+}
+
+static void handle_cluster_map(ingress_t *in, conn_t *c) {
+    size_t len;
+    char *text = cluster ? cluster_map(cluster, &len) : NULL;
+    if (!text) respond(in, c, 404, NULL, cluster ? "{\"error\":\"Out of memory\"}" : "{\"error\":\"Not clustered\"}");
+    else respond_large(in, c, "text/plain", text, len);
+}
+
+typedef enum { SUBMIT_OK, SUBMIT_NO_DEVICE, SUBMIT_INVALID, SUBMIT_BUSY, SUBMIT_REMOTE, SUBMIT_MOVING } submit_result_t;
+
+// Keys one payload and hands it to its shard. body may be in->item.payload
+// (decoded there by the callback path); t0 is the parse time when timed.
+// In a cluster, SUBMIT_REMOTE leaves the owner's address in in->owner.
+static submit_result_t submit_payload(ingress_t *in, conn_t *c, const char *device, const uint8_t *body, size_t len,
+                                      uint64_t t0) {
+    shard_item_t *it = &in->item;
+    container_codec_t codec = opt.codec;
+    it->seq = 0;
+    it->dedup = 0;
+    it->decoded = false;
+    it->codec = (uint8_t)codec;
+    if (struct_codec(codec)) {
+        if ((body[0] & 0xF0) == DEFLATE_SESSION_MAGIC) {
+            if (!device[0]) {
+                atomic_fetch_add_explicit(&in->rejected, 1, memory_order_relaxed);
+                return SUBMIT_NO_DEVICE;
+            }
+            it->codec = SHARD_CODEC_SESSION;
+        } else {
+            codec = (body[0] & 0xF0) == RECORD_RANS_MAGIC ? CONTAINER_CODEC_STRUCT_RANS : CONTAINER_CODEC_STRUCT_ZLIB;
+            it->codec = (uint8_t)codec;
+        }
+    }
+
+    char id[DEVICE_ID_MAX];
+    int rc = 0;
+    if (device[0]) {
+        it->key = shard_pipeline_key(device);
+    } else if (struct_codec(codec)) {
+        rc = container_codec_decode_record(codec, body, len, &it->rec);
+        it->decoded = rc == 0;
+        it->key = shard_pipeline_key(it->rec.iso6346);
+    } else {
+        rc = container_codec_peek_iso6346(codec, body, len, id, sizeof(id));
+        it->key = shard_pipeline_key(id);
+    }
+    if (rc != 0) {
+        atomic_fetch_add_explicit(&in->rejected, 1, memory_order_relaxed);
+        return SUBMIT_INVALID;
+    }
+    if (cluster) {
+        cluster_route_t route = cluster_route(cluster, it->key, in->owner, sizeof(in->owner));
+        if (route == CLUSTER_REMOTE) {
+            atomic_fetch_add_explicit(&in->redirected, 1, memory_order_relaxed);
+            return SUBMIT_REMOTE;
+        }
+        if (route == CLUSTER_UNAVAILABLE) {
+            atomic_fetch_add_explicit(&in->moving, 1, memory_order_relaxed);
+            return SUBMIT_MOVING;
+        }
+    }
+
+    if (opt.dedup_window_s > 0.0) it->dedup = dedup_key(it->key, dedup_hash(body, len));
+
+    unsigned shard = shard_pipeline_route(pipeline, it->key);
+    uint32_t slot = (uint32_t)(c - in->conns);
+    it->token = (uint64_t)c->gen << 32 | (uint64_t)shard << 24 | slot;
+    it->len = (uint16_t)len;
+    if (!it->decoded && body != it->payload) memcpy(it->payload, body, len);
+    if (in->inflight[shard] >= opt.ring_slots || shard_pipeline_submit(pipeline, in->index, it) != 0) {
+        atomic_fetch_add_explicit(&in->shed, 1, memory_order_relaxed);
+        return SUBMIT_BUSY;
+    }
+    in->inflight[shard]++;
+    atomic_fetch_add_explicit(&in->requests, 1, memory_order_relaxed);
+    c->pending++;
+    c->codec = it->codec;
+    if (t0) {
+        metrics_observe(in->metrics, shard_pipeline_stage_series(pipeline, SHARD_STAGE_RECEIVE, it->codec),
+                        metrics_now_ns() - t0);
+    }
+    return SUBMIT_OK;
+}
+
+static void handle_data(ingress_t *in, conn_t *c, const request_t *rq, const uint8_t *body) {
+    if (rq->body_len == 0 || rq->body_len > SHARD_ITEM_PAYLOAD_MAX) {
+        atomic_fetch_add_explicit(&in->rejected, 1, memory_order_relaxed);
+        respond(in, c, rq->body_len ? 413 : 400, NULL, "{\"error\":\"Invalid payload size\"}");
+        return;
+    }
+    uint64_t t0 = in->metrics && !(in->ticks++ & (opt.metrics_sample - 1)) ? metrics_now_ns() : 0;
+    switch (submit_payload(in, c, rq->device, body, rq->body_len, t0)) {
+    case SUBMIT_OK:
+        c->callback = false;
+        c->started_ns = t0;
+        break;
+    case SUBMIT_NO_DEVICE:
+        respond(in, c, 400, NULL,
+                "{\"error\":\"Missing device id\",\"message\":\"Session-deflate payloads require the "
+                "X-Device-Id header\"}");
+        break;
+    case SUBMIT_INVALID: respond(in, c, 400, NULL, "{\"error\":\"Invalid payload\"}"); break;
+    case SUBMIT_BUSY: respond(in, c, 503, "Retry-After: 1\r\n", "{\"error\":\"Shard busy\"}"); break;
+    case SUBMIT_REMOTE: respond_redirect(in, c, in->owner, "/container-data"); break;
+    case SUBMIT_MOVING: respond(in, c, 503, "Retry-After: 1\r\n", "{\"error\":\"Partition moving\"}"); break;
+    }
+}
+
+// 400 when every message was invalid. 503 when any was shed or belongs
+// to another node (moved): the sender resends the whole callback, and
+// the duplicate filter drops the messages already taken
+static void respond_callback(ingress_t *in, conn_t *c) {
+    const uint16_t *t = c->tally;
+    unsigned messages = 0;
+    for (int i = 0; i < TALLY_COUNT; i++) messages += t[i];
+    int status = messages && t[TALLY_INVALID] == messages ? 400 : t[TALLY_SHED] || t[TALLY_MOVED] ? 503 : 200;
+    char body[256];
+    snprintf(body, sizeof(body),
+             "{\"status\":\"astrocast-received\",\"messages\":%u,\"received\":%u,\"duplicates\":%u,"
+             "\"invalid\":%u,\"resync\":%u,\"shed\":%u,\"moved\":%u}",
+             messages, t[TALLY_RECEIVED], t[TALLY_DUPLICATE], t[TALLY_INVALID], t[TALLY_RESYNC], t[TALLY_SHED],
+             t[TALLY_MOVED]);
+    respond(in, c, status, t[TALLY_SHED] || t[TALLY_MOVED] ? "Retry-After: 1\r\n" : NULL, body);
+}
+
+static void handle_callback(ingress_t *in, conn_t *c, const request_t *rq, const uint8_t *body) {
+    astrocast_reader_t r;
+    if (astrocast_reader_init(&r, (const char *)body, rq->body_len) != 0) {
+        atomic_fetch_add_explicit(&in->rejected, 1, memory_order_relaxed);
+        respond(in, c, 400, NULL, "{\"error\":\"Invalid callback body\"}");
+        return;
+    }
+    uint64_t t0 = in->metrics && !(in->ticks++ & (opt.metrics_sample - 1)) ? metrics_now_ns() : 0;
+    memset(c->tally, 0, sizeof(c->tally));
+    c->callback = true;
+    c->started_ns = t0;
+
+    // Every message goes out as soon as it is read; a malformed tail is
+    // counted as one invalid message. A callback whose messages all belong
+    // to one other node is redirected there whole.
+    astrocast_msg_t m;
+    int rc;
+    unsigned messages = 0, remote = 0;
+    bool one_owner = true;
+    char owner[CLUSTER_ADDR_MAX] = "";
+    while ((rc = astrocast_reader_next(&r, &m)) != 0) {
+        atomic_fetch_add_explicit(&in->callbacks, 1, memory_order_relaxed);
+        char device[DEVICE_ID_MAX] = "";
+        if (m.device_guid && m.device_guid_len < DEVICE_ID_MAX) {
+            memcpy(device, m.device_guid, m.device_guid_len);
+            device[m.device_guid_len] = '\0';
+        }
+        long n = rc > 0 ? astrocast_msg_payload(&m, in->item.payload, SHARD_ITEM_PAYLOAD_MAX) : -1;
+        submit_result_t res = n > 0 ? submit_payload(in, c, device, in->item.payload, (size_t)n, t0) : SUBMIT_INVALID;
+        if (n <= 0) atomic_fetch_add_explicit(&in->rejected, 1, memory_order_relaxed);
+        messages++;
+        if (res == SUBMIT_BUSY) {
+            c->tally[TALLY_SHED]++;
+        } else if (res == SUBMIT_REMOTE || res == SUBMIT_MOVING) {
+            c->tally[TALLY_MOVED]++;
+            if (res == SUBMIT_REMOTE && !remote++) strcpy(owner, in->owner);
+            else if (res == SUBMIT_REMOTE && strcmp(owner, in->owner)) one_owner = false;
+        } else if (res != SUBMIT_OK) {
+            c->tally[TALLY_INVALID]++;
+        }
+        if (rc < 0) break;
+    }
+    if (c->pending) return;
+    if (remote && remote == messages && one_owner) respond_redirect(in, c, owner, "/astrocast-callback");
+    else respond_callback(in, c);
+}
+
+// Handles buffered requests one at a time; stops while a shard holds one
+static void conn_serve(ingress_t *in, conn_t *c) {
+    while (c->fd >= 0 && !c->pending && !c->close_after && !c->obuf) {
+        request_t rq;
+        int rc = parse_request(c, &rq);
+        if (rc == 0) return;
+        if (rc < 0) {
+            c->close_after = true;
+            respond(in, c, 400, NULL, "{\"error\":\"Bad request\"}");
+            return;
+        }
+        c->close_after = rq.close;
+        const uint8_t *body = (const uint8_t *)c->rbuf + rq.header_len;
+        if (route_is(&rq, "POST", "/container-data")) handle_data(in, c, &rq, body);
+        else if (route_is(&rq, "POST", "/astrocast-callback")) handle_callback(in, c, &rq, body);
+        else if (route_is(&rq, "GET", "/stats")) handle_stats(in, c);
+        else if (route_is(&rq, "GET", "/metrics")) handle_metrics(in, c);
+        else if (route_is(&rq, "GET", "/cluster/map")) handle_cluster_map(in, c);
+        else if (route_is(&rq, "GET", "/health")) respond(in, c, 200, NULL, "{\"status\":\"healthy\"}");
+        else respond(in, c, 404, NULL, "{\"error\":\"Not found\"}");
+        if (c->fd < 0) return;
+        size_t used = rq.header_len + rq.body_len;
+        memmove(c->rbuf, c->rbuf + used, c->rlen - used);
+        c->rlen -= used;
+    }
+}
+
+static void conn_read(ingress_t *in, conn_t *c) {
+    for (;;) {
+        if (c->rlen == RBUF_SIZE) break;
+        ssize_t n = recv(c->fd, c->rbuf + c->rlen, RBUF_SIZE - c->rlen, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            if (!c->pending) {
+                conn_close(in, c);
+                return;
+            }
+            // Answer the request the shard holds, then close; stop polling the EOF
+            struct epoll_event e = { .events = 0, .data.u64 = (uint64_t)(c - in->conns) };
+            epoll_ctl(in->epfd, EPOLL_CTL_MOD, c->fd, &e);
+            c->close_after = true;
+            return;
+        }
+        c->rlen += (size_t)n;
+    }
+    conn_serve(in, c);
+}
+
+static void drain_replies(ingress_t *in) {
+    shard_reply_t rep[256];
+    size_t n;
+    while ((n = shard_pipeline_replies(pipeline, in->index, rep, 256)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            uint32_t slot = (uint32_t)(rep[i].token & 0xFFFFFF);
+            in->inflight[(rep[i].token >> 24) & 0xFF]--;
+            conn_t *c = &in->conns[slot];
+            if (c->fd < 0 || c->gen != (uint32_t)(rep[i].token >> 32)) continue;
+            c->pending--;
+            if (c->callback) {
+                uint16_t s = rep[i].status;
+                c->tally[s == SHARD_STATUS_OK ? TALLY_RECEIVED : s == SHARD_STATUS_DUPLICATE ? TALLY_DUPLICATE
+                         : s == SHARD_STATUS_RESYNC ? TALLY_RESYNC : s == SHARD_STATUS_MOVED ? TALLY_MOVED
+                         : TALLY_INVALID]++;
+                if (c->pending) continue;
+            }
+            if (c->started_ns)
+                metrics_observe(in->metrics, shard_pipeline_stage_series(pipeline, SHARD_STAGE_REQUEST, c->codec),
+                                metrics_now_ns() - c->started_ns);
+            bool closing = c->close_after;
+            if (c->callback) respond_callback(in, c);
+            else respond_status(in, c, rep[i].status);
+            if (!closing) conn_serve(in, c);
+        }
+    }
+}
+
+static void accept_all(ingress_t *in) {
+    for (;;) {
+        int fd = accept4(in->lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (!in->free_count) {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        uint32_t slot = in->free_slots[--in->free_count];
+        conn_t *c = &in->conns[slot];
+        c->fd = fd;
+        c->pending = 0;
+        c->close_after = false;
+        c->rlen = c->wlen = c->woff = 0;
+        struct epoll_event e = { .events = EPOLLIN, .data.u64 = slot };
+        epoll_ctl(in->epfd, EPOLL_CTL_ADD, fd, &e);
+    }
+}
+
+static void *ingress_main(void *arg) {
+    ingress_t *in = arg;
+    struct epoll_event events[256];
+    while (!atomic_load_explicit(&ingress_stop, memory_order_relaxed)) {
+        int n = epoll_wait(in->epfd, events, 256, 200);
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == TAG_LISTEN) {
+                accept_all(in);
+            } else if (tag == TAG_REPLIES) {
+                drain_replies(in);
+            } else {
+                conn_t *c = &in->conns[tag];
+                if (c->fd < 0) continue;
+                if (events[i].events & EPOLLOUT) {
+                    conn_flush(in, c);
+                    if (c->fd >= 0 && !c->wlen) conn_serve(in, c);   // requests held behind a large response
+                }
+                if (c->fd >= 0 && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) conn_read(in, c);
+            }
+        }
+    }
+    return NULL;
+}
+
+static int ingress_init(ingress_t *in, unsigned index) {
+    in->index = index;
+    in->lfd = open_listener();
+    in->epfd = epoll_create1(EPOLL_CLOEXEC);
+    in->conns = calloc(MAX_CONNS, sizeof(*in->conns));
+    in->free_slots = malloc(MAX_CONNS * sizeof(*in->free_slots));
+    if (in->lfd < 0 || in->epfd < 0 || !in->conns || !in->free_slots) return -1;
+    for (uint32_t i = 0; i < MAX_CONNS; i++) {
+        in->conns[i].fd = -1;
+        in->free_slots[i] = MAX_CONNS - 1 - i;
+    }
+    in->free_count = MAX_CONNS;
+    if (registry && !(in->metrics = metrics_block(registry))) return -1;
+    struct epoll_event l = { .events = EPOLLIN, .data.u64 = TAG_LISTEN };
+    struct epoll_event r = { .events = EPOLLIN, .data.u64 = TAG_REPLIES };
+    epoll_ctl(in->epfd, EPOLL_CTL_ADD, in->lfd, &l);
+    epoll_ctl(in->epfd, EPOLL_CTL_ADD, shard_pipeline_reply_fd(pipeline, index), &r);
+    return 0;
+}
+
+static void print_stats(double t) {
+    shard_stats_t tot = { 0 };
+    uint64_t max = 0;
+    for (unsigned s = 0; s < opt.shards[0]; s++) {
+        shard_stats_t st;
+        shard_pipeline_stats(pipeline, s, &st);
+        uint64_t *tv = (uint64_t *)&tot, *sv = (uint64_t *)&st;
+        for (size_t i = 0; i < sizeof(st) / sizeof(uint64_t); i++) tv[i] += sv[i];
+        if (st.records > max) max = st.records;
+    }
+    uint64_t shed = 0;
+    for (unsigned i = 0; i < opt.ingress; i++) shed += atomic_load_explicit(&ingress[i].shed, memory_order_relaxed);
+    double mean = (double)tot.records / opt.shards[0];
+    printf("%8.1fs  records %10llu  bad %6llu  resync %5llu  dup %6llu  order %4llu  shed %6llu  devices %7llu  "
+           "balance %.2f",
+           t, (unsigned long long)tot.records, (unsigned long long)tot.bad, (unsigned long long)tot.resyncs,
+           (unsigned long long)tot.duplicates,
+           (unsigned long long)tot.order_violations, (unsigned long long)shed, (unsigned long long)tot.devices,
+           mean > 0.0 ? max / mean : 1.0);
+    if (cluster) {
+        cluster_stats_t cs;
+        cluster_stats(cluster, &cs);
+        printf("  owned %4u/%u  up %u  moved out %llu in %llu", cs.owned, opt.partitions, cs.up,
+               (unsigned long long)cs.partitions_out, (unsigned long long)cs.partitions_in);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static int run_http(void) {
+    if (opt.metrics && !(registry = metrics_create())) {
+        fprintf(stderr, "cannot allocate the metrics registry\n");
+        return 1;
+    }
+    shard_pipeline_config_t cfg;
+    pipeline_config(&cfg, opt.shards[0], true);
+    pipeline = shard_pipeline_start(&cfg);
+    ingress = calloc(opt.ingress, sizeof(*ingress));
+    if (!pipeline || !ingress) {
+        fprintf(stderr, "cannot start the shard pipeline\n");
+        return 1;
+    }
+    for (unsigned i = 0; i < opt.ingress; i++) {
+        if (ingress_init(&ingress[i], i) != 0) {
+            fprintf(stderr, "cannot listen on %s:%u\n", opt.host[0] ? opt.host : "*", opt.port);
+            return 1;
+        }
+    }
+    if (opt.cluster) {
+        cluster_config_t cc = {
+            .name = opt.node_name,
+            .gossip = opt.cluster,
+            .http = opt.advertise,
+            .join = opt.join,
+            .partitions = opt.partitions,
+            .fail_after_s = opt.fail_after_s,
+            .pipeline = pipeline,
+            .ingress = opt.ingress,
+        };
+        if (!(cluster = cluster_start(&cc))) {
+            fprintf(stderr, "cannot start the cluster on %s\n", opt.cluster);
+            return 1;
+        }
+    }
+    for (unsigned i = 0; i < opt.ingress; i++) pthread_create(&ingress[i].thread, NULL, ingress_main, &ingress[i]);
+    printf("listening on %s:%u, codec %s, %u ingress, %u shards, %zu ring slots%s", opt.host[0] ? opt.host : "*",
+           opt.port, container_codec_name(opt.codec), opt.ingress, opt.shards[0], opt.ring_slots,
+           opt.pin ? ", pinned" : "");
+    if (opt.dedup_window_s > 0.0)
+        printf(", dedup %.0f s x %zu keys per shard", opt.dedup_window_s, opt.dedup_capacity);
+    if (cluster)
+        printf(", node %s (gossip %s, %u partitions%s%s)", opt.node_name, opt.cluster, opt.partitions,
+               opt.join ? ", joining " : "", opt.join ? opt.join : "");
+    printf("\n");
+    fflush(stdout);
+
+    double t0 = now_s(), next = opt.stats_s > 0.0 ? t0 + opt.stats_s : 0.0;
+    while (!stop) {
+        usleep(100000);
+        if (next > 0.0 && now_s() >= next) {
+            print_stats(now_s() - t0);
+            next += opt.stats_s;
+        }
+    }
+    // Hand the partitions over while the ingress threads still redirect
+    if (cluster && cluster_leave(cluster, 10.0) != 0) fprintf(stderr, "left with partitions no one took\n");
+    atomic_store(&ingress_stop, true);
+    for (unsigned i = 0; i < opt.ingress; i++) pthread_join(ingress[i].thread, NULL);
+    print_stats(now_s() - t0);
+    cluster_stop(cluster);
+    shard_pipeline_stop(pipeline, NULL);
+    metrics_destroy(registry);
+    return 0;
+}
+
+// ================= BENCH =================
+typedef struct {
+    unsigned index;
+    pthread_t thread;
+    size_t count;
+    uint64_t *key, *seq, *dedup;
+    uint32_t *off;
+    uint16_t *len;
+    uint8_t *data;
+    uint8_t codec;
+    uint64_t full;                        // submits refused by a full ring
+} producer_t;
+
+static atomic_int bench_go;
+
+static int producer_build(producer_t *pr, unsigned producers) {
+    unsigned devices = 0;
+    for (unsigned d = pr->index; d < opt.devices; d += producers) devices++;
+    size_t count = opt.records / producers + (pr->index < opt.records % producers);
+    if (!devices) count = 0;
+    // Room for a copy of every record (--duplicates)
+    pr->key = malloc((2 * count + 1) * sizeof(*pr->key));
+    pr->seq = malloc((2 * count + 1) * sizeof(*pr->seq));
+    pr->dedup = malloc((2 * count + 1) * sizeof(*pr->dedup));
+    pr->off = malloc((2 * count + 1) * sizeof(*pr->off));
+    pr->len = malloc((2 * count + 1) * sizeof(*pr->len));
+    size_t cap = count * 64 + CONTAINER_CODEC_MAX_PAYLOAD;
+    pr->data = malloc(cap);
+    container_trace_t *traces = calloc(devices + 1, sizeof(*traces));
+    deflate_session_t *sessions = opt.session ? calloc(devices + 1, sizeof(*sessions)) : NULL;
+    uint64_t *keys = malloc((devices + 1) * sizeof(*keys));
+    if (!pr->key || !pr->seq || !pr->dedup || !pr->off || !pr->len || !pr->data || !traces || !keys ||
+        (opt.session && !sessions)) {
+        free(traces);
+        free(sessions);
+        free(keys);
+        return -1;
+    }
+    for (unsigned j = 0; j < devices; j++) {
+        unsigned d = pr->index + j * producers;
+        char id[32];
+        snprintf(id, sizeof(id), "dev-%u", d);
+        keys[j] = shard_pipeline_key(id);
+        container_trace_init(&traces[j], opt.seed + d, 1735689600, 60);
+        if (sessions) deflate_session_init(&sessions[j], 6, DEFLATE_SESSION_KEYFRAME_INTERVAL);
+    }
+
+    size_t pos = 0, n_items = 0;
+    uint64_t rng = (opt.seed + pr->index) * 0x9E3779B97F4A7C15ull | 1;
+    int rc = 0;
+    pr->codec = opt.session ? SHARD_CODEC_SESSION : (uint8_t)opt.codec;
+    for (size_t i = 0; i < count && !rc; i++) {
+        unsigned j = (unsigned)(i % devices);
+        container_record_t rec;
+        container_trace_next(&traces[j], &rec);
+        if (pos + CONTAINER_CODEC_MAX_PAYLOAD > cap) {
+            uint8_t *grown = realloc(pr->data, cap * 2);
+            if (!grown) {
+                rc = -1;
+                break;
+            }
+            pr->data = grown;
+            cap *= 2;
+        }
+        int n;
+        if (sessions) {
+            uint8_t packed[CONTAINER_RECORD_STRUCT_MAX];
+            size_t plen = container_record_pack_struct(&rec, packed, sizeof(packed));
+            n = deflate_session_compress(&sessions[j], packed, plen, pr->data + pos,
+                                         CONTAINER_CODEC_MAX_PAYLOAD);
+        } else {
+            n = (int)container_codec_encode(opt.codec, &rec, pr->data + pos, CONTAINER_CODEC_MAX_PAYLOAD);
+        }
+        if (n <= 0) {
+            rc = -1;
+            break;
+        }
+        // A retry resends the same bytes right behind the original
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int copies = (rng >> 11) * (1.0 / 9007199254740992.0) < opt.duplicates ? 2 : 1;
+        for (int c = 0; c < copies; c++, n_items++) {
+            pr->key[n_items] = keys[j];
+            pr->seq[n_items] = i / devices + 1;
+            pr->dedup[n_items] = dedup_key(keys[j], dedup_hash(pr->data + pos, (size_t)n));
+            pr->off[n_items] = (uint32_t)pos;
+            pr->len[n_items] = (uint16_t)n;
+        }
+        pos += (size_t)n;
+    }
+    pr->count = n_items;
+    for (unsigned j = 0; sessions && j < devices; j++) deflate_session_end(&sessions[j]);
+    free(traces);
+    free(sessions);
+    free(keys);
+    return rc;
+}
+
+static void producer_free(producer_t *pr) {
+    free(pr->key);
+    free(pr->seq);
+    free(pr->dedup);
+    free(pr->off);
+    free(pr->len);
+    free(pr->data);
+}
+
+static void *producer_main(void *arg) {
+    producer_t *pr = arg;
+    shard_item_t *it = malloc(sizeof(*it));
+    if (!it) return NULL;
+    while (!atomic_load(&bench_go)) sched_yield();
+    it->op = 0;
+    it->decoded = false;
+    it->codec = pr->codec;
+    for (size_t i = 0; i < pr->count; i++) {
+        it->key = pr->key[i];
+        it->token = i;
+        it->seq = pr->seq[i];
+        it->dedup = opt.dedup_window_s > 0.0 ? pr->dedup[i] : 0;
+        it->len = pr->len[i];
+        memcpy(it->payload, pr->data + pr->off[i], it->len);
+        while (shard_pipeline_submit(pipeline, pr->index, it) != 0) {
+            pr->full++;
+            sched_yield();
+        }
+    }
+    free(it);
+    return NULL;
+}
+
+static int run_bench(void) {
+    producer_t *prod = calloc(opt.ingress, sizeof(*prod));
+    if (!prod) return 1;
+    size_t total = 0;
+    for (unsigned i = 0; i < opt.ingress; i++) {
+        prod[i].index = i;
+        if (producer_build(&prod[i], opt.ingress) != 0) {
+            fprintf(stderr, "cannot encode the bench records\n");
+            return 1;
+        }
+        total += prod[i].count;
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("%zu records (%zu copies), %u devices, codec %s, %u producers, %ld online CPUs", opt.records,
+           total - opt.records, opt.devices, opt.session ? "session" : container_codec_name(opt.codec), opt.ingress,
+           cpus);
+    if (opt.dedup_window_s > 0.0) printf(", dedup %zu keys per shard", opt.dedup_capacity);
+    printf("\n\n%6s %12s %8s %8s %8s %6s %8s %8s %8s\n", "shards", "items/s", "speedup", "balance", "order", "bad",
+           "dups", "sleeps", "full");
+
+    double base = 0.0;
+    for (unsigned r = 0; r < opt.shard_count; r++) {
+        unsigned shards = opt.shards[r];
+        if (opt.metrics && !(registry = metrics_create())) {
+            fprintf(stderr, "cannot allocate the metrics registry\n");
+            return 1;
+        }
+        shard_pipeline_config_t cfg;
+        pipeline_config(&cfg, shards, false);
+        pipeline = shard_pipeline_start(&cfg);
+        if (!pipeline) {
+            fprintf(stderr, "cannot start %u shards\n", shards);
+            return 1;
+        }
+        int wait_id = shard_pipeline_stage_series(pipeline, SHARD_STAGE_QUEUE_WAIT, prod[0].codec);
+        int decode_id = shard_pipeline_stage_series(pipeline, SHARD_STAGE_DECODE, prod[0].codec);
+        atomic_store(&bench_go, 0);
+        for (unsigned i = 0; i < opt.ingress; i++) {
+            prod[i].full = 0;
+            pthread_create(&prod[i].thread, NULL, producer_main, &prod[i]);
+        }
+        double t0 = now_s();
+        atomic_store(&bench_go, 1);
+        for (unsigned i = 0; i < opt.ingress; i++) pthread_join(prod[i].thread, NULL);
+
+        // Drained when every submitted item has been processed
+        uint64_t per_shard[SHARD_PIPELINE_MAX_SHARDS], items;
+        shard_stats_t tot;
+        do {
+            items = 0;
+            memset(&tot, 0, sizeof(tot));
+            for (unsigned s = 0; s < shards; s++) {
+                shard_stats_t st;
+                shard_pipeline_stats(pipeline, s, &st);
+                uint64_t *tv = (uint64_t *)&tot, *sv = (uint64_t *)&st;
+                for (size_t i = 0; i < sizeof(st) / sizeof(uint64_t); i++) tv[i] += sv[i];
+                per_shard[s] = st.records;
+            }
+            items = tot.items;
+            if (items < total) sched_yield();
+        } while (items < total);
+        double dt = now_s() - t0;
+        shard_pipeline_stop(pipeline, NULL);
+
+        uint64_t max = 0, full = 0;
+        for (unsigned s = 0; s < shards; s++) max = per_shard[s] > max ? per_shard[s] : max;
+        for (unsigned i = 0; i < opt.ingress; i++) full += prod[i].full;
+        double rate = total / dt, mean = (double)tot.records / shards;
+        if (r == 0) base = rate;
+        printf("%6u %12.0f %7.2fx %8.2f %8llu %6llu %8llu %8llu %8llu\n", shards, rate, rate / base,
+               mean > 0.0 ? max / mean : 1.0, (unsigned long long)tot.order_violations,
+               (unsigned long long)tot.bad, (unsigned long long)tot.duplicates, (unsigned long long)tot.sleeps,
+               (unsigned long long)full);
+        if (tot.dedup_over_quota)
+            printf("       %llu records not remembered: devices over --dedup-per-device\n",
+                   (unsigned long long)tot.dedup_over_quota);
+        if (registry) {
+            printf("       queue wait p50 %.1f us, p99 %.1f us; decode p50 %.2f us, p99 %.2f us\n",
+                   metrics_percentile(registry, wait_id, 50.0) / 1e3, metrics_percentile(registry, wait_id, 99.0) / 1e3,
+                   metrics_percentile(registry, decode_id, 50.0) / 1e3,
+                   metrics_percentile(registry, decode_id, 99.0) / 1e3);
+            metrics_destroy(registry);
+            registry = NULL;
+        }
+        fflush(stdout);
+    }
+    for (unsigned i = 0; i < opt.ingress; i++) producer_free(&prod[i]);
+    free(prod);
+    return 0;
+}
+
+// ================= MAIN =================
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --listen [ADDR:]PORT  HTTP listen address (default 3000)\n"
+            "  --codec NAME          cbor, msgpack, protobuf, struct-zlib, struct-rans (default cbor);\n"
+            "                        the struct codecs also take rANS and session-deflate payloads;\n"
+            "                        --bench also takes session\n"
+            "  --ingress N           ingress threads, or bench producers (default 1)\n"
+            "  --shards N[,N...]     shard threads; a list runs one bench per entry (default 1)\n"
+            "  --ring-slots N        slots per SPSC ring (default 1024)\n"
+            "  --pin                 pin shard i to CPU i\n"
+            "  --store DIR           append packed records to DIR/shard-NN.rec\n"
+            "  --forward HOST:PORT   forward packed records over UDP\n"
+            "  --dedup-window S      drop payloads a device resends within S seconds (default 0, off)\n"
+            "  --dedup-capacity N    duplicate filter keys per shard and window (default 262144)\n"
+            "  --dedup-per-device N  keys one device may add per window, 0 for no limit (default 0)\n"
+            "  --dedup-confirm N     exact cache entries per shard (default 2 x capacity)\n"
+            "  --dedup-strict        also drop fingerprint matches the exact cache cannot confirm\n"
+            "  --stats S             status line interval, 0 for none (default 5)\n"
+            "  --metrics 0|1         per-stage histograms and GET /metrics (default 1)\n"
+            "  --metrics-sample N    time one request in N, a power of two (default 32)\n"
+            "  --bench               in-process producers instead of HTTP\n"
+            "  --records N           bench records (default 1000000)\n"
+            "  --devices N           bench devices (default 1024)\n"
+            "  --seed N              bench trace seed (default 1)\n"
+            "  --duplicates P        bench: fraction of records sent twice (default 0)\n"
+            "  --cluster HOST:PORT   join a receiver cluster; gossip (UDP) and state transfers (TCP) here\n"
+            "  --node-name NAME      unique member name (default: the --cluster address)\n"
+            "  --advertise HOST:PORT HTTP address other members redirect to (default the listen\n"
+            "                        address, 127.0.0.1 for a wildcard host)\n"
+            "  --join HOST:PORT      --cluster address of a member; without it this node starts the\n"
+            "                        cluster and owns every partition\n"
+            "  --partitions N        device partitions, the same on every member (default 256)\n"
+            "  --fail-after S        silence before a member is down and loses its partitions (default 3)\n",
+            prog);
+}
+
+static int parse_listen(const char *v) {
+    const char *colon = strrchr(v, ':');
+    if (colon) {
+        size_t n = (size_t)(colon - v);
+        if (n >= sizeof(opt.host)) return -1;
+        memcpy(opt.host, v, n);
+        opt.host[n] = '\0';
+        v = colon + 1;
+    }
+    char *end;
+    unsigned long port = strtoul(v, &end, 10);
+    if (*end || port == 0 || port > 65535) return -1;
+    opt.port = (uint16_t)port;
+    return 0;
+}
+
+static int parse_shards(const char *v) {
+    opt.shard_count = 0;
+    while (*v) {
+        char *end;
+        unsigned long n = strtoul(v, &end, 10);
+        if (end == v || n == 0 || n > SHARD_PIPELINE_MAX_SHARDS || opt.shard_count == MAX_SHARD_LIST) return -1;
+        opt.shards[opt.shard_count++] = (unsigned)n;
+        v = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return -1;
+    }
+    return opt.shard_count ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+    opt.port = 3000;
+    opt.codec = CONTAINER_CODEC_CBOR;
+    opt.ingress = 1;
+    opt.shards[0] = 1;
+    opt.shard_count = 1;
+    opt.ring_slots = 1024;
+    opt.stats_s = 5.0;
+    opt.metrics = true;
+    opt.metrics_sample = 32;
+    opt.records = 1000000;
+    opt.devices = 1024;
+    opt.seed = 1;
+    opt.dedup_capacity = 262144;
+    opt.dedup_per_device = 0;
+    opt.partitions = 256;
+    opt.fail_after_s = 3.0;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (!strcmp(a, "--pin")) { opt.pin = true; continue; }
+        if (!strcmp(a, "--bench")) { opt.bench = true; continue; }
+        if (!strcmp(a, "--dedup-strict")) { opt.dedup_strict = true; continue; }
+        const char *v = i + 1 < argc ? argv[++i] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--listen")) {
+            if (parse_listen(v)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--codec")) {
+            opt.session = !strcmp(v, "session");
+            if (opt.session) opt.codec = CONTAINER_CODEC_STRUCT_ZLIB;
+            else if (container_codec_parse(v, &opt.codec)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--ingress")) opt.ingress = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--shards")) {
+            if (parse_shards(v)) { usage(argv[0]); return 2; }
+        } else if (!strcmp(a, "--ring-slots")) opt.ring_slots = strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--store")) opt.store_dir = v;
+        else if (!strcmp(a, "--forward")) opt.forward = v;
+        else if (!strcmp(a, "--dedup-window")) opt.dedup_window_s = atof(v);
+        else if (!strcmp(a, "--dedup-capacity")) opt.dedup_capacity = strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--dedup-per-device")) opt.dedup_per_device = strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--dedup-confirm")) opt.dedup_confirm = strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--stats")) opt.stats_s = atof(v);
+        else if (!strcmp(a, "--metrics")) opt.metrics = atoi(v) != 0;
+        else if (!strcmp(a, "--metrics-sample")) opt.metrics_sample = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--records")) opt.records = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--devices")) opt.devices = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--seed")) opt.seed = strtoull(v, NULL, 10);
+        else if (!strcmp(a, "--duplicates")) opt.duplicates = atof(v);
+        else if (!strcmp(a, "--cluster")) opt.cluster = v;
+        else if (!strcmp(a, "--node-name")) opt.node_name = v;
+        else if (!strcmp(a, "--advertise")) snprintf(opt.advertise, sizeof(opt.advertise), "%s", v);
+        else if (!strcmp(a, "--join")) opt.join = v;
+        else if (!strcmp(a, "--partitions")) opt.partitions = (unsigned)strtoul(v, NULL, 10);
+        else if (!strcmp(a, "--fail-after")) opt.fail_after_s = atof(v);
+        else { usage(argv[0]); return 2; }
+    }
+    if (opt.cluster) {
+        if (!opt.node_name) opt.node_name = opt.cluster;
+        if (!opt.advertise[0])
+            snprintf(opt.advertise, sizeof(opt.advertise), "%.100s:%u",
+                     opt.host[0] && strcmp(opt.host, "0.0.0.0") ? opt.host : "127.0.0.1", opt.port);
+    }
+    if (!opt.ingress || opt.ingress > SHARD_PIPELINE_MAX_INGRESS || opt.ring_slots < 2 ||
+        (opt.session && !opt.bench) || (!opt.bench && opt.shard_count != 1) || (opt.bench && !opt.devices) ||
+        (opt.dedup_window_s > 0.0 && !opt.dedup_capacity) || opt.duplicates < 0.0 || opt.duplicates > 1.0 ||
+        !opt.metrics_sample || (opt.metrics_sample & (opt.metrics_sample - 1)) ||
+        (opt.cluster && (opt.bench || opt.ingress + 2 > SHARD_PIPELINE_MAX_INGRESS || !opt.partitions ||
+                         opt.partitions > SHARD_PIPELINE_MAX_PARTITIONS || opt.fail_after_s <= 0.0))) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (record_rans_decoder_init() != 0) {
+        fprintf(stderr, "rANS model tables are inconsistent\n");
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    return opt.bench ? run_bench() : run_http();
+}
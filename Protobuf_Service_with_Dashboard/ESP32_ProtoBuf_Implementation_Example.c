@@ -12,25 +12,41 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
+#include "nvs.h"
 #include "driver/gpio.h"
 #include "driver/adc.h"
 #include "driver/i2c.h"
 #include "driver/spi_master.h"
 
-// Protocol Buffer generated header (from container_data.proto)
+// Protocol Buffer generated header (from container_data.proto + container_data.options)
 #include "container_data.pb.h"
 
+// Shock-event capture (Native_Toolkit/firmware/accel_burst.c)
+#include "accel_burst.h"
+
+// Authenticated encryption framing (Native_Toolkit/firmware/aead_frame.c)
+#include "aead_frame.h"
+
 // Configuration
 #define TAG "CONTAINER_DATA"
 #define TASK_STACK_SIZE 4096
 #define QUEUE_SIZE 10
 #define SENSOR_READ_INTERVAL_MS 5000
 #define TRANSMISSION_INTERVAL_MS 30000
+#define ACCEL_TASK_STACK_SIZE 3072
+#define ACCEL_SAMPLE_RATE_HZ 400        // accelerometer output data rate
+#define ACCEL_FIFO_READ_MS 40           // FIFO watermark period (16 samples at 400 Hz)
+#define ACCEL_FIFO_MAX_SAMPLES 32
+#define DEVICE_MSISDN "393600504800"    // SIM ID; also the AEAD nonce device ID the receiver keys on
+#define AEAD_TAG_LEN AEAD_FRAME_TAG_DEFAULT   // 6-byte tag, 8 bytes overhead per frame
+#define AEAD_SEQ_RESERVE 256            // sequence numbers reserved per NVS write
+#define AEAD_NVS_NAMESPACE "aead"
 
 // GPIO pins for sensors
 #define DOOR_SENSOR_PIN GPIO_NUM_4
@@ -54,6 +70,14 @@
 static QueueHandle_t data_queue;
 static TaskHandle_t sensor_task_handle;
 static TaskHandle_t transmission_task_handle;
+static TaskHandle_t accel_task_handle;
+
+// High-rate accelerometer ring and event detector, shared between the
+// accelerometer task (producer) and the sensor/transmission tasks
+static accel_burst_t accel_burst;
+static SemaphoreHandle_t accel_mutex;
+static aead_sender_t aead_sender;
+static uint32_t aead_seq_reserved;      // first sequence not yet covered by NVS
 
 // Container data structure (matches protobuf schema)
 typedef struct {
@@ -77,6 +101,8 @@ typedef struct {
     float heading;           // degrees
     uint8_t nsat;            // Number of satellites
     float hdop;              // HDOP
+    uint8_t shock[ACCEL_BURST_MAX_BYTES]; // Encoded shock burst (only when an event fired)
+    uint8_t shock_len;
 } container_data_t;
 
 // Function prototypes
@@ -87,6 +113,8 @@ static void read_sensors(container_data_t *data);
 static void generate_container_id(char *container_id);
 static void get_current_time(char *time_str);
 static void read_accelerometer(float *x, float *y, float *z);
+static size_t read_accelerometer_fifo(accel_sample_t *samples, size_t max_samples);
+static void attach_shock_burst(container_data_t *data);
 static void read_environmental_sensors(float *temp, float *hum, float *press);
 static void read_gps_data(float *lat, float *lon, float *alt, float *spd, float *hdg, uint8_t *nsat);
 static void read_door_status(char *status);
@@ -95,9 +123,12 @@ static void read_rssi(int16_t *rssi);
 static void read_cell_id(char *cell_id);
 static void read_ble_status(uint8_t *status);
 static size_t compress_to_protobuf(const container_data_t *data, uint8_t *buffer, size_t buffer_size);
+static esp_err_t init_aead_sender(void);
+static int seal_frame(uint8_t *frame, size_t payload_len, size_t cap);
 static void transmit_data(const uint8_t *data, size_t data_size);
 static void sensor_task(void *pvParameters);
 static void transmission_task(void *pvParameters);
+static void accel_task(void *pvParameters);
 
 // Hardware initialization
 static void init_hardware(void) {
@@ -202,7 +233,7 @@ static void read_sensors(container_data_t *data) {
     }
     
     // Set MSISDN (SIM ID - should be configured)
-    strcpy(data->msisdn, "393600504800"); // Default value
+    strcpy(data->msisdn, DEVICE_MSISDN);
     
     // Set GNSS status based on satellite count
     data->gnss = (data->nsat > 0) ? 1 : 0;
@@ -229,13 +260,37 @@ static void get_current_time(char *time_str) {
              timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec, 0);
 }
 
-// Read accelerometer data (I2C)
+// Read accelerometer data (latest sample from the high-rate ring)
 static void read_accelerometer(float *x, float *y, float *z) {
-    // Placeholder for actual accelerometer reading
-    // This would typically read from MPU6050, LIS3DH, or similar
-    *x = -993.9 + (rand() % 2000) / 1000.0;
-    *y = -27.1 + (rand() % 1000) / 1000.0;
-    *z = -52.0 + (rand() % 1000) / 1000.0;
+    xSemaphoreTake(accel_mutex, portMAX_DELAY);
+    accel_burst_latest(&accel_burst, x, y, z);
+    xSemaphoreGive(accel_mutex);
+}
+
+// Drain the accelerometer FIFO (I2C), samples in mg
+static size_t read_accelerometer_fifo(accel_sample_t *samples, size_t max_samples) {
+    // Placeholder for actual FIFO burst read
+    // This would typically read the LIS3DH/LIS2DW12 FIFO up to its watermark
+    size_t count = ACCEL_SAMPLE_RATE_HZ * ACCEL_FIFO_READ_MS / 1000;
+    if (count > max_samples) count = max_samples;
+    for (size_t i = 0; i < count; i++) {
+        samples[i].x = -994 + (rand() % 9) - 4;
+        samples[i].y = -27 + (rand() % 9) - 4;
+        samples[i].z = -52 + (rand() % 9) - 4;
+    }
+    return count;
+}
+
+// Attach the pending shock burst (if any) to the next uplink
+static void attach_shock_burst(container_data_t *data) {
+    xSemaphoreTake(accel_mutex, portMAX_DELAY);
+    size_t len = accel_burst_take(&accel_burst, data->shock, sizeof(data->shock));
+    xSemaphoreGive(accel_mutex);
+
+    data->shock_len = (uint8_t)len;
+    if (len > 0) {
+        ESP_LOGI(TAG, "Shock burst attached: %d bytes", (int)len);
+    }
 }
 
 // Read environmental sensors (I2C)
@@ -329,6 +384,12 @@ static size_t compress_to_protobuf(const container_data_t *data, uint8_t *buffer
     pb_data.heading = data->heading;
     pb_data.hdop = data->hdop;
     
+    // Shock burst is only present when an event fired since the last uplink
+    if (data->shock_len > 0) {
+        memcpy(pb_data.shock.bytes, data->shock, data->shock_len);
+        pb_data.shock.size = data->shock_len;
+    }
+    
     // Encode to buffer
     pb_ostream_t stream = pb_ostream_from_buffer(buffer, buffer_size);
     bool status = pb_encode(&stream, ContainerData_fields, &pb_data);
@@ -360,6 +421,74 @@ static void transmit_data(const uint8_t *data, size_t data_size) {
     ESP_LOGI(TAG, "Transmission complete");
 }
 
+// AEAD sender: key and sequence reserve live in NVS. The key is written at
+// provisioning; the device ID in the nonce is the numeric MSISDN.
+static esp_err_t init_aead_sender(void) {
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(AEAD_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) return ret;
+
+    uint8_t key[AEAD_FRAME_KEY_SIZE];
+    size_t key_len = sizeof(key);
+    ret = nvs_get_blob(nvs, "key", key, &key_len);
+    if (ret != ESP_OK || key_len != sizeof(key)) {
+        ESP_LOGE(TAG, "AEAD key not provisioned");
+        nvs_close(nvs);
+        return ret != ESP_OK ? ret : ESP_ERR_INVALID_SIZE;
+    }
+
+    // Skip past everything reserved before the last reboot so no
+    // sequence number (and so no nonce) is ever used twice
+    uint32_t next_seq = 0;
+    nvs_get_u32(nvs, "seq", &next_seq);
+    aead_seq_reserved = next_seq + AEAD_SEQ_RESERVE;
+    ret = nvs_set_u32(nvs, "seq", aead_seq_reserved);
+    if (ret == ESP_OK) ret = nvs_commit(nvs);
+    nvs_close(nvs);
+    if (ret != ESP_OK) return ret;
+
+    uint64_t device_id = strtoull(DEVICE_MSISDN, NULL, 10);
+    aead_sender_init(&aead_sender, key, device_id, AEAD_TAG_LEN, next_seq);
+    memset(key, 0, sizeof(key));
+    ESP_LOGI(TAG, "AEAD sender ready (seq %u)", (unsigned)next_seq);
+    return ESP_OK;
+}
+
+// Seal a frame in place, extending the NVS reserve when it runs out
+static int seal_frame(uint8_t *frame, size_t payload_len, size_t cap) {
+    if (aead_sender.next_seq >= aead_seq_reserved) {
+        nvs_handle_t nvs;
+        if (nvs_open(AEAD_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return AEAD_ERR_PARAM;
+        uint32_t reserve = aead_sender.next_seq + AEAD_SEQ_RESERVE;
+        esp_err_t ret = nvs_set_u32(nvs, "seq", reserve);
+        if (ret == ESP_OK) ret = nvs_commit(nvs);
+        nvs_close(nvs);
+        if (ret != ESP_OK) return AEAD_ERR_PARAM;
+        aead_seq_reserved = reserve;
+    }
+    return aead_frame_seal(&aead_sender, frame, payload_len, cap);
+}
+
+// Accelerometer task: feeds every sample through the shock detector
+static void accel_task(void *pvParameters) {
+    accel_sample_t samples[ACCEL_FIFO_MAX_SAMPLES];
+    TickType_t last_wake = xTaskGetTickCount();
+    
+    while (1) {
+        size_t count = read_accelerometer_fifo(samples, ACCEL_FIFO_MAX_SAMPLES);
+        
+        xSemaphoreTake(accel_mutex, portMAX_DELAY);
+        for (size_t i = 0; i < count; i++) {
+            if (accel_burst_push(&accel_burst, samples[i])) {
+                ESP_LOGW(TAG, "Shock event captured (peak %u mg)", accel_burst.capture_peak_mg);
+            }
+        }
+        xSemaphoreGive(accel_mutex);
+        
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(ACCEL_FIFO_READ_MS));
+    }
+}
+
 // Sensor reading task
 static void sensor_task(void *pvParameters) {
     container_data_t sensor_data = {0};
@@ -386,14 +515,22 @@ static void transmission_task(void *pvParameters) {
     while (1) {
         // Wait for data from sensor task
         if (xQueueReceive(data_queue, &data, portMAX_DELAY) == pdTRUE) {
-            // Compress to protobuf
-            size_t compressed_size = compress_to_protobuf(&data, protobuf_buffer, sizeof(protobuf_buffer));
+            attach_shock_burst(&data);
+            
+            // Compress to protobuf behind the AEAD header, leaving room for the tag
+            size_t compressed_size = compress_to_protobuf(&data, protobuf_buffer + AEAD_FRAME_HEADER_SIZE,
+                                                          sizeof(protobuf_buffer) - AEAD_FRAME_OVERHEAD(AEAD_TAG_LEN));
             
             if (compressed_size > 0) {
                 ESP_LOGI(TAG, "Data compressed: %d bytes", compressed_size);
                 
-                // Transmit data
-                transmit_data(protobuf_buffer, compressed_size);
+                // Encrypt and authenticate in place
+                int frame_size = seal_frame(protobuf_buffer, compressed_size, sizeof(protobuf_buffer));
+                if (frame_size < 0) {
+                    ESP_LOGE(TAG, "AEAD seal failed (%d)", frame_size);
+                } else {
+                    transmit_data(protobuf_buffer, (size_t)frame_size);
+                }
             } else {
                 ESP_LOGE(TAG, "Protobuf compression failed");
             }
@@ -413,6 +550,22 @@ void app_main(void) {
     init_sensors();
     init_communication();
     
+    // Initialize shock-event capture
+    accel_mutex = xSemaphoreCreateMutex();
+    if (accel_mutex == NULL) {
+        ESP_LOGE(TAG, "Failed to create accelerometer mutex");
+        return;
+    }
+    accel_burst_config_t accel_cfg;
+    accel_burst_default_config(&accel_cfg, ACCEL_SAMPLE_RATE_HZ);
+    accel_burst_init(&accel_burst, &accel_cfg);
+    
+    // Initialize payload encryption
+    if (init_aead_sender() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize AEAD sender");
+        return;
+    }
+    
     // Create data queue
     data_queue = xQueueCreate(QUEUE_SIZE, sizeof(container_data_t));
     if (data_queue == NULL) {
@@ -420,6 +573,13 @@ void app_main(void) {
         return;
     }
     
+    // Create accelerometer task (highest priority, must keep up with the FIFO)
+    xTaskCreate(accel_task, "accel_task", ACCEL_TASK_STACK_SIZE, NULL, 6, &accel_task_handle);
+    if (accel_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create accelerometer task");
+        return;
+    }
+    
     // Create sensor reading task
     xTaskCreate(sensor_task, "sensor_task", TASK_STACK_SIZE, NULL, 5, &sensor_task_handle);
     if (sensor_task_handle == NULL) {
@@ -437,4 +597,5 @@ void app_main(void) {
     ESP_LOGI(TAG, "Container Data Logger started successfully");
     ESP_LOGI(TAG, "Sensor reading interval: %d ms", SENSOR_READ_INTERVAL_MS);
     ESP_LOGI(TAG, "Transmission interval: %d ms", TRANSMISSION_INTERVAL_MS);
+    ESP_LOGI(TAG, "Accelerometer rate: %d Hz", ACCEL_SAMPLE_RATE_HZ);
 }
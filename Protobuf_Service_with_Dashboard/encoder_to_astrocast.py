@@ -3,10 +3,25 @@ import argparse
 import json
 import os
 import re
+import sys
 from datetime import datetime, timezone
 from typing import Dict
 from google.protobuf.message import Message
-import container_data_pb2  # your generated module
+
+# Native codecs (Native_Toolkit/python/native_codecs.c) when built: the same
+# bytes as the host tools, without the generated module
+sys.path.insert(0, os.environ.get('NATIVE_CODECS_DIR', os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', 'Native_Toolkit', 'python')))
+try:
+    import native_codecs
+except ImportError:
+    native_codecs = None
+try:
+    import container_data_pb2  # your generated module
+except ImportError:
+    if native_codecs is None:
+        raise
+    container_data_pb2 = None
 
 MAX_PAYLOAD_SIZE = 158
 REQUIRED_FIELDS = [
@@ -69,8 +84,10 @@ def validate_fields(d: Dict):
         raise ValueError(f"Missing required fields: {missing}")
 
 def serialize(data: Dict) -> bytes:
-    pb = json_to_protobuf(data)
-    raw = pb.SerializeToString()
+    if native_codecs is not None and os.environ.get('NATIVE_CODECS', '1') != '0':
+        raw = native_codecs.encode("protobuf", data)
+    else:
+        raw = json_to_protobuf(data).SerializeToString()
     if len(raw) >= MAX_PAYLOAD_SIZE:
         raise ValueError(f"Encoded payload is {len(raw)} bytes (>= {MAX_PAYLOAD_SIZE}). "
                          f"Reduce precision/fields if needed.")
@@ -8,6 +8,9 @@ import time
 import random
 import requests
 import json
+import zlib
+import struct
+import mmap
 from datetime import datetime, timedelta
 from locust import HttpUser, task, between, events
 import logging
@@ -36,6 +39,55 @@ TARGET_ENDPOINT = "/container-data"
 DEFAULT_POOL_SIZE = 10000
 DATA_POOL_SIZE = int(os.environ.get('LOCUST_DATA_POOL_SIZE', DEFAULT_POOL_SIZE))
 
+# Pre-encoded corpus shared by all workers (Native_Toolkit/tools/corpus_build,
+# layout in Native_Toolkit/common/payload_corpus.h). Every worker maps the
+# same file read-only, so startup is instant and every run sends the same bytes.
+CORPUS_PATH = os.environ.get('LOCUST_CORPUS')
+
+# Native codecs (Native_Toolkit/python/native_codecs.c): the C encoders of the
+# host tools, byte for byte, at native speed. Used when the extension is built;
+# NATIVE_CODECS=0 keeps the Python encoders.
+NATIVE_CODECS_DIR = os.environ.get('NATIVE_CODECS_DIR', os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', 'Native_Toolkit', 'python'))
+native_codecs = None
+if os.environ.get('NATIVE_CODECS', '1') != '0':
+    sys.path.insert(0, NATIVE_CODECS_DIR)
+    try:
+        import native_codecs
+    except ImportError:
+        pass
+
+class PayloadCorpus:
+    """Read-only mmap of a corpus file, indexed like the generated data pool"""
+    HEADER = struct.Struct('<8sII16sQqIIQ')
+    ENTRY = struct.Struct('<II')
+
+    def __init__(self, path, codec):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, count, name, self.seed, self.time_base,
+         crc, _, payload_bytes) = self.HEADER.unpack_from(self._map, 0)
+        name = name.rstrip(b'\0').decode()
+        if magic != b'IPCORP1\0' or version != 1:
+            raise ValueError(f"{path}: not a payload corpus")
+        if name != codec:
+            raise ValueError(f"{path}: corpus holds {name} payloads, this sender sends {codec}")
+        self._data = self.HEADER.size + self.ENTRY.size * count
+        if count == 0 or len(self._map) != self._data + payload_bytes:
+            raise ValueError(f"{path}: truncated corpus")
+        with memoryview(self._map) as view, view[self.HEADER.size:] as body:
+            if zlib.crc32(body) != crc:
+                raise ValueError(f"{path}: corpus CRC mismatch")
+        self.count = count
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, i):
+        offset, length = self.ENTRY.unpack_from(self._map, self.HEADER.size + self.ENTRY.size * i)
+        start = self._data + offset
+        return {'compressed': self._map[start:start + length], 'size': length}
+
 def convert_to_protobuf_data(string_data: dict) -> container_data_pb2.ContainerData:
     """Convert string-based data to protobuf message"""
     
@@ -77,6 +129,8 @@ def convert_to_protobuf_data(string_data: dict) -> container_data_pb2.ContainerD
 
 def protobuf_compress(data: dict) -> bytes:
     """Protocol Buffer compression approach"""
+    if native_codecs:
+        return native_codecs.encode('protobuf', data)
     
     # Convert to protobuf message
     pb_data = convert_to_protobuf_data(data)
@@ -84,6 +138,13 @@ def protobuf_compress(data: dict) -> bytes:
     # Serialize to binary
     return pb_data.SerializeToString()
 
+def protobuf_compress_batch(records: list) -> list:
+    """Encode a list of records, in one native call when available"""
+    if native_codecs:
+        payloads, offsets = native_codecs.encode_batch('protobuf', records)
+        return [payloads[offsets[i]:offsets[i + 1]] for i in range(len(records))]
+    return [protobuf_compress(data) for data in records]
+
 class ContainerDataSender(HttpUser):
     wait_time = between(1, 3)  # Wait 1-3 seconds between requests
     
@@ -104,6 +165,13 @@ class ContainerDataSender(HttpUser):
         is_master = "--master" in sys.argv
         worker_label = "WORKER" if is_worker else "MASTER" if is_master else "SINGLE"
         
+        if CORPUS_PATH:
+            cls._data_pool = PayloadCorpus(CORPUS_PATH, 'protobuf')
+            cls._pool_initialized = True
+            logger.info(f"[{worker_label}] Mapped corpus {CORPUS_PATH}: {len(cls._data_pool):,} payloads "
+                        f"(seed {cls._data_pool.seed})")
+            return
+        
         logger.info(f"[{worker_label}] Pre-generating {cls._data_pool_size:,} container data records...")
         logger.info(f"   [{worker_label}] This eliminates generation bottleneck during stress testing")
         
@@ -120,26 +188,25 @@ class ContainerDataSender(HttpUser):
             batch_generated = 0
             
             while batch_generated < batch_target:
-                data = generate_test_container_data()
-                # Pre-compress the data to save CPU during test
-                compressed = protobuf_compress(data)
-                size = len(compressed)
+                records = [generate_test_container_data() for _ in range(batch_target - batch_generated)]
+                for data, compressed in zip(records, protobuf_compress_batch(records)):
+                    size = len(compressed)
                 
-                # Validate size during generation
-                if size >= MAX_PAYLOAD_SIZE:
-                    rejected_count += 1
-                    if rejected_count % 100 == 0:  # Log occasionally
-                        logger.warning(f"Rejected {rejected_count} oversized records ({size} bytes > {MAX_PAYLOAD_SIZE})")
-                    continue  # Skip this record and try another
+                    # Validate size during generation
+                    if size >= MAX_PAYLOAD_SIZE:
+                        rejected_count += 1
+                        if rejected_count % 100 == 0:  # Log occasionally
+                            logger.warning(f"Rejected {rejected_count} oversized records ({size} bytes > {MAX_PAYLOAD_SIZE})")
+                        continue  # Skip this record and try another
                 
-                cls._data_pool.append({
-                    'original': data,
-                    'compressed': compressed,
-                    'size': size
-                })
+                    cls._data_pool.append({
+                        'original': data,
+                        'compressed': compressed,
+                        'size': size
+                    })
                 
-                batch_generated += 1
-                generated_count += 1
+                    batch_generated += 1
+                    generated_count += 1
             
             progress = (generated_count / cls._data_pool_size) * 100
             elapsed = time.time() - start_time
@@ -526,6 +593,9 @@ def test_compression():
     print(f"   First 20 bytes (hex): {compressed_data[:20].hex()}")
     print(f"   Verification: Binary data? {'YES' if isinstance(compressed_data, bytes) else 'NO'}")
     print(f"   Sample delimited string: {delimited_string[:100]}...")
+    if native_codecs:
+        python_bytes = convert_to_protobuf_data(sample_data).SerializeToString()
+        print(f"   Native encoder matches SerializeToString: {'YES' if compressed_data == python_bytes else 'NO'}")
     
     # Save results to file
     timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
@@ -718,6 +788,8 @@ if __name__ == "__main__":
         print("Environment Variables:")
         print(f"  LOCUST_DATA_POOL_SIZE={DATA_POOL_SIZE:,} (default: {DEFAULT_POOL_SIZE:,})")
         print("    Controls pre-generated data pool size per worker")
+        print("  LOCUST_CORPUS=<file> (default: unset)")
+        print("    Send payloads from a corpus_build file instead of generating them")
         print("    Total capacity = POOL_SIZE × NUMBER_OF_WORKERS")
         print("")
         print("Scaling Tips:")
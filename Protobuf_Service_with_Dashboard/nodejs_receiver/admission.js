@@ -0,0 +1,213 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Admission control for the ingestion endpoints.
+//
+// Pressure is the largest of queue depth, age of the oldest queued message,
+// outbound backlog, event-loop delay and heap use, each divided by its shed
+// threshold. Below 1 everything is admitted. Above 1 routine telemetry is
+// shed with probability (pressure - 1) / SHED_RAMP, so at 1 + SHED_RAMP all
+// of it is; alarms (door open, low battery, shock, or X-Priority: alarm) are
+// still admitted. Past the hard limits (queue depth or heap) everything is
+// rejected, alarms included, so memory stays bounded.
+//
+// A shed request gets 503 with Retry-After: the time to drain the current
+// backlog at the measured rate, plus up to 50 % jitter so the retries of a
+// burst do not come back together. Payloads are decoded for classification
+// only while shedding.
+
+const v8 = require('v8');
+const { monitorEventLoopDelay } = require('perf_hooks');
+
+const envNumber = (name, def) => {
+    const value = parseFloat(process.env[name]);
+    return Number.isFinite(value) ? value : def;
+};
+
+const ALARM_PRIORITIES = ['alarm', 'high', 'critical'];
+const ROUTINE_PRIORITIES = ['routine', 'low', 'normal'];
+
+class AdmissionController {
+    // probe() returns { depth, oldestQueuedAt, outboundDepth, processed, sent }
+    constructor(probe, { drainIntervalMs = 5000 } = {}) {
+        this.probe = probe;
+        this.drainIntervalMs = drainIntervalMs;
+        this.enabled = process.env.ADMISSION_CONTROL !== 'false';
+        this.limits = {
+            queueDepth: envNumber('SHED_QUEUE_DEPTH', 50000),
+            queueDelayMs: envNumber('SHED_QUEUE_DELAY_MS', 3 * drainIntervalMs),
+            outboundDepth: envNumber('SHED_OUTBOUND_DEPTH', 100000),
+            loopDelayMs: envNumber('SHED_LOOP_DELAY_MS', 500),
+            heapFraction: envNumber('SHED_HEAP_FRACTION', 0.7)
+        };
+        this.ramp = Math.max(envNumber('SHED_RAMP', 1), 0.01);
+        this.hardDepth = envNumber('ADMISSION_HARD_DEPTH', 4 * this.limits.queueDepth);
+        this.hardHeapFraction = envNumber('ADMISSION_HARD_HEAP_FRACTION', 0.9);
+        this.maxRetryAfterS = envNumber('ADMISSION_MAX_RETRY_AFTER_S', 300);
+        this.alarmDoorStates = (process.env.ALARM_DOOR_STATES || 'O').split(',').map(s => s.trim()).filter(Boolean);
+        this.lowBatterySoc = envNumber('LOW_BATTERY_SOC', 15);
+
+        this.heapLimit = v8.getHeapStatistics().heap_size_limit;
+        this.loopDelay = monitorEventLoopDelay({ resolution: 20 });
+        this.loopDelay.enable();
+
+        this.signals = { queueDepth: 0, queueDelayMs: 0, outboundDepth: 0, loopDelayMs: 0, heapFraction: 0 };
+        this.pressure = 0;
+        this.hard = false;
+        this.refreshedAt = 0;
+        this.loopResetAt = Date.now();
+        this.rates = { inbound: 0, outbound: 0 };   // messages per second, smoothed
+        this.rateSample = null;
+        this.counters = {
+            admitted: { unclassified: 0, alarm: 0, routine: 0 },   // unclassified: below the shed threshold
+            shed: { alarm: 0, routine: 0 },
+            alarms: { header: 0, 'door-open': 0, 'low-battery': 0, shock: 0 },
+            classifyErrors: 0
+        };
+        this.lastRetryAfterS = 0;
+    }
+
+    // Signals are sampled at most every 100 ms, not per request
+    refresh(now = Date.now()) {
+        if (now - this.refreshedAt < 100) return;
+        this.refreshedAt = now;
+
+        const p = this.probe();
+        if (now - this.loopResetAt >= 1000) {
+            this.signals.loopDelayMs = this.loopDelay.percentile(99) / 1e6;
+            this.loopDelay.reset();
+            this.loopResetAt = now;
+        }
+        this.signals.queueDepth = p.depth;
+        this.signals.queueDelayMs = p.oldestQueuedAt ? now - p.oldestQueuedAt : 0;
+        this.signals.outboundDepth = p.outboundDepth || 0;
+        this.signals.heapFraction = process.memoryUsage().heapUsed / this.heapLimit;
+
+        this.pressure = Math.max(...Object.keys(this.limits).map(k => this.signals[k] / this.limits[k]));
+        this.hard = p.depth >= this.hardDepth || this.signals.heapFraction >= this.hardHeapFraction;
+        this.sampleRates(now, p);
+    }
+
+    // Drain rates over at least one processing interval (the queue is drained in bursts)
+    sampleRates(now, p) {
+        const s = this.rateSample;
+        if (!s) {
+            this.rateSample = { at: now, processed: p.processed || 0, sent: p.sent || 0 };
+            return;
+        }
+        const dt = (now - s.at) / 1000;
+        if (dt * 1000 < Math.max(this.drainIntervalMs, 1000)) return;
+        const inbound = ((p.processed || 0) - s.processed) / dt;
+        const outbound = ((p.sent || 0) - s.sent) / dt;
+        this.rates.inbound = this.rates.inbound ? 0.7 * this.rates.inbound + 0.3 * inbound : inbound;
+        this.rates.outbound = this.rates.outbound ? 0.7 * this.rates.outbound + 0.3 * outbound : outbound;
+        this.rateSample = { at: now, processed: p.processed || 0, sent: p.sent || 0 };
+    }
+
+    get level() {
+        if (this.hard) return 'overloaded';
+        return this.pressure > 1 ? 'shedding' : 'normal';
+    }
+
+    // Alarm reason for a decoded record, or null for routine telemetry
+    alarmReason(doc) {
+        if (!doc || typeof doc !== 'object') return null;
+        if (doc.door !== undefined && this.alarmDoorStates.includes(String(doc.door))) return 'door-open';
+        const soc = Number(doc['bat-soc']);
+        if (doc['bat-soc'] !== undefined && Number.isFinite(soc) && soc <= this.lowBatterySoc) return 'low-battery';
+        if (doc.shock) return 'shock';
+        return null;
+    }
+
+    // X-Priority wins; otherwise decode() is called (only while shedding) and
+    // the record inspected. decode may be null for payloads that cannot be
+    // read at ingest (sealed or FEC frames): those count as routine.
+    classify(req, decode) {
+        const header = String((req && req.get && req.get('X-Priority')) || '').toLowerCase();
+        if (ALARM_PRIORITIES.includes(header)) return { priority: 'alarm', reason: 'header' };
+        if (ROUTINE_PRIORITIES.includes(header) || !decode) return { priority: 'routine', reason: null };
+        try {
+            const reason = this.alarmReason(decode());
+            return reason ? { priority: 'alarm', reason } : { priority: 'routine', reason: null };
+        } catch (err) {
+            this.counters.classifyErrors++;
+            return { priority: 'routine', reason: null };
+        }
+    }
+
+    // Returns { admitted, priority, reason }
+    admit(req, decode = null) {
+        if (!this.enabled) return { admitted: true, priority: 'routine', reason: null };
+        this.refresh();
+
+        if (!this.hard && this.pressure <= 1) {
+            this.counters.admitted.unclassified++;
+            return { admitted: true, priority: 'routine', reason: null };
+        }
+        const { priority, reason } = this.classify(req, decode);
+        let admitted;
+        if (this.hard) admitted = false;
+        else if (priority === 'alarm') admitted = true;
+        else admitted = Math.random() >= Math.min((this.pressure - 1) / this.ramp, 1);
+
+        (admitted ? this.counters.admitted : this.counters.shed)[priority]++;
+        if (admitted && reason) this.counters.alarms[reason]++;
+        return { admitted, priority, reason };
+    }
+
+    // Seconds until the backlog has drained at the measured rates, with
+    // jitter; before a rate is known, one interval per unit of pressure
+    retryAfter() {
+        const intervalS = this.drainIntervalMs / 1000;
+        const drain = (depth, rate) => (rate > 0 ? depth / rate : intervalS * this.pressure);
+        const inbound = drain(this.signals.queueDepth, this.rates.inbound);
+        const outbound = this.signals.outboundDepth ? drain(this.signals.outboundDepth, this.rates.outbound) : 0;
+        const base = Math.max(intervalS, inbound, outbound);
+        const seconds = Math.ceil(base * (1 + 0.5 * Math.random()));
+        this.lastRetryAfterS = Math.min(Math.max(seconds, 1), this.maxRetryAfterS);
+        return this.lastRetryAfterS;
+    }
+
+    reject(res, decision) {
+        const retryAfter = this.retryAfter();
+        res.set('Retry-After', String(retryAfter));
+        return res.status(503).json({
+            error: 'Overloaded',
+            message: this.hard
+                ? 'Receiver at capacity, retry later'
+                : 'Routine telemetry is being shed under load, retry later',
+            priority: decision.priority,
+            retryAfter,
+            pressure: Number(this.pressure.toFixed(2))
+        });
+    }
+
+    getStats() {
+        this.refresh();
+        return {
+            enabled: this.enabled,
+            level: this.level,
+            pressure: Number(this.pressure.toFixed(3)),
+            signals: {
+                ...this.signals,
+                loopDelayMs: Number(this.signals.loopDelayMs.toFixed(1)),
+                heapFraction: Number(this.signals.heapFraction.toFixed(3))
+            },
+            limits: { ...this.limits, hardDepth: this.hardDepth, hardHeapFraction: this.hardHeapFraction },
+            drainRatePerSecond: {
+                inbound: Number(this.rates.inbound.toFixed(1)),
+                outbound: Number(this.rates.outbound.toFixed(1))
+            },
+            admitted: { ...this.counters.admitted },
+            shed: { ...this.counters.shed },
+            alarms: { ...this.counters.alarms },
+            classifyErrors: this.counters.classifyErrors,
+            lastRetryAfterS: this.lastRetryAfterS
+        };
+    }
+}
+
+module.exports = { AdmissionController };
@@ -0,0 +1,294 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Receiver side of the AEAD framing (mirrors Native_Toolkit/firmware/aead_frame.c).
+// Frame: [seq_lo u16 BE][ChaCha20-Poly1305 ciphertext][truncated tag]
+// Nonce: device ID (u64 BE) || sequence (u32 BE); AAD: the 2-byte header.
+// Keys come from AEAD_KEYS_FILE ({ "devices": { "<id>": "<hex key>" } })
+// or are derived from AEAD_MASTER_KEY as HMAC-SHA256(master, "aead-frame" || id u64 BE).
+//
+// A device gets a peer (key and replay window) only once one of its frames
+// has opened, and at most maxPeers are kept (least recently used first out).
+// The highest accepted sequence of each device is saved to a sequence store
+// before its payloads are used, so after a restart or an eviction frames at
+// or below it are refused. When the save fails the batch is undone: its
+// frames come back with retry set, and for STORE_RETRY_MS new sealed frames
+// should be refused (storeAvailable). Devices the store has never seen need a search
+// over sequence epochs, RESYNC_EPOCHS trial decryptions; at most
+// resyncPerSecond such searches run, other frames get a single trial.
+
+const crypto = require('crypto');
+const fs = require('fs');
+
+const HEADER_SIZE = 2;
+const REPLAY_WINDOW = 64n;
+const WINDOW_FULL = (1n << REPLAY_WINDOW) - 1n;
+const RESYNC_EPOCHS = 64;
+const STORE_RETRY_MS = 5000;
+
+function expandSeq(reference, seqLo) {
+    let candidate = (reference & 0xFFFF0000) >>> 0 | seqLo;
+    candidate >>>= 0;
+    if (candidate < reference - 0x8000 && candidate + 0x10000 <= 0xFFFFFFFF) candidate += 0x10000;
+    else if (candidate > reference + 0x8000 && candidate >= 0x10000) candidate -= 0x10000;
+    return candidate;
+}
+
+// Highest accepted sequence per device, for a receiver without a database
+class MemorySequenceStore {
+    constructor() {
+        this.sequences = new Map();
+    }
+
+    load(deviceId) {
+        return this.sequences.has(deviceId) ? this.sequences.get(deviceId) : null;
+    }
+
+    save(entries) {
+        entries.forEach(([deviceId, seq]) => this.sequences.set(deviceId, seq));
+    }
+}
+
+class AeadReceiver {
+    constructor({ keysFile = null, masterKey = null, tagLength = 6, astrocastDevices = {},
+                  store = null, maxPeers = 10000, resyncPerSecond = 20 } = {}) {
+        this.tagLength = tagLength;
+        this.keys = new Map();
+        this.astrocastDevices = { ...astrocastDevices };
+        this.masterKey = masterKey ? Buffer.from(masterKey, 'hex') : null;
+        this.store = store || new MemorySequenceStore();
+        this.maxPeers = maxPeers;
+        this.peers = new Map();                   // insertion order = LRU order
+        this.dirty = new Map();                   // deviceId -> highestSeq not yet saved
+        this.resyncPerSecond = resyncPerSecond;
+        this.resyncTokens = resyncPerSecond;
+        this.resyncRefilledAt = Date.now();
+        this.storeFailedAt = 0;
+        this.stats = { opened: 0, authFailures: 0, replays: 0, unknownDevices: 0, malformed: 0,
+                       resyncs: 0, resyncsLimited: 0, evictions: 0, storeErrors: 0 };
+
+        if (keysFile) {
+            const parsed = JSON.parse(fs.readFileSync(keysFile, 'utf8'));
+            Object.entries(parsed.devices || {}).forEach(([id, hex]) => this.keys.set(id, Buffer.from(hex, 'hex')));
+            Object.assign(this.astrocastDevices, parsed.astrocastDevices || {});
+        }
+    }
+
+    get enabled() {
+        return this.keys.size > 0 || this.masterKey !== null;
+    }
+
+    // Astrocast deviceGuid -> numeric device ID used in the nonce
+    deviceForGuid(guid) {
+        return this.astrocastDevices[guid] || null;
+    }
+
+    // The device's peer, or a candidate that is not kept until a frame opens
+    peerFor(deviceId) {
+        const peer = this.peers.get(deviceId);
+        if (peer) {
+            this.peers.delete(deviceId);
+            this.peers.set(deviceId, peer);
+            return peer;
+        }
+
+        let idBytes;
+        try {
+            idBytes = Buffer.alloc(8);
+            idBytes.writeBigUInt64BE(BigInt(deviceId));
+        } catch (err) {
+            return null;
+        }
+        let key = this.keys.get(deviceId);
+        if (!key && this.masterKey) {
+            key = crypto.createHmac('sha256', this.masterKey)
+                .update(Buffer.concat([Buffer.from('aead-frame'), idBytes])).digest();
+        }
+        if (!key) return null;
+
+        // A saved sequence: everything at or below it was accepted once
+        let saved = null;
+        try {
+            saved = this.store.load(deviceId);
+        } catch (err) {
+            this.stats.storeErrors++;
+        }
+        return saved === null
+            ? { deviceId, key, idBytes, kept: false, seen: false, highestSeq: 0, window: 0n }
+            : { deviceId, key, idBytes, kept: false, seen: true, highestSeq: saved, window: WINDOW_FULL };
+    }
+
+    keep(peer) {
+        if (peer.kept) return;
+        peer.kept = true;
+        this.peers.set(peer.deviceId, peer);
+        while (this.peers.size > this.maxPeers) {
+            this.peers.delete(this.peers.keys().next().value);
+            this.stats.evictions++;
+        }
+    }
+
+    // One full epoch search per token; tokens refill at resyncPerSecond
+    takeResync() {
+        const now = Date.now();
+        this.resyncTokens = Math.min(this.resyncPerSecond,
+            this.resyncTokens + (now - this.resyncRefilledAt) * this.resyncPerSecond / 1000);
+        this.resyncRefilledAt = now;
+        if (this.resyncTokens < 1) return false;
+        this.resyncTokens--;
+        return true;
+    }
+
+    // False for STORE_RETRY_MS after a failed save
+    get storeAvailable() {
+        return Date.now() - this.storeFailedAt >= STORE_RETRY_MS;
+    }
+
+    // Saves the sequences accepted since the last flush. Payloads must not
+    // be used before this: a frame accepted but not saved could be replayed
+    // after a restart. False when the store failed.
+    flush() {
+        if (this.dirty.size === 0) return true;
+        try {
+            this.store.save([...this.dirty]);
+        } catch (err) {
+            this.stats.storeErrors++;
+            this.storeFailedAt = Date.now();
+            return false;
+        } finally {
+            this.dirty.clear();
+        }
+        return true;
+    }
+
+    tryOpen(peer, frame, seq) {
+        const nonce = Buffer.alloc(12);
+        peer.idBytes.copy(nonce, 0);
+        nonce.writeUInt32BE(seq, 8);
+        const ctEnd = frame.length - this.tagLength;
+        try {
+            const decipher = crypto.createDecipheriv('chacha20-poly1305', peer.key, nonce,
+                { authTagLength: this.tagLength });
+            decipher.setAAD(frame.subarray(0, HEADER_SIZE), { plaintextLength: ctEnd - HEADER_SIZE });
+            decipher.setAuthTag(frame.subarray(ctEnd));
+            return Buffer.concat([decipher.update(frame.subarray(HEADER_SIZE, ctEnd)), decipher.final()]);
+        } catch (err) {
+            return null;
+        }
+    }
+
+    isReplay(peer, seq) {
+        if (!peer.seen || seq > peer.highestSeq) return false;
+        const age = BigInt(peer.highestSeq - seq);
+        return age >= REPLAY_WINDOW || ((peer.window >> age) & 1n) === 1n;
+    }
+
+    accept(peer, seq) {
+        this.keep(peer);
+        if (!peer.seen || seq > peer.highestSeq) this.dirty.set(peer.deviceId, seq);
+        if (!peer.seen) {
+            Object.assign(peer, { seen: true, highestSeq: seq, window: 1n });
+        } else if (seq > peer.highestSeq) {
+            const shift = BigInt(seq - peer.highestSeq);
+            peer.window = shift >= REPLAY_WINDOW ? 1n : ((peer.window << shift) | 1n) & ((1n << REPLAY_WINDOW) - 1n);
+            peer.highestSeq = seq;
+        } else {
+            peer.window |= 1n << BigInt(peer.highestSeq - seq);
+        }
+    }
+
+    open(deviceId, frame) {
+        return this.openBatch([{ deviceId, frame }])[0];
+    }
+
+    openFrame(deviceId, peer, frame) {
+        if (!frame || frame.length < HEADER_SIZE + this.tagLength) {
+            this.stats.malformed++;
+            return { error: 'Frame too short' };
+        }
+        if (!peer) {
+            this.stats.unknownDevices++;
+            return { error: `No key for device ${deviceId}` };
+        }
+
+        const seqLo = frame.readUInt16BE(0);
+        let seq = expandSeq(peer.seen ? peer.highestSeq : 0, seqLo);
+        if (this.isReplay(peer, seq)) {
+            this.stats.replays++;
+            return { error: 'Replayed frame' };
+        }
+
+        let payload = this.tryOpen(peer, frame, seq);
+        // A device never seen: the sequence epoch is unknown
+        if (!payload && !peer.seen) {
+            if (this.takeResync()) {
+                this.stats.resyncs++;
+                for (let epoch = 1; !payload && epoch < RESYNC_EPOCHS; epoch++) {
+                    seq = (epoch * 0x10000 + seqLo) >>> 0;
+                    payload = this.tryOpen(peer, frame, seq);
+                }
+            } else {
+                this.stats.resyncsLimited++;
+            }
+        }
+        if (!payload) {
+            this.stats.authFailures++;
+            return { error: 'Authentication failed' };
+        }
+
+        this.accept(peer, seq);
+        this.stats.opened++;
+        return { payload };
+    }
+
+    // items: [{ deviceId, frame }]. Frames are opened per device in
+    // sequence order so the replay window only moves forward. The accepted
+    // sequences are saved before the results are returned; if that fails,
+    // the windows are put back and every opened frame gets { error, retry }.
+    openBatch(items) {
+        const results = new Array(items.length);
+        const byDevice = new Map();
+        items.forEach((item, index) => {
+            const id = String(item.deviceId);
+            if (!byDevice.has(id)) byDevice.set(id, []);
+            byDevice.get(id).push(index);
+        });
+
+        const before = [];
+        for (const [deviceId, indexes] of byDevice) {
+            const peer = this.peerFor(deviceId);
+            if (peer) {
+                const { kept, seen, highestSeq, window } = peer;
+                before.push({ peer, state: { kept, seen, highestSeq, window } });
+            }
+            const seqLo = i => items[i].frame && items[i].frame.length >= HEADER_SIZE
+                ? items[i].frame.readUInt16BE(0) : 0;
+            // Order by distance from the last accepted sequence (or from the
+            // first frame of the batch), modulo the 16 bits on the wire
+            const ref = peer && peer.seen ? peer.highestSeq & 0xFFFF : seqLo(indexes[0]);
+            const position = i => (seqLo(i) - ref + 0x8000) & 0xFFFF;
+            indexes.sort((a, b) => position(a) - position(b));
+            indexes.forEach(i => { results[i] = this.openFrame(deviceId, peer, items[i].frame); });
+        }
+        if (this.flush()) return results;
+
+        before.forEach(({ peer, state }) => {
+            Object.assign(peer, state);
+            if (!state.kept && this.peers.get(peer.deviceId) === peer) this.peers.delete(peer.deviceId);
+        });
+        return results.map(result => {
+            if (!result.payload) return result;
+            this.stats.opened--;
+            return { error: 'Sequence store unavailable', retry: true };
+        });
+    }
+
+    getStats() {
+        return { ...this.stats, devices: this.peers.size, tagLength: this.tagLength, enabled: this.enabled };
+    }
+}
+
+module.exports = { AeadReceiver, MemorySequenceStore, expandSeq, HEADER_SIZE };
@@ -0,0 +1,249 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Embedded partitioned commit log between decoding and the sinks.
+//
+// A decoded record is appended once, to the partition of its device
+// (FNV-1a of the key, so one device's records stay in order), and each
+// sink reads the log through its own consumer: one committed offset per
+// partition, batches of up to batchSize records, at its own pace. When a
+// consumer's handler throws, its offsets stay put and the same batch is
+// retried after a backoff; the other consumers carry on. A record is
+// retained until every consumer has committed past it, so the slowest
+// consumer sets the retention; memory is freed a segment
+// (LOG_SEGMENT_SIZE records) at a time. The log lives in memory: a
+// restart loses what the slowest consumer had not read, as the queues it
+// replaces did.
+
+const envNumber = (name, def) => {
+    const value = parseInt(process.env[name], 10);
+    return Number.isFinite(value) && value > 0 ? value : def;
+};
+
+function fnv1a(key) {
+    let h = 0x811C9DC5;
+    for (let i = 0; i < key.length; i++) {
+        h ^= key.charCodeAt(i);
+        h = Math.imul(h, 0x01000193);
+    }
+    return h >>> 0;
+}
+
+class Partition {
+    constructor(segmentSize) {
+        this.segmentSize = segmentSize;
+        this.segments = [];                 // full segments, then the open one
+        this.start = 0;                     // first offset in memory (a segment base)
+        this.floor = 0;                     // offset every consumer has committed up to
+        this.end = 0;                       // next offset to append
+    }
+
+    append(entry) {
+        const last = this.segments[this.segments.length - 1];
+        if (last && last.length < this.segmentSize) last.push(entry);
+        else this.segments.push([entry]);
+        return this.end++;
+    }
+
+    // Up to max entries from offset, pushed onto out
+    read(offset, max, out) {
+        const size = this.segmentSize;
+        let s = Math.floor((offset - this.start) / size), i = (offset - this.start) % size;
+        for (let n = Math.min(max, this.end - offset); n > 0; n--) {
+            out.push(this.segments[s][i]);
+            if (++i === size) { s++; i = 0; }
+        }
+    }
+
+    // Drops the segments every consumer is past; returns the records released
+    trim(committed) {
+        const released = committed - this.floor;
+        this.floor = committed;
+        while (this.segments.length && this.start + this.segmentSize <= committed) {
+            this.segments.shift();
+            this.start += this.segmentSize;
+        }
+        return released;
+    }
+}
+
+class Consumer {
+    constructor(log, name, handler, {
+        batchSize = 256,
+        lingerMs = 0,                       // wait this long after a wake-up so batches fill
+        retryMs = 1000,                     // first backoff after a failed batch, doubled up to maxRetryMs
+        maxRetryMs = 60000,
+        ready = null                        // () => false pauses reading (sink-side backpressure)
+    } = {}) {
+        this.log = log;
+        this.name = name;
+        this.handler = handler;
+        this.batchSize = batchSize;
+        this.lingerMs = lingerMs;
+        this.retryMs = retryMs;
+        this.maxRetryMs = maxRetryMs;
+        this.ready = ready;
+        // Starts at the oldest retained record, so nothing appended is missed
+        this.offsets = log.partitions.map(p => p.start);
+        this.cursor = 0;
+        this.running = false;
+        this.timer = null;
+        this.failures = 0;
+        this.stats = { batches: 0, records: 0, failures: 0, lastError: null, lastBatchMs: 0 };
+    }
+
+    lag() {
+        let lag = 0;
+        this.log.partitions.forEach((p, i) => { lag += p.end - this.offsets[i]; });
+        return lag;
+    }
+
+    wake() {
+        if (this.running || this.timer) return;
+        this.timer = this.lingerMs ? setTimeout(() => this.run(), this.lingerMs) : setImmediate(() => this.run());
+    }
+
+    later(ms) {
+        if (!this.timer) this.timer = setTimeout(() => this.run(), ms);
+    }
+
+    // Round robin over the partitions from the cursor, up to batchSize in all
+    poll() {
+        const partitions = this.log.partitions, batch = [];
+        for (let k = 0; k < partitions.length && batch.length < this.batchSize; k++) {
+            const i = (this.cursor + k) % partitions.length;
+            partitions[i].read(this.offsets[i], this.batchSize - batch.length, batch);
+        }
+        this.cursor = (this.cursor + 1) % partitions.length;
+        return batch;
+    }
+
+    async run() {
+        this.timer = null;
+        if (this.running) return;
+        this.running = true;
+        try {
+            while (!this.log.closed) {
+                if (this.ready && !this.ready()) {
+                    this.later(this.log.idleMs);
+                    break;
+                }
+                const batch = this.poll();
+                if (batch.length === 0) break;
+                const started = Date.now();
+                try {
+                    await this.handler(batch);
+                } catch (err) {
+                    this.failures++;
+                    this.stats.failures++;
+                    this.stats.lastError = err.message;
+                    this.later(Math.min(this.retryMs * Math.pow(2, this.failures - 1), this.maxRetryMs));
+                    break;
+                }
+                this.failures = 0;
+                for (const entry of batch) this.offsets[entry.partition] = entry.offset + 1;
+                this.stats.batches++;
+                this.stats.records += batch.length;
+                this.stats.lastBatchMs = Date.now() - started;
+                this.log.trim();
+                // Let requests in between batches
+                await new Promise(resolve => setImmediate(resolve));
+            }
+        } finally {
+            this.running = false;
+        }
+    }
+
+    getStats() {
+        return { ...this.stats, lag: this.lag(), batchSize: this.batchSize, running: this.running };
+    }
+}
+
+class CommitLog {
+    constructor({
+        partitions = envNumber('LOG_PARTITIONS', 16),
+        segmentSize = envNumber('LOG_SEGMENT_SIZE', 1024),
+        idleMs = 200                        // re-check interval for a paused consumer
+    } = {}) {
+        this.partitions = Array.from({ length: partitions }, () => new Partition(segmentSize));
+        this.segmentSize = segmentSize;
+        this.idleMs = idleMs;
+        this.epoch = Date.now().toString(36);
+        this.consumers = [];
+        this.appended = 0;
+        this.released = 0;
+        this.closed = false;
+    }
+
+    consumer(name, handler, options) {
+        const consumer = new Consumer(this, name, handler, options);
+        this.consumers.push(consumer);
+        return consumer;
+    }
+
+    partitionFor(key) {
+        return fnv1a(String(key || '')) % this.partitions.length;
+    }
+
+    // Returns the entry: { id, partition, offset, key, value, appendedAt }.
+    // id is unique across restarts (epoch:partition:offset).
+    append(key, value) {
+        const partition = this.partitionFor(key);
+        const p = this.partitions[partition];
+        const entry = { id: null, partition, offset: p.end, key, value, appendedAt: Date.now() };
+        entry.id = `${this.epoch}:${partition}:${entry.offset}`;
+        p.append(entry);
+        this.appended++;
+        for (const consumer of this.consumers) consumer.wake();
+        return entry;
+    }
+
+    // Offset consumer name has committed up to in a partition (exclusive)
+    committed(name, partition) {
+        const consumer = this.consumers.find(c => c.name === name);
+        return consumer ? consumer.offsets[partition] : this.partitions[partition].end;
+    }
+
+    trim() {
+        this.partitions.forEach((p, i) => {
+            let min = p.end;
+            for (const consumer of this.consumers) min = Math.min(min, consumer.offsets[i]);
+            this.released += p.trim(min);
+        });
+    }
+
+    // Records some consumer has yet to commit (memory holds up to one
+    // more segment per partition)
+    retained() {
+        let n = 0;
+        for (const p of this.partitions) n += p.end - p.floor;
+        return n;
+    }
+
+    close() {
+        this.closed = true;
+        for (const consumer of this.consumers) {
+            clearTimeout(consumer.timer);
+            clearImmediate(consumer.timer);
+            consumer.timer = null;
+        }
+    }
+
+    getStats() {
+        const consumers = {};
+        for (const consumer of this.consumers) consumers[consumer.name] = consumer.getStats();
+        return {
+            partitions: this.partitions.length,
+            segmentSize: this.segmentSize,
+            appended: this.appended,
+            retained: this.retained(),
+            released: this.released,
+            consumers
+        };
+    }
+}
+
+module.exports = { CommitLog };
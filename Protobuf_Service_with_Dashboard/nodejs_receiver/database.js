@@ -76,7 +76,8 @@ class ContainerDatabase {
                 error_count INTEGER DEFAULT 0,
                 original_size INTEGER DEFAULT 0,
                 compressed_size INTEGER DEFAULT 0,
-                compression_ratio REAL DEFAULT 0.0
+                compression_ratio REAL DEFAULT 0.0,
+                log_id TEXT
             )
         `;
 
@@ -90,11 +91,25 @@ class ContainerDatabase {
             console.error('Error creating table:', err.message);
         }
 
+        // Highest accepted AEAD sequence per device: the replay floor after a restart
+        try {
+            this.db.exec(`
+                CREATE TABLE IF NOT EXISTS aead_sequences (
+                    device_id TEXT PRIMARY KEY,
+                    highest_seq INTEGER NOT NULL,
+                    updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+                )
+            `);
+        } catch (err) {
+            console.error('Error creating aead_sequences table:', err.message);
+        }
+
         // Create indexes for better performance
         const indexes = [
             'CREATE INDEX IF NOT EXISTS idx_iso6346 ON container_data(iso6346)',
             'CREATE INDEX IF NOT EXISTS idx_created_at ON container_data(created_at)',
-            'CREATE INDEX IF NOT EXISTS idx_sent_to_mobius ON container_data(sent_to_mobius)'
+            'CREATE INDEX IF NOT EXISTS idx_sent_to_mobius ON container_data(sent_to_mobius)',
+            'CREATE INDEX IF NOT EXISTS idx_log_id ON container_data(log_id)'
         ];
 
         indexes.forEach(indexSQL => {
@@ -126,6 +141,10 @@ class ContainerDatabase {
                 this.db.exec('ALTER TABLE container_data ADD COLUMN compression_ratio REAL DEFAULT 0.0');
                 console.log('Added compression_ratio column');
             }
+            if (!tableInfo.some(col => col.name === 'log_id')) {
+                this.db.exec('ALTER TABLE container_data ADD COLUMN log_id TEXT');
+                console.log('Added log_id column');
+            }
         } catch (err) {
             console.error('Error adding compression columns:', err.message);
         }
@@ -183,6 +202,78 @@ class ContainerDatabase {
         });
     }
 
+    // Rows of { containerData, logId, mobius } in one transaction. mobius is
+    // { sent, response, errors } when the forwarder answered before the row
+    // was written. A failed batch is retried row by row so one bad row does
+    // not hold back the others. Returns the error messages of failed rows.
+    insertContainerBatch(rows) {
+        if (!this.db) throw new Error('Database not initialized');
+        if (!this.batchInsert) {
+            const stmt = this.db.prepare(`
+                INSERT INTO container_data (
+                    msisdn, iso6346, time, rssi, cgi, ble_m, bat_soc, acc,
+                    temperature, humidity, pressure, door, gnss, latitude,
+                    longitude, altitude, speed, heading, nsat, hdop,
+                    original_size, compressed_size, compression_ratio,
+                    log_id, sent_to_mobius, mobius_response, error_count
+                ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+            `);
+            this.insertRow = ({ containerData: d, logId, mobius }) => stmt.run(
+                d.msisdn, d.iso6346, d.time, d.rssi, d.cgi, d['ble-m'], d['bat-soc'], d.acc,
+                d.temperature, d.humidity, d.pressure, d.door, d.gnss, d.latitude,
+                d.longitude, d.altitude, d.speed, d.heading, d.nsat, d.hdop,
+                d.original_size || 0, d.compressed_size || 0, d.compression_ratio || 0.0,
+                logId || null, mobius && mobius.sent ? 1 : 0, mobius ? mobius.response : null, mobius ? mobius.errors : 0);
+            this.batchInsert = this.db.transaction(batch => batch.forEach(this.insertRow));
+        }
+        try {
+            this.batchInsert(rows);
+            return [];
+        } catch (err) {
+            const errors = [];
+            for (const row of rows) {
+                try {
+                    this.insertRow(row);
+                } catch (rowErr) {
+                    errors.push(rowErr.message);
+                }
+            }
+            return errors;
+        }
+    }
+
+    getAeadSequence(deviceId) {
+        if (!this.aeadSelect) this.aeadSelect = this.db.prepare('SELECT highest_seq FROM aead_sequences WHERE device_id = ?');
+        const row = this.aeadSelect.get(deviceId);
+        return row ? row.highest_seq : null;
+    }
+
+    // [[deviceId, highestSeq]] in one transaction; a sequence never goes back
+    saveAeadSequences(entries) {
+        if (!this.aeadSave) {
+            const stmt = this.db.prepare(`
+                INSERT INTO aead_sequences (device_id, highest_seq) VALUES (?, ?)
+                ON CONFLICT(device_id) DO UPDATE SET highest_seq = excluded.highest_seq, updated_at = CURRENT_TIMESTAMP
+                WHERE excluded.highest_seq > aead_sequences.highest_seq
+            `);
+            this.aeadSave = this.db.transaction(list => list.forEach(([deviceId, seq]) => stmt.run(deviceId, seq)));
+        }
+        this.aeadSave(entries);
+    }
+
+    updateMobiusStatusByLogId(logId, sent, response = null) {
+        return this.db.prepare(`
+            UPDATE container_data
+            SET sent_to_mobius = ?, mobius_response = ?, processed_at = CURRENT_TIMESTAMP
+            WHERE log_id = ?
+        `).run(sent ? 1 : 0, response, logId).changes;
+    }
+
+    incrementErrorCountByLogId(logId) {
+        return this.db.prepare('UPDATE container_data SET error_count = error_count + 1 WHERE log_id = ?')
+            .run(logId).changes;
+    }
+
     getRecentContainers(limit = 100) {
         return new Promise((resolve, reject) => {
             try {
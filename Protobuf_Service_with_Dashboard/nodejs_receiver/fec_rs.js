@@ -0,0 +1,203 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Cross-frame FEC reassembly (mirrors Native_Toolkit/firmware/fec_rs.c).
+// Frame header: [group u8][index u8][K << 4 | M]. Data frames (index < K)
+// carry the original payload; parity frames carry shard_len bytes computed
+// over data shards laid out as [len u8][payload][zero padding]. Any K of
+// the K + M frames of a group rebuild the missing payloads.
+
+const HEADER_SIZE = 3;
+const MAX_K = 15;
+const MAX_M = 15;
+const MAX_SHARD = 256;
+
+// ================= GF(256) =================
+const GF_EXP = new Uint8Array(512);
+const GF_LOG = new Uint8Array(256);
+(() => {
+    let x = 1;
+    for (let i = 0; i < 255; i++) {
+        GF_EXP[i] = x;
+        GF_LOG[x] = i;
+        x <<= 1;
+        if (x & 0x100) x ^= 0x11D;
+    }
+    for (let i = 255; i < 512; i++) GF_EXP[i] = GF_EXP[i - 255];
+})();
+
+const gfMul = (a, b) => (a === 0 || b === 0) ? 0 : GF_EXP[GF_LOG[a] + GF_LOG[b]];
+const gfInv = a => a ? GF_EXP[255 - GF_LOG[a]] : 0;
+const cauchy = (k, i, j) => gfInv((k + i) ^ j);
+
+function mulAddRegion(dst, src, c, len) {
+    if (c === 0) return;
+    const row = GF_EXP.subarray(GF_LOG[c]);
+    for (let i = 0; i < len; i++) {
+        const s = src[i];
+        if (s !== 0) dst[i] ^= row[GF_LOG[s]];
+    }
+}
+
+function invertMatrix(a, k) {
+    const inv = a.map((_, r) => Array.from({ length: k }, (__, c) => (r === c ? 1 : 0)));
+    for (let col = 0; col < k; col++) {
+        let pivot = col;
+        while (pivot < k && a[pivot][col] === 0) pivot++;
+        if (pivot === k) return null;
+        [a[col], a[pivot]] = [a[pivot], a[col]];
+        [inv[col], inv[pivot]] = [inv[pivot], inv[col]];
+        const scale = gfInv(a[col][col]);
+        for (let c = 0; c < k; c++) {
+            a[col][c] = gfMul(a[col][c], scale);
+            inv[col][c] = gfMul(inv[col][c], scale);
+        }
+        for (let r = 0; r < k; r++) {
+            const f = a[r][col];
+            if (r === col || f === 0) continue;
+            for (let c = 0; c < k; c++) {
+                a[r][c] ^= gfMul(f, a[col][c]);
+                inv[r][c] ^= gfMul(f, inv[col][c]);
+            }
+        }
+    }
+    return inv;
+}
+
+// shards: array of k + m Uint8Array|null (null = missing). Returns the
+// rebuilt data shards by index, or null if fewer than k are present.
+function reconstruct(shards, k, m, shardLen) {
+    const rows = [];
+    for (let i = 0; i < k + m && rows.length < k; i++) {
+        if (shards[i]) rows.push(i);
+    }
+    if (rows.length < k) return null;
+
+    const a = rows.map(idx => Array.from({ length: k },
+        (_, c) => (idx < k ? (idx === c ? 1 : 0) : cauchy(k, idx - k, c))));
+    const inv = invertMatrix(a, k);
+    if (!inv) return null;
+
+    const rebuilt = new Map();
+    for (let j = 0; j < k; j++) {
+        if (shards[j]) continue;
+        const out = new Uint8Array(shardLen);
+        rows.forEach((idx, r) => mulAddRegion(out, shards[idx], inv[j][r], shardLen));
+        rebuilt.set(j, out);
+    }
+    return rebuilt;
+}
+
+// ================= REASSEMBLER =================
+class FecReassembler {
+    constructor(groupTimeoutMs = 15 * 60 * 1000) {
+        this.groupTimeoutMs = groupTimeoutMs;
+        this.sources = new Map();
+        this.stats = { framesIn: 0, delivered: 0, recovered: 0, incompleteGroups: 0, malformed: 0, stale: 0 };
+    }
+
+    // Returns the payloads ready for the message queue (Buffer[])
+    push(sourceKey, frame) {
+        if (!frame || frame.length < HEADER_SIZE) { this.stats.malformed++; return []; }
+        const group = frame[0], index = frame[1];
+        const k = frame[2] >> 4, m = frame[2] & 0x0F;
+        const payload = frame.subarray(HEADER_SIZE);
+        const isParity = index >= k;
+        if (k === 0 || k > MAX_K || m > MAX_M || index >= k + m ||
+            (isParity ? payload.length === 0 || payload.length > MAX_SHARD : payload.length > MAX_SHARD - 1)) {
+            this.stats.malformed++;
+            return [];
+        }
+        this.stats.framesIn++;
+
+        let state = this.sources.get(sourceKey);
+        if (state && state.group !== group) {
+            // Group ids wrap; anything in the half behind the current one is late
+            if (((group - state.group) & 0xFF) >= 128) { this.stats.stale++; return []; }
+            this.closeGroup(state);
+            state = null;
+        }
+        if (!state) {
+            state = { group, k, m, kKnown: false, data: new Map(), parity: new Map(), delivered: new Set(), shardLen: 0 };
+            this.sources.set(sourceKey, state);
+        }
+        state.touchedAt = Date.now();
+
+        const out = [];
+        if (!isParity) {
+            if (state.data.has(index)) return out;
+            state.data.set(index, Buffer.from(payload));
+            if (!state.delivered.has(index)) {
+                state.delivered.add(index);
+                out.push(Buffer.from(payload));
+            }
+        } else {
+            const p = index - k;
+            if (state.parity.has(p)) return out;
+            if (state.kKnown && (state.k !== k || state.shardLen !== payload.length)) {
+                this.stats.malformed++;
+                return out;
+            }
+            state.parity.set(p, Buffer.from(payload));
+            Object.assign(state, { k, m, kKnown: true, shardLen: payload.length });
+        }
+
+        if (state.kKnown && state.delivered.size < state.k &&
+            state.data.size + state.parity.size >= state.k) {
+            out.push(...this.recover(state));
+        }
+        this.stats.delivered += out.length;
+        return out;
+    }
+
+    recover(state) {
+        const { k, m, shardLen } = state;
+        const shards = new Array(k + m).fill(null);
+        for (const [j, payload] of state.data) {
+            if (j >= k || payload.length + 1 > shardLen) { this.stats.malformed++; return []; }
+            const shard = new Uint8Array(shardLen);
+            shard[0] = payload.length;
+            shard.set(payload, 1);
+            shards[j] = shard;
+        }
+        for (const [p, payload] of state.parity) shards[k + p] = payload;
+
+        const rebuilt = reconstruct(shards, k, m, shardLen);
+        if (!rebuilt) return [];
+        const out = [];
+        for (const [j, shard] of rebuilt) {
+            state.delivered.add(j);
+            if (shard[0] + 1 > shardLen) { this.stats.malformed++; continue; }
+            out.push(Buffer.from(shard.subarray(1, 1 + shard[0])));
+            this.stats.recovered++;
+        }
+        return out;
+    }
+
+    closeGroup(state) {
+        // Without parity the group size is unknown; count holes below the highest index
+        const expected = state.kKnown ? state.k : Math.max(-1, ...state.delivered) + 1;
+        for (let j = 0; j < expected; j++) {
+            if (!state.delivered.has(j)) { this.stats.incompleteGroups++; break; }
+        }
+    }
+
+    // Drop groups that have been idle longer than the timeout
+    expire(now = Date.now()) {
+        for (const [key, state] of this.sources) {
+            if (now - state.touchedAt > this.groupTimeoutMs) {
+                this.closeGroup(state);
+                this.sources.delete(key);
+            }
+        }
+    }
+
+    getStats() {
+        return { ...this.stats, activeSources: this.sources.size };
+    }
+}
+
+module.exports = { FecReassembler, reconstruct, HEADER_SIZE };
@@ -10,6 +10,13 @@ const axios = require('axios');
 const protobuf = require('protobufjs');
 const path = require('path');
 const ContainerDatabase = require('./database');
+const { summarizeShockBurst } = require('./shock_burst');
+const { FecReassembler } = require('./fec_rs');
+const { AeadReceiver, MemorySequenceStore } = require('./aead_frame');
+const { AdmissionController } = require('./admission');
+const { EventLog } = require('./event_log');
+const { BatchIngest, BatchStatus, FORMATS, STATUS } = require('./batch_frame');
+const { CommitLog } = require('./commit_log');
 
 // ================= CONFIG =================
 const CONFIG = {
@@ -18,7 +25,32 @@ const CONFIG = {
     OUTBOUND_URL: process.env.OUTBOUND_URL || null,
     OUTBOUND_RETRY_INTERVAL: 5000,
     MAX_RETRY_ATTEMPTS: 100,
-    MAX_DB_RETRIES: 5
+    MAX_DB_RETRIES: 5,
+    ASTROCAST_FEC: process.env.ASTROCAST_FEC === 'true',   // callback payloads are FEC frames
+    FEC_GROUP_TIMEOUT: parseInt(process.env.FEC_GROUP_TIMEOUT_MS) || 15 * 60 * 1000,
+    ASTROCAST_AEAD: process.env.ASTROCAST_AEAD === 'true',  // callback payloads are AEAD frames
+    AEAD_KEYS_FILE: process.env.AEAD_KEYS_FILE || null,
+    AEAD_MASTER_KEY: process.env.AEAD_MASTER_KEY || null,
+    AEAD_TAG_LENGTH: parseInt(process.env.AEAD_TAG_LENGTH) || 6,
+    AEAD_MAX_PEERS: parseInt(process.env.AEAD_MAX_PEERS) || 10000,       // devices with a key and window in memory
+    AEAD_RESYNC_PER_SEC: parseInt(process.env.AEAD_RESYNC_PER_SEC) || 20, // epoch searches for devices never seen
+    CALLBACK_SLICE: parseInt(process.env.CALLBACK_SLICE) || 64,   // batched callbacks per event-loop turn
+    STORAGE_BATCH: parseInt(process.env.STORAGE_BATCH) || 500,     // rows per database transaction
+    STORAGE_LINGER_MS: parseInt(process.env.STORAGE_LINGER_MS) || 100,
+    OUTBOUND_WINDOW: parseInt(process.env.OUTBOUND_WINDOW) || 1000 // records held by the forwarder (sending or retrying)
+};
+
+// ================= EVENT LOG =================
+// Hot-path messages go to the binary event log (render with `npm run logs`)
+const events = new EventLog();
+const EVENTS = {
+    shockDiscarded: events.define('warn', 'Discarding malformed shock burst: {}'),
+    messageError: events.define('error', 'Error processing message: {}'),
+    batchDone: events.define('info', 'Processed: {}, Errors: {} | Rate: {}/sec'),
+    noDatabase: events.define('warn', 'Database not available, skipping storage'),
+    storeError: events.define('error', 'Error storing record: {}'),
+    astrocastReceived: events.define('info', 'Astrocast msg received ({} bytes) guid={}'),
+    unhandled: events.define('error', 'Unhandled error: {}')
 };
 
 // Container field definitions
@@ -58,7 +90,7 @@ const safeToFixed = (value, decimals = 2, def = '0.00') =>
 function protobufDecompress(compressedData) {
     try {
         const pbMessage = ContainerData.decode(compressedData);
-        return {
+        const result = {
             msisdn: pbMessage.msisdn || '',
             iso6346: pbMessage.iso6346 || '',
             time: pbMessage.time || '',
@@ -80,6 +112,19 @@ function protobufDecompress(compressedData) {
             heading: safeToFixed(pbMessage.heading, 2),
             hdop: safeToFixed(pbMessage.hdop, 1)
         };
+
+        // Optional shock burst, only present after an accelerometer event
+        if (pbMessage.shock && pbMessage.shock.length > 0) {
+            try {
+                result.shock = {
+                    ...summarizeShockBurst(pbMessage.shock),
+                    data: Buffer.from(pbMessage.shock).toString('base64')
+                };
+            } catch (err) {
+                events.emit(EVENTS.shockDiscarded, err.message);
+            }
+        }
+        return result;
     } catch (err) {
         throw new Error(`Protocol Buffer decompression failed: ${err.message}`);
     }
@@ -107,32 +152,57 @@ class MessageQueue {
     processQueue() {
         if (this.queue.length === 0) return;
 
-        const batch = this.queue.splice(0);
+        let batch = this.queue.splice(0);
         let processed = 0, errors = 0;
+        this.openSealed(batch);
+        // Frames whose replay floor could not be saved wait for the next round
+        const held = batch.filter(msg => msg.retry);
+        if (held.length > 0) {
+            batch = batch.filter(msg => !msg.retry);
+            held.forEach(msg => { delete msg.retry; });
+            this.queue.unshift(...held);
+        }
 
         batch.forEach(msg => {
             try {
+                if (msg.error) throw new Error(msg.error);
                 this.processMessage(msg);
                 processed++; this.processed++;
             } catch (err) {
-                console.error('Error processing message:', err.message);
+                events.emit(EVENTS.messageError, err.message);
                 errors++; this.errors++;
             }
         });
 
         if (batch.length > 0) {
-            const rate = (this.processed / ((Date.now() - this.startTime) / 1000)).toFixed(1);
-            console.log(`Processed: ${processed}, Errors: ${errors} | Rate: ${rate}/sec`);
+            const rate = this.processed / ((Date.now() - this.startTime) / 1000);
+            events.emit(EVENTS.batchDone, processed, errors, Math.round(rate * 10) / 10);
         }
     }
 
+    // Decrypt every AEAD frame of the batch in one pass (grouped per device)
+    openSealed(batch) {
+        const sealed = batch.filter(msg => msg.sealed);
+        if (sealed.length === 0) return;
+
+        const results = aeadReceiver.openBatch(
+            sealed.map(msg => ({ deviceId: msg.deviceId, frame: msg.compressedData })));
+        sealed.forEach((msg, i) => {
+            if (results[i].payload) msg.compressedData = results[i].payload;
+            else if (results[i].retry) msg.retry = true;
+            else msg.error = `AEAD open failed: ${results[i].error}`;
+        });
+    }
+
     processMessage(message) {
         const { compressedData } = message;
-        const containerData = protobufDecompress(compressedData);
+        // Batch items arrive decoded
+        const { shock, ...containerData } = message.containerData || protobufDecompress(compressedData);
 
         if (Object.keys(containerData).length !== CONTAINER_FIELDS.length) {
             throw new Error(`Invalid field count: expected ${CONTAINER_FIELDS.length}, got ${Object.keys(containerData).length}`);
         }
+        if (shock) containerData.shock = shock;
 
         const reconstructedData = { "m2m:cin": { "con": containerData } };
         const originalJsonSize = Buffer.byteLength(JSON.stringify(reconstructedData), 'utf8');
@@ -142,22 +212,8 @@ class MessageQueue {
         containerData.compressed_size = compressedSize;
         containerData.compression_ratio = originalJsonSize > 0 ? originalJsonSize / compressedSize : 0;
 
-        this.onDataProcessed(reconstructedData, containerData);
-    }
-
-    async onDataProcessed(data, containerDataWithCompression) {
-        try {
-            if (!database?.db) {
-                console.error('Database not available, skipping storage');
-                outboundQueue.add(data, null);
-                return;
-            }
-            const dbId = await database.insertContainerData(containerDataWithCompression);
-            outboundQueue.add(data, dbId);
-        } catch (err) {
-            console.error('Error in onDataProcessed:', err.message);
-            outboundQueue.add(data, null);
-        }
+        // Storage, forwarding and analytics read it from the log
+        commitLog.append(containerData.msisdn || containerData.iso6346, { data: reconstructedData, containerData });
     }
 
     getStats() {
@@ -189,11 +245,15 @@ class OutboundQueue {
         }
     }
 
-    add(data, dbId = null) {
+    // entry: a commit log entry, read by the forwarder consumer
+    add(entry) {
         if (!CONFIG.OUTBOUND_URL) return;
         this.queue.push({
-            id: `${Date.now()}-${Math.random().toString(36).substr(2, 9)}`,
-            data, dbId, attempts: 0,
+            id: entry.id,
+            partition: entry.partition,
+            offset: entry.offset,
+            data: entry.value.data,
+            attempts: 0,
             createdAt: Date.now(),
             nextRetryAt: Date.now()
         });
@@ -211,7 +271,8 @@ class OutboundQueue {
         if (readyItems.length === 0) { this.processing = false; return; }
 
         for (const item of readyItems) { await this.sendItem(item); }
-        this.queue = this.queue.filter(i => i.attempts > 0 && i.attempts <= CONFIG.MAX_RETRY_ATTEMPTS);
+        // Items the forwarder added while these were sent are kept
+        this.queue = this.queue.filter(i => !i.done);
         this.processing = false;
     }
 
@@ -231,17 +292,17 @@ class OutboundQueue {
             });
 
             if (response.status === 201) {
-                item.attempts = 0; this.totalSent++;
-                if (item.dbId) await database.updateMobiusStatus(item.dbId, true, 'Success');
+                item.done = true; this.totalSent++;
+                noteMobius(item, { sent: true, response: 'Success' });
             } else {
                 throw new Error(`Unexpected status: ${response.status}`);
             }
         } catch (err) {
-            if (item.dbId) await database.incrementErrorCount(item.dbId);
+            noteMobius(item, { error: true });
             if (item.attempts >= CONFIG.MAX_RETRY_ATTEMPTS) {
                 this.totalErrors++;
-                if (item.dbId) await database.updateMobiusStatus(item.dbId, false, `Failed after max attempts`);
-                item.attempts = 0;
+                noteMobius(item, { sent: false, response: 'Failed after max attempts' });
+                item.done = true;
             } else {
                 const delay = Math.min(CONFIG.OUTBOUND_RETRY_INTERVAL * Math.pow(2, item.attempts - 1), 60000);
                 item.nextRetryAt = Date.now() + delay;
@@ -280,18 +341,175 @@ function initializeDatabase() {
     }
 }
 initializeDatabase();
+
+// ================= COMMIT LOG =================
+// Decoded records are appended to commitLog; the storage, forwarder and
+// analytics consumers each read it in batches at their own pace, so a slow
+// Mobius or database write holds back only its own consumer.
+const commitLog = new CommitLog();
+
+// Mobius outcomes for records the storage consumer has not written yet;
+// it writes them with the row
+const mobiusOutcomes = new Map();
+
+function noteMobius(item, { sent = false, response = null, error = false }) {
+    if (!database?.db) return;
+    try {
+        if (commitLog.committed('storage', item.partition) > item.offset) {
+            if (error) database.incrementErrorCountByLogId(item.id);
+            else database.updateMobiusStatusByLogId(item.id, sent, response);
+            return;
+        }
+        const outcome = mobiusOutcomes.get(item.id) || { sent: false, response: null, errors: 0 };
+        if (error) outcome.errors++;
+        else Object.assign(outcome, { sent, response });
+        mobiusOutcomes.set(item.id, outcome);
+    } catch (err) {
+        events.emit(EVENTS.storeError, err.message);
+    }
+}
+
+// Dashboard database: one transaction per batch
+commitLog.consumer('storage', async batch => {
+    const rows = batch.map(entry => {
+        const mobius = mobiusOutcomes.get(entry.id) || null;
+        if (mobius) mobiusOutcomes.delete(entry.id);
+        return { containerData: entry.value.containerData, logId: entry.id, mobius };
+    });
+    if (!database?.db) {
+        events.emit(EVENTS.noDatabase);
+        return;
+    }
+    database.insertContainerBatch(rows).forEach(message => events.emit(EVENTS.storeError, message));
+}, { batchSize: CONFIG.STORAGE_BATCH, lingerMs: CONFIG.STORAGE_LINGER_MS });
+
+// oneM2M forwarder: reads on while fewer than OUTBOUND_WINDOW records are
+// being sent or waiting to retry; the backlog beyond that stays in the log
+if (CONFIG.OUTBOUND_URL) {
+    commitLog.consumer('forwarder', batch => {
+        batch.forEach(entry => outboundQueue.add(entry));
+        outboundQueue.processQueue();
+    }, { batchSize: 256, ready: () => outboundQueue.queue.length < CONFIG.OUTBOUND_WINDOW });
+}
+
+// Rolling per-minute figures over the last hour (GET /api/analytics)
+class Analytics {
+    constructor(minutes = 60) {
+        this.minutes = minutes;
+        this.buckets = new Map();
+        this.totals = { records: 0, doorOpen: 0, shocks: 0 };
+    }
+
+    consume(batch) {
+        for (const { value: { containerData: d }, appendedAt } of batch) {
+            const minute = Math.floor(appendedAt / 60000);
+            let b = this.buckets.get(minute);
+            if (!b) {
+                b = { records: 0, containers: new Set(), doorOpen: 0, shocks: 0, temperature: 0, compression: 0 };
+                this.buckets.set(minute, b);
+            }
+            b.records++;
+            b.containers.add(d.iso6346);
+            if (d.door === 'O') b.doorOpen++;
+            if (d.shock) b.shocks++;
+            b.temperature += parseFloat(d.temperature) || 0;
+            b.compression += d.compression_ratio || 0;
+            this.totals.records++;
+            if (d.door === 'O') this.totals.doorOpen++;
+            if (d.shock) this.totals.shocks++;
+        }
+        const oldest = Math.floor(Date.now() / 60000) - this.minutes;
+        for (const minute of this.buckets.keys()) if (minute < oldest) this.buckets.delete(minute);
+    }
+
+    getStats() {
+        const minutes = [...this.buckets.entries()].sort((a, b) => a[0] - b[0]).map(([minute, b]) => ({
+            minute: new Date(minute * 60000).toISOString(),
+            records: b.records,
+            containers: b.containers.size,
+            doorOpen: b.doorOpen,
+            shocks: b.shocks,
+            avgTemperature: Math.round(b.temperature / b.records * 100) / 100,
+            avgCompression: Math.round(b.compression / b.records * 100) / 100
+        }));
+        return { totals: this.totals, minutes };
+    }
+}
+const analytics = new Analytics();
+commitLog.consumer('analytics', batch => analytics.consume(batch), { batchSize: 2048, lingerMs: 1000 });
+
 const messageQueue = new MessageQueue();
 const outboundQueue = new OutboundQueue();
+const fecReassembler = new FecReassembler(CONFIG.FEC_GROUP_TIMEOUT);
+// Replay floors live in SQLite, or in memory while there is no database
+const aeadMemory = new MemorySequenceStore();
+const aeadReceiver = new AeadReceiver({
+    keysFile: CONFIG.AEAD_KEYS_FILE,
+    masterKey: CONFIG.AEAD_MASTER_KEY,
+    tagLength: CONFIG.AEAD_TAG_LENGTH,
+    maxPeers: CONFIG.AEAD_MAX_PEERS,
+    resyncPerSecond: CONFIG.AEAD_RESYNC_PER_SEC,
+    store: {
+        load: deviceId => (database && database.db ? database.getAeadSequence(deviceId) : aeadMemory.load(deviceId)),
+        save: entries => (database && database.db ? database.saveAeadSequences(entries) : aeadMemory.save(entries))
+    }
+});
+setInterval(() => fecReassembler.expire(), 60000);
+const admission = new AdmissionController(() => ({
+    depth: messageQueue.queue.length,
+    oldestQueuedAt: messageQueue.queue.length ? messageQueue.queue[0].queuedAt : null,
+    outboundDepth: commitLog.retained() + outboundQueue.queue.length,
+    processed: messageQueue.processed,
+    sent: commitLog.released
+}), { drainIntervalMs: CONFIG.QUEUE_PROCESS_INTERVAL });
+const batches = new BatchIngest();
+
+// Answers 503 and returns true when the request is shed. Sealed and FEC
+// frames cannot be read at ingest (no decode): X-Priority or routine.
+function shed(req, res, decode) {
+    const decision = admission.admit(req, decode);
+    if (decision.admitted) return false;
+    admission.reject(res, decision);
+    return true;
+}
+
+// Queue every payload released by the FEC layer (received or rebuilt)
+function addFecFrame(sourceKey, frame, receivedAt, sealed = null) {
+    const payloads = fecReassembler.push(sourceKey, frame);
+    payloads.forEach(compressedData =>
+        messageQueue.add({ compressedData, receivedAt, size: compressedData.length, ...sealed }));
+    return payloads.length;
+}
+
+// AEAD frames are queued sealed and opened in batches by the processor.
+// Returns the queue item fields, or throws if the frame cannot be queued;
+// the error has retry set while replay floors cannot be saved.
+function sealedFields(deviceId) {
+    if (!aeadReceiver.enabled) throw new Error('AEAD keys not configured');
+    if (!deviceId) throw new Error('Missing device ID for sealed payload');
+    if (!aeadReceiver.storeAvailable) {
+        throw Object.assign(new Error('AEAD sequence store unavailable, retry later'), { retry: true });
+    }
+    return { sealed: true, deviceId };
+}
+
+// 503 with Retry-After for a retryable sealedFields error, else 400
+function rejectSealed(res, err) {
+    if (!err.retry) return res.status(400).json({ error: err.message });
+    res.set('Retry-After', String(admission.retryAfter()));
+    return res.status(503).json({ error: err.message });
+}
+const isSealed = req => (req.get('X-Payload-Sealed') || '').toLowerCase() === 'aead';
 
 // ================= MIDDLEWARE =================
 app.use(express.raw({ type: 'application/octet-stream', limit: '1mb' }));
-app.use(express.json());
+app.use(express.json({ limit: '1mb' }));
 
 // CORS
 app.use((req, res, next) => {
     res.header('Access-Control-Allow-Origin', '*');
     res.header('Access-Control-Allow-Methods', 'GET, POST, PUT, DELETE, OPTIONS');
-    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization');
+    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization, X-Device-Id, X-Payload-Sealed, X-Priority');
     if (req.method === 'OPTIONS') return res.sendStatus(200);
     next();
 });
@@ -304,11 +522,17 @@ app.get('/dashboard', (req, res) => {
 
 // ================= HEALTH =================
 app.get('/health', (req, res) => {
+    const admissionStats = admission.getStats();
+    // Still 200 while shedding: the replica is up and admitting alarms
     res.json({
-        status: 'healthy',
+        status: admissionStats.level === 'normal' ? 'healthy' : 'degraded',
         timestamp: new Date().toISOString(),
         inbound: messageQueue.getStats(),
-        outbound: outboundQueue.getStats()
+        outbound: outboundQueue.getStats(),
+        log: commitLog.getStats(),
+        fec: fecReassembler.getStats(),
+        aead: aeadReceiver.getStats(),
+        admission: admissionStats
     });
 });
 
@@ -350,13 +574,21 @@ app.get('/api/stats', async (req, res) => {
             timestamp: new Date().toISOString(),
             database: dbStats,
             inbound: messageQueue.getStats(),
-            outbound: outboundQueue.getStats()
+            outbound: outboundQueue.getStats(),
+            log: commitLog.getStats(),
+            admission: admission.getStats(),
+            batch: batches.getStats(),
+            eventLog: events.getStats()
         });
     } catch (err) {
         res.status(500).json({ error: 'Failed to fetch stats' });
     }
 });
 
+app.get('/api/analytics', (req, res) => {
+    res.json({ timestamp: new Date().toISOString(), ...analytics.getStats() });
+});
+
 app.get('/api/activity', async (req, res) => {
     try {
         let minutes = parseInt(req.query.minutes);
@@ -384,18 +616,78 @@ app.get('/api/search', async (req, res) => {
 });
 
 // ================= INGESTION ENDPOINTS =================
-// Astrocast JSON callback
-app.post('/astrocast-callback', (req, res) => {
-    try {
-        const { data, guid } = req.body;
-        if (!data) return res.status(400).json({ error: 'Missing data field' });
+// One Astrocast callback message. Returns { size, released } when queued,
+// { decision } when shed, { unavailable } when it cannot be taken now and
+// { error } when the message is unusable.
+function ingestCallback(req, message, receivedAt) {
+    const { data, guid, deviceGuid } = message || {};
+    if (!data || typeof data !== 'string') return { error: 'Missing data field' };
+
+    const compressedData = Buffer.from(data, 'base64');
+    if (compressedData.length === 0) return { error: 'Empty payload' };
+
+    let sealed = null;
+    if (CONFIG.ASTROCAST_AEAD) {
+        try {
+            sealed = sealedFields(aeadReceiver.deviceForGuid(deviceGuid));
+        } catch (err) {
+            return err.retry ? { unavailable: err } : { error: err.message };
+        }
+    }
 
-        const compressedData = Buffer.from(data, 'base64');
-        if (compressedData.length === 0) return res.status(400).json({ error: 'Empty payload' });
+    const readable = !sealed && !CONFIG.ASTROCAST_FEC;
+    const decision = admission.admit(req, readable ? () => protobufDecompress(compressedData) : null);
+    if (!decision.admitted) return { decision };
 
-        messageQueue.add({ compressedData, receivedAt: Date.now(), size: compressedData.length });
-        console.log(`Astrocast msg received (${compressedData.length} bytes) guid=${guid || 'n/a'}`);
-        res.json({ status: 'astrocast-received', size: compressedData.length });
+    if (CONFIG.ASTROCAST_FEC) {
+        const released = addFecFrame(deviceGuid || 'astrocast', compressedData, receivedAt, sealed);
+        return { size: compressedData.length, released };
+    }
+
+    messageQueue.add({ compressedData, receivedAt, size: compressedData.length, ...sealed });
+    events.emit(EVENTS.astrocastReceived, compressedData.length, guid || 'n/a');
+    return { size: compressedData.length };
+}
+
+// Batched callbacks (a JSON array). CALLBACK_SLICE messages are ingested
+// per event-loop turn, so a satellite-pass burst does not hold the loop
+// for the whole body; each message gets a status as in /container-data/batch.
+function ingestCallbacks(req, res, messages) {
+    if (messages.length > batches.maxItems) {
+        return res.status(400).json({
+            error: 'Invalid callback batch',
+            message: `${messages.length} messages exceed the limit of ${batches.maxItems}`
+        });
+    }
+    const status = new BatchStatus(messages.length);
+    const receivedAt = Date.now();
+    let next = 0;
+    const step = () => {
+        try {
+            const end = Math.min(next + CONFIG.CALLBACK_SLICE, messages.length);
+            for (; next < end; next++) {
+                const result = ingestCallback(req, messages[next], receivedAt);
+                if (result.error) status.set(next, STATUS.REJECTED);
+                else if (result.decision || result.unavailable) status.set(next, STATUS.RETRY);
+            }
+            if (next < messages.length) return setImmediate(step);
+            batches.reply(req, res, status, () => admission.retryAfter(), { queueSize: messageQueue.queue.length });
+        } catch (err) {
+            res.status(500).json({ error: err.message });
+        }
+    };
+    step();
+}
+
+// Astrocast JSON callback, one object or an array of them
+app.post('/astrocast-callback', (req, res) => {
+    if (Array.isArray(req.body)) return ingestCallbacks(req, res, req.body);
+    try {
+        const result = ingestCallback(req, req.body, Date.now());
+        if (result.error) return res.status(400).json({ error: result.error });
+        if (result.unavailable) return rejectSealed(res, result.unavailable);
+        if (result.decision) return admission.reject(res, result.decision);
+        res.json({ status: 'astrocast-received', ...result });
     } catch (err) {
         res.status(500).json({ error: err.message });
     }
@@ -408,16 +700,86 @@ app.post('/container-data', (req, res) => {
         if (!Buffer.isBuffer(compressedData)) return res.status(400).json({ error: 'Invalid data format' });
         if (compressedData.length === 0) return res.status(400).json({ error: 'Empty payload' });
 
-        messageQueue.add({ compressedData, receivedAt: Date.now(), size: compressedData.length });
+        let sealed = null;
+        if (isSealed(req)) {
+            try {
+                sealed = sealedFields(req.get('X-Device-Id'));
+            } catch (err) {
+                return rejectSealed(res, err);
+            }
+        }
+
+        if (shed(req, res, sealed ? null : () => protobufDecompress(compressedData))) return;
+
+        messageQueue.add({ compressedData, receivedAt: Date.now(), size: compressedData.length, ...sealed });
         res.json({ status: 'received', size: compressedData.length, queueSize: messageQueue.queue.length });
     } catch (err) {
         res.status(500).json({ error: err.message });
     }
 });
 
+// FEC-framed container-data (fec_rs.c), grouped per X-Device-Id
+app.post('/container-data/fec', (req, res) => {
+    try {
+        const frame = req.body;
+        if (!Buffer.isBuffer(frame)) return res.status(400).json({ error: 'Invalid data format' });
+        if (frame.length === 0) return res.status(400).json({ error: 'Empty payload' });
+
+        let sealed = null;
+        if (isSealed(req)) {
+            try {
+                sealed = sealedFields(req.get('X-Device-Id'));
+            } catch (err) {
+                return rejectSealed(res, err);
+            }
+        }
+
+        if (shed(req, res, null)) return;
+
+        const released = addFecFrame(req.get('X-Device-Id') || req.ip, frame, Date.now(), sealed);
+        res.json({ status: 'received', size: frame.length, released, queueSize: messageQueue.queue.length });
+    } catch (err) {
+        res.status(500).json({ error: err.message });
+    }
+});
+
+// Many payloads per request (batch_frame.js), one status each. With
+// X-Payload-Sealed every item is an AEAD frame, queued sealed unread.
+app.post('/container-data/batch', (req, res) => {
+    try {
+        let items;
+        try {
+            items = batches.parse(req.body);
+        } catch (err) {
+            return res.status(400).json({ error: 'Invalid batch', message: err.message });
+        }
+
+        const receivedAt = Date.now();
+        const sealedBatch = isSealed(req);
+        const status = batches.ingest(items, item => {
+            if (item.format !== FORMATS.default && item.format !== FORMATS.protobuf) return STATUS.REJECTED;
+            if (sealedBatch) {
+                if (!aeadReceiver.storeAvailable) return STATUS.RETRY;
+                const sealed = sealedFields(item.deviceId || req.get('X-Device-Id'));
+                if (!admission.admit(req, null).admitted) return STATUS.RETRY;
+                messageQueue.add({ compressedData: item.payload, receivedAt, size: item.payload.length, ...sealed });
+                return STATUS.ACCEPTED;
+            }
+            const containerData = protobufDecompress(item.payload);
+            if (!admission.admit(req, () => containerData).admitted) return STATUS.RETRY;
+            messageQueue.add({ compressedData: item.payload, containerData, receivedAt, size: item.payload.length });
+            return STATUS.ACCEPTED;
+        });
+
+        batches.reply(req, res, status, () => admission.retryAfter(), { queueSize: messageQueue.queue.length });
+    } catch (err) {
+        res.status(500).json({ error: err.message });
+    }
+});
+
 // ================= ERROR HANDLING =================
 app.use((err, req, res, next) => {
-    console.error('Unhandled error:', err);
+    events.emit(EVENTS.unhandled, err.stack || err.message);
     res.status(500).json({ error: err.message });
 });
 app.use((req, res) => {
@@ -427,6 +789,7 @@ app.use((req, res) => {
 // ================= SHUTDOWN =================
 process.on('SIGINT', () => {
     console.log('Shutting down gracefully...');
+    commitLog.close();
     if (database) database.close();
     process.exit(0);
 });
@@ -439,8 +802,13 @@ async function startServer() {
         console.log(`Server running on port ${CONFIG.PORT}`);
         console.log(`Dashboard: http://localhost:${CONFIG.PORT}/dashboard`);
         console.log(`Binary endpoint: POST /container-data`);
+        console.log(`FEC endpoint: POST /container-data/fec`);
+        console.log(`Batch endpoint: POST /container-data/batch (up to ${batches.maxItems} items)`);
         console.log(`Astrocast callback: POST /astrocast-callback`);
         console.log(`Health: GET /health`);
+        console.log(`Admission control: ${admission.enabled ? 'on' : 'off'}`);
+        console.log(`Event log: ${events.mode}`);
+        console.log(`Commit log: ${commitLog.partitions.length} partitions, consumers ${commitLog.consumers.map(c => c.name).join(', ')}`);
         console.log('='.repeat(60));
     });
 }
@@ -0,0 +1,106 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Decoder for the shock burst carried in ContainerData.shock.
+// Mirrors accel_burst_decode() in Native_Toolkit/firmware/accel_burst.c:
+//   byte 0     version(3) | log2(decimation)(2) | quant shift(3)
+//   byte 1     pre-trigger samples
+//   bytes 2-9  rate (Hz), samples per axis, peak (mg), age (100 ms), big-endian
+//   then per axis: first sample int16, blocks of 16 zigzag deltas with a
+//   4-bit width code each (15 = 16 bits), MSB-first bit packing
+
+const SHOCK_VERSION = 1;
+const HEADER_SIZE = 10;
+const BLOCK = 16;
+const MAX_QUANT_SHIFT = 5;
+
+class BitReader {
+    constructor(buf, pos) {
+        this.buf = buf;
+        this.pos = pos;
+        this.acc = 0;
+        this.bits = 0;
+        this.underflow = false;
+    }
+
+    get(width) {
+        let value = 0;
+        while (width > 0) {
+            if (this.bits === 0) {
+                if (this.pos >= this.buf.length) { this.underflow = true; return 0; }
+                this.acc = this.buf[this.pos++];
+                this.bits = 8;
+            }
+            const take = Math.min(width, this.bits);
+            this.bits -= take;
+            width -= take;
+            value = (value * (1 << take)) + ((this.acc >> this.bits) & ((1 << take) - 1));
+        }
+        return value;
+    }
+}
+
+const unzigzag = v => (v & 1) ? -((v + 1) / 2) : v / 2;
+const codeWidth = c => c === 15 ? 16 : c;
+
+// Returns { sampleRateHz, decimation, quantShift, preTrigger, peakMg, ageMs, x, y, z }
+// or throws on a malformed burst
+function decodeShockBurst(buf) {
+    if (!buf || buf.length < HEADER_SIZE || (buf[0] >> 5) !== SHOCK_VERSION) {
+        throw new Error('Invalid shock burst header');
+    }
+
+    const info = {
+        decimation: 1 << ((buf[0] >> 3) & 0x3),
+        quantShift: buf[0] & 0x7,
+        preTrigger: buf[1],
+        sampleRateHz: (buf[2] << 8) | buf[3],
+        nSamples: (buf[4] << 8) | buf[5],
+        peakMg: (buf[6] << 8) | buf[7],
+        ageMs: ((buf[8] << 8) | buf[9]) * 100
+    };
+    if (info.nSamples === 0 || info.quantShift > MAX_QUANT_SHIFT) {
+        throw new Error('Invalid shock burst header');
+    }
+
+    const halfStep = info.quantShift ? 1 << (info.quantShift - 1) : 0;
+    const reader = new BitReader(buf, HEADER_SIZE);
+    const axes = [];
+
+    for (let axis = 0; axis < 3; axis++) {
+        const out = new Int16Array(info.nSamples);
+        let value = (reader.get(16) << 16) >> 16;
+        let width = 0;
+        for (let i = 0; i < info.nSamples; i++) {
+            if (i > 0) {
+                if ((i - 1) % BLOCK === 0) width = codeWidth(reader.get(4));
+                value += unzigzag(reader.get(width));
+            }
+            out[i] = value * (1 << info.quantShift) + halfStep;
+        }
+        axes.push(out);
+    }
+    if (reader.underflow) throw new Error('Truncated shock burst');
+
+    return { ...info, x: axes[0], y: axes[1], z: axes[2] };
+}
+
+// Compact summary stored alongside the container record
+function summarizeShockBurst(buf) {
+    const burst = decodeShockBurst(buf);
+    return {
+        peak_mg: burst.peakMg,
+        sample_rate_hz: burst.sampleRateHz,
+        decimation: burst.decimation,
+        step_mg: 1 << burst.quantShift,
+        samples: burst.nSamples,
+        pre_trigger: burst.preTrigger,
+        age_ms: burst.ageMs,
+        duration_ms: Math.round(burst.nSamples * 1000 / Math.max(burst.sampleRateHz, 1))
+    };
+}
+
+module.exports = { decodeShockBurst, summarizeShockBurst };
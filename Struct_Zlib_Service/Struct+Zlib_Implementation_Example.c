@@ -17,15 +17,36 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_cpu.h"
 #include "nvs_flash.h"
 #include "esp_http_client.h"
 #include "zlib.h"
 
+// Static rANS back end (Native_Toolkit/firmware/record_rans.c)
+#include "record_rans.h"
+// Session-persistent deflate back end (Native_Toolkit/firmware/deflate_session.c)
+#include "deflate_session.h"
+// Per-stage heap accounting (Native_Toolkit/firmware/alloc_track.c, needs CONFIG_HEAP_USE_HOOKS)
+#include "alloc_track.h"
+
 // Configuration
 #define MAX_PAYLOAD_SIZE 158
 #define MAX_STRING_LENGTH 64
 #define HTTP_TIMEOUT_MS 10000
 
+// Back end after struct packing. The receiver detects it from the first byte.
+#define STRUCT_BACKEND_ZLIB 0
+#define STRUCT_BACKEND_RANS 1             // trained static model, ~3x smaller on 110-120 byte records
+#define STRUCT_BACKEND_DEFLATE_SESSION 2  // one deflate stream across messages, ~12 KB RAM
+#define STRUCT_BACKEND STRUCT_BACKEND_RANS
+
+// Heap use per stage, logged every ALLOC_TRACK_REPORT_EVERY messages
+#define ALLOC_TRACK_ENABLED 0
+#define ALLOC_TRACK_REPORT_EVERY 20
+
+// Session back end: the receiver keeps one inflate history per device id
+#define DEVICE_ID "393600504800"
+
 static const char *TAG = "ESP32_STRUCT_ZLIB";
 
 // Container data structure (exact field order as Python)
@@ -63,6 +84,9 @@ static esp_http_client_config_t http_config = {
 // Global variables
 static esp_http_client_handle_t http_client = NULL;
 static bool wifi_connected = false;
+#if STRUCT_BACKEND == STRUCT_BACKEND_DEFLATE_SESSION
+static deflate_session_t deflate_session;
+#endif
 
 // Function prototypes
 static void generate_test_data(container_data_t *data);
@@ -71,6 +95,29 @@ static esp_err_t send_compressed_data(const uint8_t *data, size_t size);
 static void wifi_init_sta(void);
 static void container_data_task(void *pvParameters);
 
+#if ALLOC_TRACK_ENABLED
+static int stage_generate, stage_compress, stage_send;
+
+static void alloc_track_log(uint32_t messages) {
+    alloc_track_stage_t stages[ALLOC_TRACK_MAX_STAGES];
+    size_t n = alloc_track_snapshot(stages, ALLOC_TRACK_MAX_STAGES);
+    ESP_LOGI(TAG, "Heap per stage after %lu messages (free %u, min free %u):", messages,
+             (unsigned)esp_get_free_heap_size(), (unsigned)esp_get_minimum_free_heap_size());
+    for (size_t i = 0; i < n && i < ALLOC_TRACK_MAX_STAGES; i++) {
+        const alloc_track_stage_t *s = &stages[i];
+        uint64_t calls = s->calls ? s->calls : 1;
+        ESP_LOGI(TAG, "  %-10s allocs/msg %.1f bytes/msg %.0f peak %llu largest %llu retained %lld",
+                 s->name, (double)s->allocs / calls, (double)s->bytes / calls,
+                 (unsigned long long)s->peak, (unsigned long long)s->largest, (long long)s->retained);
+    }
+}
+#define STAGE_ENTER(id) alloc_track_enter(id)
+#define STAGE_LEAVE() alloc_track_leave()
+#else
+#define STAGE_ENTER(id) ((void)0)
+#define STAGE_LEAVE() ((void)0)
+#endif
+
 // Generate realistic test container data
 static void generate_test_data(container_data_t *data) {
     static uint32_t container_counter = 0;
@@ -134,24 +181,19 @@ static size_t struct_zlib_compress(const container_data_t *data, uint8_t *compre
     
     size_t offset = 0;
     
-    // Pack string fields with length prefixes (big-endian)
+    // Pack string lengths in place (big-endian); the string bytes follow the
+    // fixed part, in field order, as in the Python sender
     uint16_t msisdn_len = strlen(data->msisdn);
     struct_buffer[offset++] = (msisdn_len >> 8) & 0xFF;
     struct_buffer[offset++] = msisdn_len & 0xFF;
-    memcpy(&struct_buffer[offset], data->msisdn, msisdn_len);
-    offset += msisdn_len;
     
     uint16_t iso6346_len = strlen(data->iso6346);
     struct_buffer[offset++] = (iso6346_len >> 8) & 0xFF;
     struct_buffer[offset++] = iso6346_len & 0xFF;
-    memcpy(&struct_buffer[offset], data->iso6346, iso6346_len);
-    offset += iso6346_len;
     
     uint16_t time_len = strlen(data->time);
     struct_buffer[offset++] = (time_len >> 8) & 0xFF;
     struct_buffer[offset++] = time_len & 0xFF;
-    memcpy(&struct_buffer[offset], data->time, time_len);
-    offset += time_len;
     
     // Pack integer fields
     struct_buffer[offset++] = data->rssi;
@@ -159,8 +201,6 @@ static size_t struct_zlib_compress(const container_data_t *data, uint8_t *compre
     uint16_t cgi_len = strlen(data->cgi);
     struct_buffer[offset++] = (cgi_len >> 8) & 0xFF;
     struct_buffer[offset++] = cgi_len & 0xFF;
-    memcpy(&struct_buffer[offset], data->cgi, cgi_len);
-    offset += cgi_len;
     
     struct_buffer[offset++] = data->ble_m;
     struct_buffer[offset++] = data->bat_soc;
@@ -188,8 +228,6 @@ static size_t struct_zlib_compress(const container_data_t *data, uint8_t *compre
     uint16_t door_len = strlen(data->door);
     struct_buffer[offset++] = (door_len >> 8) & 0xFF;
     struct_buffer[offset++] = door_len & 0xFF;
-    memcpy(&struct_buffer[offset], data->door, door_len);
-    offset += door_len;
     
     // Pack remaining fields
     struct_buffer[offset++] = data->gnss;
@@ -214,6 +252,30 @@ static size_t struct_zlib_compress(const container_data_t *data, uint8_t *compre
     uint32_t hdop_int = __builtin_bswap32(*(uint32_t*)&data->hdop);
     memcpy(&struct_buffer[offset], &hdop_int, 4); offset += 4;
     
+    // Append string data
+    memcpy(&struct_buffer[offset], data->msisdn, msisdn_len); offset += msisdn_len;
+    memcpy(&struct_buffer[offset], data->iso6346, iso6346_len); offset += iso6346_len;
+    memcpy(&struct_buffer[offset], data->time, time_len); offset += time_len;
+    memcpy(&struct_buffer[offset], data->cgi, cgi_len); offset += cgi_len;
+    memcpy(&struct_buffer[offset], data->door, door_len); offset += door_len;
+    
+#if STRUCT_BACKEND == STRUCT_BACKEND_RANS
+    // Static rANS with the trained model
+    size_t compressed_size = record_rans_encode(struct_buffer, struct_size, compressed_buffer, MAX_PAYLOAD_SIZE);
+    
+    free(struct_buffer);
+    
+    if (compressed_size == 0) return 0;
+#elif STRUCT_BACKEND == STRUCT_BACKEND_DEFLATE_SESSION
+    // Continues the device's deflate stream: only the changes since the last message cost bytes
+    int frame_size = deflate_session_compress(&deflate_session, struct_buffer, struct_size,
+                                              compressed_buffer, MAX_PAYLOAD_SIZE);
+    
+    free(struct_buffer);
+    
+    if (frame_size < 0) return 0;
+    size_t compressed_size = (size_t)frame_size;
+#else
     // Compress with zlib at maximum level
     uLong compressed_size = compressBound(struct_size);
     if (compressed_size > MAX_PAYLOAD_SIZE) {
@@ -227,14 +289,16 @@ static size_t struct_zlib_compress(const container_data_t *data, uint8_t *compre
     free(struct_buffer);
     
     if (zlib_result != Z_OK) return 0;
+#endif
     
     ESP_LOGI(TAG, "Compression: %zu -> %lu bytes (%.1fx)", 
-             struct_size, compressed_size, (float)struct_size / compressed_size);
+             struct_size, (unsigned long)compressed_size, (float)struct_size / compressed_size);
     
     return (size_t)compressed_size;
 }
 
 // Send compressed data via HTTP POST
+// Returns ESP_ERR_INVALID_STATE on HTTP 409 (session desync: resend as keyframe)
 static esp_err_t send_compressed_data(const uint8_t *data, size_t size) {
     if (!http_client || !data || size == 0) return ESP_ERR_INVALID_ARG;
     if (size > MAX_PAYLOAD_SIZE) return ESP_ERR_INVALID_SIZE;
@@ -245,6 +309,7 @@ static esp_err_t send_compressed_data(const uint8_t *data, size_t size) {
     if (err == ESP_OK) {
         int status_code = esp_http_client_get_status_code(http_client);
         if (status_code == 200) return ESP_OK;
+        if (status_code == 409) return ESP_ERR_INVALID_STATE;
     }
     return err;
 }
@@ -303,14 +368,37 @@ static void container_data_task(void *pvParameters) {
             continue;
         }
         
+        STAGE_ENTER(stage_generate);
         generate_test_data(&container_data);
+        STAGE_LEAVE();
+        STAGE_ENTER(stage_compress);
+        uint32_t encode_start = esp_cpu_get_cycle_count();
         size_t compressed_size = struct_zlib_compress(&container_data, compressed_buffer);
+        // Encode cost for Native_Toolkit/tools/energy_report --cycles
+        uint32_t encode_cycles = esp_cpu_get_cycle_count() - encode_start;
+        STAGE_LEAVE();
         
         if (compressed_size > 0) {
+            STAGE_ENTER(stage_send);
             esp_err_t send_result = send_compressed_data(compressed_buffer, compressed_size);
+            STAGE_LEAVE();
+#if STRUCT_BACKEND == STRUCT_BACKEND_DEFLATE_SESSION
+            // The receiver lost the history (missed message or restart): resend as a keyframe
+            if (send_result != ESP_OK) {
+                deflate_session_request_keyframe(&deflate_session);
+                if (send_result == ESP_ERR_INVALID_STATE) {
+                    compressed_size = struct_zlib_compress(&container_data, compressed_buffer);
+                    send_result = compressed_size > 0 ? send_compressed_data(compressed_buffer, compressed_size) : ESP_FAIL;
+                }
+            }
+#endif
             if (send_result == ESP_OK) {
                 message_counter++;
-                ESP_LOGI(TAG, "Message %lu sent (%zu bytes)", message_counter, compressed_size);
+                ESP_LOGI(TAG, "Message %lu sent (%zu bytes, encode %lu cycles)", message_counter, compressed_size,
+                         (unsigned long)encode_cycles);
+#if ALLOC_TRACK_ENABLED
+                if (message_counter % ALLOC_TRACK_REPORT_EVERY == 0) alloc_track_log(message_counter);
+#endif
             }
         }
         
@@ -342,6 +430,18 @@ void app_main(void) {
     http_client = esp_http_client_init(&http_config);
     if (http_client == NULL) return;
     
+#if STRUCT_BACKEND == STRUCT_BACKEND_DEFLATE_SESSION
+    if (deflate_session_init(&deflate_session, Z_BEST_COMPRESSION, DEFLATE_SESSION_KEYFRAME_INTERVAL) != DEFLATE_SESSION_OK) return;
+    esp_http_client_set_header(http_client, "X-Device-Id", DEVICE_ID);
+#endif
+    
+#if ALLOC_TRACK_ENABLED
+    if (!alloc_track_hooked()) ESP_LOGW(TAG, "CONFIG_HEAP_USE_HOOKS is off: heap per stage is not tracked");
+    stage_generate = alloc_track_stage("generate");
+    stage_compress = alloc_track_stage("compress");
+    stage_send = alloc_track_stage("http-send");
+#endif
+    
     // Create container data task
     xTaskCreate(container_data_task, "container_data", 8192, NULL, 5, NULL);
     
@@ -3,6 +3,8 @@ import zlib
 import time
 import random
 import json
+import mmap
+import sys
 from datetime import datetime, timedelta
 from locust import HttpUser, task, between, events
 import logging
@@ -20,6 +22,64 @@ import os
 DEFAULT_POOL_SIZE = 10000
 DATA_POOL_SIZE = int(os.environ.get('LOCUST_DATA_POOL_SIZE', DEFAULT_POOL_SIZE))
 
+# Back end after struct packing: 'zlib' (default), 'rans' (static trained model)
+# or 'session' (one deflate stream per simulated device, see DeflateSession)
+STRUCT_BACKEND = os.environ.get('STRUCT_BACKEND', 'zlib')
+SESSION_KEYFRAME_INTERVAL = int(os.environ.get('SESSION_KEYFRAME_INTERVAL', 32))
+RECORD_RANS_MODEL_PATH = os.environ.get(
+    'RECORD_RANS_MODEL',
+    os.path.join(os.path.dirname(os.path.abspath(__file__)), 'nodejs_receiver', 'record_rans_model.json'))
+
+# Pre-encoded corpus shared by all workers (Native_Toolkit/tools/corpus_build,
+# layout in Native_Toolkit/common/payload_corpus.h). Every worker maps the
+# same file read-only, so startup is instant and every run sends the same bytes.
+CORPUS_PATH = os.environ.get('LOCUST_CORPUS')
+CORPUS_CODEC = 'struct-rans' if STRUCT_BACKEND == 'rans' else 'struct-zlib'
+
+# Native codecs (Native_Toolkit/python/native_codecs.c): the C encoders of the
+# host tools, byte for byte, at native speed. Used when the extension is built;
+# NATIVE_CODECS=0 keeps the Python encoders.
+NATIVE_CODECS_DIR = os.environ.get('NATIVE_CODECS_DIR', os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), '..', 'Native_Toolkit', 'python'))
+native_codecs = None
+if os.environ.get('NATIVE_CODECS', '1') != '0':
+    sys.path.insert(0, NATIVE_CODECS_DIR)
+    try:
+        import native_codecs
+    except ImportError:
+        pass
+
+class PayloadCorpus:
+    """Read-only mmap of a corpus file, indexed like the generated data pool"""
+    HEADER = struct.Struct('<8sII16sQqIIQ')
+    ENTRY = struct.Struct('<II')
+
+    def __init__(self, path, codec):
+        with open(path, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        (magic, version, count, name, self.seed, self.time_base,
+         crc, _, payload_bytes) = self.HEADER.unpack_from(self._map, 0)
+        name = name.rstrip(b'\0').decode()
+        if magic != b'IPCORP1\0' or version != 1:
+            raise ValueError(f"{path}: not a payload corpus")
+        if name != codec:
+            raise ValueError(f"{path}: corpus holds {name} payloads, this sender sends {codec}")
+        self._data = self.HEADER.size + self.ENTRY.size * count
+        if count == 0 or len(self._map) != self._data + payload_bytes:
+            raise ValueError(f"{path}: truncated corpus")
+        with memoryview(self._map) as view, view[self.HEADER.size:] as body:
+            if zlib.crc32(body) != crc:
+                raise ValueError(f"{path}: corpus CRC mismatch")
+        self.count = count
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, i):
+        offset, length = self.ENTRY.unpack_from(self._map, self.HEADER.size + self.ENTRY.size * i)
+        start = self._data + offset
+        return {'compressed': self._map[start:start + length], 'size': length}
+
 def convert_to_typed_data(string_data: dict) -> dict:
     """Convert string-based data to properly typed data for struct compression"""
     
@@ -55,8 +115,8 @@ def convert_to_typed_data(string_data: dict) -> dict:
     
     return typed_data
 
-def struct_zlib_compress(data: dict) -> bytes:
-    """Smart compression: struct + zlib approach"""
+def struct_pack(data: dict) -> bytes:
+    """Struct packing: fixed-size fields and string lengths, then the strings"""
     
     typed_data = convert_to_typed_data(data)
     
@@ -92,8 +152,132 @@ def struct_zlib_compress(data: dict) -> bytes:
     for string_bytes in string_data:
         binary_data += string_bytes
     
+    return binary_data
+
+def struct_zlib_compress(data: dict) -> bytes:
+    """Smart compression: struct + zlib approach"""
+    
+    if native_encoder_ready():
+        return native_codecs.encode(CORPUS_CODEC, data)
+    binary_data = struct_pack(data)
+    if STRUCT_BACKEND == 'rans':
+        return record_rans_encode(binary_data)
     return zlib.compress(binary_data, level=9)
 
+# Static rANS back end (mirrors Native_Toolkit/firmware/record_rans.c)
+RECORD_RANS_L = 1 << 23
+RECORD_RANS_FIXED_BYTES = 63
+RECORD_RANS_STR_POSITIONS = 16
+RECORD_RANS_STR_LEN_OFFSETS = (0, 2, 4, 7, 35)  # msisdn, iso6346, time, cgi, door
+_record_rans_model = None
+
+def load_record_rans_model():
+    """Load the trained model once: (version, [(scale_bits, freq, cum) per context])"""
+    global _record_rans_model
+    if _record_rans_model is None:
+        with open(RECORD_RANS_MODEL_PATH) as f:
+            model = json.load(f)
+        contexts = []
+        for ctx in model['contexts']:
+            freq = [1] * 256
+            for symbol, count in ctx['pairs']:
+                freq[symbol] = count
+            cum = [0] * 257
+            for symbol in range(256):
+                cum[symbol + 1] = cum[symbol] + freq[symbol]
+            contexts.append((ctx['scale'], freq, cum))
+        _record_rans_model = (model['version'], contexts)
+    return _record_rans_model
+
+def record_rans_encode(packed: bytes) -> bytes:
+    """Static rANS coding of a packed record: [0xA0 | version][state u32 BE][bytes]"""
+    version, contexts = load_record_rans_model()
+    
+    lengths = [struct.unpack_from('>H', packed, offset)[0] for offset in RECORD_RANS_STR_LEN_OFFSETS]
+    ctx = list(range(RECORD_RANS_FIXED_BYTES))
+    for field, length in enumerate(lengths):
+        base = RECORD_RANS_FIXED_BYTES + field * RECORD_RANS_STR_POSITIONS
+        ctx.extend(base + min(pos, RECORD_RANS_STR_POSITIONS - 1) for pos in range(length))
+    if len(ctx) != len(packed):
+        raise ValueError('record does not follow the packed layout')
+    
+    # rANS is last-in first-out: encode backwards, then reverse the output
+    x = RECORD_RANS_L
+    out = bytearray()
+    for symbol, c in zip(reversed(packed), reversed(ctx)):
+        scale, freq, cum = contexts[c]
+        f = freq[symbol]
+        x_max = ((RECORD_RANS_L >> scale) << 8) * f
+        while x >= x_max:
+            out.append(x & 0xFF)
+            x >>= 8
+        x = ((x // f) << scale) + (x % f) + cum[symbol]
+    out.reverse()
+    
+    return bytes([0xA0 | version]) + struct.pack('>I', x) + bytes(out)
+
+# Session-persistent deflate (mirrors Native_Toolkit/firmware/deflate_session.c)
+class DeflateSession:
+    """One raw deflate stream per device: [0xC0 | flags][seq u8][deflate, sync marker stripped]"""
+    
+    MAGIC = 0xC0
+    FLAG_KEY = 0x01
+    SYNC_MARKER = b'\x00\x00\xff\xff'
+    
+    def __init__(self, keyframe_interval=SESSION_KEYFRAME_INTERVAL):
+        self.keyframe_interval = keyframe_interval
+        self.seq = 0
+        self.since_key = 0
+        self.key_next = True
+        self.reset_next = False
+        self.stream = self._new_stream()
+    
+    @staticmethod
+    def _new_stream():
+        # Same window (2 KB) and memory level as the firmware
+        return zlib.compressobj(9, zlib.DEFLATED, -11, 4)
+    
+    def request_keyframe(self):
+        """The receiver lost track (HTTP 409): restart the history on the next frame"""
+        if not self.key_next:
+            self.reset_next = True
+        self.key_next = True
+    
+    def compress(self, packed: bytes) -> bytes:
+        key = self.key_next
+        if self.reset_next:
+            self.stream = self._new_stream()
+            self.reset_next = False
+        if key:
+            self.since_key = 0
+        
+        # The message before a scheduled keyframe ends with a full flush
+        full = self.keyframe_interval > 0 and self.since_key + 1 >= self.keyframe_interval
+        out = self.stream.compress(packed) + self.stream.flush(zlib.Z_FULL_FLUSH if full else zlib.Z_SYNC_FLUSH)
+        if not out.endswith(self.SYNC_MARKER):
+            raise ValueError('deflate flush did not end with the sync marker')
+        
+        frame = bytes([self.MAGIC | (self.FLAG_KEY if key else 0), self.seq]) + out[:-len(self.SYNC_MARKER)]
+        self.seq = (self.seq + 1) & 0xFF
+        self.key_next = full
+        self.since_key += 1
+        return frame
+
+def native_encoder_ready() -> bool:
+    """The extension builds the firmware's rANS model in; use it only for the same model"""
+    if not native_codecs:
+        return False
+    if STRUCT_BACKEND == 'rans':
+        return native_codecs.RANS_MODEL_VERSION == load_record_rans_model()[0]
+    return True
+
+def struct_zlib_compress_batch(records: list) -> list:
+    """Encode a list of records, in one native call when available"""
+    if native_encoder_ready():
+        payloads, offsets = native_codecs.encode_batch(CORPUS_CODEC, records)
+        return [payloads[offsets[i]:offsets[i + 1]] for i in range(len(records))]
+    return [struct_zlib_compress(data) for data in records]
+
 class ContainerDataSender(HttpUser):
     wait_time = between(1, 3)
     
@@ -112,6 +296,13 @@ class ContainerDataSender(HttpUser):
         is_master = "--master" in sys.argv
         worker_label = "WORKER" if is_worker else "MASTER" if is_master else "SINGLE"
         
+        if CORPUS_PATH:
+            cls._data_pool = PayloadCorpus(CORPUS_PATH, CORPUS_CODEC)
+            cls._pool_initialized = True
+            logger.info(f"[{worker_label}] Mapped corpus {CORPUS_PATH}: {len(cls._data_pool):,} payloads "
+                        f"(seed {cls._data_pool.seed})")
+            return
+        
         logger.info(f"[{worker_label}] Pre-generating {cls._data_pool_size:,} container data records...")
         
         cls._data_pool = []
@@ -126,24 +317,24 @@ class ContainerDataSender(HttpUser):
             batch_generated = 0
             
             while batch_generated < batch_target:
-                data = generate_test_container_data()
-                compressed = struct_zlib_compress(data)
-                size = len(compressed)
+                records = [generate_test_container_data() for _ in range(batch_target - batch_generated)]
+                for data, compressed in zip(records, struct_zlib_compress_batch(records)):
+                    size = len(compressed)
                 
-                if size >= MAX_PAYLOAD_SIZE:
-                    rejected_count += 1
-                    if rejected_count % 100 == 0:
-                        logger.warning(f"Rejected {rejected_count} oversized records ({size} bytes > {MAX_PAYLOAD_SIZE})")
-                    continue
+                    if size >= MAX_PAYLOAD_SIZE:
+                        rejected_count += 1
+                        if rejected_count % 100 == 0:
+                            logger.warning(f"Rejected {rejected_count} oversized records ({size} bytes > {MAX_PAYLOAD_SIZE})")
+                        continue
                 
-                cls._data_pool.append({
-                    'original': data,
-                    'compressed': compressed,
-                    'size': size
-                })
+                    cls._data_pool.append({
+                        'original': data,
+                        'compressed': compressed,
+                        'size': size
+                    })
                 
-                batch_generated += 1
-                generated_count += 1
+                    batch_generated += 1
+                    generated_count += 1
             
             progress = (generated_count / cls._data_pool_size) * 100
             elapsed = time.time() - start_time
@@ -171,12 +362,22 @@ class ContainerDataSender(HttpUser):
         self.message_id = 0
         self.data_index = 0
         
+        # Session mode: every user is one container sending drifting records
+        if STRUCT_BACKEND == 'session':
+            self.device_record = generate_test_container_data()
+            self.device_id = f"{self.device_record['iso6346']}-{id(self):x}"
+            self.session = DeflateSession()
+            return
+        
         if not self.__class__._pool_initialized:
             self.__class__.initialize_data_pool()
     
     @task
     def send_container_data(self):
         """Send pre-generated compressed container data"""
+        if STRUCT_BACKEND == 'session':
+            self.send_session_data()
+            return
         try:
             data_item = self.__class__._data_pool[self.data_index]
             compressed_data = data_item['compressed']
@@ -205,6 +406,37 @@ class ContainerDataSender(HttpUser):
         except Exception as e:
             logger.error(f"Error sending container data: {e}")
 
+    def send_session_data(self):
+        """Send the next record of this user's container through its deflate session"""
+        try:
+            self.device_record = drift_container_data(self.device_record)
+            packed = struct_pack(self.device_record)
+            self.message_id += 1
+            
+            # On 409 the receiver lost the history: resend once as a keyframe
+            for attempt in range(2):
+                frame = self.session.compress(packed)
+                with self.client.post(
+                    TARGET_ENDPOINT,
+                    data=frame,
+                    headers={'Content-Type': 'application/octet-stream', 'X-Device-Id': self.device_id},
+                    catch_response=True
+                ) as response:
+                    if response.status_code == 409 and attempt == 0:
+                        response.success()
+                        self.session.request_keyframe()
+                        continue
+                    if response.status_code == 200:
+                        logger.debug(f"Message {self.message_id} sent successfully ({len(frame)} bytes)")
+                    else:
+                        logger.error(f"Failed to send message {self.message_id}: {response.status_code}")
+                        response.failure(f"HTTP {response.status_code}")
+                        self.session.request_keyframe()
+                break
+                    
+        except Exception as e:
+            logger.error(f"Error sending container data: {e}")
+
 # Locust event listeners
 @events.test_start.add_listener
 def on_test_start(environment, **kwargs):
@@ -278,6 +510,21 @@ def generate_test_container_data():
         "hdop": f"{(0.5 + random.random() * 5):.1f}"
     }
 
+def drift_container_data(previous: dict) -> dict:
+    """Next uplink of the same container: same identity, sensors drift slightly"""
+    data = dict(previous)
+    acc = [float(x) + (random.random() - 0.5) * 0.2 for x in previous['acc'].split()]
+    
+    data['time'] = datetime.now().strftime("%d%m%y %H%M%S.%f")[:-5]
+    data['rssi'] = str(min(35, max(15, int(previous['rssi']) + random.randint(-1, 1))))
+    data['acc'] = ' '.join(f"{value:.4f}" for value in acc)
+    data['temperature'] = f"{float(previous['temperature']) + (random.random() - 0.5) * 0.1:.2f}"
+    data['humidity'] = f"{float(previous['humidity']) + (random.random() - 0.5) * 0.4:.2f}"
+    data['pressure'] = f"{float(previous['pressure']) + (random.random() - 0.5) * 0.1:.4f}"
+    data['speed'] = f"{min(40.0, max(0.0, float(previous['speed']) + (random.random() - 0.5) * 2)):.1f}"
+    data['heading'] = f"{(float(previous['heading']) + (random.random() - 0.5) * 10) % 360:.2f}"
+    return data
+
 def test_compression():
     """Test the compression effectiveness"""
     print("Testing SMART compression (struct + zlib)...")
@@ -292,6 +539,19 @@ def test_compression():
     print(f"   Compression ratio: {len(json_bytes) / len(compressed_data):.2f}x")
     print(f"   Size check: {'PASS' if len(compressed_data) < MAX_PAYLOAD_SIZE else 'FAIL'} (<{MAX_PAYLOAD_SIZE} bytes)")
     print(f"   Space remaining: {MAX_PAYLOAD_SIZE - len(compressed_data)} bytes")
+    if native_encoder_ready():
+        packed = struct_pack(sample_data)
+        python_bytes = record_rans_encode(packed) if STRUCT_BACKEND == 'rans' else zlib.compress(packed, level=9)
+        print(f"   Native encoder matches Python encoder: {'YES' if compressed_data == python_bytes else 'NO'}")
+    
+    session = DeflateSession()
+    record = sample_data
+    sizes = []
+    for _ in range(SESSION_KEYFRAME_INTERVAL):
+        record = drift_container_data(record)
+        sizes.append(len(session.compress(struct_pack(record))))
+    print(f"Session deflate ({len(sizes)} consecutive uplinks of one container):")
+    print(f"   Keyframe: {sizes[0]} bytes, then mean {sum(sizes[1:]) / (len(sizes) - 1):.1f} bytes")
     
     return {
         'compressed_data': compressed_data,
@@ -317,4 +577,6 @@ if __name__ == "__main__":
         print("")
         print("Environment Variables:")
         print(f"  LOCUST_DATA_POOL_SIZE={DATA_POOL_SIZE:,} (default: {DEFAULT_POOL_SIZE:,})")
-        print("    Controls pre-generated data pool size per worker") 
\ No newline at end of file
+        print("    Controls pre-generated data pool size per worker") 
+        print("  LOCUST_CORPUS=<file> (default: unset)")
+        print("    Send payloads from a corpus_build file instead of generating them")
\ No newline at end of file
@@ -0,0 +1,115 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Session-persistent deflate receiver (mirrors Native_Toolkit/firmware/deflate_session.c).
+// Payload: [0xC0 | flags][seq u8][raw deflate ending in a sync flush, marker stripped]
+// flags bit 0 = keyframe. Each device keeps one deflate stream across messages,
+// so every message may reference the ones before it. Instead of holding a
+// zlib stream per device, the receiver keeps the last window of decompressed
+// bytes and passes it as the preset dictionary, which is what the streaming
+// inflater would hold in its window.
+
+const zlib = require('zlib');
+
+const MAGIC = 0xC0;
+const FLAG_KEY = 0x01;
+const HEADER_SIZE = 2;
+const SYNC_MARKER = Buffer.from([0x00, 0x00, 0xFF, 0xFF]);
+
+const isDeflateSession = buf => buf.length > 0 && (buf[0] & 0xF0) === MAGIC;
+
+// Thrown when a message cannot be decoded until the next keyframe
+class SessionDesyncError extends Error {
+    constructor(message, expectedSeq) {
+        super(message);
+        this.resync = true;
+        this.expectedSeq = expectedSeq;
+    }
+}
+
+class SessionTable {
+    // windowBytes must be at least the sender's window (2 KB for windowBits 11)
+    constructor({ windowBytes = 2048, idleTimeoutMs = 24 * 3600 * 1000, maxSessions = 100000 } = {}) {
+        this.windowBytes = windowBytes;
+        this.idleTimeoutMs = idleTimeoutMs;
+        this.maxSessions = maxSessions;
+        this.sessions = new Map(); // deviceId -> { history, expectedSeq, synced, lastSeen }
+        this.counters = { messages: 0, keyframes: 0, desyncs: 0, errors: 0, evicted: 0, wireBytes: 0, packedBytes: 0 };
+        setInterval(() => this.sweep(), Math.min(idleTimeoutMs, 60000)).unref();
+    }
+
+    // Returns the packed record (Buffer); throws SessionDesyncError or Error
+    decode(deviceId, buf) {
+        if (buf.length < HEADER_SIZE || !isDeflateSession(buf)) throw new Error('Not a session frame');
+        const key = (buf[0] & FLAG_KEY) !== 0;
+        const seq = buf[1];
+
+        let session = this.sessions.get(deviceId);
+        if (session) {
+            this.sessions.delete(deviceId); // re-inserted below: Map order is LRU order
+        } else {
+            session = { history: Buffer.alloc(0), expectedSeq: 0, synced: false, lastSeen: 0 };
+        }
+        session.lastSeen = Date.now();
+        this.sessions.set(deviceId, session);
+        if (this.sessions.size > this.maxSessions) {
+            this.sessions.delete(this.sessions.keys().next().value);
+            this.counters.evicted++;
+        }
+
+        if (key) {
+            session.history = Buffer.alloc(0);
+            session.synced = true;
+            this.counters.keyframes++;
+        } else if (!session.synced || seq !== session.expectedSeq) {
+            // A lost message leaves a hole in the history: wait for a keyframe
+            session.synced = false;
+            this.counters.desyncs++;
+            throw new SessionDesyncError(`Session desync for ${deviceId}: got seq ${seq}`, session.expectedSeq);
+        }
+
+        let packed;
+        try {
+            const options = { finishFlush: zlib.constants.Z_SYNC_FLUSH };
+            if (session.history.length > 0) options.dictionary = session.history;
+            packed = zlib.inflateRawSync(Buffer.concat([buf.subarray(HEADER_SIZE), SYNC_MARKER]), options);
+        } catch (error) {
+            session.synced = false;
+            this.counters.errors++;
+            throw new SessionDesyncError(`Session data error for ${deviceId}: ${error.message}`, session.expectedSeq);
+        }
+
+        const history = Buffer.concat([session.history, packed]);
+        session.history = history.length > this.windowBytes
+            ? Buffer.from(history.subarray(history.length - this.windowBytes))
+            : history;
+        session.expectedSeq = (seq + 1) & 0xFF;
+        this.counters.messages++;
+        this.counters.wireBytes += buf.length;
+        this.counters.packedBytes += packed.length;
+        return packed;
+    }
+
+    sweep() {
+        const cutoff = Date.now() - this.idleTimeoutMs;
+        for (const [deviceId, session] of this.sessions) {
+            if (session.lastSeen >= cutoff) break; // LRU order: the rest are newer
+            this.sessions.delete(deviceId);
+            this.counters.evicted++;
+        }
+    }
+
+    getStats() {
+        const { wireBytes, packedBytes } = this.counters;
+        return {
+            ...this.counters,
+            activeSessions: this.sessions.size,
+            ratio: wireBytes > 0 ? packedBytes / wireBytes : 0
+        };
+    }
+}
+
+module.exports = { isDeflateSession, SessionTable, SessionDesyncError };
@@ -0,0 +1,487 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Binary event log for the receiver hot path.
+//
+// console.log formats a string and writes it to stdout synchronously on the
+// event loop. Here a message is a template defined once, with {} where the
+// arguments go; an event is the template id, a timestamp and the raw
+// arguments, appended to a SharedArrayBuffer ring owned by this thread. A
+// worker thread drains the ring into compact files and rotates them, so the
+// event loop never formats text, takes a lock or makes a system call. When
+// the ring is full, events are dropped and counted, never waited for.
+//
+//   EVENT_LOG            binary (default), console (render immediately) or off
+//   EVENT_LOG_DIR        directory of the .evl files (default ./logs)
+//   EVENT_LOG_RING_KB    ring size (default 4096)
+//   EVENT_LOG_FLUSH_MS   drain interval (default 200)
+//   EVENT_LOG_FILE_MB    rotate after this size (default 64)
+//   EVENT_LOG_FILES      files kept per process (default 8)
+//
+// `node event_log.js [--json] [--level L] FILE|DIR...` renders files as text.
+//
+// File format, little endian: "EVL1", then records of
+//   u16 length (whole record), u16 template id, u32 ms since the last epoch
+// followed by the arguments, each a u8 tag and then an i32 (1), an f64 (2),
+// a u16 length and UTF-8 (3), a u8 boolean (4), a u16 string id (5) or
+// nothing (0, null). Three ids are reserved: 0xFFFF defines a template (u16
+// id, u8 level, UTF-8 text), 0xFFFE sets the epoch (f64 ms since 1970) and
+// 0xFFFD defines a string (u16 id, UTF-8). A string argument seen twice is
+// given an id, so a repeated error message costs a map lookup instead of a
+// copy. Every file starts with the definitions and the epoch, so each one
+// decodes on its own.
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { Worker, isMainThread, workerData, threadId } = require('worker_threads');
+
+const MAGIC = Buffer.from('EVL1');
+const ID_DEFINE = 0xFFFF;
+const ID_EPOCH = 0xFFFE;
+const ID_STRING = 0xFFFD;
+const TAG_NULL = 0, TAG_INT = 1, TAG_FLOAT = 2, TAG_STRING = 3, TAG_BOOL = 4, TAG_REF = 5;
+const LEVELS = ['debug', 'info', 'warn', 'error'];
+const MAX_ARGS = 4;
+const MAX_STRING = 1024;                              // UTF-8 bytes kept per string argument
+const MAX_INTERNED = 4096;                            // string ids per process
+const MAX_INTERN_LENGTH = 256;
+const MAX_RECORD = 8 + MAX_ARGS * (3 + MAX_STRING);
+const RECORD_HEADER = 8;
+
+// Ring control words (Int32), then the data from byte 64
+const HEAD = 0, TAIL = 1, END = 2, STATE = 3;
+const RUNNING = 0, CLOSING = 1, CLOSED = 2;
+const DATA_OFFSET = 64;
+
+const envNumber = (name, def) => {
+    const value = parseFloat(process.env[name]);
+    return Number.isFinite(value) ? value : def;
+};
+
+// Replaces each {} with the next argument; extra arguments are appended
+function render(text, args) {
+    let i = 0;
+    const out = text.replace(/\{\}/g, () => (i < args.length ? String(args[i++]) : '{}'));
+    return i < args.length ? `${out} ${args.slice(i).join(' ')}` : out;
+}
+
+class EventLog {
+    constructor(options = {}) {
+        this.mode = options.mode || process.env.EVENT_LOG || 'binary';
+        this.templates = [];                          // { level, text, argc }
+        this.dropped = 0;                             // not yet reported in the ring
+        this.droppedTotal = 0;
+        this.written = 0;
+        this.pendingDefines = [];                     // template ids not yet in the ring
+        this.strings = new Map();                     // interned string -> id
+        this.seen = new Set();                        // strings seen once, cleared when full
+        this.pendingStrings = [];
+        this.define('warn', 'Event log ring full, {} events dropped');
+
+        if (this.mode !== 'binary') return;
+        const ringBytes = Math.max(envNumber('EVENT_LOG_RING_KB', 4096), 64) * 1024;
+        this.size = ringBytes;
+        this.sab = new SharedArrayBuffer(DATA_OFFSET + ringBytes);
+        this.ctrl = new Int32Array(this.sab, 0, 4);
+        this.buf = Buffer.from(this.sab, DATA_OFFSET, ringBytes);
+        this.view = new DataView(this.sab, DATA_OFFSET, ringBytes);
+        this.head = 0;                                // written up to here, published once per turn
+        this.tail = 0;                                // last tail seen, reloaded when short of room
+        this.kickTail = -1;
+        this.epoch = 0;
+        this.now = 0;
+        this.clockUses = 0;
+        this.inTurn = false;
+        // Once per event-loop turn: publish the head and re-read the clock
+        // on the next event (Date.now costs more than the rest of an event)
+        this.endTurn = () => {
+            this.inTurn = false;
+            if (this.ctrl) Atomics.store(this.ctrl, HEAD, this.head);
+        };
+
+        // Replicas may share the directory (and all be pid 1 in their containers)
+        const stamp = new Date().toISOString().replace(/[-:]/g, '').replace(/\..*/, 'Z');
+        const host = os.hostname().replace(/[^A-Za-z0-9.-]/g, '_');
+        this.worker = new Worker(__filename, {
+            workerData: {
+                eventLogDrain: true,
+                sab: this.sab,
+                dir: options.dir || process.env.EVENT_LOG_DIR || path.join(process.cwd(), 'logs'),
+                prefix: `events-${stamp}-${host}-${process.pid}-${threadId}`,
+                flushMs: envNumber('EVENT_LOG_FLUSH_MS', 200),
+                fileBytes: envNumber('EVENT_LOG_FILE_MB', 64) * 1024 * 1024,
+                files: envNumber('EVENT_LOG_FILES', 8)
+            }
+        });
+        this.worker.unref();
+        this.worker.on('error', err => {
+            console.error('Event log drain failed, falling back to console:', err.message);
+            this.mode = 'console';
+            this.ctrl = null;
+        });
+        process.on('exit', () => this.close());
+    }
+
+    // Returns the template id; level is debug, info, warn or error. Define
+    // templates once, at load, not per event.
+    define(level, text) {
+        const id = this.templates.length;
+        const argc = (text.match(/\{\}/g) || []).length;
+        if (argc > MAX_ARGS) throw new Error(`Event template takes at most ${MAX_ARGS} arguments: ${text}`);
+        this.templates.push({ level: Math.max(LEVELS.indexOf(level), 0), text, argc });
+        this.pendingDefines.push(id);
+        return id;
+    }
+
+    // Records one event. Up to four arguments: numbers, strings, booleans
+    // or null; anything else is stored as String(value).
+    emit(id, a, b, c, d) {
+        if (this.mode !== 'binary') {
+            if (this.mode === 'console') this.print(id, [a, b, c, d].slice(0, this.templates[id].argc));
+            return;
+        }
+        const behind = this.pendingDefines.length || this.pendingStrings.length || this.dropped;
+        const off = behind && !this.catchUp() ? -1 : this.begin(id);
+        if (off < 0) {
+            this.dropped++;
+            this.droppedTotal++;
+            return;
+        }
+        const argc = this.templates[id].argc;
+        let end = off + RECORD_HEADER;
+        if (argc > 0) end = this.arg(end, a);
+        if (argc > 1) end = this.arg(end, b);
+        if (argc > 2) end = this.arg(end, c);
+        if (argc > 3) end = this.arg(end, d);
+        this.commit(off, end);
+        this.written++;
+    }
+
+    print(id, args) {
+        const t = this.templates[id];
+        (t.level >= 2 ? console.error : console.log)(render(t.text, args));
+    }
+
+    // Definitions and the drop count go into the ring before the next event
+    catchUp() {
+        while (this.pendingStrings.length) {
+            const str = this.pendingStrings[0];
+            if (!this.strings.has(str)) {
+                const off = this.begin(ID_STRING);
+                if (off < 0) return false;
+                this.view.setUint16(off + 8, this.strings.size, true);
+                this.commit(off, off + 10 + this.buf.write(str, off + 10, MAX_STRING, 'utf8'));
+                this.strings.set(str, this.strings.size);
+            }
+            this.pendingStrings.shift();
+        }
+        while (this.pendingDefines.length) {
+            const t = this.templates[this.pendingDefines[0]];
+            const off = this.begin(ID_DEFINE);
+            if (off < 0) return false;
+            this.view.setUint16(off + 8, this.pendingDefines[0], true);
+            this.view.setUint8(off + 10, t.level);
+            const n = this.buf.write(t.text, off + 11, MAX_RECORD - 11, 'utf8');
+            this.commit(off, off + 11 + n);
+            this.pendingDefines.shift();
+        }
+        if (this.dropped) {
+            const off = this.begin(0);
+            if (off < 0) return false;
+            this.commit(off, this.arg(off + RECORD_HEADER, this.dropped));
+            this.dropped = 0;
+        }
+        return true;
+    }
+
+    // Offset of a record with room for MAX_RECORD bytes, header filled
+    // except the length; -1 when the ring is full
+    begin(id) {
+        if (!this.inTurn) {
+            this.inTurn = true;
+            this.clockUses = 0;
+            this.now = Date.now();
+            queueMicrotask(this.endTurn);
+        } else if ((++this.clockUses & 63) === 0) {
+            this.now = Date.now();
+        }
+        const now = this.now;
+        if (now - this.epoch > 0xFFFFFFFF || now < this.epoch) {
+            const off = this.reserve();
+            if (off < 0) return -1;
+            this.epoch = now;
+            this.view.setUint16(off + 2, ID_EPOCH, true);
+            this.view.setUint32(off + 4, 0, true);
+            this.view.setFloat64(off + RECORD_HEADER, now, true);
+            this.commit(off, off + RECORD_HEADER + 8);
+        }
+        const off = this.reserve();
+        if (off < 0) return -1;
+        this.view.setUint16(off + 2, id, true);
+        this.view.setUint32(off + 4, now - this.epoch, true);
+        return off;
+    }
+
+    // Single producer: head is ours, tail the drain's. A stale tail only
+    // understates the room, so it is re-read only when the ring looks full
+    // or half full (then the drain is woken early).
+    reserve() {
+        if (this.used(this.tail) > this.size / 2) {
+            this.tail = Atomics.load(this.ctrl, TAIL);
+            if (this.used(this.tail) > this.size / 2 && this.tail !== this.kickTail) {
+                this.kickTail = this.tail;
+                Atomics.store(this.ctrl, HEAD, this.head);
+                Atomics.notify(this.ctrl, STATE);
+            }
+        }
+        let off = this.fit(this.tail);
+        if (off < 0) off = this.fit(this.tail = Atomics.load(this.ctrl, TAIL));
+        return off;
+    }
+
+    used(tail) {
+        return this.head >= tail ? this.head - tail : this.size - tail + this.head;
+    }
+
+    // Records never wrap; END marks where the data stops when head goes
+    // back to 0
+    fit(tail) {
+        const head = this.head;
+        if (head >= tail) {
+            if (this.size - head >= MAX_RECORD) return head;
+            if (tail <= MAX_RECORD) return -1;
+            Atomics.store(this.ctrl, END, head);
+            this.head = 0;
+            return 0;
+        }
+        return tail - head > MAX_RECORD ? head : -1;
+    }
+
+    commit(off, end) {
+        this.view.setUint16(off, end - off, true);
+        this.head = end;
+    }
+
+    arg(off, v) {
+        const view = this.view;
+        if (typeof v === 'number') {
+            if ((v | 0) === v) {
+                view.setUint8(off, TAG_INT);
+                view.setInt32(off + 1, v, true);
+                return off + 5;
+            }
+            view.setUint8(off, TAG_FLOAT);
+            view.setFloat64(off + 1, v, true);
+            return off + 9;
+        }
+        if (v === null || v === undefined) {
+            view.setUint8(off, TAG_NULL);
+            return off + 1;
+        }
+        if (typeof v === 'boolean') {
+            view.setUint8(off, TAG_BOOL);
+            view.setUint8(off + 1, v ? 1 : 0);
+            return off + 2;
+        }
+        const str = typeof v === 'string' ? v : String(v);
+        const sid = this.strings.get(str);
+        if (sid !== undefined) {
+            view.setUint8(off, TAG_REF);
+            view.setUint16(off + 1, sid, true);
+            return off + 3;
+        }
+        if (this.strings.size < MAX_INTERNED && str.length <= MAX_INTERN_LENGTH) {
+            if (this.seen.has(str)) {
+                this.seen.delete(str);
+                this.pendingStrings.push(str);
+            } else {
+                if (this.seen.size >= MAX_INTERNED) this.seen.clear();
+                this.seen.add(str);
+            }
+        }
+        let n = 0;
+        // Short ASCII is copied inline; Buffer.write is a native call
+        if (str.length <= 64) {
+            const bytes = this.buf;
+            for (; n < str.length; n++) {
+                const ch = str.charCodeAt(n);
+                if (ch > 0x7F) break;
+                bytes[off + 3 + n] = ch;
+            }
+        }
+        if (n < str.length) n = this.buf.write(str, off + 3, MAX_STRING, 'utf8');
+        view.setUint8(off, TAG_STRING);
+        view.setUint16(off + 1, n, true);
+        return off + 3 + n;
+    }
+
+    // Drains what is left and closes the file; blocks for at most 2 s
+    close() {
+        if (!this.ctrl || Atomics.load(this.ctrl, STATE) !== RUNNING) return;
+        Atomics.store(this.ctrl, HEAD, this.head);
+        Atomics.store(this.ctrl, STATE, CLOSING);
+        Atomics.notify(this.ctrl, STATE);
+        Atomics.wait(this.ctrl, STATE, CLOSING, 2000);
+    }
+
+    getStats() {
+        return {
+            mode: this.mode,
+            templates: this.templates.length,
+            events: this.written,
+            dropped: this.droppedTotal,
+            ringBytes: this.size || 0
+        };
+    }
+}
+
+// ================= DRAIN (worker thread) =================
+function drain({ sab, dir, prefix, flushMs, fileBytes, files }) {
+    const ctrl = new Int32Array(sab, 0, 4);
+    const data = Buffer.from(sab, DATA_OFFSET, sab.byteLength - DATA_OFFSET);
+    const defines = new Map();                        // template or string id -> record, replayed per file
+    let epoch = null;
+    let fd = -1, fileSize = 0, fileSeq = 0;
+
+    fs.mkdirSync(dir, { recursive: true });
+
+    const open = () => {
+        const name = `${prefix}-${String(fileSeq++).padStart(4, '0')}.evl`;
+        fd = fs.openSync(path.join(dir, name), 'w');
+        const head = [MAGIC, ...defines.values()];
+        if (epoch) head.push(epoch);
+        const chunk = Buffer.concat(head);
+        fs.writeSync(fd, chunk);
+        fileSize = chunk.length;
+        const own = fs.readdirSync(dir).filter(f => f.startsWith(`${prefix}-`) && f.endsWith('.evl')).sort();
+        for (const old of own.slice(0, Math.max(own.length - files, 0))) fs.unlinkSync(path.join(dir, old));
+    };
+
+    // Copies [from, to) of the ring to the file, keeping the definitions
+    // and the epoch for the next file
+    const write = (from, to) => {
+        if (fd < 0) open();
+        for (let off = from; off < to;) {
+            const len = data.readUInt16LE(off);
+            const id = data.readUInt16LE(off + 2);
+            if (id === ID_DEFINE || id === ID_STRING) {
+                defines.set(id << 16 | data.readUInt16LE(off + 8), Buffer.from(data.subarray(off, off + len)));
+            }
+            else if (id === ID_EPOCH) epoch = Buffer.from(data.subarray(off, off + len));
+            off += len;
+        }
+        fs.writeSync(fd, data, from, to - from);
+        fileSize += to - from;
+    };
+
+    for (;;) {
+        const state = Atomics.load(ctrl, STATE);
+        const head = Atomics.load(ctrl, HEAD);
+        let tail = Atomics.load(ctrl, TAIL);
+        if (head < tail) {
+            write(tail, Atomics.load(ctrl, END));
+            tail = 0;
+            Atomics.store(ctrl, TAIL, 0);
+        }
+        if (head > tail) {
+            write(tail, head);
+            Atomics.store(ctrl, TAIL, head);
+        }
+        if (fileSize >= fileBytes) {
+            fs.closeSync(fd);
+            fd = -1;
+        }
+        if (state !== RUNNING) break;
+        Atomics.wait(ctrl, STATE, RUNNING, flushMs);
+    }
+    if (fd >= 0) fs.closeSync(fd);
+    Atomics.store(ctrl, STATE, CLOSED);
+    Atomics.notify(ctrl, STATE);
+}
+
+// ================= DECODER =================
+function* decodeFile(file) {
+    const bytes = fs.readFileSync(file);
+    if (bytes.length < 4 || !bytes.subarray(0, 4).equals(MAGIC)) throw new Error(`${file}: not an event log`);
+    const templates = new Map();
+    const strings = new Map();
+    let epoch = 0;
+    for (let off = 4; off + RECORD_HEADER <= bytes.length;) {
+        const len = bytes.readUInt16LE(off);
+        if (len < RECORD_HEADER || off + len > bytes.length) break;    // cut short by a crash
+        const id = bytes.readUInt16LE(off + 2);
+        const end = off + len;
+        if (id === ID_DEFINE) {
+            templates.set(bytes.readUInt16LE(off + 8), {
+                level: bytes.readUInt8(off + 10),
+                text: bytes.toString('utf8', off + 11, end)
+            });
+        } else if (id === ID_STRING) {
+            strings.set(bytes.readUInt16LE(off + 8), bytes.toString('utf8', off + 10, end));
+        } else if (id === ID_EPOCH) {
+            epoch = bytes.readDoubleLE(off + 8);
+        } else {
+            const args = [];
+            for (let p = off + RECORD_HEADER; p < end;) {
+                const tag = bytes.readUInt8(p++);
+                if (tag === TAG_INT) { args.push(bytes.readInt32LE(p)); p += 4; }
+                else if (tag === TAG_FLOAT) { args.push(bytes.readDoubleLE(p)); p += 8; }
+                else if (tag === TAG_BOOL) { args.push(bytes.readUInt8(p) === 1); p += 1; }
+                else if (tag === TAG_REF) { args.push(strings.get(bytes.readUInt16LE(p))); p += 2; }
+                else if (tag === TAG_STRING) {
+                    const n = bytes.readUInt16LE(p);
+                    args.push(bytes.toString('utf8', p + 2, p + 2 + n));
+                    p += 2 + n;
+                } else args.push(null);
+            }
+            const t = templates.get(id) || { level: 1, text: `#${id}` };
+            yield { time: epoch + bytes.readUInt32LE(off + 4), level: LEVELS[t.level], template: t.text, args };
+        }
+        off = end;
+    }
+}
+
+function main(argv) {
+    let json = false, minLevel = 0;
+    const inputs = [];
+    for (let i = 0; i < argv.length; i++) {
+        if (argv[i] === '--json') json = true;
+        else if (argv[i] === '--level') minLevel = Math.max(LEVELS.indexOf(argv[++i]), 0);
+        else inputs.push(argv[i]);
+    }
+    if (!inputs.length) {
+        console.error('usage: node event_log.js [--json] [--level debug|info|warn|error] FILE|DIR...');
+        process.exit(2);
+    }
+    const files = inputs.flatMap(p => (fs.statSync(p).isDirectory()
+        ? fs.readdirSync(p).filter(f => f.endsWith('.evl')).sort().map(f => path.join(p, f))
+        : [p]));
+    process.stdout.on('error', err => {
+        if (err.code === 'EPIPE') process.exit(0);                      // | head
+        throw err;
+    });
+    let lines = [];
+    for (const file of files) {
+        for (const e of decodeFile(file)) {
+            if (LEVELS.indexOf(e.level) < minLevel) continue;
+            const time = new Date(e.time).toISOString();
+            lines.push(json
+                ? JSON.stringify({ time, level: e.level, message: render(e.template, e.args), args: e.args })
+                : `${time} ${e.level.toUpperCase().padEnd(5)} ${render(e.template, e.args)}`);
+            if (lines.length === 4096) {
+                process.stdout.write(`${lines.join('\n')}\n`);
+                lines = [];
+            }
+        }
+    }
+    if (lines.length) process.stdout.write(`${lines.join('\n')}\n`);
+}
+
+if (!isMainThread && workerData && workerData.eventLogDrain) drain(workerData);
+else if (require.main === module) main(process.argv.slice(2));
+
+module.exports = { EventLog, decodeFile, render };
@@ -0,0 +1,88 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// Static rANS back end for the packed record (mirrors Native_Toolkit/firmware/record_rans.c).
+// Payload: [0xA0 | model version][rANS state u32 BE][rANS bytes]. The model
+// (record_rans_model.json) is generated by Native_Toolkit/tools/record_rans_train.c
+// and must match the one compiled into the firmware.
+
+const model = require('./record_rans_model.json');
+
+const MAGIC = 0xA0;
+const HEADER_SIZE = 5;
+const FIXED_BYTES = 63;
+const STR_POSITIONS = 16;
+const STR_LEN_OFFSET = [0, 2, 4, 7, 35];  // msisdn, iso6346, time, cgi, door
+const MAX_RECORD = 256;
+const RANS_L = 1 << 23;
+
+// Cumulative frequencies per context; unlisted symbols have frequency 1
+const contexts = model.contexts.map(ctx => {
+    const cum = new Uint16Array(257);
+    const freq = new Uint16Array(256).fill(1);
+    ctx.pairs.forEach(([symbol, f]) => { freq[symbol] = f; });
+    for (let s = 0; s < 256; s++) cum[s + 1] = cum[s] + freq[s];
+    return { scale: ctx.scale, flat: ctx.pairs.length === 0, cum };
+});
+if (contexts.length !== FIXED_BYTES + STR_LEN_OFFSET.length * STR_POSITIONS) {
+    throw new Error(`record_rans_model.json has ${contexts.length} contexts`);
+}
+
+const isRecordRans = buf => buf.length > 0 && (buf[0] & 0xF0) === MAGIC;
+
+function findSymbol(cum, slot) {
+    let lo = 0, hi = 255;
+    while (lo < hi) {
+        const mid = (lo + hi + 1) >> 1;
+        if (cum[mid] <= slot) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+// Returns the packed record (Buffer); throws on a malformed payload
+function decode(buf) {
+    if (buf.length < HEADER_SIZE) throw new Error('rANS payload too short');
+    if (buf[0] !== (MAGIC | model.version)) {
+        throw new Error(`rANS model version ${buf[0] & 0x0F}, receiver has ${model.version}`);
+    }
+
+    let x = buf.readUInt32BE(1);
+    let p = HEADER_SIZE;
+    const symbol = ctxIndex => {
+        const { scale, flat, cum } = contexts[ctxIndex];
+        const slot = x & ((1 << scale) - 1);
+        const s = flat ? slot : findSymbol(cum, slot);
+        x = (cum[s + 1] - cum[s]) * (x >>> scale) + slot - cum[s];
+        while (x < RANS_L) {
+            if (p >= buf.length) throw new Error('rANS payload truncated');
+            x = ((x << 8) | buf[p++]) >>> 0;
+        }
+        return s;
+    };
+
+    const fixed = Buffer.alloc(FIXED_BYTES);
+    for (let i = 0; i < FIXED_BYTES; i++) fixed[i] = symbol(i);
+
+    const lengths = STR_LEN_OFFSET.map(offset => fixed.readUInt16BE(offset));
+    const total = FIXED_BYTES + lengths.reduce((a, b) => a + b, 0);
+    if (total > MAX_RECORD) throw new Error(`rANS record of ${total} bytes`);
+
+    const packed = Buffer.alloc(total);
+    fixed.copy(packed);
+    let i = FIXED_BYTES;
+    lengths.forEach((length, field) => {
+        for (let pos = 0; pos < length; pos++) {
+            packed[i++] = symbol(FIXED_BYTES + field * STR_POSITIONS + Math.min(pos, STR_POSITIONS - 1));
+        }
+    });
+
+    // The encoder started from RANS_L: anything else means corruption
+    if (x !== RANS_L || p !== buf.length) throw new Error('rANS payload corrupted');
+    return packed;
+}
+
+module.exports = { isRecordRans, decode, MODEL_VERSION: model.version };
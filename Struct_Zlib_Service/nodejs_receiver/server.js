@@ -8,6 +8,11 @@
 const express = require('express');
 const zlib = require('zlib');
 const axios = require('axios');
+const recordRans = require('./record_rans');
+const { isDeflateSession, SessionTable } = require('./deflate_session');
+const { AdmissionController } = require('./admission');
+const { EventLog } = require('./event_log');
+const { BatchIngest, FORMATS, STATUS } = require('./batch_frame');
 const app = express();
 
 // Configuration
@@ -16,6 +21,21 @@ const QUEUE_PROCESS_INTERVAL = 5000; // Process queue every 5 seconds
 const OUTBOUND_URL = process.env.OUTBOUND_URL || null; // M2M endpoint
 const OUTBOUND_RETRY_INTERVAL = 5000; // Retry interval
 const MAX_RETRY_ATTEMPTS = 100; // Maximum retry attempts
+const SESSION_WINDOW_BYTES = parseInt(process.env.SESSION_WINDOW_BYTES) || 2048; // >= sender deflate window
+const SESSION_IDLE_TIMEOUT_MS = parseInt(process.env.SESSION_IDLE_TIMEOUT_MS) || 24 * 3600 * 1000; // Drop idle device sessions
+const MAX_SESSIONS = parseInt(process.env.MAX_SESSIONS) || 100000; // Least recently used sessions are evicted
+
+// Hot-path messages go to the binary event log (render with `npm run logs`)
+const events = new EventLog();
+const EVENTS = {
+    batchStart: events.define('info', 'Processing {} messages from queue...'),
+    messageError: events.define('error', 'Error processing message: {}'),
+    batchDone: events.define('info', 'Batch processed: {} messages, {} errors'),
+    totals: events.define('info', 'Total: {} processed, {} errors, Rate: {} msg/sec'),
+    outboundGiveUp: events.define('warn', 'Giving up on item {} after {} attempts'),
+    receiveError: events.define('error', 'Error receiving container data: {}'),
+    unhandled: events.define('error', 'Unhandled error: {}')
+};
 
 // Field order for struct unpacking (must match Python exactly)
 const FIELD_ORDER = [
@@ -25,68 +45,76 @@ const FIELD_ORDER = [
 ];
 
 // Decompression: reverse of Python struct_zlib_compress
+// The back end is chosen by the first byte: zlib (CMF low nibble 8) or static rANS (0xA?).
+// Session frames (0xC?) are decoded at ingest, in arrival order, and queued as packed records.
 function structZlibDecompress(compressedData) {
     try {
-        const decompressed = zlib.inflateSync(compressedData);
-        let offset = 0;
-        const containerData = {};
-        const stringData = [];
-        
-        // First pass: read fixed-size data and string lengths
-        for (const field of FIELD_ORDER) {
-            if (['msisdn', 'iso6346', 'time', 'cgi', 'door'].includes(field)) {
-                const length = decompressed.readUInt16BE(offset);
-                offset += 2;
-                stringData.push({ field, length });
-            } else if (['rssi', 'ble-m', 'bat-soc', 'gnss', 'nsat'].includes(field)) {
-                containerData[field] = decompressed.readUInt8(offset);
-                offset += 1;
-            } else if (field === 'acc') {
-                const x = decompressed.readFloatBE(offset);
-                const y = decompressed.readFloatBE(offset + 4);
-                const z = decompressed.readFloatBE(offset + 8);
-                containerData[field] = `${x.toFixed(4)} ${y.toFixed(4)} ${z.toFixed(4)}`;
-                offset += 12;
-            } else {
-                const value = decompressed.readFloatBE(offset);
-                
-                if (field === 'pressure') {
-                    containerData[field] = value.toFixed(4);
-                } else if (['latitude', 'longitude', 'altitude'].includes(field)) {
-                    containerData[field] = value.toFixed(2);
-                } else if (field === 'speed') {
-                    containerData[field] = value.toFixed(1);
-                } else if (['temperature', 'humidity', 'heading'].includes(field)) {
-                    containerData[field] = value.toFixed(2);
-                } else if (field === 'hdop') {
-                    containerData[field] = value.toFixed(1);
-                }
-                
-                offset += 4;
-            }
-        }
-        
-        // Second pass: read string data
-        for (const stringInfo of stringData) {
-            const stringBytes = decompressed.subarray(offset, offset + stringInfo.length);
-            containerData[stringInfo.field] = stringBytes.toString('utf-8');
-            offset += stringInfo.length;
-        }
-        
-        // Convert numeric fields back to strings to match original format
-        containerData.rssi = containerData.rssi.toString();
-        containerData['ble-m'] = containerData['ble-m'].toString();
-        containerData['bat-soc'] = containerData['bat-soc'].toString();
-        containerData.gnss = containerData.gnss.toString();
-        containerData.nsat = containerData.nsat.toString().padStart(2, '0');
-        
-        return containerData;
-        
+        const decompressed = recordRans.isRecordRans(compressedData)
+            ? recordRans.decode(compressedData)
+            : zlib.inflateSync(compressedData);
+        return structUnpack(decompressed);
     } catch (error) {
         throw new Error(`Struct+zlib decompression failed: ${error.message}`);
     }
 }
 
+// Unpack the struct layout: fixed-size fields and string lengths, then the strings
+function structUnpack(decompressed) {
+    let offset = 0;
+    const containerData = {};
+    const stringData = [];
+    
+    // First pass: read fixed-size data and string lengths
+    for (const field of FIELD_ORDER) {
+        if (['msisdn', 'iso6346', 'time', 'cgi', 'door'].includes(field)) {
+            const length = decompressed.readUInt16BE(offset);
+            offset += 2;
+            stringData.push({ field, length });
+        } else if (['rssi', 'ble-m', 'bat-soc', 'gnss', 'nsat'].includes(field)) {
+            containerData[field] = decompressed.readUInt8(offset);
+            offset += 1;
+        } else if (field === 'acc') {
+            const x = decompressed.readFloatBE(offset);
+            const y = decompressed.readFloatBE(offset + 4);
+            const z = decompressed.readFloatBE(offset + 8);
+            containerData[field] = `${x.toFixed(4)} ${y.toFixed(4)} ${z.toFixed(4)}`;
+            offset += 12;
+        } else {
+            const value = decompressed.readFloatBE(offset);
+            
+            if (field === 'pressure') {
+                containerData[field] = value.toFixed(4);
+            } else if (['latitude', 'longitude', 'altitude'].includes(field)) {
+                containerData[field] = value.toFixed(2);
+            } else if (field === 'speed') {
+                containerData[field] = value.toFixed(1);
+            } else if (['temperature', 'humidity', 'heading'].includes(field)) {
+                containerData[field] = value.toFixed(2);
+            } else if (field === 'hdop') {
+                containerData[field] = value.toFixed(1);
+            }
+            
+            offset += 4;
+        }
+    }
+    
+    // Second pass: read string data
+    for (const stringInfo of stringData) {
+        const stringBytes = decompressed.subarray(offset, offset + stringInfo.length);
+        containerData[stringInfo.field] = stringBytes.toString('utf-8');
+        offset += stringInfo.length;
+    }
+    
+    // Convert numeric fields back to strings to match original format
+    containerData.rssi = containerData.rssi.toString();
+    containerData['ble-m'] = containerData['ble-m'].toString();
+    containerData['bat-soc'] = containerData['bat-soc'].toString();
+    containerData.gnss = containerData.gnss.toString();
+    containerData.nsat = containerData.nsat.toString().padStart(2, '0');
+    
+    return containerData;
+}
+
 // Message queue for processing compressed data
 class MessageQueue {
     constructor() {
@@ -118,7 +146,7 @@ class MessageQueue {
     processQueue() {
         if (this.queue.length === 0) return;
         
-        console.log(`Processing ${this.queue.length} messages from queue...`);
+        events.emit(EVENTS.batchStart, this.queue.length);
         
         const batch = this.queue.splice(0);
         const batchStats = { processed: 0, errors: 0 };
@@ -129,22 +157,25 @@ class MessageQueue {
                 this.processed++;
                 batchStats.processed++;
             } catch (error) {
-                console.error('Error processing message:', error.message);
+                events.emit(EVENTS.messageError, error.message);
                 this.errors++;
                 batchStats.errors++;
             }
         });
         
         if (batch.length > 0) {
-            console.log(`Batch processed: ${batchStats.processed} messages, ${batchStats.errors} errors`);
-            console.log(`Total: ${this.processed} processed, ${this.errors} errors, Rate: ${(this.processed / ((Date.now() - this.startTime) / 1000)).toFixed(1)} msg/sec`);
+            events.emit(EVENTS.batchDone, batchStats.processed, batchStats.errors);
+            const rate = this.processed / ((Date.now() - this.startTime) / 1000);
+            events.emit(EVENTS.totals, this.processed, this.errors, Math.round(rate * 10) / 10);
         }
     }
     
     processMessage(message) {
-        const { compressedData, receivedAt, queuedAt } = message;
+        const { compressedData, packedData, receivedAt, queuedAt } = message;
         
-        const containerData = structZlibDecompress(compressedData);
+        // Batch items arrive decoded
+        const containerData = message.containerData ||
+            (packedData ? structUnpack(packedData) : structZlibDecompress(compressedData));
         
         // Validate field count
         if (Object.keys(containerData).length !== FIELD_ORDER.length) {
@@ -263,7 +294,7 @@ class OutboundQueue {
         } catch (error) {
             if (item.attempts >= MAX_RETRY_ATTEMPTS) {
                 this.totalErrors++;
-                console.log(`Giving up on item ${item.id} after ${MAX_RETRY_ATTEMPTS} attempts`);
+                events.emit(EVENTS.outboundGiveUp, item.id, MAX_RETRY_ATTEMPTS);
                 item.attempts = 0;
             } else {
                 const delay = Math.min(OUTBOUND_RETRY_INTERVAL * Math.pow(2, item.attempts - 1), 60000);
@@ -289,6 +320,23 @@ class OutboundQueue {
 // Initialize queues
 const messageQueue = new MessageQueue();
 const outboundQueue = new OutboundQueue();
+const deflateSessions = new SessionTable({
+    windowBytes: SESSION_WINDOW_BYTES,
+    idleTimeoutMs: SESSION_IDLE_TIMEOUT_MS,
+    maxSessions: MAX_SESSIONS
+});
+const admission = new AdmissionController(() => ({
+    depth: messageQueue.queue.length,
+    oldestQueuedAt: messageQueue.queue.length ? messageQueue.queue[0].queuedAt : null,
+    outboundDepth: outboundQueue.queue.length,
+    processed: messageQueue.processed,
+    sent: outboundQueue.totalSent
+}), { drainIntervalMs: QUEUE_PROCESS_INTERVAL });
+const batches = new BatchIngest();
+
+// The first byte names the back end; a batch item's format tag must agree
+const structFormat = data => (isDeflateSession(data) ? FORMATS.session
+    : recordRans.isRecordRans(data) ? FORMATS['struct-rans'] : FORMATS['struct-zlib']);
 
 // Middleware
 app.use(express.raw({ type: 'application/octet-stream', limit: '1mb' }));
@@ -298,7 +346,7 @@ app.use(express.json());
 app.use((req, res, next) => {
     res.header('Access-Control-Allow-Origin', '*');
     res.header('Access-Control-Allow-Methods', 'GET, POST, PUT, DELETE, OPTIONS');
-    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization');
+    res.header('Access-Control-Allow-Headers', 'Content-Type, Authorization, X-Device-Id, X-Priority');
     
     if (req.method === 'OPTIONS') {
         res.sendStatus(200);
@@ -312,12 +360,16 @@ app.use((req, res, next) => {
 app.get('/health', (req, res) => {
     const inboundStats = messageQueue.getStats();
     const outboundStats = outboundQueue.getStats();
+    const admissionStats = admission.getStats();
     
+    // Still 200 while shedding: the replica is up and admitting alarms
     res.json({
-        status: 'healthy',
+        status: admissionStats.level === 'normal' ? 'healthy' : 'degraded',
         timestamp: new Date().toISOString(),
         inbound: inboundStats,
-        outbound: outboundStats
+        outbound: outboundStats,
+        sessions: deflateSessions.getStats(),
+        admission: admissionStats
     });
 });
 
@@ -329,7 +381,11 @@ app.get('/stats', (req, res) => {
     res.json({
         timestamp: new Date().toISOString(),
         inbound: inboundStats,
-        outbound: outboundStats
+        outbound: outboundStats,
+        sessions: deflateSessions.getStats(),
+        admission: admission.getStats(),
+        batch: batches.getStats(),
+        eventLog: events.getStats()
     });
 });
 
@@ -352,8 +408,41 @@ app.post('/container-data', (req, res) => {
             });
         }
         
+        // Session frames depend on the previous message of the same device
+        let packedData = null;
+        if (isDeflateSession(compressedData)) {
+            const deviceId = req.get('X-Device-Id');
+            if (!deviceId) {
+                return res.status(400).json({
+                    error: 'Missing device id',
+                    message: 'Session-deflate payloads require the X-Device-Id header'
+                });
+            }
+            try {
+                packedData = deflateSessions.decode(deviceId, compressedData);
+            } catch (error) {
+                // The sender answers 409 by resending the record as a keyframe
+                return res.status(error.resync ? 409 : 400).json({
+                    error: error.resync ? 'Session desync' : 'Invalid session frame',
+                    message: error.message,
+                    resync: Boolean(error.resync),
+                    expectedSeq: error.expectedSeq
+                });
+            }
+        }
+        
+        // Under load routine telemetry is shed; alarms are still admitted. A
+        // session frame is decoded first (its history must advance in order),
+        // so a retry of a shed frame gets 409 and is resent as a keyframe.
+        const decision = admission.admit(req, () =>
+            packedData ? structUnpack(packedData) : structZlibDecompress(compressedData));
+        if (!decision.admitted) {
+            return admission.reject(res, decision);
+        }
+        
         messageQueue.add({
             compressedData: compressedData,
+            packedData: packedData,
             receivedAt: Date.now(),
             size: compressedData.length
         });
@@ -366,7 +455,62 @@ app.post('/container-data', (req, res) => {
         });
         
     } catch (error) {
-        console.error('Error receiving container data:', error.message);
+        events.emit(EVENTS.receiveError, error.message);
+        res.status(500).json({
+            error: 'Processing error',
+            message: error.message
+        });
+    }
+});
+
+// Batch endpoint: many payloads per request (batch_frame.js), one status each.
+// Items are decoded in order, so the session frames of a device may follow
+// each other in one batch.
+app.post('/container-data/batch', (req, res) => {
+    try {
+        let items;
+        try {
+            items = batches.parse(req.body);
+        } catch (error) {
+            return res.status(400).json({
+                error: 'Invalid batch',
+                message: error.message
+            });
+        }
+        
+        const receivedAt = Date.now();
+        const status = batches.ingest(items, item => {
+            const format = structFormat(item.payload);
+            if (item.format !== FORMATS.default && item.format !== format) return STATUS.REJECTED;
+            
+            let packedData = null;
+            if (format === FORMATS.session) {
+                const deviceId = item.deviceId || req.get('X-Device-Id');
+                if (!deviceId) return STATUS.REJECTED;
+                try {
+                    packedData = deflateSessions.decode(deviceId, item.payload);
+                } catch (error) {
+                    return error.resync ? STATUS.RESYNC : STATUS.REJECTED;
+                }
+            }
+            const containerData = packedData ? structUnpack(packedData) : structZlibDecompress(item.payload);
+            
+            if (!admission.admit(req, () => containerData).admitted) return STATUS.RETRY;
+            messageQueue.add({
+                compressedData: item.payload,
+                containerData: containerData,
+                receivedAt: receivedAt,
+                size: item.payload.length
+            });
+            return STATUS.ACCEPTED;
+        });
+        
+        batches.reply(req, res, status, () => admission.retryAfter(), {
+            queueSize: messageQueue.queue.length
+        });
+        
+    } catch (error) {
+        events.emit(EVENTS.receiveError, error.message);
         res.status(500).json({
             error: 'Processing error',
             message: error.message
@@ -376,7 +520,7 @@ app.post('/container-data', (req, res) => {
 
 // Error handling middleware
 app.use((error, req, res, next) => {
-    console.error('Unhandled error:', error);
+    events.emit(EVENTS.unhandled, error.stack || error.message);
     res.status(500).json({
         error: 'Internal server error',
         message: error.message
@@ -411,10 +555,14 @@ app.listen(PORT, () => {
     console.log('='.repeat(60));
     console.log(`Listening on port ${PORT}`);
     console.log(`Main endpoint: POST /container-data`);
+    console.log(`Batch endpoint: POST /container-data/batch (up to ${batches.maxItems} items)`);
     console.log(`Health check: GET /health`);
     console.log(`Statistics: GET /stats`);
     console.log(`Queue processing: every ${QUEUE_PROCESS_INTERVAL}ms`);
-    console.log(`Compression method: Struct + Zlib`);
+    console.log(`Session deflate: ${SESSION_WINDOW_BYTES} B window, up to ${MAX_SESSIONS} devices`);
+    console.log(`Admission control: ${admission.enabled ? 'on' : 'off'}`);
+    console.log(`Event log: ${events.mode}`);
+    console.log(`Compression method: Struct + Zlib (static rANS model v${recordRans.MODEL_VERSION} accepted)`);
     console.log(`Content-Type: application/octet-stream`);
     console.log('='.repeat(60));
 });
@@ -0,0 +1,66 @@
+// ------------------------------------------------------------
+//  IoT Payload Optimization Framework – Master's Thesis (2025)
+//  Copyright (c) 2025 Natesh Kumar (Natdev15)
+//  Provided for academic and research reference only.
+// ------------------------------------------------------------
+
+// The receivers share these modules byte for byte. Each service keeps its
+// own copy so that its nodejs_receiver/ stays a self-contained Docker build
+// context; this check keeps the copies from drifting.
+//
+//   node scripts/check_shared_modules.js                  exit 1 when copies differ
+//   node scripts/check_shared_modules.js --sync SERVICE   copy SERVICE's modules to the others
+//
+// Every receiver runs it as `npm run check:shared`.
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..');
+const SERVICES = ['CBOR_Service', 'MessagePack_Service', 'Struct_Zlib_Service', 'Protobuf_Service_with_Dashboard'];
+const MODULES = ['admission.js', 'event_log.js', 'batch_frame.js'];
+
+const modulePath = (service, name) => path.join(ROOT, service, 'nodejs_receiver', name);
+
+function digest(file) {
+    try {
+        return crypto.createHash('sha256').update(fs.readFileSync(file)).digest('hex').slice(0, 12);
+    } catch (err) {
+        return 'missing';
+    }
+}
+
+function check() {
+    let drifted = 0;
+    for (const name of MODULES) {
+        const copies = SERVICES.map(service => ({ service, hash: digest(modulePath(service, name)) }));
+        if (copies.every(copy => copy.hash === copies[0].hash && copy.hash !== 'missing')) continue;
+        drifted++;
+        console.error(`${name} differs between the receivers:`);
+        copies.forEach(copy => console.error(`  ${copy.hash}  ${copy.service}`));
+    }
+    if (drifted) {
+        console.error('Apply the change to every copy, or run with --sync SERVICE to copy one over the others.');
+        return 1;
+    }
+    console.log(`${MODULES.length} shared modules identical in ${SERVICES.length} receivers`);
+    return 0;
+}
+
+function sync(source) {
+    if (!SERVICES.includes(source)) {
+        console.error(`Unknown service ${source}; one of ${SERVICES.join(', ')}`);
+        return 1;
+    }
+    for (const name of MODULES) {
+        const content = fs.readFileSync(modulePath(source, name));
+        SERVICES.filter(service => service !== source)
+            .forEach(service => fs.writeFileSync(modulePath(service, name), content));
+    }
+    console.log(`Copied ${MODULES.join(', ')} from ${source}`);
+    return 0;
+}
+
+const args = process.argv.slice(2);
+process.exit(args[0] === '--sync' ? sync(args[1]) : check());